@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+Raft replication benchmark for Pyserv framework
+Runs an in-process cluster over localhost TCP and reports commit throughput and latency
+
+Usage: python scripts/benchmark_raft.py [--nodes 3,5] [--commands N] [--concurrency C]
+"""
+
+import argparse
+import asyncio
+import sys
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "src"))
+
+from pyserv.microservices.consensus import InMemoryStorage, NetworkTransport, NodeRole, RaftNode
+
+
+async def start_cluster(size):
+    """Start a cluster of size nodes and wait for its leader"""
+    ids = [f"node{i}" for i in range(size)]
+    transports = {node_id: NetworkTransport(node_id, "127.0.0.1", 0) for node_id in ids}
+    for transport in transports.values():
+        await transport.initialize()
+    for transport in transports.values():
+        for node_id, other in transports.items():
+            transport.add_node(node_id, "127.0.0.1", other.port)
+
+    nodes = [RaftNode(node_id, ids, transports[node_id], InMemoryStorage(node_id)) for node_id in ids]
+    tasks = [asyncio.create_task(node.start()) for node in nodes]
+    while True:
+        leaders = [node for node in nodes if node.role == NodeRole.LEADER]
+        if len(leaders) == 1:
+            return nodes, tasks, leaders[0]
+        await asyncio.sleep(0.01)
+
+
+async def run(size, commands, concurrency):
+    """Commit commands through the leader with concurrency clients; return latencies in ms and elapsed s"""
+    nodes, tasks, leader = await start_cluster(size)
+    latencies = []
+    remaining = iter(range(commands))
+
+    async def client():
+        for n in remaining:
+            start = time.perf_counter()
+            if not await leader.append_entry({"key": f"k{n % 1000}", "value": n}, wait_for_commit=True):
+                raise RuntimeError("leadership lost during benchmark")
+            latencies.append((time.perf_counter() - start) * 1000)
+
+    start = time.perf_counter()
+    await asyncio.gather(*(client() for _ in range(concurrency)))
+    elapsed = time.perf_counter() - start
+
+    for node in nodes:
+        await node.stop()
+    for task in tasks:
+        task.cancel()
+    await asyncio.gather(*tasks, return_exceptions=True)
+    latencies.sort()
+    return latencies, elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark Pyserv Raft replication")
+    parser.add_argument("--nodes", default="3,5", help="Comma-separated cluster sizes")
+    parser.add_argument("--commands", type=int, default=5000, help="Commands committed per cluster size")
+    parser.add_argument("--concurrency", type=int, default=64, help="Concurrent clients submitting commands")
+    args = parser.parse_args()
+
+    for size in (int(n) for n in args.nodes.split(",")):
+        latencies, elapsed = asyncio.run(run(size, args.commands, args.concurrency))
+        p50 = latencies[len(latencies) // 2]
+        p99 = latencies[int(len(latencies) * 0.99)]
+        print(f"{size} nodes: {len(latencies) / elapsed:9.0f} commits/s  "
+              f"p50 {p50:7.2f}ms  p99 {p99:7.2f}ms  ({args.concurrency} clients)")
+
+
+if __name__ == "__main__":
+    main()
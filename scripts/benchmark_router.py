@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+Router matching microbenchmark for Pyserv framework
+Compares radix-tree lookup against the linear regex scan as route count grows
+
+Usage: python scripts/benchmark_router.py [--routes 10,100,600,2000] [--iterations N]
+"""
+
+import argparse
+import random
+import sys
+import time
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "src"))
+
+from pyserv.routing.router import Router
+
+
+def build_router(route_count):
+    """Build a router shaped like a REST API with route_count routes"""
+    router = Router()
+    paths = []
+    resource = 0
+    while len(router.routes) < route_count:
+        base = f"/api/v1/resource{resource}"
+        templates = [
+            (base, "GET"),
+            (base, "POST"),
+            (f"{base}/{{id:int}}", "GET"),
+            (f"{base}/{{id:int}}", "PUT"),
+            (f"{base}/{{id:int}}/items/{{item}}", "GET"),
+            (f"{base}/search", "GET"),
+        ]
+        for template, method in templates:
+            if len(router.routes) >= route_count:
+                break
+            router.add_route(template, lambda request, **kwargs: None, [method])
+            concrete = template.replace("{id:int}", "42").replace("{item}", "abc")
+            paths.append((method, concrete))
+        resource += 1
+    return router, paths
+
+
+def time_lookups(match, requests, iterations):
+    """Return per-lookup latencies in microseconds"""
+    samples = []
+    for _ in range(iterations):
+        method, path = random.choice(requests)
+        start = time.perf_counter()
+        match(method, path)
+        samples.append((time.perf_counter() - start) * 1_000_000)
+    samples.sort()
+    return samples
+
+
+def report(name, samples):
+    """Format mean/p50/p99 for one matcher"""
+    mean = sum(samples) / len(samples)
+    p50 = samples[len(samples) // 2]
+    p99 = samples[int(len(samples) * 0.99)]
+    return f"{name:<8} mean {mean:8.2f}us  p50 {p50:8.2f}us  p99 {p99:8.2f}us"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark Pyserv route matching")
+    parser.add_argument("--routes", default="10,50,100,300,600,1000",
+                        help="Comma-separated route counts")
+    parser.add_argument("--iterations", type=int, default=20000,
+                        help="Lookups per matcher and route count")
+    args = parser.parse_args()
+
+    random.seed(0)
+    for route_count in (int(n) for n in args.routes.split(",")):
+        router, requests = build_router(route_count)
+        compiled = router._get_compiled()
+
+        radix = time_lookups(compiled.match, requests, args.iterations)
+        regex = time_lookups(router._match_linear, requests, args.iterations)
+
+        print(f"{route_count} routes ({compiled.backend} radix backend)")
+        print("  " + report("radix", radix))
+        print("  " + report("regex", regex))
+        print(f"  speedup {sum(regex) / sum(radix):.1f}x")
+
+
+if __name__ == "__main__":
+    main()
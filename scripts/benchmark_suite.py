@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""
+Hot-path benchmark suite for Pyserv framework
+Runs the in-process benchmarks, prints ops/sec, latency percentiles and allocations per op,
+and exits non-zero when results regress against a stored baseline; failed operations and
+(unless --allow-skipped) benchmark groups that could not be built also fail the gate
+
+Usage: python scripts/benchmark_suite.py [--filter router] [--baseline FILE [--update-baseline]] [--allow-skipped]
+"""
+
+import argparse
+import asyncio
+import json
+import sys
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "src"))
+
+from pyserv.performance.benchmarks import HotPathSuite, format_results
+from pyserv.performance.profiling import RegressionDetector
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark Pyserv framework hot paths")
+    parser.add_argument("--filter", default=None, help="Only run benchmarks whose name contains this")
+    parser.add_argument("--iterations", type=int, default=2000, help="Timed operations per benchmark")
+    parser.add_argument("--warmup", type=int, default=200, help="Untimed operations before timing")
+    parser.add_argument("--repeat", type=int, default=3, help="Runs per benchmark; the fastest is kept")
+    parser.add_argument("--routes", default="10,100,1000", help="Comma-separated route counts for router benchmarks")
+    parser.add_argument("--depths", default="0,5,20", help="Comma-separated middleware chain depths")
+    parser.add_argument("--baseline", default=None, help="Baseline JSON file to compare against")
+    parser.add_argument("--update-baseline", action="store_true", help="Store these results as the new baseline")
+    parser.add_argument("--threshold", type=float, default=0.25, help="Relative change that counts as a regression")
+    parser.add_argument("--json", default=None, help="Also write results to this JSON file")
+    parser.add_argument("--allow-skipped", action="store_true",
+                        help="Pass the gate even if benchmark groups could not be built")
+    args = parser.parse_args()
+
+    suite = HotPathSuite(
+        iterations=args.iterations,
+        warmup=args.warmup,
+        repeat=args.repeat,
+        route_counts=[int(n) for n in args.routes.split(",")],
+        middleware_depths=[int(n) for n in args.depths.split(",")],
+    )
+    results = asyncio.run(suite.run(args.filter))
+    print(format_results(results, suite.skipped))
+    if suite.skipped:
+        print(f"SKIPPED {len(suite.skipped)} benchmark group(s): {', '.join(suite.skipped)}")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump([result.__dict__ for result in results], f, indent=2)
+
+    if not args.baseline:
+        return 0
+
+    detector = RegressionDetector(args.baseline)
+    if args.update_baseline:
+        detector.establish_baseline(results)
+        print(f"baseline written to {args.baseline}")
+        return 0
+
+    regressions = detector.detect_regression(results, threshold=args.threshold)
+    for regression in regressions:
+        print(f"REGRESSION {regression['test']}: {regression['type']} "
+              f"{regression['baseline']:.6g} -> {regression['current']:.6g} "
+              f"(+{regression['change_percent']:.1f}%, {regression['severity']})")
+    if suite.skipped and not args.allow_skipped:
+        print("skipped benchmark groups are not gated; failing (pass --allow-skipped to accept)")
+        return 1
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
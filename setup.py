@@ -5,6 +5,7 @@ Enterprise-grade web framework with optional C/C++ extensions
 """
 
 from setuptools import setup, find_packages, Extension
+from setuptools.command.build_ext import build_ext
 from pathlib import Path
 import sys
 import os
@@ -112,6 +113,7 @@ extras_require = {
         "uvloop>=0.16.0; sys_platform != 'win32'",  # Fast event loop (Unix only)
         "httptools>=0.4.0",      # Fast HTTP parsing
         "cython>=0.29.0",        # C extensions compilation
+        "orjson>=3.8.0",         # Native JSON codec backend
     ],
     
     # Web3 and blockchain
@@ -144,21 +146,44 @@ extras_require["all"] = [
     dep for deps in extras_require.values() for dep in deps
 ]
 
+# Native extensions: (module name, source file)
+native_extensions = [
+    ('pyserv.core.http_parser', 'src/pyserv/core/http_parser.c'),
+    ('pyserv.core.route_tree', 'src/pyserv/core/route_tree.c'),
+    ('pyserv.core.shm_sync', 'src/pyserv/core/shm_sync.c'),
+    ('pyserv.core.frame_ring', 'src/pyserv/core/frame_ring.c'),
+]
+
+
+class optional_build_ext(build_ext):
+    """Build C extensions, falling back to Python implementations on failure"""
+
+    def run(self):
+        try:
+            super().run()
+        except Exception as e:
+            print(f"Warning: C extensions failed to build ({e}). Framework will use Python implementations.")
+
+    def build_extension(self, ext):
+        try:
+            super().build_extension(ext)
+        except Exception as e:
+            print(f"Warning: failed to build {ext.name} ({e}). Using Python implementation.")
+
+
 # Define C extensions for performance
 extensions = []
 if should_build_extensions():
-    # HTTP parser extension
-    http_parser_ext = Extension(
-        'pyserv.core.http_parser',
-        sources=['src/pyserv/core/http_parser.c'] if os.path.exists('src/pyserv/core/http_parser.c') else [],
-        extra_compile_args=get_compile_args(),
-        language='c'
-    )
-    
-    # Only add if source file exists
-    if os.path.exists('src/pyserv/core/http_parser.c'):
-        extensions.append(http_parser_ext)
-    
+    for module_name, source in native_extensions:
+        # Only add if source file exists
+        if os.path.exists(source):
+            extensions.append(Extension(
+                module_name,
+                sources=[source],
+                extra_compile_args=get_compile_args(),
+                language='c'
+            ))
+
     if not extensions:
         print("Note: C extension source files not found. Framework will use Python implementations.")
 
@@ -210,6 +235,7 @@ setup(
     install_requires=install_requires,
     extras_require=extras_require,
     ext_modules=extensions,
+    cmdclass={'build_ext': optional_build_ext},
     entry_points={
         "console_scripts": [
             "pyserv=pyserv.cli:main",
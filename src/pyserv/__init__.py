@@ -33,38 +33,51 @@ __version__ = "0.1.0"
 __author__ = "Pyserv Team"
 __email__ = "team@pyserv.dev"
 
-# Core framework components
-from pyserv.server.application import Application
-from pyserv.server.config import AppConfig
-from pyserv.http import Request, Response
-from pyserv.routing import Router, Route
-from pyserv.exceptions import HTTPException, BadRequest, NotFound, Forbidden
+# Everything below is resolved on first access (PEP 562), so ``import pyserv`` only
+# costs this module; subsystems are imported when an application actually uses them.
+# Run ``pyserv importtime`` to see what a given import pulls in.
+from pyserv.utils.lazy import attach
 
-# Essential middleware
-from pyserv.middleware import HTTPMiddleware, WebSocketMiddleware
+__getattr__, __dir__ = attach(__name__, {
+    # Core framework components
+    "pyserv.server.application": ["Application"],
+    "pyserv.server.config": ["AppConfig"],
+    "pyserv.http": ["Request", "Response"],
+    "pyserv.routing": ["Router", "Route"],
+    "pyserv.exceptions": ["HTTPException", "BadRequest", "NotFound", "Forbidden"],
 
-# Template engine
-from pyserv.templating import TemplateEngine
+    # Essential middleware
+    "pyserv.middleware": ["HTTPMiddleware", "WebSocketMiddleware"],
 
-# Database and models
-from pyserv.models import BaseModel
-from pyserv.database import DatabaseConnection
+    # Template engine
+    "pyserv.templating": ["TemplateEngine"],
 
-# Security (core only)
-from pyserv.security import SecurityManager, get_security_manager
+    # Database and models
+    "pyserv.models": ["BaseModel"],
+    "pyserv.database": ["DatabaseConnection"],
 
-# Authentication
-from pyserv.auth import AuthManager, login_required
+    # Security (core only)
+    "pyserv.security": ["SecurityManager", "get_security_manager"],
 
-# Events and plugins
-from pyserv.events import EventBus, Event
-from pyserv.plugins import PluginManager
+    # Authentication
+    "pyserv.auth": ["AuthManager", "login_required"],
 
-# WebSocket support
-from pyserv.websocket import WebSocket
+    # Events and plugins
+    "pyserv.events": ["EventBus", "Event"],
+    "pyserv.plugins": ["PluginManager"],
+
+    # WebSocket support
+    "pyserv.websocket": ["WebSocket"],
 
-# Utilities
-from pyserv.utils.di import Container
+    # Utilities
+    "pyserv.utils.di": ["Container"],
+}, submodules=[
+    # Heavy optional subsystems, only imported when touched
+    "payment", "neuralforge", "iot", "microservices", "deployment", "graphql",
+], aliases={
+    # Convenience alias
+    "Pyserv": "pyserv.server.application:Application",
+})
 
 __all__ = [
     # Core framework
@@ -92,6 +105,3 @@ __all__ = [
     # Version info
     "__version__", "__author__", "__email__",
 ]
-
-# Convenience alias
-Pyserv = Application
\ No newline at end of file
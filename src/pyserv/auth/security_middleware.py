@@ -522,115 +522,123 @@ def init_security(config: Optional[SecurityConfig] = None) -> UnifiedSecurityMid
     return get_security_middleware(config)
 
 # Quantum Security Integration
-try:
-    from pyserv.security.quantum_security import (
-        get_quantum_security_manager,
-        QuantumAlgorithm,
-        quantum_authenticate,
-        establish_secure_channel
-    )
+# pyserv.security.quantum_security (and the key management stack behind it) is imported
+# only once a config enables quantum authentication or secure channels
+def _quantum_enabled(config: SecurityConfig) -> bool:
+    return bool(getattr(config, 'quantum_auth_enabled', False) or
+                getattr(config, 'quantum_channel_enabled', False))
+
+
+class QuantumSecurityProtector:
+    """Quantum-resistant security features"""
+
+    def __init__(self, config: SecurityConfig):
+        from pyserv.security.quantum_security import get_quantum_security_manager
+        self.config = config
+        self.quantum_manager = get_quantum_security_manager()
+
+    async def validate_quantum_authentication(self, request) -> None:
+        """Validate quantum-resistant authentication"""
+        from pyserv.security.quantum_security import quantum_authenticate
 
-    class QuantumSecurityProtector:
-        """Quantum-resistant security features"""
+        quantum_token = request.headers.get('X-Quantum-Auth')
+        if not quantum_token:
+            raise SecurityError("Quantum authentication required")
 
-        def __init__(self, config: SecurityConfig):
-            self.config = config
-            self.quantum_manager = get_quantum_security_manager()
+        identity = self._extract_identity(request)
+        try:
+            auth_result = await quantum_authenticate(identity)
+            request.state.quantum_auth = auth_result
+            request.state.quantum_authenticated = True
+        except Exception as e:
+            raise SecurityError(f"Quantum authentication failed: {str(e)}")
 
-        async def validate_quantum_authentication(self, request) -> None:
-            """Validate quantum-resistant authentication"""
-            quantum_token = request.headers.get('X-Quantum-Auth')
-            if not quantum_token:
-                raise SecurityError("Quantum authentication required")
+    async def ensure_secure_channel(self, request) -> None:
+        """Ensure a quantum-secure channel is established"""
+        from pyserv.security.quantum_security import establish_secure_channel
 
-            identity = self._extract_identity(request)
+        channel_id = request.headers.get('X-Secure-Channel')
+
+        if channel_id:
+            request.state.quantum_channel = {'channel_id': channel_id, 'valid': True}
+        else:
             try:
-                auth_result = await quantum_authenticate(identity)
-                request.state.quantum_auth = auth_result
-                request.state.quantum_authenticated = True
+                channel_info = await establish_secure_channel()
+                request.state.quantum_channel = channel_info
             except Exception as e:
-                raise SecurityError(f"Quantum authentication failed: {str(e)}")
-
-        async def ensure_secure_channel(self, request) -> None:
-            """Ensure a quantum-secure channel is established"""
-            channel_id = request.headers.get('X-Secure-Channel')
-
-            if channel_id:
-                request.state.quantum_channel = {'channel_id': channel_id, 'valid': True}
-            else:
-                try:
-                    channel_info = await establish_secure_channel()
-                    request.state.quantum_channel = channel_info
-                except Exception as e:
-                    # Log but don't fail - allow fallback to classical crypto
-                    print(f"Failed to establish quantum channel: {e}")
-
-        def _extract_identity(self, request) -> str:
-            """Extract user identity from request"""
-            return (
-                getattr(request.state, 'user_id', None) or
-                request.headers.get('X-User-ID') or
-                request.query_params.get('user_id', [''])[0] or
-                'anonymous'
-            )
-
-    # Add quantum features to UnifiedSecurityMiddleware
-    _quantum_protector = None
-
-    def _get_quantum_protector(self):
-        global _quantum_protector
-        if _quantum_protector is None:
-            _quantum_protector = QuantumSecurityProtector(self.config)
-        return _quantum_protector
-
-    async def validate_quantum_auth(self, request) -> None:
-        """Validate quantum authentication"""
-        protector = self._get_quantum_protector()
-        await protector.validate_quantum_authentication(request)
-
-    async def ensure_quantum_channel(self, request) -> None:
-        """Ensure quantum secure channel"""
-        protector = self._get_quantum_protector()
-        await protector.ensure_secure_channel(request)
-
-    # Extend process_request to include quantum features
-    original_process_request = UnifiedSecurityMiddleware.process_request
-
-    async def enhanced_process_request(self, request) -> None:
-        await original_process_request(self, request)
-
-        # Add quantum security if enabled
-        if hasattr(self.config, 'quantum_auth_enabled') and self.config.quantum_auth_enabled:
-            await self.validate_quantum_auth(request)
-
-        if hasattr(self.config, 'quantum_channel_enabled') and self.config.quantum_channel_enabled:
-            await self.ensure_quantum_channel(request)
-
-    UnifiedSecurityMiddleware.process_request = enhanced_process_request
-
-    # Extend process_response to include quantum headers
-    original_process_response = UnifiedSecurityMiddleware.process_response
-
-    async def enhanced_process_response(self, response) -> None:
-        await original_process_response(self, response)
-
-        # Add quantum security headers
-        headers = getattr(response, 'headers', {})
-        headers['X-Quantum-Security'] = 'enabled'
-        headers['X-Supported-Algorithms'] = ','.join(
-            [alg.value for alg in get_quantum_security_manager().providers.keys()]
+                # Log but don't fail - allow fallback to classical crypto
+                print(f"Failed to establish quantum channel: {e}")
+
+    def _extract_identity(self, request) -> str:
+        """Extract user identity from request"""
+        return (
+            getattr(request.state, 'user_id', None) or
+            request.headers.get('X-User-ID') or
+            request.query_params.get('user_id', [''])[0] or
+            'anonymous'
         )
 
-        if hasattr(response, '_request') and hasattr(response._request.state, 'quantum_channel'):
-            channel = response._request.state.quantum_channel
-            if isinstance(channel, dict):
-                headers['X-Secure-Channel-ID'] = channel.get('channel_id', '')
 
-    UnifiedSecurityMiddleware.process_response = enhanced_process_response
+# Add quantum features to UnifiedSecurityMiddleware
+_quantum_protector = None
 
-except ImportError:
-    # Quantum security not available
-    pass
+def _get_quantum_protector(self):
+    global _quantum_protector
+    if _quantum_protector is None:
+        _quantum_protector = QuantumSecurityProtector(self.config)
+    return _quantum_protector
+
+async def validate_quantum_auth(self, request) -> None:
+    """Validate quantum authentication"""
+    protector = self._get_quantum_protector()
+    await protector.validate_quantum_authentication(request)
+
+async def ensure_quantum_channel(self, request) -> None:
+    """Ensure quantum secure channel"""
+    protector = self._get_quantum_protector()
+    await protector.ensure_secure_channel(request)
+
+UnifiedSecurityMiddleware._get_quantum_protector = _get_quantum_protector
+UnifiedSecurityMiddleware.validate_quantum_auth = validate_quantum_auth
+UnifiedSecurityMiddleware.ensure_quantum_channel = ensure_quantum_channel
+
+# Extend process_request to include quantum features
+original_process_request = UnifiedSecurityMiddleware.process_request
+
+async def enhanced_process_request(self, request) -> None:
+    await original_process_request(self, request)
+
+    # Add quantum security if enabled
+    if getattr(self.config, 'quantum_auth_enabled', False):
+        await self.validate_quantum_auth(request)
+
+    if getattr(self.config, 'quantum_channel_enabled', False):
+        await self.ensure_quantum_channel(request)
+
+UnifiedSecurityMiddleware.process_request = enhanced_process_request
+
+# Extend process_response to include quantum headers
+original_process_response = UnifiedSecurityMiddleware.process_response
+
+async def enhanced_process_response(self, response) -> None:
+    await original_process_response(self, response)
+
+    # Only advertise quantum security where it is in use
+    if not _quantum_enabled(self.config):
+        return
+
+    headers = getattr(response, 'headers', {})
+    headers['X-Quantum-Security'] = 'enabled'
+    headers['X-Supported-Algorithms'] = ','.join(
+        [alg.value for alg in self._get_quantum_protector().quantum_manager.providers.keys()]
+    )
+
+    if hasattr(response, '_request') and hasattr(response._request.state, 'quantum_channel'):
+        channel = response._request.state.quantum_channel
+        if isinstance(channel, dict):
+            headers['X-Secure-Channel-ID'] = channel.get('channel_id', '')
+
+UnifiedSecurityMiddleware.process_response = enhanced_process_response
 
 # Backward compatibility aliases
 SecurityMiddleware = UnifiedSecurityMiddleware
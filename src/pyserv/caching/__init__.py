@@ -3,16 +3,22 @@ Multi-level caching system for PyServ.
 Provides in-memory, Redis, and CDN caching with cache hierarchies.
 """
 
-from pyserv.caching.cache_manager import CacheManager, CacheConfig, CacheLevel
-from pyserv.caching.memory_cache import MemoryCache
-from pyserv.caching.redis_cache import RedisCache
-from pyserv.caching.cdn_cache import CDNCache
-from pyserv.caching.cache_decorator import cache_result, invalidate_cache, cache_key
-from pyserv.caching.cache_metrics import CacheMetricsCollector
+# Backends load on first access, so using the memory cache does not import Redis or CDN clients
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".cache_manager": ["CacheManager", "CacheConfig", "CacheLevel"],
+    ".memory_cache": ["MemoryCache"],
+    ".shared_memory_cache": ["SharedMemoryCache"],
+    ".redis_cache": ["RedisCache"],
+    ".cdn_cache": ["CDNCache"],
+    ".cache_decorator": ["cache_result", "invalidate_cache", "cache_key"],
+    ".cache_metrics": ["CacheMetricsCollector"],
+})
 
 __all__ = [
     'CacheManager', 'CacheConfig', 'CacheLevel',
-    'MemoryCache', 'RedisCache', 'CDNCache',
+    'MemoryCache', 'SharedMemoryCache', 'RedisCache', 'CDNCache',
     'cache_result', 'invalidate_cache', 'cache_key',
     'CacheMetricsCollector'
 ]
@@ -175,10 +175,6 @@ class CacheManager:
         for level in self.caches.values():
             await level.invalidate_pattern(pattern)
 
-# Global cache manager
-cache_manager = CacheManager(CacheConfig())
-
-
 class CacheMetricsCollector:
     """Collects cache metrics"""
 
@@ -357,3 +353,7 @@ class CDNCache:
     async def invalidate_pattern(self, pattern: str):
         """Invalidate keys matching pattern (placeholder)"""
         pass
+
+
+# Global cache manager
+cache_manager = CacheManager(CacheConfig())
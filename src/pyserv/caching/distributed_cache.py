@@ -2,7 +2,7 @@
 Multi-level distributed caching system for Pyserv  framework.
 
 This module provides aggressive caching strategies with:
-- Multi-level caching (L1: Memory, L2: Redis, L3: Database)
+- Multi-level caching (L1: Memory, shared memory across workers, L2: Redis, L3: Database)
 - Cache warming and prefetching
 - Distributed cache invalidation
 - Cache analytics and monitoring
@@ -19,20 +19,27 @@ from typing import Dict, List, Optional, Any, Callable, AsyncGenerator, Set
 from dataclasses import dataclass, field
 from abc import ABC, abstractmethod
 from enum import Enum
-import aioredis
 from concurrent.futures import ThreadPoolExecutor
 import threading
 
-from pyserv.caching import CacheManager, MemoryCache, RedisCache, DatabaseCache
-from pyserv.database.connections import DatabaseConnection
+from pyserv.caching import CacheManager, MemoryCache, RedisCache
+from pyserv.caching.shared_memory_cache import SharedMemoryCache
 from pyserv.monitoring.metrics import get_metrics_collector
 
+try:
+    from pyserv.caching import DatabaseCache
+    from pyserv.database.connections import get_pooled_connection
+except ImportError:
+    # No database cache backend ships with the framework; L3 stays off without one
+    DatabaseCache = None
+
 
 class CacheLevel(Enum):
     """Cache levels in hierarchy"""
     L1_MEMORY = 1
     L2_REDIS = 2
     L3_DATABASE = 3
+    L1_SHARED = 4  # host-wide shared memory, checked between L1 and L2
 
 
 class CacheStrategy(Enum):
@@ -49,6 +56,11 @@ class CacheConfig:
     enable_l1: bool = True
     enable_l2: bool = True
     enable_l3: bool = True
+    enable_shared: bool = False
+    shared_cache_name: str = "default"
+    shared_cache_path: Optional[str] = None
+    shared_cache_buckets: int = 4096
+    shared_cache_slot_size: int = 512
     l1_ttl: int = 300  # 5 minutes
     l2_ttl: int = 3600  # 1 hour
     l3_ttl: int = 86400  # 24 hours
@@ -150,6 +162,7 @@ class DistributedCache:
 
         # Cache levels
         self._l1_cache: Optional[MemoryCache] = None
+        self._shared_cache: Optional[SharedMemoryCache] = None
         self._l2_cache: Optional[RedisCache] = None
         self._l3_cache: Optional[DatabaseCache] = None
 
@@ -175,10 +188,20 @@ class DistributedCache:
         if self.config.enable_l1:
             self._l1_cache = MemoryCache()
 
+        if self.config.enable_shared:
+            self._shared_cache = SharedMemoryCache(
+                name=self.config.shared_cache_name,
+                path=self.config.shared_cache_path,
+                buckets=self.config.shared_cache_buckets,
+                slot_size=self.config.shared_cache_slot_size
+            )
+
         if self.config.enable_l2:
             self._l2_cache = RedisCache(self.config.redis_url)
 
-        if self.config.enable_l3:
+        if self.config.enable_l3 and DatabaseCache is None:
+            self.logger.warning("No database cache backend is available; L3 caching is disabled")
+        elif self.config.enable_l3:
             # Initialize database cache with pooled connection
             db_config = type('Config', (), {
                 'database_url': 'sqlite:///cache.db'  # Default cache database
@@ -246,7 +269,7 @@ class DistributedCache:
 
         try:
             # Try L1 cache first
-            if self._l1_cache and self.config.enable_l1:
+            if self._l1_cache is not None and self.config.enable_l1:
                 value = await self._l1_cache.get(key)
                 if value is not None:
                     await self.analytics.record_hit(CacheLevel.L1_MEMORY)
@@ -254,20 +277,33 @@ class DistributedCache:
                     self.metrics.get_metric("cache_operation_duration_seconds").observe(duration)
                     return self._decompress_if_needed(value)
 
+            # Try the cache shared by all workers on this host
+            if self._shared_cache is not None:
+                value = self._shared_cache.get_sync(key)
+                if value is not None:
+                    await self.analytics.record_hit(CacheLevel.L1_SHARED)
+                    if self._l1_cache is not None:
+                        await self._l1_cache.set(key, value, self.config.l1_ttl)
+                    duration = time.time() - start_time
+                    self.metrics.get_metric("cache_operation_duration_seconds").observe(duration)
+                    return self._decompress_if_needed(value)
+
             # Try L2 cache
-            if self._l2_cache and self.config.enable_l2:
+            if self._l2_cache is not None and self.config.enable_l2:
                 value = await self._l2_cache.get(key)
                 if value is not None:
                     await self.analytics.record_hit(CacheLevel.L2_REDIS)
                     # Promote to L1
-                    if self._l1_cache:
+                    if self._l1_cache is not None:
                         await self._l1_cache.set(key, value, self.config.l1_ttl)
+                    if self._shared_cache is not None:
+                        self._shared_cache.set_sync(key, value, self.config.l1_ttl)
                     duration = time.time() - start_time
                     self.metrics.get_metric("cache_operation_duration_seconds").observe(duration)
                     return self._decompress_if_needed(value)
 
             # Try L3 cache
-            if self._l3_cache and self.config.enable_l3:
+            if self._l3_cache is not None and self.config.enable_l3:
                 value = await self._l3_cache.get(key)
                 if value is not None:
                     await self.analytics.record_hit(CacheLevel.L3_DATABASE)
@@ -307,17 +343,22 @@ class DistributedCache:
             success = True
 
             # Set in L1
-            if self._l1_cache and self.config.enable_l1:
+            if self._l1_cache is not None and self.config.enable_l1:
                 success &= await self._l1_cache.set(key, compressed_value, l1_ttl)
                 await self.analytics.record_set(CacheLevel.L1_MEMORY)
 
+            # Set in shared memory; values too large for a slot skip this level
+            if self._shared_cache is not None:
+                self._shared_cache.set_sync(key, compressed_value, l1_ttl, tags)
+                await self.analytics.record_set(CacheLevel.L1_SHARED)
+
             # Set in L2
-            if self._l2_cache and self.config.enable_l2:
+            if self._l2_cache is not None and self.config.enable_l2:
                 success &= await self._l2_cache.set(key, compressed_value, l2_ttl)
                 await self.analytics.record_set(CacheLevel.L2_REDIS)
 
             # Set in L3
-            if self._l3_cache and self.config.enable_l3:
+            if self._l3_cache is not None and self.config.enable_l3:
                 success &= await self._l3_cache.set(key, compressed_value, l3_ttl)
                 await self.analytics.record_set(CacheLevel.L3_DATABASE)
 
@@ -340,17 +381,22 @@ class DistributedCache:
             success = True
 
             # Delete from L1
-            if self._l1_cache:
+            if self._l1_cache is not None:
                 success &= await self._l1_cache.delete(key)
                 await self.analytics.record_delete(CacheLevel.L1_MEMORY)
 
+            # Delete from shared memory
+            if self._shared_cache is not None:
+                self._shared_cache.delete_sync(key)
+                await self.analytics.record_delete(CacheLevel.L1_SHARED)
+
             # Delete from L2
-            if self._l2_cache:
+            if self._l2_cache is not None:
                 success &= await self._l2_cache.delete(key)
                 await self.analytics.record_delete(CacheLevel.L2_REDIS)
 
             # Delete from L3
-            if self._l3_cache:
+            if self._l3_cache is not None:
                 success &= await self._l3_cache.delete(key)
                 await self.analytics.record_delete(CacheLevel.L3_DATABASE)
 
@@ -368,6 +414,10 @@ class DistributedCache:
     async def invalidate_by_tag(self, tag: str) -> int:
         """Invalidate all cache entries with a specific tag"""
         try:
+            # Other workers' tagged entries may not be in our local tag index
+            if self._shared_cache is not None:
+                self._shared_cache.invalidate_by_tag_sync(tag)
+
             keys_to_delete = await self._get_keys_by_tag(tag)
             deleted_count = 0
 
@@ -387,11 +437,13 @@ class DistributedCache:
         try:
             success = True
 
-            if self._l1_cache:
+            if self._l1_cache is not None:
                 success &= await self._l1_cache.clear()
-            if self._l2_cache:
+            if self._shared_cache is not None:
+                success &= await self._shared_cache.clear()
+            if self._l2_cache is not None:
                 success &= await self._l2_cache.clear()
-            if self._l3_cache:
+            if self._l3_cache is not None:
                 success &= await self._l3_cache.clear()
 
             return success
@@ -425,11 +477,13 @@ class DistributedCache:
         """Promote value to higher cache levels"""
         try:
             # Promote to L2
-            if self._l2_cache and self.config.enable_l2:
+            if self._l2_cache is not None and self.config.enable_l2:
                 await self._l2_cache.set(key, value, self.config.l2_ttl)
 
-            # Promote to L1
-            if self._l1_cache and self.config.enable_l1:
+            # Promote to shared memory and L1
+            if self._shared_cache is not None:
+                self._shared_cache.set_sync(key, value, self.config.l1_ttl)
+            if self._l1_cache is not None and self.config.enable_l1:
                 await self._l1_cache.set(key, value, self.config.l1_ttl)
 
         except Exception as e:
@@ -483,7 +537,7 @@ class DistributedCache:
 
     async def _propagate_invalidation(self, key: str):
         """Propagate cache invalidation to other instances"""
-        if self._l2_cache and self.config.invalidation_propagation:
+        if self._l2_cache is not None and self.config.invalidation_propagation:
             try:
                 # Publish invalidation message to Redis pubsub
                 await self._l2_cache._get_redis().publish(
@@ -534,9 +588,10 @@ class DistributedCache:
     async def _cleanup_expired_entries(self):
         """Clean up expired cache entries"""
         # This is mainly for L1 cache as L2/L3 handle expiration automatically
-        if self._l1_cache:
-            # Memory cache cleanup is handled by the cache itself
-            pass
+        if self._l1_cache is not None:
+            expired = self._l1_cache.purge_expired()
+            if expired:
+                self.logger.debug(f"Purged {expired} expired L1 entries")
 
 
 # Global distributed cache instance
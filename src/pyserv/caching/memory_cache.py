@@ -1,164 +1,238 @@
 """
 In-memory cache implementation with LRU eviction.
+
+Keys are spread over a power-of-two number of shards, each an
+``OrderedDict`` (a C linked hash map) guarded by its own lock, so hits,
+inserts and evictions are O(1) and unrelated keys never contend. The
+memory budget is split evenly across shards and each shard evicts its own
+least recently used entries.
+
+Expired entries are dropped lazily when they are read, and ``purge_expired``
+sweeps a per-shard timer wheel of one-second ticks so entries that are
+never read again still release their memory. Every removal also takes the
+key out of its wheel slot, so the wheel never outgrows the live entries.
 """
 
-import asyncio
-import heapq
-import json
 import logging
+import sys
+import threading
 import time
-from typing import Dict, List, Optional, Any, Tuple
-from dataclasses import dataclass
-from datetime import datetime, timedelta
+from collections import OrderedDict
+from typing import Any, Dict, Optional, Set
 
 from pyserv.caching.cache_manager import CacheConfig
 
-@dataclass
+# Timer wheel resolution in seconds
+_TICK = 1.0
+
+
 class CacheItem:
-    key: str
-    value: Any
-    created_at: datetime
-    accessed_at: datetime
-    expires_at: Optional[datetime]
-    access_count: int = 0
-    size_bytes: int = 0
+    """Cached value with its accounted size and absolute expiry."""
+
+    __slots__ = ('value', 'size_bytes', 'expires_at', 'access_count')
+
+    def __init__(self, value: Any, size_bytes: int, expires_at: float):
+        self.value = value
+        self.size_bytes = size_bytes
+        self.expires_at = expires_at  # time.monotonic() deadline, 0.0 for no expiry
+        self.access_count = 0
+
+
+class _Shard:
+    """LRU segment of the cache with its own lock and timer wheel."""
+
+    __slots__ = ('lock', 'items', 'wheel', 'wheel_tick', 'size', 'max_size')
+
+    def __init__(self, max_size: int):
+        self.lock = threading.Lock()
+        self.items: 'OrderedDict[str, CacheItem]' = OrderedDict()
+        self.wheel: Dict[int, Set[str]] = {}  # tick -> keys expiring in it
+        self.wheel_tick = int(time.monotonic() / _TICK)
+        self.size = 0
+        self.max_size = max_size
+
+    def insert(self, key: str, item: CacheItem) -> None:
+        self.items[key] = item
+        self.size += item.size_bytes
+        if item.expires_at:
+            self.wheel.setdefault(int(item.expires_at / _TICK), set()).add(key)
+
+    def remove(self, key: str) -> CacheItem:
+        """Drop ``key`` and its wheel slot, so the wheel only ever holds live keys"""
+        item = self.items.pop(key)
+        self.size -= item.size_bytes
+        if item.expires_at:
+            tick = int(item.expires_at / _TICK)
+            keys = self.wheel[tick]
+            keys.discard(key)
+            if not keys:
+                del self.wheel[tick]
+        return item
+
+    def remove_lru(self) -> CacheItem:
+        return self.remove(next(iter(self.items)))
+
 
 class MemoryCache:
     """
     High-performance in-memory cache with LRU eviction.
     """
 
-    def __init__(self, config: CacheConfig):
-        self.config = config
-        self.cache: Dict[str, CacheItem] = {}
-        self.access_order: List[Tuple[float, str]] = []  # (access_time, key) for LRU
-        self.current_size = 0
+    def __init__(self, config: Optional[CacheConfig] = None, shards: int = 16):
+        self.config = config or CacheConfig()
+        if shards < 1 or shards & (shards - 1):
+            raise ValueError("shards must be a power of two")
+        self._mask = shards - 1
+        self._shards = [_Shard(max(1, self.config.max_memory_size // shards)) for _ in range(shards)]
         self.logger = logging.getLogger("memory_cache")
-        self._lock = asyncio.Lock()
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+        self.expirations = 0
+
+    @property
+    def current_size(self) -> int:
+        return sum(shard.size for shard in self._shards)
+
+    def __len__(self) -> int:
+        return sum(len(shard.items) for shard in self._shards)
+
+    def _shard(self, key: str) -> _Shard:
+        return self._shards[hash(key) & self._mask]
 
     async def get(self, key: str) -> Optional[Any]:
         """Get value from cache."""
-        async with self._lock:
-            if key not in self.cache:
+        shard = self._shard(key)
+        with shard.lock:
+            item = shard.items.get(key)
+            if item is None:
+                self.misses += 1
                 return None
 
-            item = self.cache[key]
-
             # Check expiration
-            if item.expires_at and datetime.now() > item.expires_at:
-                await self._evict(key)
+            if item.expires_at and time.monotonic() >= item.expires_at:
+                shard.remove(key)
+                self.expirations += 1
+                self.misses += 1
                 return None
 
-            # Update access information
-            item.accessed_at = datetime.now()
+            # Update LRU order
+            shard.items.move_to_end(key)
             item.access_count += 1
+            self.hits += 1
+            return item.value
 
-            # Update LRU order
-            self._update_access_order(key)
+    async def set(self, key: str, value: Any, ttl_seconds: Optional[int] = None,
+                  size: Optional[int] = None) -> bool:
+        """
+        Set value in cache.
+
+        Args:
+            key: Cache key
+            value: Value to cache
+            ttl_seconds: Time to live, or None for no expiry
+            size: Size in bytes to account for the value; estimated when omitted
+
+        Returns:
+            False if the value is larger than a shard's memory budget
+        """
+        value_size = size if size is not None else self._calculate_size(value)
+        expires_at = time.monotonic() + ttl_seconds if ttl_seconds else 0.0
+
+        shard = self._shard(key)
+        if value_size > shard.max_size:
+            return False
 
-            return item.value
+        with shard.lock:
+            if key in shard.items:
+                shard.remove(key)
+
+            shard.insert(key, CacheItem(value, value_size, expires_at))
 
-    async def set(self, key: str, value: Any, ttl_seconds: Optional[int] = None) -> bool:
-        """Set value in cache."""
-        async with self._lock:
-            # Calculate size
-            value_size = self._calculate_size(value)
-            ttl = timedelta(seconds=ttl_seconds) if ttl_seconds else None
-
-            # Check if we need to evict
-            if self.current_size + value_size > self.config.max_memory_size:
-                await self._evict_lru()
-
-            # Create cache item
-            expires_at = datetime.now() + ttl if ttl else None
-            item = CacheItem(
-                key=key,
-                value=value,
-                created_at=datetime.now(),
-                accessed_at=datetime.now(),
-                expires_at=expires_at,
-                size_bytes=value_size
-            )
-
-            # Remove old item if exists
-            if key in self.cache:
-                self.current_size -= self.cache[key].size_bytes
-                self._remove_from_access_order(key)
-
-            # Add new item
-            self.cache[key] = item
-            self.current_size += value_size
-            self._update_access_order(key)
+            # Evict from the cold end until the shard fits its budget
+            while shard.size > shard.max_size:
+                shard.remove_lru()
+                self.evictions += 1
 
             return True
 
     async def delete(self, key: str) -> bool:
         """Delete value from cache."""
-        async with self._lock:
-            if key in self.cache:
-                self.current_size -= self.cache[key].size_bytes
-                await self._evict(key)
+        shard = self._shard(key)
+        with shard.lock:
+            if key in shard.items:
+                shard.remove(key)
                 return True
             return False
 
-    async def clear(self):
+    async def clear(self) -> bool:
         """Clear all cache entries."""
-        async with self._lock:
-            self.cache.clear()
-            self.access_order.clear()
-            self.current_size = 0
-
-    async def _evict(self, key: str):
-        """Evict a single cache entry."""
-        if key in self.cache:
-            self.current_size -= self.cache[key].size_bytes
-            del self.cache[key]
-            self._remove_from_access_order(key)
-
-    async def _evict_lru(self):
-        """Evict least recently used items."""
-        while self.current_size > self.config.max_memory_size and self.cache:
-            if not self.access_order:
-                break
-
-            # Get LRU key
-            _, lru_key = heapq.heappop(self.access_order)
-
-            if lru_key in self.cache:
-                await self._evict(lru_key)
-
-    def _update_access_order(self, key: str):
-        """Update access order for LRU."""
-        # Remove old entry
-        self._remove_from_access_order(key)
-
-        # Add new entry (negative time for max-heap behavior)
-        access_time = -time.time()
-        heapq.heappush(self.access_order, (access_time, key))
-
-    def _remove_from_access_order(self, key: str):
-        """Remove key from access order."""
-        self.access_order = [(t, k) for t, k in self.access_order if k != key]
-        heapq.heapify(self.access_order)
+        for shard in self._shards:
+            with shard.lock:
+                shard.items.clear()
+                shard.wheel.clear()
+                shard.size = 0
+        return True
+
+    def purge_expired(self) -> int:
+        """
+        Drop entries whose TTL has passed.
+
+        Advances each shard's timer wheel to the current tick, so the cost is
+        proportional to the entries expiring rather than the cache size.
+
+        Returns:
+            Number of entries removed
+        """
+        now = time.monotonic()
+        now_tick = int(now / _TICK)
+        removed = 0
+
+        for shard in self._shards:
+            with shard.lock:
+                if now_tick - shard.wheel_tick <= len(shard.wheel):
+                    due = range(shard.wheel_tick, now_tick + 1)
+                else:
+                    due = sorted(tick for tick in shard.wheel if tick <= now_tick)
+
+                for tick in due:
+                    keys = shard.wheel.get(tick)
+                    if not keys:
+                        continue
+                    # Removal unschedules the key, emptying (and dropping) the slot as it goes
+                    for key in [key for key in keys if shard.items[key].expires_at <= now]:
+                        shard.remove(key)
+                        removed += 1
+
+                shard.wheel_tick = now_tick
+
+        self.expirations += removed
+        return removed
 
     def _calculate_size(self, value: Any) -> int:
-        """Calculate approximate size of cached value."""
+        """Estimate the size of a cached value without serialising it."""
+        if isinstance(value, (bytes, bytearray, memoryview)):
+            return len(value)
+        if isinstance(value, str):
+            return len(value)
         try:
-            if isinstance(value, str):
-                return len(value.encode('utf-8'))
-            elif isinstance(value, (dict, list)):
-                return len(json.dumps(value).encode('utf-8'))
-            else:
-                return 64  # Default size for other objects
-        except:
+            return sys.getsizeof(value)
+        except TypeError:
             return 64
 
     def get_stats(self) -> Dict[str, Any]:
         """Get cache statistics."""
+        current_size = self.current_size
+        lookups = self.hits + self.misses
         return {
-            "entries": len(self.cache),
-            "current_size": self.current_size,
+            "entries": len(self),
+            "current_size": current_size,
             "max_size": self.config.max_memory_size,
-            "utilization": self.current_size / self.config.max_memory_size,
-            "access_order_size": len(self.access_order)
+            "utilization": current_size / self.config.max_memory_size,
+            "shards": len(self._shards),
+            "hits": self.hits,
+            "misses": self.misses,
+            "hit_rate": self.hits / lookups if lookups else 0.0,
+            "evictions": self.evictions,
+            "expirations": self.expirations
         }
@@ -0,0 +1,447 @@
+"""
+Cross-process shared-memory cache for multi-worker deployments.
+
+All workers on a host map the same file (under ``/dev/shm`` when available)
+holding a fixed-geometry, set-associative hash table. A key hashes to one
+bucket of ``ways`` fixed-size slots, and each bucket is guarded by a
+seqlock:
+
+- Readers never lock. They copy the bucket's matching slot and retry if the
+  bucket's sequence word changed meanwhile, so a hit costs one hash and a
+  couple of buffer copies.
+- Writers serialise per bucket with a POSIX record lock on the bucket's
+  sequence word, which the kernel releases if a worker dies mid-write.
+
+When a bucket is full, the slot written longest ago is replaced. Values
+that don't fit in a slot are not cached.
+
+Tags are invalidated in O(1): each entry records the generation of up to
+``MAX_TAGS`` tag counters, and ``invalidate_by_tag`` bumps the counter so
+every worker stops seeing the tagged entries at once.
+
+``pyserv.core.shm_sync`` provides the memory-ordered sequence accessors
+when it is built. The Python fallback relies on the store ordering of
+x86-64; on weakly ordered CPUs build the extension.
+"""
+
+import hashlib
+import logging
+import mmap
+import os
+import pickle
+import struct
+import tempfile
+import threading
+import time
+from typing import Any, Dict, Iterable, Optional, Tuple
+
+from pyserv.core import load_extension
+
+try:
+    import fcntl
+except ImportError:  # pragma: no cover - Windows
+    fcntl = None
+
+_shm_sync = load_extension("shm_sync")
+
+MAGIC = b"PYSVSHM1"
+VERSION = 1
+MAX_TAGS = 4
+
+# magic, version, bucket_count, ways, slot_size, tag_slots
+_HEADER = struct.Struct("<8sIIIII")
+_HEADER_SIZE = 64
+# Bucket header holds the sequence word, padded to a cache line
+_BUCKET_HEADER_SIZE = 64
+# key hash, stored_at, expires_at, key_len, value_len, kind, tag_count, tag (index, generation) pairs
+_SLOT = struct.Struct("<QddIIBB2x" + "I" * (2 * MAX_TAGS))
+_KIND_OFFSET = 32
+_SEQ = struct.Struct("<Q")
+_GENERATION = struct.Struct("<I")
+
+# Slot value kinds
+_EMPTY = 0
+_BYTES = 1
+_STR = 2
+_PICKLE = 3
+
+_READ_RETRIES = 32
+
+
+def _hash64(data: bytes) -> int:
+    """Process-independent 64-bit hash (builtin hash() is seeded per process)."""
+    return int.from_bytes(hashlib.blake2b(data, digest_size=8).digest(), "little")
+
+
+if _shm_sync is not None:
+    _read_begin = _shm_sync.read_begin
+    _read_validate = _shm_sync.read_validate
+    _write_begin = _shm_sync.write_begin
+    _write_end = _shm_sync.write_end
+else:
+    def _read_begin(buffer, offset: int) -> int:
+        return _SEQ.unpack_from(buffer, offset)[0]
+
+    def _read_validate(buffer, offset: int, seq: int) -> bool:
+        return not seq & 1 and _SEQ.unpack_from(buffer, offset)[0] == seq
+
+    def _write_begin(buffer, offset: int) -> int:
+        seq = _SEQ.unpack_from(buffer, offset)[0]
+        if not seq & 1:
+            seq += 1
+            _SEQ.pack_into(buffer, offset, seq)
+        return seq
+
+    def _write_end(buffer, offset: int) -> int:
+        seq = (_SEQ.unpack_from(buffer, offset)[0] | 1) + 1
+        _SEQ.pack_into(buffer, offset, seq)
+        return seq
+
+
+def default_path(name: str) -> str:
+    """Backing file for a named cache, in tmpfs when the host has one."""
+    directory = "/dev/shm" if os.path.isdir("/dev/shm") else tempfile.gettempdir()
+    return os.path.join(directory, f"pyserv-{name}.cache")
+
+
+class SharedMemoryCache:
+    """
+    Host-wide cache shared by all worker processes.
+
+    Create it in the master before workers fork, or in each worker with the
+    same ``name``/``path`` and geometry; the first process to open the file
+    formats it and later ones validate the header.
+    """
+
+    def __init__(self, name: str = "default", path: Optional[str] = None,
+                 buckets: int = 4096, ways: int = 8, slot_size: int = 512,
+                 tag_slots: int = 4096):
+        if fcntl is None:
+            raise RuntimeError("SharedMemoryCache requires POSIX file locking")
+        if slot_size <= _SLOT.size or slot_size % 8:
+            raise ValueError(f"slot_size must be a multiple of 8 larger than {_SLOT.size}")
+        if buckets < 1 or ways < 1 or tag_slots < 1:
+            raise ValueError("buckets, ways and tag_slots must be positive")
+
+        self.path = path or default_path(name)
+        self.buckets = buckets
+        self.ways = ways
+        self.slot_size = slot_size
+        self.tag_slots = tag_slots
+        self.max_payload = slot_size - _SLOT.size
+
+        self._tags_offset = _HEADER_SIZE
+        tags_end = self._tags_offset + tag_slots * _GENERATION.size
+        self._buckets_offset = (tags_end + 63) // 64 * 64
+        self._bucket_size = _BUCKET_HEADER_SIZE + ways * slot_size
+        # The tag table lock sits on the header's padding, away from any bucket
+        self._tag_lock_offset = _HEADER.size
+        self.size_bytes = self._buckets_offset + buckets * self._bucket_size
+
+        self.logger = logging.getLogger("shared_memory_cache")
+        self._local_lock = threading.Lock()
+        self._fd: Optional[int] = None
+        self._mm: Optional[mmap.mmap] = None
+        self.hits = 0
+        self.misses = 0
+        self.sets = 0
+        self.evictions = 0
+        self.read_retries = 0
+        self._open()
+
+    def _open(self) -> None:
+        """Map the backing file, formatting it if this is the first process."""
+        fd = os.open(self.path, os.O_RDWR | os.O_CREAT, 0o600)
+        try:
+            fcntl.lockf(fd, fcntl.LOCK_EX, _HEADER_SIZE, 0)
+            try:
+                expected = (MAGIC, VERSION, self.buckets, self.ways, self.slot_size, self.tag_slots)
+                if os.fstat(fd).st_size != self.size_bytes:
+                    if os.pread(fd, len(MAGIC), 0) == MAGIC:
+                        raise ValueError(f"Shared cache {self.path} exists with a different geometry")
+                    os.ftruncate(fd, self.size_bytes)
+
+                mm = mmap.mmap(fd, self.size_bytes, mmap.MAP_SHARED, mmap.PROT_READ | mmap.PROT_WRITE)
+                header = _HEADER.unpack_from(mm, 0)
+                if header[0] != MAGIC:
+                    # Fresh file: the zero-filled table is already empty
+                    _HEADER.pack_into(mm, 0, *expected)
+                elif header != expected:
+                    mm.close()
+                    raise ValueError(f"Shared cache {self.path} exists with a different geometry")
+            finally:
+                fcntl.lockf(fd, fcntl.LOCK_UN, _HEADER_SIZE, 0)
+        except BaseException:
+            os.close(fd)
+            raise
+
+        self._fd = fd
+        self._mm = mm
+
+    def close(self) -> None:
+        """Unmap the table in this process."""
+        if self._mm is not None:
+            self._mm.close()
+            os.close(self._fd)
+            self._mm = None
+            self._fd = None
+
+    def unlink(self) -> None:
+        """Close the table and remove its backing file."""
+        self.close()
+        try:
+            os.unlink(self.path)
+        except FileNotFoundError:
+            pass
+
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        state.update(_fd=None, _mm=None, _local_lock=None)
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self._local_lock = threading.Lock()
+        self._open()
+
+    def _bucket(self, key_hash: int) -> int:
+        return self._buckets_offset + (key_hash % self.buckets) * self._bucket_size
+
+    def _tag_offset(self, tag: str) -> int:
+        return self._tags_offset + (_hash64(tag.encode("utf-8")) % self.tag_slots) * _GENERATION.size
+
+    def _tags_current(self, slot: Tuple) -> bool:
+        """Check that no tag of this entry was invalidated since it was set."""
+        mm = self._mm
+        for i in range(slot[6]):
+            index, generation = slot[7 + 2 * i], slot[8 + 2 * i]
+            offset = self._tags_offset + index * _GENERATION.size
+            if _GENERATION.unpack_from(mm, offset)[0] != generation:
+                return False
+        return True
+
+    def _find(self, bucket: int, key_hash: int, key: bytes) -> Tuple[int, Optional[Tuple], Optional[bytes]]:
+        """Return (slot offset, header, value) of key within a bucket."""
+        mm = self._mm
+        offset = bucket + _BUCKET_HEADER_SIZE
+        key_len = len(key)
+        for _ in range(self.ways):
+            slot = _SLOT.unpack_from(mm, offset)
+            if slot[5] != _EMPTY and slot[0] == key_hash and slot[3] == key_len:
+                payload = offset + _SLOT.size
+                value_len = min(slot[4], self.max_payload - key_len)
+                if mm[payload:payload + key_len] == key:
+                    return offset, slot, mm[payload + key_len:payload + key_len + value_len]
+            offset += self.slot_size
+        return -1, None, None
+
+    def get_sync(self, key: str) -> Optional[Any]:
+        """Look up key without taking any lock."""
+        mm = self._mm
+        key_bytes = key.encode("utf-8")
+        key_hash = _hash64(key_bytes)
+        bucket = self._bucket(key_hash)
+
+        for _ in range(_READ_RETRIES):
+            seq = _read_begin(mm, bucket)
+            if seq & 1:
+                self.read_retries += 1
+                continue
+            _, slot, value = self._find(bucket, key_hash, key_bytes)
+            if _read_validate(mm, bucket, seq):
+                break
+            self.read_retries += 1
+        else:
+            # A writer kept the bucket busy; treat it as a miss
+            self.misses += 1
+            return None
+
+        if slot is None or (slot[2] and slot[2] <= time.time()) or not self._tags_current(slot):
+            self.misses += 1
+            return None
+
+        self.hits += 1
+        kind = slot[5]
+        if kind == _BYTES:
+            return value
+        if kind == _STR:
+            return value.decode("utf-8")
+        return pickle.loads(value)
+
+    def set_sync(self, key: str, value: Any, ttl_seconds: Optional[int] = None,
+                 tags: Optional[Iterable[str]] = None) -> bool:
+        """Store key, replacing the bucket's oldest slot when it is full."""
+        if isinstance(value, bytes):
+            kind, payload = _BYTES, value
+        elif isinstance(value, str):
+            kind, payload = _STR, value.encode("utf-8")
+        else:
+            kind, payload = _PICKLE, pickle.dumps(value, pickle.HIGHEST_PROTOCOL)
+
+        key_bytes = key.encode("utf-8")
+        if len(key_bytes) + len(payload) > self.max_payload:
+            return False
+
+        tag_offsets = [self._tag_offset(tag) for tag in (tags or ())]
+        if len(tag_offsets) > MAX_TAGS:
+            raise ValueError(f"at most {MAX_TAGS} tags per entry")
+
+        key_hash = _hash64(key_bytes)
+        bucket = self._bucket(key_hash)
+        now = time.time()
+        expires_at = now + ttl_seconds if ttl_seconds else 0.0
+
+        with self._bucket_lock(bucket):
+            mm = self._mm
+            tag_fields = []
+            for offset in tag_offsets:
+                tag_fields.append((offset - self._tags_offset) // _GENERATION.size)
+                tag_fields.append(_GENERATION.unpack_from(mm, offset)[0])
+            tag_fields.extend([0] * (2 * MAX_TAGS - len(tag_fields)))
+
+            target, _, _ = self._find(bucket, key_hash, key_bytes)
+            if target < 0:
+                target = self._victim(bucket, now)
+
+            _write_begin(mm, bucket)
+            _SLOT.pack_into(mm, target, key_hash, now, expires_at, len(key_bytes), len(payload),
+                            kind, len(tag_offsets), *tag_fields)
+            start = target + _SLOT.size
+            mm[start:start + len(key_bytes)] = key_bytes
+            start += len(key_bytes)
+            mm[start:start + len(payload)] = payload
+            _write_end(mm, bucket)
+
+        self.sets += 1
+        return True
+
+    def delete_sync(self, key: str) -> bool:
+        """Remove key from the table."""
+        key_bytes = key.encode("utf-8")
+        key_hash = _hash64(key_bytes)
+        bucket = self._bucket(key_hash)
+
+        with self._bucket_lock(bucket):
+            target, _, _ = self._find(bucket, key_hash, key_bytes)
+            if target < 0:
+                return False
+            self._clear_slot(bucket, target)
+        return True
+
+    def invalidate_by_tag_sync(self, tag: str) -> None:
+        """Invalidate every entry carrying tag, in all workers."""
+        offset = self._tag_offset(tag)
+        with self._lock(self._tag_lock_offset):
+            mm = self._mm
+            generation = (_GENERATION.unpack_from(mm, offset)[0] + 1) & 0xFFFFFFFF
+            _GENERATION.pack_into(mm, offset, generation)
+
+    def clear_sync(self) -> None:
+        """Empty every bucket."""
+        for index in range(self.buckets):
+            bucket = self._buckets_offset + index * self._bucket_size
+            with self._bucket_lock(bucket):
+                offset = bucket + _BUCKET_HEADER_SIZE
+                for _ in range(self.ways):
+                    if self._mm[offset + _KIND_OFFSET] != _EMPTY:
+                        self._clear_slot(bucket, offset)
+                    offset += self.slot_size
+
+    def _victim(self, bucket: int, now: float) -> int:
+        """Pick the slot to overwrite: empty, then expired, then oldest."""
+        mm = self._mm
+        offset = bucket + _BUCKET_HEADER_SIZE
+        oldest, oldest_at = offset, None
+        for _ in range(self.ways):
+            slot = _SLOT.unpack_from(mm, offset)
+            if slot[5] == _EMPTY or (slot[2] and slot[2] <= now):
+                return offset
+            if oldest_at is None or slot[1] < oldest_at:
+                oldest, oldest_at = offset, slot[1]
+            offset += self.slot_size
+        self.evictions += 1
+        return oldest
+
+    def _clear_slot(self, bucket: int, offset: int) -> None:
+        mm = self._mm
+        _write_begin(mm, bucket)
+        _SLOT.pack_into(mm, offset, 0, 0.0, 0.0, 0, 0, _EMPTY, 0, *([0] * (2 * MAX_TAGS)))
+        _write_end(mm, bucket)
+
+    def _bucket_lock(self, bucket: int) -> '_RecordLock':
+        return self._lock(bucket)
+
+    def _lock(self, offset: int) -> '_RecordLock':
+        return _RecordLock(self._fd, offset, self._local_lock)
+
+    # Async API matching the other cache levels
+
+    async def get(self, key: str) -> Optional[Any]:
+        """Get value from cache."""
+        return self.get_sync(key)
+
+    async def set(self, key: str, value: Any, ttl_seconds: Optional[int] = None,
+                  tags: Optional[Iterable[str]] = None) -> bool:
+        """Set value in cache."""
+        return self.set_sync(key, value, ttl_seconds, tags)
+
+    async def delete(self, key: str) -> bool:
+        """Delete value from cache."""
+        return self.delete_sync(key)
+
+    async def invalidate_by_tag(self, tag: str) -> None:
+        """Invalidate all entries with a tag; entries are dropped lazily."""
+        self.invalidate_by_tag_sync(tag)
+
+    async def clear(self) -> bool:
+        """Clear all cache entries."""
+        self.clear_sync()
+        return True
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Get cache statistics for this process."""
+        lookups = self.hits + self.misses
+        return {
+            "path": self.path,
+            "backend": "native" if _shm_sync is not None else "python",
+            "size_bytes": self.size_bytes,
+            "buckets": self.buckets,
+            "ways": self.ways,
+            "max_payload": self.max_payload,
+            "hits": self.hits,
+            "misses": self.misses,
+            "hit_rate": self.hits / lookups if lookups else 0.0,
+            "sets": self.sets,
+            "evictions": self.evictions,
+            "read_retries": self.read_retries
+        }
+
+
+class _RecordLock:
+    """Exclusive lock on one byte of the backing file, per process and thread."""
+
+    __slots__ = ('fd', 'offset', 'local')
+
+    def __init__(self, fd: int, offset: int, local: threading.Lock):
+        self.fd = fd
+        self.offset = offset
+        self.local = local
+
+    def __enter__(self):
+        # POSIX record locks don't exclude threads of the same process
+        self.local.acquire()
+        try:
+            fcntl.lockf(self.fd, fcntl.LOCK_EX, 1, self.offset)
+        except BaseException:
+            self.local.release()
+            raise
+        return self
+
+    def __exit__(self, *exc_info):
+        try:
+            fcntl.lockf(self.fd, fcntl.LOCK_UN, 1, self.offset)
+        finally:
+            self.local.release()
+
+
+__all__ = ['SharedMemoryCache', 'default_path']
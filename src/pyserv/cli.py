@@ -86,6 +86,7 @@ class PyservCLI:
   pyserv runserver
   pyserv makemigrations
   pyserv test
+  pyserv importtime pyserv.server.application
             """
         )
         
@@ -220,6 +221,7 @@ class PyservCLI:
         collectstatic_parser.add_argument('--clear', action='store_true', help='Clear the existing files before collecting')
         collectstatic_parser.add_argument('--cdn', action='store_true', help='Deploy to CDN after collecting')
         collectstatic_parser.add_argument('--hash', action='store_true', help='Add hash-based versioning')
+        collectstatic_parser.add_argument('--compress', action='store_true', help='Write precompressed .br/.gz variants')
 
     def _add_testing_commands(self, subparsers):
         """Add testing commands"""
@@ -247,6 +249,13 @@ class PyservCLI:
         subparsers.add_parser('check', help='Check for common problems')
         subparsers.add_parser('version', help='Show Pyserv version')
 
+        importtime_parser = subparsers.add_parser('importtime', help='Show the import-time breakdown of a module')
+        importtime_parser.add_argument('module', nargs='?', default='pyserv', help='Module to import (default: pyserv)')
+        importtime_parser.add_argument('--top', type=int, default=15, help='Rows to show per table')
+        importtime_parser.add_argument('--depth', type=int, default=2, help='Dotted depth used to group pyserv modules')
+        importtime_parser.add_argument('--runs', type=int, default=3, help='Fresh interpreters to try; the fastest is shown')
+        importtime_parser.add_argument('--json', action='store_true', help='Print the report as JSON')
+
     def _add_queue_commands(self, subparsers):
         """Add queue and scheduler commands"""
         work_parser = subparsers.add_parser('work', help='Start background workers')
@@ -342,6 +351,7 @@ class PyservCLI:
         # System commands
         self.registry.register('check', None, self.cmd_check)
         self.registry.register('version', None, self.cmd_version)
+        self.registry.register('importtime', None, self.cmd_importtime)
         self.registry.register('help', None, self.cmd_help)
 
         # Queue commands
@@ -1482,6 +1492,7 @@ urlpatterns = []
         clear = getattr(args, 'clear', False)
         deploy_cdn = getattr(args, 'cdn', False)
         add_hashing = getattr(args, 'hash', False)
+        precompress = getattr(args, 'compress', False)
 
         # Create mock args object for the staticfiles command
         class MockArgs:
@@ -1489,6 +1500,7 @@ urlpatterns = []
                 self.clear = clear
                 self.cdn = deploy_cdn
                 self.hash = add_hashing
+                self.compress = precompress
 
         mock_args = MockArgs()
         staticfiles.cmd_collectstatic(mock_args)
@@ -1652,6 +1664,19 @@ urlpatterns = []
         except ImportError:
             print("Pyserv version unknown")
 
+    def cmd_importtime(self, args):
+        """Show what importing a module costs, grouped by subsystem"""
+        from pyserv.performance.importtime import measure_import, format_report
+
+        report = measure_import(args.module, runs=args.runs)
+        if args.json:
+            import json
+            print(json.dumps(report.to_dict(args.depth), indent=2))
+        else:
+            print(format_report(report, top=args.top, depth=args.depth))
+        if not report.ok:
+            sys.exit(1)
+
     def cmd_help(self, args):
         """Show help"""
         self.parser.print_help()
@@ -184,6 +184,13 @@ class StaticFilesConfig:
     use_cdn: bool = os.getenv('STATIC_USE_CDN', 'False').lower() == 'true'
     cdn_url: str = os.getenv('STATIC_CDN_URL', '')
 
+    # Cache lifetime for unhashed files (hashed files are cached for a year)
+    max_age: int = int(os.getenv('STATIC_MAX_AGE', '3600'))
+
+    # Write .br/.gz variants at collectstatic time, served instead of compressing per request
+    precompress: bool = os.getenv('STATIC_PRECOMPRESS', 'False').lower() == 'true'
+    precompress_encodings: List[str] = field(default_factory=lambda: os.getenv('STATIC_PRECOMPRESS_ENCODINGS', 'br,gzip').split(','))
+
 
 @dataclass
 class AppConfig:
@@ -0,0 +1,54 @@
+"""
+Pyserv native core - optional C accelerators for framework hot paths.
+
+Extensions in this package are compiled by setup.py when a C compiler is
+available. Every consumer loads them through ``load_extension`` and keeps
+a pure-Python fallback, so the framework behaves identically without them.
+
+Setting ``PYSERV_DISABLE_CEXT=1`` skips both building and loading the
+extensions, which is useful when comparing against the Python paths.
+"""
+
+import importlib
+import os
+from types import ModuleType
+from typing import Dict, Optional
+
+CEXT_DISABLED = os.environ.get('PYSERV_DISABLE_CEXT', '').lower() in ('1', 'true', 'yes')
+
+_loaded: Dict[str, Optional[ModuleType]] = {}
+
+
+def load_extension(name: str) -> Optional[ModuleType]:
+    """
+    Import a native extension from ``pyserv.core``.
+
+    Args:
+        name: Extension module name, e.g. ``"http_parser"``
+
+    Returns:
+        The extension module, or None if it is disabled or not built
+    """
+    if name in _loaded:
+        return _loaded[name]
+
+    module = None
+    if not CEXT_DISABLED:
+        try:
+            module = importlib.import_module(f"{__name__}.{name}")
+        except ImportError:
+            module = None
+
+    _loaded[name] = module
+    return module
+
+
+def available_extensions() -> Dict[str, bool]:
+    """Report which known native extensions could be loaded."""
+    return {name: load_extension(name) is not None for name in NATIVE_EXTENSIONS}
+
+
+# Extensions declared in setup.py, kept here so tooling can report on them
+NATIVE_EXTENSIONS = ('http_parser', 'route_tree', 'shm_sync', 'frame_ring')
+
+__all__ = ['CEXT_DISABLED', 'NATIVE_EXTENSIONS', 'load_extension', 'available_extensions']
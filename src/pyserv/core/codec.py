@@ -0,0 +1,201 @@
+"""
+Pyserv JSON codec - one encoder/decoder for the whole framework.
+
+``dumps`` returns UTF-8 bytes directly and ``loads`` accepts bytes, bytearray,
+memoryview or str. The fastest available backend is chosen at import:
+
+- ``orjson``: native, serializes dataclasses, datetimes, UUIDs and enums
+  itself and writes bytes without an intermediate str
+- ``msgspec``: native, same coverage
+- ``stdlib``: ``json`` with the same compact output and type handling
+
+Set ``PYSERV_JSON_BACKEND`` to force one, or call ``set_backend``. Types
+the backend can't handle go through ``default``, which knows framework
+models (anything with ``to_dict``), dataclasses, dates, Decimal, UUID,
+enums and sets; ``register_encoder`` adds more.
+
+Output is compact (no spaces) and non-ASCII is written as UTF-8 for every
+backend, so responses are byte-identical whichever one is active.
+"""
+
+import dataclasses
+import datetime
+import decimal
+import enum
+import json as _json
+import os
+import uuid
+from typing import Any, Callable, Dict, Optional, Type, Union
+
+BACKENDS = ('orjson', 'msgspec', 'stdlib')
+
+_encoders: Dict[Type, Callable[[Any], Any]] = {}
+
+
+class DecodeError(ValueError):
+    """Raised by ``loads`` for malformed JSON, whatever the backend."""
+
+
+class EncodeError(TypeError):
+    """Raised by ``dumps`` for objects that can't be serialized."""
+
+
+def register_encoder(cls: Type, encoder: Callable[[Any], Any]) -> None:
+    """
+    Teach the codec to serialize a type.
+
+    Args:
+        cls: Type (subclasses included) to handle
+        encoder: Function returning a JSON-serializable replacement
+    """
+    _encoders[cls] = encoder
+
+
+def default(obj: Any) -> Any:
+    """Convert objects the backend doesn't support natively."""
+    for cls in type(obj).__mro__:
+        encoder = _encoders.get(cls)
+        if encoder is not None:
+            return encoder(obj)
+
+    to_dict = getattr(obj, 'to_dict', None)
+    if callable(to_dict):
+        return to_dict()
+    if dataclasses.is_dataclass(obj) and not isinstance(obj, type):
+        return dataclasses.asdict(obj)
+    if isinstance(obj, (datetime.datetime, datetime.date, datetime.time)):
+        return obj.isoformat()
+    if isinstance(obj, enum.Enum):
+        return obj.value
+    if isinstance(obj, (uuid.UUID, decimal.Decimal)):
+        return str(obj)
+    if isinstance(obj, (set, frozenset)):
+        return list(obj)
+    if isinstance(obj, (bytes, bytearray, memoryview)):
+        return bytes(obj).decode('utf-8')
+    raise EncodeError(f"Object of type {type(obj).__name__} is not JSON serializable")
+
+
+_stdlib_encoder = _json.JSONEncoder(ensure_ascii=False, separators=(',', ':'), default=default)
+
+
+def _stdlib_dumps(obj: Any) -> bytes:
+    try:
+        return _stdlib_encoder.encode(obj).encode('utf-8')
+    except (TypeError, ValueError) as e:
+        raise EncodeError(str(e)) from e
+
+
+def _stdlib_loads(data: Union[bytes, bytearray, memoryview, str]) -> Any:
+    if isinstance(data, memoryview):
+        data = bytes(data)
+    try:
+        return _json.loads(data)
+    except (ValueError, UnicodeDecodeError) as e:
+        raise DecodeError(str(e)) from e
+
+
+def _make_orjson():
+    import orjson
+
+    option = orjson.OPT_NON_STR_KEYS
+
+    def dumps(obj: Any) -> bytes:
+        try:
+            return orjson.dumps(obj, default=default, option=option)
+        except TypeError:
+            # Integers beyond 64 bits and other edge cases orjson rejects
+            return _stdlib_dumps(obj)
+
+    def loads(data):
+        try:
+            return orjson.loads(data)
+        except orjson.JSONDecodeError as e:
+            raise DecodeError(str(e)) from e
+
+    return dumps, loads
+
+
+def _make_msgspec():
+    import msgspec
+
+    encoder = msgspec.json.Encoder(enc_hook=default)
+    decoder = msgspec.json.Decoder()
+
+    def dumps(obj: Any) -> bytes:
+        try:
+            return encoder.encode(obj)
+        except (TypeError, msgspec.EncodeError):
+            return _stdlib_dumps(obj)
+
+    def loads(data):
+        try:
+            return decoder.decode(data)
+        except msgspec.DecodeError as e:
+            raise DecodeError(str(e)) from e
+
+    return dumps, loads
+
+
+_factories = {
+    'orjson': _make_orjson,
+    'msgspec': _make_msgspec,
+    'stdlib': lambda: (_stdlib_dumps, _stdlib_loads),
+}
+
+BACKEND = 'stdlib'
+_dumps: Callable[[Any], bytes] = _stdlib_dumps
+_loads: Callable[[Any], Any] = _stdlib_loads
+
+
+def set_backend(name: Optional[str] = None) -> str:
+    """
+    Select the JSON backend.
+
+    Args:
+        name: One of ``BACKENDS``, or None for the fastest installed one
+
+    Returns:
+        The name of the active backend
+
+    Raises:
+        ImportError: If the named backend is not installed
+    """
+    global BACKEND, _dumps, _loads
+
+    candidates = [name] if name else list(BACKENDS)
+    for candidate in candidates:
+        if candidate not in _factories:
+            raise ValueError(f"Unknown JSON backend {candidate!r}")
+        try:
+            _dumps, _loads = _factories[candidate]()
+        except ImportError:
+            if name:
+                raise
+            continue
+        BACKEND = candidate
+        return BACKEND
+    return BACKEND
+
+
+def dumps(obj: Any) -> bytes:
+    """Serialize obj to compact UTF-8 JSON bytes."""
+    return _dumps(obj)
+
+
+def dumps_str(obj: Any) -> str:
+    """Serialize obj to a JSON str, e.g. for WebSocket text frames."""
+    return _dumps(obj).decode('utf-8')
+
+
+def loads(data: Union[bytes, bytearray, memoryview, str]) -> Any:
+    """Parse JSON from bytes-like or str data."""
+    return _loads(data)
+
+
+set_backend(os.environ.get('PYSERV_JSON_BACKEND') or None)
+
+__all__ = [
+    'BACKEND', 'BACKENDS', 'DecodeError', 'EncodeError',
+    'default', 'dumps', 'dumps_str', 'loads', 'register_encoder', 'set_backend'
+]
@@ -0,0 +1,521 @@
+/*
+ * Pyserv native frame ring.
+ *
+ * Bounded ring of object references for pyserv.streaming.ring, used to
+ * hand encoded frames between pipeline stages without copying them, and
+ * the frame splitter behind pyserv.streaming.frames.FrameDecoder:
+ *
+ *   ring = Ring(capacity)             # capacity rounds up to a power of two
+ *   ring.push(frame) -> bool          # False when full
+ *   ring.push_many(frames) -> int     # how many fitted, in order
+ *   ring.pop(default=None)
+ *   ring.pop_many(max_items=-1) -> list
+ *
+ * Slots hold references only, so a frame's buffer is never copied. No
+ * method releases the GIL, and none runs Python code (an allocation or a
+ * decref) between reading head/tail and updating them, which makes every
+ * operation atomic with respect to other threads: any number of producers
+ * and consumers may share one ring (MPMC). Head and tail are free-running counters masked into the
+ * slot array, so a full ring and an empty ring need no extra flag.
+ *
+ *   decode(buffer, offset=0, max_frame_size=16 MiB) -> (frames, offset)
+ *
+ * splits the complete frames at the start of buffer into
+ * (id, timestamp_ns, type, encoding, metadata, payload, wire) tuples, where
+ * the last three are memoryviews of buffer, and returns the offset of the
+ * first incomplete frame. The layout is documented in frames.py.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MAX_CAPACITY ((Py_ssize_t)1 << 30)
+
+#define FRAME_VERSION 1
+#define FRAME_HEADER_SIZE 32
+#define FRAME_PREFIX_SIZE 4
+#define DEFAULT_MAX_FRAME_SIZE (16 * 1024 * 1024)
+
+typedef struct {
+    PyObject_HEAD
+    PyObject **slots;
+    Py_ssize_t capacity;
+    size_t mask;
+    size_t head;        /* next slot to pop */
+    size_t tail;        /* next slot to push */
+    unsigned long long pushed;
+    unsigned long long rejected;
+} RingObject;
+
+#define RING_SIZE(r) ((Py_ssize_t)((r)->tail - (r)->head))
+
+static int
+ring_put(RingObject *self, PyObject *item)
+{
+    if (RING_SIZE(self) >= self->capacity) {
+        self->rejected++;
+        return 0;
+    }
+    Py_INCREF(item);
+    self->slots[self->tail & self->mask] = item;
+    self->tail++;
+    self->pushed++;
+    return 1;
+}
+
+/* Returns a new reference, or NULL without an exception when empty */
+static PyObject *
+ring_take(RingObject *self)
+{
+    PyObject **slot;
+    PyObject *item;
+
+    if (self->head == self->tail) {
+        return NULL;
+    }
+    slot = &self->slots[self->head & self->mask];
+    item = *slot;
+    *slot = NULL;
+    self->head++;
+    return item;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Ring type                                                                 */
+/* ------------------------------------------------------------------------ */
+
+static PyObject *
+Ring_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"capacity", NULL};
+    RingObject *self;
+    Py_ssize_t requested = 1024, capacity = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n:Ring", kwlist, &requested)) {
+        return NULL;
+    }
+    if (requested < 1 || requested > MAX_CAPACITY) {
+        PyErr_SetString(PyExc_ValueError, "capacity must be between 1 and 2**30");
+        return NULL;
+    }
+    while (capacity < requested) {
+        capacity <<= 1;
+    }
+    self = (RingObject *)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->slots = PyMem_Calloc((size_t)capacity, sizeof(PyObject *));
+    if (self->slots == NULL) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+    self->capacity = capacity;
+    self->mask = (size_t)capacity - 1;
+    self->head = self->tail = 0;
+    self->pushed = self->rejected = 0;
+    return (PyObject *)self;
+}
+
+static int
+Ring_traverse(RingObject *self, visitproc visit, void *arg)
+{
+    size_t position;
+
+    if (self->slots == NULL) {
+        return 0;
+    }
+    for (position = self->head; position != self->tail; position++) {
+        Py_VISIT(self->slots[position & self->mask]);
+    }
+    return 0;
+}
+
+static int
+Ring_clear(RingObject *self)
+{
+    PyObject *item;
+
+    if (self->slots == NULL) {
+        return 0;
+    }
+    while ((item = ring_take(self)) != NULL) {
+        Py_DECREF(item);
+    }
+    return 0;
+}
+
+static void
+Ring_dealloc(RingObject *self)
+{
+    PyObject_GC_UnTrack(self);
+    Ring_clear(self);
+    PyMem_Free(self->slots);
+    self->slots = NULL;
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static Py_ssize_t
+Ring_len(RingObject *self)
+{
+    return RING_SIZE(self);
+}
+
+PyDoc_STRVAR(Ring_push_doc,
+"push(item) -> bool\n\n"
+"Append item; False (and nothing stored) if the ring is full.");
+
+static PyObject *
+Ring_push(RingObject *self, PyObject *item)
+{
+    return PyBool_FromLong(ring_put(self, item));
+}
+
+PyDoc_STRVAR(Ring_push_many_doc,
+"push_many(items) -> int\n\n"
+"Append items in order until the ring is full; returns how many were stored.");
+
+static PyObject *
+Ring_push_many(RingObject *self, PyObject *items)
+{
+    PyObject *seq, *item;
+    Py_ssize_t count, index;
+
+    seq = PySequence_Fast(items, "push_many() argument must be iterable");
+    if (seq == NULL) {
+        return NULL;
+    }
+    count = PySequence_Fast_GET_SIZE(seq);
+    for (index = 0; index < count; index++) {
+        item = PySequence_Fast_GET_ITEM(seq, index);
+        if (!ring_put(self, item)) {
+            break;
+        }
+    }
+    Py_DECREF(seq);
+    return PyLong_FromSsize_t(index);
+}
+
+PyDoc_STRVAR(Ring_pop_doc,
+"pop(default=None)\n\n"
+"Remove and return the oldest item, or default if the ring is empty.");
+
+static PyObject *
+Ring_pop(RingObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    PyObject *item;
+
+    if (nargs > 1) {
+        PyErr_SetString(PyExc_TypeError, "pop() takes at most 1 argument");
+        return NULL;
+    }
+    item = ring_take(self);
+    if (item != NULL) {
+        return item;
+    }
+    item = nargs ? args[0] : Py_None;
+    Py_INCREF(item);
+    return item;
+}
+
+PyDoc_STRVAR(Ring_pop_many_doc,
+"pop_many(max_items=-1) -> list\n\n"
+"Remove and return up to max_items of the oldest items (all if negative).");
+
+static PyObject *
+Ring_pop_many(RingObject *self, PyObject *const *args, Py_ssize_t nargs)
+{
+    Py_ssize_t limit = -1, count, index;
+    PyObject *result, *item;
+
+    if (nargs > 1) {
+        PyErr_SetString(PyExc_TypeError, "pop_many() takes at most 1 argument");
+        return NULL;
+    }
+    if (nargs == 1) {
+        limit = PyLong_AsSsize_t(args[0]);
+        if (limit == -1 && PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+    count = RING_SIZE(self);
+    if (limit >= 0 && limit < count) {
+        count = limit;
+    }
+    result = PyList_New(count);
+    if (result == NULL) {
+        return NULL;
+    }
+    /* The allocation can run the GC, whose finalizers may let another
+       consumer pop, so count is an upper bound: take until empty. */
+    for (index = 0; index < count; index++) {
+        item = ring_take(self);
+        if (item == NULL) {
+            break;
+        }
+        PyList_SET_ITEM(result, index, item);
+    }
+    if (index < count && PyList_SetSlice(result, index, count, NULL) < 0) {
+        Py_DECREF(result);
+        return NULL;
+    }
+    return result;
+}
+
+PyDoc_STRVAR(Ring_clear_doc,
+"clear() -> None\n\n"
+"Drop every queued item.");
+
+static PyObject *
+Ring_clear_method(RingObject *self, PyObject *Py_UNUSED(ignored))
+{
+    Ring_clear(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+Ring_get_capacity(RingObject *self, void *closure)
+{
+    return PyLong_FromSsize_t(self->capacity);
+}
+
+static PyObject *
+Ring_get_free(RingObject *self, void *closure)
+{
+    return PyLong_FromSsize_t(self->capacity - RING_SIZE(self));
+}
+
+static PyObject *
+Ring_get_pushed(RingObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLongLong(self->pushed);
+}
+
+static PyObject *
+Ring_get_rejected(RingObject *self, void *closure)
+{
+    return PyLong_FromUnsignedLongLong(self->rejected);
+}
+
+static PyMethodDef Ring_methods[] = {
+    {"push", (PyCFunction)Ring_push, METH_O, Ring_push_doc},
+    {"push_many", (PyCFunction)Ring_push_many, METH_O, Ring_push_many_doc},
+    {"pop", (PyCFunction)(void (*)(void))Ring_pop, METH_FASTCALL, Ring_pop_doc},
+    {"pop_many", (PyCFunction)(void (*)(void))Ring_pop_many, METH_FASTCALL, Ring_pop_many_doc},
+    {"clear", (PyCFunction)Ring_clear_method, METH_NOARGS, Ring_clear_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef Ring_getset[] = {
+    {"capacity", (getter)Ring_get_capacity, NULL, "Number of slots", NULL},
+    {"free", (getter)Ring_get_free, NULL, "Slots currently unused", NULL},
+    {"pushed", (getter)Ring_get_pushed, NULL, "Items accepted since creation", NULL},
+    {"rejected", (getter)Ring_get_rejected, NULL, "Pushes refused because the ring was full", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PySequenceMethods Ring_as_sequence = {
+    .sq_length = (lenfunc)Ring_len,
+};
+
+static PyTypeObject RingType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "pyserv.core.frame_ring.Ring",
+    .tp_doc = PyDoc_STR("Bounded multi-producer, multi-consumer ring of object references."),
+    .tp_basicsize = sizeof(RingObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_new = Ring_new,
+    .tp_dealloc = (destructor)Ring_dealloc,
+    .tp_traverse = (traverseproc)Ring_traverse,
+    .tp_clear = (inquiry)Ring_clear,
+    .tp_methods = Ring_methods,
+    .tp_getset = Ring_getset,
+    .tp_as_sequence = &Ring_as_sequence,
+};
+
+/* ------------------------------------------------------------------------ */
+/* Frame splitting                                                           */
+/* ------------------------------------------------------------------------ */
+
+static uint64_t
+read_le(const unsigned char *p, int size)
+{
+    uint64_t value = 0;
+    int i;
+
+    for (i = size - 1; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static PyObject *
+view_slice(PyObject *view, Py_ssize_t start, Py_ssize_t stop)
+{
+    PyObject *first, *last, *slice = NULL, *result = NULL;
+
+    first = PyLong_FromSsize_t(start);
+    last = PyLong_FromSsize_t(stop);
+    if (first != NULL && last != NULL) {
+        slice = PySlice_New(first, last, NULL);
+    }
+    Py_XDECREF(first);
+    Py_XDECREF(last);
+    if (slice != NULL) {
+        result = PyObject_GetItem(view, slice);
+        Py_DECREF(slice);
+    }
+    return result;
+}
+
+PyDoc_STRVAR(decode_doc,
+"decode(buffer, offset=0, max_frame_size=16777216) -> (frames, offset)\n\n"
+"Split the complete frames starting at offset into\n"
+"(id, timestamp_ns, type, encoding, metadata, payload, wire) tuples whose\n"
+"buffers are memoryviews of buffer. Returns them with the offset of the\n"
+"first incomplete frame; raises ValueError for a malformed frame.");
+
+static PyObject *
+decode(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"buffer", "offset", "max_frame_size", NULL};
+    PyObject *buffer, *view = NULL, *frames, *type = NULL, *item;
+    PyObject *metadata, *payload, *wire;
+    Py_ssize_t offset = 0, max_frame_size = DEFAULT_MAX_FRAME_SIZE;
+    Py_ssize_t end, body, meta_start, payload_start, type_len, meta_len, last_type_len = -1;
+    const unsigned char *data, *last_type = NULL;
+    uint64_t length;
+    Py_buffer raw;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|nn:decode", kwlist, &buffer, &offset, &max_frame_size)) {
+        return NULL;
+    }
+    if (PyObject_GetBuffer(buffer, &raw, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    if (offset < 0 || offset > raw.len) {
+        PyBuffer_Release(&raw);
+        PyErr_SetString(PyExc_ValueError, "offset outside the buffer");
+        return NULL;
+    }
+    frames = PyList_New(0);
+    if (frames == NULL) {
+        PyBuffer_Release(&raw);
+        return NULL;
+    }
+    data = (const unsigned char *)raw.buf;
+
+    while (raw.len - offset >= FRAME_PREFIX_SIZE) {
+        length = read_le(data + offset, 4);
+        if (length + FRAME_PREFIX_SIZE > (uint64_t)max_frame_size
+                || length < FRAME_HEADER_SIZE - FRAME_PREFIX_SIZE) {
+            PyErr_Format(PyExc_ValueError, "invalid frame length %llu", (unsigned long long)length);
+            goto error;
+        }
+        end = offset + FRAME_PREFIX_SIZE + (Py_ssize_t)length;
+        if (end > raw.len) {
+            break;
+        }
+        if (data[offset + 4] != FRAME_VERSION) {
+            PyErr_Format(PyExc_ValueError, "unsupported frame version %d", data[offset + 4]);
+            goto error;
+        }
+        type_len = (Py_ssize_t)read_le(data + offset + 6, 2);
+        meta_len = (Py_ssize_t)read_le(data + offset + 24, 4);
+        body = offset + FRAME_HEADER_SIZE;
+        meta_start = body + type_len;
+        payload_start = meta_start + meta_len;
+        if (payload_start > end) {
+            PyErr_SetString(PyExc_ValueError, "truncated frame body");
+            goto error;
+        }
+        if (view == NULL && (view = PyMemoryView_FromObject(buffer)) == NULL) {
+            goto error;
+        }
+        /* A stream usually repeats one message type: reuse the decoded name */
+        if (type == NULL || type_len != last_type_len || memcmp(data + body, last_type, type_len) != 0) {
+            Py_XDECREF(type);
+            type = PyUnicode_DecodeUTF8((const char *)data + body, type_len, NULL);
+            if (type == NULL) {
+                goto error;
+            }
+            last_type = data + body;
+            last_type_len = type_len;
+        }
+        metadata = view_slice(view, meta_start, payload_start);
+        payload = metadata ? view_slice(view, payload_start, end) : NULL;
+        wire = payload ? view_slice(view, offset, end) : NULL;
+        if (wire == NULL) {
+            Py_XDECREF(metadata);
+            Py_XDECREF(payload);
+            goto error;
+        }
+        item = Py_BuildValue("(KKOiNNN)",
+                             (unsigned long long)read_le(data + offset + 8, 8),
+                             (unsigned long long)read_le(data + offset + 16, 8),
+                             type, (int)data[offset + 5], metadata, payload, wire);
+        if (item == NULL || PyList_Append(frames, item) < 0) {
+            Py_XDECREF(item);
+            goto error;
+        }
+        Py_DECREF(item);
+        offset = end;
+    }
+
+    Py_XDECREF(type);
+    Py_XDECREF(view);
+    PyBuffer_Release(&raw);
+    return Py_BuildValue("(Nn)", frames, offset);
+
+error:
+    Py_XDECREF(type);
+    Py_XDECREF(view);
+    Py_DECREF(frames);
+    PyBuffer_Release(&raw);
+    return NULL;
+}
+
+static PyMethodDef frame_ring_methods[] = {
+    {"decode", (PyCFunction)(void (*)(void))decode, METH_VARARGS | METH_KEYWORDS, decode_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+/* ------------------------------------------------------------------------ */
+/* Module definition                                                         */
+/* ------------------------------------------------------------------------ */
+
+static struct PyModuleDef frame_ring_module = {
+    PyModuleDef_HEAD_INIT,
+    "pyserv.core.frame_ring",
+    "Native bounded frame ring and frame splitter for Pyserv streaming pipelines.",
+    -1,
+    frame_ring_methods,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+PyMODINIT_FUNC
+PyInit_frame_ring(void)
+{
+    PyObject *module;
+
+    if (PyType_Ready(&RingType) < 0) {
+        return NULL;
+    }
+    module = PyModule_Create(&frame_ring_module);
+    if (module == NULL) {
+        return NULL;
+    }
+    Py_INCREF(&RingType);
+    if (PyModule_AddObject(module, "Ring", (PyObject *)&RingType) < 0) {
+        Py_DECREF(&RingType);
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
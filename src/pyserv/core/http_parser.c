@@ -0,0 +1,1013 @@
+/*
+ * Pyserv native HTTP parser.
+ *
+ * Provides the hot-path parsing primitives used by pyserv.http.request:
+ *
+ *   parse_headers(headers)       ASGI header list -> {name: value | [values]}
+ *   parse_query(qs)              query string -> {name: [values]} (parse_qs)
+ *   parse_request(data)          raw HTTP/1.x request head -> tuple of slices
+ *   parse_chunked(data, offset)  chunked transfer-encoding body decoder
+ *   parse_content_length(value)  strict Content-Length parser
+ *
+ * Delimiter scanning uses SSE2 on x86 and NEON on AArch64, falling back to a
+ * scalar loop elsewhere. Raw parsing returns memoryview slices into the
+ * caller's buffer so header names and values are never copied.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PYSERV_HAVE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PYSERV_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static __inline int pyserv_ctz(unsigned int x)
+{
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return (int)index;
+}
+#else
+#define pyserv_ctz(x) __builtin_ctz(x)
+#endif
+
+#define MAX_HEADERS 100
+#define NAME_CACHE_LIMIT 256
+
+static PyObject *HttpParserError;
+
+/* Lowercased header names keyed by the raw header bytes. */
+static PyObject *name_cache;
+
+/* RFC 9110 token characters, used for methods and header names. */
+static const unsigned char token_table[256] = {
+    /* 0x00 - 0x1f: control characters */
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /*    !  "  #  $  %  &  '  (  )  *  +  ,  -  .  / */
+    0, 1, 0, 1, 1, 1, 1, 1, 0, 0, 1, 1, 0, 1, 1, 0,
+    /* 0-9                           :  ;  <  =  >  ? */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,
+    /* @  A-O */
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    /* P-Z                           [  \  ]  ^  _ */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 1,
+    /* `  a-o */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    /* p-z                           {  |  }  ~  DEL */
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 0, 1, 0,
+    /* 0x80 - 0xff: not allowed in tokens */
+};
+
+/* ------------------------------------------------------------------------ */
+/* Delimiter scanning                                                        */
+/* ------------------------------------------------------------------------ */
+
+/* Return the first position in [p, end) holding either a or b, or NULL. */
+static inline const char *
+find_byte2(const char *p, const char *end, char a, char b)
+{
+#if defined(PYSERV_HAVE_SSE2)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, va),
+                                    _mm_cmpeq_epi8(chunk, vb));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask) {
+            return p + pyserv_ctz((unsigned int)mask);
+        }
+        p += 16;
+    }
+#elif defined(PYSERV_HAVE_NEON)
+    const uint8x16_t va = vdupq_n_u8((uint8_t)a);
+    const uint8x16_t vb = vdupq_n_u8((uint8_t)b);
+    while (end - p >= 16) {
+        uint8x16_t chunk = vld1q_u8((const uint8_t *)p);
+        uint8x16_t hits = vorrq_u8(vceqq_u8(chunk, va), vceqq_u8(chunk, vb));
+        if (vmaxvq_u8(hits)) {
+            break;
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == a || *p == b) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/* Single-byte search; libc memchr is already vectorised. */
+static inline const char *
+find_byte(const char *p, const char *end, char c)
+{
+    return p < end ? memchr(p, c, end - p) : NULL;
+}
+
+static inline int
+is_ows(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+static inline int
+ascii_lower(int c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + 32 : c;
+}
+
+static int
+equals_ignore_case(const char *s, Py_ssize_t n, const char *lit)
+{
+    Py_ssize_t i;
+    for (i = 0; i < n; i++) {
+        if (lit[i] == '\0' || ascii_lower((unsigned char)s[i]) != lit[i]) {
+            return 0;
+        }
+    }
+    return lit[n] == '\0';
+}
+
+/* ------------------------------------------------------------------------ */
+/* Header and query decoding for ASGI scopes                                 */
+/* ------------------------------------------------------------------------ */
+
+/* Decode a header name to a lowercased str, caching common names. */
+static PyObject *
+decode_header_name(PyObject *raw, const char *s, Py_ssize_t n)
+{
+    PyObject *name;
+    Py_ssize_t i;
+    int ascii = 1;
+
+    if (PyBytes_CheckExact(raw)) {
+        name = PyDict_GetItemWithError(name_cache, raw);
+        if (name != NULL) {
+            Py_INCREF(name);
+            return name;
+        }
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        if ((unsigned char)s[i] >= 0x80) {
+            ascii = 0;
+            break;
+        }
+    }
+
+    if (ascii) {
+        Py_UCS1 *out;
+        name = PyUnicode_New(n, 127);
+        if (name == NULL) {
+            return NULL;
+        }
+        out = PyUnicode_1BYTE_DATA(name);
+        for (i = 0; i < n; i++) {
+            out[i] = (Py_UCS1)ascii_lower((unsigned char)s[i]);
+        }
+    }
+    else {
+        PyObject *decoded = PyUnicode_DecodeUTF8(s, n, NULL);
+        if (decoded == NULL) {
+            return NULL;
+        }
+        name = PyObject_CallMethod(decoded, "lower", NULL);
+        Py_DECREF(decoded);
+        if (name == NULL) {
+            return NULL;
+        }
+    }
+
+    if (PyBytes_CheckExact(raw) && PyDict_GET_SIZE(name_cache) < NAME_CACHE_LIMIT) {
+        if (PyDict_SetItem(name_cache, raw, name) < 0) {
+            Py_DECREF(name);
+            return NULL;
+        }
+    }
+    return name;
+}
+
+/* Insert value under name, turning repeated headers into a list. */
+static int
+store_header(PyObject *parsed, PyObject *name, PyObject *value)
+{
+    PyObject *existing = PyDict_GetItemWithError(parsed, name);
+
+    if (existing == NULL) {
+        if (PyErr_Occurred()) {
+            return -1;
+        }
+        return PyDict_SetItem(parsed, name, value);
+    }
+    if (PyList_CheckExact(existing)) {
+        return PyList_Append(existing, value);
+    }
+
+    PyObject *values = PyList_New(2);
+    if (values == NULL) {
+        return -1;
+    }
+    Py_INCREF(existing);
+    Py_INCREF(value);
+    PyList_SET_ITEM(values, 0, existing);
+    PyList_SET_ITEM(values, 1, value);
+    int rc = PyDict_SetItem(parsed, name, values);
+    Py_DECREF(values);
+    return rc;
+}
+
+PyDoc_STRVAR(parse_headers_doc,
+"parse_headers(headers) -> dict\n\n"
+"Decode an ASGI header list into a dict of lowercased names. Repeated\n"
+"headers are collected into a list, matching Request._parse_headers.");
+
+static PyObject *
+parse_headers(PyObject *self, PyObject *headers)
+{
+    PyObject *seq, *parsed;
+    Py_ssize_t i, count;
+
+    seq = PySequence_Fast(headers, "headers must be a sequence of pairs");
+    if (seq == NULL) {
+        return NULL;
+    }
+    parsed = PyDict_New();
+    if (parsed == NULL) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    count = PySequence_Fast_GET_SIZE(seq);
+    for (i = 0; i < count; i++) {
+        PyObject *pair = PySequence_Fast_GET_ITEM(seq, i);
+        PyObject *raw_name, *raw_value, *name, *value;
+        Py_buffer name_buf, value_buf;
+        int rc;
+
+        if (PyTuple_CheckExact(pair) && PyTuple_GET_SIZE(pair) == 2) {
+            raw_name = PyTuple_GET_ITEM(pair, 0);
+            raw_value = PyTuple_GET_ITEM(pair, 1);
+            Py_INCREF(raw_name);
+            Py_INCREF(raw_value);
+        }
+        else if (PyList_CheckExact(pair) && PyList_GET_SIZE(pair) == 2) {
+            raw_name = PyList_GET_ITEM(pair, 0);
+            raw_value = PyList_GET_ITEM(pair, 1);
+            Py_INCREF(raw_name);
+            Py_INCREF(raw_value);
+        }
+        else {
+            PyErr_SetString(PyExc_ValueError, "each header must be a (name, value) pair");
+            goto error;
+        }
+
+        if (PyObject_GetBuffer(raw_name, &name_buf, PyBUF_SIMPLE) < 0) {
+            Py_DECREF(raw_name);
+            Py_DECREF(raw_value);
+            goto error;
+        }
+        name = decode_header_name(raw_name, name_buf.buf, name_buf.len);
+        PyBuffer_Release(&name_buf);
+        Py_DECREF(raw_name);
+        if (name == NULL) {
+            Py_DECREF(raw_value);
+            goto error;
+        }
+
+        if (PyObject_GetBuffer(raw_value, &value_buf, PyBUF_SIMPLE) < 0) {
+            Py_DECREF(name);
+            Py_DECREF(raw_value);
+            goto error;
+        }
+        value = PyUnicode_DecodeUTF8(value_buf.buf, value_buf.len, NULL);
+        PyBuffer_Release(&value_buf);
+        Py_DECREF(raw_value);
+        if (value == NULL) {
+            Py_DECREF(name);
+            goto error;
+        }
+
+        rc = store_header(parsed, name, value);
+        Py_DECREF(name);
+        Py_DECREF(value);
+        if (rc < 0) {
+            goto error;
+        }
+    }
+
+    Py_DECREF(seq);
+    return parsed;
+
+error:
+    Py_DECREF(seq);
+    Py_DECREF(parsed);
+    return NULL;
+}
+
+static inline int
+hex_value(unsigned char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c = (unsigned char)ascii_lower(c);
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/* Percent-decode s into out ('+' becomes space) and return a str. */
+static PyObject *
+unquote_plus(const char *s, Py_ssize_t n, char *out)
+{
+    Py_ssize_t i = 0, j = 0;
+
+    while (i < n) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '+') {
+            out[j++] = ' ';
+            i++;
+        }
+        else if (c == '%' && i + 2 < n
+                 && hex_value((unsigned char)s[i + 1]) >= 0
+                 && hex_value((unsigned char)s[i + 2]) >= 0) {
+            out[j++] = (char)((hex_value((unsigned char)s[i + 1]) << 4)
+                              | hex_value((unsigned char)s[i + 2]));
+            i += 3;
+        }
+        else {
+            out[j++] = (char)c;
+            i++;
+        }
+    }
+    return PyUnicode_DecodeUTF8(out, j, "replace");
+}
+
+static int
+append_query_value(PyObject *parsed, PyObject *name, PyObject *value)
+{
+    PyObject *values = PyDict_GetItemWithError(parsed, name);
+
+    if (values == NULL) {
+        if (PyErr_Occurred()) {
+            return -1;
+        }
+        values = PyList_New(1);
+        if (values == NULL) {
+            return -1;
+        }
+        Py_INCREF(value);
+        PyList_SET_ITEM(values, 0, value);
+        int rc = PyDict_SetItem(parsed, name, values);
+        Py_DECREF(values);
+        return rc;
+    }
+    return PyList_Append(values, value);
+}
+
+PyDoc_STRVAR(parse_query_doc,
+"parse_query(qs) -> dict\n\n"
+"Parse an application/x-www-form-urlencoded string (str or bytes) into a\n"
+"dict of lists. Equivalent to urllib.parse.parse_qs(qs,\n"
+"keep_blank_values=True).");
+
+static PyObject *
+parse_query(PyObject *self, PyObject *arg)
+{
+    const char *s;
+    Py_ssize_t n;
+    Py_buffer view;
+    int have_view = 0;
+    PyObject *parsed = NULL;
+    char *scratch = NULL;
+
+    if (PyUnicode_Check(arg)) {
+        s = PyUnicode_AsUTF8AndSize(arg, &n);
+        if (s == NULL) {
+            return NULL;
+        }
+    }
+    else {
+        if (PyObject_GetBuffer(arg, &view, PyBUF_SIMPLE) < 0) {
+            return NULL;
+        }
+        have_view = 1;
+        s = view.buf;
+        n = view.len;
+    }
+
+    parsed = PyDict_New();
+    if (parsed == NULL || n == 0) {
+        goto done;
+    }
+
+    scratch = PyMem_Malloc(n);
+    if (scratch == NULL) {
+        PyErr_NoMemory();
+        Py_CLEAR(parsed);
+        goto done;
+    }
+
+    {
+        const char *p = s, *end = s + n;
+        while (p <= end) {
+            const char *amp = memchr(p, '&', end - p);
+            const char *field_end = amp ? amp : end;
+            Py_ssize_t field_len = field_end - p;
+
+            if (field_len > 0) {
+                const char *eq = memchr(p, '=', field_len);
+                const char *name_end = eq ? eq : field_end;
+                const char *value_start = eq ? eq + 1 : field_end;
+                PyObject *name, *value;
+                int rc;
+
+                name = unquote_plus(p, name_end - p, scratch);
+                if (name == NULL) {
+                    Py_CLEAR(parsed);
+                    goto done;
+                }
+                value = unquote_plus(value_start, field_end - value_start, scratch);
+                if (value == NULL) {
+                    Py_DECREF(name);
+                    Py_CLEAR(parsed);
+                    goto done;
+                }
+                rc = append_query_value(parsed, name, value);
+                Py_DECREF(name);
+                Py_DECREF(value);
+                if (rc < 0) {
+                    Py_CLEAR(parsed);
+                    goto done;
+                }
+            }
+
+            if (amp == NULL) {
+                break;
+            }
+            p = amp + 1;
+        }
+    }
+
+done:
+    PyMem_Free(scratch);
+    if (have_view) {
+        PyBuffer_Release(&view);
+    }
+    return parsed;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Raw HTTP/1.x parsing                                                      */
+/* ------------------------------------------------------------------------ */
+
+static int
+parse_length(const char *s, Py_ssize_t n, long long *out)
+{
+    long long value = 0;
+    Py_ssize_t i;
+
+    if (n == 0 || n > 18) {
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9') {
+            return -1;
+        }
+        value = value * 10 + (s[i] - '0');
+    }
+    *out = value;
+    return 0;
+}
+
+/* True when the last transfer coding in the header value is "chunked". */
+static int
+is_chunked_coding(const char *s, Py_ssize_t n)
+{
+    const char *comma = NULL;
+    Py_ssize_t i;
+
+    for (i = n - 1; i >= 0; i--) {
+        if (s[i] == ',') {
+            comma = s + i;
+            break;
+        }
+    }
+    if (comma != NULL) {
+        n -= (comma + 1) - s;
+        s = comma + 1;
+    }
+    while (n > 0 && is_ows(*s)) {
+        s++;
+        n--;
+    }
+    while (n > 0 && is_ows(s[n - 1])) {
+        n--;
+    }
+    return equals_ignore_case(s, n, "chunked");
+}
+
+static PyObject *
+slice_view(PyObject *view, const char *base, const char *start, const char *end)
+{
+    return PySequence_GetSlice(view, start - base, end - base);
+}
+
+PyDoc_STRVAR(parse_request_doc,
+"parse_request(data) -> tuple | None\n\n"
+"Parse an HTTP/1.x request head from a bytes-like object.\n\n"
+"Returns None when the head is incomplete, otherwise\n"
+"(method, target, minor_version, headers, head_length, content_length,\n"
+"chunked). target and every header name/value are memoryview slices of\n"
+"data; content_length is None when absent. Raises HttpParserError on a\n"
+"malformed head.");
+
+static PyObject *
+parse_request(PyObject *self, PyObject *arg)
+{
+    Py_buffer buf;
+    PyObject *view = NULL, *method = NULL, *target = NULL, *headers = NULL;
+    PyObject *result = NULL, *length_obj = NULL;
+    const char *base, *p, *end, *line_end, *sp;
+    long long content_length = -1;
+    int chunked = 0, minor;
+    Py_ssize_t header_count = 0;
+
+    if (PyObject_GetBuffer(arg, &buf, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    base = buf.buf;
+    p = base;
+    end = base + buf.len;
+
+    /* Tolerate leading empty lines (RFC 9112 section 2.2). */
+    while (p < end && (*p == '\r' || *p == '\n')) {
+        p++;
+    }
+
+    line_end = find_byte(p, end, '\n');
+    if (line_end == NULL) {
+        goto incomplete;
+    }
+
+    /* Method */
+    sp = p;
+    while (sp < line_end && token_table[(unsigned char)*sp]) {
+        sp++;
+    }
+    if (sp == p || sp >= line_end || *sp != ' ') {
+        PyErr_SetString(HttpParserError, "invalid request method");
+        goto error;
+    }
+    method = PyUnicode_DecodeASCII(p, sp - p, NULL);
+    if (method == NULL) {
+        goto error;
+    }
+
+    /* Target */
+    p = sp + 1;
+    sp = find_byte2(p, line_end, ' ', '\r');
+    if (sp == NULL || sp == p || *sp != ' ') {
+        PyErr_SetString(HttpParserError, "invalid request target");
+        goto error;
+    }
+
+    view = PyMemoryView_FromObject(arg);
+    if (view == NULL) {
+        goto error;
+    }
+    target = slice_view(view, base, p, sp);
+    if (target == NULL) {
+        goto error;
+    }
+
+    /* Version */
+    p = sp + 1;
+    {
+        const char *version_end = line_end;
+        if (version_end > p && version_end[-1] == '\r') {
+            version_end--;
+        }
+        if (version_end - p != 8 || memcmp(p, "HTTP/1.", 7) != 0
+            || p[7] < '0' || p[7] > '9') {
+            PyErr_SetString(HttpParserError, "invalid HTTP version");
+            goto error;
+        }
+        minor = p[7] - '0';
+    }
+
+    headers = PyList_New(0);
+    if (headers == NULL) {
+        goto error;
+    }
+
+    /* Header fields */
+    p = line_end + 1;
+    for (;;) {
+        const char *colon, *value_start, *value_end;
+        PyObject *name_obj, *value_obj, *pair;
+
+        if (p >= end) {
+            goto incomplete;
+        }
+        if (*p == '\n') {
+            p++;
+            break;
+        }
+        if (*p == '\r') {
+            if (p + 1 >= end) {
+                goto incomplete;
+            }
+            if (p[1] != '\n') {
+                PyErr_SetString(HttpParserError, "invalid header line ending");
+                goto error;
+            }
+            p += 2;
+            break;
+        }
+        if (is_ows(*p)) {
+            PyErr_SetString(HttpParserError, "obsolete header line folding");
+            goto error;
+        }
+
+        line_end = find_byte(p, end, '\n');
+        if (line_end == NULL) {
+            goto incomplete;
+        }
+        if (++header_count > MAX_HEADERS) {
+            PyErr_SetString(HttpParserError, "too many headers");
+            goto error;
+        }
+
+        colon = find_byte(p, line_end, ':');
+        if (colon == NULL || colon == p) {
+            PyErr_SetString(HttpParserError, "invalid header name");
+            goto error;
+        }
+        for (sp = p; sp < colon; sp++) {
+            if (!token_table[(unsigned char)*sp]) {
+                PyErr_SetString(HttpParserError, "invalid header name");
+                goto error;
+            }
+        }
+
+        value_start = colon + 1;
+        value_end = line_end;
+        if (value_end > value_start && value_end[-1] == '\r') {
+            value_end--;
+        }
+        while (value_start < value_end && is_ows(*value_start)) {
+            value_start++;
+        }
+        while (value_end > value_start && is_ows(value_end[-1])) {
+            value_end--;
+        }
+        for (sp = value_start; sp < value_end; sp++) {
+            unsigned char c = (unsigned char)*sp;
+            if ((c < 0x20 && c != '\t') || c == 0x7f) {
+                PyErr_SetString(HttpParserError, "invalid character in header value");
+                goto error;
+            }
+        }
+
+        if (equals_ignore_case(p, colon - p, "content-length")) {
+            long long parsed_length;
+            if (parse_length(value_start, value_end - value_start, &parsed_length) < 0
+                || (content_length >= 0 && content_length != parsed_length)) {
+                PyErr_SetString(HttpParserError, "invalid Content-Length");
+                goto error;
+            }
+            content_length = parsed_length;
+        }
+        else if (equals_ignore_case(p, colon - p, "transfer-encoding")) {
+            chunked = is_chunked_coding(value_start, value_end - value_start);
+        }
+
+        name_obj = slice_view(view, base, p, colon);
+        if (name_obj == NULL) {
+            goto error;
+        }
+        value_obj = slice_view(view, base, value_start, value_end);
+        if (value_obj == NULL) {
+            Py_DECREF(name_obj);
+            goto error;
+        }
+        pair = PyTuple_Pack(2, name_obj, value_obj);
+        Py_DECREF(name_obj);
+        Py_DECREF(value_obj);
+        if (pair == NULL || PyList_Append(headers, pair) < 0) {
+            Py_XDECREF(pair);
+            goto error;
+        }
+        Py_DECREF(pair);
+
+        p = line_end + 1;
+    }
+
+    if (chunked && content_length >= 0) {
+        PyErr_SetString(HttpParserError, "both Content-Length and chunked Transfer-Encoding");
+        goto error;
+    }
+
+    if (content_length >= 0) {
+        length_obj = PyLong_FromLongLong(content_length);
+        if (length_obj == NULL) {
+            goto error;
+        }
+    }
+    else {
+        length_obj = Py_None;
+        Py_INCREF(length_obj);
+    }
+
+    result = Py_BuildValue("(NNiNnNO)", method, target, minor, headers,
+                           (Py_ssize_t)(p - base), length_obj,
+                           chunked ? Py_True : Py_False);
+    method = target = headers = length_obj = NULL;
+    Py_XDECREF(view);
+    PyBuffer_Release(&buf);
+    return result;
+
+incomplete:
+    Py_XDECREF(method);
+    Py_XDECREF(target);
+    Py_XDECREF(headers);
+    Py_XDECREF(view);
+    PyBuffer_Release(&buf);
+    Py_RETURN_NONE;
+
+error:
+    Py_XDECREF(method);
+    Py_XDECREF(target);
+    Py_XDECREF(headers);
+    Py_XDECREF(length_obj);
+    Py_XDECREF(view);
+    PyBuffer_Release(&buf);
+    return NULL;
+}
+
+PyDoc_STRVAR(parse_chunked_doc,
+"parse_chunked(data, offset=0) -> (chunks, consumed, done)\n\n"
+"Decode as many complete chunks of a chunked transfer-encoded body as\n"
+"data holds, starting at offset. chunks is a list of memoryview slices of\n"
+"data, consumed is the offset just past the last complete chunk and done\n"
+"is True once the terminating chunk and trailer section were read.");
+
+static PyObject *
+parse_chunked(PyObject *self, PyObject *args)
+{
+    PyObject *arg, *view = NULL, *chunks = NULL;
+    Py_ssize_t offset = 0;
+    Py_buffer buf;
+    const char *base, *p, *end;
+    int done = 0;
+
+    if (!PyArg_ParseTuple(args, "O|n:parse_chunked", &arg, &offset)) {
+        return NULL;
+    }
+    if (PyObject_GetBuffer(arg, &buf, PyBUF_SIMPLE) < 0) {
+        return NULL;
+    }
+    if (offset < 0 || offset > buf.len) {
+        PyBuffer_Release(&buf);
+        PyErr_SetString(PyExc_ValueError, "offset out of range");
+        return NULL;
+    }
+
+    base = buf.buf;
+    p = base + offset;
+    end = base + buf.len;
+
+    chunks = PyList_New(0);
+    if (chunks == NULL) {
+        goto error;
+    }
+    view = PyMemoryView_FromObject(arg);
+    if (view == NULL) {
+        goto error;
+    }
+
+    while (p < end) {
+        const char *line_end = find_byte(p, end, '\n');
+        const char *q = p;
+        unsigned long long size = 0;
+        int digits = 0;
+
+        if (line_end == NULL) {
+            break;
+        }
+        while (q < line_end && hex_value((unsigned char)*q) >= 0) {
+            if (++digits > 15) {
+                PyErr_SetString(HttpParserError, "chunk size too large");
+                goto error;
+            }
+            size = (size << 4) | (unsigned long long)hex_value((unsigned char)*q);
+            q++;
+        }
+        if (digits == 0 || (q < line_end && *q != ';' && *q != '\r' && !is_ows(*q))) {
+            PyErr_SetString(HttpParserError, "invalid chunk size");
+            goto error;
+        }
+
+        if (size == 0) {
+            /* Last chunk: skip trailer fields up to the empty line. */
+            const char *t = line_end + 1;
+            for (;;) {
+                const char *trailer_end;
+                if (t >= end) {
+                    goto finished;
+                }
+                if (*t == '\n') {
+                    t++;
+                    break;
+                }
+                if (*t == '\r') {
+                    if (t + 1 >= end) {
+                        goto finished;
+                    }
+                    t += 2;
+                    break;
+                }
+                trailer_end = find_byte(t, end, '\n');
+                if (trailer_end == NULL) {
+                    goto finished;
+                }
+                t = trailer_end + 1;
+            }
+            p = t;
+            done = 1;
+            break;
+        }
+
+        {
+            const char *data_start = line_end + 1;
+            const char *data_end;
+            PyObject *chunk;
+
+            if ((unsigned long long)(end - data_start) < size) {
+                break;
+            }
+            data_end = data_start + size;
+            if (data_end >= end) {
+                break;
+            }
+            if (*data_end == '\r') {
+                if (data_end + 1 >= end) {
+                    break;
+                }
+                if (data_end[1] != '\n') {
+                    PyErr_SetString(HttpParserError, "missing CRLF after chunk data");
+                    goto error;
+                }
+                q = data_end + 2;
+            }
+            else if (*data_end == '\n') {
+                q = data_end + 1;
+            }
+            else {
+                PyErr_SetString(HttpParserError, "missing CRLF after chunk data");
+                goto error;
+            }
+
+            chunk = slice_view(view, base, data_start, data_end);
+            if (chunk == NULL || PyList_Append(chunks, chunk) < 0) {
+                Py_XDECREF(chunk);
+                goto error;
+            }
+            Py_DECREF(chunk);
+            p = q;
+        }
+    }
+
+finished:
+    Py_DECREF(view);
+    PyBuffer_Release(&buf);
+    return Py_BuildValue("(NnO)", chunks, (Py_ssize_t)(p - base),
+                         done ? Py_True : Py_False);
+
+error:
+    Py_XDECREF(chunks);
+    Py_XDECREF(view);
+    PyBuffer_Release(&buf);
+    return NULL;
+}
+
+PyDoc_STRVAR(parse_content_length_doc,
+"parse_content_length(value) -> int\n\n"
+"Parse a Content-Length value (str or bytes), ignoring surrounding\n"
+"whitespace. Raises HttpParserError unless it is a plain decimal number.");
+
+static PyObject *
+parse_content_length(PyObject *self, PyObject *arg)
+{
+    const char *s;
+    Py_ssize_t n;
+    Py_buffer view;
+    int have_view = 0, rc;
+    long long value;
+
+    if (PyUnicode_Check(arg)) {
+        s = PyUnicode_AsUTF8AndSize(arg, &n);
+        if (s == NULL) {
+            return NULL;
+        }
+    }
+    else {
+        if (PyObject_GetBuffer(arg, &view, PyBUF_SIMPLE) < 0) {
+            return NULL;
+        }
+        have_view = 1;
+        s = view.buf;
+        n = view.len;
+    }
+
+    while (n > 0 && is_ows(*s)) {
+        s++;
+        n--;
+    }
+    while (n > 0 && is_ows(s[n - 1])) {
+        n--;
+    }
+    rc = parse_length(s, n, &value);
+    if (have_view) {
+        PyBuffer_Release(&view);
+    }
+    if (rc < 0) {
+        PyErr_SetString(HttpParserError, "invalid Content-Length");
+        return NULL;
+    }
+    return PyLong_FromLongLong(value);
+}
+
+/* ------------------------------------------------------------------------ */
+/* Module definition                                                         */
+/* ------------------------------------------------------------------------ */
+
+static PyMethodDef http_parser_methods[] = {
+    {"parse_headers", parse_headers, METH_O, parse_headers_doc},
+    {"parse_query", parse_query, METH_O, parse_query_doc},
+    {"parse_request", parse_request, METH_O, parse_request_doc},
+    {"parse_chunked", parse_chunked, METH_VARARGS, parse_chunked_doc},
+    {"parse_content_length", parse_content_length, METH_O, parse_content_length_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef http_parser_module = {
+    PyModuleDef_HEAD_INIT,
+    "pyserv.core.http_parser",
+    "Native HTTP parsing primitives for Pyserv.",
+    -1,
+    http_parser_methods,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+PyMODINIT_FUNC
+PyInit_http_parser(void)
+{
+    PyObject *module = PyModule_Create(&http_parser_module);
+    if (module == NULL) {
+        return NULL;
+    }
+
+    HttpParserError = PyErr_NewException("pyserv.core.http_parser.HttpParserError",
+                                         PyExc_ValueError, NULL);
+    if (HttpParserError == NULL || PyModule_AddObject(module, "HttpParserError", HttpParserError) < 0) {
+        Py_XDECREF(HttpParserError);
+        Py_DECREF(module);
+        return NULL;
+    }
+    Py_INCREF(HttpParserError);
+
+    name_cache = PyDict_New();
+    if (name_cache == NULL) {
+        Py_DECREF(module);
+        return NULL;
+    }
+
+#if defined(PYSERV_HAVE_SSE2)
+    PyModule_AddStringConstant(module, "SIMD", "sse2");
+#elif defined(PYSERV_HAVE_NEON)
+    PyModule_AddStringConstant(module, "SIMD", "neon");
+#else
+    PyModule_AddStringConstant(module, "SIMD", "none");
+#endif
+    PyModule_AddIntConstant(module, "MAX_HEADERS", MAX_HEADERS);
+    return module;
+}
@@ -0,0 +1,629 @@
+/*
+ * Pyserv native route tree.
+ *
+ * Native backend for pyserv.routing.radix.RadixTree with the same API:
+ *
+ *   tree = RouteTree()
+ *   tree.insert(segments, rank, entry)
+ *   tree.lookup(path) -> [(entry, values), ...] ordered by rank
+ *
+ * Segments are str literals, None for a single-segment parameter and
+ * Ellipsis for a trailing wildcard. Lookups walk the UTF-8 bytes of the
+ * path directly; static edges are kept sorted and found by binary search,
+ * so only captured parameter values are allocated.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STACK_SEGMENTS 64
+
+typedef struct {
+    Py_ssize_t rank;
+    PyObject *entry;
+} Entry;
+
+typedef struct Node {
+    Py_ssize_t n_static;
+    Py_ssize_t cap_static;
+    char **keys;
+    Py_ssize_t *key_lens;
+    struct Node **children;
+    struct Node *param;
+    Entry *routes;
+    Py_ssize_t n_routes;
+    Entry *wildcard;
+    Py_ssize_t n_wildcard;
+} Node;
+
+typedef struct {
+    PyObject_HEAD
+    Node *root;
+    Py_ssize_t size;
+} RouteTreeObject;
+
+typedef struct {
+    Py_ssize_t rank;
+    PyObject *entry;    /* borrowed from the tree */
+    PyObject *values;   /* owned tuple */
+} Found;
+
+typedef struct {
+    Found *items;
+    Py_ssize_t count;
+    Py_ssize_t capacity;
+} FoundList;
+
+typedef struct {
+    const char *path;
+    const Py_ssize_t *starts;
+    const Py_ssize_t *ends;
+    Py_ssize_t n_parts;
+    Py_ssize_t *captures;
+    FoundList *found;
+} LookupState;
+
+/* ------------------------------------------------------------------------ */
+/* Node management                                                           */
+/* ------------------------------------------------------------------------ */
+
+static Node *
+node_new(void)
+{
+    Node *node = PyMem_Calloc(1, sizeof(Node));
+    if (node == NULL) {
+        PyErr_NoMemory();
+    }
+    return node;
+}
+
+static void
+node_free(Node *node)
+{
+    Py_ssize_t i;
+
+    if (node == NULL) {
+        return;
+    }
+    for (i = 0; i < node->n_static; i++) {
+        PyMem_Free(node->keys[i]);
+        node_free(node->children[i]);
+    }
+    PyMem_Free(node->keys);
+    PyMem_Free(node->key_lens);
+    PyMem_Free(node->children);
+    node_free(node->param);
+    for (i = 0; i < node->n_routes; i++) {
+        Py_XDECREF(node->routes[i].entry);
+    }
+    for (i = 0; i < node->n_wildcard; i++) {
+        Py_XDECREF(node->wildcard[i].entry);
+    }
+    PyMem_Free(node->routes);
+    PyMem_Free(node->wildcard);
+    PyMem_Free(node);
+}
+
+static int
+node_traverse(Node *node, visitproc visit, void *arg)
+{
+    Py_ssize_t i;
+
+    if (node == NULL) {
+        return 0;
+    }
+    for (i = 0; i < node->n_routes; i++) {
+        Py_VISIT(node->routes[i].entry);
+    }
+    for (i = 0; i < node->n_wildcard; i++) {
+        Py_VISIT(node->wildcard[i].entry);
+    }
+    for (i = 0; i < node->n_static; i++) {
+        int rc = node_traverse(node->children[i], visit, arg);
+        if (rc) {
+            return rc;
+        }
+    }
+    return node_traverse(node->param, visit, arg);
+}
+
+/* Order static keys by length, then bytes. */
+static int
+key_compare(const char *a, Py_ssize_t a_len, const char *b, Py_ssize_t b_len)
+{
+    if (a_len != b_len) {
+        return a_len < b_len ? -1 : 1;
+    }
+    return a_len ? memcmp(a, b, a_len) : 0;
+}
+
+/* Binary search; returns the index of key or -(insertion point) - 1. */
+static Py_ssize_t
+node_find_static(const Node *node, const char *key, Py_ssize_t len)
+{
+    Py_ssize_t lo = 0, hi = node->n_static;
+
+    while (lo < hi) {
+        Py_ssize_t mid = lo + (hi - lo) / 2;
+        int cmp = key_compare(node->keys[mid], node->key_lens[mid], key, len);
+        if (cmp == 0) {
+            return mid;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return -lo - 1;
+}
+
+static Node *
+node_static_child(Node *node, const char *key, Py_ssize_t len)
+{
+    Py_ssize_t index = node_find_static(node, key, len);
+    Node *child;
+    char *key_copy;
+
+    if (index >= 0) {
+        return node->children[index];
+    }
+    index = -index - 1;
+
+    if (node->n_static == node->cap_static) {
+        Py_ssize_t capacity = node->cap_static ? node->cap_static * 2 : 4;
+        char **keys = PyMem_Realloc(node->keys, capacity * sizeof(char *));
+        if (keys == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        node->keys = keys;
+        Py_ssize_t *lens = PyMem_Realloc(node->key_lens, capacity * sizeof(Py_ssize_t));
+        if (lens == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        node->key_lens = lens;
+        Node **children = PyMem_Realloc(node->children, capacity * sizeof(Node *));
+        if (children == NULL) {
+            PyErr_NoMemory();
+            return NULL;
+        }
+        node->children = children;
+        node->cap_static = capacity;
+    }
+
+    key_copy = PyMem_Malloc(len ? len : 1);
+    child = node_new();
+    if (key_copy == NULL || child == NULL) {
+        PyMem_Free(key_copy);
+        PyMem_Free(child);
+        if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        return NULL;
+    }
+    memcpy(key_copy, key, len);
+
+    memmove(node->keys + index + 1, node->keys + index,
+            (node->n_static - index) * sizeof(char *));
+    memmove(node->key_lens + index + 1, node->key_lens + index,
+            (node->n_static - index) * sizeof(Py_ssize_t));
+    memmove(node->children + index + 1, node->children + index,
+            (node->n_static - index) * sizeof(Node *));
+    node->keys[index] = key_copy;
+    node->key_lens[index] = len;
+    node->children[index] = child;
+    node->n_static++;
+    return child;
+}
+
+/* Insert into an entry array kept sorted by rank. */
+static int
+entries_insert(Entry **entries, Py_ssize_t *count, Py_ssize_t rank, PyObject *entry)
+{
+    Entry *grown = PyMem_Realloc(*entries, (*count + 1) * sizeof(Entry));
+    Py_ssize_t i;
+
+    if (grown == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    *entries = grown;
+    i = *count;
+    while (i > 0 && grown[i - 1].rank > rank) {
+        grown[i] = grown[i - 1];
+        i--;
+    }
+    Py_INCREF(entry);
+    grown[i].rank = rank;
+    grown[i].entry = entry;
+    (*count)++;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Lookup                                                                    */
+/* ------------------------------------------------------------------------ */
+
+static int
+found_add(LookupState *state, const Entry *entry, Py_ssize_t n_captures)
+{
+    FoundList *found = state->found;
+    PyObject *values;
+    Py_ssize_t i;
+
+    if (found->count == found->capacity) {
+        Py_ssize_t capacity = found->capacity ? found->capacity * 2 : 4;
+        Found *items = PyMem_Realloc(found->items, capacity * sizeof(Found));
+        if (items == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        found->items = items;
+        found->capacity = capacity;
+    }
+
+    values = PyTuple_New(n_captures);
+    if (values == NULL) {
+        return -1;
+    }
+    for (i = 0; i < n_captures; i++) {
+        Py_ssize_t part = state->captures[i];
+        PyObject *value = PyUnicode_DecodeUTF8(state->path + state->starts[part],
+                                               state->ends[part] - state->starts[part],
+                                               NULL);
+        if (value == NULL) {
+            Py_DECREF(values);
+            return -1;
+        }
+        PyTuple_SET_ITEM(values, i, value);
+    }
+
+    found->items[found->count].rank = entry->rank;
+    found->items[found->count].entry = entry->entry;
+    found->items[found->count].values = values;
+    found->count++;
+    return 0;
+}
+
+static int
+lookup_node(LookupState *state, const Node *node, Py_ssize_t depth, Py_ssize_t n_captures)
+{
+    Py_ssize_t i;
+
+    /* A trailing wildcard needs at least one more (possibly empty) segment */
+    if (node->n_wildcard && depth < state->n_parts) {
+        for (i = 0; i < node->n_wildcard; i++) {
+            if (found_add(state, &node->wildcard[i], n_captures) < 0) {
+                return -1;
+            }
+        }
+    }
+
+    if (depth == state->n_parts) {
+        for (i = 0; i < node->n_routes; i++) {
+            if (found_add(state, &node->routes[i], n_captures) < 0) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    {
+        const char *part = state->path + state->starts[depth];
+        Py_ssize_t part_len = state->ends[depth] - state->starts[depth];
+        Py_ssize_t index;
+
+        if (node->n_static) {
+            index = node_find_static(node, part, part_len);
+            if (index >= 0
+                && lookup_node(state, node->children[index], depth + 1, n_captures) < 0) {
+                return -1;
+            }
+        }
+        if (node->param != NULL && part_len > 0) {
+            state->captures[n_captures] = depth;
+            if (lookup_node(state, node->param, depth + 1, n_captures + 1) < 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int
+found_compare(const void *a, const void *b)
+{
+    Py_ssize_t ra = ((const Found *)a)->rank;
+    Py_ssize_t rb = ((const Found *)b)->rank;
+    return (ra > rb) - (ra < rb);
+}
+
+/* ------------------------------------------------------------------------ */
+/* RouteTree type                                                            */
+/* ------------------------------------------------------------------------ */
+
+static PyObject *
+RouteTree_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    RouteTreeObject *self;
+
+    if (PyTuple_GET_SIZE(args) || (kwds != NULL && PyDict_GET_SIZE(kwds))) {
+        PyErr_SetString(PyExc_TypeError, "RouteTree() takes no arguments");
+        return NULL;
+    }
+    self = (RouteTreeObject *)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+    self->root = node_new();
+    if (self->root == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    self->size = 0;
+    return (PyObject *)self;
+}
+
+static int
+RouteTree_traverse(RouteTreeObject *self, visitproc visit, void *arg)
+{
+    return node_traverse(self->root, visit, arg);
+}
+
+static int
+RouteTree_clear(RouteTreeObject *self)
+{
+    Node *root = self->root;
+    self->root = NULL;
+    node_free(root);
+    self->size = 0;
+    return 0;
+}
+
+static void
+RouteTree_dealloc(RouteTreeObject *self)
+{
+    PyObject_GC_UnTrack(self);
+    RouteTree_clear(self);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static Py_ssize_t
+RouteTree_len(RouteTreeObject *self)
+{
+    return self->size;
+}
+
+PyDoc_STRVAR(RouteTree_insert_doc,
+"insert(segments, rank, entry)\n\n"
+"Add entry under a path given as segments: str literals, None for a\n"
+"parameter and a trailing Ellipsis for a wildcard.");
+
+static PyObject *
+RouteTree_insert(RouteTreeObject *self, PyObject *args)
+{
+    PyObject *segments, *entry, *seq;
+    Py_ssize_t rank, i, count;
+    Node *node;
+    int rc;
+
+    if (!PyArg_ParseTuple(args, "OnO:insert", &segments, &rank, &entry)) {
+        return NULL;
+    }
+    if (self->root == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "route tree was cleared");
+        return NULL;
+    }
+    seq = PySequence_Fast(segments, "segments must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    node = self->root;
+    count = PySequence_Fast_GET_SIZE(seq);
+    for (i = 0; i < count; i++) {
+        PyObject *segment = PySequence_Fast_GET_ITEM(seq, i);
+
+        if (segment == Py_Ellipsis) {
+            if (i != count - 1) {
+                PyErr_SetString(PyExc_ValueError, "wildcard must be the last segment");
+                Py_DECREF(seq);
+                return NULL;
+            }
+            rc = entries_insert(&node->wildcard, &node->n_wildcard, rank, entry);
+            Py_DECREF(seq);
+            if (rc < 0) {
+                return NULL;
+            }
+            self->size++;
+            Py_RETURN_NONE;
+        }
+        if (segment == Py_None) {
+            if (node->param == NULL && (node->param = node_new()) == NULL) {
+                Py_DECREF(seq);
+                return NULL;
+            }
+            node = node->param;
+        }
+        else if (PyUnicode_Check(segment)) {
+            Py_ssize_t len;
+            const char *key = PyUnicode_AsUTF8AndSize(segment, &len);
+            if (key == NULL || (node = node_static_child(node, key, len)) == NULL) {
+                Py_DECREF(seq);
+                return NULL;
+            }
+        }
+        else {
+            PyErr_SetString(PyExc_TypeError, "segments must be str, None or Ellipsis");
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+
+    if (entries_insert(&node->routes, &node->n_routes, rank, entry) < 0) {
+        return NULL;
+    }
+    self->size++;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(RouteTree_lookup_doc,
+"lookup(path) -> list\n\n"
+"Return (entry, values) for every entry matching path, ordered by rank.\n"
+"values holds the captured parameter segments.");
+
+static PyObject *
+RouteTree_lookup(RouteTreeObject *self, PyObject *arg)
+{
+    Py_ssize_t stack_starts[STACK_SEGMENTS], stack_ends[STACK_SEGMENTS];
+    Py_ssize_t stack_captures[STACK_SEGMENTS];
+    Py_ssize_t *starts = stack_starts, *ends = stack_ends, *captures = stack_captures;
+    Py_ssize_t len, n_parts = 1, i, part;
+    FoundList found = {NULL, 0, 0};
+    LookupState state;
+    PyObject *result = NULL;
+    const char *path;
+
+    if (!PyUnicode_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "path must be str");
+        return NULL;
+    }
+    if (self->root == NULL) {
+        return PyList_New(0);
+    }
+    path = PyUnicode_AsUTF8AndSize(arg, &len);
+    if (path == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < len; i++) {
+        if (path[i] == '/') {
+            n_parts++;
+        }
+    }
+    if (n_parts > STACK_SEGMENTS) {
+        starts = PyMem_Malloc(n_parts * sizeof(Py_ssize_t));
+        ends = PyMem_Malloc(n_parts * sizeof(Py_ssize_t));
+        captures = PyMem_Malloc(n_parts * sizeof(Py_ssize_t));
+        if (starts == NULL || ends == NULL || captures == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+    }
+
+    starts[0] = 0;
+    for (i = 0, part = 0; i < len; i++) {
+        if (path[i] == '/') {
+            ends[part] = i;
+            starts[++part] = i + 1;
+        }
+    }
+    ends[part] = len;
+
+    state.path = path;
+    state.starts = starts;
+    state.ends = ends;
+    state.n_parts = n_parts;
+    state.captures = captures;
+    state.found = &found;
+
+    if (lookup_node(&state, self->root, 0, 0) < 0) {
+        goto done;
+    }
+    if (found.count > 1) {
+        qsort(found.items, found.count, sizeof(Found), found_compare);
+    }
+
+    result = PyList_New(found.count);
+    if (result == NULL) {
+        goto done;
+    }
+    for (i = 0; i < found.count; i++) {
+        PyObject *pair = PyTuple_Pack(2, found.items[i].entry, found.items[i].values);
+        if (pair == NULL) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, pair);
+    }
+
+done:
+    for (i = 0; i < found.count; i++) {
+        Py_DECREF(found.items[i].values);
+    }
+    PyMem_Free(found.items);
+    if (starts != stack_starts) {
+        PyMem_Free(starts);
+        PyMem_Free(ends);
+        PyMem_Free(captures);
+    }
+    return result;
+}
+
+static PyMethodDef RouteTree_methods[] = {
+    {"insert", (PyCFunction)RouteTree_insert, METH_VARARGS, RouteTree_insert_doc},
+    {"lookup", (PyCFunction)RouteTree_lookup, METH_O, RouteTree_lookup_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static PySequenceMethods RouteTree_as_sequence = {
+    .sq_length = (lenfunc)RouteTree_len,
+};
+
+static PyTypeObject RouteTreeType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "pyserv.core.route_tree.RouteTree",
+    .tp_doc = PyDoc_STR("Segment radix tree for route matching."),
+    .tp_basicsize = sizeof(RouteTreeObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+    .tp_new = RouteTree_new,
+    .tp_dealloc = (destructor)RouteTree_dealloc,
+    .tp_traverse = (traverseproc)RouteTree_traverse,
+    .tp_clear = (inquiry)RouteTree_clear,
+    .tp_methods = RouteTree_methods,
+    .tp_as_sequence = &RouteTree_as_sequence,
+};
+
+/* ------------------------------------------------------------------------ */
+/* Module definition                                                         */
+/* ------------------------------------------------------------------------ */
+
+static struct PyModuleDef route_tree_module = {
+    PyModuleDef_HEAD_INIT,
+    "pyserv.core.route_tree",
+    "Native route matching tree for Pyserv.",
+    -1,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+PyMODINIT_FUNC
+PyInit_route_tree(void)
+{
+    PyObject *module;
+
+    if (PyType_Ready(&RouteTreeType) < 0) {
+        return NULL;
+    }
+    module = PyModule_Create(&route_tree_module);
+    if (module == NULL) {
+        return NULL;
+    }
+    Py_INCREF(&RouteTreeType);
+    if (PyModule_AddObject(module, "RouteTree", (PyObject *)&RouteTreeType) < 0) {
+        Py_DECREF(&RouteTreeType);
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
@@ -0,0 +1,174 @@
+/*
+ * Pyserv native seqlock primitives.
+ *
+ * Memory-ordered accessors for the 64-bit sequence words that guard the
+ * buckets of pyserv.caching.shared_memory_cache. They operate on any
+ * writable buffer, typically an mmap shared between worker processes:
+ *
+ *   seq = read_begin(buf, offset)          # acquire load
+ *   ... copy bucket contents ...
+ *   ok = read_validate(buf, offset, seq)   # acquire fence, reload, compare
+ *
+ *   write_begin(buf, offset)               # seq -> odd, release fence
+ *   ... write bucket contents ...
+ *   write_end(buf, offset)                 # seq -> even, release store
+ *
+ * Writers must already be serialised (the cache uses a per-bucket file
+ * lock); these functions only provide the ordering a seqlock needs on
+ * weakly ordered CPUs.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <stdint.h>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+#error "shm_sync requires GCC-style __atomic builtins"
+#endif
+
+static uint64_t *
+seq_word(Py_buffer *view, PyObject *buffer, Py_ssize_t offset, int flags)
+{
+    if (PyObject_GetBuffer(buffer, view, flags) < 0) {
+        return NULL;
+    }
+    if (offset < 0 || offset % 8 != 0 || offset > view->len - 8) {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_ValueError, "offset must be an 8-byte aligned position inside the buffer");
+        return NULL;
+    }
+    return (uint64_t *)((char *)view->buf + offset);
+}
+
+PyDoc_STRVAR(read_begin_doc,
+"read_begin(buffer, offset) -> int\n\n"
+"Load the sequence word at offset with acquire ordering.");
+
+static PyObject *
+read_begin(PyObject *self, PyObject *args)
+{
+    PyObject *buffer;
+    Py_ssize_t offset;
+    Py_buffer view;
+    uint64_t *word, seq;
+
+    if (!PyArg_ParseTuple(args, "On:read_begin", &buffer, &offset)) {
+        return NULL;
+    }
+    word = seq_word(&view, buffer, offset, PyBUF_SIMPLE);
+    if (word == NULL) {
+        return NULL;
+    }
+    seq = __atomic_load_n(word, __ATOMIC_ACQUIRE);
+    PyBuffer_Release(&view);
+    return PyLong_FromUnsignedLongLong(seq);
+}
+
+PyDoc_STRVAR(read_validate_doc,
+"read_validate(buffer, offset, seq) -> bool\n\n"
+"Return True if seq is even and the word at offset still equals it,\n"
+"i.e. no writer ran while the protected data was being read.");
+
+static PyObject *
+read_validate(PyObject *self, PyObject *args)
+{
+    PyObject *buffer;
+    Py_ssize_t offset;
+    unsigned long long seq;
+    Py_buffer view;
+    uint64_t *word, current;
+
+    if (!PyArg_ParseTuple(args, "OnK:read_validate", &buffer, &offset, &seq)) {
+        return NULL;
+    }
+    word = seq_word(&view, buffer, offset, PyBUF_SIMPLE);
+    if (word == NULL) {
+        return NULL;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    current = __atomic_load_n(word, __ATOMIC_RELAXED);
+    PyBuffer_Release(&view);
+    return PyBool_FromLong((seq & 1) == 0 && current == seq);
+}
+
+PyDoc_STRVAR(write_begin_doc,
+"write_begin(buffer, offset) -> int\n\n"
+"Mark the protected data as being written by making the sequence odd.\n"
+"An odd word left behind by a crashed writer is reused as-is.");
+
+static PyObject *
+write_begin(PyObject *self, PyObject *args)
+{
+    PyObject *buffer;
+    Py_ssize_t offset;
+    Py_buffer view;
+    uint64_t *word, seq;
+
+    if (!PyArg_ParseTuple(args, "On:write_begin", &buffer, &offset)) {
+        return NULL;
+    }
+    word = seq_word(&view, buffer, offset, PyBUF_WRITABLE);
+    if (word == NULL) {
+        return NULL;
+    }
+    seq = __atomic_load_n(word, __ATOMIC_RELAXED);
+    if ((seq & 1) == 0) {
+        seq += 1;
+        __atomic_store_n(word, seq, __ATOMIC_RELAXED);
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    PyBuffer_Release(&view);
+    return PyLong_FromUnsignedLongLong(seq);
+}
+
+PyDoc_STRVAR(write_end_doc,
+"write_end(buffer, offset) -> int\n\n"
+"Publish the written data by making the sequence even again.");
+
+static PyObject *
+write_end(PyObject *self, PyObject *args)
+{
+    PyObject *buffer;
+    Py_ssize_t offset;
+    Py_buffer view;
+    uint64_t *word, seq;
+
+    if (!PyArg_ParseTuple(args, "On:write_end", &buffer, &offset)) {
+        return NULL;
+    }
+    word = seq_word(&view, buffer, offset, PyBUF_WRITABLE);
+    if (word == NULL) {
+        return NULL;
+    }
+    seq = __atomic_load_n(word, __ATOMIC_RELAXED);
+    seq = (seq | 1) + 1;
+    __atomic_store_n(word, seq, __ATOMIC_RELEASE);
+    PyBuffer_Release(&view);
+    return PyLong_FromUnsignedLongLong(seq);
+}
+
+static PyMethodDef shm_sync_methods[] = {
+    {"read_begin", read_begin, METH_VARARGS, read_begin_doc},
+    {"read_validate", read_validate, METH_VARARGS, read_validate_doc},
+    {"write_begin", write_begin, METH_VARARGS, write_begin_doc},
+    {"write_end", write_end, METH_VARARGS, write_end_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef shm_sync_module = {
+    PyModuleDef_HEAD_INIT,
+    "pyserv.core.shm_sync",
+    "Native seqlock primitives for Pyserv shared-memory caches.",
+    -1,
+    shm_sync_methods,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+PyMODINIT_FUNC
+PyInit_shm_sync(void)
+{
+    return PyModule_Create(&shm_sync_module);
+}
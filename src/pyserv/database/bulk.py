@@ -0,0 +1,105 @@
+"""
+Shared helpers for the bulk write path (insert_many / upsert_many / update_many).
+
+Rows may come from a list, any iterable, or an async iterable, so an import
+can stream a file into the database without materialising it. Rows are
+grouped into chunks small enough for the backend's bind-parameter limit,
+and between chunks the writer yields to the event loop and, if a
+``rate_limit`` (rows per second) is set, sleeps to stay under it.
+"""
+
+import asyncio
+import time
+from typing import Any, AsyncIterator, Dict, Iterable, List, Optional, Sequence, Tuple, Union
+
+Rows = Union[Iterable[Dict[str, Any]], AsyncIterator[Dict[str, Any]]]
+
+# Bind parameters allowed in one statement
+POSTGRESQL_MAX_PARAMS = 32767
+MYSQL_MAX_PARAMS = 65535
+
+DEFAULT_BATCH_SIZE = 5000
+
+
+def chunk_size(columns: int, max_params: Optional[int], batch_size: Optional[int]) -> int:
+    """Largest row count per statement that respects the parameter limit."""
+    size = batch_size or DEFAULT_BATCH_SIZE
+    if max_params and columns:
+        size = min(size, max(1, max_params // columns))
+    return size
+
+
+def row_to_dict(row: Any) -> Dict[str, Any]:
+    """Accept plain dicts and model instances."""
+    if isinstance(row, dict):
+        return row
+    to_dict = getattr(row, 'to_dict', None)
+    if callable(to_dict):
+        return to_dict()
+    raise TypeError(f"Bulk rows must be dicts or models, got {type(row).__name__}")
+
+
+async def _aiter(rows: Rows) -> AsyncIterator[Any]:
+    if hasattr(rows, '__aiter__'):
+        async for row in rows:
+            yield row
+    else:
+        for row in rows:
+            yield row
+
+
+def columns_of(chunk: Sequence[Dict[str, Any]], columns: Optional[Sequence[str]] = None) -> Tuple[str, ...]:
+    """Column order for a chunk: explicit, else the first row's keys."""
+    return tuple(columns) if columns else tuple(chunk[0].keys())
+
+
+def as_tuples(chunk: Sequence[Dict[str, Any]], columns: Sequence[str]) -> List[tuple]:
+    """Rows as tuples in column order; missing keys become NULL."""
+    return [tuple(row.get(column) for column in columns) for row in chunk]
+
+
+class Throttle:
+    """Cooperative backpressure between chunks."""
+
+    def __init__(self, rate_limit: Optional[float] = None):
+        self.rate_limit = rate_limit
+        self.written = 0
+        self._started = time.monotonic()
+
+    async def after(self, rows: int) -> None:
+        self.written += rows
+        if self.rate_limit:
+            ahead = self.written / self.rate_limit - (time.monotonic() - self._started)
+            if ahead > 0:
+                await asyncio.sleep(ahead)
+                return
+        # Let request handlers run between chunks of a long import
+        await asyncio.sleep(0)
+
+
+async def chunked(rows: Rows, max_params: Optional[int], batch_size: Optional[int],
+                  rate_limit: Optional[float] = None) -> AsyncIterator[List[Dict[str, Any]]]:
+    """
+    Group rows into chunks that fit the parameter limit, throttling after each.
+
+    The chunk size is derived from the width of the first row.
+    """
+    throttle = Throttle(rate_limit)
+    size = None
+    chunk: List[Dict[str, Any]] = []
+    async for row in _aiter(rows):
+        row = row_to_dict(row)
+        if size is None:
+            size = chunk_size(len(row), max_params, batch_size)
+        chunk.append(row)
+        if len(chunk) >= size:
+            yield chunk
+            await throttle.after(len(chunk))
+            chunk = []
+    if chunk:
+        yield chunk
+        await throttle.after(len(chunk))
+
+
+__all__ = ['DEFAULT_BATCH_SIZE', 'POSTGRESQL_MAX_PARAMS', 'MYSQL_MAX_PARAMS', 'Throttle',
+           'as_tuples', 'chunk_size', 'chunked', 'columns_of', 'row_to_dict']
@@ -1,8 +1,10 @@
-from typing import List, Dict, Any, AsyncGenerator, Type, Optional, Tuple
+from typing import List, Dict, Any, AsyncGenerator, AsyncIterator, Type, Optional, Tuple
 from motor.motor_asyncio import AsyncIOMotorClient
 from contextlib import asynccontextmanager
-from pymongo import ASCENDING, DESCENDING
+from pymongo import ASCENDING, DESCENDING, UpdateOne
 from bson import ObjectId
+from pyserv.database import bulk
+from pyserv.database.pool import PoolConfig
 from pyserv.database.config import DatabaseConfig
 from pyserv.utils.types import Field
 
@@ -14,16 +16,23 @@ class MongoDBConnection:
         self.config = config
         self.client = None
         self.db = None
+        self.pool_config = PoolConfig()
 
     async def connect(self) -> None:
         """Connect to the database"""
         params = self.config.get_connection_params()
+        # The driver pools sockets itself; apply the same sizing and timeouts
+        pool = self.pool_config
         self.client = AsyncIOMotorClient(
             host=params['host'],
             port=params['port'],
             username=params['username'],
             password=params['password'],
-            authSource=params['authSource']
+            authSource=params['authSource'],
+            minPoolSize=pool.min_size,
+            maxPoolSize=pool.max_size,
+            maxIdleTimeMS=pool.max_idle_time * 1000,
+            waitQueueTimeoutMS=pool.acquire_timeout * 1000,
         )
         self.db = self.client[self.config.database]
 
@@ -119,6 +128,76 @@ class MongoDBConnection:
         result = await collection.insert_one(mongo_data)
         return str(result.inserted_id)
 
+    async def insert_many(self, model_class: Type, rows: bulk.Rows, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert documents with unordered insert_many, chunk by chunk.
+
+        Returns:
+            Number of documents written
+        """
+        collection = self.db[model_class.get_table_name()]
+        written = 0
+        async for chunk in bulk.chunked(rows, None, batch_size, rate_limit):
+            result = await collection.insert_many([self._convert_to_mongo(row) for row in chunk], ordered=False)
+            written += len(result.inserted_ids)
+        return written
+
+    async def upsert_many(self, model_class: Type, rows: bulk.Rows, conflict_fields: List[str],
+                          update_fields: Optional[List[str]] = None, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert-or-update with bulk_write of upserting UpdateOne operations.
+
+        Returns:
+            Number of documents inserted or modified
+        """
+        conflicts = self._mongo_fields(conflict_fields)
+        updated = None if update_fields is None else self._mongo_fields(update_fields)
+
+        def operation(row):
+            document = self._convert_to_mongo(row)
+            match = {field: document.get(field) for field in conflicts}
+            if updated is None:
+                updates = {k: v for k, v in document.items() if k not in match}
+            else:
+                updates = {k: document.get(k) for k in updated if k not in match}
+            inserts = {k: v for k, v in document.items() if k not in updates and k not in match}
+            update = {}
+            if updates:
+                update["$set"] = updates
+            if inserts:
+                update["$setOnInsert"] = inserts
+            return UpdateOne(match, update or {"$setOnInsert": match}, upsert=True)
+
+        return await self._bulk_write(model_class, rows, operation, batch_size, rate_limit)
+
+    async def update_many(self, model_class: Type, rows: bulk.Rows, key_fields: List[str] = ('id',),
+                          batch_size: Optional[int] = None, rate_limit: Optional[float] = None) -> int:
+        """
+        Update many documents, each matched by its key_fields, with bulk_write.
+
+        Returns:
+            Number of documents modified
+        """
+        keys = self._mongo_fields(key_fields)
+
+        def operation(row):
+            document = self._convert_to_mongo(row)
+            match = {field: document.get(field) for field in keys}
+            return UpdateOne(match, {"$set": {k: v for k, v in document.items() if k not in match}})
+
+        return await self._bulk_write(model_class, rows, operation, batch_size, rate_limit)
+
+    async def _bulk_write(self, model_class: Type, rows: bulk.Rows, operation, batch_size: Optional[int],
+                          rate_limit: Optional[float]) -> int:
+        collection = self.db[model_class.get_table_name()]
+        written = 0
+        async for chunk in bulk.chunked(rows, None, batch_size, rate_limit):
+            result = await collection.bulk_write([operation(row) for row in chunk], ordered=False)
+            written += result.upserted_count + result.modified_count
+        return written
+
     async def update_one(self, model_class: Type, filters: Dict[str, Any], data: Dict[str, Any]) -> bool:
         """Update a single document"""
         collection = self.db[model_class.get_table_name()]
@@ -208,6 +287,11 @@ class MongoDBConnection:
 
         return results
 
+    @staticmethod
+    def _mongo_fields(fields: List[str]) -> List[str]:
+        """Rename field names the way _convert_to_mongo renames document keys"""
+        return ['_id' if field == 'id' else field for field in fields]
+
     def _convert_to_mongo(self, data: Dict[str, Any]) -> Dict[str, Any]:
         """Convert data to MongoDB format"""
         mongo_data = {}
@@ -410,6 +494,64 @@ class MongoDBConnection:
 
         return results
 
+    async def iter_query_builder(self, model_class: Type, query_params: Dict[str, Any],
+                                 batch_size: int = 1000) -> AsyncIterator[Tuple[Tuple[str, ...], List[tuple]]]:
+        """
+        Stream a QueryBuilder query with a batched find cursor.
+
+        Columns are the selected fields, or the keys of the first document.
+        Grouped and distinct queries run as an aggregation and are chunked.
+
+        Yields:
+            (column names, rows as tuples) for up to batch_size rows at a time
+        """
+        select_fields = query_params.get('select_fields') or []
+        columns: Optional[Tuple[str, ...]] = tuple(select_fields) or None
+
+        def to_rows(documents):
+            nonlocal columns
+            if columns is None:
+                columns = tuple(documents[0].keys())
+            rows = []
+            for document in documents:
+                if isinstance(document.get('_id'), ObjectId):
+                    document['_id'] = str(document['_id'])
+                rows.append(tuple(document.get(column) for column in columns))
+            return rows
+
+        if query_params.get('group_by') or query_params.get('having') or query_params.get('distinct'):
+            results = await self.execute_query_builder(model_class, query_params)
+            for start in range(0, len(results), batch_size):
+                rows = to_rows(results[start:start + batch_size])
+                yield columns, rows
+            return
+
+        projection = {field: 1 for field in select_fields} if select_fields else None
+        query = self.db[model_class.get_table_name()].find(
+            self._convert_filters_to_mongo(query_params.get('filters') or {}), projection
+        ).batch_size(batch_size)
+        order_by = query_params.get('order_by') or []
+        if order_by:
+            query = query.sort([
+                (field, DESCENDING if direction in (-1, 'DESC', 'desc') else ASCENDING)
+                for field, direction in order_by
+            ])
+        if query_params.get('offset'):
+            query = query.skip(query_params['offset'])
+        if query_params.get('limit') is not None:
+            query = query.limit(query_params['limit'])
+
+        documents = []
+        async for document in query:
+            documents.append(document)
+            if len(documents) >= batch_size:
+                rows = to_rows(documents)
+                yield columns, rows
+                documents = []
+        if documents:
+            rows = to_rows(documents)
+            yield columns, rows
+
     def _convert_filters_to_mongo(self, filters: Dict[str, Any]) -> Dict[str, Any]:
         """Convert query filters to MongoDB format"""
         mongo_filters = {}
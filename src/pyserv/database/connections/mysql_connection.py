@@ -1,7 +1,10 @@
-from typing import List, Dict, Any, AsyncGenerator, Type, Optional, Tuple
+from typing import List, Dict, Any, AsyncGenerator, AsyncIterator, Type, Optional, Tuple
 import aiomysql
 from contextlib import asynccontextmanager
 from pyserv.database.config import DatabaseConfig
+from pyserv.database import bulk
+from pyserv.database.pool import ConnectionPool, ConnectionStats, PoolConfig
+from pyserv.database.query_plan import PlanCache, MYSQL
 from pyserv.utils.types import Field, StringField, IntegerField, BooleanField, DateTimeField, FieldType
 
 
@@ -11,24 +14,27 @@ class MySQLConnection:
     def __init__(self, config: DatabaseConfig):
         self.config = config
         self.pool = None
+        self.pool_config = PoolConfig()
+        # aiomysql speaks the text protocol, so MySQL has no server-side
+        # prepared statements to reuse; the plan cache saves the SQL building
+        self.plan_cache = PlanCache(MYSQL)
 
     async def connect(self) -> None:
         """Connect to the database"""
-        params = self.config.get_connection_params()
-        self.pool = await aiomysql.create_pool(
-            host=params['host'],
-            port=params['port'],
-            user=params['user'],
-            password=params['password'],
-            db=params['database'],
-            autocommit=True
+        self.pool = ConnectionPool(
+            self._create_connection,
+            close=lambda connection: connection.close(),
+            validate=self._validate_connection,
+            reset=self._reset_connection,
+            config=self.pool_config,
+            name='mysql',
         )
+        await self.pool.start()
 
     async def disconnect(self) -> None:
         """Disconnect from the database"""
         if self.pool:
-            self.pool.close()
-            await self.pool.wait_closed()
+            await self.pool.close()
 
     async def execute_query(self, query: str, params: tuple = None) -> Any:
         """Execute a SQL query"""
@@ -142,6 +148,77 @@ class MySQLConnection:
                 await connection.commit()
                 return cursor.lastrowid
 
+    async def insert_many(self, model_class: Type, rows: bulk.Rows, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert with multi-row VALUES statements sized to the placeholder limit.
+
+        Returns:
+            Number of rows written
+        """
+        return await self._insert_chunks(model_class, rows, "", batch_size, rate_limit)
+
+    async def upsert_many(self, model_class: Type, rows: bulk.Rows, conflict_fields: List[str],
+                          update_fields: Optional[List[str]] = None, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert-or-update with INSERT ... ON DUPLICATE KEY UPDATE.
+
+        MySQL matches on the table's unique keys, so conflict_fields only
+        decides which columns are left alone; an empty update_fields means
+        INSERT IGNORE.
+
+        Returns:
+            Number of rows affected, as reported by MySQL
+        """
+        def suffix(columns):
+            updates = [c for c in columns if c not in conflict_fields] if update_fields is None else update_fields
+            if not updates:
+                return None
+            return " ON DUPLICATE KEY UPDATE " + ', '.join(f"{c} = VALUES({c})" for c in updates)
+
+        return await self._insert_chunks(model_class, rows, suffix, batch_size, rate_limit)
+
+    async def _insert_chunks(self, model_class: Type, rows: bulk.Rows, suffix, batch_size: Optional[int],
+                             rate_limit: Optional[float]) -> int:
+        table = model_class.get_table_name()
+        written = 0
+        async with self.pool.acquire() as connection:
+            async with connection.cursor() as cursor:
+                async for chunk in bulk.chunked(rows, bulk.MYSQL_MAX_PARAMS, batch_size, rate_limit):
+                    columns = bulk.columns_of(chunk)
+                    tail = suffix(columns) if callable(suffix) else suffix
+                    verb = "INSERT IGNORE" if tail is None else "INSERT"
+                    row_placeholder = f"({', '.join(['%s'] * len(columns))})"
+                    query = (f"{verb} INTO {table} ({', '.join(columns)}) VALUES "
+                             f"{', '.join([row_placeholder] * len(chunk))}{tail or ''}")
+                    await cursor.execute(query, [value for row in bulk.as_tuples(chunk, columns) for value in row])
+                    written += cursor.rowcount
+                await connection.commit()
+        return written
+
+    async def update_many(self, model_class: Type, rows: bulk.Rows, key_fields: List[str] = ('id',),
+                          batch_size: Optional[int] = None, rate_limit: Optional[float] = None) -> int:
+        """
+        Update many rows, each matched by its key_fields, with executemany.
+
+        Returns:
+            Number of rows changed, as reported by MySQL
+        """
+        table = model_class.get_table_name()
+        written = 0
+        async with self.pool.acquire() as connection:
+            async with connection.cursor() as cursor:
+                async for chunk in bulk.chunked(rows, None, batch_size, rate_limit):
+                    columns = [c for c in bulk.columns_of(chunk) if c not in key_fields]
+                    set_clause = ', '.join(f"{c} = %s" for c in columns)
+                    where_clause = ' AND '.join(f"{k} = %s" for k in key_fields)
+                    query = f"UPDATE {table} SET {set_clause} WHERE {where_clause}"
+                    await cursor.executemany(query, bulk.as_tuples(chunk, list(columns) + list(key_fields)))
+                    written += cursor.rowcount
+                await connection.commit()
+        return written
+
     async def update_one(self, model_class: Type, filters: Dict[str, Any], data: Dict[str, Any]) -> bool:
         """Update a single record"""
         set_clause = ', '.join([f"{k} = {self.get_param_placeholder(i+1)}" for i, k in enumerate(data.keys())])
@@ -200,9 +277,26 @@ class MySQLConnection:
                 results = await cursor.fetchall()
                 return [dict(row) for row in results]
 
+    def get_pool_stats(self) -> Optional[ConnectionStats]:
+        """Get connection pool statistics"""
+        return self.pool.get_stats() if self.pool else None
+
+    async def _validate_connection(self, connection: Any) -> bool:
+        """Check an idle pooled connection is still alive"""
+        if connection.closed:
+            return False
+        await connection.ping(reconnect=False)
+        return True
+
+    async def _reset_connection(self, connection: Any) -> None:
+        """Roll back a transaction left open, as aiomysql's own pool does"""
+        if connection.closed:
+            raise ConnectionError("connection is closed")
+        if connection.get_transaction_status():
+            await connection.rollback()
+
     async def _create_connection(self) -> Any:
         """Create a new MySQL connection for pooling"""
-        import aiomysql
         params = self.config.get_connection_params()
         return await aiomysql.connect(
             host=params['host'],
@@ -408,98 +502,34 @@ class MySQLConnection:
 
     async def execute_query_builder(self, model_class: Type, query_params: Dict[str, Any]) -> List[Dict[str, Any]]:
         """Execute a complex query built by QueryBuilder for MySQL"""
-        # Extract query parameters
-        select_fields = query_params.get('select_fields', [])
-        distinct = query_params.get('distinct', False)
-        filters = query_params.get('filters', {})
-        limit = query_params.get('limit')
-        offset = query_params.get('offset')
-        order_by = query_params.get('order_by', [])
-        group_by = query_params.get('group_by', [])
-        having = query_params.get('having', [])
-
-        # Build SELECT clause
-        select_clause = "SELECT "
-        if distinct:
-            select_clause += "DISTINCT "
-        if select_fields:
-            select_clause += ', '.join(select_fields)
-        else:
-            select_clause += '*'
-
-        # Build FROM clause
-        from_clause = f"FROM {model_class.get_table_name()}"
-
-        # Build WHERE clause
-        where_clause = ""
-        params = []
-        if filters:
-            conditions = []
-            for key, value in filters.items():
-                if isinstance(value, dict):
-                    # Handle MongoDB-style operators
-                    for op, val in value.items():
-                        if op == '$gt':
-                            conditions.append(f"{key} > %s")
-                            params.append(val)
-                        elif op == '$lt':
-                            conditions.append(f"{key} < %s")
-                            params.append(val)
-                        elif op == '$gte':
-                            conditions.append(f"{key} >= %s")
-                            params.append(val)
-                        elif op == '$lte':
-                            conditions.append(f"{key} <= %s")
-                            params.append(val)
-                        elif op == '$ne':
-                            conditions.append(f"{key} != %s")
-                            params.append(val)
-                        elif op == '$in':
-                            placeholders = ', '.join(['%s' for _ in val])
-                            conditions.append(f"{key} IN ({placeholders})")
-                            params.extend(val)
-                        elif op == '$regex':
-                            conditions.append(f"{key} LIKE %s")
-                            params.append(val.replace('.*', '%'))
-                else:
-                    conditions.append(f"{key} = %s")
-                    params.append(value)
-            if conditions:
-                where_clause = f"WHERE {' AND '.join(conditions)}"
-
-        # Build GROUP BY clause
-        group_clause = ""
-        if group_by:
-            group_clause = f"GROUP BY {', '.join(group_by)}"
-
-        # Build HAVING clause
-        having_clause = ""
-        if having:
-            having_conditions = []
-            for condition in having:
-                # Simple parsing - in practice, you'd need more sophisticated parsing
-                having_conditions.append(condition)
-            if having_conditions:
-                having_clause = f"HAVING {' AND '.join(having_conditions)}"
-
-        # Build ORDER BY clause
-        order_clause = ""
-        if order_by:
-            order_parts = []
-            for field, direction in order_by:
-                order_parts.append(f"{field} {'DESC' if direction == -1 else 'ASC'}")
-            order_clause = f"ORDER BY {', '.join(order_parts)}"
+        plan, params = self.plan_cache.prepare(query_params, model_class.get_table_name())
 
-        # Build LIMIT and OFFSET clauses
-        limit_clause = f"LIMIT {limit}" if limit else ""
-        offset_clause = f"OFFSET {offset}" if offset else ""
-
-        # Combine all parts
-        query = f"{select_clause} {from_clause} {where_clause} {group_clause} {having_clause} {order_clause} {limit_clause} {offset_clause}".strip()
-
-        # Execute query
         async with self.pool.acquire() as connection:
             async with connection.cursor(aiomysql.DictCursor) as cursor:
-                await cursor.execute(query, tuple(params))
+                await cursor.execute(plan.sql, tuple(params))
                 results = await cursor.fetchall()
                 return [dict(row) for row in results]
+
+    async def iter_query_builder(self, model_class: Type, query_params: Dict[str, Any],
+                                 batch_size: int = 1000) -> AsyncIterator[Tuple[Tuple[str, ...], List[tuple]]]:
+        """
+        Stream a QueryBuilder query with an unbuffered server-side cursor.
+
+        Yields:
+            (column names, rows as tuples) for up to batch_size rows at a time
+        """
+        plan, params = self.plan_cache.prepare(query_params, model_class.get_table_name())
+
+        async with self.pool.acquire() as connection:
+            async with connection.cursor(aiomysql.SSCursor) as cursor:
+                await cursor.execute(plan.sql, tuple(params))
+                columns = tuple(column[0] for column in cursor.description)
+                while True:
+                    rows = await cursor.fetchmany(batch_size)
+                    if not rows:
+                        break
+                    yield columns, list(rows)
+
+    def get_plan_cache_stats(self) -> Dict[str, Any]:
+        """Get QueryBuilder plan cache statistics"""
+        return self.plan_cache.get_stats()
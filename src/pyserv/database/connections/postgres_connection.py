@@ -5,7 +5,7 @@ Real PostgreSQL database connection implementation with full CRUD operations.
 import asyncpg
 import json
 import os
-from typing import List, Dict, Any, AsyncGenerator, Type, Optional, Tuple, Union
+from typing import List, Dict, Any, AsyncGenerator, AsyncIterator, Type, Optional, Tuple, Union
 from contextlib import asynccontextmanager
 from datetime import datetime
 import logging
@@ -14,6 +14,9 @@ from decimal import Decimal
 from urllib.parse import urlparse
 
 from pyserv.database.config import DatabaseConfig
+from pyserv.database import bulk
+from pyserv.database.pool import ConnectionPool, ConnectionStats, PoolConfig
+from pyserv.database.query_plan import PlanCache, POSTGRESQL
 from pyserv.utils.types import Field, StringField, IntegerField, BooleanField, DateTimeField, FieldType
 
 logger = logging.getLogger(__name__)
@@ -22,14 +25,25 @@ logger = logging.getLogger(__name__)
 class PostgreSQLConnection:
     """PostgreSQL database connection"""
 
+    # Prepared statements asyncpg keeps per pooled connection
+    statement_cache_size = 512
+
     def __init__(self, config: DatabaseConfig):
         self.config = config
         self.pool = None
+        self.pool_config = PoolConfig()
+        self.plan_cache = PlanCache(POSTGRESQL)
 
     async def connect(self) -> None:
         """Connect to the database"""
-        params = self.config.get_connection_params()
-        self.pool = await asyncpg.create_pool(**params)
+        self.pool = ConnectionPool(
+            self._create_connection,
+            validate=self._validate_connection,
+            reset=self._reset_connection,
+            config=self.pool_config,
+            name='postgresql',
+        )
+        await self.pool.start()
 
     async def disconnect(self) -> None:
         """Disconnect from the database"""
@@ -133,6 +147,76 @@ class PostgreSQLConnection:
             result = await connection.fetchrow(query, *values)
             return dict(result) if result else None
 
+    async def insert_many(self, model_class: Type, rows: bulk.Rows, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert rows with COPY.
+
+        Each chunk of batch_size rows is one COPY, committed on its own.
+
+        Returns:
+            Number of rows written
+        """
+        table = model_class.get_table_name()
+        written = 0
+        async with self.pool.acquire() as connection:
+            async for chunk in bulk.chunked(rows, None, batch_size, rate_limit):
+                columns = bulk.columns_of(chunk)
+                await connection.copy_records_to_table(
+                    table, records=bulk.as_tuples(chunk, columns), columns=list(columns)
+                )
+                written += len(chunk)
+        return written
+
+    async def upsert_many(self, model_class: Type, rows: bulk.Rows, conflict_fields: List[str],
+                          update_fields: Optional[List[str]] = None, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert-or-update with INSERT ... ON CONFLICT, pipelined with executemany.
+
+        Args:
+            conflict_fields: Columns of the unique constraint to match on
+            update_fields: Columns to overwrite on conflict (default: all others);
+                an empty list means DO NOTHING
+
+        Returns:
+            Number of rows submitted
+        """
+        table = model_class.get_table_name()
+        written = 0
+        async with self.pool.acquire() as connection:
+            async for chunk in bulk.chunked(rows, None, batch_size, rate_limit):
+                columns = bulk.columns_of(chunk)
+                updates = [c for c in columns if c not in conflict_fields] if update_fields is None else update_fields
+                placeholders = ', '.join(f"${i + 1}" for i in range(len(columns)))
+                action = (f"DO UPDATE SET {', '.join(f'{c} = EXCLUDED.{c}' for c in updates)}"
+                          if updates else "DO NOTHING")
+                query = (f"INSERT INTO {table} ({', '.join(columns)}) VALUES ({placeholders}) "
+                         f"ON CONFLICT ({', '.join(conflict_fields)}) {action}")
+                await connection.executemany(query, bulk.as_tuples(chunk, columns))
+                written += len(chunk)
+        return written
+
+    async def update_many(self, model_class: Type, rows: bulk.Rows, key_fields: List[str] = ('id',),
+                          batch_size: Optional[int] = None, rate_limit: Optional[float] = None) -> int:
+        """
+        Update many rows, each matched by its key_fields, with executemany.
+
+        Returns:
+            Number of rows submitted
+        """
+        table = model_class.get_table_name()
+        written = 0
+        async with self.pool.acquire() as connection:
+            async for chunk in bulk.chunked(rows, None, batch_size, rate_limit):
+                columns = [c for c in bulk.columns_of(chunk) if c not in key_fields]
+                set_clause = ', '.join(f"{c} = ${i + 1}" for i, c in enumerate(columns))
+                where_clause = ' AND '.join(f"{k} = ${len(columns) + i + 1}" for i, k in enumerate(key_fields))
+                query = f"UPDATE {table} SET {set_clause} WHERE {where_clause}"
+                await connection.executemany(query, bulk.as_tuples(chunk, list(columns) + list(key_fields)))
+                written += len(chunk)
+        return written
+
     async def update_one(self, model_class: Type, filters: Dict[str, Any], data: Dict[str, Any]) -> bool:
         """Update a single record"""
         set_clause = ', '.join([f"{k} = {self.get_param_placeholder(i+1)}" for i, k in enumerate(data.keys())])
@@ -379,111 +463,59 @@ class PostgreSQLConnection:
 
     async def execute_query_builder(self, model_class: Type, query_params: Dict[str, Any]) -> List[Dict[str, Any]]:
         """Execute a complex query built by QueryBuilder for PostgreSQL"""
-        # Extract query parameters
-        select_fields = query_params.get('select_fields', [])
-        distinct = query_params.get('distinct', False)
-        filters = query_params.get('filters', {})
-        limit = query_params.get('limit')
-        offset = query_params.get('offset')
-        order_by = query_params.get('order_by', [])
-        group_by = query_params.get('group_by', [])
-        having = query_params.get('having', [])
-
-        # Build SELECT clause
-        select_clause = "SELECT "
-        if distinct:
-            select_clause += "DISTINCT "
-        if select_fields:
-            select_clause += ', '.join(select_fields)
-        else:
-            select_clause += '*'
-
-        # Build FROM clause
-        from_clause = f"FROM {model_class.get_table_name()}"
-
-        # Build WHERE clause
-        where_clause = ""
-        params = []
-        param_index = 1
-        if filters:
-            conditions = []
-            for key, value in filters.items():
-                if isinstance(value, dict):
-                    # Handle MongoDB-style operators
-                    for op, val in value.items():
-                        if op == '$gt':
-                            conditions.append(f"{key} > ${param_index}")
-                            params.append(val)
-                            param_index += 1
-                        elif op == '$lt':
-                            conditions.append(f"{key} < ${param_index}")
-                            params.append(val)
-                            param_index += 1
-                        elif op == '$gte':
-                            conditions.append(f"{key} >= ${param_index}")
-                            params.append(val)
-                            param_index += 1
-                        elif op == '$lte':
-                            conditions.append(f"{key} <= ${param_index}")
-                            params.append(val)
-                            param_index += 1
-                        elif op == '$ne':
-                            conditions.append(f"{key} != ${param_index}")
-                            params.append(val)
-                            param_index += 1
-                        elif op == '$in':
-                            placeholders = ', '.join([f"${param_index + i}" for i in range(len(val))])
-                            conditions.append(f"{key} IN ({placeholders})")
-                            params.extend(val)
-                            param_index += len(val)
-                        elif op == '$regex':
-                            conditions.append(f"{key} ~ ${param_index}")
-                            params.append(val)
-                            param_index += 1
-                else:
-                    conditions.append(f"{key} = ${param_index}")
-                    params.append(value)
-                    param_index += 1
-            if conditions:
-                where_clause = f"WHERE {' AND '.join(conditions)}"
-
-        # Build GROUP BY clause
-        group_clause = ""
-        if group_by:
-            group_clause = f"GROUP BY {', '.join(group_by)}"
-
-        # Build HAVING clause
-        having_clause = ""
-        if having:
-            having_conditions = []
-            for condition in having:
-                # Simple parsing - in practice, you'd need more sophisticated parsing
-                having_conditions.append(condition)
-            if having_conditions:
-                having_clause = f"HAVING {' AND '.join(having_conditions)}"
-
-        # Build ORDER BY clause
-        order_clause = ""
-        if order_by:
-            order_parts = []
-            for field, direction in order_by:
-                order_parts.append(f"{field} {'DESC' if direction == -1 else 'ASC'}")
-            order_clause = f"ORDER BY {', '.join(order_parts)}"
+        plan, params = self.plan_cache.prepare(query_params, model_class.get_table_name())
+
+        # The SQL text is stable per query shape, so asyncpg reuses the
+        # connection's prepared statement instead of parsing it again
+        async with self.pool.acquire() as connection:
+            results = await connection.fetch(plan.sql, *params)
+            return [dict(row) for row in results]
 
-        # Build LIMIT and OFFSET clauses
-        limit_clause = f"LIMIT {limit}" if limit else ""
-        offset_clause = f"OFFSET {offset}" if offset else ""
+    async def iter_query_builder(self, model_class: Type, query_params: Dict[str, Any],
+                                 batch_size: int = 1000) -> AsyncIterator[Tuple[Tuple[str, ...], List[tuple]]]:
+        """
+        Stream a QueryBuilder query through a server-side cursor.
 
-        # Combine all parts
-        query = f"{select_clause} {from_clause} {where_clause} {group_clause} {having_clause} {order_clause} {limit_clause} {offset_clause}".strip()
+        Yields:
+            (column names, rows as tuples) for up to batch_size rows at a time
+        """
+        plan, params = self.plan_cache.prepare(query_params, model_class.get_table_name())
 
-        # Execute query
+        # Cursors only live inside a transaction; the connection stays held until exhausted
         async with self.pool.acquire() as connection:
-            results = await connection.fetch(query, *params)
-            return [dict(row) for row in results]
+            async with connection.transaction():
+                statement = await connection.prepare(plan.sql)
+                columns = tuple(attribute.name for attribute in statement.get_attributes())
+                cursor = await statement.cursor(*params)
+                while True:
+                    rows = await cursor.fetch(batch_size)
+                    if not rows:
+                        break
+                    yield columns, [tuple(row) for row in rows]
+
+    def get_plan_cache_stats(self) -> Dict[str, Any]:
+        """Get QueryBuilder plan cache statistics"""
+        return self.plan_cache.get_stats()
+
+    def get_pool_stats(self) -> Optional[ConnectionStats]:
+        """Get connection pool statistics"""
+        return self.pool.get_stats() if self.pool else None
 
     async def _create_connection(self) -> Any:
         """Create a new PostgreSQL connection for pooling"""
-        import asyncpg
         params = self.config.get_connection_params()
+        params.setdefault('statement_cache_size', self.statement_cache_size)
         return await asyncpg.connect(**params)
+
+    async def _validate_connection(self, connection: Any) -> bool:
+        """Check an idle pooled connection is still alive"""
+        if connection.is_closed():
+            return False
+        await connection.fetchval("SELECT 1")
+        return True
+
+    async def _reset_connection(self, connection: Any) -> None:
+        """Roll back and clear session state before reuse, as asyncpg's own pool does"""
+        if connection.is_closed():
+            raise ConnectionError("connection is closed")
+        await connection.reset()
@@ -6,7 +6,7 @@ import sqlite3
 import json
 import os
 import asyncio
-from typing import List, Dict, Any, AsyncGenerator, Type, Optional, Tuple, Union
+from typing import List, Dict, Any, AsyncGenerator, AsyncIterator, Type, Optional, Tuple, Union
 from contextlib import asynccontextmanager
 from datetime import datetime
 import logging
@@ -14,6 +14,8 @@ import threading
 from decimal import Decimal
 
 from ...config import DatabaseConfig
+from .. import bulk
+from ..query_plan import PlanCache, SQLITE
 from ...utils.types import Field, StringField, IntegerField, BooleanField, DateTimeField, FieldType
 
 logger = logging.getLogger(__name__)
@@ -22,13 +24,17 @@ logger = logging.getLogger(__name__)
 class SQLiteConnection:
     """SQLite database connection"""
 
+    # Compiled statements sqlite3 keeps per connection
+    cached_statements = 512
+
     def __init__(self, config: DatabaseConfig):
         self.config = config
         self.connection = None
+        self.plan_cache = PlanCache(SQLITE)
 
     async def connect(self) -> None:
         """Connect to the database"""
-        self.connection = sqlite3.connect(self.config.database)
+        self.connection = sqlite3.connect(self.config.database, cached_statements=self.cached_statements)
         self.connection.row_factory = sqlite3.Row
         self.connection.execute("PRAGMA foreign_keys = ON")
 
@@ -82,7 +88,7 @@ class SQLiteConnection:
     async def _create_connection(self) -> Any:
         """Create a new SQLite connection for pooling"""
         import sqlite3
-        conn = sqlite3.connect(self.config.database)
+        conn = sqlite3.connect(self.config.database, cached_statements=self.cached_statements)
         conn.row_factory = sqlite3.Row
         conn.execute("PRAGMA foreign_keys = ON")
         return conn
@@ -151,6 +157,81 @@ class SQLiteConnection:
         self.connection.commit()
         return cursor.lastrowid
 
+    async def insert_many(self, model_class: Type, rows: bulk.Rows, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert in a single transaction with executemany.
+
+        Returns:
+            Number of rows written
+        """
+        table = model_class.get_table_name()
+
+        def statement(columns):
+            return f"INSERT INTO {table} ({', '.join(columns)}) VALUES ({', '.join(['?'] * len(columns))})"
+
+        return await self._executemany_chunks(rows, statement, None, batch_size, rate_limit)
+
+    async def upsert_many(self, model_class: Type, rows: bulk.Rows, conflict_fields: List[str],
+                          update_fields: Optional[List[str]] = None, batch_size: Optional[int] = None,
+                          rate_limit: Optional[float] = None) -> int:
+        """
+        Bulk insert-or-update with INSERT ... ON CONFLICT, in a single transaction.
+
+        Args:
+            conflict_fields: Columns of the unique constraint to match on
+            update_fields: Columns to overwrite on conflict (default: all others);
+                an empty list means DO NOTHING
+
+        Returns:
+            Number of rows written
+        """
+        table = model_class.get_table_name()
+
+        def statement(columns):
+            updates = [c for c in columns if c not in conflict_fields] if update_fields is None else update_fields
+            action = (f"DO UPDATE SET {', '.join(f'{c} = excluded.{c}' for c in updates)}"
+                      if updates else "DO NOTHING")
+            return (f"INSERT INTO {table} ({', '.join(columns)}) VALUES ({', '.join(['?'] * len(columns))}) "
+                    f"ON CONFLICT ({', '.join(conflict_fields)}) {action}")
+
+        return await self._executemany_chunks(rows, statement, None, batch_size, rate_limit)
+
+    async def update_many(self, model_class: Type, rows: bulk.Rows, key_fields: List[str] = ('id',),
+                          batch_size: Optional[int] = None, rate_limit: Optional[float] = None) -> int:
+        """
+        Update many rows, each matched by its key_fields, in a single transaction.
+
+        Returns:
+            Number of rows changed
+        """
+        table = model_class.get_table_name()
+
+        def statement(columns):
+            set_clause = ', '.join(f"{c} = ?" for c in columns)
+            where_clause = ' AND '.join(f"{k} = ?" for k in key_fields)
+            return f"UPDATE {table} SET {set_clause} WHERE {where_clause}"
+
+        return await self._executemany_chunks(rows, statement, key_fields, batch_size, rate_limit)
+
+    async def _executemany_chunks(self, rows: bulk.Rows, statement, key_fields: Optional[List[str]],
+                                  batch_size: Optional[int], rate_limit: Optional[float]) -> int:
+        if not self.connection:
+            await self.connect()
+        written = 0
+        # One transaction for the whole load: commits once, rolls back on error
+        with self.connection:
+            async for chunk in bulk.chunked(rows, None, batch_size, rate_limit):
+                columns = bulk.columns_of(chunk)
+                if key_fields:
+                    columns = tuple(c for c in columns if c not in key_fields)
+                    params = bulk.as_tuples(chunk, columns + tuple(key_fields))
+                else:
+                    params = bulk.as_tuples(chunk, columns)
+                cursor = self.connection.executemany(statement(columns), params)
+                written += cursor.rowcount
+        return written
+
     async def update_one(self, model_class: Type, filters: Dict[str, Any], data: Dict[str, Any]) -> bool:
         """Update a single record"""
         set_clause = ', '.join([f"{k} = {self.get_param_placeholder(i+1)}" for i, k in enumerate(data.keys())])
@@ -524,96 +605,37 @@ class SQLiteConnection:
 
     async def execute_query_builder(self, model_class: Type, query_params: Dict[str, Any]) -> List[Dict[str, Any]]:
         """Execute a complex query built by QueryBuilder for SQLite"""
-        # Extract query parameters
-        select_fields = query_params.get('select_fields', [])
-        distinct = query_params.get('distinct', False)
-        filters = query_params.get('filters', {})
-        limit = query_params.get('limit')
-        offset = query_params.get('offset')
-        order_by = query_params.get('order_by', [])
-        group_by = query_params.get('group_by', [])
-        having = query_params.get('having', [])
-
-        # Build SELECT clause
-        select_clause = "SELECT "
-        if distinct:
-            select_clause += "DISTINCT "
-        if select_fields:
-            select_clause += ', '.join(select_fields)
-        else:
-            select_clause += '*'
-
-        # Build FROM clause
-        from_clause = f"FROM {model_class.get_table_name()}"
-
-        # Build WHERE clause
-        where_clause = ""
-        params = []
-        if filters:
-            conditions = []
-            for key, value in filters.items():
-                if isinstance(value, dict):
-                    # Handle MongoDB-style operators
-                    for op, val in value.items():
-                        if op == '$gt':
-                            conditions.append(f"{key} > ?")
-                            params.append(val)
-                        elif op == '$lt':
-                            conditions.append(f"{key} < ?")
-                            params.append(val)
-                        elif op == '$gte':
-                            conditions.append(f"{key} >= ?")
-                            params.append(val)
-                        elif op == '$lte':
-                            conditions.append(f"{key} <= ?")
-                            params.append(val)
-                        elif op == '$ne':
-                            conditions.append(f"{key} != ?")
-                            params.append(val)
-                        elif op == '$in':
-                            placeholders = ', '.join(['?' for _ in val])
-                            conditions.append(f"{key} IN ({placeholders})")
-                            params.extend(val)
-                        elif op == '$regex':
-                            conditions.append(f"{key} LIKE ?")
-                            params.append(val.replace('.*', '%'))
-                else:
-                    conditions.append(f"{key} = ?")
-                    params.append(value)
-            if conditions:
-                where_clause = f"WHERE {' AND '.join(conditions)}"
-
-        # Build GROUP BY clause
-        group_clause = ""
-        if group_by:
-            group_clause = f"GROUP BY {', '.join(group_by)}"
-
-        # Build HAVING clause
-        having_clause = ""
-        if having:
-            having_conditions = []
-            for condition in having:
-                # Simple parsing - in practice, you'd need more sophisticated parsing
-                having_conditions.append(condition)
-            if having_conditions:
-                having_clause = f"HAVING {' AND '.join(having_conditions)}"
-
-        # Build ORDER BY clause
-        order_clause = ""
-        if order_by:
-            order_parts = []
-            for field, direction in order_by:
-                order_parts.append(f"{field} {'DESC' if direction == -1 else 'ASC'}")
-            order_clause = f"ORDER BY {', '.join(order_parts)}"
-
-        # Build LIMIT and OFFSET clauses
-        limit_clause = f"LIMIT {limit}" if limit else ""
-        offset_clause = f"OFFSET {offset}" if offset else ""
+        plan, params = self.plan_cache.prepare(query_params, model_class.get_table_name())
 
-        # Combine all parts
-        query = f"{select_clause} {from_clause} {where_clause} {group_clause} {having_clause} {order_clause} {limit_clause} {offset_clause}".strip()
-
-        # Execute query
-        cursor = await self.execute_query(query, tuple(params) if params else None)
+        # sqlite3 reuses the compiled statement from its per-connection cache
+        cursor = await self.execute_query(plan.sql, tuple(params) if params else None)
         rows = cursor.fetchall()
         return [dict(row) for row in rows]
+
+    async def iter_query_builder(self, model_class: Type, query_params: Dict[str, Any],
+                                 batch_size: int = 1000) -> AsyncIterator[Tuple[Tuple[str, ...], List[tuple]]]:
+        """
+        Stream a QueryBuilder query in batches of plain tuples.
+
+        Yields:
+            (column names, rows as tuples) for up to batch_size rows at a time
+        """
+        plan, params = self.plan_cache.prepare(query_params, model_class.get_table_name())
+
+        cursor = self.connection.cursor()
+        # Plain tuples instead of sqlite3.Row objects
+        cursor.row_factory = None
+        try:
+            cursor.execute(plan.sql, tuple(params))
+            columns = tuple(column[0] for column in cursor.description)
+            while True:
+                rows = cursor.fetchmany(batch_size)
+                if not rows:
+                    break
+                yield columns, rows
+        finally:
+            cursor.close()
+
+    def get_plan_cache_stats(self) -> Dict[str, Any]:
+        """Get QueryBuilder plan cache statistics"""
+        return self.plan_cache.get_stats()
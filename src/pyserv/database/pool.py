@@ -0,0 +1,635 @@
+"""
+Connection pool engine shared by the Pyserv database backends.
+
+A backend hands the pool three hooks: ``create`` to open a driver
+connection, ``close`` to close one, and optionally ``validate`` (a cheap
+liveness query) and ``reset`` (run when a connection comes back, e.g. to
+roll back a transaction left open). The pool then provides:
+
+- FIFO fairness: callers that have to wait are served strictly in arrival
+  order. A released connection goes straight to the oldest waiter, so a
+  late arrival can never barge past it.
+- Acquire timeouts that raise ``PoolTimeoutError``.
+- Adaptive sizing. The pool keeps a soft target size between ``min_size``
+  and ``max_size``. When a waiter has been queued longer than
+  ``target_wait``, the target grows by one. Every maintenance cycle the
+  pool also looks at the p95 of recent acquire waits: if it is above
+  ``target_wait`` the target grows by a quarter, and if connections sat
+  idle through the whole cycle the target shrinks towards ``min_size``.
+- A background maintenance loop. It closes connections past
+  ``max_lifetime``, or idle longer than ``max_idle_time`` above
+  ``min_size``. It validates the remaining idle connections and refills
+  the pool to ``min_size``.
+- Metrics in constant memory: a fixed-bucket acquire latency histogram, a
+  ring of recent waits for percentiles, and in-use, idle and waiter gauges.
+
+``acquire()`` works like the asyncpg and aiomysql pool method of the same
+name, so backend code written against a driver pool keeps working::
+
+    async with self.pool.acquire() as connection:
+        await connection.fetch(query)
+"""
+
+import asyncio
+import inspect
+import logging
+import math
+import time
+from array import array
+from bisect import bisect_left
+from collections import deque
+from dataclasses import dataclass, field
+from typing import Any, Awaitable, Callable, Deque, Dict, List, Optional
+
+logger = logging.getLogger(__name__)
+
+# Upper bounds (seconds) of the acquire latency histogram buckets
+ACQUIRE_BUCKETS = (0.0001, 0.0005, 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0)
+
+# Recent acquire waits kept for percentiles
+WAIT_WINDOW = 1024
+
+
+@dataclass
+class PoolConfig:
+    """Configuration for database connection pool"""
+    min_size: int = 5
+    max_size: int = 20
+    max_idle_time: int = 300  # seconds
+    max_lifetime: int = 3600  # seconds
+    acquire_timeout: int = 30  # seconds
+    retry_attempts: int = 3
+    retry_delay: float = 0.1  # seconds
+    health_check_interval: int = 60  # seconds
+    prepared_statement_cache_size: int = 100
+    target_wait: float = 0.01  # seconds; waits above this grow the pool
+    validate_timeout: float = 5.0  # seconds
+
+
+@dataclass
+class ConnectionStats:
+    """Connection pool statistics"""
+    total_connections: int = 0
+    active_connections: int = 0
+    idle_connections: int = 0
+    pending_acquires: int = 0
+    total_acquires: int = 0
+    total_releases: int = 0
+    total_timeouts: int = 0
+    total_errors: int = 0
+    created_at: float = field(default_factory=time.time)
+    target_size: int = 0
+    total_created: int = 0
+    total_recycled: int = 0
+    total_validation_failures: int = 0
+    acquire_wait_p50: float = 0.0
+    acquire_wait_p95: float = 0.0
+    acquire_wait_p99: float = 0.0
+
+
+class PoolTimeoutError(asyncio.TimeoutError):
+    """No connection became available within the acquire timeout"""
+
+
+async def _maybe_await(result: Any) -> Any:
+    if inspect.isawaitable(result):
+        return await result
+    return result
+
+
+class PoolConnection:
+    """Wrapper for pooled database connections"""
+
+    def __init__(self, connection: Any, pool: Any, created_at: float):
+        self.connection = connection
+        self.pool = pool
+        self.created_at = created_at
+        self.last_used = created_at
+        self.in_use = False
+        self.prepared_statements: Dict[str, Any] = {}
+
+    async def execute(self, query: str, params: tuple = None) -> Any:
+        """Execute query with connection"""
+        self.last_used = time.time()
+        try:
+            if hasattr(self.connection, 'execute'):
+                return await self.connection.execute(query, params or ())
+            else:
+                # MongoDB style
+                return await self.connection.command(query, params or {})
+        except Exception as e:
+            self.pool._stats.total_errors += 1
+            raise e
+
+    async def execute_raw(self, query: str, params: tuple = None) -> Any:
+        """Execute raw query with cursor access"""
+        self.last_used = time.time()
+        try:
+            if hasattr(self.connection, 'execute_raw'):
+                return await self.connection.execute_raw(query, params or ())
+            else:
+                # Fallback to regular execute for backends without raw support
+                return await self.execute(query, params)
+        except Exception as e:
+            self.pool._stats.total_errors += 1
+            raise e
+
+    async def get_cursor(self) -> Any:
+        """Get raw database cursor (Django-style API)"""
+        self.last_used = time.time()
+        try:
+            if hasattr(self.connection, 'cursor'):
+                return self.connection.cursor()
+            else:
+                # For backends without direct cursor access
+                raise NotImplementedError("Direct cursor access not available for this backend")
+        except Exception as e:
+            self.pool._stats.total_errors += 1
+            raise e
+
+    async def begin_transaction(self) -> Any:
+        """Begin transaction with connection"""
+        self.last_used = time.time()
+        try:
+            if hasattr(self.connection, 'begin_transaction'):
+                return await self.connection.begin_transaction()
+            else:
+                raise NotImplementedError("Transaction support not available for this backend")
+        except Exception as e:
+            self.pool._stats.total_errors += 1
+            raise e
+
+    async def commit_transaction(self, transaction: Any) -> None:
+        """Commit transaction"""
+        try:
+            if hasattr(self.connection, 'commit_transaction'):
+                await self.connection.commit_transaction(transaction)
+            else:
+                raise NotImplementedError("Transaction support not available for this backend")
+        except Exception as e:
+            self.pool._stats.total_errors += 1
+            raise e
+
+    async def rollback_transaction(self, transaction: Any) -> None:
+        """Rollback transaction"""
+        try:
+            if hasattr(self.connection, 'rollback_transaction'):
+                await self.connection.rollback_transaction(transaction)
+            else:
+                raise NotImplementedError("Transaction support not available for this backend")
+        except Exception as e:
+            self.pool._stats.total_errors += 1
+            raise e
+
+    async def execute_in_transaction(self, query: str, params: tuple = None) -> Any:
+        """Execute query within transaction context"""
+        self.last_used = time.time()
+        try:
+            if hasattr(self.connection, 'execute_in_transaction'):
+                return await self.connection.execute_in_transaction(query, params or ())
+            else:
+                # Fallback to manual transaction handling
+                transaction = await self.begin_transaction()
+                try:
+                    result = await self.execute(query, params)
+                    await self.commit_transaction(transaction)
+                    return result
+                except Exception:
+                    await self.rollback_transaction(transaction)
+                    raise
+        except Exception as e:
+            self.pool._stats.total_errors += 1
+            raise e
+
+    async def close(self):
+        """Close the connection"""
+        if hasattr(self.connection, 'close'):
+            await _maybe_await(self.connection.close())
+
+    def is_expired(self, max_lifetime: int) -> bool:
+        """Check if connection has expired"""
+        return (time.time() - self.created_at) > max_lifetime
+
+    def is_idle_timeout(self, max_idle_time: int) -> bool:
+        """Check if connection has been idle too long"""
+        return (time.time() - self.last_used) > max_idle_time
+
+
+class _AcquireContext:
+    """``async with pool.acquire()`` yields the raw driver connection."""
+
+    __slots__ = ('_pool', '_timeout', '_entry')
+
+    def __init__(self, pool: 'ConnectionPool', timeout: Optional[float]):
+        self._pool = pool
+        self._timeout = timeout
+        self._entry: Optional[PoolConnection] = None
+
+    async def __aenter__(self) -> Any:
+        self._entry = await self._pool.checkout(self._timeout)
+        return self._entry.connection
+
+    async def __aexit__(self, exc_type, exc_val, exc_tb) -> None:
+        entry, self._entry = self._entry, None
+        await self._pool.checkin(entry)
+
+    def __await__(self):
+        return self._pool.checkout(self._timeout).__await__()
+
+
+class ConnectionPool:
+    """
+    Fair, adaptive pool of driver connections.
+
+    Args:
+        create: Coroutine function opening a new driver connection
+        close: Closes a driver connection (sync or async); defaults to ``close()``
+        validate: Liveness check; raising or returning False discards the connection
+        reset: Run on check-in; raising discards the connection
+        config: Sizing, timeouts and recycling policy
+        name: Label for metrics and logs
+    """
+
+    def __init__(self, create: Callable[[], Awaitable[Any]], close: Optional[Callable[[Any], Any]] = None,
+                 validate: Optional[Callable[[Any], Any]] = None, reset: Optional[Callable[[Any], Any]] = None,
+                 config: Optional[PoolConfig] = None, name: str = 'default'):
+        self.config = config or PoolConfig()
+        if self.config.max_size < 1 or self.config.min_size > self.config.max_size:
+            raise ValueError("PoolConfig requires 1 <= max_size and min_size <= max_size")
+        self.name = name
+        self._create = create
+        self._close = close
+        self._validate = validate
+        self._reset = reset
+
+        self._idle: Deque[PoolConnection] = deque()
+        self._waiters: Deque[asyncio.Future] = deque()
+        self._size = 0  # open connections plus those being opened
+        self._opening = 0
+        self._in_use = 0
+        self._target = max(self.config.min_size, 1)
+        self._closed = False
+        self._maintenance_task: Optional[asyncio.Task] = None
+        self._open_tasks: set = set()
+        # Fewest idle connections, and acquires counted, since the last maintenance cycle
+        self._idle_low_water: Optional[int] = None
+        self._cycle_wait_count = 0
+
+        self._stats = ConnectionStats()
+        self._bucket_counts = array('Q', [0] * (len(ACQUIRE_BUCKETS) + 1))
+        self._wait_sum = 0.0
+        self._waits = array('d', [0.0] * WAIT_WINDOW)
+        self._wait_index = 0
+        self._wait_count = 0
+
+    # Lifecycle
+
+    async def start(self) -> 'ConnectionPool':
+        """Open ``min_size`` connections and start background maintenance."""
+        await self._fill(self.config.min_size)
+        self.start_maintenance()
+        return self
+
+    def start_maintenance(self) -> None:
+        if self._maintenance_task is None and self.config.health_check_interval > 0:
+            self._maintenance_task = asyncio.create_task(self._maintenance_loop())
+
+    async def stop_maintenance(self) -> None:
+        if self._maintenance_task:
+            self._maintenance_task.cancel()
+            try:
+                await self._maintenance_task
+            except asyncio.CancelledError:
+                pass
+            self._maintenance_task = None
+
+    async def close(self) -> None:
+        """Close idle connections, fail waiters; in-use ones close on check-in."""
+        self._closed = True
+        await self.stop_maintenance()
+        for task in list(self._open_tasks):
+            task.cancel()
+        while self._waiters:
+            waiter = self._waiters.popleft()
+            if not waiter.done():
+                waiter.set_exception(RuntimeError(f"Connection pool {self.name!r} is closed"))
+        while self._idle:
+            await self._discard(self._idle.popleft())
+
+    # Acquire / release
+
+    def acquire(self, timeout: Optional[float] = None) -> _AcquireContext:
+        """Check out a connection: ``async with`` yields it and checks it back in."""
+        return _AcquireContext(self, timeout)
+
+    async def checkout(self, timeout: Optional[float] = None) -> PoolConnection:
+        """Take a connection, waiting in FIFO order if none is idle."""
+        if self._closed:
+            raise RuntimeError(f"Connection pool {self.name!r} is closed")
+        if self._idle and not self._waiters:
+            entry = self._idle.pop()
+            self._mark_checked_out(entry)
+            self._record_wait(0.0)
+            return entry
+
+        timeout = self.config.acquire_timeout if timeout is None else timeout
+        loop = asyncio.get_running_loop()
+        started = loop.time()
+        waiter = loop.create_future()
+        self._waiters.append(waiter)
+        self._stats.pending_acquires += 1
+        self._grow_for_waiters()
+        try:
+            target_wait = self.config.target_wait
+            if target_wait and target_wait < timeout:
+                try:
+                    return await asyncio.wait_for(asyncio.shield(waiter), target_wait)
+                except asyncio.TimeoutError:
+                    # Queued too long: raise the soft size so another connection opens
+                    if self._target < self.config.max_size:
+                        self._target += 1
+                        self._grow_for_waiters()
+            remaining = max(0.0, timeout - (loop.time() - started))
+            return await asyncio.wait_for(waiter, remaining)
+        except asyncio.TimeoutError:
+            self._stats.total_timeouts += 1
+            self._record_wait(loop.time() - started)
+            raise PoolTimeoutError(
+                f"Timed out after {timeout}s acquiring a connection from pool {self.name!r} "
+                f"({self._in_use} in use, {len(self._waiters)} waiting)"
+            ) from None
+        except BaseException:
+            # Cancelled after a connection was handed over: give it back
+            if waiter.done() and not waiter.cancelled() and waiter.exception() is None:
+                await self.checkin(waiter.result())
+            raise
+        finally:
+            self._stats.pending_acquires -= 1
+            if not waiter.done():
+                waiter.cancel()
+            try:
+                self._waiters.remove(waiter)
+            except ValueError:
+                pass
+            if waiter.done() and not waiter.cancelled() and waiter.exception() is None:
+                self._record_wait(loop.time() - started)
+
+    async def checkin(self, entry: PoolConnection, discard: bool = False) -> None:
+        """Return a connection; ``discard=True`` closes it instead (e.g. it is broken)."""
+        if not entry.in_use:
+            return
+        entry.in_use = False
+        entry.last_used = time.time()
+        self._in_use -= 1
+        self._stats.total_releases += 1
+
+        if not discard and self._reset is not None:
+            try:
+                await _maybe_await(self._reset(entry.connection))
+            except Exception as e:
+                logger.warning(f"Discarding connection from pool {self.name!r} after failed reset: {e}")
+                discard = True
+
+        if discard or self._closed or entry.is_expired(self.config.max_lifetime):
+            if not discard and not self._closed:
+                self._stats.total_recycled += 1
+            await self._discard(entry)
+            self._grow_for_waiters()
+            return
+
+        if self._size > self._target and not self._waiters:
+            # Pool shrank while this one was out
+            await self._discard(entry)
+            return
+
+        self._hand_over(entry)
+
+    # Internals
+
+    def _mark_checked_out(self, entry: PoolConnection) -> None:
+        entry.in_use = True
+        entry.last_used = time.time()
+        self._in_use += 1
+        self._stats.total_acquires += 1
+        idle = len(self._idle)
+        if self._idle_low_water is None or idle < self._idle_low_water:
+            self._idle_low_water = idle
+
+    def _hand_over(self, entry: PoolConnection) -> None:
+        """Give a connection to the oldest live waiter, else make it idle."""
+        while self._waiters:
+            waiter = self._waiters.popleft()
+            if not waiter.done():
+                self._mark_checked_out(entry)
+                waiter.set_result(entry)
+                return
+        self._idle.append(entry)
+
+    def _grow_for_waiters(self) -> None:
+        """Open connections for waiters not already covered by one being opened."""
+        if self._closed:
+            return
+        uncovered = len(self._waiters) - self._opening
+        while uncovered > 0 and self._size < self._target:
+            self._spawn_open()
+            uncovered -= 1
+
+    def _spawn_open(self) -> None:
+        self._size += 1
+        self._opening += 1
+        task = asyncio.create_task(self._open_for_waiter())
+        self._open_tasks.add(task)
+        task.add_done_callback(self._open_tasks.discard)
+
+    async def _open_for_waiter(self) -> None:
+        try:
+            entry = await self._open()
+        except asyncio.CancelledError:
+            self._size -= 1
+            raise
+        except Exception as e:
+            self._size -= 1
+            self._stats.total_errors += 1
+            logger.error(f"Failed to open connection for pool {self.name!r}: {e}")
+            # Fail the oldest waiter fast rather than letting it run into the timeout
+            while self._waiters:
+                waiter = self._waiters.popleft()
+                if not waiter.done():
+                    waiter.set_exception(e)
+                    break
+            return
+        finally:
+            self._opening -= 1
+        if self._closed:
+            await self._discard(entry)
+        else:
+            self._hand_over(entry)
+
+    async def _open(self) -> PoolConnection:
+        connection = await self._create()
+        self._stats.total_created += 1
+        return PoolConnection(connection, self, time.time())
+
+    async def _fill(self, size: int) -> None:
+        """Open idle connections until the pool holds ``size``."""
+        missing = size - self._size
+        if missing <= 0 or self._closed:
+            return
+        self._size += missing
+        results = await asyncio.gather(*(self._open() for _ in range(missing)), return_exceptions=True)
+        for result in results:
+            if isinstance(result, BaseException):
+                self._size -= 1
+                self._stats.total_errors += 1
+                logger.error(f"Failed to open connection for pool {self.name!r}: {result}")
+            else:
+                self._hand_over(result)
+
+    async def _discard(self, entry: PoolConnection) -> None:
+        self._size -= 1
+        try:
+            if self._close is not None:
+                await _maybe_await(self._close(entry.connection))
+            else:
+                await entry.close()
+        except Exception as e:
+            logger.debug(f"Error closing connection from pool {self.name!r}: {e}")
+
+    def _record_wait(self, seconds: float) -> None:
+        self._bucket_counts[bisect_left(ACQUIRE_BUCKETS, seconds)] += 1
+        self._wait_sum += seconds
+        self._waits[self._wait_index] = seconds
+        self._wait_index = (self._wait_index + 1) % WAIT_WINDOW
+        self._wait_count += 1
+
+    def wait_percentiles(self, *quantiles: float, last: Optional[int] = None) -> List[float]:
+        """Acquire-wait quantiles over the last ``last`` (at most ``WAIT_WINDOW``) acquires."""
+        filled = min(self._wait_count, WAIT_WINDOW if last is None else last, WAIT_WINDOW)
+        if filled <= 0:
+            return [0.0 for _ in quantiles]
+        end = self._wait_index
+        if filled <= end:
+            recent = self._waits[end - filled:end]
+        else:
+            recent = self._waits[end - filled:] + self._waits[:end]
+        window = sorted(recent)
+        return [window[min(filled - 1, int(q * filled))] for q in quantiles]
+
+    async def _maintenance_loop(self) -> None:
+        while True:
+            try:
+                await asyncio.sleep(self.config.health_check_interval)
+                await self.run_maintenance()
+            except asyncio.CancelledError:
+                break
+            except Exception as e:
+                logger.error(f"Pool {self.name!r} maintenance error: {e}")
+
+    async def run_maintenance(self) -> None:
+        """One maintenance cycle: recycle, validate, resize, refill."""
+        config = self.config
+
+        # Recycle: expired always, idle-timed-out only above min_size
+        keep: Deque[PoolConnection] = deque()
+        while self._idle:
+            entry = self._idle.popleft()
+            if entry.is_expired(config.max_lifetime) or (
+                    entry.is_idle_timeout(config.max_idle_time) and self._size > config.min_size):
+                self._stats.total_recycled += 1
+                await self._discard(entry)
+            else:
+                keep.append(entry)
+
+        # Validate the rest while they are out of circulation
+        if self._validate is not None:
+            for entry in list(keep):
+                try:
+                    ok = await asyncio.wait_for(_maybe_await(self._validate(entry.connection)),
+                                                config.validate_timeout)
+                except Exception:
+                    ok = False
+                if ok is False:
+                    self._stats.total_validation_failures += 1
+                    keep.remove(entry)
+                    await self._discard(entry)
+        for entry in keep:
+            self._hand_over(entry)
+
+        # Adapt the target size to the waits and idleness seen during this cycle
+        p95, = self.wait_percentiles(0.95, last=self._wait_count - self._cycle_wait_count)
+        idle_low_water = len(self._idle) if self._idle_low_water is None else self._idle_low_water
+        if p95 > config.target_wait and self._target < config.max_size:
+            self._target = min(config.max_size, self._target + max(1, math.ceil(self._target / 4)))
+        elif idle_low_water and self._target > config.min_size:
+            self._target = max(config.min_size, 1, self._target - max(1, idle_low_water // 2))
+        self._idle_low_water = None
+        self._cycle_wait_count = self._wait_count
+        while self._size > self._target and self._idle:
+            await self._discard(self._idle.popleft())
+
+        await self._fill(config.min_size)
+        self._grow_for_waiters()
+
+    # Introspection
+
+    @property
+    def size(self) -> int:
+        return self._size
+
+    @property
+    def target_size(self) -> int:
+        return self._target
+
+    def get_stats(self) -> ConnectionStats:
+        """Snapshot of pool statistics"""
+        stats = self._stats
+        stats.total_connections = self._size
+        stats.active_connections = self._in_use
+        stats.idle_connections = len(self._idle)
+        stats.target_size = self._target
+        stats.acquire_wait_p50, stats.acquire_wait_p95, stats.acquire_wait_p99 = \
+            self.wait_percentiles(0.5, 0.95, 0.99)
+        return stats
+
+    def collect_metrics(self) -> List[Any]:
+        """Pool metrics as ``MetricValue`` records for ``MetricsCollector.add_collector``."""
+        from pyserv.monitoring.metrics import MetricValue
+
+        stats = self.get_stats()
+        now = time.time()
+        labels = {'pool': self.name}
+
+        def value(name, amount, metric_type='gauge', **extra):
+            return MetricValue(name=name, value=amount, timestamp=now,
+                               labels={**labels, **extra}, metric_type=metric_type)
+
+        values = [
+            value('db_pool_connections', stats.active_connections, state='in_use'),
+            value('db_pool_connections', stats.idle_connections, state='idle'),
+            value('db_pool_waiters', len(self._waiters)),
+            value('db_pool_target_size', self._target),
+            value('db_pool_max_size', self.config.max_size),
+            value('db_pool_acquires_total', stats.total_acquires, 'counter'),
+            value('db_pool_timeouts_total', stats.total_timeouts, 'counter'),
+            value('db_pool_errors_total', stats.total_errors, 'counter'),
+            value('db_pool_recycled_total', stats.total_recycled, 'counter'),
+        ]
+        cumulative = 0
+        for bound, count in zip(ACQUIRE_BUCKETS + (math.inf,), self._bucket_counts):
+            cumulative += count
+            le = '+Inf' if bound == math.inf else str(bound)
+            values.append(value('db_pool_acquire_seconds_bucket', cumulative, 'histogram', le=le))
+        values.append(value('db_pool_acquire_seconds_sum', self._wait_sum, 'histogram'))
+        values.append(value('db_pool_acquire_seconds_count', cumulative, 'histogram'))
+        return values
+
+    def register_metrics(self, collector: Any = None) -> None:
+        """Export this pool's metrics through a ``MetricsCollector`` (default: the global one)."""
+        if collector is None:
+            from pyserv.monitoring.metrics import get_metrics_collector
+            collector = get_metrics_collector()
+        collector.add_collector(self.collect_metrics)
+
+
+__all__ = ['ACQUIRE_BUCKETS', 'ConnectionPool', 'ConnectionStats', 'PoolConfig', 'PoolConnection',
+           'PoolTimeoutError']
@@ -0,0 +1,284 @@
+"""
+Compiled, cached SQL plans for QueryBuilder queries.
+
+``execute_query_builder`` used to rebuild the SQL string from the query
+parameters on every call. Here the parameters are reduced to a *shape*:
+selected columns, the filter fields with their operators, ordering,
+grouping, and whether a limit or offset is present. The values are left
+out. Each shape is compiled once per dialect into a ``CompiledPlan``
+holding the SQL text and a recipe for pulling the bind parameters out of
+the query parameters. LIMIT and OFFSET are bound as parameters too, so
+pages of the same list query share one plan.
+
+Stable SQL text is also what lets drivers reuse server-side prepared
+statements: asyncpg keeps a per-connection prepared-statement LRU keyed
+by query text, and sqlite3 keeps a per-connection statement cache.
+
+IN lists are value-dependent in length. PostgreSQL binds them as one
+array parameter (``= ANY($n)``). The other dialects pad the list to the
+next power of two by repeating its last value, so at most a handful of
+shapes exist for each IN filter.
+
+HAVING conditions are raw SQL whose parameters are written as ``?``; they
+are renumbered into the dialect's placeholders and bound between the
+WHERE values and LIMIT/OFFSET, in the order they appear in the SQL.
+"""
+
+import re
+from collections import OrderedDict
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+_COMPARISONS = {'$gt': '>', '$lt': '<', '$gte': '>=', '$lte': '<=', '$ne': '!='}
+
+# A quoted string literal (kept as is) or a bare ? placeholder
+_HAVING_TOKEN = re.compile(r"'(?:[^']|'')*'|\?")
+
+
+class Dialect:
+    """Placeholder and operator syntax of one SQL backend."""
+
+    def __init__(self, name: str, placeholder: Callable[[int], str], array_in: bool = False,
+                 regex_operator: Optional[str] = None, offset_only_limit: Optional[str] = None):
+        self.name = name
+        self.placeholder = placeholder
+        self.array_in = array_in
+        # None means regexes are translated to LIKE patterns
+        self.regex_operator = regex_operator
+        # LIMIT value to use when only OFFSET is given, for dialects that require LIMIT
+        self.offset_only_limit = offset_only_limit
+
+
+POSTGRESQL = Dialect('postgresql', lambda index: f"${index}", array_in=True, regex_operator='~')
+MYSQL = Dialect('mysql', lambda index: '%s', offset_only_limit='18446744073709551615')
+SQLITE = Dialect('sqlite', lambda index: '?', offset_only_limit='-1')
+
+
+def _bucket(size: int) -> int:
+    """Round an IN-list length up to a power of two."""
+    bucket = 1
+    while bucket < size:
+        bucket <<= 1
+    return bucket
+
+
+def _is_descending(direction: Any) -> bool:
+    return direction == -1 or (isinstance(direction, str) and direction.upper() == 'DESC')
+
+
+def _value_shape(value: Any, array_in: bool) -> Any:
+    """Shape of one filter value: its operators, never its data."""
+    if value is None:
+        return 'null'
+    if not isinstance(value, dict):
+        return 'eq'
+    shape = []
+    for op, val in value.items():
+        if op == '$in':
+            size = len(val)
+            shape.append((op, 'array' if array_in and size else (_bucket(size) if size else 0)))
+        elif op == '$ne' and val is None:
+            shape.append(('$ne', 'null'))
+        elif op == '$regex':
+            case_insensitive = 'i' in value.get('$options', '')
+            shape.append((op, case_insensitive))
+        elif op in _COMPARISONS:
+            shape.append((op, None))
+    return tuple(shape)
+
+
+def query_shape(query_params: Dict[str, Any], dialect: Dialect) -> tuple:
+    """
+    Compute the plan-cache key for a QueryBuilder query.
+
+    Two queries with the same key differ only in bound values.
+    """
+    filters = query_params.get('filters') or {}
+    return (
+        query_params.get('table_name'),
+        tuple(query_params.get('select_fields') or ()),
+        bool(query_params.get('distinct')),
+        tuple((key, _value_shape(value, dialect.array_in)) for key, value in filters.items()),
+        tuple((field, _is_descending(direction)) for field, direction in query_params.get('order_by') or ()),
+        tuple(query_params.get('group_by') or ()),
+        tuple(query_params.get('having') or ()),
+        query_params.get('limit') is not None,
+        query_params.get('offset') is not None,
+    )
+
+
+class CompiledPlan:
+    """SQL text for one query shape plus how to bind its parameters."""
+
+    __slots__ = ('sql', '_steps', '_limit', '_offset', 'uses')
+
+    def __init__(self, sql: str, steps: List[Tuple[str, Optional[str], Any]], limit: bool, offset: bool):
+        self.sql = sql
+        self._steps = steps
+        self._limit = limit
+        self._offset = offset
+        self.uses = 0
+
+    def bind(self, query_params: Dict[str, Any]) -> List[Any]:
+        """Extract bind parameters, in placeholder order, from query parameters."""
+        filters = query_params.get('filters') or {}
+        params: List[Any] = []
+        for key, op, arg in self._steps:
+            value = filters[key]
+            if op is None:
+                params.append(value)
+                continue
+            value = value[op]
+            if op == '$in':
+                if arg == 'array':
+                    params.append(list(value))
+                else:
+                    values = list(value)
+                    params.extend(values)
+                    params.extend([values[-1]] * (arg - len(values)))
+            elif op == '$regex' and arg == 'like':
+                params.append(value.replace('.*', '%'))
+            else:
+                params.append(value)
+        params.extend(query_params.get('having_params') or ())
+        if self._limit:
+            params.append(query_params['limit'])
+        if self._offset:
+            params.append(query_params['offset'])
+        return params
+
+
+def compile_plan(query_params: Dict[str, Any], dialect: Dialect, table_name: str) -> CompiledPlan:
+    """Build the SQL and bind recipe for the shape of ``query_params``."""
+    steps: List[Tuple[str, Optional[str], Any]] = []
+    counter = [0]
+
+    def placeholder() -> str:
+        counter[0] += 1
+        return dialect.placeholder(counter[0])
+
+    select_fields = query_params.get('select_fields') or []
+    parts = ["SELECT DISTINCT" if query_params.get('distinct') else "SELECT",
+             ', '.join(select_fields) if select_fields else '*',
+             f"FROM {table_name}"]
+
+    conditions = []
+    for key, value in (query_params.get('filters') or {}).items():
+        if value is None:
+            conditions.append(f"{key} IS NULL")
+        elif not isinstance(value, dict):
+            conditions.append(f"{key} = {placeholder()}")
+            steps.append((key, None, None))
+        else:
+            for op, shape in _value_shape(value, dialect.array_in):
+                if op == '$in':
+                    if shape == 0:
+                        conditions.append("1 = 0")
+                    elif shape == 'array':
+                        conditions.append(f"{key} = ANY({placeholder()})")
+                        steps.append((key, op, 'array'))
+                    else:
+                        conditions.append(f"{key} IN ({', '.join(placeholder() for _ in range(shape))})")
+                        steps.append((key, op, shape))
+                elif op == '$ne' and shape == 'null':
+                    conditions.append(f"{key} IS NOT NULL")
+                elif op == '$regex':
+                    if dialect.regex_operator:
+                        operator = dialect.regex_operator + ('*' if shape else '')
+                        conditions.append(f"{key} {operator} {placeholder()}")
+                        steps.append((key, op, None))
+                    else:
+                        conditions.append(f"{key} LIKE {placeholder()}")
+                        steps.append((key, op, 'like'))
+                else:
+                    conditions.append(f"{key} {_COMPARISONS[op]} {placeholder()}")
+                    steps.append((key, op, None))
+    if conditions:
+        parts.append(f"WHERE {' AND '.join(conditions)}")
+
+    group_by = query_params.get('group_by') or []
+    if group_by:
+        parts.append(f"GROUP BY {', '.join(group_by)}")
+    having = query_params.get('having') or []
+    if having:
+        conditions = [_HAVING_TOKEN.sub(lambda m: placeholder() if m.group() == '?' else m.group(), condition)
+                      for condition in having]
+        parts.append(f"HAVING {' AND '.join(conditions)}")
+
+    order_by = query_params.get('order_by') or []
+    if order_by:
+        parts.append("ORDER BY " + ', '.join(
+            f"{field} {'DESC' if _is_descending(direction) else 'ASC'}" for field, direction in order_by
+        ))
+
+    has_limit = query_params.get('limit') is not None
+    has_offset = query_params.get('offset') is not None
+    if has_limit:
+        parts.append(f"LIMIT {placeholder()}")
+    elif has_offset and dialect.offset_only_limit:
+        parts.append(f"LIMIT {dialect.offset_only_limit}")
+    if has_offset:
+        parts.append(f"OFFSET {placeholder()}")
+
+    return CompiledPlan(' '.join(parts), steps, has_limit, has_offset)
+
+
+class PlanCache:
+    """
+    LRU cache of compiled plans for one backend.
+
+    Example:
+        plan, params = self.plan_cache.prepare(query_params, model_class.get_table_name())
+        rows = await connection.fetch(plan.sql, *params)
+    """
+
+    def __init__(self, dialect: Dialect, max_size: int = 512):
+        self.dialect = dialect
+        self.max_size = max_size
+        self._plans: 'OrderedDict[tuple, CompiledPlan]' = OrderedDict()
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+
+    def get(self, query_params: Dict[str, Any], table_name: Optional[str] = None) -> CompiledPlan:
+        """Return the plan for this query's shape, compiling it on a miss."""
+        key = query_shape(query_params, self.dialect)
+        if table_name is not None and key[0] != table_name:
+            key = (table_name,) + key[1:]
+        plan = self._plans.get(key)
+        if plan is not None:
+            self.hits += 1
+            self._plans.move_to_end(key)
+        else:
+            self.misses += 1
+            plan = compile_plan(query_params, self.dialect, table_name or key[0])
+            self._plans[key] = plan
+            if len(self._plans) > self.max_size:
+                self._plans.popitem(last=False)
+                self.evictions += 1
+        plan.uses += 1
+        return plan
+
+    def prepare(self, query_params: Dict[str, Any], table_name: Optional[str] = None) -> Tuple[CompiledPlan, List[Any]]:
+        """Plan and bound parameters for a query."""
+        plan = self.get(query_params, table_name)
+        return plan, plan.bind(query_params)
+
+    def clear(self) -> None:
+        """Drop all plans, e.g. after a schema migration."""
+        self._plans.clear()
+
+    def get_stats(self) -> Dict[str, Any]:
+        total = self.hits + self.misses
+        return {
+            'dialect': self.dialect.name,
+            'plans': len(self._plans),
+            'max_size': self.max_size,
+            'hits': self.hits,
+            'misses': self.misses,
+            'evictions': self.evictions,
+            'hit_rate': self.hits / total if total else 0.0,
+        }
+
+
+__all__ = ['Dialect', 'POSTGRESQL', 'MYSQL', 'SQLITE', 'CompiledPlan', 'PlanCache',
+           'compile_plan', 'query_shape']
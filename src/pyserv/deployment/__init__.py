@@ -3,12 +3,17 @@ Deployment automation system for PyServ.
 Provides automated deployment, containerization, and orchestration features.
 """
 
-from .deployment_manager import DeploymentManager, DeploymentConfig
-from .docker_manager import DockerManager
-from .kubernetes_manager import KubernetesManager
-from .ci_cd_pipeline import CICDPipeline, PipelineStage
-from .deployment_monitor import DeploymentMonitor
-from .rollback_manager import RollbackManager
+# Managers load on first access, so importing pyserv.deployment does not pull in Docker/Kubernetes clients
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".deployment_manager": ["DeploymentManager", "DeploymentConfig"],
+    ".docker_manager": ["DockerManager"],
+    ".kubernetes_manager": ["KubernetesManager"],
+    ".ci_cd_pipeline": ["CICDPipeline", "PipelineStage"],
+    ".deployment_monitor": ["DeploymentMonitor"],
+    ".rollback_manager": ["RollbackManager"],
+})
 
 __all__ = [
     'DeploymentManager', 'DeploymentConfig',
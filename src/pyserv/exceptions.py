@@ -140,6 +140,12 @@ class Gone(HTTPException):
         super().__init__(message, status_code=410, error_code="gone", **kwargs)
 
 
+class PayloadTooLarge(HTTPException):
+    """413 Payload Too Large"""
+    def __init__(self, message: str = "Payload too large", **kwargs):
+        super().__init__(message, status_code=413, error_code="payload_too_large", **kwargs)
+
+
 class UnprocessableEntity(HTTPException):
     """422 Unprocessable Entity"""
     def __init__(self, message: str = "Unprocessable entity", **kwargs):
@@ -157,7 +163,8 @@ class TooManyRequests(HTTPException):
 class InternalServerError(HTTPException):
     """500 Internal Server Error"""
     def __init__(self, message: str = "Internal server error", **kwargs):
-        super().__init__(message, status_code=500, error_code="internal_server_error", **kwargs)
+        kwargs.setdefault("error_code", "internal_server_error")
+        super().__init__(message, status_code=500, **kwargs)
 
 
 class NotImplemented(HTTPException):
@@ -567,6 +574,7 @@ __all__ = [
     'UnsupportedMediaType',
     'Conflict',
     'Gone',
+    'PayloadTooLarge',
     'UnprocessableEntity',
     'TooManyRequests',
     'InternalServerError',
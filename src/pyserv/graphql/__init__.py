@@ -15,10 +15,14 @@ This module provides comprehensive GraphQL support with:
 - Caching and batching
 """
 
-from .schema import GraphQLManager, GraphQLSchema, GraphQLObjectType, GraphQLField
-from .query import GraphQLQuery, GraphQLMutation, GraphQLSubscription
-from .middleware import GraphQLMiddleware
-from .playground import GraphQLPlayground
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".schema": ["GraphQLManager", "GraphQLSchema", "GraphQLObjectType", "GraphQLField"],
+    ".query": ["GraphQLQuery", "GraphQLMutation", "GraphQLSubscription"],
+    ".middleware": ["GraphQLMiddleware"],
+    ".playground": ["GraphQLPlayground"],
+})
 
 __all__ = [
     'GraphQLManager', 'GraphQLSchema', 'GraphQLObjectType', 'GraphQLField',
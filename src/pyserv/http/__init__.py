@@ -5,9 +5,10 @@ This module contains HTTP request/response handling, middleware, and routing com
 """
 
 from .request import Request
-from .response import Response
+from .response import Response, FileResponse
+from .multipart import UploadFile
 
-__all__ = ['Request', 'Response']
+__all__ = ['Request', 'Response', 'FileResponse', 'UploadFile']
 
 
 
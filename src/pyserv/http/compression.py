@@ -0,0 +1,232 @@
+"""
+Pyserv HTTP content-coding.
+
+Negotiates a coding from ``Accept-Encoding`` and compresses bodies either
+in one shot or incrementally for streamed responses. gzip and deflate use
+``zlib``; ``br`` and ``zstd`` are offered when ``brotli`` (or
+``brotlicffi``) and ``zstandard`` are installed.
+
+Compression contexts that can be reused are pooled: a ``zstandard``
+``ZstdCompressor`` is expensive to build and is returned to a bounded free
+list when its stream finishes. zlib and brotli expose no reset in Python
+(and copying a zlib context costs more than creating one), so those get a
+fresh stream object per response.
+"""
+
+import threading
+import zlib
+from typing import Dict, Iterable, List, Optional, Sequence, Tuple
+
+try:
+    import brotli
+except ImportError:  # pragma: no cover - optional dependency
+    try:
+        import brotlicffi as brotli
+    except ImportError:
+        brotli = None
+
+try:
+    import zstandard
+except ImportError:  # pragma: no cover - optional dependency
+    zstandard = None
+
+# Bodies smaller than this are not worth the CPU or the header bytes
+MIN_SIZE = 500
+
+# Server preference when the client weights codings equally
+PREFERENCE = ('br', 'zstd', 'gzip', 'deflate')
+
+# Levels tuned for on-the-fly compression; static precompression uses MAX_LEVELS
+DEFAULT_LEVELS = {'br': 4, 'zstd': 3, 'gzip': 6, 'deflate': 6}
+MAX_LEVELS = {'br': 11, 'zstd': 19, 'gzip': 9, 'deflate': 9}
+
+_COMPRESSIBLE_PREFIXES = ('text/',)
+_COMPRESSIBLE_TYPES = frozenset((
+    'application/json', 'application/javascript', 'application/xml',
+    'application/xhtml+xml', 'application/rss+xml', 'application/atom+xml',
+    'application/wasm', 'application/x-ndjson', 'image/svg+xml',
+))
+_COMPRESSIBLE_SUFFIXES = ('+json', '+xml')
+
+
+def available_encodings() -> Tuple[str, ...]:
+    """Codings usable in this process, in server preference order."""
+    return tuple(
+        encoding for encoding in PREFERENCE
+        if (encoding != 'br' or brotli is not None) and (encoding != 'zstd' or zstandard is not None)
+    )
+
+
+def is_compressible(media_type: Optional[str]) -> bool:
+    """True for textual media types that benefit from compression."""
+    if not media_type:
+        return False
+    media_type = media_type.split(';', 1)[0].strip().lower()
+    return (media_type.startswith(_COMPRESSIBLE_PREFIXES) or media_type in _COMPRESSIBLE_TYPES
+            or media_type.endswith(_COMPRESSIBLE_SUFFIXES))
+
+
+def parse_accept_encoding(header: str) -> Dict[str, float]:
+    """Parse ``Accept-Encoding`` into a coding -> q-value map."""
+    weights: Dict[str, float] = {}
+    for item in header.split(','):
+        coding, _sep, params = item.partition(';')
+        coding = coding.strip().lower()
+        if not coding:
+            continue
+        q = 1.0
+        for param in params.split(';'):
+            name, eq, value = param.partition('=')
+            if eq and name.strip().lower() == 'q':
+                try:
+                    q = float(value)
+                except ValueError:
+                    q = 0.0
+        if coding == 'x-gzip':
+            coding = 'gzip'
+        weights[coding] = max(q, weights.get(coding, 0.0))
+    return weights
+
+
+def negotiate(accept_encoding: Optional[str], available: Optional[Iterable[str]] = None) -> Optional[str]:
+    """
+    Choose a content-coding.
+
+    Args:
+        accept_encoding: Raw ``Accept-Encoding`` header value
+        available: Candidate codings in preference order (default: all usable)
+
+    Returns:
+        The coding to use, or None for identity
+    """
+    if not accept_encoding:
+        return None
+    weights = parse_accept_encoding(accept_encoding)
+    wildcard = weights.get('*', 0.0)
+    best, best_q = None, 0.0
+    for encoding in (available_encodings() if available is None else available):
+        q = weights.get(encoding, wildcard)
+        if q > best_q:
+            best, best_q = encoding, q
+    return best
+
+
+class _ContextPool:
+    """Bounded free list of reusable compression contexts."""
+
+    def __init__(self, factory, limit: int = 32):
+        self._factory = factory
+        self._limit = limit
+        self._free: Dict[int, List] = {}
+        self._lock = threading.Lock()
+
+    def acquire(self, level: int):
+        with self._lock:
+            free = self._free.get(level)
+            if free:
+                return free.pop()
+        return self._factory(level)
+
+    def release(self, level: int, context) -> None:
+        with self._lock:
+            free = self._free.setdefault(level, [])
+            if len(free) < self._limit:
+                free.append(context)
+
+
+_zstd_pool = _ContextPool(lambda level: zstandard.ZstdCompressor(level=level)) if zstandard else None
+
+
+class StreamCompressor:
+    """
+    Incremental compressor for one response body.
+
+    ``compress(chunk)`` returns the bytes to send for that chunk. With
+    ``flush=True`` (the default) each call ends with a sync flush so the
+    client can decode everything sent so far, which is what streamed and
+    server-sent responses need. ``finish()`` returns the trailer and frees
+    the context; ``close()`` frees it without a trailer.
+    """
+
+    def __init__(self, encoding: str, level: Optional[int] = None, flush: bool = True):
+        if encoding not in available_encodings():
+            raise ValueError(f"Unsupported content-coding {encoding!r}")
+        self.encoding = encoding
+        self.level = DEFAULT_LEVELS[encoding] if level is None else level
+        self.flush = flush
+        self._context = None
+
+        if encoding == 'gzip':
+            self._stream = zlib.compressobj(self.level, zlib.DEFLATED, 31)
+        elif encoding == 'deflate':
+            self._stream = zlib.compressobj(self.level, zlib.DEFLATED, 15)
+        elif encoding == 'br':
+            self._stream = brotli.Compressor(quality=self.level)
+        else:
+            self._context = _zstd_pool.acquire(self.level)
+            self._stream = self._context.compressobj()
+
+    def compress(self, data: bytes) -> bytes:
+        if self._stream is None:
+            raise ValueError("Compressor is closed")
+        encoding = self.encoding
+        if encoding == 'br':
+            out = self._stream.process(data) if hasattr(self._stream, 'process') else self._stream.compress(data)
+            return out + self._stream.flush() if self.flush else out
+        out = self._stream.compress(data)
+        if not self.flush:
+            return out
+        if encoding == 'zstd':
+            return out + self._stream.flush(zstandard.COMPRESSOBJ_FLUSH_BLOCK)
+        return out + self._stream.flush(zlib.Z_SYNC_FLUSH)
+
+    def finish(self) -> bytes:
+        if self._stream is None:
+            return b""
+        tail = self._stream.finish() if self.encoding == 'br' else self._stream.flush()
+        self.close()
+        return tail
+
+    def close(self) -> None:
+        self._stream = None
+        if self._context is not None:
+            _zstd_pool.release(self.level, self._context)
+            self._context = None
+
+
+def compress(data: bytes, encoding: str, level: Optional[int] = None) -> bytes:
+    """Compress a complete body."""
+    compressor = StreamCompressor(encoding, level, flush=False)
+    try:
+        return compressor.compress(data) + compressor.finish()
+    finally:
+        compressor.close()
+
+
+def decompress(data: bytes, encoding: str) -> bytes:
+    """Decode a body produced by ``compress``; mainly for tests and clients."""
+    if encoding == 'gzip':
+        return zlib.decompress(data, 47)
+    if encoding == 'deflate':
+        return zlib.decompress(data)
+    if encoding == 'br' and brotli is not None:
+        return brotli.decompress(data)
+    if encoding == 'zstd' and zstandard is not None:
+        return zstandard.ZstdDecompressor().decompressobj().decompress(data)
+    raise ValueError(f"Unsupported content-coding {encoding!r}")
+
+
+def add_vary(headers: Dict[str, str], value: str = 'Accept-Encoding') -> None:
+    """Add a token to the Vary header without duplicating it."""
+    current = headers.get('vary')
+    if not current:
+        headers['vary'] = value
+    elif value.lower() not in [token.strip().lower() for token in current.split(',')]:
+        headers['vary'] = f"{current}, {value}"
+
+
+__all__ = [
+    'MIN_SIZE', 'PREFERENCE', 'DEFAULT_LEVELS', 'MAX_LEVELS', 'StreamCompressor',
+    'available_encodings', 'add_vary', 'compress', 'decompress', 'is_compressible',
+    'negotiate', 'parse_accept_encoding'
+]
@@ -0,0 +1,303 @@
+"""
+Pyserv streaming multipart/form-data parser.
+
+``MultipartParser`` is an incremental state machine: ``feed`` it body
+chunks as they arrive and it returns part events, keeping only a
+boundary-sized tail of unparsed data in memory. ``parse_form`` drives it
+from a request body stream and collects fields as strings and file parts
+as ``UploadFile`` objects backed by a ``SpooledTemporaryFile``, so large
+uploads overflow to disk instead of being held in memory.
+"""
+
+import asyncio
+import tempfile
+from typing import Any, AsyncIterator, Dict, List, Optional, Tuple, Union
+
+from pyserv.exceptions import BadRequest, PayloadTooLarge
+from pyserv.i18n import _
+
+# Event kinds returned by MultipartParser.feed
+PART_BEGIN = "part_begin"
+PART_DATA = "part_data"
+PART_END = "part_end"
+
+_PREAMBLE, _HEADERS, _BODY, _AFTER_DELIMITER, _DONE = range(5)
+
+
+def parse_options_header(value: str) -> Tuple[str, Dict[str, str]]:
+    """Split a header like ``form-data; name="a"`` into its value and parameters."""
+    main, _sep, rest = value.partition(";")
+    params: Dict[str, str] = {}
+    while rest:
+        item, _sep, rest = _split_param(rest)
+        key, eq, val = item.strip().partition("=")
+        if not eq:
+            continue
+        val = val.strip()
+        if len(val) >= 2 and val[0] == val[-1] == '"':
+            val = val[1:-1].replace('\\"', '"').replace("\\\\", "\\")
+        params[key.strip().lower()] = val
+    return main.strip().lower(), params
+
+
+def _split_param(text: str) -> Tuple[str, str, str]:
+    """Split off the next ``;``-separated parameter, respecting quotes."""
+    quoted = False
+    escaped = False
+    for index, char in enumerate(text):
+        if escaped:
+            escaped = False
+        elif char == "\\" and quoted:
+            escaped = True
+        elif char == '"':
+            quoted = not quoted
+        elif char == ";" and not quoted:
+            return text[:index], ";", text[index + 1:]
+    return text, "", ""
+
+
+class MultipartParser:
+    """
+    Incremental multipart/form-data parser.
+
+    ``feed(data)`` returns a list of ``(kind, payload)`` events where kind is
+    ``PART_BEGIN`` (payload: dict of lowercased headers), ``PART_DATA``
+    (payload: bytes) or ``PART_END`` (payload: None). Call ``close()`` once
+    the body ends to check that the closing boundary was seen.
+    """
+
+    def __init__(self, boundary: Union[str, bytes], max_header_size: int = 16 * 1024,
+                 max_parts: int = 1000):
+        if isinstance(boundary, str):
+            boundary = boundary.encode("latin-1")
+        if not boundary or len(boundary) > 200:
+            raise BadRequest(_("invalid_multipart_boundary"))
+        self._first = b"--" + boundary
+        self._delimiter = b"\r\n--" + boundary
+        self._buffer = bytearray()
+        self._state = _PREAMBLE
+        self._max_header_size = max_header_size
+        self._max_parts = max_parts
+        self._parts = 0
+
+    @property
+    def done(self) -> bool:
+        return self._state == _DONE
+
+    def feed(self, data: bytes) -> List[Tuple[str, Any]]:
+        events: List[Tuple[str, Any]] = []
+        if self._state == _DONE:
+            return events
+        buffer = self._buffer
+        buffer += data
+
+        while True:
+            if self._state == _PREAMBLE:
+                # The first boundary may start the body without a leading CRLF
+                index = buffer.find(self._first)
+                if index < 0:
+                    # Keep a tail that could be the start of the boundary
+                    keep = len(self._first) - 1
+                    if len(buffer) > keep:
+                        del buffer[:len(buffer) - keep]
+                    break
+                del buffer[:index + len(self._first)]
+                self._state = _AFTER_DELIMITER
+
+            elif self._state == _AFTER_DELIMITER:
+                if len(buffer) < 2:
+                    break
+                if buffer[:2] == b"--":
+                    self._state = _DONE
+                    buffer.clear()
+                    break
+                # Tolerate transport padding after the boundary
+                line_end = buffer.find(b"\r\n")
+                if line_end < 0:
+                    if len(buffer) > 1024:
+                        raise BadRequest(_("invalid_multipart_data"))
+                    break
+                if buffer[:line_end].strip(b" \t"):
+                    raise BadRequest(_("invalid_multipart_data"))
+                del buffer[:line_end + 2]
+                self._state = _HEADERS
+
+            elif self._state == _HEADERS:
+                if len(buffer) < 2:
+                    break
+                if buffer[:2] == b"\r\n":
+                    # A part with no headers at all starts with an empty line
+                    header_end, body_start = 0, 2
+                else:
+                    header_end = buffer.find(b"\r\n\r\n")
+                    if header_end < 0:
+                        if len(buffer) > self._max_header_size:
+                            raise BadRequest(_("multipart_headers_too_large"))
+                        break
+                    body_start = header_end + 4
+                self._parts += 1
+                if self._parts > self._max_parts:
+                    raise BadRequest(_("too_many_multipart_parts"))
+                headers = self._parse_headers(bytes(buffer[:header_end]))
+                del buffer[:body_start]
+                events.append((PART_BEGIN, headers))
+                self._state = _BODY
+
+            elif self._state == _BODY:
+                index = buffer.find(self._delimiter)
+                if index < 0:
+                    # Emit everything that can't be the start of a delimiter
+                    safe = len(buffer) - len(self._delimiter) + 1
+                    if safe > 0:
+                        events.append((PART_DATA, bytes(buffer[:safe])))
+                        del buffer[:safe]
+                    break
+                if index:
+                    events.append((PART_DATA, bytes(buffer[:index])))
+                del buffer[:index + len(self._delimiter)]
+                events.append((PART_END, None))
+                self._state = _AFTER_DELIMITER
+
+            else:
+                break
+
+        return events
+
+    def close(self) -> None:
+        """Signal end of input; raises BadRequest if the body was truncated."""
+        if self._state != _DONE:
+            raise BadRequest(_("invalid_multipart_data"))
+
+    @staticmethod
+    def _parse_headers(block: bytes) -> Dict[str, str]:
+        headers: Dict[str, str] = {}
+        for line in block.split(b"\r\n"):
+            if not line:
+                continue
+            name, sep, value = line.partition(b":")
+            if not sep:
+                raise BadRequest(_("invalid_multipart_data"))
+            headers[name.decode("latin-1").strip().lower()] = value.decode("utf-8", "replace").strip()
+        return headers
+
+
+class UploadFile:
+    """
+    Uploaded file part.
+
+    Data is written to a ``SpooledTemporaryFile`` that stays in memory up to
+    ``spool_max_size`` bytes and then rolls over to disk; disk writes and
+    reads run in the default executor.
+    """
+
+    def __init__(self, filename: Optional[str], content_type: str = "application/octet-stream",
+                 headers: Optional[Dict[str, str]] = None, spool_max_size: int = 1024 * 1024):
+        self.filename = filename
+        self.content_type = content_type
+        self.headers = headers or {}
+        self.size = 0
+        self._spool_max_size = spool_max_size
+        self.file = tempfile.SpooledTemporaryFile(max_size=spool_max_size)
+
+    @property
+    def in_memory(self) -> bool:
+        """True while the data has not rolled over to disk."""
+        return self.size <= self._spool_max_size
+
+    async def write(self, data: bytes) -> None:
+        if self.size + len(data) <= self._spool_max_size:
+            self.file.write(data)
+        else:
+            await asyncio.get_running_loop().run_in_executor(None, self.file.write, data)
+        self.size += len(data)
+
+    async def read(self, size: int = -1) -> bytes:
+        if self.in_memory:
+            return self.file.read(size)
+        return await asyncio.get_running_loop().run_in_executor(None, self.file.read, size)
+
+    async def seek(self, offset: int) -> None:
+        self.file.seek(offset)
+
+    async def close(self) -> None:
+        self.file.close()
+
+    def __repr__(self) -> str:
+        return f"<UploadFile {self.filename!r} {self.size} bytes>"
+
+
+async def parse_form(chunks: AsyncIterator[bytes], boundary: Union[str, bytes],
+                     max_field_size: int = 1024 * 1024,
+                     spool_max_size: int = 1024 * 1024,
+                     max_parts: int = 1000) -> Dict[str, Any]:
+    """
+    Parse a multipart/form-data body stream.
+
+    Returns:
+        Dictionary of field names to str values or UploadFile objects;
+        repeated names map to lists, as with urlencoded forms
+    """
+    parser = MultipartParser(boundary, max_parts=max_parts)
+    form: Dict[str, Any] = {}
+    name: Optional[str] = None
+    upload: Optional[UploadFile] = None
+    field: Optional[bytearray] = None
+    charset = "utf-8"
+
+    try:
+        async for chunk in chunks:
+            for kind, payload in parser.feed(chunk):
+                if kind == PART_BEGIN:
+                    _disp, params = parse_options_header(payload.get("content-disposition", ""))
+                    name = params.get("name")
+                    if name is None:
+                        raise BadRequest(_("invalid_multipart_data"))
+                    content_type, type_params = parse_options_header(payload.get("content-type", "text/plain"))
+                    if "filename" in params:
+                        upload = UploadFile(params["filename"], content_type or "application/octet-stream",
+                                            payload, spool_max_size)
+                    else:
+                        field = bytearray()
+                        charset = type_params.get("charset", "utf-8")
+                elif kind == PART_DATA:
+                    if upload is not None:
+                        await upload.write(payload)
+                    else:
+                        field += payload
+                        if len(field) > max_field_size:
+                            raise PayloadTooLarge(_("request_entity_too_large"))
+                else:
+                    if upload is not None:
+                        await upload.seek(0)
+                        value: Any = upload
+                    else:
+                        try:
+                            value = field.decode(charset)
+                        except (LookupError, UnicodeDecodeError):
+                            raise BadRequest(_("invalid_multipart_data"))
+                    _add_value(form, name, value)
+                    name, upload, field = None, None, None
+        parser.close()
+    except BaseException:
+        if upload is not None:
+            await upload.close()
+        for value in form.values():
+            for item in value if isinstance(value, list) else [value]:
+                if isinstance(item, UploadFile):
+                    await item.close()
+        raise
+
+    return form
+
+
+def _add_value(form: Dict[str, Any], name: str, value: Any) -> None:
+    if name not in form:
+        form[name] = value
+    elif isinstance(form[name], list):
+        form[name].append(value)
+    else:
+        form[name] = [form[name], value]
+
+
+__all__ = ['MultipartParser', 'UploadFile', 'parse_form', 'parse_options_header',
+           'PART_BEGIN', 'PART_DATA', 'PART_END']
@@ -14,6 +14,7 @@ This module provides comprehensive HTTP request handling with support for:
 
 import json
 import asyncio
+import codecs
 from typing import Dict, List, Any, AsyncGenerator, Optional, Union, TYPE_CHECKING
 from urllib.parse import parse_qs, unquote
 from email.utils import parsedate_to_datetime
@@ -22,9 +23,14 @@ from datetime import datetime
 if TYPE_CHECKING:
     from ..server.application import Application
 
-from pyserv.exceptions import BadRequest, UnsupportedMediaType
+from pyserv.core import codec, load_extension
+from pyserv.exceptions import BadRequest, PayloadTooLarge, UnsupportedMediaType
+from pyserv.http.multipart import parse_form, parse_options_header
 from pyserv.i18n import _
 
+# Native header/query parser, None when not built or PYSERV_DISABLE_CEXT is set
+_http_parser = load_extension("http_parser")
+
 
 class Request:
     """
@@ -39,8 +45,16 @@ class Request:
     - Request state management for middleware
     - Content type detection and validation
     - Security features and validation
+
+    Bodies larger than ``max_body_size`` bytes are rejected with 413. The
+    default comes from ``DEFAULT_MAX_BODY_SIZE`` and a route can override it
+    with ``max_body_size=`` when it is registered; None disables the limit.
     """
 
+    DEFAULT_MAX_BODY_SIZE = 100 * 1024 * 1024  # 100MB
+    # Multipart file parts larger than this are spooled to disk
+    SPOOL_MAX_SIZE = 1024 * 1024
+
     def __init__(self, scope: Dict[str, Any], receive: callable, send: callable, app: "Application"):
         self.scope = scope
         self.receive = receive
@@ -60,7 +74,9 @@ class Request:
         self.state: Dict[str, Any] = {}
 
         # Body handling
-        self._body: Optional[bytes] = None
+        self.max_body_size: Optional[int] = self.DEFAULT_MAX_BODY_SIZE
+        self._body: Optional[Union[bytes, bytearray]] = None
+        self._stream_consumed = False
         self._json_cache: Optional[Any] = None
         self._form_cache: Optional[Dict[str, Any]] = None
 
@@ -78,6 +94,9 @@ class Request:
 
     def _parse_headers(self, headers: List[List[bytes]]) -> Dict[str, str]:
         """Parse and normalize HTTP headers."""
+        if _http_parser is not None:
+            return _http_parser.parse_headers(headers)
+
         parsed = {}
         for key_bytes, value_bytes in headers:
             key = key_bytes.decode().lower()
@@ -96,6 +115,8 @@ class Request:
         """Parse query parameters from URL."""
         if not self.query_string:
             return {}
+        if _http_parser is not None:
+            return _http_parser.parse_query(self.query_string)
         return parse_qs(self.query_string, keep_blank_values=True)
 
     def _parse_content_length(self) -> Optional[int]:
@@ -103,6 +124,8 @@ class Request:
         content_length = self.headers.get("content-length")
         if content_length:
             try:
+                if _http_parser is not None:
+                    return _http_parser.parse_content_length(content_length)
                 return int(content_length)
             except ValueError:
                 pass
@@ -138,24 +161,44 @@ class Request:
         Returns:
             The complete request body as bytes
         """
-        if self._body is None:
-            self._body = b""
-            more_body = True
+        body = await self._read_body()
+        if isinstance(body, bytearray):
+            body = self._body = bytes(body)
+        return body
 
-            while more_body:
-                try:
-                    message = await self.receive()
-                    body_chunk = message.get("body", b"")
-                    self._body += body_chunk
-                    more_body = message.get("more_body", False)
-
-                    # Prevent excessive memory usage
-                    if len(self._body) > 100 * 1024 * 1024:  # 100MB limit
-                        raise BadRequest(_("request_entity_too_large"))
-
-                except asyncio.TimeoutError:
-                    raise BadRequest(_("request_timeout"))
+    async def _read_body(self) -> Union[bytes, bytearray]:
+        """
+        Buffer the body once, without quadratic concatenation.
 
+        A single-message body is kept as received. Otherwise chunks are
+        copied into one bytearray, preallocated from Content-Length when the
+        client sent it.
+        """
+        if self._body is not None:
+            return self._body
+
+        first: Optional[bytes] = None
+        buffer: Optional[bytearray] = None
+        position = 0
+
+        async for chunk in self.stream():
+            if first is None and buffer is None:
+                first = chunk
+                continue
+            if buffer is None:
+                buffer = bytearray(max(self.content_length or 0, len(first) + len(chunk)))
+                buffer[:len(first)] = first
+                position = len(first)
+                first = None
+            end = position + len(chunk)
+            buffer[position:end] = chunk
+            position = end
+
+        if buffer is not None:
+            del buffer[position:]
+            self._body = buffer
+        else:
+            self._body = first or b""
         return self._body
 
     async def json(self) -> Any:
@@ -174,20 +217,95 @@ class Request:
         if not self._is_json_content_type():
             raise UnsupportedMediaType(_("content_type_not_json"))
 
-        body = await self.body()
+        body = await self._read_body()
         if not body:
             raise BadRequest(_("empty_request_body"))
 
         try:
-            self._json_cache = json.loads(body.decode())
+            self._json_cache = codec.loads(body)
             return self._json_cache
-        except (json.JSONDecodeError, UnicodeDecodeError) as e:
+        except codec.DecodeError as e:
+            raise BadRequest(_("invalid_json_format", error=str(e)))
+
+    async def json_items(self) -> AsyncGenerator[Any, None]:
+        """
+        Decode a top-level JSON array incrementally.
+
+        Items are yielded as soon as they have fully arrived, so a large
+        array upload is never buffered or decoded as a whole.
+
+        Yields:
+            Each element of the array
+
+        Raises:
+            BadRequest: If the body is not a well-formed JSON array
+        """
+        if not self._is_json_content_type():
+            raise UnsupportedMediaType(_("content_type_not_json"))
+
+        decoder = json.JSONDecoder()
+        utf8 = codecs.getincrementaldecoder("utf-8")()
+        text = ""
+        index = 0
+        # 0: before "[", 1: first item or "]", 2: "," or "]", 3: item after ",", 4: done
+        state = 0
+
+        async def chunks():
+            async for chunk in self.stream():
+                yield chunk, False
+            yield b"", True
+
+        try:
+            async for chunk, final in chunks():
+                text = text[index:] + utf8.decode(chunk, final)
+                index = 0
+                length = len(text)
+
+                while True:
+                    while index < length and text[index] in " \t\r\n":
+                        index += 1
+                    if index == length:
+                        break
+
+                    char = text[index]
+                    if state == 4:
+                        raise ValueError("unexpected data after JSON array")
+                    if state == 0:
+                        if char != "[":
+                            raise ValueError("expected a JSON array")
+                        state, index = 1, index + 1
+                    elif state in (1, 2) and char == "]":
+                        state, index = 4, index + 1
+                    elif state == 2:
+                        if char != ",":
+                            raise ValueError("expected ',' or ']'")
+                        state, index = 3, index + 1
+                    else:
+                        try:
+                            item, end = decoder.raw_decode(text, index)
+                        except json.JSONDecodeError:
+                            if final:
+                                raise
+                            break
+                        # A number cut by the chunk boundary ("12" of "12.5") only
+                        # parses as a prefix; wait until a delimiter follows it
+                        if not final and (end == length or text[end] not in " \t\r\n,]"):
+                            break
+                        state, index = 2, end
+                        yield item
+
+            if state != 4:
+                raise ValueError("unterminated JSON array")
+        except (ValueError, UnicodeDecodeError) as e:
             raise BadRequest(_("invalid_json_format", error=str(e)))
 
     async def form(self) -> Dict[str, Any]:
         """
         Parse request body as form data.
 
+        multipart/form-data is parsed as it streams in; file parts become
+        ``UploadFile`` objects spooled to disk past ``SPOOL_MAX_SIZE``.
+
         Returns:
             Dictionary of form field names to values
         """
@@ -197,6 +315,15 @@ class Request:
         if not self._is_form_content_type():
             raise UnsupportedMediaType(_("content_type_not_form"))
 
+        if "multipart/form-data" in self.content_type:
+            # Boundaries are case-sensitive, so parse the original header
+            _media_type, params = parse_options_header(self.headers.get("content-type", ""))
+            boundary = params.get("boundary")
+            if not boundary:
+                raise BadRequest(_("invalid_multipart_boundary"))
+            self._form_cache = await parse_form(self.stream(), boundary, spool_max_size=self.SPOOL_MAX_SIZE)
+            return self._form_cache
+
         body = await self.body()
         if not body:
             return {}
@@ -216,19 +343,41 @@ class Request:
         """
         Stream the request body as an async generator.
 
+        Yields the buffered body if it was already read, and enforces
+        ``max_body_size`` while receiving.
+
         Yields:
             Chunks of the request body as bytes
         """
+        if self._body is not None:
+            if self._body:
+                yield bytes(self._body)
+            return
+        if self._stream_consumed:
+            raise RuntimeError("Request body stream already consumed")
+        self._stream_consumed = True
+
+        limit = self.max_body_size
+        if limit is not None and self.content_length is not None and self.content_length > limit:
+            raise PayloadTooLarge(_("request_entity_too_large"))
+
+        received = 0
         more_body = True
         while more_body:
             try:
                 message = await self.receive()
-                chunk = message.get("body", b"")
-                if chunk:  # Only yield non-empty chunks
-                    yield chunk
-                more_body = message.get("more_body", False)
             except asyncio.TimeoutError:
                 raise BadRequest(_("request_timeout"))
+            if message.get("type") == "http.disconnect":
+                raise BadRequest(_("client_disconnected"))
+
+            chunk = message.get("body", b"")
+            if chunk:  # Only yield non-empty chunks
+                received += len(chunk)
+                if limit is not None and received > limit:
+                    raise PayloadTooLarge(_("request_entity_too_large"))
+                yield chunk
+            more_body = message.get("more_body", False)
 
     def _is_json_content_type(self) -> bool:
         """Check if content type is JSON."""
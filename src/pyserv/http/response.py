@@ -14,13 +14,16 @@ This module provides comprehensive HTTP response handling with support for:
 
 import asyncio
 import inspect
-import json
 import hashlib
-import gzip
-import zlib
-from typing import Any, Dict, List, Callable, Optional, Union, AsyncGenerator
-from datetime import datetime, timedelta
-from email.utils import format_datetime
+import mimetypes
+import os
+import re
+from typing import Any, Dict, List, Callable, Optional, Union, AsyncGenerator, Tuple
+from datetime import datetime, timedelta, timezone
+from email.utils import format_datetime, parsedate_to_datetime
+
+from pyserv.core import codec
+from pyserv.http import compression as content_coding
 
 
 class Response:
@@ -39,6 +42,12 @@ class Response:
     - Security headers
     """
 
+    # Bodies below this size are sent uncompressed
+    compression_min_size = content_coding.MIN_SIZE
+
+    # Chunks a generator-backed stream may run ahead of the client
+    stream_queue_size = 8
+
     # Common HTTP status codes
     STATUS_CODES = {
         100: "Continue",
@@ -124,6 +133,7 @@ class Response:
         # Streaming support
         self._streaming = asyncio.Queue() if content is None else None
         self._stream_ended = False
+        self._stream_source: Optional[AsyncGenerator[bytes, None]] = None
 
         # Content type detection
         self.media_type = self._detect_media_type(content, media_type)
@@ -290,9 +300,22 @@ class Response:
     async def end_stream(self) -> None:
         """End the response stream."""
         if self._streaming is not None and not self._stream_ended:
-            await self._streaming.put(None)
+            try:
+                await self._streaming.put(None)
+            except asyncio.CancelledError:
+                self._abort_stream()
+                raise
             self._stream_ended = True
 
+    def _abort_stream(self) -> None:
+        """Drop queued chunks once nobody is reading; no end sentinel is sent."""
+        self._stream_ended = True
+        while True:
+            try:
+                self._streaming.get_nowait()
+            except asyncio.QueueEmpty:
+                return
+
     async def stream_generator(self, generator: AsyncGenerator[bytes, None]) -> None:
         """Stream data from an async generator."""
         if self._streaming is None:
@@ -301,11 +324,18 @@ class Response:
         try:
             async for chunk in generator:
                 await self.stream_data(chunk)
+        except asyncio.CancelledError:
+            # The client went away: a sentinel would block on the full queue forever
+            self._abort_stream()
+            aclose = getattr(generator, 'aclose', None)
+            if aclose is not None:
+                await aclose()
+            raise
         finally:
             await self.end_stream()
 
     def _get_content_bytes(self) -> bytes:
-        """Get the response content as bytes."""
+        """Get the response content as bytes (before any content-coding)."""
         if self._processed_content is not None:
             return self._processed_content
 
@@ -316,72 +346,122 @@ class Response:
             content = self.content
         elif isinstance(self.content, str):
             content = self.content.encode(self.charset)
-        elif isinstance(self.content, (dict, list)):
-            content = json.dumps(self.content, ensure_ascii=False).encode(self.charset)
+        elif isinstance(self.content, (dict, list)) or self._is_json_media_type():
+            content = codec.dumps(self.content)
+            if self.charset.lower().replace("-", "") != "utf8":
+                content = content.decode("utf-8").encode(self.charset)
         else:
             content = str(self.content).encode(self.charset)
 
-        # Apply compression if requested
-        if self.compression:
-            content = self._compress_content(content)
-
         self._processed_content = content
         return content
 
-    def _compress_content(self, content: bytes) -> bytes:
-        """Compress response content."""
-        if self.compression == "gzip":
-            return gzip.compress(content)
-        elif self.compression == "deflate":
-            return zlib.compress(content)
+    def _is_json_media_type(self) -> bool:
+        media_type = (self.media_type or "").split(";", 1)[0].strip()
+        return media_type == "application/json" or media_type.endswith("+json")
+
+    def _select_encoding(self, scope: Dict[str, Any]) -> Optional[str]:
+        """
+        Negotiate a content-coding for this response.
+
+        ``compression`` may be ``"auto"`` (any coding the client accepts)
+        or a specific coding, which is used only if the client accepts it.
+        """
+        if not self.compression or "content-encoding" in self.headers \
+                or self.status_code in (204, 304) or self.status_code < 200 \
+                or not content_coding.is_compressible(self.media_type):
+            return None
+
+        if self.compression == "auto":
+            candidates = content_coding.available_encodings()
         else:
-            return content
+            candidates = [self.compression] if self.compression in content_coding.available_encodings() else []
+        if not candidates:
+            return None
+
+        accept_encoding = None
+        for key, value in scope.get("headers", []):
+            if key.lower() == b"accept-encoding":
+                accept_encoding = value.decode("latin-1")
+                break
+        content_coding.add_vary(self.headers)
+        return content_coding.negotiate(accept_encoding, candidates)
+
+    def _encoded_headers(self, encoding: Optional[str]) -> Dict[str, str]:
+        """Response headers adjusted for the chosen content-coding."""
+        headers = dict(self.headers)
+        if encoding:
+            headers["content-encoding"] = encoding
+            headers.pop("content-length", None)
+            etag = headers.get("etag")
+            if etag and not etag.startswith("W/") and etag.endswith('"'):
+                headers["etag"] = f'{etag[:-1]}-{encoding}"'
+        return headers
 
     async def __call__(self, scope: Dict[str, Any], receive: callable, send: callable) -> None:
         """ASGI response callable."""
-        # Prepare headers
-        headers = [
-            [key.encode(), value.encode()]
-            for key, value in self.headers.items()
-        ]
-
-        # Add content-length if we have content
-        if self.content is not None and "content-length" not in self.headers:
+        encoding = self._select_encoding(scope)
+
+        content_bytes = None
+        if self._streaming is None and self.content is not None:
             content_bytes = self._get_content_bytes()
-            headers.append([b"content-length", str(len(content_bytes)).encode()])
+            if encoding and len(content_bytes) >= self.compression_min_size:
+                content_bytes = content_coding.compress(content_bytes, encoding)
+            else:
+                encoding = None
+
+        headers = self._encoded_headers(encoding)
+        if content_bytes is not None and (encoding or "content-length" not in headers):
+            headers["content-length"] = str(len(content_bytes))
 
         # Send response start
         await send({
             "type": "http.response.start",
             "status": self.status_code,
-            "headers": headers,
+            "headers": [[key.encode(), value.encode()] for key, value in headers.items()],
         })
 
-        # Handle streaming response
+        # Handle streaming response, compressing each chunk as it is produced
         if self._streaming is not None:
-            while True:
-                try:
-                    data = await asyncio.wait_for(self._streaming.get(), timeout=30.0)
-                    if data is None:
+            compressor = content_coding.StreamCompressor(encoding) if encoding else None
+            producer = None
+            if self._stream_source is not None:
+                producer = asyncio.create_task(self.stream_generator(self._stream_source))
+            try:
+                while True:
+                    try:
+                        data = await asyncio.wait_for(self._streaming.get(), timeout=30.0)
+                        if data is None:
+                            if producer is not None:
+                                # Re-raise generator errors instead of ending a truncated body cleanly
+                                await producer
+                            break
+                        if compressor is not None:
+                            data = compressor.compress(data)
+                            if not data:
+                                continue
+                        await send({
+                            "type": "http.response.body",
+                            "body": data,
+                            "more_body": True,
+                        })
+                    except asyncio.TimeoutError:
+                        # End stream on timeout
                         break
-                    await send({
-                        "type": "http.response.body",
-                        "body": data,
-                        "more_body": True,
-                    })
-                except asyncio.TimeoutError:
-                    # End stream on timeout
-                    break
 
-            await send({
-                "type": "http.response.body",
-                "body": b"",
-                "more_body": False,
-            })
+                await send({
+                    "type": "http.response.body",
+                    "body": compressor.finish() if compressor is not None else b"",
+                    "more_body": False,
+                })
+            finally:
+                if producer is not None and not producer.done():
+                    producer.cancel()
+                if compressor is not None:
+                    compressor.close()
 
         # Handle regular response
-        elif self.content is not None:
-            content_bytes = self._get_content_bytes()
+        elif content_bytes is not None:
             await send({
                 "type": "http.response.body",
                 "body": content_bytes,
@@ -389,6 +469,10 @@ class Response:
             })
 
         # Execute background tasks
+        await self._run_background_tasks()
+
+    async def _run_background_tasks(self) -> None:
+        """Execute background tasks after the body is sent."""
         for task in self.background_tasks:
             if inspect.iscoroutinefunction(task):
                 asyncio.create_task(task())
@@ -466,6 +550,36 @@ class Response:
             **kwargs
         )
 
+    @classmethod
+    def stream(
+        cls,
+        generator: AsyncGenerator[bytes, None],
+        status_code: int = 200,
+        headers: Optional[Dict[str, str]] = None,
+        media_type: str = "text/html",
+        **kwargs
+    ) -> 'Response':
+        """
+        Create a response whose body is pulled from an async generator.
+
+        The generator runs alongside the send loop with at most
+        ``stream_queue_size`` chunks in flight, so a slow client holds back
+        rendering instead of letting the body pile up in memory. Pairs with
+        the template engines' streaming renders::
+
+            Response.stream(engine.render_stream("page.html", context))
+        """
+        response = cls(
+            content=None,
+            status_code=status_code,
+            headers=headers,
+            media_type=media_type,
+            **kwargs
+        )
+        response._streaming = asyncio.Queue(maxsize=cls.stream_queue_size)
+        response._stream_source = generator
+        return response
+
     @classmethod
     def file(
         cls,
@@ -475,29 +589,15 @@ class Response:
         headers: Optional[Dict[str, str]] = None,
         **kwargs
     ) -> 'Response':
-        """Create a file response."""
-        import os
-        import mimetypes
-
-        if not os.path.exists(path):
+        """Create a streaming file response."""
+        if not os.path.isfile(path):
             return cls(status_code=404, content="File not found")
 
-        if filename is None:
-            filename = os.path.basename(path)
-
-        if media_type is None:
-            media_type, _ = mimetypes.guess_type(filename)
-
-        headers = headers or {}
-        headers["content-disposition"] = f'attachment; filename="{filename}"'
-
-        with open(path, 'rb') as f:
-            content = f.read()
-
-        return cls(
-            content=content,
+        return FileResponse(
+            path,
+            filename=filename,
+            media_type=media_type,
             headers=headers,
-            media_type=media_type or "application/octet-stream",
             **kwargs
         )
 
@@ -522,10 +622,208 @@ def RedirectResponse(url: str, status_code: int = 302, **kwargs) -> Response:
     """Create a redirect response (legacy compatibility)."""
     return Response.redirect(url, status_code, **kwargs)
 
-def FileResponse(path: str, **kwargs) -> Response:
-    """Create a file response (legacy compatibility)."""
-    return Response.file(path, **kwargs)
 
+class FileResponse(Response):
+    """
+    Streaming file response.
 
+    The file is never loaded whole: it is sent in ``chunk_size`` reads
+    performed off the event loop, or handed to the server through the ASGI
+    ``http.response.zerocopysend`` extension when the server offers it.
 
+    Features:
+    - ETag and Last-Modified derived from stat(), no content hashing
+    - Conditional GET (If-None-Match / If-Modified-Since) with 304
+    - Single byte ranges with 206 Partial Content, guarded by If-Range
+    - HEAD requests send headers only
+    """
+
+    chunk_size = 64 * 1024
+
+    def __init__(
+        self,
+        path: Union[str, os.PathLike],
+        filename: Optional[str] = None,
+        media_type: Optional[str] = None,
+        headers: Optional[Dict[str, str]] = None,
+        status_code: int = 200,
+        content_disposition: Optional[str] = "attachment",
+        chunk_size: Optional[int] = None,
+        stat_result: Optional[os.stat_result] = None,
+        **kwargs
+    ):
+        self.path = os.fspath(path)
+        self.filename = filename or os.path.basename(self.path)
+        if media_type is None:
+            media_type, _ = mimetypes.guess_type(self.filename)
+            media_type = media_type or "application/octet-stream"
+        if chunk_size:
+            self.chunk_size = chunk_size
+
+        kwargs.setdefault("charset", "utf-8" if media_type.startswith("text/") else None)
+        super().__init__(
+            content=b"",
+            status_code=status_code,
+            headers=headers,
+            media_type=media_type,
+            **kwargs
+        )
+
+        if content_disposition:
+            self.headers.setdefault(
+                "content-disposition", f'{content_disposition}; filename="{self.filename}"'
+            )
+
+        self.stat_result = stat_result or os.stat(self.path)
+        self.headers.setdefault("accept-ranges", "bytes")
+        self.headers.setdefault("etag", self._make_etag(self.stat_result))
+        self.headers.setdefault("last-modified", format_datetime(
+            datetime.fromtimestamp(self.stat_result.st_mtime, timezone.utc), usegmt=True
+        ))
+
+    @staticmethod
+    def _make_etag(stat_result: os.stat_result) -> str:
+        """Validator built from modification time and size."""
+        return f'"{stat_result.st_mtime_ns:x}-{stat_result.st_size:x}"'
+
+    def set_etag(self, etag: Optional[str] = None) -> None:
+        """Set ETag header (defaults to the stat()-based validator)."""
+        self.set_header("etag", etag or self._make_etag(self.stat_result))
+
+    def _not_modified(self, request_headers: Dict[str, str]) -> bool:
+        """Evaluate If-None-Match / If-Modified-Since."""
+        if_none_match = request_headers.get("if-none-match")
+        if if_none_match is not None:
+            etag = self.headers["etag"]
+            tags = [tag.strip() for tag in if_none_match.split(",")]
+            return "*" in tags or etag in tags or f"W/{etag}" in tags
+
+        if_modified_since = request_headers.get("if-modified-since")
+        if if_modified_since:
+            try:
+                since = parsedate_to_datetime(if_modified_since)
+            except (TypeError, ValueError):
+                return False
+            if since.tzinfo is None:
+                since = since.replace(tzinfo=timezone.utc)
+            return int(self.stat_result.st_mtime) <= since.timestamp()
+        return False
+
+    def _parse_range(self, request_headers: Dict[str, str]) -> Optional[Tuple[int, int]]:
+        """
+        Resolve a single byte range against the file size.
+
+        Returns:
+            (start, end) inclusive, None to send the whole file
+
+        Raises:
+            ValueError: If the range can't be satisfied
+        """
+        range_header = request_headers.get("range")
+        if not range_header or self.status_code != 200:
+            return None
+
+        # A stale If-Range validator means the client wants the full file
+        if_range = request_headers.get("if-range")
+        if if_range and if_range.strip() not in (self.headers["etag"], self.headers["last-modified"]):
+            return None
+
+        match = _RANGE_PATTERN.fullmatch(range_header.strip())
+        if not match:
+            return None  # Multiple or malformed ranges: ignore, send 200
+
+        size = self.stat_result.st_size
+        first, last = match.group(1), match.group(2)
+        if first:
+            start = int(first)
+            end = min(int(last), size - 1) if last else size - 1
+        elif last:
+            start = max(size - int(last), 0)
+            end = size - 1
+        else:
+            return None
+
+        if start > end or start >= size:
+            raise ValueError("range not satisfiable")
+        return start, end
+
+    async def __call__(self, scope: Dict[str, Any], receive: callable, send: callable) -> None:
+        """ASGI response callable."""
+        request_headers = {
+            key.decode("latin-1").lower(): value.decode("latin-1")
+            for key, value in scope.get("headers", [])
+        }
+        status_code = self.status_code
+        headers = dict(self.headers)
+        size = self.stat_result.st_size
+        start, end = 0, size - 1
+
+        if status_code == 200 and scope.get("method", "GET") in ("GET", "HEAD") \
+                and self._not_modified(request_headers):
+            status_code = 304
+            for key in ("content-type", "content-disposition", "content-length"):
+                headers.pop(key, None)
+        else:
+            try:
+                byte_range = self._parse_range(request_headers)
+            except ValueError:
+                byte_range = None
+                status_code = 416
+                headers["content-range"] = f"bytes */{size}"
+                headers["content-length"] = "0"
+            if byte_range is not None:
+                start, end = byte_range
+                status_code = 206
+                headers["content-range"] = f"bytes {start}-{end}/{size}"
+            if status_code != 416:
+                headers["content-length"] = str(end - start + 1)
+
+        await send({
+            "type": "http.response.start",
+            "status": status_code,
+            "headers": [[key.encode("latin-1"), value.encode("latin-1")] for key, value in headers.items()],
+        })
+
+        count = end - start + 1
+        if status_code in (304, 416) or scope.get("method") == "HEAD" or count <= 0:
+            await send({"type": "http.response.body", "body": b"", "more_body": False})
+        elif "http.response.zerocopysend" in scope.get("extensions", {}):
+            await self._send_zerocopy(send, start, count)
+        else:
+            await self._send_chunks(send, start, count)
+
+        await self._run_background_tasks()
+
+    async def _send_zerocopy(self, send: callable, offset: int, count: int) -> None:
+        """Let the server sendfile() the range directly from the descriptor."""
+        with open(self.path, "rb") as file:
+            await send({
+                "type": "http.response.zerocopysend",
+                "file": file,
+                "offset": offset,
+                "count": count,
+                "more_body": False,
+            })
 
+    async def _send_chunks(self, send: callable, offset: int, count: int) -> None:
+        """Stream the range in fixed-size reads performed off the event loop."""
+        loop = asyncio.get_running_loop()
+        with open(self.path, "rb") as file:
+            if offset:
+                file.seek(offset)
+            while count > 0:
+                chunk = await loop.run_in_executor(None, file.read, min(self.chunk_size, count))
+                if not chunk:
+                    break  # File shrank while sending
+                count -= len(chunk)
+                await send({
+                    "type": "http.response.body",
+                    "body": chunk,
+                    "more_body": count > 0,
+                })
+            if count > 0:
+                await send({"type": "http.response.body", "body": b"", "more_body": False})
+
+
+# Single "bytes=start-end" range; suffix ("-500") and open ("500-") forms allowed
+_RANGE_PATTERN = re.compile(r"bytes=\s*(\d*)\s*-\s*(\d*)")
@@ -3,11 +3,16 @@ IoT Protocols and P2P Communication for PyServ.
 Provides support for IoT protocols and peer-to-peer communication.
 """
 
-from .mqtt_client import MQTTClient, MQTTConfig
-from .coap_server import CoAPServer, CoAPConfig
-from .websocket_p2p import WebSocketP2P, P2PConfig
-from .device_manager import DeviceManager, DeviceConfig
-from .protocol_gateway import ProtocolGateway
+# Protocols load on first access, so importing pyserv.iot does not pull in MQTT/CoAP clients
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".mqtt_client": ["MQTTClient", "MQTTConfig"],
+    ".coap_server": ["CoAPServer", "CoAPConfig"],
+    ".websocket_p2p": ["WebSocketP2P", "P2PConfig"],
+    ".device_manager": ["DeviceManager", "DeviceConfig"],
+    ".protocol_gateway": ["ProtocolGateway"],
+})
 
 __all__ = [
     'MQTTClient', 'MQTTConfig',
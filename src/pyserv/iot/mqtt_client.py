@@ -74,8 +74,8 @@ class MQTTClient:
                 self.logger.warning("MQTT client not connected")
                 return False
 
-            # Convert message to JSON if it's not a string
-            if not isinstance(message, str):
+            # Convert message to JSON unless it is already a string or binary frame
+            if not isinstance(message, (str, bytes)):
                 message = json.dumps(message)
 
             # In real implementation, this would publish via MQTT
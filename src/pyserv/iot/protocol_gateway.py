@@ -5,9 +5,11 @@ Provides unified interface for different IoT protocols.
 
 import asyncio
 import logging
-from typing import Dict, Any, Optional, Callable, List
+from typing import Dict, Any, Optional, Callable, List, Tuple, Union
 from dataclasses import dataclass
 
+from pyserv.streaming.frames import FrameDecoder, FrameError, StreamFrame
+
 @dataclass
 class ProtocolGatewayConfig:
     """Configuration for protocol gateway."""
@@ -35,6 +37,8 @@ class ProtocolGateway:
         self.message_queue = asyncio.Queue(maxsize=config.message_queue_size)
         self.is_running = False
         self.protocol_handlers: Dict[str, Callable] = {}
+        self._decoders: Dict[Tuple[str, Optional[str]], FrameDecoder] = {}
+        self.frames_received = 0
 
     async def start(self) -> bool:
         """Start the protocol gateway."""
@@ -86,6 +90,8 @@ class ProtocolGateway:
         """Send message to device using specified or default protocol."""
         try:
             protocol = protocol or self.config.default_protocol
+            if isinstance(message, StreamFrame):
+                message = message.to_bytes()
 
             if protocol == "mqtt" and self.mqtt_client:
                 topic = f"devices/{device_id}/commands"
@@ -112,6 +118,8 @@ class ProtocolGateway:
         try:
             protocol = protocol or self.config.default_protocol
             sent_count = 0
+            if isinstance(message, StreamFrame):
+                message = message.to_bytes()
 
             if protocol == "mqtt" and self.mqtt_client:
                 topic = f"devices/{device_type}/broadcast"
@@ -139,6 +147,47 @@ class ProtocolGateway:
             del self.protocol_handlers[protocol]
             self.logger.info(f"Unregistered handler for protocol: {protocol}")
 
+    async def ingest(self, protocol: str, data: Union[bytes, bytearray, memoryview],
+                     device_id: Optional[str] = None) -> int:
+        """
+        Decode binary stream frames received over a protocol and hand them to its handler.
+
+        ``data`` may hold any number of frames, and a frame may be split across
+        calls; each (protocol, device) stream keeps its own decoder. Frames are
+        views into ``data``, so telemetry is passed on without copying.
+
+        Returns:
+            Number of frames delivered
+        """
+        key = (protocol, device_id)
+        decoder = self._decoders.get(key)
+        if decoder is None:
+            decoder = self._decoders[key] = FrameDecoder()
+        try:
+            frames = decoder.feed(data)
+        except FrameError as e:
+            self.logger.error(f"Dropping corrupt {protocol} stream from {device_id}: {e}")
+            decoder.reset()
+            return 0
+        if not frames:
+            return 0
+
+        handler = self.protocol_handlers.get(protocol)
+        if handler is None:
+            self.logger.warning(f"No handler for protocol: {protocol}")
+            return 0
+        for frame in frames:
+            try:
+                await handler(device_id, frame)
+            except Exception as e:
+                self.logger.error(f"Error handling message: {e}")
+        self.frames_received += len(frames)
+        return len(frames)
+
+    def forget_stream(self, protocol: str, device_id: Optional[str] = None):
+        """Drop the partial-frame state of a stream, e.g. when its device disconnects."""
+        self._decoders.pop((protocol, device_id), None)
+
     async def _process_messages(self):
         """Process incoming messages from all protocols."""
         while self.is_running:
@@ -181,6 +230,7 @@ class ProtocolGateway:
             "default_protocol": self.config.default_protocol,
             "enabled_protocols": [],
             "message_queue_size": self.message_queue.qsize(),
+            "frames_received": self.frames_received,
             "registered_handlers": list(self.protocol_handlers.keys())
         }
 
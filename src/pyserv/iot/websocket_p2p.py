@@ -55,6 +55,14 @@ class ChannelLayer(ABC):
         """Remove channel from a group."""
         pass
 
+    async def attach(self, channel: str, websocket: Any):
+        """Bind a channel to its WebSocket; layers that write to sockets themselves use it."""
+        pass
+
+    async def detach(self, channel: str):
+        """Forget a channel's WebSocket."""
+        pass
+
 
 class InMemoryChannelLayer(ChannelLayer):
     """
@@ -95,13 +103,66 @@ class InMemoryChannelLayer(ChannelLayer):
             self.groups[group].remove(channel)
 
 
+class HubChannelLayer(InMemoryChannelLayer):
+    """
+    Channel layer whose groups are ``WebSocketHub`` topics.
+
+    Group messages for channels attached to a WebSocket are encoded once
+    and queued to every socket by the hub, so a slow peer never holds up
+    the others. Channels without a socket still get them on their queue.
+    """
+
+    def __init__(self, hub=None):
+        super().__init__()
+        if hub is None:
+            from pyserv.websocket.hub import get_websocket_hub
+            hub = get_websocket_hub()
+        self.hub = hub
+        self.websockets: Dict[str, Any] = {}
+
+    async def attach(self, channel: str, websocket: Any):
+        """Bind a channel to its WebSocket, subscribing it to the groups it is already in."""
+        self.websockets[channel] = websocket
+        for group, channels in self.groups.items():
+            if channel in channels:
+                await self.hub.subscribe(websocket, group)
+
+    async def detach(self, channel: str):
+        """Forget a channel's WebSocket and its hub subscriptions."""
+        websocket = self.websockets.pop(channel, None)
+        if websocket is not None:
+            await self.hub.remove(websocket)
+
+    async def group_send(self, group: str, message: Any):
+        """Publish to the group's sockets through the hub, and queue for channels without one."""
+        await self.hub.publish(group, message)
+        for channel in list(self.groups.get(group, ())):
+            if channel not in self.websockets:
+                await self.send(channel, message)
+
+    async def group_add(self, channel: str, group: str):
+        """Add channel to a group."""
+        await super().group_add(channel, group)
+        websocket = self.websockets.get(channel)
+        if websocket is not None:
+            await self.hub.subscribe(websocket, group)
+
+    async def group_discard(self, channel: str, group: str):
+        """Remove channel from a group."""
+        await super().group_discard(channel, group)
+        websocket = self.websockets.get(channel)
+        if websocket is not None:
+            await self.hub.unsubscribe(websocket, group)
+
+
 class WebSocketConsumer(ABC):
     """
     Base WebSocket consumer class similar to Django Channels.
     """
 
-    def __init__(self, scope: Dict[str, Any]):
+    def __init__(self, scope: Dict[str, Any], websocket: Any = None):
         self.scope = scope
+        self.websocket = websocket
         self.channel_layer: Optional[ChannelLayer] = None
         self.channel_name: Optional[str] = None
 
@@ -150,14 +211,16 @@ class P2PConsumer(WebSocketConsumer):
     P2P WebSocket consumer with channel layer support.
     """
 
-    def __init__(self, scope: Dict[str, Any]):
-        super().__init__(scope)
+    def __init__(self, scope: Dict[str, Any], websocket: Any = None):
+        super().__init__(scope, websocket)
         self.groups: Set[str] = set()
 
     async def connect(self):
         """Accept P2P connection."""
         await self.accept()
         self.channel_name = f"p2p_{id(self)}"
+        if self.channel_layer and self.websocket is not None:
+            await self.channel_layer.attach(self.channel_name, self.websocket)
 
         # Add to default groups
         await self.group_add("p2p")
@@ -168,6 +231,8 @@ class P2PConsumer(WebSocketConsumer):
         # Remove from all groups
         for group in self.groups:
             await self.group_discard(group)
+        if self.channel_layer and self.channel_name:
+            await self.channel_layer.detach(self.channel_name)
 
     async def receive(self, text_data: str = None, bytes_data: bytes = None):
         """Handle incoming P2P messages."""
@@ -223,14 +288,16 @@ class WebSocketP2P:
     WebSocket-based P2P communication for IoT devices with Django Channels-like features.
     """
 
-    def __init__(self, config: P2PConfig):
+    def __init__(self, config: P2PConfig, hub=None):
         self.config = config
         self.logger = logging.getLogger("websocket_p2p")
         self.websocket = None
         self.is_connected = False
         self.peers: Dict[str, Dict[str, Any]] = {}
         self.message_handlers: List[Callable] = []
-        self.channel_layer: ChannelLayer = InMemoryChannelLayer()
+        self.hub = hub
+        # With a hub, group sends reach consumers' sockets through it
+        self.channel_layer: ChannelLayer = HubChannelLayer(hub) if hub is not None else InMemoryChannelLayer()
         self.consumers: Dict[str, WebSocketConsumer] = {}
 
     async def connect(self) -> bool:
@@ -287,7 +354,7 @@ class WebSocketP2P:
                 return False
 
             # Convert message to JSON if needed
-            if not isinstance(message, str):
+            if not isinstance(message, (str, bytes)):
                 message = json.dumps(message)
 
             # In real implementation, this would send via P2P connection
@@ -302,9 +369,13 @@ class WebSocketP2P:
     async def broadcast(self, message: Any) -> int:
         """Broadcast message to all connected peers."""
         try:
-            if not isinstance(message, str):
+            if not isinstance(message, (str, bytes)):
                 message = json.dumps(message)
 
+            if self.hub is not None:
+                # Consumers join the broadcast group on connect; the hub queues to each socket
+                return await self.hub.publish("broadcast", message)
+
             sent_count = 0
             for peer_id in self.peers:
                 if await self.send_to_peer(peer_id, message):
@@ -9,34 +9,28 @@ This module provides comprehensive microservices architecture with:
 - Data-intensive processing patterns
 """
 
-# Core service architecture
-from .service import (
-    Service, ServiceStatus, ServiceDiscovery, ServiceInstance,
-    InMemoryServiceDiscovery
-)
-
-# Distributed consensus
-from .consensus import (
-    RaftConsensus, ConsensusState, LogEntry, DistributedLock
-)
-
-# Event sourcing and CQRS
-from .event_sourcing import (
-    Event, EventStore, Aggregate, Command, CommandHandler,
-    Repository, EventPublisher
-)
-
-# API design patterns
-from .rest_api_patterns import (
-    HttpMethod, Link, APIResponse, APIError, RateLimiter,
-    DistributedRateLimiter, PaginationParams, Paginator,
-    APIResource, ValidationError, NotFoundError,
-    UnauthorizedError, ForbiddenError
-)
-
-# Legacy service discovery (for backward compatibility)
-from .service_discovery import ServiceDiscovery as LegacyServiceDiscovery
-from .service_discovery import ConsulDiscovery, ZookeeperDiscovery
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".service": [
+        "Service", "ServiceStatus", "ServiceDiscovery", "ServiceInstance",
+        "InMemoryServiceDiscovery",
+    ],
+    ".consensus": ["RaftConsensus", "ConsensusState", "LogEntry", "DistributedLock"],
+    ".event_sourcing": [
+        "Event", "EventStore", "Aggregate", "Command", "CommandHandler", "Repository",
+        "EventPublisher",
+    ],
+    ".event_log": ["SegmentedEventLog", "EventLogCorruption"],
+    ".rest_api_patterns": [
+        "HttpMethod", "Link", "APIResponse", "APIError", "RateLimiter",
+        "DistributedRateLimiter", "PaginationParams", "Paginator", "APIResource",
+        "ValidationError", "NotFoundError", "UnauthorizedError", "ForbiddenError",
+    ],
+    ".service_discovery": ["ConsulDiscovery", "ZookeeperDiscovery"],
+}, aliases={
+    "LegacyServiceDiscovery": ".service_discovery:ServiceDiscovery",
+})
 
 __all__ = [
     # Service architecture
@@ -48,7 +42,7 @@ __all__ = [
 
     # Event sourcing and CQRS
     'Event', 'EventStore', 'Aggregate', 'Command', 'CommandHandler',
-    'Repository', 'EventPublisher',
+    'Repository', 'EventPublisher', 'SegmentedEventLog', 'EventLogCorruption',
 
     # API design patterns
     'HttpMethod', 'Link', 'APIResponse', 'APIError', 'RateLimiter',
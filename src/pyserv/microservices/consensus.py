@@ -15,14 +15,14 @@ import time
 import json
 import socket
 import struct
-import threading
-from typing import List, Dict, Any, Optional, Callable
-from datetime import datetime
+from collections import deque
+from typing import List, Dict, Any, Optional, Callable, Set, Tuple
+from datetime import datetime, timedelta
 from dataclasses import dataclass, field
 from enum import Enum
-import pickle
 import uuid
 
+from pyserv.core import codec
 from pyserv.database import DatabaseConnection
 from pyserv.database.config import db_config
 
@@ -82,6 +82,68 @@ class LogEntry:
         return self.entry_type == LogEntryType.NO_OP
 
 
+# Wire format: every frame is a fixed header followed by a body.
+#   header = <body length: u32> <kind: u8> <correlation id: u32>
+# Bodies are packed fields; strings are u16-length-prefixed UTF-8
+# (0xFFFF for None) and commands are u32-length-prefixed JSON.
+FRAME_HEADER = struct.Struct('!IBI')
+MAX_FRAME_SIZE = 64 * 1024 * 1024
+
+FRAME_APPEND_ENTRIES = 1
+FRAME_APPEND_ENTRIES_RESPONSE = 2
+FRAME_REQUEST_VOTE = 3
+FRAME_REQUEST_VOTE_RESPONSE = 4
+FRAME_ERROR = 5
+
+_EPOCH = datetime(1970, 1, 1)
+_MICROSECOND = timedelta(microseconds=1)
+_ENTRY_TYPES = list(LogEntryType)
+_ENTRY_TYPE_CODES = {entry_type: code for code, entry_type in enumerate(_ENTRY_TYPES)}
+_U16 = struct.Struct('!H')
+_U32 = struct.Struct('!I')
+_APPEND_HEADER = struct.Struct('!QQQQI')
+_ENTRY_HEADER = struct.Struct('!QQBq')
+_APPEND_RESPONSE = struct.Struct('!QBQ')
+_VOTE_REQUEST = struct.Struct('!QQQ')
+_VOTE_RESPONSE = struct.Struct('!QB')
+
+
+def _pack_str(value: Optional[str]) -> bytes:
+    if value is None:
+        return _U16.pack(0xFFFF)
+    data = value.encode('utf-8')
+    return _U16.pack(len(data)) + data
+
+
+def _unpack_str(data: bytes, offset: int) -> Tuple[Optional[str], int]:
+    (length,) = _U16.unpack_from(data, offset)
+    offset += _U16.size
+    if length == 0xFFFF:
+        return None, offset
+    return data[offset:offset + length].decode('utf-8'), offset + length
+
+
+def _encode_entry(entry: LogEntry) -> bytes:
+    command = codec.dumps(entry.command)
+    return b''.join((
+        _ENTRY_HEADER.pack(entry.term, entry.index, _ENTRY_TYPE_CODES[entry.entry_type],
+                           (entry.timestamp - _EPOCH) // _MICROSECOND),
+        _pack_str(entry.client_id),
+        _U32.pack(len(command)), command,
+    ))
+
+
+def _decode_entry(data: bytes, offset: int) -> Tuple[LogEntry, int]:
+    term, index, type_code, micros = _ENTRY_HEADER.unpack_from(data, offset)
+    client_id, offset = _unpack_str(data, offset + _ENTRY_HEADER.size)
+    (length,) = _U32.unpack_from(data, offset)
+    offset += _U32.size
+    command = codec.loads(data[offset:offset + length])
+    entry = LogEntry(term=term, index=index, entry_type=_ENTRY_TYPES[type_code], command=command,
+                     client_id=client_id, timestamp=_EPOCH + timedelta(microseconds=micros))
+    return entry, offset + length
+
+
 @dataclass
 class RPCRequest:
     """Base RPC request"""
@@ -90,12 +152,14 @@ class RPCRequest:
 
     def to_bytes(self) -> bytes:
         """Serialize to bytes"""
-        return pickle.dumps(self.__dict__, protocol=pickle.HIGHEST_PROTOCOL)
+        return codec.dumps(self.__dict__)
 
     @classmethod
-    def from_bytes(cls, data: bytes):
+    def from_bytes(cls, data: bytes, request_id: Optional[str] = None):
         """Deserialize from bytes"""
-        parsed_data = pickle.loads(data)
+        parsed_data = codec.loads(data)
+        if request_id is not None:
+            parsed_data['request_id'] = request_id
         return cls(**parsed_data)
 
 
@@ -109,12 +173,13 @@ class RPCResponse:
 
     def to_bytes(self) -> bytes:
         """Serialize to bytes"""
-        return pickle.dumps(self.__dict__, protocol=pickle.HIGHEST_PROTOCOL)
+        return codec.dumps(self.__dict__)
 
     @classmethod
-    def from_bytes(cls, data: bytes):
+    def from_bytes(cls, data: bytes, request_id: str = ""):
         """Deserialize from bytes"""
-        parsed_data = pickle.loads(data)
+        parsed_data = codec.loads(data)
+        parsed_data.setdefault('request_id', request_id)
         return cls(**parsed_data)
 
 
@@ -128,18 +193,27 @@ class AppendEntriesRequest(RPCRequest):
     leader_commit: int = 0
 
     def to_bytes(self) -> bytes:
-        """Serialize to bytes with entry conversion"""
-        data = self.__dict__.copy()
-        data['entries'] = [entry.to_dict() for entry in self.entries]
-        return pickle.dumps(data, protocol=pickle.HIGHEST_PROTOCOL)
+        """Serialize to the binary wire format"""
+        parts = [
+            _APPEND_HEADER.pack(self.term, self.prev_log_index, self.prev_log_term,
+                                self.leader_commit, len(self.entries)),
+            _pack_str(self.leader_id),
+        ]
+        parts.extend(_encode_entry(entry) for entry in self.entries)
+        return b''.join(parts)
 
     @classmethod
-    def from_bytes(cls, data: bytes):
-        """Deserialize from bytes with entry conversion"""
-        parsed_data = pickle.loads(data)
-        entries = [LogEntry.from_dict(entry_data) for entry_data in parsed_data.get('entries', [])]
-        parsed_data['entries'] = entries
-        return cls(**parsed_data)
+    def from_bytes(cls, data: bytes, request_id: Optional[str] = None):
+        """Deserialize from the binary wire format"""
+        term, prev_log_index, prev_log_term, leader_commit, count = _APPEND_HEADER.unpack_from(data, 0)
+        leader_id, offset = _unpack_str(data, _APPEND_HEADER.size)
+        entries = []
+        for _ in range(count):
+            entry, offset = _decode_entry(data, offset)
+            entries.append(entry)
+        return cls(term=term, request_id=request_id or str(uuid.uuid4()), leader_id=leader_id,
+                   prev_log_index=prev_log_index, prev_log_term=prev_log_term,
+                   entries=entries, leader_commit=leader_commit)
 
 
 @dataclass
@@ -147,6 +221,18 @@ class AppendEntriesResponse(RPCResponse):
     """AppendEntries RPC response"""
     match_index: int = 0
 
+    def to_bytes(self) -> bytes:
+        """Serialize to the binary wire format"""
+        return _APPEND_RESPONSE.pack(self.term, self.success, self.match_index) + _pack_str(self.error_message)
+
+    @classmethod
+    def from_bytes(cls, data: bytes, request_id: str = ""):
+        """Deserialize from the binary wire format"""
+        term, success, match_index = _APPEND_RESPONSE.unpack_from(data, 0)
+        error_message, _ = _unpack_str(data, _APPEND_RESPONSE.size)
+        return cls(term=term, request_id=request_id, success=bool(success),
+                   error_message=error_message or "", match_index=match_index)
+
 
 @dataclass
 class RequestVoteRequest(RPCRequest):
@@ -155,6 +241,19 @@ class RequestVoteRequest(RPCRequest):
     last_log_index: int = 0
     last_log_term: int = 0
 
+    def to_bytes(self) -> bytes:
+        """Serialize to the binary wire format"""
+        return (_VOTE_REQUEST.pack(self.term, self.last_log_index, self.last_log_term)
+                + _pack_str(self.candidate_id))
+
+    @classmethod
+    def from_bytes(cls, data: bytes, request_id: Optional[str] = None):
+        """Deserialize from the binary wire format"""
+        term, last_log_index, last_log_term = _VOTE_REQUEST.unpack_from(data, 0)
+        candidate_id, _ = _unpack_str(data, _VOTE_REQUEST.size)
+        return cls(term=term, request_id=request_id or str(uuid.uuid4()), candidate_id=candidate_id,
+                   last_log_index=last_log_index, last_log_term=last_log_term)
+
 
 @dataclass
 class RequestVoteResponse(RPCResponse):
@@ -166,6 +265,21 @@ class RequestVoteResponse(RPCResponse):
         """Success is determined by vote_granted"""
         return self.vote_granted
 
+    @success.setter
+    def success(self, value: bool) -> None:
+        # The dataclass default for RPCResponse.success is ignored; vote_granted decides
+        pass
+
+    def to_bytes(self) -> bytes:
+        """Serialize to the binary wire format"""
+        return _VOTE_RESPONSE.pack(self.term, self.vote_granted)
+
+    @classmethod
+    def from_bytes(cls, data: bytes, request_id: str = ""):
+        """Deserialize from the binary wire format"""
+        term, vote_granted = _VOTE_RESPONSE.unpack_from(data, 0)
+        return cls(term=term, request_id=request_id, vote_granted=bool(vote_granted))
+
 
 class PersistentStorage:
     """Database-agnostic persistent storage for Raft state"""
@@ -352,248 +466,316 @@ class PersistentStorage:
             logger.error(f"Failed to truncate log: {e}")
 
 
-class NetworkTransport:
-    """Network transport layer"""
+class InMemoryStorage(PersistentStorage):
+    """Raft state kept in process memory, for tests, benchmarks and ephemeral clusters"""
 
-    def __init__(self, node_id: str, host: str = 'localhost', port: int = 0):
+    def __init__(self, node_id: str):
         self.node_id = node_id
-        self.host = host
-        self.port = port
-        self.server_socket = None
-        self.node_addresses: Dict[str, Tuple[str, int]] = {}
-        self.logger = logging.getLogger(f"NetworkTransport-{node_id}")
-        self._message_handlers: Dict[str, Callable] = {}
-        self._running = False
-
-    async def initialize(self):
-        """Initialize the transport layer"""
-        self.server_socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-        self.server_socket.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
-        self.server_socket.bind((self.host, self.port))
-        self.port = self.server_socket.getsockname()[1]
-        self.server_socket.listen(5)
-        self.server_socket.setblocking(False)
+        self.db_connection = None
+        self._initialized = True
+        self._term = 0
+        self._voted_for: Optional[str] = None
+        self._log: List[LogEntry] = []
 
-        self._running = True
-        server_thread = threading.Thread(target=self._run_server, daemon=True)
-        server_thread.start()
+    async def get_current_term(self) -> int:
+        return self._term
 
-        self.logger.info(f"Network transport initialized on {self.host}:{self.port}")
+    async def set_current_term(self, term: int):
+        self._term = term
 
-    def _run_server(self):
-        """Run the server socket in background thread"""
-        loop = asyncio.new_event_loop()
-        asyncio.set_event_loop(loop)
+    async def get_voted_for(self) -> Optional[str]:
+        return self._voted_for
 
-        async def handle_client(client_socket, client_address):
-            try:
-                length_data = await loop.sock_recv(client_socket, 4)
-                if not length_data or len(length_data) != 4:
-                    return
-                message_length = struct.unpack('!I', length_data)[0]
+    async def set_voted_for(self, voted_for: Optional[str]):
+        self._voted_for = voted_for
 
-                message_data = await loop.sock_recv(client_socket, message_length)
-                if not message_data:
-                    return
+    async def get_last_log_index(self) -> int:
+        return self._log[-1].index if self._log else 0
 
-                message = pickle.loads(message_data)
-                response = await self._handle_message(message)
+    async def get_last_log_term(self) -> int:
+        return self._log[-1].term if self._log else 0
 
-                if response:
-                    response_data = pickle.dumps(response, protocol=pickle.HIGHEST_PROTOCOL)
-                    response_length = struct.pack('!I', len(response_data))
-                    await loop.sock_sendall(client_socket, response_length + response_data)
+    async def get_log_entries(self, start_index: int = 1) -> List[LogEntry]:
+        return [entry for entry in self._log if entry.index >= start_index]
 
-            except Exception as e:
-                self.logger.error(f"Error handling client {client_address}: {e}")
-            finally:
-                try:
-                    client_socket.close()
-                except:
-                    pass
+    async def append_log_entry(self, entry: LogEntry):
+        self._log.append(entry)
 
-        async def server_loop():
-            while self._running:
-                try:
-                    client_socket, client_address = await loop.sock_accept(self.server_socket)
-                    asyncio.create_task(handle_client(client_socket, client_address))
-                except Exception as e:
-                    if self._running:
-                        self.logger.error(f"Server error: {e}")
-                    break
+    async def truncate_log_from(self, from_index: int):
+        self._log = [entry for entry in self._log if entry.index < from_index]
 
-        loop.run_until_complete(server_loop())
 
-    async def _handle_message(self, message: Dict[str, Any]) -> Any:
-        """Handle incoming message"""
-        message_type = message.get('type')
-        handler = self._message_handlers.get(message_type)
+class TransportError(Exception):
+    """An RPC could not be delivered or answered"""
 
-        if handler:
-            try:
-                return await handler(message.get('data'))
-            except Exception as e:
-                self.logger.error(f"Error handling {message_type} message: {e}")
-                return {'error': str(e)}
 
-        return {'error': f'Unknown message type: {message_type}'}
+class PeerConnection:
+    """
+    Persistent connection to one peer.
 
-    async def send_append_entries(self, node_id: str, request: AppendEntriesRequest) -> AppendEntriesResponse:
-        """Send AppendEntries RPC to node"""
-        if node_id not in self.node_addresses:
-            raise Exception(f"Unknown node: {node_id}")
+    Requests carry a correlation id, so several can be in flight at once.
+    A reader task resolves each caller's future as its response arrives.
+    The connection is re-established on the next call after a failure.
+    """
 
-        host, port = self.node_addresses[node_id]
+    def __init__(self, node_id: str, host: str, port: int, connect_timeout: float = 1.0):
+        self.node_id = node_id
+        self.host = host
+        self.port = port
+        self.connect_timeout = connect_timeout
+        self._reader: Optional[asyncio.StreamReader] = None
+        self._writer: Optional[asyncio.StreamWriter] = None
+        self._reader_task: Optional[asyncio.Task] = None
+        self._pending: Dict[int, asyncio.Future] = {}
+        self._next_id = 0
+        self._connect_lock = asyncio.Lock()
 
+    @property
+    def connected(self) -> bool:
+        return self._writer is not None and not self._writer.is_closing()
+
+    async def _connect(self) -> None:
+        async with self._connect_lock:
+            if self.connected:
+                return
+            self._reader, self._writer = await asyncio.wait_for(
+                asyncio.open_connection(self.host, self.port), self.connect_timeout)
+            sock = self._writer.get_extra_info('socket')
+            if sock is not None:
+                sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            self._reader_task = asyncio.create_task(self._read_loop(self._reader))
+
+    async def _read_loop(self, reader: asyncio.StreamReader) -> None:
+        error: Exception = TransportError(f"Connection to {self.node_id} closed")
+        try:
+            while True:
+                length, kind, correlation_id = FRAME_HEADER.unpack(await reader.readexactly(FRAME_HEADER.size))
+                body = await reader.readexactly(length)
+                future = self._pending.pop(correlation_id, None)
+                if future is not None and not future.done():
+                    future.set_result((kind, body))
+        except asyncio.CancelledError:
+            raise
+        except Exception as e:
+            error = TransportError(f"Connection to {self.node_id} lost: {e}")
+        finally:
+            self._drop(error)
+
+    def _drop(self, error: Exception) -> None:
+        """Fail every in-flight call and forget the connection"""
+        if self._writer is not None:
+            self._writer.close()
+        self._reader = self._writer = None
+        pending, self._pending = self._pending, {}
+        for future in pending.values():
+            if not future.done():
+                future.set_exception(error)
+
+    async def call(self, kind: int, body: bytes, timeout: float) -> Tuple[int, bytes]:
+        """Send one request frame and wait for its response frame"""
+        if not self.connected:
+            await self._connect()
+        self._next_id = (self._next_id + 1) & 0xFFFFFFFF
+        correlation_id = self._next_id
+        future = asyncio.get_running_loop().create_future()
+        self._pending[correlation_id] = future
         try:
-            sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-            sock.settimeout(5.0)
-            sock.connect((host, port))
+            self._writer.write(FRAME_HEADER.pack(len(body), kind, correlation_id) + body)
+            await self._writer.drain()
+            return await asyncio.wait_for(future, timeout)
+        except asyncio.TimeoutError:
+            raise TransportError(f"RPC to {self.node_id} timed out")
+        finally:
+            self._pending.pop(correlation_id, None)
 
-            request_data = pickle.dumps({
-                'type': 'append_entries',
-                'data': request.to_bytes()
-            }, protocol=pickle.HIGHEST_PROTOCOL)
-            request_length = struct.pack('!I', len(request_data))
+    def close(self) -> None:
+        if self._reader_task is not None:
+            self._reader_task.cancel()
+        self._drop(TransportError(f"Connection to {self.node_id} closed"))
 
-            sock.sendall(request_length + request_data)
 
-            length_data = sock.recv(4)
-            if not length_data or len(length_data) != 4:
-                raise Exception("Invalid response length")
+class NetworkTransport:
+    """
+    Network transport layer.
 
-            response_length = struct.unpack('!I', length_data)[0]
-            response_data = sock.recv(response_length)
+    Each peer gets one persistent TCP connection carrying binary frames
+    (see ``FRAME_HEADER``), so AppendEntries can be pipelined. Incoming
+    frames on a connection are handled in order, which is what Raft
+    expects from a pipelined follower.
+    """
 
-            if not response_data:
-                raise Exception("Empty response")
+    def __init__(self, node_id: str, host: str = 'localhost', port: int = 0,
+                 rpc_timeout: float = 1.0, connect_timeout: float = 1.0):
+        self.node_id = node_id
+        self.host = host
+        self.port = port
+        self.rpc_timeout = rpc_timeout
+        self.connect_timeout = connect_timeout
+        self.server: Optional[asyncio.AbstractServer] = None
+        self.node_addresses: Dict[str, Tuple[str, int]] = {}
+        self.peers: Dict[str, PeerConnection] = {}
+        self.logger = logging.getLogger(f"NetworkTransport-{node_id}")
+        self._message_handlers: Dict[str, Callable] = {}
+        self._server_connections: Set[asyncio.StreamWriter] = set()
+        self._running = False
 
-            response = pickle.loads(response_data)
-            if isinstance(response, dict) and 'error' in response:
-                raise Exception(response['error'])
+    async def initialize(self):
+        """Initialize the transport layer"""
+        self.server = await asyncio.start_server(self._serve, self.host, self.port)
+        self.port = self.server.sockets[0].getsockname()[1]
+        self._running = True
+        self.logger.info(f"Network transport initialized on {self.host}:{self.port}")
 
-            return AppendEntriesResponse.from_bytes(response_data)
+    async def _serve(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter) -> None:
+        """Answer frames from one peer, in arrival order"""
+        sock = writer.get_extra_info('socket')
+        if sock is not None:
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self._server_connections.add(writer)
+        try:
+            while self._running:
+                length, kind, correlation_id = FRAME_HEADER.unpack(await reader.readexactly(FRAME_HEADER.size))
+                if length > MAX_FRAME_SIZE:
+                    raise TransportError(f"Frame of {length} bytes exceeds limit")
+                body = await reader.readexactly(length)
+                reply_kind, reply = await self._handle_frame(kind, body, str(correlation_id))
+                writer.write(FRAME_HEADER.pack(len(reply), reply_kind, correlation_id) + reply)
+                await writer.drain()
+        except (asyncio.IncompleteReadError, ConnectionError, asyncio.CancelledError):
+            # Peer went away, or the transport is shutting down
+            pass
+        except Exception as e:
+            self.logger.error(f"Error serving peer connection: {e}")
+        finally:
+            self._server_connections.discard(writer)
+            writer.close()
+
+    async def _handle_frame(self, kind: int, body: bytes, request_id: str) -> Tuple[int, bytes]:
+        """Decode a request frame, run its handler and encode the reply"""
+        if kind == FRAME_APPEND_ENTRIES:
+            message_type, request_class, reply_kind = 'append_entries', AppendEntriesRequest, FRAME_APPEND_ENTRIES_RESPONSE
+        elif kind == FRAME_REQUEST_VOTE:
+            message_type, request_class, reply_kind = 'request_vote', RequestVoteRequest, FRAME_REQUEST_VOTE_RESPONSE
+        else:
+            return FRAME_ERROR, f"Unknown frame kind: {kind}".encode('utf-8')
 
+        handler = self._message_handlers.get(message_type)
+        if handler is None:
+            return FRAME_ERROR, f"Unknown message type: {message_type}".encode('utf-8')
+        try:
+            response = await handler(request_class.from_bytes(body, request_id))
+            return reply_kind, response.to_bytes()
+        except Exception as e:
+            self.logger.error(f"Error handling {message_type} message: {e}")
+            return FRAME_ERROR, str(e).encode('utf-8')
+
+    def _peer(self, node_id: str) -> PeerConnection:
+        peer = self.peers.get(node_id)
+        if peer is None:
+            if node_id not in self.node_addresses:
+                raise TransportError(f"Unknown node: {node_id}")
+            host, port = self.node_addresses[node_id]
+            peer = self.peers[node_id] = PeerConnection(node_id, host, port, self.connect_timeout)
+        return peer
+
+    async def _call(self, node_id: str, kind: int, request: RPCRequest, response_class, expected: int,
+                    timeout: Optional[float]):
+        reply_kind, body = await self._peer(node_id).call(
+            kind, request.to_bytes(), self.rpc_timeout if timeout is None else timeout)
+        if reply_kind == FRAME_ERROR:
+            raise TransportError(body.decode('utf-8', 'replace'))
+        if reply_kind != expected:
+            raise TransportError(f"Unexpected reply frame {reply_kind} from {node_id}")
+        return response_class.from_bytes(body, request.request_id)
+
+    async def send_append_entries(self, node_id: str, request: AppendEntriesRequest,
+                                  timeout: Optional[float] = None) -> AppendEntriesResponse:
+        """Send AppendEntries RPC to node"""
+        try:
+            return await self._call(node_id, FRAME_APPEND_ENTRIES, request, AppendEntriesResponse,
+                                    FRAME_APPEND_ENTRIES_RESPONSE, timeout)
         except Exception as e:
-            self.logger.error(f"Failed to send AppendEntries to {node_id}: {e}")
+            self.logger.debug(f"Failed to send AppendEntries to {node_id}: {e}")
             raise
-        finally:
-            try:
-                sock.close()
-            except:
-                pass
 
-    async def send_request_vote(self, node_id: str, request: RequestVoteRequest) -> RequestVoteResponse:
+    async def send_request_vote(self, node_id: str, request: RequestVoteRequest,
+                                timeout: Optional[float] = None) -> RequestVoteResponse:
         """Send RequestVote RPC to node"""
-        if node_id not in self.node_addresses:
-            raise Exception(f"Unknown node: {node_id}")
-
-        host, port = self.node_addresses[node_id]
-
         try:
-            sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
-            sock.settimeout(5.0)
-            sock.connect((host, port))
-
-            request_data = pickle.dumps({
-                'type': 'request_vote',
-                'data': request.to_bytes()
-            }, protocol=pickle.HIGHEST_PROTOCOL)
-            request_length = struct.pack('!I', len(request_data))
-
-            sock.sendall(request_length + request_data)
-
-            length_data = sock.recv(4)
-            if not length_data or len(length_data) != 4:
-                raise Exception("Invalid response length")
-
-            response_length = struct.unpack('!I', length_data)[0]
-            response_data = sock.recv(response_length)
-
-            if not response_data:
-                raise Exception("Empty response")
-
-            response = pickle.loads(response_data)
-            if isinstance(response, dict) and 'error' in response:
-                raise Exception(response['error'])
-
-            return RequestVoteResponse.from_bytes(response_data)
-
+            return await self._call(node_id, FRAME_REQUEST_VOTE, request, RequestVoteResponse,
+                                    FRAME_REQUEST_VOTE_RESPONSE, timeout)
         except Exception as e:
-            self.logger.error(f"Failed to send RequestVote to {node_id}: {e}")
+            self.logger.debug(f"Failed to send RequestVote to {node_id}: {e}")
             raise
-        finally:
-            try:
-                sock.close()
-            except:
-                pass
 
     async def broadcast_append_entries(self, requests: Dict[str, AppendEntriesRequest]) -> Dict[str, AppendEntriesResponse]:
         """Broadcast AppendEntries to multiple nodes"""
-        tasks = []
-        for node_id, request in requests.items():
-            task = asyncio.create_task(self.send_append_entries(node_id, request))
-            tasks.append((node_id, task))
+        node_ids = list(requests)
+        responses = await asyncio.gather(
+            *(self.send_append_entries(node_id, requests[node_id]) for node_id in node_ids),
+            return_exceptions=True)
 
         results = {}
-        for node_id, task in tasks:
-            try:
-                response = await task
-                results[node_id] = response
-            except Exception as e:
-                self.logger.error(f"Broadcast failed for {node_id}: {e}")
-                results[node_id] = AppendEntriesResponse(
+        for node_id, response in zip(node_ids, responses):
+            if isinstance(response, BaseException):
+                self.logger.error(f"Broadcast failed for {node_id}: {response}")
+                response = AppendEntriesResponse(
                     term=0,
                     success=False,
                     match_index=0,
                     request_id=requests[node_id].request_id,
-                    error_message=str(e)
+                    error_message=str(response)
                 )
-
+            results[node_id] = response
         return results
 
     async def broadcast_request_vote(self, requests: Dict[str, RequestVoteRequest]) -> Dict[str, RequestVoteResponse]:
         """Broadcast RequestVote to multiple nodes"""
-        tasks = []
-        for node_id, request in requests.items():
-            task = asyncio.create_task(self.send_request_vote(node_id, request))
-            tasks.append((node_id, task))
+        node_ids = list(requests)
+        responses = await asyncio.gather(
+            *(self.send_request_vote(node_id, requests[node_id]) for node_id in node_ids),
+            return_exceptions=True)
 
         results = {}
-        for node_id, task in tasks:
-            try:
-                response = await task
-                results[node_id] = response
-            except Exception as e:
-                self.logger.error(f"Vote broadcast failed for {node_id}: {e}")
-                results[node_id] = RequestVoteResponse(
+        for node_id, response in zip(node_ids, responses):
+            if isinstance(response, BaseException):
+                self.logger.error(f"Vote broadcast failed for {node_id}: {response}")
+                response = RequestVoteResponse(
                     term=0,
                     vote_granted=False,
                     request_id=requests[node_id].request_id
                 )
-
+            results[node_id] = response
         return results
 
     def add_node(self, node_id: str, host: str, port: int):
         """Add node address to registry"""
         self.node_addresses[node_id] = (host, port)
+        peer = self.peers.pop(node_id, None)
+        if peer is not None:
+            peer.close()
 
     def remove_node(self, node_id: str):
         """Remove node from registry"""
         self.node_addresses.pop(node_id, None)
+        peer = self.peers.pop(node_id, None)
+        if peer is not None:
+            peer.close()
 
     def register_message_handler(self, message_type: str, handler: Callable):
-        """Register message handler"""
+        """Register message handler; it receives and returns RPC dataclasses"""
         self._message_handlers[message_type] = handler
 
     def shutdown(self):
         """Shutdown the transport layer"""
         self._running = False
-        if self.server_socket:
-            try:
-                self.server_socket.close()
-            except:
-                pass
+        if self.server:
+            self.server.close()
+        for writer in list(self._server_connections):
+            writer.close()
+        for peer in self.peers.values():
+            peer.close()
+        self.peers.clear()
 
 
 class RaftNode:
@@ -626,14 +808,20 @@ class RaftNode:
         self.running = False
         self.logger = logging.getLogger(f"RaftNode-{node_id}")
 
+        # Replication: one pipelined replicator task per follower
+        self.max_batch_entries = 512
+        self.max_inflight = 8
+        self._replicators: Dict[str, asyncio.Task] = {}
+        self._replication_wakeup: Dict[str, asyncio.Event] = {}
+        self._commit_waiters: Dict[int, asyncio.Future] = {}
+
         self._election_timer_task: Optional[asyncio.Task] = None
-        self._heartbeat_task: Optional[asyncio.Task] = None
-        self._log_replication_task: Optional[asyncio.Task] = None
 
         for node in cluster_nodes:
             if node != node_id:
                 self.next_index[node] = 1
                 self.match_index[node] = 0
+        self.match_index[node_id] = 0
 
     def _random_election_timeout(self) -> float:
         """Generate random election timeout between 150-300ms"""
@@ -668,10 +856,8 @@ class RaftNode:
 
         if self._election_timer_task:
             self._election_timer_task.cancel()
-        if self._heartbeat_task:
-            self._heartbeat_task.cancel()
-        if self._log_replication_task:
-            self._log_replication_task.cancel()
+        self._stop_replicators()
+        self._fail_commit_waiters()
 
         self.transport.shutdown()
 
@@ -711,8 +897,8 @@ class RaftNode:
         self.logger.info(f"Starting election for term {self.current_term}")
 
         vote_requests = {}
-        last_log_index = await self.storage.get_last_log_index()
-        last_log_term = await self.storage.get_last_log_term()
+        last_log_index = len(self.log)
+        last_log_term = self.log[-1].term if self.log else 0
 
         for node in self.cluster_nodes:
             if node != self.node_id:
@@ -751,113 +937,124 @@ class RaftNode:
         """Run leader role logic"""
         self.logger.info("Running as leader")
 
-        if not self._heartbeat_task or self._heartbeat_task.done():
-            self._heartbeat_task = asyncio.create_task(self._send_heartbeats())
-
-        while self.running and self.role == NodeRole.LEADER:
-            try:
-                await self._replicate_log()
-                await asyncio.sleep(self.heartbeat_interval)
-            except Exception as e:
-                self.logger.error(f"Leader error: {e}")
-                await self._become_follower()
-                break
-
-    async def _send_heartbeats(self):
-        """Send heartbeats to all followers"""
-        while self.running and self.role == NodeRole.LEADER:
-            try:
-                heartbeat_requests = {}
-                for node in self.cluster_nodes:
-                    if node != self.node_id:
-                        request = AppendEntriesRequest(
-                            term=self.current_term,
-                            leader_id=self.node_id,
-                            prev_log_index=await self.storage.get_last_log_index(),
-                            prev_log_term=await self.storage.get_last_log_term(),
-                            entries=[],
-                            leader_commit=self.commit_index
-                        )
-                        heartbeat_requests[node] = request
-
-                if heartbeat_requests:
-                    responses = await self.transport.broadcast_append_entries(heartbeat_requests)
-
-                    for node_id, response in responses.items():
-                        if not response.success:
-                            if response.term > self.current_term:
-                                await self._step_down(response.term)
-                                return
-
-                            if node_id in self.next_index:
-                                self.next_index[node_id] = max(1, self.next_index[node_id] - 1)
-
-                await asyncio.sleep(self.heartbeat_interval)
+        for node in self.cluster_nodes:
+            if node != self.node_id:
+                task = self._replicators.get(node)
+                if task is None or task.done():
+                    self._replicators[node] = asyncio.create_task(self._replicate_to(node))
 
-            except asyncio.CancelledError:
-                break
-            except Exception as e:
-                self.logger.error(f"Heartbeat error: {e}")
+        try:
+            while self.running and self.role == NodeRole.LEADER:
                 await asyncio.sleep(self.heartbeat_interval)
+        finally:
+            self._stop_replicators()
+
+    def _stop_replicators(self) -> None:
+        for task in self._replicators.values():
+            task.cancel()
+        self._replicators.clear()
+
+    def _wake_replicators(self) -> None:
+        for event in self._replication_wakeup.values():
+            event.set()
+
+    def _append_request(self, node: str) -> AppendEntriesRequest:
+        """AppendEntries carrying the next batch of the log tail for ``node``"""
+        prev_log_index = self.next_index[node] - 1
+        prev_log_term = self.log[prev_log_index - 1].term if prev_log_index > 0 else 0
+        return AppendEntriesRequest(
+            term=self.current_term,
+            leader_id=self.node_id,
+            prev_log_index=prev_log_index,
+            prev_log_term=prev_log_term,
+            entries=self.log[prev_log_index:prev_log_index + self.max_batch_entries],
+            leader_commit=self.commit_index
+        )
 
-    async def _replicate_log(self):
-        """Replicate log entries to followers"""
-        if not self.running or self.role != NodeRole.LEADER:
-            return
+    async def _replicate_to(self, node: str):
+        """
+        Replicate the log to one follower.
+
+        Sends only the entries from ``next_index`` on, in batches of up to
+        ``max_batch_entries``. ``next_index`` advances as soon as a batch is
+        sent, so up to ``max_inflight`` requests can be outstanding. With
+        nothing to send, an empty AppendEntries goes out every
+        ``heartbeat_interval``. A rejection or error drops the pipeline and
+        resumes from what the follower confirmed.
+        """
+        inflight: deque = deque()
+        wakeup = self._replication_wakeup.setdefault(node, asyncio.Event())
+        last_sent = 0.0
+
+        def reset_pipeline():
+            while inflight:
+                inflight.popleft()[0].cancel()
 
-        for node in self.cluster_nodes:
-            if node != self.node_id:
-                next_idx = self.next_index[node]
-
-                if next_idx <= len(self.log):
-                    entries_to_send = self.log[next_idx-1:] if next_idx <= len(self.log) else []
+        try:
+            while self.running and self.role == NodeRole.LEADER:
+                while len(inflight) < self.max_inflight and (
+                        self.next_index[node] <= len(self.log) or
+                        (not inflight and time.monotonic() - last_sent >= self.heartbeat_interval)):
+                    request = self._append_request(node)
+                    count = len(request.entries)
+                    inflight.append((asyncio.ensure_future(self.transport.send_append_entries(node, request)),
+                                     request.prev_log_index, count))
+                    self.next_index[node] = request.prev_log_index + count + 1
+                    last_sent = time.monotonic()
+
+                if not inflight:
+                    wakeup.clear()
+                    remaining = self.heartbeat_interval - (time.monotonic() - last_sent)
+                    try:
+                        await asyncio.wait_for(wakeup.wait(), max(remaining, 0))
+                    except asyncio.TimeoutError:
+                        pass
+                    continue
 
-                    prev_log_index = next_idx - 1
-                    prev_log_term = 0
-                    if prev_log_index > 0 and prev_log_index <= len(self.log):
-                        prev_log_term = self.log[prev_log_index - 1].term
+                future, prev_index, count = inflight.popleft()
+                try:
+                    response = await future
+                except Exception as e:
+                    self.logger.debug(f"Log replication failed for {node}: {e}")
+                    reset_pipeline()
+                    self.next_index[node] = self.match_index[node] + 1
+                    await asyncio.sleep(self.heartbeat_interval)
+                    continue
 
-                    request = AppendEntriesRequest(
-                        term=self.current_term,
-                        leader_id=self.node_id,
-                        prev_log_index=prev_log_index,
-                        prev_log_term=prev_log_term,
-                        entries=entries_to_send,
-                        leader_commit=self.commit_index
-                    )
+                if response.term > self.current_term:
+                    reset_pipeline()
+                    await self._step_down(response.term)
+                    return
 
-                    try:
-                        response = await self.transport.send_append_entries(node, request)
-
-                        if response.success:
-                            self.match_index[node] = prev_log_index + len(entries_to_send)
-                            self.next_index[node] = self.match_index[node] + 1
-                            await self._update_commit_index()
-                        else:
-                            if response.term > self.current_term:
-                                await self._step_down(response.term)
-                                return
-                            self.next_index[node] = max(1, self.next_index[node] - 1)
-
-                    except Exception as e:
-                        self.logger.error(f"Log replication failed for {node}: {e}")
-                        self.next_index[node] = max(1, self.next_index[node] - 1)
+                if response.success:
+                    if prev_index + count > self.match_index[node]:
+                        self.match_index[node] = prev_index + count
+                        await self._update_commit_index()
+                else:
+                    # The follower's log diverges before prev_index: back up to its hint
+                    reset_pipeline()
+                    self.next_index[node] = max(1, min(prev_index, response.match_index + 1))
+        finally:
+            reset_pipeline()
 
     async def _update_commit_index(self):
         """Update commit index based on majority replication"""
         if not self.running or self.role != NodeRole.LEADER:
             return
 
-        match_indices = sorted([self.match_index[node] for node in self.cluster_nodes if node != self.node_id])
-        match_indices.append(self.match_index[self.node_id])
-
-        if len(match_indices) > 0:
-            median_index = match_indices[len(match_indices) // 2]
-
-            if median_index > self.commit_index:
-                if median_index <= len(self.log) and self.log[median_index - 1].term == self.current_term:
-                    self.commit_index = median_index
-                    await self._apply_committed_entries()
+        match_indices = sorted(
+            (len(self.log) if node == self.node_id else self.match_index.get(node, 0)
+             for node in self.cluster_nodes),
+            reverse=True)
+        if not match_indices:
+            match_indices = [len(self.log)]
+
+        # The highest index stored on a majority of the cluster
+        majority_index = match_indices[len(match_indices) // 2]
+        if majority_index > self.commit_index:
+            if majority_index <= len(self.log) and self.log[majority_index - 1].term == self.current_term:
+                self.commit_index = majority_index
+                await self._apply_committed_entries()
 
     async def _apply_committed_entries(self):
         """Apply committed log entries to state machine"""
@@ -867,6 +1064,17 @@ class RaftNode:
             await self._apply_to_state_machine(entry.command)
             self.logger.debug(f"Applied log entry {self.last_applied}")
 
+            waiter = self._commit_waiters.pop(self.last_applied, None)
+            if waiter is not None and not waiter.done():
+                waiter.set_result(True)
+
+    def _fail_commit_waiters(self) -> None:
+        """Resolve pending commit waits as failed, e.g. after losing leadership"""
+        waiters, self._commit_waiters = self._commit_waiters, {}
+        for waiter in waiters.values():
+            if not waiter.done():
+                waiter.set_result(False)
+
     async def _apply_to_state_machine(self, command: Any):
         """Apply command to state machine"""
         if isinstance(command, dict):
@@ -875,8 +1083,19 @@ class RaftNode:
             if key is not None:
                 self.state_machine[key] = value
 
-    async def append_entry(self, command: Any, client_id: str = None) -> bool:
-        """Append entry to log (only leader can do this)"""
+    async def append_entry(self, command: Any, client_id: str = None, wait_for_commit: bool = False) -> bool:
+        """
+        Append entry to log (only leader can do this).
+
+        Args:
+            command: Command for the state machine
+            client_id: Submitting client
+            wait_for_commit: Return only once the entry is committed and applied
+
+        Returns:
+            True if appended (and, when waiting, committed)
+        """
+        waiter = None
         async with self.lock:
             if self.role != NodeRole.LEADER:
                 return False
@@ -892,9 +1111,19 @@ class RaftNode:
             self.log.append(entry)
             await self.storage.append_log_entry(entry)
             self.match_index[self.node_id] = len(self.log)
+            if wait_for_commit:
+                waiter = asyncio.get_running_loop().create_future()
+                self._commit_waiters[entry.index] = waiter
 
             self.logger.debug(f"Appended entry to log: {len(self.log)}")
+
+        # Entries appended while a batch is in flight go out together in the next one
+        self._wake_replicators()
+        if len(self.cluster_nodes) <= 1:
+            await self._update_commit_index()
+        if waiter is None:
             return True
+        return await waiter
 
     async def _become_candidate(self):
         """Transition to candidate role"""
@@ -915,6 +1144,7 @@ class RaftNode:
                 if node != self.node_id:
                     self.next_index[node] = len(self.log) + 1
                     self.match_index[node] = 0
+            self.match_index[self.node_id] = len(self.log)
 
     async def _become_follower(self):
         """Transition to follower role"""
@@ -922,6 +1152,7 @@ class RaftNode:
             self.role = NodeRole.FOLLOWER
             self.voted_for = None
             await self.storage.set_voted_for(None)
+        self._fail_commit_waiters()
 
     async def _step_down(self, term: int):
         """Step down to follower due to higher term"""
@@ -933,23 +1164,22 @@ class RaftNode:
                 await self.storage.set_current_term(term)
                 await self.storage.set_voted_for(None)
                 self.last_heartbeat = time.time()
+        self._fail_commit_waiters()
 
-    async def handle_append_entries(self, request_data: bytes) -> bytes:
+    async def handle_append_entries(self, request: AppendEntriesRequest) -> AppendEntriesResponse:
         """Handle AppendEntries RPC"""
         try:
-            request = AppendEntriesRequest.from_bytes(request_data)
-            response = await self._process_append_entries(request)
-            return response.to_bytes()
+            return await self._process_append_entries(request)
         except Exception as e:
             self.logger.error(f"Error handling AppendEntries: {e}")
             error_response = AppendEntriesResponse(
                 term=self.current_term,
                 success=False,
                 match_index=0,
-                request_id=request.request_id if 'request' in locals() else str(uuid.uuid4()),
+                request_id=request.request_id,
                 error_message=str(e)
             )
-            return error_response.to_bytes()
+            return error_response
 
     async def _process_append_entries(self, request: AppendEntriesRequest) -> AppendEntriesResponse:
         """Process AppendEntries RPC"""
@@ -974,54 +1204,59 @@ class RaftNode:
             if request.prev_log_index > 0:
                 if (request.prev_log_index > len(self.log) or
                     self.log[request.prev_log_index - 1].term != request.prev_log_term):
+                    # match_index hints how far back the leader should retry from
                     return AppendEntriesResponse(
                         term=self.current_term,
                         success=False,
-                        match_index=0,
+                        match_index=min(len(self.log), request.prev_log_index - 1),
                         request_id=request.request_id
                     )
 
-            log_index = request.prev_log_index
-            for entry in request.entries:
-                log_index += 1
-
-                if (log_index <= len(self.log) and
-                    self.log[log_index - 1].term != entry.term):
+            # Entries we already hold (same index and term) are skipped, so
+            # overlapping or duplicated requests after a pipeline reset are
+            # idempotent; the log is truncated only at the first real conflict
+            new_entries = request.entries
+            for offset, entry in enumerate(request.entries):
+                log_index = request.prev_log_index + offset + 1
+                if log_index > len(self.log):
+                    new_entries = request.entries[offset:]
+                    break
+                if self.log[log_index - 1].term != entry.term:
                     self.log = self.log[:log_index - 1]
                     await self.storage.truncate_log_from(log_index)
+                    new_entries = request.entries[offset:]
                     break
+            else:
+                new_entries = []
 
-            for entry in request.entries:
-                if log_index > len(self.log):
-                    self.log.append(entry)
-                    await self.storage.append_log_entry(entry)
-                    log_index += 1
+            for entry in new_entries:
+                self.log.append(entry)
+                await self.storage.append_log_entry(entry)
 
+            last_verified = request.prev_log_index + len(request.entries)
             if request.leader_commit > self.commit_index:
-                self.commit_index = min(request.leader_commit, len(self.log))
+                self.commit_index = min(request.leader_commit, last_verified)
                 await self._apply_committed_entries()
 
             return AppendEntriesResponse(
                 term=self.current_term,
                 success=True,
-                match_index=len(self.log),
+                match_index=last_verified,
                 request_id=request.request_id
             )
 
-    async def handle_request_vote(self, request_data: bytes) -> bytes:
+    async def handle_request_vote(self, request: RequestVoteRequest) -> RequestVoteResponse:
         """Handle RequestVote RPC"""
         try:
-            request = RequestVoteRequest.from_bytes(request_data)
-            response = await self._process_request_vote(request)
-            return response.to_bytes()
+            return await self._process_request_vote(request)
         except Exception as e:
             self.logger.error(f"Error handling RequestVote: {e}")
             error_response = RequestVoteResponse(
                 term=self.current_term,
                 vote_granted=False,
-                request_id=request.request_id if 'request' in locals() else str(uuid.uuid4())
+                request_id=request.request_id
             )
-            return error_response.to_bytes()
+            return error_response
 
     async def _process_request_vote(self, request: RequestVoteRequest) -> RequestVoteResponse:
         """Process RequestVote RPC"""
@@ -1036,10 +1271,10 @@ class RaftNode:
                 )
 
             if (self.voted_for is None or self.voted_for == request.candidate_id):
-                last_log_term = await self.storage.get_last_log_term()
+                last_log_term = self.log[-1].term if self.log else 0
                 log_ok = (request.last_log_term > last_log_term or
                          (request.last_log_term == last_log_term and
-                          request.last_log_index >= await self.storage.get_last_log_index()))
+                          request.last_log_index >= len(self.log)))
 
                 if log_ok:
                     self.voted_for = request.candidate_id
@@ -1090,13 +1325,13 @@ class ConsensusManager:
 
         self.logger.info(f"Consensus manager shutdown for node {self.node_id}")
 
-    async def submit_command(self, command: Any, client_id: str = None) -> bool:
+    async def submit_command(self, command: Any, client_id: str = None, wait_for_commit: bool = False) -> bool:
         """Submit command to consensus system"""
         if not self.raft_node or self.raft_node.role != NodeRole.LEADER:
             self.logger.warning("Not leader, cannot accept command")
             return False
 
-        return await self.raft_node.append_entry(command, client_id)
+        return await self.raft_node.append_entry(command, client_id, wait_for_commit=wait_for_commit)
 
     def get_state_machine_value(self, key: str) -> Any:
         """Get value from state machine"""
@@ -1146,7 +1381,7 @@ class DistributedLock:
 
         try:
             success = await asyncio.wait_for(
-                self.consensus_manager.submit_command(lock_entry, holder_id),
+                self.consensus_manager.submit_command(lock_entry, holder_id, wait_for_commit=True),
                 timeout=timeout
             )
 
@@ -1177,7 +1412,7 @@ class DistributedLock:
         }
 
         try:
-            success = await self.consensus_manager.submit_command(lock_entry, holder_id)
+            success = await self.consensus_manager.submit_command(lock_entry, holder_id, wait_for_commit=True)
 
             if success:
                 self.holder = None
@@ -0,0 +1,212 @@
+"""
+Append-only segmented event log for Pyserv event sourcing.
+
+Events are written to numbered segment files in a directory. Each record
+is::
+
+    <body length: u32> <crc32 of body: u32> <meta length: u16> <meta> <payload>
+
+``meta`` is ``aggregate_id \\x1f event_type`` and ``payload`` the event
+JSON. A reader can rebuild indexes from the fixed header and the short
+meta without decoding any payloads. Writes are buffered, and ``sync()``
+fsyncs with group commit: concurrent callers share one fsync. A segment
+rolls over once it reaches ``segment_size`` and is then read through
+``mmap``. On open, a torn tail left in the last segment by a crash is
+truncated.
+"""
+
+import asyncio
+import mmap
+import os
+import struct
+import threading
+import zlib
+from pathlib import Path
+from typing import Dict, Iterator, Optional, Tuple, Union
+
+HEADER = struct.Struct('<IIH')
+META_SEPARATOR = b'\x1f'
+SEGMENT_SUFFIX = '.seg'
+
+# (segment number, offset of the record header)
+Location = Tuple[int, int]
+
+
+class EventLogCorruption(Exception):
+    """A sealed segment holds a record that fails its checksum"""
+
+
+class SegmentedEventLog:
+    """
+    Append-only event log split into segment files.
+
+    Args:
+        directory: Where segment files live
+        segment_size: Bytes after which a new segment is started
+    """
+
+    def __init__(self, directory: Union[str, Path], segment_size: int = 64 * 1024 * 1024):
+        self.directory = Path(directory)
+        self.directory.mkdir(parents=True, exist_ok=True)
+        self.segment_size = segment_size
+        self._maps: Dict[int, mmap.mmap] = {}
+        self._files: Dict[int, object] = {}
+        self._lock = threading.Lock()
+        self._sync_lock: Optional[asyncio.Lock] = None
+        self._written = 0
+        self._synced = 0
+        self._dirty = False
+
+        segments = self.segments()
+        self._active = segments[-1] if segments else 0
+        self._recover()
+        self._file = open(self._segment_path(self._active), 'ab')
+        self._position = self._file.tell()
+
+    def _segment_path(self, number: int) -> Path:
+        return self.directory / f"{number:010d}{SEGMENT_SUFFIX}"
+
+    def segments(self) -> list:
+        """Segment numbers in order"""
+        return sorted(int(p.stem) for p in self.directory.glob(f"*{SEGMENT_SUFFIX}"))
+
+    def _recover(self) -> None:
+        """Truncate a partially written record at the end of the active segment"""
+        path = self._segment_path(self._active)
+        if not path.exists():
+            return
+        with open(path, 'rb') as f:
+            data = f.read()
+        offset = 0
+        while offset + HEADER.size <= len(data):
+            length, crc, _ = HEADER.unpack_from(data, offset)
+            end = offset + HEADER.size + length
+            if end > len(data) or zlib.crc32(data[offset + HEADER.size:end]) != crc:
+                break
+            offset = end
+        if offset != len(data):
+            with open(path, 'r+b') as f:
+                f.truncate(offset)
+
+    def append(self, aggregate_id: str, event_type: str, payload: bytes) -> Location:
+        """Buffer one record; returns where it was written"""
+        meta = aggregate_id.encode('utf-8') + META_SEPARATOR + event_type.encode('utf-8')
+        body = meta + payload
+        record = HEADER.pack(len(body), zlib.crc32(body), len(meta)) + body
+        with self._lock:
+            if self._position and self._position + len(record) > self.segment_size:
+                self._roll()
+            location = (self._active, self._position)
+            self._file.write(record)
+            self._position += len(record)
+            self._written += 1
+            self._dirty = True
+        return location
+
+    def _roll(self) -> None:
+        """Seal the active segment and start the next one"""
+        self._file.flush()
+        os.fsync(self._file.fileno())
+        self._file.close()
+        self._synced = self._written
+        self._active += 1
+        self._file = open(self._segment_path(self._active), 'ab')
+        self._position = 0
+
+    def flush(self) -> None:
+        """Hand buffered records to the OS"""
+        with self._lock:
+            if self._dirty:
+                self._file.flush()
+                self._dirty = False
+
+    async def sync(self) -> None:
+        """Make everything appended so far durable, sharing fsyncs between callers"""
+        target = self._written
+        if self._synced >= target:
+            return
+        if self._sync_lock is None:
+            self._sync_lock = asyncio.Lock()
+        async with self._sync_lock:
+            if self._synced >= target:
+                return
+            with self._lock:
+                upto = self._written
+                if self._dirty:
+                    self._file.flush()
+                    self._dirty = False
+                # A roll may close the active file meanwhile; the duplicate keeps this segment open
+                fd = os.dup(self._file.fileno())
+            try:
+                await asyncio.get_running_loop().run_in_executor(None, os.fsync, fd)
+            finally:
+                os.close(fd)
+            self._synced = max(self._synced, upto)
+
+    def _view(self, segment: int):
+        """Readable bytes of a segment: an mmap when sealed, the file when active"""
+        if segment == self._active:
+            self.flush()
+            handle = self._files.get(segment)
+            if handle is None:
+                handle = self._files[segment] = open(self._segment_path(segment), 'rb')
+            return None, handle
+        view = self._maps.get(segment)
+        if view is None:
+            handle = self._files.pop(segment, None)
+            if handle is not None:
+                handle.close()
+            with open(self._segment_path(segment), 'rb') as f:
+                view = self._maps[segment] = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        return view, None
+
+    def read(self, location: Location) -> bytes:
+        """Payload of the record at ``location``"""
+        segment, offset = location
+        view, handle = self._view(segment)
+        if view is not None:
+            length, _, meta_length = HEADER.unpack_from(view, offset)
+            start = offset + HEADER.size + meta_length
+            return view[start:offset + HEADER.size + length]
+        header = os.pread(handle.fileno(), HEADER.size, offset)
+        length, _, meta_length = HEADER.unpack(header)
+        return os.pread(handle.fileno(), length - meta_length, offset + HEADER.size + meta_length)
+
+    def scan(self) -> Iterator[Tuple[Location, str, str]]:
+        """Yield ``(location, aggregate_id, event_type)`` for every record without decoding payloads"""
+        self.flush()
+        for segment in self.segments():
+            path = self._segment_path(segment)
+            if path.stat().st_size == 0:
+                continue
+            with open(path, 'rb') as f:
+                data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+            try:
+                offset, size = 0, len(data)
+                while offset + HEADER.size <= size:
+                    length, _, meta_length = HEADER.unpack_from(data, offset)
+                    if offset + HEADER.size + length > size:
+                        raise EventLogCorruption(f"Truncated record in segment {segment} at {offset}")
+                    start = offset + HEADER.size
+                    aggregate_id, _, event_type = data[start:start + meta_length].partition(META_SEPARATOR)
+                    yield (segment, offset), aggregate_id.decode('utf-8'), event_type.decode('utf-8')
+                    offset = start + length
+            finally:
+                data.close()
+
+    def close(self) -> None:
+        """Flush, fsync and release every file"""
+        with self._lock:
+            self._file.flush()
+            os.fsync(self._file.fileno())
+            self._file.close()
+            self._synced = self._written
+        for view in self._maps.values():
+            view.close()
+        for handle in self._files.values():
+            handle.close()
+        self._maps.clear()
+        self._files.clear()
+
+
+__all__ = ['EventLogCorruption', 'Location', 'SegmentedEventLog']
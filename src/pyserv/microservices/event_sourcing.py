@@ -11,14 +11,18 @@ This module provides:
 import json
 import uuid
 from abc import ABC, abstractmethod
-from typing import List, Dict, Any, Optional, Callable, Type, TypeVar, Generic
+from typing import List, Dict, Any, Optional, Callable, Type, TypeVar, Generic, Union
 from datetime import datetime
+from pathlib import Path
 from dataclasses import dataclass, field
 from concurrent.futures import ThreadPoolExecutor
 import asyncio
 import threading
 from contextlib import asynccontextmanager
 
+from pyserv.core import codec
+from .event_log import SegmentedEventLog
+
 
 T = TypeVar('T')
 
@@ -85,14 +89,72 @@ class EventStore:
     - Retrieving events for aggregates
     - Publishing events to subscribers
     - Maintaining event streams
+
+    Events are indexed per aggregate and per event type. An aggregate's
+    events sit in version order, so version ranges are slices. Given a
+    ``directory``, events and snapshots go to append-only segment logs
+    (see ``SegmentedEventLog``). The indexes then hold log locations, and
+    events are decoded only when read. Opening an existing directory
+    rebuilds the indexes from record headers alone.
+
+    Args:
+        storage_backend: Custom backend handed each event via ``_persist_event``
+        directory: Directory for the segmented event log
+        segment_size: Bytes per log segment
+        sync_writes: fsync before ``append`` returns; concurrent appends share fsyncs
     """
 
-    def __init__(self, storage_backend: Optional[Any] = None):
-        self.events: List[Event] = []
+    def __init__(self, storage_backend: Optional[Any] = None, directory: Optional[Union[str, Path]] = None,
+                 segment_size: int = 64 * 1024 * 1024, sync_writes: bool = True):
         self.subscribers: Dict[str, List[Callable[[Event], Any]]] = {}
-        self.snapshots: Dict[str, Dict[str, Any]] = {}
+        # Encoded snapshots in memory, or log locations with a directory
+        self.snapshots: Dict[str, Any] = {}
         self._lock = threading.RLock()
         self.storage_backend = storage_backend
+        self.sync_writes = sync_writes
+
+        # Entries are Event objects in memory, or log locations with a directory
+        self._log: List[Any] = []
+        self._by_aggregate: Dict[str, List[Any]] = {}
+        self._by_type: Dict[str, List[Any]] = {}
+
+        self.event_log: Optional[SegmentedEventLog] = None
+        self.snapshot_log: Optional[SegmentedEventLog] = None
+        if directory is not None:
+            directory = Path(directory)
+            self.event_log = SegmentedEventLog(directory / 'events', segment_size)
+            self.snapshot_log = SegmentedEventLog(directory / 'snapshots', segment_size)
+            self._load_indexes()
+
+    def _load_indexes(self) -> None:
+        """Rebuild indexes and the snapshot table from the logs"""
+        for location, aggregate_id, event_type in self.event_log.scan():
+            self._index(location, aggregate_id, event_type)
+        for location, aggregate_id, _ in self.snapshot_log.scan():
+            self.snapshots[aggregate_id] = location
+
+    def _index(self, entry: Any, aggregate_id: str, event_type: str) -> None:
+        self._log.append(entry)
+        self._by_aggregate.setdefault(aggregate_id, []).append(entry)
+        self._by_type.setdefault(event_type, []).append(entry)
+
+    def _read(self, entry: Any) -> Event:
+        if isinstance(entry, Event):
+            return entry
+        return Event.from_dict(codec.loads(self.event_log.read(entry)))
+
+    @property
+    def events(self) -> List[Event]:
+        """All events in append order"""
+        return self.get_events()
+
+    def _store(self, event: Event) -> None:
+        """Version, write and index one event; caller holds the lock"""
+        event.version = len(self._by_aggregate.get(event.aggregate_id, ())) + 1
+        entry: Any = event
+        if self.event_log is not None:
+            entry = self.event_log.append(event.aggregate_id, event.event_type, codec.dumps(event.to_dict()))
+        self._index(entry, event.aggregate_id, event.event_type)
 
     async def append(self, event: Event) -> bool:
         """
@@ -104,25 +166,7 @@ class EventStore:
         Returns:
             True if successful, False otherwise
         """
-        with self._lock:
-            try:
-                # Add version based on existing events for this aggregate
-                existing_events = [e for e in self.events if e.aggregate_id == event.aggregate_id]
-                event.version = len(existing_events) + 1
-
-                self.events.append(event)
-
-                # Persist to storage if available
-                if self.storage_backend:
-                    await self._persist_event(event)
-
-                # Notify subscribers
-                await self._notify_subscribers(event)
-
-                return True
-            except Exception as e:
-                print(f"Failed to append event: {e}")
-                return False
+        return await self.append_events([event])
 
     async def append_events(self, events: List[Event]) -> bool:
         """
@@ -134,24 +178,26 @@ class EventStore:
         Returns:
             True if all events appended successfully
         """
-        with self._lock:
-            try:
+        try:
+            with self._lock:
                 for event in events:
-                    existing_events = [e for e in self.events if e.aggregate_id == event.aggregate_id]
-                    event.version = len(existing_events) + 1
-                    self.events.append(event)
+                    self._store(event)
 
-                    if self.storage_backend:
-                        await self._persist_event(event)
+            if self.event_log is not None and self.sync_writes:
+                await self.event_log.sync()
 
-                # Notify subscribers for all events
+            if self.storage_backend:
                 for event in events:
-                    await self._notify_subscribers(event)
+                    await self._persist_event(event)
+
+            # Notify subscribers for all events
+            for event in events:
+                await self._notify_subscribers(event)
 
-                return True
-            except Exception as e:
-                print(f"Failed to append events: {e}")
-                return False
+            return True
+        except Exception as e:
+            print(f"Failed to append events: {e}")
+            return False
 
     def get_events(self, aggregate_id: str = None, event_type: str = None,
                    from_version: int = None, to_version: int = None) -> List[Event]:
@@ -165,24 +211,29 @@ class EventStore:
             to_version: Ending version
 
         Returns:
-            List of matching events
+            List of matching events in append order (version order per aggregate)
         """
         with self._lock:
-            events = self.events.copy()
-
             if aggregate_id:
-                events = [e for e in events if e.aggregate_id == aggregate_id]
-
-            if event_type:
-                events = [e for e in events if e.event_type == event_type]
-
-            if from_version is not None:
-                events = [e for e in events if e.version >= from_version]
-
-            if to_version is not None:
-                events = [e for e in events if e.version <= to_version]
-
-            return sorted(events, key=lambda e: (e.timestamp, e.version))
+                entries = self._by_aggregate.get(aggregate_id, [])
+                start = max((from_version or 1) - 1, 0)
+                stop = len(entries) if to_version is None else max(to_version, 0)
+                entries = entries[start:stop]
+                from_version = to_version = None
+            elif event_type:
+                entries = list(self._by_type.get(event_type, []))
+                event_type = None
+            else:
+                entries = list(self._log)
+
+        events = [self._read(entry) for entry in entries]
+        if event_type:
+            events = [e for e in events if e.event_type == event_type]
+        if from_version is not None or to_version is not None:
+            low = from_version if from_version is not None else 1
+            high = to_version if to_version is not None else float('inf')
+            events = [e for e in events if low <= e.version <= high]
+        return events
 
     def get_aggregate_events(self, aggregate_id: str) -> List[Event]:
         """Get all events for a specific aggregate"""
@@ -192,6 +243,10 @@ class EventStore:
         """Get complete event stream for an aggregate"""
         return self.get_aggregate_events(aggregate_id)
 
+    def get_version(self, aggregate_id: str) -> int:
+        """Current version of an aggregate (0 if it has no events)"""
+        return len(self._by_aggregate.get(aggregate_id, ()))
+
     async def subscribe(self, event_type: str, callback: Callable[[Event], Any]) -> None:
         """
         Subscribe to events of a specific type.
@@ -248,12 +303,17 @@ class EventStore:
             state: Current state of the aggregate
             version: Version at which snapshot was taken
         """
+        # Encoded now, so events applied to the live state later cannot change the snapshot
+        data = codec.dumps({
+            'state': state,
+            'version': version,
+            'timestamp': datetime.now()
+        })
         with self._lock:
-            self.snapshots[aggregate_id] = {
-                'state': state,
-                'version': version,
-                'timestamp': datetime.now()
-            }
+            if self.snapshot_log is not None:
+                self.snapshots[aggregate_id] = self.snapshot_log.append(aggregate_id, 'snapshot', data)
+            else:
+                self.snapshots[aggregate_id] = data
 
     def get_snapshot(self, aggregate_id: str) -> Optional[Dict[str, Any]]:
         """
@@ -265,13 +325,25 @@ class EventStore:
         Returns:
             Snapshot data or None if no snapshot exists
         """
-        return self.snapshots.get(aggregate_id)
+        snapshot = self.snapshots.get(aggregate_id)
+        if snapshot is None:
+            return None
+        # Decoded per call, so a restored aggregate never shares objects with the store
+        snapshot = codec.loads(snapshot if isinstance(snapshot, bytes) else self.snapshot_log.read(snapshot))
+        snapshot['timestamp'] = datetime.fromisoformat(snapshot['timestamp'])
+        return snapshot
 
     def get_event_count(self, aggregate_id: str = None) -> int:
         """Get total number of events, optionally for specific aggregate"""
         if aggregate_id:
-            return len([e for e in self.events if e.aggregate_id == aggregate_id])
-        return len(self.events)
+            return len(self._by_aggregate.get(aggregate_id, ()))
+        return len(self._log)
+
+    def close(self) -> None:
+        """Flush and close the on-disk logs"""
+        if self.event_log is not None:
+            self.event_log.close()
+            self.snapshot_log.close()
 
 
 class Aggregate(ABC):
@@ -316,16 +388,38 @@ class Aggregate(ABC):
         if hasattr(self, handler_name):
             handler = getattr(self, handler_name)
             handler(event)
-            self.version = event.version
         else:
             # Generic event application
             self._apply_generic_event(event)
+        self.version = event.version
 
     def _apply_generic_event(self, event: Event) -> None:
         """Generic event application logic"""
         # Override in subclasses for custom logic
         pass
 
+    def snapshot_state(self) -> Dict[str, Any]:
+        """
+        State to store in a snapshot.
+
+        By default every public attribute except the identity, version and
+        pending events. Override when state is not JSON-serialisable as is.
+        """
+        excluded = {'aggregate_id', 'version', 'uncommitted_events'}
+        return {k: v for k, v in vars(self).items() if not k.startswith('_') and k not in excluded}
+
+    def restore_snapshot(self, state: Dict[str, Any], version: int) -> None:
+        """
+        Restore state produced by ``snapshot_state``.
+
+        Args:
+            state: Snapshot state
+            version: Version the snapshot was taken at
+        """
+        for key, value in state.items():
+            setattr(self, key, value)
+        self.version = version
+
     async def load_from_events(self, events: List[Event]) -> None:
         """
         Load aggregate state from a list of events.
@@ -340,10 +434,16 @@ class Aggregate(ABC):
         """
         Load aggregate state from event store history.
 
+        Starts from the latest snapshot, if any, and replays only the
+        events recorded after it.
+
         Args:
             event_store: Event store to load events from
         """
-        events = event_store.get_aggregate_events(self.aggregate_id)
+        snapshot = event_store.get_snapshot(self.aggregate_id)
+        if snapshot is not None:
+            self.restore_snapshot(snapshot['state'], snapshot['version'])
+        events = event_store.get_events(aggregate_id=self.aggregate_id, from_version=self.version + 1)
         await self.load_from_events(events)
 
     def get_uncommitted_events(self) -> List[Event]:
@@ -417,13 +517,14 @@ class Repository(Generic[T]):
     abstracting away the event store implementation details.
     """
 
-    def __init__(self, event_store: EventStore, aggregate_class: Type[T]):
+    def __init__(self, event_store: EventStore, aggregate_class: Type[T], snapshot_every: Optional[int] = None):
         self.event_store = event_store
         self.aggregate_class = aggregate_class
+        self.snapshot_every = snapshot_every
 
     async def load(self, aggregate_id: str) -> T:
         """
-        Load an aggregate from event store.
+        Load an aggregate from event store, starting at its latest snapshot.
 
         Args:
             aggregate_id: ID of the aggregate to load
@@ -452,9 +553,18 @@ class Repository(Generic[T]):
         success = await self.event_store.append_events(events)
         if success:
             aggregate.mark_changes_as_committed()
+            aggregate.version = events[-1].version
+            if self.snapshot_every and self._crossed_snapshot(events):
+                self.event_store.create_snapshot(
+                    aggregate.aggregate_id, aggregate.snapshot_state(), aggregate.version)
 
         return success
 
+    def _crossed_snapshot(self, events: List[Event]) -> bool:
+        """Whether this save passed a multiple of ``snapshot_every``"""
+        last = events[-1].version
+        return last // self.snapshot_every > (last - len(events)) // self.snapshot_every
+
     async def exists(self, aggregate_id: str) -> bool:
         """
         Check if an aggregate exists.
@@ -465,8 +575,7 @@ class Repository(Generic[T]):
         Returns:
             True if aggregate exists
         """
-        events = self.event_store.get_aggregate_events(aggregate_id)
-        return len(events) > 0
+        return self.event_store.get_event_count(aggregate_id) > 0
 
 
 class EventPublisher:
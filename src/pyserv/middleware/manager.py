@@ -14,6 +14,7 @@ This module provides an advanced middleware management system with:
 """
 
 import asyncio
+import inspect
 import logging
 import time
 import uuid
@@ -23,6 +24,8 @@ from enum import Enum
 from functools import wraps
 from contextlib import asynccontextmanager
 
+from pyserv.http.response import Response
+
 logger = logging.getLogger(__name__)
 
 
@@ -63,8 +66,10 @@ class MiddlewareInfo:
     phases: List[MiddlewarePhase] = field(default_factory=lambda: [MiddlewarePhase.REQUEST, MiddlewarePhase.RESPONSE])
     enabled: bool = True
     config: Dict[str, Any] = field(default_factory=dict)
+    # Total time of the timed_count sampled calls out of execution_count
     execution_time: float = 0.0
     execution_count: int = 0
+    timed_count: int = 0
     error_count: int = 0
     last_error: Optional[str] = None
 
@@ -94,15 +99,32 @@ class RequestContext:
 
 
 class MiddlewareManager:
-    """Advanced middleware manager with comprehensive features"""
-
-    def __init__(self):
+    """
+    Advanced middleware manager with comprehensive features
+
+    Registered middleware are compiled into flat, pre-filtered chains per
+    phase whenever they are added, removed, enabled or disabled, so a request
+    only touches the middleware that will actually run. HTTP middleware
+    registered for the request phase form an onion around the endpoint and
+    are called as ``middleware(request, call_next)``; middleware registered
+    only for the response phase are called afterwards as
+    ``middleware(request, response)``.
+
+    Per-middleware timing is sampled on one request in ``timing_sample_rate``
+    and request contexts are released as soon as their request finishes.
+    """
+
+    def __init__(self, timing_sample_rate: int = 64):
         self.http_middlewares: List[MiddlewareInfo] = []
         self.websocket_middlewares: List[MiddlewareInfo] = []
         self.middleware_cache: Dict[str, Any] = {}
         self.request_contexts: Dict[str, RequestContext] = {}
+        self.timing_sample_rate = max(1, timing_sample_rate)
         self._performance_stats: Dict[str, Dict[str, Any]] = {}
         self._enabled = True
+        self._sample_counter = 0
+        self._chains: Dict[Tuple[MiddlewareType, MiddlewarePhase], Tuple[MiddlewareInfo, ...]] = {}
+        self._rebuild_chains()
 
     def add(self, middleware: Union[Callable, Type], priority: MiddlewarePriority = MiddlewarePriority.NORMAL,
             middleware_type: MiddlewareType = MiddlewareType.HTTP,
@@ -148,6 +170,7 @@ class MiddlewareManager:
         # Sort by priority (highest first)
         self.http_middlewares.sort(key=lambda m: m.priority.value, reverse=True)
         self.websocket_middlewares.sort(key=lambda m: m.priority.value, reverse=True)
+        self._rebuild_chains()
 
         logger.info(f"Added middleware {name} with priority {priority.value}")
 
@@ -163,29 +186,29 @@ class MiddlewareManager:
                     break
 
         if removed:
+            self._rebuild_chains()
             logger.info(f"Removed middleware {name}")
 
         return removed
 
     def enable(self, name: str) -> bool:
         """Enable middleware"""
-        for middleware_list in [self.http_middlewares, self.websocket_middlewares]:
-            for middleware in middleware_list:
-                if middleware.name == name:
-                    middleware.enabled = True
-                    logger.info(f"Enabled middleware {name}")
-                    return True
-        return False
+        return self._set_enabled(name, True)
 
     def disable(self, name: str) -> bool:
         """Disable middleware"""
-        for middleware_list in [self.http_middlewares, self.websocket_middlewares]:
-            for middleware in middleware_list:
-                if middleware.name == name:
-                    middleware.enabled = False
-                    logger.info(f"Disabled middleware {name}")
-                    return True
-        return False
+        return self._set_enabled(name, False)
+
+    def _set_enabled(self, name: str, enabled: bool) -> bool:
+        """Toggle middleware by name and recompile the chains"""
+        middleware = self.get_middleware(name)
+        if middleware is None:
+            return False
+
+        middleware.enabled = enabled
+        self._rebuild_chains()
+        logger.info(f"{'Enabled' if enabled else 'Disabled'} middleware {name}")
+        return True
 
     def get_middleware(self, name: str) -> Optional[MiddlewareInfo]:
         """Get middleware by name"""
@@ -195,119 +218,113 @@ class MiddlewareManager:
                     return middleware
         return None
 
-    async def process_http_request(self, request) -> Any:
-        """Process HTTP request through middleware pipeline"""
-        if not self._enabled:
-            return request
+    def _rebuild_chains(self) -> None:
+        """Compile the enabled middleware of each phase into call order"""
+        chains = {}
+        for middleware_type, middleware_list in [(MiddlewareType.HTTP, self.http_middlewares),
+                                                 (MiddlewareType.WEBSOCKET, self.websocket_middlewares)]:
+            for phase in MiddlewarePhase:
+                chains[(middleware_type, phase)] = tuple(
+                    m for m in middleware_list if m.enabled and phase in m.phases
+                )
+
+        # Request-phase middleware already see the response through call_next,
+        # so only response-only middleware run as response hooks (innermost first)
+        chains[(MiddlewareType.HTTP, MiddlewarePhase.RESPONSE)] = tuple(reversed([
+            m for m in chains[(MiddlewareType.HTTP, MiddlewarePhase.RESPONSE)]
+            if MiddlewarePhase.REQUEST not in m.phases
+        ]))
+        self._chains = chains
+
+    def _should_time(self) -> bool:
+        """Return True for the one request in timing_sample_rate that is timed"""
+        self._sample_counter += 1
+        if self._sample_counter >= self.timing_sample_rate:
+            self._sample_counter = 0
+            return True
+        return False
 
-        # Create request context
+    def _open_context(self, target) -> RequestContext:
+        """Create and register the context for a request or connection"""
         context = RequestContext()
         self.request_contexts[context.request_id] = context
+        target.context = context
+        return context
+
+    def _release_context(self, target) -> None:
+        """Forget the context of a finished request or connection"""
+        context = getattr(target, 'context', None)
+        if context is not None:
+            self.request_contexts.pop(context.request_id, None)
+
+    @staticmethod
+    def _record_error(middleware: MiddlewareInfo, error: Exception) -> None:
+        """Record a middleware failure"""
+        middleware.error_count += 1
+        middleware.last_error = str(error)
+        logger.error(f"Error in middleware {middleware.name}: {error}")
+
+    async def _call(self, middleware: MiddlewareInfo, timed: bool, *args) -> Any:
+        """Call a flat-chain middleware, timing it when sampled"""
+        middleware.execution_count += 1
+        if not timed:
+            return await middleware.middleware(*args)
+
+        start_time = time.perf_counter()
+        try:
+            return await middleware.middleware(*args)
+        finally:
+            middleware.execution_time += time.perf_counter() - start_time
+            middleware.timed_count += 1
 
-        # Add context to request
-        request.context = context
-
-        # Process through request middleware
-        for middleware in self.http_middlewares:
-            if (middleware.enabled and
-                MiddlewarePhase.REQUEST in middleware.phases):
-                try:
-                    start_time = time.time()
-                    request = await self._execute_middleware(middleware, request, None)
-                    execution_time = time.time() - start_time
-
-                    # Update stats
-                    middleware.execution_time += execution_time
-                    middleware.execution_count += 1
-
-                    # Store in context
-                    context.set_middleware_data(middleware.name, 'last_execution_time', execution_time)
-
-                except Exception as e:
-                    middleware.error_count += 1
-                    middleware.last_error = str(e)
-                    logger.error(f"Error in middleware {middleware.name}: {e}")
-
-                    # Check if middleware should continue on error
-                    if not middleware.config.get('continue_on_error', False):
-                        raise
-
+    async def process_http_request(self, request) -> Any:
+        """Attach a fresh request context before the middleware chain runs"""
+        if self._enabled:
+            self._open_context(request)
         return request
 
     async def process_http_response(self, request, response) -> Any:
-        """Process HTTP response through middleware pipeline"""
+        """Run response-only middleware and release the request context"""
         if not self._enabled:
             return response
 
-        context = getattr(request, 'context', None)
-        if not context:
+        try:
+            hooks = self._chains[(MiddlewareType.HTTP, MiddlewarePhase.RESPONSE)]
+            if hooks:
+                timed = self._should_time()
+                for middleware in hooks:
+                    try:
+                        response = await self._call(middleware, timed, request, response)
+                    except Exception as e:
+                        self._record_error(middleware, e)
+                        if not middleware.config.get('continue_on_error', False):
+                            raise
             return response
-
-        # Process through response middleware (in reverse order)
-        for middleware in reversed(self.http_middlewares):
-            if (middleware.enabled and
-                MiddlewarePhase.RESPONSE in middleware.phases):
-                try:
-                    start_time = time.time()
-                    response = await self._execute_middleware(middleware, request, response)
-                    execution_time = time.time() - start_time
-
-                    # Update stats
-                    middleware.execution_time += execution_time
-                    middleware.execution_count += 1
-
-                    # Store in context
-                    if context:
-                        context.set_middleware_data(middleware.name, 'last_response_time', execution_time)
-
-                except Exception as e:
-                    middleware.error_count += 1
-                    middleware.last_error = str(e)
-                    logger.error(f"Error in response middleware {middleware.name}: {e}")
-
-                    # Check if middleware should continue on error
-                    if not middleware.config.get('continue_on_error', False):
-                        raise
-
-        return response
+        finally:
+            self._release_context(request)
 
     async def process_websocket(self, websocket) -> Optional[Any]:
         """Process WebSocket through middleware pipeline"""
         if not self._enabled:
             return websocket
 
-        # Create request context
-        context = RequestContext()
-        self.request_contexts[context.request_id] = context
-
-        # Add context to websocket
-        websocket.context = context
-
-        # Process through connect middleware
-        for middleware in self.websocket_middlewares:
-            if (middleware.enabled and
-                MiddlewarePhase.WEBSOCKET_CONNECT in middleware.phases):
-                try:
-                    start_time = time.time()
-                    result = await self._execute_websocket_middleware(middleware, websocket, 'connect')
-                    execution_time = time.time() - start_time
-
-                    # Update stats
-                    middleware.execution_time += execution_time
-                    middleware.execution_count += 1
-
-                    if result is None:
-                        # Middleware rejected the connection
-                        return None
+        self._open_context(websocket)
 
-                except Exception as e:
-                    middleware.error_count += 1
-                    middleware.last_error = str(e)
-                    logger.error(f"Error in WebSocket middleware {middleware.name}: {e}")
+        chain = self._chains[(MiddlewareType.WEBSOCKET, MiddlewarePhase.WEBSOCKET_CONNECT)]
+        timed = self._should_time() if chain else False
+        for middleware in chain:
+            try:
+                result = await self._call(middleware, timed, websocket, _accept_connection)
+            except Exception as e:
+                self._record_error(middleware, e)
+                if middleware.config.get('continue_on_error', False):
+                    continue
+                result = None
 
-                    # Check if middleware should continue on error
-                    if not middleware.config.get('continue_on_error', False):
-                        return None
+            if result is None:
+                # Middleware rejected the connection
+                self._release_context(websocket)
+                return None
 
         return websocket
 
@@ -316,166 +333,115 @@ class MiddlewareManager:
         if not self._enabled:
             return message
 
-        context = getattr(websocket, 'context', None)
-        if not context:
+        chain = self._chains[(MiddlewareType.WEBSOCKET, MiddlewarePhase.WEBSOCKET_MESSAGE)]
+        if not chain or getattr(websocket, 'context', None) is None:
             return message
 
-        # Process through message middleware
-        for middleware in self.websocket_middlewares:
-            if (middleware.enabled and
-                MiddlewarePhase.WEBSOCKET_MESSAGE in middleware.phases):
-                try:
-                    start_time = time.time()
-                    message = await self._execute_websocket_middleware(middleware, websocket, 'message', message)
-                    execution_time = time.time() - start_time
-
-                    # Update stats
-                    middleware.execution_time += execution_time
-                    middleware.execution_count += 1
+        timed = self._should_time()
+        for middleware in chain:
+            try:
+                message = await self._call(middleware, timed, websocket, message)
+            except Exception as e:
+                self._record_error(middleware, e)
+                continue
 
-                    if message is None:
-                        # Middleware consumed the message
-                        return None
-
-                except Exception as e:
-                    middleware.error_count += 1
-                    middleware.last_error = str(e)
-                    logger.error(f"Error in WebSocket message middleware {middleware.name}: {e}")
+            if message is None:
+                # Middleware consumed the message
+                return None
 
         return message
 
     async def process_websocket_disconnect(self, websocket) -> None:
-        """Process WebSocket disconnect through middleware pipeline"""
-        if not self._enabled:
+        """Process WebSocket disconnect and release the connection context"""
+        if not self._enabled or getattr(websocket, 'context', None) is None:
             return
 
-        context = getattr(websocket, 'context', None)
-        if not context:
-            return
-
-        # Process through disconnect middleware
-        for middleware in self.websocket_middlewares:
-            if (middleware.enabled and
-                MiddlewarePhase.WEBSOCKET_DISCONNECT in middleware.phases):
+        try:
+            chain = self._chains[(MiddlewareType.WEBSOCKET, MiddlewarePhase.WEBSOCKET_DISCONNECT)]
+            timed = self._should_time() if chain else False
+            for middleware in chain:
                 try:
-                    start_time = time.time()
-                    await self._execute_websocket_middleware(middleware, websocket, 'disconnect')
-                    execution_time = time.time() - start_time
+                    await self._call(middleware, timed, websocket)
+                except Exception as e:
+                    self._record_error(middleware, e)
+        finally:
+            self._release_context(websocket)
 
-                    # Update stats
-                    middleware.execution_time += execution_time
-                    middleware.execution_count += 1
+    async def execute_http_chain(self, request, final_handler: Callable) -> Any:
+        """
+        Execute the complete HTTP middleware chain
 
-                except Exception as e:
-                    middleware.error_count += 1
-                    middleware.last_error = str(e)
-                    logger.error(f"Error in WebSocket disconnect middleware {middleware.name}: {e}")
+        Opens the request context, runs the request-phase middleware as an
+        onion around ``final_handler`` (sync or async), applies the
+        response-only middleware and releases the context.
+        """
+        if not self._enabled:
+            return await _resolve(final_handler(request))
 
-    async def _execute_middleware(self, middleware: MiddlewareInfo, request, response) -> Any:
-        """Execute HTTP middleware"""
+        request = await self.process_http_request(request)
         try:
-            if response is None:
-                # Request phase
-                return await middleware.middleware(request, self._create_call_next(middleware, request))
+            chain = self._chains[(MiddlewareType.HTTP, MiddlewarePhase.REQUEST)]
+            if chain:
+                response = await self._dispatch(chain, 0, request, final_handler, self._should_time())
             else:
-                # Response phase
-                return await middleware.middleware(request, response)
-        except Exception as e:
-            logger.error(f"Error executing middleware {middleware.name}: {e}")
+                response = await _resolve(final_handler(request))
+        except BaseException:
+            self._release_context(request)
             raise
 
-    async def _execute_websocket_middleware(self, middleware: MiddlewareInfo, websocket, phase: str, message=None) -> Any:
-        """Execute WebSocket middleware"""
+        return await self.process_http_response(request, response)
+
+    async def _dispatch(self, chain: Tuple[MiddlewareInfo, ...], index: int, request,
+                        final_handler: Callable, timed: bool) -> Any:
+        """Run chain[index] with a call_next bound to the rest of the chain"""
+        if index == len(chain):
+            return await _resolve(final_handler(request))
+
+        middleware = chain[index]
+        entered = False
+        downstream_failed = False
+        downstream_time = 0.0
+
+        async def call_next(next_request=request):
+            nonlocal entered, downstream_failed, downstream_time
+            entered = True
+            start_time = time.perf_counter() if timed else 0.0
+            try:
+                return await self._dispatch(chain, index + 1, next_request, final_handler, timed)
+            except BaseException:
+                downstream_failed = True
+                raise
+            finally:
+                if timed:
+                    downstream_time += time.perf_counter() - start_time
+
+        middleware.execution_count += 1
+        start_time = time.perf_counter() if timed else 0.0
         try:
-            if phase == 'connect':
-                return await middleware.middleware(websocket, self._create_websocket_call_next(middleware, websocket, phase))
-            elif phase == 'message':
-                return await middleware.middleware(websocket, message)
-            elif phase == 'disconnect':
-                return await middleware.middleware(websocket)
+            return await middleware.middleware(request, call_next)
         except Exception as e:
-            logger.error(f"Error executing WebSocket middleware {middleware.name}: {e}")
-            raise
-
-    def _create_call_next(self, current_middleware: MiddlewareInfo, request):
-        """Create call_next function for HTTP middleware"""
-        async def call_next(response=None):
-            # Find next middleware
-            current_index = None
-            for i, middleware in enumerate(self.http_middlewares):
-                if middleware.name == current_middleware.name:
-                    current_index = i
-                    break
-
-            if current_index is None or current_index == len(self.http_middlewares) - 1:
-                # No more middleware, return response
-                return response
-
-            # Execute next middleware
-            next_middleware = self.http_middlewares[current_index + 1]
-            return await self._execute_middleware(next_middleware, request, response)
-
-        return call_next
-
-    def _create_websocket_call_next(self, current_middleware: MiddlewareInfo, websocket, phase: str):
-        """Create call_next function for WebSocket middleware"""
-        async def call_next(message=None):
-            # Find next middleware
-            current_index = None
-            for i, middleware in enumerate(self.websocket_middlewares):
-                if middleware.name == current_middleware.name:
-                    current_index = i
-                    break
-
-            if current_index is None or current_index == len(self.websocket_middlewares) - 1:
-                # No more middleware
-                if phase == 'connect':
-                    return True  # Accept connection
-                elif phase == 'message':
-                    return message  # Pass through message
-                else:
-                    return None
-
-            # Execute next middleware
-            next_middleware = self.websocket_middlewares[current_index + 1]
-            return await self._execute_websocket_middleware(next_middleware, websocket, phase, message)
-
-        return call_next
-
-    async def execute_http_chain(self, request, final_handler: Callable) -> Any:
-        """Execute the complete HTTP middleware chain"""
-        async def call_next(response=None):
-            if response is None:
-                # Execute final handler
-                return await final_handler(request)
-            else:
-                # Response phase - process through response middleware
-                return await self.process_http_response(request, response)
-
-        # Start with request processing
-        processed_request = await self.process_http_request(request)
-
-        # Execute through middleware chain
-        response = await self._execute_middleware_chain(processed_request, call_next)
-
-        return response
-
-    async def _execute_middleware_chain(self, request, call_next):
-        """Execute middleware chain starting from the first middleware"""
-        if not self.http_middlewares:
-            return await call_next()
-
-        # Start with the first middleware
-        first_middleware = self.http_middlewares[0]
-        return await self._execute_middleware(first_middleware, request, None)
+            if downstream_failed:
+                raise
+            self._record_error(middleware, e)
+            if entered or not middleware.config.get('continue_on_error', False):
+                raise
+            # Skip the failed middleware and carry on down the chain
+            return await self._dispatch(chain, index + 1, request, final_handler, timed)
+        finally:
+            if timed:
+                # Exclude the time spent in the middleware and handler below
+                middleware.execution_time += time.perf_counter() - start_time - downstream_time
+                middleware.timed_count += 1
 
     def get_stats(self) -> Dict[str, Any]:
         """Get middleware manager statistics"""
         stats = {
             'total_http_middlewares': len(self.http_middlewares),
             'total_websocket_middlewares': len(self.websocket_middlewares),
+            'active_http_middlewares': len(self._chains[(MiddlewareType.HTTP, MiddlewarePhase.REQUEST)]),
             'enabled': self._enabled,
             'active_requests': len(self.request_contexts),
+            'timing_sample_rate': self.timing_sample_rate,
             'middleware_stats': {}
         }
 
@@ -487,6 +453,9 @@ class MiddlewareManager:
                 'phases': [phase.value for phase in middleware.phases],
                 'execution_time': middleware.execution_time,
                 'execution_count': middleware.execution_count,
+                'timed_count': middleware.timed_count,
+                'average_time': (middleware.execution_time / middleware.timed_count
+                                 if middleware.timed_count else 0.0),
                 'error_count': middleware.error_count,
                 'last_error': middleware.last_error
             }
@@ -502,12 +471,14 @@ class MiddlewareManager:
         for middleware_list in [self.http_middlewares, self.websocket_middlewares]:
             for middleware in middleware_list:
                 middleware.enabled = True
+        self._rebuild_chains()
 
     def disable_all(self) -> None:
         """Disable all middleware"""
         for middleware_list in [self.http_middlewares, self.websocket_middlewares]:
             for middleware in middleware_list:
                 middleware.enabled = False
+        self._rebuild_chains()
 
     def get_middleware_by_phase(self, phase: MiddlewarePhase, middleware_type: MiddlewareType = MiddlewareType.HTTP) -> List[MiddlewareInfo]:
         """Get middleware by phase"""
@@ -515,6 +486,18 @@ class MiddlewareManager:
         return [m for m in middleware_list if phase in m.phases and m.enabled]
 
 
+async def _accept_connection(websocket=None) -> bool:
+    """call_next for WebSocket connect middleware: accept the connection"""
+    return True
+
+
+async def _resolve(result: Any) -> Any:
+    """Await result if the handler returned an awaitable"""
+    if inspect.isawaitable(result):
+        return await result
+    return result
+
+
 # Built-in Middleware Classes
 class BaseMiddleware:
     """Base middleware class with common functionality"""
@@ -641,27 +624,21 @@ class SecurityHeadersMiddleware(BaseMiddleware):
 
 
 class CompressionMiddleware(BaseMiddleware):
-    """Response compression middleware"""
+    """
+    Response compression middleware.
+
+    Turns on Accept-Encoding negotiation for responses that didn't choose
+    a coding themselves; the response compresses its body (or each
+    streamed chunk) when it is sent. Config keys: ``min_size`` (bytes).
+    """
 
     async def __call__(self, request, call_next):
         response = await call_next(request)
 
-        # Check if client accepts compression
-        accept_encoding = request.headers.get('Accept-Encoding', '')
-
-        if 'gzip' in accept_encoding and hasattr(response, 'body'):
-            # Compress response body
-            import gzip
-            import io
-
-            if isinstance(response.body, str):
-                body_bytes = response.body.encode('utf-8')
-            else:
-                body_bytes = response.body
-
-            compressed = gzip.compress(body_bytes)
-            response.body = compressed
-            response.headers['Content-Encoding'] = 'gzip'
+        if isinstance(response, Response) and not response.compression:
+            response.compression = "auto"
+            if "min_size" in self.config:
+                response.compression_min_size = self.config["min_size"]
 
         return response
 
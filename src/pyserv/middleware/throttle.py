@@ -31,7 +31,7 @@ from dataclasses import dataclass
 
 from pyserv.utils.rate_limiting import (
     RateLimiter, RateLimitConfig, RateLimitResult,
-    RateLimitAlgorithm, RateLimitExceeded
+    RateLimitAlgorithm, RateLimitExceeded, RateLimitBackend
 )
 from pyserv.http.response import Response
 from pyserv.middleware.base import HTTPMiddleware
@@ -48,6 +48,10 @@ class ThrottleConfig:
     algorithm: RateLimitAlgorithm = RateLimitAlgorithm.TOKEN_BUCKET
     window_size: int = 60
 
+    # Where limiter state lives: None for the shared in-process engine,
+    # or e.g. RedisRateLimitBackend for limits that hold across workers and nodes
+    backend: Optional[RateLimitBackend] = None
+
     # Key generation
     key_func: Optional[Callable] = None
     key_prefix: str = "throttle"
@@ -132,6 +136,7 @@ class ThrottleMiddleware(HTTPMiddleware):
 
         return RateLimiter(
             config=rate_config,
+            backend=self.config.backend,
             key_func=lambda req: f"{self.config.key_prefix}:{key_func(req)}"
         )
 
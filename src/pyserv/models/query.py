@@ -5,7 +5,7 @@ Query builder for database operations.
 import json
 from bson import ObjectId
 from pymongo import ASCENDING, DESCENDING
-from typing import Dict, List, Optional, Any, Tuple, Union, Type, TypeVar, Generic
+from typing import AsyncIterator, Dict, List, Optional, Any, Tuple, Union, Type, TypeVar, Generic
 from pydantic import BaseModel as PydanticBaseModel, create_model, validator
 from datetime import datetime
 import asyncio
@@ -59,6 +59,7 @@ class QueryBuilder(Generic[T]):
         new_builder._having_params = self._having_params.copy()
         new_builder._param_counter = self._param_counter
         new_builder._lazy_loading_enabled = self._lazy_loading_enabled
+        new_builder._filter_criteria = self._filter_criteria.copy()
         return new_builder
 
     def disable_lazy_loading(self) -> 'QueryBuilder[T]':
@@ -148,16 +149,15 @@ class QueryBuilder(Generic[T]):
         return self
 
     def having(self, condition: str, *params: Any) -> 'QueryBuilder[T]':
-        """Add HAVING clause and return self"""
+        """Add HAVING clause and return self; write its parameters as ``?``"""
         self._having_conditions.append(condition)
         self._having_params.extend(params)
         return self
 
-    async def execute(self) -> List[T]:
-        """Execute the query and return results using unified db interface"""
-        # Build query parameters for unified db interface
-        query_params = {
-            'select_fields': self._select_fields,
+    def _build_query_params(self, select_fields: Optional[List[str]] = None) -> Dict[str, Any]:
+        """Pack builder state into the unified db interface's query parameters"""
+        return {
+            'select_fields': list(select_fields) if select_fields else self._select_fields,
             'distinct': self._distinct,
             'filters': self._filter_criteria,
             'limit': self._limit,
@@ -169,6 +169,10 @@ class QueryBuilder(Generic[T]):
             'table_name': self.model_class.get_table_name()
         }
 
+    async def execute(self) -> List[T]:
+        """Execute the query and return results using unified db interface"""
+        query_params = self._build_query_params()
+
         # Execute using unified db interface
         results = await self.db.execute_query_builder(self.model_class, query_params)
 
@@ -184,6 +188,75 @@ class QueryBuilder(Generic[T]):
 
         return instances
 
+    async def _iter_rows(self, batch_size: int,
+                         fields: Tuple[str, ...] = ()) -> AsyncIterator[Tuple[Tuple[str, ...], List[tuple]]]:
+        """Yield (columns, row tuples) batches straight from the driver"""
+        query_params = self._build_query_params(list(fields))
+        iter_query_builder = getattr(self.db, 'iter_query_builder', None)
+        if iter_query_builder is not None:
+            async for columns, rows in iter_query_builder(self.model_class, query_params, batch_size):
+                yield columns, rows
+            return
+
+        # Backends without a streaming cursor: buffer, then slice
+        columns, results = await self._fetch_rows(fields)
+        for start in range(0, len(results), batch_size):
+            yield columns, [tuple(row.get(c) for c in columns) for row in results[start:start + batch_size]]
+
+    async def _fetch_rows(self, fields: Tuple[str, ...] = ()) -> Tuple[Tuple[str, ...], List[Dict[str, Any]]]:
+        """Fetch every row in one round trip, without the cursor, transaction and prepare of _iter_rows"""
+        results = await self.db.execute_query_builder(self.model_class, self._build_query_params(list(fields)))
+        columns = tuple(fields) or (tuple(results[0].keys()) if results else ())
+        return columns, results
+
+    async def iter_batches(self, size: int = 1000, columnar: bool = False) -> AsyncIterator[Any]:
+        """
+        Stream results in batches without building model instances.
+
+        Uses a server-side cursor where the backend has one, so large
+        exports never hold the full result set in memory.
+
+        Args:
+            size: Rows per batch
+            columnar: Yield ``{column: [values...]}`` instead of a list of tuples
+
+        Example:
+            async for rows in User.query().filter(active=True).iter_batches(5000):
+                writer.writerows(rows)
+        """
+        async for columns, rows in self._iter_rows(size):
+            if columnar:
+                yield dict(zip(columns, (list(values) for values in zip(*rows))))
+            else:
+                yield rows
+
+    async def stream(self, batch_size: int = 1000) -> AsyncIterator[T]:
+        """Iterate model instances fetched batch by batch from a streaming cursor"""
+        async for columns, rows in self._iter_rows(batch_size):
+            for row in rows:
+                yield self.model_class(**dict(zip(columns, row)))
+
+    async def values(self, *fields: str) -> List[Dict[str, Any]]:
+        """Return rows as plain dicts, skipping model construction and validation"""
+        columns, results = await self._fetch_rows(fields)
+        if not fields:
+            return results
+        return [{column: row.get(column) for column in columns} for row in results]
+
+    async def values_list(self, *fields: str, flat: bool = False) -> List[Any]:
+        """
+        Return rows as tuples, or single values with ``flat=True``.
+
+        Example:
+            ids = await Order.query().filter(status='open').values_list('id', flat=True)
+        """
+        if flat and len(fields) != 1:
+            raise ValueError("values_list(flat=True) requires exactly one field")
+        columns, results = await self._fetch_rows(fields)
+        if flat:
+            return [row.get(fields[0]) for row in results]
+        return [tuple(row.get(column) for column in columns) for row in results]
+
     async def _prefetch_relationships(self, instances: List[T]):
         """Prefetch relationships to avoid N+1 queries"""
         tasks = []
@@ -1,4 +1,4 @@
-from typing import Optional, Dict, Any, ClassVar
+from typing import Optional, Dict, Any, ClassVar, List
 from datetime import datetime, timezone
 from enum import Enum
 import hashlib
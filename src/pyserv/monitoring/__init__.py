@@ -3,12 +3,16 @@ Advanced monitoring system for PyServ.
 Provides comprehensive monitoring, alerting, and observability features.
 """
 
-from .monitoring_manager import MonitoringManager, MonitoringConfig
-from .metrics_collector import MetricsCollector
-from .alert_manager import AlertManager, AlertRule
-from .dashboard_generator import DashboardGenerator
-from .log_aggregator import LogAggregator
-from .trace_manager import TraceManager
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".monitoring_manager": ["MonitoringManager", "MonitoringConfig"],
+    ".metrics_collector": ["MetricsCollector"],
+    ".alert_manager": ["AlertManager", "AlertRule"],
+    ".dashboard_generator": ["DashboardGenerator"],
+    ".log_aggregator": ["LogAggregator"],
+    ".trace_manager": ["TraceManager"],
+})
 
 __all__ = [
     'MonitoringManager', 'MonitoringConfig',
@@ -1,17 +1,33 @@
 """
 Metrics collection system for Pyserv  framework.
 Provides counters, gauges, histograms, and timers for monitoring.
+
+Updates never allocate: each label set maps to a preallocated series
+(cached after its first use), counters keep one cell per writing thread so
+no lock is taken on the hot path, and histograms are fixed arrays of bucket
+counts. ``MetricValue`` records and exposition text are only built when
+metrics are collected or scraped.
 """
 
 from abc import ABC, abstractmethod
-from typing import Dict, Any, Optional, List
+from array import array
+from bisect import bisect_left
+from typing import Dict, Any, Optional, List, Tuple, Iterable
+import math
 import time
 import asyncio
 import json
-from collections import defaultdict
+import threading
 from dataclasses import dataclass, field
 
 
+PROMETHEUS_CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8"
+OPENMETRICS_CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+DEFAULT_BUCKETS = (0.1, 0.5, 1.0, 2.5, 5.0, 10.0)
+LATENCY_BUCKETS = (0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0)
+
+
 @dataclass
 class MetricValue:
     """Represents a metric value with metadata"""
@@ -22,23 +38,274 @@ class MetricValue:
     metric_type: str = "gauge"
 
 
+def _escape(value: str) -> str:
+    return str(value).replace('\\', '\\\\').replace('"', '\\"').replace('\n', '\\n')
+
+
+def _format_labels(labels: Dict[str, str], extra: Optional[Tuple[str, str]] = None) -> str:
+    parts = [f'{key}="{_escape(value)}"' for key, value in labels.items()]
+    if extra:
+        parts.append(f'{extra[0]}="{extra[1]}"')
+    return f"{{{','.join(parts)}}}" if parts else ""
+
+
+def _format_number(value: float) -> str:
+    if value == math.inf:
+        return "+Inf"
+    if value == -math.inf:
+        return "-Inf"
+    if isinstance(value, float) and value.is_integer() and abs(value) < 1e15:
+        return str(int(value))
+    return repr(value)
+
+
+def _format_bound(bound: float) -> str:
+    return "+Inf" if bound == math.inf else repr(float(bound))
+
+
+class StripedCounter:
+    """
+    Counter with one cell per writing thread.
+
+    A thread only ever writes its own cell, so ``add`` needs no lock and no
+    update is lost; reads sum the cells.
+    """
+
+    __slots__ = ('_cells', '_local', '_lock')
+
+    def __init__(self):
+        self._cells: List[List[float]] = []
+        self._local = threading.local()
+        self._lock = threading.Lock()
+
+    def add(self, amount: float = 1.0) -> None:
+        try:
+            self._local.cell[0] += amount
+        except AttributeError:
+            cell = [amount]
+            with self._lock:
+                self._cells.append(cell)
+            self._local.cell = cell
+
+    @property
+    def value(self) -> float:
+        return sum(cell[0] for cell in self._cells)
+
+    def reset(self) -> None:
+        for cell in self._cells:
+            cell[0] = 0.0
+
+
+class BucketHistogram:
+    """Fixed-bucket histogram; ``counts[i]`` holds observations in ``(bounds[i-1], bounds[i]]``"""
+
+    __slots__ = ('bounds', 'counts', 'sum')
+
+    def __init__(self, bounds: Iterable[float] = DEFAULT_BUCKETS):
+        self.bounds = tuple(sorted(bounds))
+        self.counts = array('q', bytes(8 * (len(self.bounds) + 1)))
+        self.sum = 0.0
+
+    def add(self, value: float) -> None:
+        self.counts[bisect_left(self.bounds, value)] += 1
+        self.sum += value
+
+    @property
+    def count(self) -> int:
+        return sum(self.counts)
+
+    def cumulative(self) -> List[Tuple[float, int]]:
+        """``(upper bound, observations <= bound)`` pairs, ending with +Inf"""
+        total, pairs = 0, []
+        for bound, count in zip(self.bounds + (math.inf,), self.counts):
+            total += count
+            pairs.append((bound, total))
+        return pairs
+
+    def quantile(self, q: float) -> float:
+        """Estimate by linear interpolation inside the bucket holding rank ``q``"""
+        count = self.count
+        if not count:
+            return math.nan
+        rank = q * count
+        seen, lower = 0, 0.0
+        for index, bucket in enumerate(self.counts):
+            if bucket and seen + bucket >= rank:
+                if index == len(self.bounds):
+                    return self.bounds[-1] if self.bounds else math.nan
+                upper = self.bounds[index]
+                return lower + (upper - lower) * max(rank - seen, 0) / bucket
+            seen += bucket
+            if index < len(self.bounds):
+                lower = self.bounds[index]
+        return lower
+
+    def reset(self) -> None:
+        for index in range(len(self.counts)):
+            self.counts[index] = 0
+        self.sum = 0.0
+
+
+class QuantileSketch:
+    """
+    Log-bucketed quantile sketch in the style of DDSketch.
+
+    Bucket ``i`` covers ``(gamma**(i-1), gamma**i]`` with
+    ``gamma = (1 + accuracy) / (1 - accuracy)``, so any quantile is returned
+    within ``relative_accuracy`` of the true value. Buckets for the whole
+    ``[min_value, max_value]`` range are preallocated; values outside it are
+    clamped to the end buckets.
+    """
+
+    __slots__ = ('relative_accuracy', 'min_value', 'max_value', 'gamma', '_multiplier',
+                 '_offset', 'counts', 'count', 'sum', 'min', 'max')
+
+    def __init__(self, relative_accuracy: float = 0.01, min_value: float = 1e-6, max_value: float = 1e4):
+        if not 0 < relative_accuracy < 1:
+            raise ValueError("relative_accuracy must be between 0 and 1")
+        self.relative_accuracy = relative_accuracy
+        self.min_value = min_value
+        self.max_value = max_value
+        self.gamma = (1 + relative_accuracy) / (1 - relative_accuracy)
+        self._multiplier = 1 / math.log(self.gamma)
+        self._offset = math.ceil(math.log(min_value) * self._multiplier)
+        size = math.ceil(math.log(max_value) * self._multiplier) - self._offset + 1
+        self.counts = array('q', bytes(8 * size))
+        self.count = 0
+        self.sum = 0.0
+        self.min = math.inf
+        self.max = -math.inf
+
+    def add(self, value: float) -> None:
+        if value > self.min_value:
+            index = math.ceil(math.log(value) * self._multiplier) - self._offset
+            if index >= len(self.counts):
+                index = len(self.counts) - 1
+        else:
+            index = 0
+        self.counts[index] += 1
+        self.count += 1
+        self.sum += value
+        if value < self.min:
+            self.min = value
+        if value > self.max:
+            self.max = value
+
+    def quantile(self, q: float) -> float:
+        if not self.count:
+            return math.nan
+        rank = q * (self.count - 1)
+        seen = 0
+        for index, bucket in enumerate(self.counts):
+            seen += bucket
+            if seen > rank:
+                estimate = 2 * self.gamma ** (index + self._offset) / (self.gamma + 1)
+                return min(max(estimate, self.min), self.max)
+        return self.max
+
+    def merge(self, other: 'QuantileSketch') -> None:
+        """Fold ``other`` (built with the same parameters) into this sketch"""
+        if (other.gamma, other._offset, len(other.counts)) != (self.gamma, self._offset, len(self.counts)):
+            raise ValueError("sketches have different parameters")
+        for index, bucket in enumerate(other.counts):
+            if bucket:
+                self.counts[index] += bucket
+        self.count += other.count
+        self.sum += other.sum
+        self.min = min(self.min, other.min)
+        self.max = max(self.max, other.max)
+
+    def reset(self) -> None:
+        for index in range(len(self.counts)):
+            self.counts[index] = 0
+        self.count = 0
+        self.sum = 0.0
+        self.min = math.inf
+        self.max = -math.inf
+
+
 class Metric(ABC):
-    """Base metric class"""
+    """
+    Base metric class.
+
+    Each distinct label set is a series, created on first use and cached
+    under its sorted items, so the order labels are passed in does not
+    matter; ``with_labels`` returns the series itself so callers can hold on
+    to it and skip the lookup entirely.
+    """
+
+    metric_type = "untyped"
 
     def __init__(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None):
         self.name = name
         self.description = description
         self.labels = labels or {}
-        self._values: List[MetricValue] = []
+        self._series: Dict[Tuple, Any] = {}
+        self._series_lock = threading.Lock()
+        self._default = self._new_series(dict(self.labels))
 
     @abstractmethod
-    def collect(self) -> List[MetricValue]:
-        """Collect metric values"""
+    def _new_series(self, labels: Dict[str, str]) -> Any:
+        """Create the preallocated state for one label set"""
+        pass
+
+    @abstractmethod
+    def _samples(self, series: Any, openmetrics: bool) -> Iterable[Tuple[str, Optional[Tuple[str, str]], float]]:
+        """``(sample name, extra (label, value) or None, value)`` for one series"""
         pass
 
+    def with_labels(self, labels: Optional[Dict[str, str]] = None, **kwargs: str) -> Any:
+        """Series for ``labels`` (merged over the metric's own labels)"""
+        if kwargs:
+            labels = {**labels, **kwargs} if labels else kwargs
+        if not labels:
+            return self._default
+        key = tuple(sorted(labels.items()))
+        series = self._series.get(key)
+        if series is None:
+            with self._series_lock:
+                series = self._series.get(key)
+                if series is None:
+                    series = self._series[key] = self._new_series({**self.labels, **dict(key)})
+        return series
+
+    def _lookup(self, labels: Dict[str, str]) -> Any:
+        """``with_labels`` for the update methods: one sort and one dict probe once cached"""
+        series = self._series.get(tuple(sorted(labels.items())))
+        return series if series is not None else self.with_labels(labels)
+
+    def series(self) -> List[Any]:
+        """Every series, default first"""
+        return [self._default, *self._series.values()]
+
     def add_label(self, key: str, value: str):
         """Add a label to the metric"""
         self.labels[key] = value
+        for series in self.series():
+            series.labels.setdefault(key, value)
+
+    def collect(self) -> List[MetricValue]:
+        """Collect metric values"""
+        now = time.time()
+        values = []
+        for series in self.series():
+            for name, extra, value in self._samples(series, False):
+                labels = {**series.labels, extra[0]: extra[1]} if extra else series.labels
+                values.append(MetricValue(name=name, value=value, timestamp=now,
+                                          labels=labels, metric_type=self.metric_type))
+        return values
+
+    def expose(self, lines: List[str], openmetrics: bool = False) -> None:
+        """Append this metric in Prometheus (or OpenMetrics) text format to ``lines``"""
+        family = self.name
+        if openmetrics and self.metric_type == "counter" and family.endswith("_total"):
+            family = family[:-len("_total")]
+        if self.description:
+            lines.append(f"# HELP {family} {self.description}")
+        lines.append(f"# TYPE {family} {self.metric_type}")
+        for series in self.series():
+            for name, extra, value in self._samples(series, openmetrics):
+                lines.append(f"{name}{_format_labels(series.labels, extra)} {_format_number(value)}")
 
     def _create_value(self, value: float, labels: Optional[Dict[str, str]] = None) -> MetricValue:
         """Create a metric value"""
@@ -51,132 +318,207 @@ class Metric(ABC):
             value=value,
             timestamp=time.time(),
             labels=all_labels,
-            metric_type=self.__class__.__name__.lower()
+            metric_type=self.metric_type
         )
 
 
+class _CounterSeries(StripedCounter):
+    __slots__ = ('labels',)
+
+    def __init__(self, labels: Dict[str, str]):
+        super().__init__()
+        self.labels = labels
+
+    def increment(self, amount: float = 1.0) -> None:
+        self.add(amount)
+
+
 class Counter(Metric):
     """Monotonically increasing counter"""
 
-    def __init__(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None):
-        super().__init__(name, description, labels)
-        self._count = 0
+    metric_type = "counter"
+
+    def _new_series(self, labels):
+        return _CounterSeries(labels)
+
+    def _samples(self, series, openmetrics):
+        name = self.name
+        if openmetrics and not name.endswith("_total"):
+            name += "_total"
+        yield name, None, series.value
 
     def increment(self, amount: float = 1.0, labels: Optional[Dict[str, str]] = None):
         """Increment the counter"""
-        self._count += amount
-        self._values.append(self._create_value(self._count, labels))
+        (self._lookup(labels) if labels else self._default).add(amount)
+
+    @property
+    def value(self) -> float:
+        """Current value of the unlabelled series"""
+        return self._default.value
 
-    def collect(self) -> List[MetricValue]:
-        """Collect current counter value"""
-        return [self._create_value(self._count)]
+
+class _GaugeSeries:
+    __slots__ = ('labels', 'value')
+
+    def __init__(self, labels: Dict[str, str]):
+        self.labels = labels
+        self.value = 0.0
+
+    def set(self, value: float) -> None:
+        self.value = value
+
+    def increment(self, amount: float = 1.0) -> None:
+        self.value += amount
+
+    def decrement(self, amount: float = 1.0) -> None:
+        self.value -= amount
 
 
 class Gauge(Metric):
     """Gauge that can go up and down"""
 
-    def __init__(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None):
-        super().__init__(name, description, labels)
-        self._value = 0.0
+    metric_type = "gauge"
+
+    def _new_series(self, labels):
+        return _GaugeSeries(labels)
+
+    def _samples(self, series, openmetrics):
+        yield self.name, None, series.value
 
     def set(self, value: float, labels: Optional[Dict[str, str]] = None):
         """Set the gauge value"""
-        self._value = value
-        self._values.append(self._create_value(value, labels))
+        (self._lookup(labels) if labels else self._default).value = value
 
     def increment(self, amount: float = 1.0):
         """Increment the gauge"""
-        self._value += amount
-        self._values.append(self._create_value(self._value))
+        self._default.value += amount
 
     def decrement(self, amount: float = 1.0):
         """Decrement the gauge"""
-        self._value -= amount
-        self._values.append(self._create_value(self._value))
+        self._default.value -= amount
 
-    def collect(self) -> List[MetricValue]:
-        """Collect current gauge value"""
-        return [self._create_value(self._value)]
+    @property
+    def value(self) -> float:
+        """Current value of the unlabelled series"""
+        return self._default.value
+
+
+class _HistogramSeries(BucketHistogram):
+    __slots__ = ('labels',)
+
+    def __init__(self, labels: Dict[str, str], bounds: Iterable[float]):
+        super().__init__(bounds)
+        self.labels = labels
+
+    def observe(self, value: float) -> None:
+        self.add(value)
 
 
 class Histogram(Metric):
-    """Histogram for measuring distributions"""
+    """Histogram for measuring distributions, over fixed buckets"""
+
+    metric_type = "histogram"
 
     def __init__(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None,
                  buckets: Optional[List[float]] = None):
+        self.buckets = sorted(buckets or DEFAULT_BUCKETS)
         super().__init__(name, description, labels)
-        self.buckets = buckets or [0.1, 0.5, 1.0, 2.5, 5.0, 10.0]
-        self._observations: List[float] = []
-        self._bucket_counts = defaultdict(int)
-        self._sum = 0.0
-        self._count = 0
+
+    def _new_series(self, labels):
+        return _HistogramSeries(labels, self.buckets)
+
+    def _samples(self, series, openmetrics):
+        total = 0
+        for bound, total in series.cumulative():
+            yield f"{self.name}_bucket", ("le", _format_bound(bound)), total
+        yield f"{self.name}_sum", None, series.sum
+        yield f"{self.name}_count", None, total
 
     def observe(self, value: float, labels: Optional[Dict[str, str]] = None):
         """Observe a value"""
-        self._observations.append(value)
-        self._sum += value
-        self._count += 1
+        (self._lookup(labels) if labels else self._default).add(value)
 
-        # Update bucket counts
-        for bucket in self.buckets:
-            if value <= bucket:
-                self._bucket_counts[bucket] += 1
+    def quantile(self, q: float, labels: Optional[Dict[str, str]] = None) -> float:
+        """Estimate the ``q`` quantile from the bucket counts"""
+        return self.with_labels(labels).quantile(q)
 
-        self._values.append(self._create_value(value, labels))
+    @property
+    def sum(self) -> float:
+        """Sum of observations in the unlabelled series"""
+        return self._default.sum
 
-    def collect(self) -> List[MetricValue]:
-        """Collect histogram metrics"""
-        values = []
+    @property
+    def count(self) -> int:
+        """Observations in the unlabelled series"""
+        return self._default.count
 
-        # Bucket counts
-        for bucket in self.buckets:
-            values.append(MetricValue(
-                name=f"{self.name}_bucket",
-                value=self._bucket_counts[bucket],
-                timestamp=time.time(),
-                labels={**self.labels, "le": str(bucket)},
-                metric_type="histogram"
-            ))
-
-        # Sum
-        values.append(MetricValue(
-            name=f"{self.name}_sum",
-            value=self._sum,
-            timestamp=time.time(),
-            labels=self.labels,
-            metric_type="histogram"
-        ))
-
-        # Count
-        values.append(MetricValue(
-            name=f"{self.name}_count",
-            value=self._count,
-            timestamp=time.time(),
-            labels=self.labels,
-            metric_type="histogram"
-        ))
 
-        return values
+class _SketchSeries(QuantileSketch):
+    __slots__ = ('labels',)
 
+    def __init__(self, labels: Dict[str, str], relative_accuracy: float, min_value: float, max_value: float):
+        super().__init__(relative_accuracy, min_value, max_value)
+        self.labels = labels
 
-class Timer(Metric):
-    """Timer for measuring durations"""
+    def observe(self, value: float) -> None:
+        self.add(value)
 
-    def __init__(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None):
+
+class SketchHistogram(Metric):
+    """
+    Distribution with relative-error quantiles, exposed as a summary.
+
+    Use it instead of ``Histogram`` when the interesting values span several
+    orders of magnitude and nobody knows good bucket bounds up front.
+    """
+
+    metric_type = "summary"
+
+    def __init__(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None,
+                 quantiles: Iterable[float] = (0.5, 0.9, 0.99), relative_accuracy: float = 0.01,
+                 min_value: float = 1e-6, max_value: float = 1e4):
+        self.quantiles = tuple(quantiles)
+        self._sketch_args = (relative_accuracy, min_value, max_value)
         super().__init__(name, description, labels)
+
+    def _new_series(self, labels):
+        return _SketchSeries(labels, *self._sketch_args)
+
+    def _samples(self, series, openmetrics):
+        if series.count:
+            for q in self.quantiles:
+                yield self.name, ("quantile", str(q)), series.quantile(q)
+        yield f"{self.name}_sum", None, series.sum
+        yield f"{self.name}_count", None, series.count
+
+    def observe(self, value: float, labels: Optional[Dict[str, str]] = None):
+        """Observe a value"""
+        (self._lookup(labels) if labels else self._default).add(value)
+
+    def quantile(self, q: float, labels: Optional[Dict[str, str]] = None) -> float:
+        """The ``q`` quantile, within the sketch's relative accuracy"""
+        return self.with_labels(labels).quantile(q)
+
+
+class Timer(Histogram):
+    """Timer for measuring durations, recorded into a latency histogram"""
+
+    def __init__(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None,
+                 buckets: Optional[List[float]] = None):
+        super().__init__(name, description, labels, buckets or list(LATENCY_BUCKETS))
         self._start_time: Optional[float] = None
 
     def start(self):
         """Start the timer"""
-        self._start_time = time.time()
+        self._start_time = time.perf_counter()
 
     def stop(self, labels: Optional[Dict[str, str]] = None) -> float:
         """Stop the timer and record duration"""
         if self._start_time is None:
             return 0.0
 
-        duration = time.time() - self._start_time
-        self._values.append(self._create_value(duration, labels))
+        duration = time.perf_counter() - self._start_time
+        self.observe(duration, labels)
         self._start_time = None
         return duration
 
@@ -189,9 +531,25 @@ class Timer(Metric):
         """Async context manager exit"""
         self.stop()
 
-    def collect(self) -> List[MetricValue]:
-        """Collect timer metrics"""
-        return self._values[-10:] if self._values else []  # Last 10 measurements
+
+def _expose_values(lines: List[str], values: List[MetricValue], openmetrics: bool) -> None:
+    """Render ``MetricValue`` records from custom collectors, one TYPE line per family"""
+    typed = set()
+    for value in values:
+        family = value.name
+        if value.metric_type in ("histogram", "summary"):
+            for suffix in ("_bucket", "_sum", "_count"):
+                if family.endswith(suffix):
+                    family = family[:-len(suffix)]
+                    break
+        elif openmetrics and value.metric_type == "counter" and family.endswith("_total"):
+            family = family[:-len("_total")]
+        if family not in typed:
+            typed.add(family)
+            metric_type = value.metric_type if value.metric_type in (
+                "counter", "gauge", "histogram", "summary") else "untyped"
+            lines.append(f"# TYPE {family} {metric_type}")
+        lines.append(f"{value.name}{_format_labels(value.labels)} {_format_number(value.value)}")
 
 
 class MetricsCollector:
@@ -228,6 +586,13 @@ class MetricsCollector:
         self.register_metric(histogram)
         return histogram
 
+    def create_sketch(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None,
+                      **options) -> SketchHistogram:
+        """Create and register a quantile sketch"""
+        sketch = SketchHistogram(name, description, labels, **options)
+        self.register_metric(sketch)
+        return sketch
+
     def create_timer(self, name: str, description: str = "", labels: Optional[Dict[str, str]] = None) -> Timer:
         """Create and register a timer"""
         timer = Timer(name, description, labels)
@@ -248,32 +613,38 @@ class MetricsCollector:
 
         # Collect from custom collectors
         for collector in self._collectors:
-            if asyncio.iscoroutinefunction(collector):
-                values = await collector()
-            else:
-                values = collector()
-            all_values.extend(values)
+            all_values.extend(await self._run_collector(collector))
 
         return all_values
 
-    def to_prometheus(self) -> str:
-        """Export metrics in Prometheus format"""
-        lines = []
+    async def _run_collector(self, collector: callable) -> List[MetricValue]:
+        if asyncio.iscoroutinefunction(collector):
+            return await collector()
+        return collector()
 
+    def _render(self, collected: List[MetricValue], openmetrics: bool) -> str:
+        lines: List[str] = []
         for metric in self._metrics.values():
-            if metric.description:
-                lines.append(f"# HELP {metric.name} {metric.description}")
-            lines.append(f"# TYPE {metric.name} {metric.__class__.__name__.lower()}")
-
-            for value in metric.collect():
-                labels_str = ""
-                if value.labels:
-                    labels_list = [f'{k}="{v}"' for k, v in value.labels.items()]
-                    labels_str = f"{{{','.join(labels_list)}}}"
-
-                lines.append(f"{value.name}{labels_str} {value.value} {int(value.timestamp * 1000)}")
+            metric.expose(lines, openmetrics)
+        _expose_values(lines, collected, openmetrics)
+        if openmetrics:
+            lines.append("# EOF")
+        return "\n".join(lines) + "\n"
+
+    def to_prometheus(self, openmetrics: bool = False) -> str:
+        """Export metrics in Prometheus format (synchronous collectors only)"""
+        collected = []
+        for collector in self._collectors:
+            if not asyncio.iscoroutinefunction(collector):
+                collected.extend(collector())
+        return self._render(collected, openmetrics)
 
-        return "\n".join(lines)
+    async def expose(self, openmetrics: bool = False) -> str:
+        """Export metrics in Prometheus or OpenMetrics format, including async collectors"""
+        collected = []
+        for collector in self._collectors:
+            collected.extend(await self._run_collector(collector))
+        return self._render(collected, openmetrics)
 
     def to_json(self) -> str:
         """Export metrics as JSON"""
@@ -281,6 +652,25 @@ class MetricsCollector:
         return json.dumps([v.__dict__ for v in all_values], default=str)
 
 
+def metrics_endpoint(collector: Optional[MetricsCollector] = None):
+    """
+    Route handler serving the collector for Prometheus scrapes.
+
+    Answers in OpenMetrics when the scraper asks for it in ``Accept``:
+
+        app.route("/metrics")(metrics_endpoint())
+    """
+    from pyserv.http import Response
+
+    async def metrics(request):
+        target = collector or get_metrics_collector()
+        openmetrics = "application/openmetrics-text" in (getattr(request, "accept", "") or "")
+        body = await target.expose(openmetrics)
+        return Response(body, media_type=OPENMETRICS_CONTENT_TYPE if openmetrics else PROMETHEUS_CONTENT_TYPE)
+
+    return metrics
+
+
 # Global metrics collector
 _metrics_collector = None
 
@@ -330,5 +720,9 @@ def init_builtin_metrics():
 init_builtin_metrics()
 
 
-
-
+__all__ = [
+    'MetricValue', 'Metric', 'Counter', 'Gauge', 'Histogram', 'SketchHistogram', 'Timer',
+    'StripedCounter', 'BucketHistogram', 'QuantileSketch', 'MetricsCollector',
+    'metrics_endpoint', 'get_metrics_collector', 'init_builtin_metrics',
+    'DEFAULT_BUCKETS', 'LATENCY_BUCKETS', 'PROMETHEUS_CONTENT_TYPE', 'OPENMETRICS_CONTENT_TYPE',
+]
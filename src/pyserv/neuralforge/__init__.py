@@ -11,12 +11,17 @@ Features:
 Author: Pyserv  Framework
 """
 
-from .llm_engine import LLMEngine, LLMConfig, LLMResponse, LLMProvider
-from .agent_system import NeuralAgent, AgentState, AgentCapability, AgentMemory
-from .mcp_integration import MCPServer
-from .communication import AgentCommunicator
-from .economy import EconomySystem
-from .framework import NeuralForge
+# Components load on first access, so importing pyserv.neuralforge does not pull in the LLM clients
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".llm_engine": ["LLMEngine", "LLMConfig", "LLMResponse", "LLMProvider"],
+    ".agent_system": ["NeuralAgent", "AgentState", "AgentCapability", "AgentMemory"],
+    ".mcp_integration": ["MCPServer"],
+    ".communication": ["AgentCommunicator"],
+    ".economy": ["EconomySystem"],
+    ".framework": ["NeuralForge"],
+})
 
 __version__ = "1.0.0"
 __all__ = [
@@ -3,13 +3,18 @@ Payment processing system for PyServ.
 Supports multiple payment providers, secure transactions, and compliance features.
 """
 
-from .payment_processor import PaymentProcessor, PaymentConfig
-from .stripe_processor import StripeProcessor
-from .paypal_processor import PayPalProcessor
-from .crypto_processor import CryptoProcessor
-from .payment_security import PaymentSecurity, PCICompliance
-from .transaction_manager import TransactionManager
-from .webhook_handler import WebhookHandler
+# Providers load on first access, so importing pyserv.payment does not pull in every payment SDK
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".payment_processor": ["PaymentProcessor", "PaymentConfig"],
+    ".stripe_processor": ["StripeProcessor"],
+    ".paypal_processor": ["PayPalProcessor"],
+    ".crypto_processor": ["CryptoProcessor"],
+    ".payment_security": ["PaymentSecurity", "PCICompliance"],
+    ".transaction_manager": ["TransactionManager"],
+    ".webhook_handler": ["WebhookHandler"],
+})
 
 __all__ = [
     'PaymentProcessor', 'PaymentConfig',
@@ -3,16 +3,28 @@ Performance monitoring and optimization system for PyServ.
 Provides comprehensive performance tracking, profiling, and optimization tools.
 """
 
-from .performance_monitor import PerformanceMonitor, PerformanceMetrics
-from .profiler import Profiler, profile_function, benchmark
-from .load_balancer import LoadBalancer, LoadBalancerConfig
-from .performance_optimizer import PerformanceOptimizer
-from .anti_patterns import PerformanceAntiPatternDetector
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".performance_monitor": ["PerformanceMonitor", "PerformanceMetrics"],
+    ".profiler": ["Profiler", "profile_function", "benchmark"],
+    ".load_balancer": ["LoadBalancer", "LoadBalancerConfig"],
+    ".performance_optimizer": ["PerformanceOptimizer"],
+    ".anti_patterns": ["PerformanceAntiPatternDetector"],
+    ".sampling": [
+        "SamplingProfiler", "SampledProfile", "profile_endpoint", "get_sampling_profiler",
+    ],
+    ".benchmarks": ["AsgiClient", "HotPathSuite"],
+    ".importtime": ["measure_import", "format_report"],
+})
 
 __all__ = [
     'PerformanceMonitor', 'PerformanceMetrics',
     'Profiler', 'profile_function', 'benchmark',
     'LoadBalancer', 'LoadBalancerConfig',
     'PerformanceOptimizer',
-    'PerformanceAntiPatternDetector'
+    'PerformanceAntiPatternDetector',
+    'SamplingProfiler', 'SampledProfile', 'profile_endpoint', 'get_sampling_profiler',
+    'AsgiClient', 'HotPathSuite',
+    'measure_import', 'format_report'
 ]
@@ -0,0 +1,161 @@
+"""
+Import-time breakdown for Pyserv framework
+Runs an import under ``python -X importtime`` in a fresh interpreter and groups
+the reported self/cumulative times by subsystem, so cold-start regressions can be
+traced to the package that introduced them
+"""
+
+import os
+import re
+import subprocess
+import sys
+import time
+from dataclasses import dataclass, field
+from typing import Dict, List, Optional, Tuple
+
+_LINE = re.compile(r"^import time:\s+(\d+) \|\s+(\d+) \| ( *)(\S+)\s*$")
+
+
+@dataclass
+class ImportRecord:
+    """One module as reported by ``-X importtime``"""
+    module: str
+    self_us: int
+    cumulative_us: int
+    depth: int
+
+
+@dataclass
+class ImportReport:
+    """Everything one import statement pulled in"""
+    target: str
+    records: List[ImportRecord] = field(default_factory=list)
+    wall_seconds: float = 0.0
+    returncode: int = 0
+    error: str = ""
+
+    @property
+    def ok(self) -> bool:
+        return self.returncode == 0
+
+    @property
+    def total_us(self) -> int:
+        return sum(record.self_us for record in self.records)
+
+    def by_subsystem(self, depth: int = 2) -> List[Tuple[str, int, int]]:
+        """``(subsystem, self_us, modules)`` sorted by time spent, most expensive first"""
+        groups: Dict[str, List[int]] = {}
+        for record in self.records:
+            group = groups.setdefault(subsystem(record.module, depth), [0, 0])
+            group[0] += record.self_us
+            group[1] += 1
+        return sorted(((name, us, count) for name, (us, count) in groups.items()),
+                      key=lambda item: item[1], reverse=True)
+
+    def slowest(self, count: int = 10) -> List[ImportRecord]:
+        """Modules with the largest self time"""
+        return sorted(self.records, key=lambda record: record.self_us, reverse=True)[:count]
+
+    def to_dict(self, depth: int = 2) -> Dict:
+        return {
+            'target': self.target,
+            'ok': self.ok,
+            'error': self.error,
+            'wall_seconds': self.wall_seconds,
+            'total_us': self.total_us,
+            'modules': len(self.records),
+            'subsystems': [{'name': name, 'self_us': us, 'modules': count}
+                           for name, us, count in self.by_subsystem(depth)],
+        }
+
+
+def subsystem(module: str, depth: int = 2) -> str:
+    """Group key: ``pyserv.<package>`` for framework modules, the top-level package otherwise"""
+    parts = module.split('.')
+    if parts[0] == 'pyserv':
+        return '.'.join(parts[:depth])
+    return parts[0]
+
+
+def parse_importtime(output: str) -> List[ImportRecord]:
+    """Parse ``-X importtime`` stderr, ignoring any other lines (tracebacks, warnings)"""
+    records = []
+    for line in output.splitlines():
+        match = _LINE.match(line)
+        if match:
+            self_us, cumulative_us, indent, module = match.groups()
+            records.append(ImportRecord(module, int(self_us), int(cumulative_us), len(indent) // 2))
+    return records
+
+
+def _run(statement: str, python: str, env: Optional[Dict[str, str]]) -> Tuple[subprocess.CompletedProcess, float]:
+    start = time.perf_counter()
+    completed = subprocess.run([python, '-X', 'importtime', '-c', statement],
+                               capture_output=True, text=True, env=env)
+    return completed, time.perf_counter() - start
+
+
+def measure_import(target: str = 'pyserv', runs: int = 3, python: Optional[str] = None,
+                   env: Optional[Dict[str, str]] = None) -> ImportReport:
+    """
+    Import ``target`` in fresh interpreters and report what it loaded.
+
+    Modules the interpreter loads at startup (site, encodings, ...) are excluded,
+    and the fastest of ``runs`` attempts is kept to damp disk-cache noise.
+
+    Args:
+        target: Dotted module name to import
+        runs: Number of fresh interpreters to try
+        python: Interpreter to use, defaults to the running one
+        env: Environment for the child; defaults to this process's, with ``src`` of the
+            running pyserv prepended to PYTHONPATH so the working tree is measured
+
+    Returns:
+        The report of the fastest run
+    """
+    python = python or sys.executable
+    if env is None:
+        env = dict(os.environ)
+        source_root = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+        env['PYTHONPATH'] = os.pathsep.join(filter(None, [source_root, env.get('PYTHONPATH')]))
+
+    baseline, _ = _run('pass', python, env)
+    startup = {record.module for record in parse_importtime(baseline.stderr)}
+
+    best: Optional[ImportReport] = None
+    for _ in range(max(1, runs)):
+        completed, elapsed = _run(f'import {target}', python, env)
+        records = [record for record in parse_importtime(completed.stderr) if record.module not in startup]
+        error = ""
+        if completed.returncode != 0:
+            errors = [line for line in completed.stderr.splitlines() if not line.startswith('import time:')]
+            error = errors[-1] if errors else f"exit status {completed.returncode}"
+        report = ImportReport(target, records, elapsed, completed.returncode, error)
+        if not report.ok:
+            return report
+        if best is None or report.total_us < best.total_us:
+            best = report
+    return best
+
+
+def format_report(report: ImportReport, top: int = 15, depth: int = 2) -> str:
+    """Render a report as the text table printed by ``pyserv importtime``"""
+    lines = [f"import {report.target}: {report.total_us / 1000:.1f} ms in {len(report.records)} modules "
+             f"(interpreter wall {report.wall_seconds * 1000:.0f} ms)"]
+    if not report.ok:
+        lines.append(f"  import failed: {report.error}")
+
+    lines.append("")
+    lines.append(f"{'subsystem':<40} {'self ms':>10} {'share':>7} {'modules':>8}")
+    total = report.total_us or 1
+    for name, us, count in report.by_subsystem(depth)[:top]:
+        lines.append(f"{name:<40} {us / 1000:>10.2f} {us / total:>6.1%} {count:>8}")
+
+    lines.append("")
+    lines.append(f"{'slowest modules':<52} {'self ms':>10} {'cumul ms':>10}")
+    for record in report.slowest(top):
+        lines.append(f"{record.module:<52} {record.self_us / 1000:>10.2f} {record.cumulative_us / 1000:>10.2f}")
+    return "\n".join(lines)
+
+
+__all__ = ['ImportRecord', 'ImportReport', 'subsystem', 'parse_importtime', 'measure_import', 'format_report']
@@ -60,6 +60,8 @@ class BenchmarkResult:
     memory_peak: int
     cpu_average: float
     error_rate: float
+    alloc_bytes_per_op: float = 0.0
+    retained_bytes_per_op: float = 0.0
     timestamp: float = field(default_factory=time.time)
 
 
@@ -232,17 +234,55 @@ class PerformanceProfiler:
             # Fallback to file storage
             self._store_to_file_sync(result)
 
-    def generate_flame_graph(self, profile_data: str, output_file: str):
-        """Generate flame graph from profile data"""
+    def generate_flame_graph(self, profile_data: Any, output_file: str):
+        """
+        Write flame graph input for profile data.
+
+        A ``SampledProfile`` is written as collapsed stacks, which speedscope
+        and flamegraph.pl read directly; strings are written as given.
+        """
         try:
-            # This would require additional dependencies like flameprof
-            # For now, just save the profile data
+            if hasattr(profile_data, 'collapsed'):
+                profile_data = profile_data.collapsed()
             with open(output_file, 'w') as f:
                 f.write(profile_data)
             self.logger.info(f"Flame graph data saved to {output_file}")
         except Exception as e:
             self.logger.error(f"Failed to generate flame graph: {e}")
 
+    async def store_sampled_profile(self, profile: Any, top: int = 50):
+        """
+        Store a ``SampledProfile`` window: one ``profile_results`` row per route
+        and its ``top`` stacks in ``profile_samples``.
+        """
+        try:
+            await self._create_profiling_tables()
+            window = max(profile.end_time - profile.start_time, profile.interval)
+            for route, samples in profile.by_route().items():
+                sampled_time = samples * profile.interval
+                await self.db_connection.execute("""
+                    INSERT INTO profile_results
+                    (function_name, total_time, call_count, average_time, cumulative_time, memory_usage, cpu_usage, timestamp)
+                    VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+                """, (
+                    f"route:{route or '-'}",
+                    sampled_time,
+                    samples,
+                    profile.interval,
+                    sampled_time,
+                    0,
+                    100.0 * sampled_time / window,
+                    profile.end_time
+                ))
+            for route, middleware, frames, samples in profile.top(top):
+                await self.db_connection.execute("""
+                    INSERT INTO profile_samples
+                    (route, middleware, stack, samples, window_start, window_end)
+                    VALUES (?, ?, ?, ?, ?, ?)
+                """, (route, middleware, ";".join(frames), samples, profile.start_time, profile.end_time))
+        except Exception as e:
+            self.logger.error(f"Failed to store sampled profile: {e}")
+
     def _store_to_database_sync(self, result: ProfileResult):
         """Store profiling result to database (synchronous version)"""
         try:
@@ -326,6 +366,18 @@ class PerformanceProfiler:
                 )
             """)
             
+            await self.db_connection.execute("""
+                CREATE TABLE IF NOT EXISTS profile_samples (
+                    id INTEGER PRIMARY KEY AUTOINCREMENT,
+                    route TEXT,
+                    middleware TEXT,
+                    stack TEXT,
+                    samples INTEGER,
+                    window_start REAL,
+                    window_end REAL
+                )
+            """)
+
             await self.db_connection.execute("""
                 CREATE TABLE IF NOT EXISTS benchmark_results (
                     id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -544,37 +596,61 @@ class RegressionDetector:
         self._save_baselines()
         self.logger.info(f"Established baselines for {len(results)} tests")
 
-    def detect_regression(self, current_results: List[BenchmarkResult]) -> List[Dict[str, Any]]:
-        """Detect performance regressions"""
+    def detect_regression(self, current_results: List[BenchmarkResult],
+                          threshold: float = 0.1) -> List[Dict[str, Any]]:
+        """
+        Detect performance regressions
+
+        ``threshold`` is the relative change that counts as a regression
+        (0.1 = 10%); twice the threshold is reported as high severity.
+        Throughput, average and p99 latency and allocations per op are
+        compared; allocation checks apply only when the baseline recorded
+        them. Any failed operation is a high-severity ``error_regression``,
+        with or without a baseline, since a failing case can look fast.
+        """
         regressions = []
 
+        def check(name: str, kind: str, baseline_value: float, current_value: float, higher_is_worse: bool = True):
+            if baseline_value <= 0:
+                return
+            change = (current_value - baseline_value) / baseline_value
+            if not higher_is_worse:
+                change = -change
+            if change > threshold:
+                regressions.append({
+                    "test": name,
+                    "type": kind,
+                    "baseline": baseline_value,
+                    "current": current_value,
+                    "change_percent": change * 100,
+                    "severity": "high" if change > 2 * threshold else "medium"
+                })
+
         for current in current_results:
+            if current.error_rate > 0:
+                baseline = self.baselines.get(current.name)
+                regressions.append({
+                    "test": current.name,
+                    "type": "error_regression",
+                    "baseline": baseline.error_rate if baseline is not None else 0.0,
+                    "current": current.error_rate,
+                    "change_percent": current.error_rate * 100,
+                    "severity": "high"
+                })
             if current.name in self.baselines:
                 baseline = self.baselines[current.name]
 
-                # Check for significant regressions
-                ops_regression = (baseline.operations_per_second - current.operations_per_second) / baseline.operations_per_second
-                latency_regression = (current.average_latency - baseline.average_latency) / baseline.average_latency
-
-                if ops_regression > 0.1:  # 10% drop in throughput
-                    regressions.append({
-                        "test": current.name,
-                        "type": "throughput_regression",
-                        "baseline": baseline.operations_per_second,
-                        "current": current.operations_per_second,
-                        "change_percent": ops_regression * 100,
-                        "severity": "high" if ops_regression > 0.2 else "medium"
-                    })
-
-                if latency_regression > 0.1:  # 10% increase in latency
-                    regressions.append({
-                        "test": current.name,
-                        "type": "latency_regression",
-                        "baseline": baseline.average_latency,
-                        "current": current.average_latency,
-                        "change_percent": latency_regression * 100,
-                        "severity": "high" if latency_regression > 0.2 else "medium"
-                    })
+                check(current.name, "throughput_regression",
+                      baseline.operations_per_second, current.operations_per_second, higher_is_worse=False)
+                check(current.name, "latency_regression", baseline.average_latency, current.average_latency)
+                check(current.name, "p99_latency_regression", baseline.p99_latency, current.p99_latency)
+                # Allocations are near-deterministic, so small absolute jitter is ignored
+                if current.alloc_bytes_per_op - baseline.alloc_bytes_per_op > 64:
+                    check(current.name, "allocation_regression",
+                          baseline.alloc_bytes_per_op, current.alloc_bytes_per_op)
+                if current.retained_bytes_per_op - baseline.retained_bytes_per_op > 16:
+                    check(current.name, "retained_memory_regression",
+                          max(baseline.retained_bytes_per_op, 1.0), current.retained_bytes_per_op)
 
         if regressions:
             self.logger.warning(f"Performance regressions detected: {len(regressions)}")
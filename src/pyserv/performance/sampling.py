@@ -0,0 +1,515 @@
+"""
+Statistical sampling profiler for Pyserv framework.
+
+A background thread snapshots every thread's Python stack about 100 times a
+second (``sys._current_frames``) and counts identical stacks in process, so
+the cost is a fixed few microseconds per sample no matter how much code
+runs between samples. That makes it safe to leave on in production, unlike
+the deterministic ``cProfile`` sessions in ``profiling.py``.
+
+Each sample is attributed to the route and middleware it ran under. Both
+are read off the sampled stack itself (the handler below
+``Application.handle_http`` and the middleware called by
+``MiddlewareManager._dispatch``), so requests pay nothing for the tagging.
+Middleware runs before routing, so middleware samples carry the middleware
+but no route.
+
+Profiles export as collapsed stacks (flamegraph.pl, speedscope, inferno)
+or gzipped pprof protobuf (``go tool pprof``), served by
+``profile_endpoint``, and can be stored continuously in the profiling
+tables through ``PerformanceProfiler.store_sampled_profile``.
+"""
+
+import asyncio
+import gzip
+import logging
+import os
+import sys
+import threading
+import time
+from dataclasses import dataclass, field
+from typing import Any, Callable, Dict, Iterable, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+# Frame roles used for attribution
+_DISPATCH = 1   # MiddlewareManager._dispatch: its callee is a middleware (or _resolve)
+_RESOLVE = 2    # middleware.manager._resolve: the chain has reached the handler
+_FINAL = 3      # Application.handle_http's final_handler: the route handler is below
+
+# Leaf frames that mean a thread is waiting, not working
+_IDLE_LEAVES = {
+    ('selectors.py', 'select'), ('threading.py', 'wait'), ('threading.py', '_wait_for_tstate_lock'),
+    ('queue.py', 'get'),
+}
+
+SampleKey = Tuple[str, str, Tuple[Any, ...]]
+
+# Code objects whose role is cached; dynamically compiled code (templates, exec) would grow it forever
+_ROLE_CACHE_SIZE = 65536
+
+
+def _short_filename(filename: str) -> str:
+    """Drop everything up to the package root so labels stay readable"""
+    for marker in ('/site-packages/', '/src/'):
+        position = filename.rfind(marker)
+        if position >= 0:
+            return filename[position + len(marker):]
+    position = filename.rfind('/lib/python')
+    if position >= 0:
+        # Standard library: drop "/lib/pythonX.Y/"
+        return filename[filename.find('/', position + len('/lib/python')) + 1:]
+    return os.path.basename(filename)
+
+
+def _code_label(code) -> str:
+    return f"{getattr(code, 'co_qualname', code.co_name)} ({_short_filename(code.co_filename)}:{code.co_firstlineno})"
+
+
+def _code_role(code) -> int:
+    qualname = getattr(code, 'co_qualname', code.co_name)
+    if qualname == 'MiddlewareManager._dispatch':
+        return _DISPATCH
+    if qualname == '_resolve' and code.co_filename.endswith(os.path.join('middleware', 'manager.py')):
+        return _RESOLVE
+    if qualname == 'Application.handle_http.<locals>.final_handler':
+        return _FINAL
+    return 0
+
+
+def _middleware_name(code) -> str:
+    qualname = getattr(code, 'co_qualname', code.co_name)
+    return qualname[:-len('.__call__')] if qualname.endswith('.__call__') else qualname
+
+
+@dataclass
+class SampledProfile:
+    """Aggregated samples: ``(route, middleware, stack of code objects) -> count``"""
+    interval: float
+    start_time: float
+    end_time: float
+    samples: Dict[SampleKey, int] = field(default_factory=dict)
+    idle_samples: int = 0
+    dropped_samples: int = 0
+
+    @property
+    def total_samples(self) -> int:
+        return sum(self.samples.values())
+
+    def since(self, earlier: 'SampledProfile') -> 'SampledProfile':
+        """Samples taken after ``earlier`` (a snapshot of the same profiler)"""
+        samples = {}
+        for key, count in self.samples.items():
+            count -= earlier.samples.get(key, 0)
+            if count > 0:
+                samples[key] = count
+        return SampledProfile(self.interval, earlier.end_time, self.end_time, samples,
+                              self.idle_samples - earlier.idle_samples,
+                              self.dropped_samples - earlier.dropped_samples)
+
+    def by_route(self) -> Dict[str, int]:
+        """Samples per route (``""`` for work outside a route handler)"""
+        totals: Dict[str, int] = {}
+        for (route, _middleware, _stack), count in self.samples.items():
+            totals[route] = totals.get(route, 0) + count
+        return totals
+
+    def by_middleware(self) -> Dict[str, int]:
+        """Samples per middleware, for samples taken inside the middleware chain"""
+        totals: Dict[str, int] = {}
+        for (_route, middleware, _stack), count in self.samples.items():
+            if middleware:
+                totals[middleware] = totals.get(middleware, 0) + count
+        return totals
+
+    def stacks(self) -> Iterable[Tuple[str, str, List[str], int]]:
+        """``(route, middleware, frame labels root first, count)`` per distinct stack"""
+        labels: Dict[Any, str] = {}
+        for (route, middleware, stack), count in self.samples.items():
+            names = []
+            for code in stack:
+                name = labels.get(code)
+                if name is None:
+                    name = labels[code] = code if isinstance(code, str) else _code_label(code)
+                names.append(name)
+            yield route, middleware, names, count
+
+    def top(self, limit: int = 20) -> List[Tuple[str, str, List[str], int]]:
+        """The ``limit`` most sampled stacks"""
+        return sorted(self.stacks(), key=lambda item: item[3], reverse=True)[:limit]
+
+    def collapsed(self) -> str:
+        """Brendan Gregg's collapsed-stack format, route and middleware as root frames"""
+        lines = []
+        for route, middleware, names, count in self.stacks():
+            prefix = []
+            if route:
+                prefix.append(f"[route {route}]")
+            if middleware:
+                prefix.append(f"[middleware {middleware}]")
+            frames = ";".join(part.replace(";", ":") for part in prefix + names)
+            lines.append(f"{frames} {count}")
+        return "\n".join(lines) + ("\n" if lines else "")
+
+    def to_pprof(self) -> bytes:
+        """Gzipped pprof ``Profile`` protobuf; route and middleware are sample labels"""
+        return gzip.compress(_encode_pprof(self))
+
+
+# pprof protobuf encoding (github.com/google/pprof/proto/profile.proto)
+
+def _varint(value: int) -> bytes:
+    out = bytearray()
+    value &= (1 << 64) - 1
+    while True:
+        bits = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(bits | 0x80)
+        else:
+            out.append(bits)
+            return bytes(out)
+
+
+def _field_varint(number: int, value: int) -> bytes:
+    return _varint(number << 3) + _varint(value)
+
+
+def _field_bytes(number: int, payload: bytes) -> bytes:
+    return _varint((number << 3) | 2) + _varint(len(payload)) + payload
+
+
+def _field_packed(number: int, values: Iterable[int]) -> bytes:
+    return _field_bytes(number, b"".join(_varint(value) for value in values))
+
+
+class _Window:
+    """Counts accumulated since ``start_time``"""
+
+    __slots__ = ('start_time', 'samples', 'idle', 'dropped')
+
+    def __init__(self, start_time: float):
+        self.start_time = start_time
+        self.samples: Dict[SampleKey, int] = {}
+        self.idle = 0
+        self.dropped = 0
+
+    def profile(self, interval: float, end_time: float) -> SampledProfile:
+        return SampledProfile(interval, self.start_time, end_time, dict(self.samples), self.idle, self.dropped)
+
+
+def _encode_pprof(profile: SampledProfile) -> bytes:
+    strings: Dict[str, int] = {"": 0}
+
+    def string(value: str) -> int:
+        index = strings.get(value)
+        if index is None:
+            index = strings[value] = len(strings)
+        return index
+
+    functions: Dict[Any, int] = {}
+    function_records: List[bytes] = []
+
+    def function(code) -> int:
+        function_id = functions.get(code)
+        if function_id is None:
+            function_id = functions[code] = len(functions) + 1
+            if isinstance(code, str):
+                name, filename, line = code, "", 0
+            else:
+                name, filename, line = getattr(code, 'co_qualname', code.co_name), code.co_filename, code.co_firstlineno
+            function_records.append(_field_bytes(5, (
+                _field_varint(1, function_id) + _field_varint(2, string(name)) +
+                _field_varint(3, string(name)) + _field_varint(4, string(filename)) +
+                _field_varint(5, line))))
+        return function_id
+
+    period_ns = int(profile.interval * 1e9)
+    body = bytearray()
+    body += _field_bytes(1, _field_varint(1, string("samples")) + _field_varint(2, string("count")))
+    body += _field_bytes(1, _field_varint(1, string("cpu")) + _field_varint(2, string("nanoseconds")))
+    route_key, middleware_key = string("route"), string("middleware")
+    for (route, middleware, stack), count in profile.samples.items():
+        sample = _field_packed(1, (function(code) for code in reversed(stack)))
+        sample += _field_packed(2, (count, count * period_ns))
+        if route:
+            sample += _field_bytes(3, _field_varint(1, route_key) + _field_varint(2, string(route)))
+        if middleware:
+            sample += _field_bytes(3, _field_varint(1, middleware_key) + _field_varint(2, string(middleware)))
+        body += _field_bytes(2, sample)
+    # One location per function: location id == function id
+    for function_id in range(1, len(functions) + 1):
+        body += _field_bytes(4, _field_varint(1, function_id) + _field_bytes(4, _field_varint(1, function_id)))
+    for record in function_records:
+        body += record
+    for value in strings:
+        body += _field_bytes(6, value.encode())
+    body += _field_varint(9, int(profile.start_time * 1e9))
+    body += _field_varint(10, int((profile.end_time - profile.start_time) * 1e9))
+    body += _field_bytes(11, _field_varint(1, string("cpu")) + _field_varint(2, string("nanoseconds")))
+    body += _field_varint(12, period_ns)
+    return bytes(body)
+
+
+class SamplingProfiler:
+    """
+    Always-on stack sampler.
+
+    Args:
+        interval: seconds between samples (0.01 is 100 Hz)
+        max_depth: frames kept per stack, leaf side
+        max_stacks: distinct stacks kept; samples of further stacks are
+            counted in ``dropped_samples`` so memory stays bounded
+        include_idle: also record threads parked in selectors, locks and queues
+        router: ``Router`` used to name routes by path; handlers are named by
+            qualname otherwise
+    """
+
+    def __init__(self, interval: float = 0.01, max_depth: int = 96, max_stacks: int = 10000,
+                 include_idle: bool = False, router: Any = None):
+        self.interval = interval
+        self.max_depth = max_depth
+        self.max_stacks = max_stacks
+        self.include_idle = include_idle
+        self.router = router
+        # The current window first, then private ones opened by ``capture``
+        self._windows: Tuple[_Window, ...] = (_Window(time.time()),)
+        self._roles: Dict[Any, int] = {}
+        self._route_names: Dict[Any, str] = {}
+        self._route_count = -1
+        self._lock = threading.Lock()
+        self._thread: Optional[threading.Thread] = None
+        self._stop = threading.Event()
+        self._export_task: Optional[asyncio.Task] = None
+        self.sample_time = 0.0
+        self.sample_count = 0
+
+    @property
+    def running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
+
+    def start(self) -> None:
+        """Start sampling in a daemon thread"""
+        if self.running:
+            return
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run, name="pyserv-sampling-profiler", daemon=True)
+        self._thread.start()
+        logger.info(f"Sampling profiler started at {1 / self.interval:.0f} Hz")
+
+    def stop(self) -> None:
+        """Stop sampling; collected samples are kept"""
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join()
+            self._thread = None
+        if self._export_task is not None:
+            self._export_task.cancel()
+            self._export_task = None
+
+    def _run(self) -> None:
+        own = threading.get_ident()
+        next_time = time.monotonic()
+        while not self._stop.is_set():
+            started = time.perf_counter()
+            self.sample(exclude=own)
+            self.sample_time += time.perf_counter() - started
+            self.sample_count += 1
+            next_time += self.interval
+            delay = next_time - time.monotonic()
+            if delay < 0:
+                # Fell behind (a long GIL hold): skip missed ticks instead of bursting
+                next_time = time.monotonic()
+                delay = self.interval
+            self._stop.wait(delay)
+
+    def sample(self, exclude: Optional[int] = None) -> None:
+        """Take one sample of every thread except ``exclude``"""
+        frames = sys._current_frames()
+        for ident, frame in frames.items():
+            if ident != exclude:
+                self._record(frame)
+
+    def _record(self, frame) -> None:
+        codes = []
+        while frame is not None:
+            codes.append(frame.f_code)
+            frame = frame.f_back
+        codes.reverse()
+
+        if not self.include_idle:
+            leaf = codes[-1]
+            if (os.path.basename(leaf.co_filename), leaf.co_name) in _IDLE_LEAVES:
+                with self._lock:
+                    for window in self._windows:
+                        window.idle += 1
+                return
+
+        route, middleware = self._attribute(codes)
+        key = (route, middleware, tuple(codes[-self.max_depth:]))
+        with self._lock:
+            for window in self._windows:
+                samples = window.samples
+                count = samples.get(key)
+                if count is not None:
+                    samples[key] = count + 1
+                elif len(samples) < self.max_stacks:
+                    samples[key] = 1
+                else:
+                    window.dropped += 1
+
+    def _attribute(self, codes: List[Any]) -> Tuple[str, str]:
+        """Route and middleware active in a root-first stack of code objects"""
+        roles = self._roles
+        if len(roles) > _ROLE_CACHE_SIZE:
+            roles.clear()
+        route = middleware = ""
+        provisional = False
+        previous = 0
+        for code in codes:
+            role = roles.get(code)
+            if role is None:
+                role = roles[code] = _code_role(code)
+            if previous == _DISPATCH:
+                middleware = "" if role == _RESOLVE else _middleware_name(code)
+            elif previous == _FINAL:
+                middleware = ""
+                route, provisional = self._route_name(code)
+            elif provisional and code in self._route_names:
+                # final_handler called a wrapper; name the route by the real handler below it
+                route, provisional = self._route_names[code], False
+            previous = role
+        return route, middleware
+
+    def _route_name(self, code) -> Tuple[str, bool]:
+        """Route for a handler's code, and whether it is only a qualname guess"""
+        router = self.router
+        if router is not None and len(router.routes) != self._route_count:
+            self._index_routes(router)
+        name = self._route_names.get(code)
+        if name is not None:
+            return name, False
+        return getattr(code, 'co_qualname', code.co_name), True
+
+    def _index_routes(self, router) -> None:
+        import inspect
+
+        names = {}
+        for route in list(router.routes):
+            handler = inspect.unwrap(route.handler)
+            code = getattr(handler, '__code__', None) or getattr(getattr(handler, '__call__', None), '__code__', None)
+            if code is not None:
+                names[code] = f"{','.join(sorted(getattr(route, 'methods', ())))} {route.path}".strip()
+        self._route_names = names
+        self._route_count = len(router.routes)
+
+    def snapshot(self, reset: bool = False) -> SampledProfile:
+        """The samples so far; ``reset`` starts a new window"""
+        now = time.time()
+        with self._lock:
+            profile = self._windows[0].profile(self.interval, now)
+            if reset:
+                self._windows = (_Window(now), *self._windows[1:])
+        return profile
+
+    async def capture(self, seconds: float) -> SampledProfile:
+        """
+        The samples taken over the next ``seconds``, counted in a private
+        window so resets (e.g. by ``start_export``) meanwhile don't affect them
+        """
+        window = _Window(time.time())
+        with self._lock:
+            self._windows += (window,)
+        try:
+            await asyncio.sleep(seconds)
+        finally:
+            with self._lock:
+                self._windows = tuple(other for other in self._windows if other is not window)
+        return window.profile(self.interval, time.time())
+
+    def reset(self) -> None:
+        """Discard collected samples"""
+        self.snapshot(reset=True)
+
+    def overhead(self) -> float:
+        """Fraction of wall time spent sampling"""
+        if not self.sample_count:
+            return 0.0
+        return (self.sample_time / self.sample_count) / self.interval
+
+    def start_export(self, store: Any, interval: float = 60.0) -> asyncio.Task:
+        """
+        Every ``interval`` seconds store the window's samples with
+        ``await store.store_sampled_profile(profile)`` (a ``PerformanceProfiler``)
+        and start a new window. Runs on the current event loop.
+        """
+        async def export():
+            while True:
+                await asyncio.sleep(interval)
+                profile = self.snapshot(reset=True)
+                if not profile.samples:
+                    continue
+                try:
+                    await store.store_sampled_profile(profile)
+                except Exception as e:
+                    logger.error(f"Failed to export sampled profile: {e}")
+
+        self._export_task = asyncio.get_running_loop().create_task(export())
+        return self._export_task
+
+    def get_stats(self) -> Dict[str, Any]:
+        with self._lock:
+            window = self._windows[0]
+            stacks, total = len(window.samples), sum(window.samples.values())
+            idle, dropped = window.idle, window.dropped
+        return {
+            "running": self.running,
+            "interval": self.interval,
+            "samples": total,
+            "stacks": stacks,
+            "idle_samples": idle,
+            "dropped_samples": dropped,
+            "overhead": self.overhead(),
+        }
+
+
+def profile_endpoint(profiler: Optional['SamplingProfiler'] = None) -> Callable:
+    """
+    Route handler downloading the current profile.
+
+    ``?format=pprof`` returns gzipped pprof, anything else collapsed stacks;
+    ``?seconds=N`` returns only samples from the next N seconds:
+
+        app.route("/debug/profile")(profile_endpoint())
+    """
+    from pyserv.http import Response
+
+    async def profile(request):
+        target = profiler or get_sampling_profiler()
+        seconds = float(request.get_query_param("seconds", "0") or 0)
+        if seconds > 0:
+            data = await target.capture(min(seconds, 300.0))
+        else:
+            data = target.snapshot()
+
+        if request.get_query_param("format") == "pprof":
+            return Response(data.to_pprof(), media_type="application/octet-stream",
+                            headers={"content-disposition": 'attachment; filename="profile.pb.gz"'})
+        return Response(data.collapsed(), media_type="text/plain",
+                        headers={"content-disposition": 'attachment; filename="profile.folded"'})
+
+    return profile
+
+
+_sampling_profiler: Optional[SamplingProfiler] = None
+
+
+def get_sampling_profiler(**options) -> SamplingProfiler:
+    """Get the global sampling profiler (created, not started, on first use)"""
+    global _sampling_profiler
+    if _sampling_profiler is None:
+        _sampling_profiler = SamplingProfiler(**options)
+    return _sampling_profiler
+
+
+__all__ = ['SamplingProfiler', 'SampledProfile', 'profile_endpoint', 'get_sampling_profiler']
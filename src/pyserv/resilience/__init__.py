@@ -4,23 +4,26 @@ Provides circuit breakers, retry mechanisms, graceful degradation,
 auto-recovery, and load balancing for mission-critical applications.
 """
 
-from .circuit_breaker import (
-    CircuitBreaker, CircuitBreakerConfig, CircuitBreakerState,
-    CircuitBreakerManager, CircuitBreakerOpenException, CircuitBreakerTimeoutException
-)
-from .retry import (
-    RetryMechanism, RetryConfig, RetryStrategy, RetryCondition,
-    RetryManager, with_exponential_backoff, with_fixed_retry
-)
-from .degradation import (
-    GracefulDegradation, DegradationStrategy, DegradationRule
-)
-from .auto_recovery import (
-    AutoRecoveryManager, HealthCheck, HealthStatus, RecoveryStrategy, SystemMetrics
-)
-from .load_balancer import (
-    LoadBalancer, LoadBalancingStrategy, BackendServer, LoadBalancerManager
-)
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".circuit_breaker": [
+        "CircuitBreaker", "CircuitBreakerConfig", "CircuitBreakerState",
+        "CircuitBreakerManager", "CircuitBreakerOpenException", "CircuitBreakerTimeoutException",
+    ],
+    ".retry": [
+        "RetryMechanism", "RetryConfig", "RetryStrategy", "RetryCondition", "RetryManager",
+        "with_exponential_backoff", "with_fixed_retry",
+    ],
+    ".degradation": ["GracefulDegradation", "DegradationStrategy", "DegradationRule"],
+    ".auto_recovery": [
+        "AutoRecoveryManager", "HealthCheck", "HealthStatus", "RecoveryStrategy",
+        "SystemMetrics",
+    ],
+    ".load_balancer": [
+        "LoadBalancer", "LoadBalancingStrategy", "BackendServer", "LoadBalancerManager",
+    ],
+})
 
 __all__ = [
     # Circuit Breaker
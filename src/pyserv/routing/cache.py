@@ -0,0 +1,107 @@
+"""
+Bounded route-match cache for Pyserv routing system.
+
+A fixed number of slots is evicted with the CLOCK (second-chance)
+algorithm: hits set a reference bit, and the clock hand clears bits until
+it finds an unreferenced slot to reuse. New entries start unreferenced, so
+one-off URLs from scanners are the first to go while hot routes survive.
+
+The router only caches matches for static routes. Parameterised routes
+are resolved through the compiled radix tree, which holds one entry per
+route template, so distinct URLs like ``/users/1``, ``/users/2`` never
+grow the cache.
+"""
+
+from typing import Any, Dict, Hashable, List, Optional
+
+
+class RouteCache:
+    """Fixed-capacity CLOCK cache with hit/miss/eviction counters."""
+
+    __slots__ = ('capacity', '_index', '_keys', '_values', '_referenced', '_hand',
+                 'hits', 'misses', 'evictions')
+
+    def __init__(self, capacity: int = 4096):
+        if capacity < 1:
+            raise ValueError("capacity must be at least 1")
+        self.capacity = capacity
+        self._index: Dict[Hashable, int] = {}
+        self._keys: List[Optional[Hashable]] = []
+        self._values: List[Any] = []
+        self._referenced = bytearray(capacity)
+        self._hand = 0
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+
+    def __len__(self) -> int:
+        return len(self._index)
+
+    def __contains__(self, key: Hashable) -> bool:
+        return key in self._index
+
+    def get(self, key: Hashable) -> Any:
+        """Return the cached value for key, or None on a miss."""
+        slot = self._index.get(key)
+        if slot is None:
+            self.misses += 1
+            return None
+        self._referenced[slot] = 1
+        self.hits += 1
+        return self._values[slot]
+
+    def put(self, key: Hashable, value: Any) -> None:
+        """Cache value under key, evicting a cold entry when full."""
+        slot = self._index.get(key)
+        if slot is not None:
+            self._values[slot] = value
+            self._referenced[slot] = 1
+            return
+
+        if len(self._keys) < self.capacity:
+            slot = len(self._keys)
+            self._keys.append(key)
+            self._values.append(value)
+        else:
+            slot = self._evict()
+            self._keys[slot] = key
+            self._values[slot] = value
+
+        self._referenced[slot] = 0
+        self._index[key] = slot
+
+    def _evict(self) -> int:
+        """Advance the clock hand to an unreferenced slot and free it."""
+        referenced = self._referenced
+        while True:
+            slot = self._hand
+            self._hand = (slot + 1) % self.capacity
+            if referenced[slot]:
+                referenced[slot] = 0
+                continue
+            del self._index[self._keys[slot]]
+            self.evictions += 1
+            return slot
+
+    def clear(self) -> None:
+        """Drop all entries, keeping the counters."""
+        self._index.clear()
+        self._keys.clear()
+        self._values.clear()
+        self._referenced = bytearray(self.capacity)
+        self._hand = 0
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Get cache statistics."""
+        lookups = self.hits + self.misses
+        return {
+            "size": len(self._index),
+            "capacity": self.capacity,
+            "hits": self.hits,
+            "misses": self.misses,
+            "evictions": self.evictions,
+            "hit_rate": self.hits / lookups if lookups else 0.0,
+        }
+
+
+__all__ = ['RouteCache']
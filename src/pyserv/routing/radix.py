@@ -0,0 +1,173 @@
+"""
+Radix-tree route matcher for Pyserv routing system.
+
+Routes are indexed by path segment into a tree of static, parameter and
+wildcard edges, built once from each ``Route.segments`` and rebuilt only
+when the route table changes. A lookup walks one branch per distinct edge
+instead of running every route's regex, so cost grows with path depth
+rather than route count.
+
+Matching semantics are identical to the regex path: among all routes that
+match, the one with the highest priority wins and ties go to the route
+registered first. Routes whose paths can't be expressed as whole segments
+(e.g. ``/files/{name}.txt``) keep using their compiled regex.
+
+A native tree from ``pyserv.core.route_tree`` is used when it is built.
+"""
+
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+from urllib.parse import unquote
+
+from pyserv.core import load_extension
+
+_route_tree = load_extension("route_tree")
+
+# Segment markers shared with the native tree
+PARAM = None
+WILDCARD = Ellipsis
+
+
+class _Node:
+    """Tree node holding child edges and the routes that end here."""
+
+    __slots__ = ('static', 'param', 'routes', 'wildcard')
+
+    def __init__(self):
+        self.static: Dict[str, '_Node'] = {}
+        self.param: Optional['_Node'] = None
+        self.routes: List[Tuple[int, Any]] = []
+        self.wildcard: List[Tuple[int, Any]] = []
+
+
+class RadixTree:
+    """
+    Pure-Python segment radix tree.
+
+    ``insert`` takes a sequence of segments where a str is a literal,
+    ``PARAM`` captures one non-empty segment and a trailing ``WILDCARD``
+    captures the rest of the path. ``lookup`` returns ``(entry, values)``
+    for every matching entry ordered by the rank given at insert time,
+    where values are the captured parameter segments.
+    """
+
+    def __init__(self):
+        self._root = _Node()
+        self._size = 0
+
+    def __len__(self) -> int:
+        return self._size
+
+    def insert(self, segments: Sequence[Any], rank: int, entry: Any) -> None:
+        node = self._root
+        for index, segment in enumerate(segments):
+            if segment is WILDCARD:
+                if index != len(segments) - 1:
+                    raise ValueError("wildcard must be the last segment")
+                node.wildcard.append((rank, entry))
+                node.wildcard.sort(key=lambda item: item[0])
+                self._size += 1
+                return
+            if segment is PARAM:
+                if node.param is None:
+                    node.param = _Node()
+                node = node.param
+            else:
+                child = node.static.get(segment)
+                if child is None:
+                    child = node.static[segment] = _Node()
+                node = child
+
+        node.routes.append((rank, entry))
+        node.routes.sort(key=lambda item: item[0])
+        self._size += 1
+
+    def lookup(self, path: str) -> List[Tuple[Any, Tuple[str, ...]]]:
+        parts = path.split('/')
+        depth_limit = len(parts)
+        found: List[Tuple[int, Any, Tuple[str, ...]]] = []
+        stack = [(self._root, 0, ())]
+
+        while stack:
+            node, depth, values = stack.pop()
+
+            # A trailing wildcard needs at least one more (possibly empty) segment
+            if node.wildcard and depth < depth_limit:
+                found.extend((rank, entry, values) for rank, entry in node.wildcard)
+
+            if depth == depth_limit:
+                found.extend((rank, entry, values) for rank, entry in node.routes)
+                continue
+
+            part = parts[depth]
+            if node.param is not None and part:
+                stack.append((node.param, depth + 1, values + (part,)))
+            child = node.static.get(part)
+            if child is not None:
+                stack.append((child, depth + 1, values))
+
+        if len(found) > 1:
+            found.sort(key=lambda item: item[0])
+        return [(entry, values) for _, entry, values in found]
+
+
+class CompiledRoutes:
+    """
+    Route table compiled for fast matching.
+
+    Built from a router's routes in registration order; ranks encode the
+    priority order used by the regex matcher (priority desc, then order).
+    """
+
+    def __init__(self, routes: Sequence[Any], native: bool = True):
+        self.size = len(routes)
+        self.backend = "native" if native and _route_tree is not None else "python"
+        self._tree = _route_tree.RouteTree() if self.backend == "native" else RadixTree()
+        self._fallback: List[Tuple[int, Any]] = []
+
+        ordered = sorted(enumerate(routes), key=lambda item: (-item[1].priority, item[0]))
+        for rank, (_, route) in enumerate(ordered):
+            if route.segments is None:
+                self._fallback.append((rank, route))
+                continue
+
+            segments = []
+            names = []
+            for kind, value in route.segments:
+                if kind == 'param':
+                    segments.append(PARAM)
+                    names.append(value)
+                elif kind == 'wildcard':
+                    segments.append(WILDCARD)
+                else:
+                    segments.append(value)
+            self._tree.insert(segments, rank, (rank, route, tuple(names)))
+
+    def match(self, method: str, path: str) -> Optional[Tuple[Any, Dict[str, Any]]]:
+        """
+        Find the best route for a request.
+
+        Returns:
+            (route, params) tuple or None if no route matches
+        """
+        best_rank = None
+        best = None
+
+        for (rank, route, names), values in self._tree.lookup(unquote(path)):
+            if method not in route.methods or route.host or route.schemes:
+                continue
+            params = route.convert_params(dict(zip(names, values)))
+            if params is not None:
+                best_rank, best = rank, (route, params)
+                break
+
+        for rank, route in self._fallback:
+            if best_rank is not None and rank > best_rank:
+                break
+            params = route.match(path, method)
+            if params is not None:
+                return route, params
+
+        return best
+
+
+__all__ = ['RadixTree', 'CompiledRoutes', 'PARAM', 'WILDCARD']
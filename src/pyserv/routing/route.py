@@ -10,6 +10,12 @@ from urllib.parse import unquote
 from pyserv.types import RouteType, RouteConfig
 from pyserv.middleware.resolver import middleware_resolver
 
+# Matches {name} and {name:type} path parameters
+_PARAM_PATTERN = re.compile(r'\{([^:}]+)(?::([^}]+))?\}')
+
+# Characters that keep a path segment out of the radix matcher
+_SEGMENT_SPECIAL = re.compile(r'[{}*?\[\]|\\]')
+
 
 class Route:
     """
@@ -66,6 +72,7 @@ class Route:
         self.pattern: Optional[Pattern] = None
         self.param_names: List[str] = []
         self.param_types: Dict[str, type] = {}
+        self.segments: Optional[List[Tuple[str, Optional[str]]]] = None
         self._compile_pattern()
 
     def _resolve_middleware(self, middleware_specs: List[Any]) -> List[Callable]:
@@ -79,39 +86,62 @@ class Route:
 
     def _compile_pattern(self) -> None:
         """Compile regex pattern with enhanced parameter handling."""
-        # Convert path parameters like {id:int} or {id} to regex groups
-        pattern = self.path
-
-        # Handle typed parameters like {id:int}, {name:str}, etc.
-        typed_param_pattern = r'\{([^:}]+):([^}]+)\}'
-        def typed_param_replacer(match):
-            param_name = match.group(1)
-            param_type = match.group(2)
-            self.param_names.append(param_name)
-            self.param_types[param_name] = self._get_type_from_string(param_type)
-            return f'(?P<{param_name}>[^/]+)'
-
-        pattern = re.sub(typed_param_pattern, typed_param_replacer, pattern)
-
-        # Handle regular parameters like {id}
-        simple_param_pattern = r'\{([^}]+)\}'
-        def simple_param_replacer(match):
-            param_name = match.group(1)
+        # Convert path parameters like {id:int} or {id} to regex groups,
+        # escaping the static text between them
+        regex_parts = []
+        position = 0
+        for match in _PARAM_PATTERN.finditer(self.path):
+            regex_parts.append(self._escape_static(self.path[position:match.start()]))
+            param_name, param_type = match.group(1), match.group(2)
             if param_name not in self.param_names:
                 self.param_names.append(param_name)
-                self.param_types[param_name] = str  # Default to string
-            return f'(?P<{param_name}>[^/]+)'
+                self.param_types[param_name] = (
+                    self._get_type_from_string(param_type) if param_type else str
+                )
+            regex_parts.append(f'(?P<{param_name}>[^/]+)')
+            position = match.end()
+        regex_parts.append(self._escape_static(self.path[position:]))
 
-        pattern = re.sub(simple_param_pattern, simple_param_replacer, pattern)
-
-        # Escape other special regex characters
-        pattern = re.sub(r'([.+^$()])', r'\\\1', pattern)
-        # Convert wildcards
-        pattern = pattern.replace('*', '.*')
         # Add start and end anchors
-        pattern = f'^{pattern}$'
+        self.pattern = re.compile(f"^{''.join(regex_parts)}$")
+        self.segments = self._compile_segments()
+
+    @staticmethod
+    def _escape_static(text: str) -> str:
+        """Escape literal path text and convert wildcards."""
+        return re.sub(r'([.+^$()])', r'\\\1', text).replace('*', '.*')
+
+    def _compile_segments(self) -> Optional[List[Tuple[str, Optional[str]]]]:
+        """
+        Split the path into (kind, value) segments for the radix matcher.
+
+        Kinds are "static" (literal text), "param" (a whole-segment
+        parameter, value is its name) and "wildcard" (a trailing "*").
+        Returns None when the path needs the regex, e.g. "/files/{name}.txt".
+        """
+        parts = self.path.split('/')
+        segments = []
+        for index, part in enumerate(parts):
+            param = _PARAM_PATTERN.fullmatch(part)
+            if param:
+                segments.append(('param', param.group(1)))
+            elif part == '*' and index == len(parts) - 1:
+                segments.append(('wildcard', None))
+            elif _SEGMENT_SPECIAL.search(part):
+                return None
+            else:
+                segments.append(('static', part))
+        return segments
 
-        self.pattern = re.compile(pattern)
+    @property
+    def is_static(self) -> bool:
+        """True when the route matches exactly one path."""
+        return not self.param_names and '*' not in self.path
+
+    @property
+    def priority(self) -> int:
+        """Matching priority; higher values are tried first."""
+        return getattr(self.config, 'priority', 0) or 0
 
     def _get_type_from_string(self, type_str: str) -> type:
         """Convert string type representation to actual type."""
@@ -146,8 +176,15 @@ class Route:
         if not match:
             return None
 
-        params = match.groupdict()
+        return self.convert_params(match.groupdict())
 
+    def convert_params(self, params: Dict[str, str]) -> Optional[Dict[str, Any]]:
+        """
+        Apply defaults and type conversion to raw path parameters.
+
+        Returns:
+            Dictionary of converted parameters or None if conversion fails
+        """
         # Apply defaults for missing parameters
         for key, default_value in self.defaults.items():
             if key not in params:
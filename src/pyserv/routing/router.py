@@ -26,6 +26,8 @@ logger = logging.getLogger(__name__)
 
 from .route import Route, WebSocketRoute
 from .group import RouteGroup
+from .radix import CompiledRoutes
+from .cache import RouteCache
 from pyserv.middleware.base import MiddlewareType
 
 
@@ -55,13 +57,15 @@ class Router:
     - Fallback routes
     """
 
-    def __init__(self):
+    def __init__(self, cache_size: int = 4096):
         self.routes: List[Route] = []
         self.websocket_routes: List[Route] = []
         self.mounted_routers: Dict[str, 'Router'] = {}
         self.named_routes: Dict[str, Route] = {}
-        self._route_cache: Dict[str, Tuple[Optional[Route], Optional[Dict[str, str]]]] = {}
+        self._route_cache = RouteCache(cache_size)
         self._cache_enabled = True
+        self._compiled: Optional[CompiledRoutes] = None
+        self._radix_enabled = True
         self.fallback_route: Optional[Route] = None
         self.intended_url: Optional[str] = None
         self._redirects: Dict[str, str] = {}
@@ -83,8 +87,8 @@ class Router:
         if name:
             self.named_routes[name] = route
 
-        # Clear cache when routes change
-        self._route_cache.clear()
+        # Clear cache and compiled matcher when routes change
+        self._invalidate()
         return route
 
     def add_websocket_route(
@@ -109,7 +113,7 @@ class Router:
         """Add route to router."""
         route = Route(path, handler, methods)
         self.routes.append(route)
-        self._route_cache.clear()  # Clear cache when routes change
+        self._invalidate()  # Clear cache when routes change
 
     def match(self, method: str, path: str) -> Optional[RouteMatch]:
         """
@@ -118,14 +122,13 @@ class Router:
         Returns:
             RouteMatch object or None if no match
         """
-        cache_key = f"{method}:{path}"
+        cache_key = (method, path)
 
         # Check cache first
-        if cache_key in self._route_cache:
-            cached = self._route_cache[cache_key]
-            if cached:
+        if self._cache_enabled:
+            cached = self._route_cache.get(cache_key)
+            if cached is not None:
                 return cached
-            return None
 
         # Check mounted routers first
         for mount_path, router in self.mounted_routers.items():
@@ -133,38 +136,57 @@ class Router:
                 remaining_path = path[len(mount_path):]
                 match_result = router.match(method, remaining_path)
                 if match_result:
-                    if self._cache_enabled:
-                        self._route_cache[cache_key] = match_result
+                    self._cache_match(cache_key, match_result)
                     return match_result
 
-        # Find matching route (sorted by priority)
-        for route in sorted(self.routes, key=lambda r: r.config.get('priority', 0), reverse=True):
+        # Find matching route (highest priority first)
+        if self._radix_enabled:
+            found = self._get_compiled().match(method, path)
+        else:
+            found = self._match_linear(method, path)
+
+        if found is not None:
+            route, params = found
+            # Create RouteMatch object
+            route_match = RouteMatch(
+                handler=route.handler,
+                params=params,
+                route=route,
+                middleware=route.middleware
+            )
+            self._cache_match(cache_key, route_match)
+            return route_match
+
+        # Negative results aren't cached so unknown URLs can't fill the cache
+        return None
+
+    def _match_linear(self, method: str, path: str) -> Optional[Tuple[Route, Dict[str, Any]]]:
+        """Try each route's regex in priority order (used when radix matching is off)."""
+        for route in sorted(self.routes, key=lambda r: r.priority, reverse=True):
             params = route.match(path, method)
             if params is not None:
-                # Create RouteMatch object
-                route_match = RouteMatch(
-                    handler=route.handler,
-                    params=params,
-                    route=route,
-                    middleware=route.middleware
-                )
-                # Cache positive result
-                self._route_cache[cache_key] = route_match
-                return route_match
-
-        # Cache negative result
-        self._route_cache[cache_key] = None
+                return route, params
         return None
 
+    def _get_compiled(self) -> CompiledRoutes:
+        """Get the radix matcher, rebuilding it if the route table changed."""
+        if self._compiled is None or self._compiled.size != len(self.routes):
+            self._compiled = CompiledRoutes(self.routes)
+        return self._compiled
+
+    def _invalidate(self) -> None:
+        """Drop cached matches and the compiled matcher."""
+        self._route_cache.clear()
+        self._compiled = None
+
     def match_websocket(self, path: str) -> Optional[RouteMatch]:
         """Match WebSocket connection."""
-        cache_key = f"WS:{path}"
+        cache_key = ("WS", path)
 
-        if cache_key in self._route_cache:
-            cached = self._route_cache[cache_key]
-            if cached:
+        if self._cache_enabled:
+            cached = self._route_cache.get(cache_key)
+            if cached is not None:
                 return cached
-            return None
 
         for route in self.websocket_routes:
             params = route.match(path, "GET")
@@ -176,12 +198,21 @@ class Router:
                     route=route,
                     middleware=route.middleware
                 )
-                self._route_cache[cache_key] = route_match
+                self._cache_match(cache_key, route_match)
                 return route_match
 
-        self._route_cache[cache_key] = None
         return None
 
+    def _cache_match(self, cache_key: Tuple[str, str], route_match: RouteMatch) -> None:
+        """
+        Cache a match by exact URL if its route is static.
+
+        Parameterised routes are served by the compiled matcher instead, so
+        each distinct URL under a template doesn't take a cache slot.
+        """
+        if self._cache_enabled and route_match.route.is_static:
+            self._route_cache.put(cache_key, route_match)
+
     def get_route_by_name(self, name: str) -> Optional[Route]:
         """Get route by name."""
         return self.named_routes.get(name)
@@ -210,7 +241,20 @@ class Router:
 
     def clear_cache(self) -> None:
         """Clear route matching cache."""
-        self._route_cache.clear()
+        self._invalidate()
+
+    def compile(self) -> int:
+        """
+        Build the radix matcher now (and for mounted routers) instead of on
+        the first request; a pre-fork master calls this so workers share it.
+        Returns the number of routes compiled.
+        """
+        count = len(self.routes)
+        if self._radix_enabled:
+            self._get_compiled()
+        for router in self.mounted_routers.values():
+            count += router.compile()
+        return count
 
     def get_stats(self) -> Dict[str, Any]:
         """Get router statistics."""
@@ -219,7 +263,9 @@ class Router:
             "websocket_routes": len(self.websocket_routes),
             "mounted_routers": len(self.mounted_routers),
             "cache_size": len(self._route_cache),
-            "named_routes": len(self.named_routes)
+            "cache": self._route_cache.get_stats(),
+            "named_routes": len(self.named_routes),
+            "matcher": self._get_compiled().backend if self._radix_enabled else "regex"
         }
 
     def add_permanent_redirect(self, from_path: str, to_path: str, name: Optional[str] = None):
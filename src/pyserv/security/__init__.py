@@ -4,21 +4,27 @@ Provides enterprise-grade security features for mission-critical applications.
 """
 
 # Authentication moved to auth module - use from pyserv.auth import AuthManager
-from .encryption import EncryptionService
-from .audit import AuditLogger
-from .rbac import RoleBasedAccessControl
-from .rate_limiter import RateLimiter
-from .csrf import CSRFProtection
-from .headers import SecurityHeaders
-from .file_validation import (
-    FileValidator, BasicFileValidator, ClamAVValidator,
-    AWSGuardDutyValidator, CompositeValidator, SecurityManager,
-    get_security_manager
-)
+# Components load on first access; quantum_security, blockchain and web3 stay unloaded unless used
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".encryption": ["EncryptionService"],
+    ".audit": ["AuditLogger", "AuditRing"],
+    ".rbac": ["RoleBasedAccessControl"],
+    ".rate_limiter": ["RateLimiter"],
+    ".csrf": ["CSRFProtection"],
+    ".headers": ["SecurityHeaders"],
+    ".file_validation": [
+        "FileValidator", "BasicFileValidator", "ClamAVValidator",
+        "AWSGuardDutyValidator", "CompositeValidator", "SecurityManager",
+        "get_security_manager",
+    ],
+}, submodules=["quantum_security", "blockchain", "web3", "zero_trust", "webassembly"])
 
 __all__ = [
     'EncryptionService',
     'AuditLogger',
+    'AuditRing',
     'RoleBasedAccessControl',
     'RateLimiter',
     'CSRFProtection',
@@ -1,11 +1,24 @@
 """
 Comprehensive audit logging for compliance and security monitoring.
+
+Entries are published to a bounded in-memory ring and written by a background
+thread, so logging an event never touches the disk on the event loop. The writer
+group-commits batches (one write per batch, fsync per a configurable policy),
+tracks the file size itself for rotation, and maintains a fixed-width sidecar
+index (``<log>.idx``) that lets recent and filtered queries read only the lines
+they return instead of the whole file.
 """
 
 import json
 import asyncio
+import os
+import struct
+import threading
+import time
+import zlib
+from collections import deque
 from datetime import datetime
-from typing import Dict, List, Any, Optional
+from typing import Deque, Dict, Iterator, List, Any, Optional, Tuple
 from dataclasses import dataclass
 from enum import Enum
 import logging
@@ -36,30 +49,263 @@ class AuditEntry:
     success: bool
     correlation_id: Optional[str] = None
 
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            'timestamp': self.timestamp.isoformat(),
+            'event_type': self.event_type.value,
+            'user_id': self.user_id,
+            'session_id': self.session_id,
+            'resource': self.resource,
+            'action': self.action,
+            'details': self.details,
+            'ip_address': self.ip_address,
+            'user_agent': self.user_agent,
+            'success': self.success,
+            'correlation_id': self.correlation_id
+        }
+
+    @classmethod
+    def from_dict(cls, data: Dict[str, Any]) -> 'AuditEntry':
+        return cls(
+            timestamp=datetime.fromisoformat(data['timestamp']),
+            event_type=AuditEvent(data['event_type']),
+            user_id=data['user_id'],
+            session_id=data['session_id'],
+            resource=data['resource'],
+            action=data['action'],
+            details=data['details'],
+            ip_address=data['ip_address'],
+            user_agent=data['user_agent'],
+            success=data['success'],
+            correlation_id=data.get('correlation_id')
+        )
+
+
+class AuditRing:
+    """
+    Bounded ring of audit entries shared by the file writer and other consumers.
+
+    Every entry gets a sequence number. The file writer is the durable consumer:
+    producers may not run more than ``capacity`` entries ahead of it, so nothing
+    is overwritten before it is on disk. Other consumers (e.g. SIEM forwarding)
+    keep their own cursor and are told how many entries they lost if they fall
+    more than ``capacity`` behind.
+    """
+
+    def __init__(self, capacity: int = 65536):
+        self.capacity = capacity
+        self._items: List[Optional[AuditEntry]] = [None] * capacity
+        self._head = 0
+        self._durable = 0
+        self._cond = threading.Condition()
+        self._readers_waiting = 0
+        self._space_waiters: Deque[Tuple[asyncio.AbstractEventLoop, asyncio.Future]] = deque()
+
+    @property
+    def head(self) -> int:
+        """Sequence number the next entry will get"""
+        return self._head
+
+    @property
+    def pending(self) -> int:
+        """Entries published but not yet committed by the durable consumer"""
+        return self._head - self._durable
+
+    def publish(self, entry: AuditEntry) -> bool:
+        """Append an entry; False if the durable consumer is a full ring behind"""
+        with self._cond:
+            if self._head - self._durable >= self.capacity:
+                return False
+            self._items[self._head % self.capacity] = entry
+            self._head += 1
+            # Signalling costs more than the append itself, so only do it for a parked reader
+            if self._readers_waiting:
+                self._cond.notify_all()
+            return True
+
+    def read(self, cursor: int, max_items: int, timeout: float = 0.0) -> Tuple[List[AuditEntry], int, int]:
+        """
+        Read entries published after ``cursor``.
+
+        Args:
+            cursor: Sequence number of the first entry wanted
+            max_items: Upper bound on entries returned
+            timeout: Seconds to wait for an entry if none is available
+
+        Returns:
+            ``(entries, next_cursor, lost)`` where ``lost`` counts entries already overwritten
+        """
+        with self._cond:
+            if timeout and self._head <= cursor:
+                self._readers_waiting += 1
+                try:
+                    self._cond.wait(timeout)
+                finally:
+                    self._readers_waiting -= 1
+            start = max(cursor, self._head - self.capacity)
+            end = min(self._head, start + max_items)
+            entries = [self._items[seq % self.capacity] for seq in range(start, end)]
+        return entries, end, start - cursor
+
+    def commit(self, cursor: int) -> None:
+        """Record durable progress and wake producers waiting for space"""
+        with self._cond:
+            self._durable = max(self._durable, cursor)
+            waiters = list(self._space_waiters)
+            self._space_waiters.clear()
+            self._cond.notify_all()
+        for loop, future in waiters:
+            loop.call_soon_threadsafe(_resolve, future)
+
+    def wake(self) -> None:
+        """Wake a consumer blocked in ``read``"""
+        with self._cond:
+            self._cond.notify_all()
+
+    async def wait_for_space(self) -> None:
+        """Wait until the durable consumer has made room"""
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+        with self._cond:
+            if self._head - self._durable < self.capacity:
+                return
+            self._space_waiters.append((loop, future))
+        await future
+
+
+def _resolve(future: asyncio.Future) -> None:
+    if not future.done():
+        future.set_result(None)
+
+
+# Sidecar index record: line offset, line length, timestamp, event code, success, crc32(user_id)
+INDEX_RECORD = struct.Struct("<QIdBBI")
+
+_EVENT_CODES = {event.value: code for code, event in enumerate(AuditEvent)}
+_UNKNOWN_EVENT = 255
+
+FSYNC_POLICIES = ("always", "interval", "never")
+
+# Longest pause between attempts to write a batch that failed
+_MAX_RETRY_DELAY = 1.0
+
+
+class _BatchError(Exception):
+    """A batch write failed after its first ``written`` entries reached the log"""
+
+    def __init__(self, written: int):
+        super().__init__(written)
+        self.written = written
+
+
+def _user_hash(user_id: Optional[str]) -> int:
+    return 0 if user_id is None else zlib.crc32(str(user_id).encode())
+
+
+def _index_record(offset: int, line: bytes, data: Dict[str, Any]) -> bytes:
+    try:
+        timestamp = datetime.fromisoformat(data['timestamp']).timestamp()
+    except (KeyError, TypeError, ValueError):
+        timestamp = 0.0
+    return INDEX_RECORD.pack(offset, len(line), timestamp,
+                             _EVENT_CODES.get(data.get('event_type'), _UNKNOWN_EVENT),
+                             bool(data.get('success')), _user_hash(data.get('user_id')))
+
+
+def _reverse_lines(path: Path, block_size: int = 64 * 1024) -> Iterator[bytes]:
+    """Yield the lines of a file from last to first, reading fixed-size blocks from the end"""
+    with open(path, 'rb') as f:
+        position = f.seek(0, os.SEEK_END)
+        remainder = b''
+        while position > 0:
+            step = min(block_size, position)
+            position -= step
+            f.seek(position)
+            lines = (f.read(step) + remainder).split(b'\n')
+            remainder = lines.pop(0)
+            for line in reversed(lines):
+                if line:
+                    yield line
+        if remainder:
+            yield remainder
+
+
 class AuditLogger:
     """
     Comprehensive audit logging system for compliance.
     """
 
-    def __init__(self, log_file: str = "audit.log", max_file_size: int = 100 * 1024 * 1024):
+    def __init__(self, log_file: str = "audit.log", max_file_size: int = 100 * 1024 * 1024,
+                 buffer_size: int = 65536, batch_size: int = 512, fsync: str = "interval",
+                 fsync_interval: float = 1.0, flush_interval: float = 0.05,
+                 overflow: str = "block", index: bool = True):
+        """
+        Args:
+            log_file: Path of the JSON-lines audit log
+            max_file_size: Rotate once the log grows past this many bytes
+            buffer_size: Capacity of the in-memory ring between producers and the writer
+            batch_size: Most entries written per group commit
+            fsync: ``"always"`` (every batch), ``"interval"`` (at most every ``fsync_interval``) or ``"never"``
+            fsync_interval: Seconds between fsyncs under the ``"interval"`` policy
+            flush_interval: Longest the writer waits for more entries before writing what it has
+            overflow: ``"block"`` waits (without blocking the loop) when the ring is full, ``"drop"`` discards
+            index: Maintain the ``<log_file>.idx`` sidecar index
+        """
+        if fsync not in FSYNC_POLICIES:
+            raise ValueError(f"fsync must be one of {FSYNC_POLICIES}")
         self.log_file = Path(log_file)
+        self.index_file = Path(f"{log_file}.idx")
         self.max_file_size = max_file_size
-        self._queue: asyncio.Queue[AuditEntry] = asyncio.Queue()
-        self._running = False
+        self.batch_size = batch_size
+        self.fsync = fsync
+        self.fsync_interval = fsync_interval
+        self.flush_interval = flush_interval
+        self.overflow = overflow
+        self.use_index = index
+        self.buffer = AuditRing(buffer_size)
         self.correlation_id = None
+        self.stats = {'written': 0, 'batches': 0, 'fsyncs': 0, 'rotations': 0, 'dropped': 0, 'errors': 0}
+
+        self._thread: Optional[threading.Thread] = None
+        self._stopping = False
+        self._log_fd: Optional[int] = None
+        self._index_fd: Optional[int] = None
+        self._size = 0
+        self._index_ready = False
+        self._last_fsync = 0.0
+        self._unsynced = False
+
+    @property
+    def _running(self) -> bool:
+        return self._thread is not None and self._thread.is_alive()
 
     async def start(self):
         """Start audit logging service."""
-        if not self._running:
-            self._running = True
-            asyncio.create_task(self._process_queue())
+        self._start_writer()
 
     async def stop(self):
         """Stop audit logging service."""
-        self._running = False
-        # Process remaining entries
-        while not self._queue.empty():
-            await asyncio.sleep(0.1)
+        thread = self._thread
+        if thread is None:
+            return
+        # The writer drains every published entry and fsyncs before exiting
+        self._stopping = True
+        self.buffer.wake()
+        await asyncio.get_running_loop().run_in_executor(None, thread.join)
+        self._thread = None
+
+    async def flush(self):
+        """Wait until every entry logged so far has been written."""
+        target = self.buffer.head
+        while self._running and self.buffer._durable < target:
+            await asyncio.sleep(self.flush_interval / 4)
+
+    def _start_writer(self) -> None:
+        if self._running:
+            return
+        self._stopping = False
+        self._thread = threading.Thread(target=self._run_writer, name="pyserv-audit-writer", daemon=True)
+        self._thread.start()
 
     async def log_event(self, event_type: AuditEvent, user_id: Optional[str],
                        session_id: Optional[str], resource: str, action: str,
@@ -80,121 +326,325 @@ class AuditLogger:
             correlation_id=self.correlation_id
         )
 
-        await self._queue.put(entry)
+        if not self._running:
+            self._start_writer()
+        while not self.buffer.publish(entry):
+            if self.overflow == "drop":
+                self.stats['dropped'] += 1
+                if self.stats['dropped'] % 1000 == 1:
+                    logging.error(f"Audit buffer full, dropped {self.stats['dropped']} entries so far")
+                return
+            await self.buffer.wait_for_space()
 
-    async def _process_queue(self):
-        """Process audit log queue."""
-        while self._running:
-            try:
-                if not self._queue.empty():
-                    entry = await self._queue.get()
-                    await self._write_entry(entry)
-                    self._queue.task_done()
-                else:
-                    await asyncio.sleep(0.1)
-            except Exception as e:
-                logging.error(f"Audit logging error: {e}")
-
-    async def _write_entry(self, entry: AuditEntry):
-        """Write audit entry to file."""
-        # Check file size and rotate if necessary
-        if self.log_file.exists() and self.log_file.stat().st_size > self.max_file_size:
-            await self._rotate_log()
-
-        log_data = {
-            'timestamp': entry.timestamp.isoformat(),
-            'event_type': entry.event_type.value,
-            'user_id': entry.user_id,
-            'session_id': entry.session_id,
-            'resource': entry.resource,
-            'action': entry.action,
-            'details': entry.details,
-            'ip_address': entry.ip_address,
-            'user_agent': entry.user_agent,
-            'success': entry.success,
-            'correlation_id': entry.correlation_id
-        }
+    # Writer thread
 
-        log_line = json.dumps(log_data, default=str) + '\n'
+    def _run_writer(self) -> None:
+        try:
+            self._open()
+        except Exception as e:
+            logging.error(f"Audit logging error: cannot open {self.log_file}: {e}")
+            self.stats['errors'] += 1
+            # The first batch retries the open
+            self._close()
 
-        with open(self.log_file, 'a') as f:
-            f.write(log_line)
+        cursor = self.buffer._durable
+        retry_delay = 0.0
+        while True:
+            entries, end, _ = self.buffer.read(cursor, self.batch_size, timeout=self.flush_interval)
+            if entries:
+                written = len(entries)
+                try:
+                    if self._log_fd is None:
+                        self._open()
+                    self._write_batch(entries)
+                    retry_delay = 0.0
+                except Exception as e:
+                    written = e.written if isinstance(e, _BatchError) else 0
+                    logging.error(f"Audit logging error: {e.__cause__ or e}")
+                    self.stats['errors'] += 1
+                    # Reopen before the retry, in case a rotation left the descriptors half-replaced
+                    self._close()
+                    if self._stopping and retry_delay >= _MAX_RETRY_DELAY:
+                        # Shutting down and still failing after backing off: give up instead of hanging
+                        self.stats['dropped'] += len(entries) - written
+                        written = len(entries)
+                    else:
+                        retry_delay = min(max(retry_delay * 2, self.flush_interval), _MAX_RETRY_DELAY)
+                # Unwritten entries stay pending; producers wait on (or drop into) the ring meanwhile
+                cursor = end - len(entries) + written
+                self.buffer.commit(cursor)
+                if written < len(entries):
+                    time.sleep(retry_delay)
+                    continue
+            self._maybe_fsync()
+            if self._stopping and self.buffer.head <= cursor:
+                break
 
-    async def _rotate_log(self):
-        """Rotate audit log file."""
-        timestamp = datetime.now().strftime("%Y%m%d_%H%M%S")
-        backup_file = self.log_file.with_suffix(f'.{timestamp}.bak')
-        self.log_file.rename(backup_file)
+        self._maybe_fsync(force=True)
+        self._close()
+
+    def _open(self) -> None:
+        self.log_file.parent.mkdir(parents=True, exist_ok=True)
+        self._log_fd = os.open(self.log_file, os.O_WRONLY | os.O_CREAT | os.O_APPEND, 0o640)
+        # The only stat: from here on the writer tracks the size itself
+        self._size = os.fstat(self._log_fd).st_size
+        if self.use_index:
+            self._index_fd = os.open(self.index_file, os.O_RDWR | os.O_CREAT | os.O_APPEND, 0o640)
+            if not self._index_consistent(self._index_fd, self._size):
+                self._rebuild_index()
+            self._index_ready = True
+
+    def _close(self) -> None:
+        self._index_ready = False
+        for fd in (self._log_fd, self._index_fd):
+            if fd is not None:
+                try:
+                    os.close(fd)
+                except OSError:
+                    pass
+        self._log_fd = self._index_fd = None
+
+    @staticmethod
+    def _index_consistent(fd: int, log_size: int) -> bool:
+        """True if the index ends exactly where the log does"""
+        size = os.fstat(fd).st_size
+        if size % INDEX_RECORD.size:
+            return False
+        if size == 0:
+            return log_size == 0
+        offset, length = INDEX_RECORD.unpack(os.pread(fd, INDEX_RECORD.size, size - INDEX_RECORD.size))[:2]
+        return offset + length == log_size
+
+    def _rebuild_index(self) -> None:
+        """Re-derive the sidecar index from the log (after a crash or on first use)"""
+        os.ftruncate(self._index_fd, 0)
+        records = []
+        offset = 0
+        with open(self.log_file, 'rb') as f:
+            for line in f:
+                try:
+                    data = json.loads(line)
+                except ValueError:
+                    data = {}
+                records.append(_index_record(offset, line, data))
+                offset += len(line)
+                if len(records) >= 4096:
+                    os.write(self._index_fd, b''.join(records))
+                    records.clear()
+        if records:
+            os.write(self._index_fd, b''.join(records))
+
+    def _write_batch(self, entries: List[AuditEntry]) -> None:
+        """Group-commit a batch: one write for the lines, one for their index records"""
+        lines: List[bytes] = []
+        records: List[bytes] = []
+        offset = self._size
+        written = 0
+        try:
+            for entry in entries:
+                # Rotate before the entry that would go past the limit, as the per-write check did
+                if self.max_file_size and offset > self.max_file_size:
+                    self._append(lines, records, offset)
+                    written += len(lines)
+                    lines, records = [], []
+                    self._rotate_log()
+                    offset = 0
+                data = entry.to_dict()
+                line = (json.dumps(data, default=str) + '\n').encode()
+                if self._index_fd is not None:
+                    records.append(_index_record(offset, line, data))
+                lines.append(line)
+                offset += len(line)
+            self._append(lines, records, offset)
+        except Exception as e:
+            self.stats['written'] += written
+            raise _BatchError(written) from e
+        self.stats['written'] += len(entries)
+        self.stats['batches'] += 1
+
+    def _append(self, lines: List[bytes], records: List[bytes], new_size: int) -> None:
+        if not lines:
+            return
+        os.write(self._log_fd, b''.join(lines))
+        self._size = new_size
+        self._unsynced = True
+        # The index is written after the lines it points to, so readers never see dangling offsets
+        if records:
+            try:
+                os.write(self._index_fd, b''.join(records))
+            except OSError as e:
+                # The lines are already in the log, so carry on without the index; the next open rebuilds it
+                logging.error(f"Audit index error, index disabled until reopened: {e}")
+                self.stats['errors'] += 1
+                os.close(self._index_fd)
+                self._index_fd = None
+                self._index_ready = False
+
+    def _maybe_fsync(self, force: bool = False) -> None:
+        if not self._unsynced or self._log_fd is None or self.fsync == "never":
+            return
+        now = time.monotonic()
+        if force or self.fsync == "always" or now - self._last_fsync >= self.fsync_interval:
+            os.fsync(self._log_fd)
+            self._last_fsync = now
+            self._unsynced = False
+            self.stats['fsyncs'] += 1
+
+    def _rotate_log(self) -> None:
+        """Rotate audit log file (and start a fresh index)."""
+        self._maybe_fsync(force=True)
+        timestamp = datetime.now().strftime("%Y%m%d_%H%M%S_%f")
+        os.close(self._log_fd)
+        attempt = 0
+        while True:
+            suffix = f'.{timestamp}.bak' if not attempt else f'.{timestamp}_{attempt}.bak'
+            try:
+                # A hard link fails instead of replacing an existing backup, unlike rename
+                os.link(self.log_file, self.log_file.with_suffix(suffix))
+                break
+            except FileExistsError:
+                attempt += 1
+        os.unlink(self.log_file)
+        self._log_fd = os.open(self.log_file, os.O_WRONLY | os.O_CREAT | os.O_APPEND, 0o640)
+        self._size = 0
+        if self._index_fd is not None:
+            os.ftruncate(self._index_fd, 0)
+        self.stats['rotations'] += 1
 
     def set_correlation_id(self, correlation_id: str):
         """Set correlation ID for audit entries."""
         self.correlation_id = correlation_id
 
+    # Queries
+
+    def _usable_index(self) -> bool:
+        """The index can answer queries when this writer maintains it or it matches the log on disk"""
+        if not self.use_index or not self.index_file.exists():
+            return False
+        if self._index_ready:
+            return True
+        try:
+            fd = os.open(self.index_file, os.O_RDONLY)
+            try:
+                return self._index_consistent(fd, self.log_file.stat().st_size)
+            finally:
+                os.close(fd)
+        except OSError:
+            return False
+
+    def _index_reverse(self, chunk: int = 4096) -> Iterator[Tuple]:
+        """Index records from newest to oldest"""
+        with open(self.index_file, 'rb') as f:
+            count = os.fstat(f.fileno()).st_size // INDEX_RECORD.size
+            while count > 0:
+                start = max(0, count - chunk)
+                f.seek(start * INDEX_RECORD.size)
+                data = f.read((count - start) * INDEX_RECORD.size)
+                yield from reversed(list(INDEX_RECORD.iter_unpack(data)))
+                count = start
+
+    @staticmethod
+    def _parse(lines: List[bytes]) -> List[AuditEntry]:
+        entries = []
+        for line in lines:
+            try:
+                entries.append(AuditEntry.from_dict(json.loads(line)))
+            except (json.JSONDecodeError, KeyError, ValueError):
+                continue
+        return entries
+
     def get_recent_entries(self, limit: int = 100) -> List[AuditEntry]:
         """Get recent audit entries."""
-        entries = []
         try:
-            if self.log_file.exists():
-                with open(self.log_file, 'r') as f:
-                    for line in f.readlines()[-limit:]:
-                        try:
-                            data = json.loads(line.strip())
-                            entry = AuditEntry(
-                                timestamp=datetime.fromisoformat(data['timestamp']),
-                                event_type=AuditEvent(data['event_type']),
-                                user_id=data['user_id'],
-                                session_id=data['session_id'],
-                                resource=data['resource'],
-                                action=data['action'],
-                                details=data['details'],
-                                ip_address=data['ip_address'],
-                                user_agent=data['user_agent'],
-                                success=data['success'],
-                                correlation_id=data.get('correlation_id')
-                            )
-                            entries.append(entry)
-                        except (json.JSONDecodeError, KeyError, ValueError):
-                            continue
+            if not self.log_file.exists() or limit <= 0:
+                return []
+            if self._usable_index():
+                records = []
+                for record in self._index_reverse(chunk=limit):
+                    records.append(record)
+                    if len(records) == limit:
+                        break
+                if not records:
+                    return []
+                # The newest ``limit`` lines are contiguous: one read covers them
+                first, last = records[-1], records[0]
+                with open(self.log_file, 'rb') as f:
+                    f.seek(first[0])
+                    data = f.read(last[0] + last[1] - first[0])
+                return self._parse(data.splitlines())
+
+            lines = []
+            for line in _reverse_lines(self.log_file):
+                lines.append(line)
+                if len(lines) == limit:
+                    break
+            return self._parse(lines[::-1])
         except Exception as e:
             logging.error(f"Error reading audit log: {e}")
+            return []
 
-        return entries
+    def search_entries(self, limit: Optional[int] = None, since: Optional[datetime] = None,
+                       **filters) -> List[AuditEntry]:
+        """
+        Search audit entries with filters.
 
-    def search_entries(self, **filters) -> List[AuditEntry]:
-        """Search audit entries with filters."""
-        entries = []
+        Filters compare against the stored JSON fields (``event_type`` may be given as an
+        AuditEvent). ``event_type``, ``user_id`` and ``success`` are checked against the
+        sidecar index first, so only candidate lines are read. Matching runs newest
+        first, so ``limit`` and ``since`` stop the search early; results are returned
+        in log order.
+        """
+        filters = {key: value.value if isinstance(value, AuditEvent) else value
+                   for key, value in filters.items()}
+        entries: List[AuditEntry] = []
         try:
-            if self.log_file.exists():
-                with open(self.log_file, 'r') as f:
-                    for line in f:
-                        try:
-                            data = json.loads(line.strip())
-
-                            # Apply filters
-                            match = True
-                            for key, value in filters.items():
-                                if key not in data or data[key] != value:
-                                    match = False
-                                    break
-
-                            if match:
-                                entry = AuditEntry(
-                                    timestamp=datetime.fromisoformat(data['timestamp']),
-                                    event_type=AuditEvent(data['event_type']),
-                                    user_id=data['user_id'],
-                                    session_id=data['session_id'],
-                                    resource=data['resource'],
-                                    action=data['action'],
-                                    details=data['details'],
-                                    ip_address=data['ip_address'],
-                                    user_agent=data['user_agent'],
-                                    success=data['success'],
-                                    correlation_id=data.get('correlation_id')
-                                )
-                                entries.append(entry)
-                        except (json.JSONDecodeError, KeyError, ValueError):
+            if not self.log_file.exists():
+                return entries
+            cutoff = since.timestamp() if since else None
+
+            def matches(data: Dict[str, Any]) -> bool:
+                for key, value in filters.items():
+                    if key not in data or data[key] != value:
+                        return False
+                return True
+
+            def accept(line: bytes) -> bool:
+                try:
+                    data = json.loads(line)
+                    if matches(data):
+                        entry = AuditEntry.from_dict(data)
+                        if since is None or entry.timestamp >= since:
+                            entries.append(entry)
+                except (json.JSONDecodeError, KeyError, ValueError):
+                    pass
+                return limit is not None and len(entries) >= limit
+
+            if self._usable_index():
+                event_code = _EVENT_CODES.get(filters['event_type'], -1) if 'event_type' in filters else None
+                user_hash = _user_hash(filters['user_id']) if 'user_id' in filters else None
+                success = filters.get('success')
+                with open(self.log_file, 'rb') as f:
+                    for offset, length, timestamp, code, ok, user in self._index_reverse():
+                        if cutoff is not None and timestamp < cutoff:
+                            break
+                        if event_code is not None and code != event_code:
+                            continue
+                        if user_hash is not None and user != user_hash:
+                            continue
+                        if isinstance(success, bool) and bool(ok) != success:
                             continue
+                        f.seek(offset)
+                        if accept(f.read(length)):
+                            break
+            else:
+                for line in _reverse_lines(self.log_file):
+                    if accept(line):
+                        break
         except Exception as e:
             logging.error(f"Error searching audit log: {e}")
 
+        entries.reverse()
         return entries
+
+
+__all__ = ['AuditEvent', 'AuditEntry', 'AuditRing', 'AuditLogger', 'INDEX_RECORD', 'FSYNC_POLICIES']
@@ -23,6 +23,9 @@ from collections import defaultdict
 from pyserv.http import Request, Response
 from pyserv.exceptions import HTTPException
 from pyserv.middleware import HTTPMiddleware
+from pyserv.utils.rate_limiting import (
+    RateLimitAlgorithm, RateLimitEngine, RateLimitPolicy, get_rate_limit_engine,
+)
 
 logger = logging.getLogger(__name__)
 
@@ -118,37 +121,26 @@ class SecurityEvent:
 
 
 class RateLimiter:
-    """Rate limiter for security middleware"""
+    """Rate limiter for security middleware, backed by the shared rate-limit engine"""
 
-    def __init__(self, requests: int = 100, window: int = 60):
+    def __init__(self, requests: int = 100, window: int = 60, engine: Optional[RateLimitEngine] = None):
         self.requests = requests
         self.window = window
-        self.requests_by_key: Dict[str, List[float]] = defaultdict(list)
+        self.policy = RateLimitPolicy(requests, window, RateLimitAlgorithm.SLIDING_WINDOW)
+        self.engine = engine or get_rate_limit_engine()
 
     def is_allowed(self, key: str) -> bool:
         """Check if request is allowed for the given key"""
-        now = time.time()
-        # Remove old requests outside the window
-        self.requests_by_key[key] = [
-            req_time for req_time in self.requests_by_key[key]
-            if now - req_time < self.window
-        ]
-
-        # Check if under limit
-        if len(self.requests_by_key[key]) < self.requests:
-            self.requests_by_key[key].append(now)
-            return True
-
-        return False
+        return self.engine.check(self.policy, key).allowed
 
     def get_remaining_requests(self, key: str) -> int:
         """Get remaining requests for the key"""
-        now = time.time()
-        self.requests_by_key[key] = [
-            req_time for req_time in self.requests_by_key[key]
-            if now - req_time < self.window
-        ]
-        return max(0, self.requests - len(self.requests_by_key[key]))
+        # A zero-cost check reads the allowance without consuming any
+        return self.engine.check(self.policy, key, cost=0).remaining
+
+    def get_live_keys(self) -> int:
+        """Keys with unexpired state, across every policy sharing the engine"""
+        return self.engine.table.get_stats()['live']
 
 
 class SecurityMonitor:
@@ -496,7 +488,7 @@ class SecurityMiddleware(HTTPMiddleware):
     async def get_security_stats(self) -> Dict[str, Any]:
         """Get security statistics"""
         return {
-            "rate_limited_requests": len(self.rate_limiter.requests_by_key),
+            "rate_limited_requests": self.rate_limiter.get_live_keys(),
             "blocked_ips": len(self.security_monitor.blocked_ips),
             "suspicious_activities": len(self.security_monitor.suspicious_activity),
             "csrf_tokens_active": len(self.csrf_tokens)
@@ -11,6 +11,8 @@ import json
 import aiohttp
 from enum import Enum
 
+from .audit import AuditEntry, AuditEvent
+
 
 class SIEMProvider(Enum):
     """Supported SIEM providers"""
@@ -128,6 +130,24 @@ class SIEMIntegration:
         self.flush_interval = config.get('flush_interval', 30)
         self.session = None
         self.flush_task = None
+        self.audit_ring = None
+        self._audit_cursor = 0
+        self.audit_batch_size = config.get('audit_batch_size', 1000)
+        self.lost_audit_events = 0
+
+    def attach_audit_log(self, audit_log):
+        """
+        Forward audit entries to the SIEM from the audit logger's ring.
+
+        Entries are read at flush time with this integration's own cursor, so the
+        audit file writer is never slowed down by SIEM delivery. Entries logged
+        before attaching are not forwarded.
+
+        Args:
+            audit_log: An AuditLogger or its AuditRing
+        """
+        self.audit_ring = getattr(audit_log, 'buffer', audit_log)
+        self._audit_cursor = self.audit_ring.head
 
     async def initialize(self):
         """Initialize SIEM connection"""
@@ -157,13 +177,12 @@ class SIEMIntegration:
             except asyncio.CancelledError:
                 pass
 
+        # Final flush, while the session is still open
+        await self._flush_events()
+
         if self.session:
             await self.session.close()
 
-        # Final flush
-        if self.event_buffer:
-            await self._flush_events()
-
     async def log_event(self, event: SecurityEvent):
         """Log security event"""
         self.event_buffer.append(event)
@@ -228,12 +247,31 @@ class SIEMIntegration:
             except Exception as e:
                 print(f"Error sending alert to {endpoint}: {e}")
 
+    async def _drain_audit_log(self):
+        """Turn audit entries published since the last flush into buffered security events"""
+        if self.audit_ring is None:
+            return
+        while True:
+            entries, self._audit_cursor, lost = self.audit_ring.read(self._audit_cursor, self.audit_batch_size)
+            if lost:
+                self.lost_audit_events += lost
+                print(f"SIEM fell behind the audit log, {lost} audit entries were not forwarded")
+            if not entries:
+                return
+            for entry in entries:
+                event = audit_to_security_event(entry)
+                self.event_buffer.append(event)
+                await self._check_alert_rules(event)
+
     async def _flush_events(self):
         """Flush events to SIEM"""
+        await self._drain_audit_log()
         if not self.event_buffer:
             return
 
-        events_data = [event.to_dict() for event in self.event_buffer]
+        # Swap the buffer out so events logged while sending go to the next flush
+        pending, self.event_buffer = self.event_buffer, []
+        events_data = [event.to_dict() for event in pending]
 
         try:
             if self.provider == SIEMProvider.SPLUNK:
@@ -247,10 +285,9 @@ class SIEMIntegration:
             else:
                 await self._send_to_custom(events_data)
 
-            self.event_buffer.clear()
-
         except Exception as e:
             print(f"Failed to flush events to SIEM: {e}")
+            self.event_buffer[:0] = pending
 
     async def _send_to_splunk(self, events: List[Dict[str, Any]]):
         """Send events to Splunk"""
@@ -364,6 +401,33 @@ class SIEMIntegration:
 # Global SIEM instance
 _siem_instance = None
 
+_AUDIT_SEVERITY = {
+    AuditEvent.FAILED_LOGIN: AlertSeverity.MEDIUM,
+    AuditEvent.PERMISSION_CHANGE: AlertSeverity.MEDIUM,
+    AuditEvent.ADMIN_ACTION: AlertSeverity.MEDIUM,
+    AuditEvent.SECURITY_EVENT: AlertSeverity.HIGH,
+}
+
+
+def audit_to_security_event(entry: AuditEntry) -> SecurityEvent:
+    """Map an audit log entry onto a SIEM security event"""
+    return SecurityEvent(
+        event_id=f"audit_{entry.timestamp.timestamp():.6f}_{id(entry):x}",
+        timestamp=entry.timestamp,
+        source="audit",
+        event_type=entry.event_type.value,
+        severity=_AUDIT_SEVERITY.get(entry.event_type, AlertSeverity.LOW),
+        description=f"{entry.action} {entry.resource}",
+        details={**entry.details, 'success': entry.success, 'session_id': entry.session_id,
+                 'user_agent': entry.user_agent, 'correlation_id': entry.correlation_id},
+        user_id=entry.user_id,
+        ip_address=entry.ip_address,
+        resource=entry.resource,
+        action=entry.action,
+        tags=['audit'] if entry.success else ['audit', 'failure']
+    )
+
+
 def get_siem_integration(provider: SIEMProvider = SIEMProvider.CUSTOM,
                         config: Optional[Dict[str, Any]] = None) -> SIEMIntegration:
     """Get global SIEM integration instance"""
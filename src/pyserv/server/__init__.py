@@ -5,12 +5,15 @@ This module contains the core server components including the Application class,
 server implementation, and configuration management.
 """
 
-from .application import Application
-from .server import Server
-from .config import AppConfig
-
-__all__ = ['Application', 'Server', 'AppConfig']
-
-
+# Loaded on first access, so importing a single server module (e.g. pyserv.server.prefork)
+# does not construct the whole application stack
+from pyserv.utils.lazy import attach
 
+__getattr__, __dir__ = attach(__name__, {
+    ".application": ["Application"],
+    ".server": ["Server"],
+    ".config": ["AppConfig"],
+    ".prefork": ["PreforkConfig", "PreforkSupervisor"],
+})
 
+__all__ = ['Application', 'Server', 'AppConfig', 'PreforkConfig', 'PreforkSupervisor']
@@ -29,54 +29,33 @@ Key Features:
 """
 
 import inspect
-from typing import Dict, List, Callable, Any, Optional, Type, Awaitable
-from functools import wraps
+from typing import Dict, List, Callable, Any, Optional, Type, Awaitable, TYPE_CHECKING
+from functools import wraps, cached_property
 
-# Core imports
+# Core imports (needed to route and serve a request)
 from pyserv.server.config import AppConfig
 from pyserv.routing import Router
 from pyserv.middleware import Middleware, HTTPMiddleware, WebSocketMiddleware, MiddlewareCallable, MiddlewareType
 from pyserv.exceptions import HTTPException, WebSocketException, WebSocketDisconnect
-from pyserv.templating import TemplateEngine
 from pyserv.http import Request, Response
 from pyserv.websocket import WebSocket
 
-from pyserv.middleware.manager import MiddlewareManager
-
-# Core framework imports
-from pyserv.utils.di import Container
-from pyserv.storage import get_storage_manager
-from pyserv.caching import get_cache_manager
-from pyserv.auth import get_security_manager
-
-# Database imports
-from pyserv.database import DatabaseConfig
-from pyserv.database.connections import DatabaseConnection
-
-# Security middleware
-from pyserv.security.middleware import SecurityMiddleware, CSRFMiddleware
-
-# Server import
-from pyserv.server import Server
-
-# Event system
+# Event and plugin systems
 from pyserv.events import EventBus, Event, EventHandler, get_event_bus
-
-# Plugin system
 from pyserv.plugins import PluginManager, Plugin, get_plugin_manager
 
-# Performance monitoring
-from pyserv.monitoring import MetricsCollector, HealthChecker
-
-# GraphQL support
-from pyserv.graphql import GraphQLManager
-
-# gRPC support
-from pyserv.microservices.grpc_service import GRPCManager, get_grpc_manager, get_grpc_client_manager
-
 # Middleware manager
 from pyserv.middleware.manager import MiddlewareManager, get_middleware_manager
 
+# Everything else (templating, database, storage, caching, DI, security middleware,
+# GraphQL, gRPC, monitoring and the server itself) is imported where it is first used,
+# so applications that never touch a subsystem never pay for importing it.
+if TYPE_CHECKING:
+    from pyserv.templating import TemplateEngine
+    from pyserv.database.connections import DatabaseConnection
+    from pyserv.server.server import Server
+    from pyserv.utils.di import Container
+
 
 class Application:
     """
@@ -107,36 +86,22 @@ class Application:
         self.router = Router()
         self.middleware_manager = MiddlewareManager()
         self.state: Dict[str, Any] = {}
-        self.template_engine: Optional[TemplateEngine] = None
-        self.db_connection: Optional[DatabaseConnection] = None
+        self.template_engine: Optional['TemplateEngine'] = None
+        self.db_connection: Optional['DatabaseConnection'] = None
         self._startup_events: List[Callable] = []
         self._shutdown_events: List[Callable] = []
         self._exception_handlers: Dict[Type[Exception], Callable] = {}
-        self._server: Optional[Server] = None
+        self._server: Optional['Server'] = None
         self._is_running = False
 
         # Initialize core systems
         self.event_bus = get_event_bus()
         self.plugin_manager = get_plugin_manager()
-        self.grpc_manager = get_grpc_manager()
-        self.grpc_client_manager = get_grpc_client_manager()
         self.middleware_manager = get_middleware_manager()
 
-        # Lightweight dependency injection container
-        self.container = self._setup_di_container()
-
         # Default middleware (with lazy loading)
         self._setup_default_middleware()
 
-        # Initialize GraphQL
-        from pyserv.graphql import GraphQLManager
-        self.graphql_manager = GraphQLManager()
-
-        # Initialize monitoring
-        from pyserv.monitoring import MetricsCollector, HealthChecker
-        self.metrics_collector = MetricsCollector()
-        self.health_checker = HealthChecker()
-
         # Initialize SSE manager
         from pyserv.server.sse import get_sse_manager
         self.sse_manager = get_sse_manager()
@@ -145,8 +110,44 @@ class Application:
         from pyserv.server.session import get_session_manager
         self.session_manager = get_session_manager()
 
-    def _setup_di_container(self) -> Container:
+    @cached_property
+    def container(self) -> 'Container':
+        """Lightweight dependency injection container, created on first use"""
+        return self._setup_di_container()
+
+    @cached_property
+    def grpc_manager(self):
+        """gRPC service manager, created on first use"""
+        from pyserv.microservices.grpc_service import get_grpc_manager
+        return get_grpc_manager()
+
+    @cached_property
+    def grpc_client_manager(self):
+        """gRPC client manager, created on first use"""
+        from pyserv.microservices.grpc_service import get_grpc_client_manager
+        return get_grpc_client_manager()
+
+    @cached_property
+    def graphql_manager(self):
+        """GraphQL manager, created on first use"""
+        from pyserv.graphql import GraphQLManager
+        return GraphQLManager()
+
+    @cached_property
+    def metrics_collector(self):
+        """Monitoring metrics collector, created on first use"""
+        from pyserv.monitoring import MetricsCollector
+        return MetricsCollector()
+
+    @cached_property
+    def health_checker(self):
+        """Health checker, created on first use"""
+        from pyserv.monitoring import HealthChecker
+        return HealthChecker()
+
+    def _setup_di_container(self) -> 'Container':
         """Setup lightweight dependency injection container."""
+        from pyserv.utils.di import Container
         container = Container()
         # Register basic services
         container.register_singleton("app", self)
@@ -156,6 +157,7 @@ class Application:
     def _setup_default_middleware(self) -> None:
         """Setup default middleware with lazy loading."""
         try:
+            from pyserv.security.middleware import SecurityMiddleware, CSRFMiddleware
             if SecurityMiddleware:
                 self.add_middleware(SecurityMiddleware)
             if CSRFMiddleware:
@@ -167,13 +169,13 @@ class Application:
     def create_server(self):
         """Create a server instance for this application"""
         if self._server is None:
+            from pyserv.server.server import Server
             self._server = Server(self, self.config)
         return self._server
 
     async def serve(self, **kwargs) -> None:
         """Start serving requests (non-blocking)"""
-        if self._server is None:
-            self._server = Server(self, self.config)
+        self.create_server()
 
         for key, value in kwargs.items():
             if hasattr(self.config, key):
@@ -253,15 +255,25 @@ class Application:
     def mount(self, path: str, app: 'Application') -> None:
         self.router.mount(path, app.router)
     
+    def setup_template_engine(self) -> 'TemplateEngine':
+        """Create the template engine on first use; a pre-fork master calls this to warm it"""
+        if self.template_engine is None:
+            from pathlib import Path
+            from pyserv.templating import TemplateConfig, TemplateEngine
+            self.template_engine = TemplateEngine(TemplateConfig(template_dir=Path(self.config.template_dir)))
+        return self.template_engine
+    
     async def startup(self) -> None:
         # Initialize database
         if self.config.database_url:
+            from pyserv.database import DatabaseConfig
+            from pyserv.database.connections import DatabaseConnection
             db_config = DatabaseConfig(self.config.database_url)
             self.db_connection = DatabaseConnection.get_instance(db_config)
             await self.db_connection.connect()
         
-        # Initialize template engine
-        self.template_engine = TemplateEngine(self.config.template_dir)
+        # Initialize template engine (unless one was set up and warmed before a pre-fork)
+        self.setup_template_engine()
         
         # Run startup events
         for event in self._startup_events:
@@ -312,24 +324,19 @@ class Application:
         try:
             request = Request(scope, receive, send, self)
 
-            # Process request through middleware
-            request = await self.middleware_manager.process_http_request(request)
-
             # Execute middleware chain
             async def final_handler(req: Request) -> Response:
-                route, path_params = self.router.match(req.method, req.path)
-                if not route:
+                match = self.router.match(req.method, req.path)
+                if not match:
                     from pyserv.exceptions import HTTPException
                     raise HTTPException(404, "Not Found")
 
-                req.path_params = path_params
-                return await route.handler(req)
+                req.path_params = match.params
+                if match.route.config.max_body_size is not None:
+                    req.max_body_size = match.route.config.max_body_size
+                return await match.handler(req)
 
             response = await self.middleware_manager.execute_http_chain(request, final_handler)
-
-            # Process response through middleware
-            response = await self.middleware_manager.process_http_response(request, response)
-
             await response(scope, receive, send)
 
         except Exception as exc:
@@ -346,14 +353,17 @@ class Application:
                 await send({"type": "websocket.close", "code": 1008})
                 return
 
-            # Route and handle WebSocket
-            route, path_params = self.router.match_websocket(websocket.path)
-            if not route:
-                await websocket.close(1008, "No route found")
-                return
+            try:
+                # Route and handle WebSocket
+                match = self.router.match_websocket(websocket.path)
+                if not match:
+                    await websocket.close(1008, "No route found")
+                    return
 
-            websocket.path_params = path_params or {}
-            await route.handler(websocket)
+                websocket.path_params = match.params or {}
+                await match.handler(websocket)
+            finally:
+                await self.middleware_manager.process_websocket_disconnect(websocket)
 
         except Exception as exc:
             await self.handle_websocket_exception(exc, scope, receive, send)
@@ -418,16 +428,19 @@ class Application:
     @property
     def storage(self):
         """Get storage manager"""
+        from pyserv.storage import get_storage_manager
         return get_storage_manager(self.config)
 
     @property
     def cache(self):
         """Get cache manager"""
+        from pyserv.caching import get_cache_manager
         return get_cache_manager(self.config)
 
     @property
     def security(self):
         """Get security manager"""
+        from pyserv.auth import get_security_manager
         return get_security_manager(self.config)
 
     def inject(self, service_type: Type, instance: Any) -> None:
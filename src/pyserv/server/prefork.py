@@ -0,0 +1,535 @@
+"""
+Pre-fork server supervisor for Pyserv framework.
+
+The master process warms everything that is immutable after startup —
+imports, compiled routes, compiled templates — then ``gc.freeze()``-s the
+heap and forks workers, so those pages stay shared copy-on-write instead of
+being rebuilt (and duplicated) per worker. Each worker binds its own
+``SO_REUSEPORT`` listener, letting the kernel balance connections, or
+inherits one listener from the master where the option is unavailable.
+Event loops, database pools and other per-process state are created by the
+ASGI lifespan startup inside each worker, after the fork.
+
+Workers can be pinned to CPUs and are recycled on a request count or RSS
+threshold: the worker asks to be replaced, the master forks its successor,
+and the old worker is only told to drain once the new one is serving.
+"""
+
+import asyncio
+import gc
+import importlib
+import logging
+import os
+import random
+import selectors
+import signal
+import socket
+import sys
+import time
+from collections import deque
+from dataclasses import dataclass, field
+from typing import Any, Awaitable, Callable, Deque, Dict, List, Optional
+
+# One-byte messages a worker writes to the master over its pipe
+READY = b'R'
+RECYCLE = b'C'
+
+# Seconds to wait before re-forking a worker that died young, so a broken app doesn't fork-loop
+RESPAWN_BACKOFF = 1.0
+
+
+def _env_list(name: str) -> List[str]:
+    return [item.strip() for item in os.getenv(name, '').split(',') if item.strip()]
+
+
+@dataclass
+class PreforkConfig:
+    """Pre-fork supervisor configuration"""
+    workers: int = int(os.getenv('WORKERS', '1'))
+    host: str = os.getenv('HOST', '127.0.0.1')
+    port: int = int(os.getenv('PORT', '8000'))
+    backlog: int = int(os.getenv('BACKLOG', '2048'))
+    # One listener per worker balanced by the kernel; falls back to a shared listener without SO_REUSEPORT
+    reuse_port: bool = os.getenv('REUSE_PORT', 'True').lower() == 'true'
+    cpu_affinity: bool = os.getenv('CPU_AFFINITY', 'False').lower() == 'true'
+    # Recycle a worker after this many requests (0 = never), plus up to max_requests_jitter more
+    max_requests: int = int(os.getenv('MAX_REQUESTS', '0'))
+    max_requests_jitter: int = int(os.getenv('MAX_REQUESTS_JITTER', '0'))
+    # Recycle a worker whose resident memory exceeds this (0 = never)
+    max_memory_mb: int = int(os.getenv('WORKER_MAX_MEMORY_MB', '0'))
+    memory_check_interval: float = float(os.getenv('WORKER_MEMORY_CHECK_INTERVAL', '5'))
+    graceful_timeout: float = float(os.getenv('GRACEFUL_TIMEOUT', '30'))
+    # A worker that never reports ready (no lifespan support) is assumed ready after this
+    ready_timeout: float = float(os.getenv('WORKER_READY_TIMEOUT', '30'))
+    preload_modules: List[str] = field(default_factory=lambda: _env_list('PRELOAD_MODULES'))
+    freeze_gc: bool = os.getenv('PREFORK_FREEZE_GC', 'True').lower() == 'true'
+
+    @classmethod
+    def from_config(cls, config: Any) -> 'PreforkConfig':
+        """Take any same-named settings from an application or server config"""
+        prefork = cls()
+        for name in cls.__dataclass_fields__:
+            value = getattr(config, name, None)
+            if value is not None:
+                setattr(prefork, name, value)
+        return prefork
+
+
+@dataclass
+class WorkerProcess:
+    """A forked worker as seen from the master"""
+    slot: int
+    pid: int
+    pipe: int
+    started_at: float = field(default_factory=time.monotonic)
+    ready: bool = False
+    retiring: bool = False
+
+
+def create_listen_socket(host: str, port: int, backlog: int, reuse_port: bool) -> socket.socket:
+    """A non-blocking, inheritable TCP listener"""
+    family = socket.AF_INET6 if ':' in host else socket.AF_INET
+    sock = socket.socket(family, socket.SOCK_STREAM)
+    try:
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        if reuse_port:
+            sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEPORT, 1)
+        sock.bind((host, port))
+        sock.listen(backlog)
+    except BaseException:
+        sock.close()
+        raise
+    sock.setblocking(False)
+    sock.set_inheritable(True)
+    return sock
+
+
+def resident_memory() -> int:
+    """Current resident set size in bytes (peak RSS where /proc is unavailable)"""
+    try:
+        with open('/proc/self/statm') as f:
+            return int(f.read().split()[1]) * os.sysconf('SC_PAGE_SIZE')
+    except (OSError, ValueError, IndexError):
+        import resource
+        peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        return peak if sys.platform == 'darwin' else peak * 1024
+
+
+def warm_up(app: Any, preload_modules: Optional[List[str]] = None,
+            hooks: Optional[List[Callable[[Any], Any]]] = None, freeze: bool = True) -> Dict[str, int]:
+    """
+    Do the shareable part of startup once, before forking.
+
+    Imports ``preload_modules``, compiles the app's routes and preloads its
+    template engine (anything with ``preload()``, created through the app's
+    ``setup_template_engine()`` when it has one), runs ``hooks(app)``,
+    then collects garbage and freezes the survivors so later collections in
+    the workers never touch (and un-share) their pages.
+    """
+    stats = {'modules': 0, 'routes': 0, 'templates': 0}
+    logger = logging.getLogger("app.server.prefork")
+
+    for module in preload_modules or ():
+        importlib.import_module(module)
+        stats['modules'] += 1
+
+    router = getattr(app, 'router', None)
+    if router is not None and hasattr(router, 'compile'):
+        stats['routes'] = router.compile()
+
+    setup = getattr(app, 'setup_template_engine', None)
+    engine = setup() if callable(setup) else getattr(app, 'template_engine', None)
+    if engine is not None and hasattr(engine, 'preload'):
+        stats['templates'] = engine.preload()
+
+    for hook in hooks or ():
+        hook(app)
+
+    if freeze:
+        gc.collect()
+        gc.freeze()
+        stats['frozen'] = gc.get_freeze_count()
+    logger.info(f"Warmed up before fork: {stats}")
+    return stats
+
+
+async def hypercorn_serve(app: Any, config: Any, sockets: List[socket.socket],
+                          shutdown_trigger: Callable[[], Awaitable[Any]]) -> None:
+    """Serve ``app`` with Hypercorn on already-bound listeners"""
+    from hypercorn.asyncio.run import worker_serve
+    from hypercorn.config import Sockets
+
+    try:
+        from hypercorn.utils import wrap_app
+    except ImportError:  # Hypercorn < 0.15 takes the bare ASGI app
+        wrap_app = None
+    if wrap_app is not None:
+        app = wrap_app(app, config.wsgi_max_body_size, None)
+
+    if config.ssl_enabled:
+        bound = Sockets(secure_sockets=sockets, insecure_sockets=[], quic_sockets=[])
+    else:
+        bound = Sockets(secure_sockets=[], insecure_sockets=sockets, quic_sockets=[])
+    await worker_serve(app, config, sockets=bound, shutdown_trigger=shutdown_trigger)
+
+
+class PreforkSupervisor:
+    """
+    Master process of a pre-fork server.
+
+    ``run`` warms up, forks ``config.workers`` workers and supervises them:
+    workers that die are replaced (with a back-off when they die young),
+    recycle requests are served one at a time as rolling restarts, SIGHUP
+    rolls every worker, and SIGTERM/SIGINT drain all workers within
+    ``graceful_timeout`` before killing stragglers.
+
+    ``serve(app, sockets, shutdown_trigger)`` runs inside each worker;
+    the default serves with Hypercorn using ``server_config``.
+    """
+
+    def __init__(self, app: Any, config: PreforkConfig, server_config: Any = None,
+                 serve: Optional[Callable[..., Awaitable[Any]]] = None,
+                 warmup_hooks: Optional[List[Callable[[Any], Any]]] = None):
+        self.app = app
+        self.config = config
+        self.server_config = server_config
+        self.serve = serve or (lambda app, sockets, trigger: hypercorn_serve(app, server_config, sockets, trigger))
+        self.warmup_hooks = warmup_hooks or []
+        self.logger = logging.getLogger("app.server.prefork")
+
+        self.workers: Dict[int, WorkerProcess] = {}  # by pid
+        self.slots: Dict[int, WorkerProcess] = {}  # serving worker per slot
+        self.restarts = 0
+        self._recycle: Deque[int] = deque()
+        self._replacing: Optional[WorkerProcess] = None
+        self._rolling_at = 0.0  # no rolling replacement is forked before this (monotonic)
+        self._respawn_at: Dict[int, float] = {}
+        self._spawned: Dict[int, int] = {}  # forks per slot
+        self._listener: Optional[socket.socket] = None
+        self._selector: Optional[selectors.BaseSelector] = None
+        self._wake_r = self._wake_w = -1
+        self._stopping = False
+        self._reload = False
+        self._cpus: List[int] = []
+
+    # Master
+
+    def run(self, install_signals: bool = True) -> int:
+        """Warm up, fork the workers and supervise them until stopped; returns an exit code"""
+        if self.config.reuse_port and not hasattr(socket, 'SO_REUSEPORT'):
+            self.logger.warning("SO_REUSEPORT unavailable; workers will share one listener")
+            self.config.reuse_port = False
+
+        warm_up(self.app, self.config.preload_modules, self.warmup_hooks, self.config.freeze_gc)
+        if not self.config.reuse_port:
+            self._listener = create_listen_socket(self.config.host, self.config.port, self.config.backlog, False)
+        if self.config.cpu_affinity and hasattr(os, 'sched_getaffinity'):
+            self._cpus = sorted(os.sched_getaffinity(0))
+
+        self._selector = selectors.DefaultSelector()
+        self._wake_r, self._wake_w = os.pipe()
+        os.set_blocking(self._wake_r, False)
+        os.set_blocking(self._wake_w, False)
+        self._selector.register(self._wake_r, selectors.EVENT_READ)
+        previous = self._install_signals() if install_signals else {}
+
+        self.logger.info(f"Pre-fork master {os.getpid()} starting {self.config.workers} workers on "
+                         f"{self.config.host}:{self.config.port} (reuse_port={self.config.reuse_port})")
+        try:
+            for slot in range(self.config.workers):
+                self.slots[slot] = self._spawn(slot)
+            self._supervise()
+        finally:
+            self._drain()
+            for sig, handler in previous.items():
+                signal.signal(sig, handler)
+            self._selector.close()
+            os.close(self._wake_r)
+            os.close(self._wake_w)
+            if self._listener is not None:
+                self._listener.close()
+        return 0
+
+    def stop(self) -> None:
+        """Ask the master to drain and exit (safe from signal handlers and other threads)"""
+        self._stopping = True
+        self._wake()
+
+    def reload(self) -> None:
+        """Rolling restart of every worker"""
+        self._reload = True
+        self._wake()
+
+    def _wake(self) -> None:
+        try:
+            os.write(self._wake_w, b'\0')
+        except (BlockingIOError, OSError):
+            pass
+
+    def _install_signals(self) -> Dict[int, Any]:
+        previous = {}
+        for sig, handler in ((signal.SIGTERM, lambda *_: self.stop()), (signal.SIGINT, lambda *_: self.stop()),
+                             (signal.SIGHUP, lambda *_: self.reload())):
+            previous[sig] = signal.signal(sig, handler)
+        return previous
+
+    def _supervise(self) -> None:
+        while not self._stopping:
+            for key, _ in self._selector.select(timeout=1.0):
+                if key.fd == self._wake_r:
+                    self._drain_fd(self._wake_r)
+                else:
+                    self._read_worker(key.data)
+            self._reap()
+            if self._stopping:
+                break
+            if self._reload:
+                self._reload = False
+                self._recycle.extend(slot for slot in self.slots if slot not in self._recycle)
+            self._respawn_due()
+            self._advance_rolling()
+
+    def _spawn(self, slot: int) -> WorkerProcess:
+        """Fork a worker for ``slot``"""
+        # A recycled worker overlaps its successor, so alternate the low bit per fork
+        generation = self._spawned[slot] = self._spawned.get(slot, 0) + 1
+        read_fd, write_fd = os.pipe()
+        pid = os.fork()
+        if pid == 0:
+            os.close(read_fd)
+            self._child(slot, write_fd, slot << 1 | generation & 1)  # never returns
+
+        os.close(write_fd)
+        os.set_blocking(read_fd, False)
+        worker = WorkerProcess(slot, pid, read_fd)
+        self.workers[pid] = worker
+        self._selector.register(read_fd, selectors.EVENT_READ, worker)
+        self.logger.info(f"Worker {slot} started (pid {pid})")
+        return worker
+
+    def _read_worker(self, worker: WorkerProcess) -> None:
+        try:
+            data = os.read(worker.pipe, 64)
+        except BlockingIOError:
+            return
+        except OSError:
+            data = b''
+        if not data:
+            self._close_pipe(worker)
+            return
+        if READY in data:
+            worker.ready = True
+        if RECYCLE in data and not worker.retiring and self.slots.get(worker.slot) is worker \
+                and worker.slot not in self._recycle:
+            self.logger.info(f"Worker {worker.slot} (pid {worker.pid}) requested recycling")
+            self._recycle.append(worker.slot)
+
+    def _close_pipe(self, worker: WorkerProcess) -> None:
+        if worker.pipe >= 0:
+            self._selector.unregister(worker.pipe)
+            os.close(worker.pipe)
+            worker.pipe = -1
+
+    def _reap(self) -> None:
+        while True:
+            try:
+                pid, status = os.waitpid(-1, os.WNOHANG)
+            except ChildProcessError:
+                return
+            if pid == 0:
+                return
+            worker = self.workers.pop(pid, None)
+            if worker is None:
+                continue
+            self._close_pipe(worker)
+            code = os.waitstatus_to_exitcode(status)
+            if worker is self._replacing:
+                self._replacing = None
+                if not self._stopping:
+                    # The successor died before serving; the old worker keeps its slot and is retried later
+                    self.logger.error(f"Replacement for worker {worker.slot} exited with {code}")
+                    self._recycle.appendleft(worker.slot)
+                    self._rolling_at = time.monotonic() + RESPAWN_BACKOFF
+            elif self.slots.get(worker.slot) is worker:
+                del self.slots[worker.slot]
+                replacing = self._replacing is not None and self._replacing.slot == worker.slot
+                if not self._stopping and not replacing:
+                    young = time.monotonic() - worker.started_at < RESPAWN_BACKOFF
+                    self.logger.error(f"Worker {worker.slot} (pid {pid}) exited with {code}; restarting")
+                    self._respawn_at[worker.slot] = time.monotonic() + (RESPAWN_BACKOFF if young else 0.0)
+            else:
+                self.logger.info(f"Worker {worker.slot} (pid {pid}) retired")
+
+    def _respawn_due(self) -> None:
+        now = time.monotonic()
+        for slot, due in list(self._respawn_at.items()):
+            if due <= now:
+                del self._respawn_at[slot]
+                self.slots[slot] = self._spawn(slot)
+                self.restarts += 1
+
+    def _advance_rolling(self) -> None:
+        """Replace recycled workers one at a time, retiring each only once its successor serves"""
+        replacement = self._replacing
+        if replacement is not None:
+            alive = time.monotonic() - replacement.started_at
+            if not (replacement.ready or alive >= self.config.ready_timeout):
+                return
+            old = self.slots.get(replacement.slot)
+            self.slots[replacement.slot] = replacement
+            self._replacing = None
+            self.restarts += 1
+            if old is not None and old is not replacement:
+                old.retiring = True
+                self._signal(old, signal.SIGTERM)
+
+        if time.monotonic() < self._rolling_at:
+            return
+        while self._recycle and self._replacing is None:
+            slot = self._recycle.popleft()
+            if slot in self.slots:
+                self._replacing = self._spawn(slot)
+
+    def _drain(self) -> None:
+        """Stop every worker gracefully, then kill what is left after ``graceful_timeout``"""
+        for worker in list(self.workers.values()):
+            self._signal(worker, signal.SIGTERM)
+        deadline = time.monotonic() + self.config.graceful_timeout
+        while self.workers and time.monotonic() < deadline:
+            self._reap()
+            time.sleep(0.05)
+        for worker in list(self.workers.values()):
+            self.logger.warning(f"Worker {worker.slot} (pid {worker.pid}) did not stop in time; killing")
+            self._signal(worker, signal.SIGKILL)
+        while self.workers:
+            self._reap()
+            time.sleep(0.01)
+
+    @staticmethod
+    def _signal(worker: WorkerProcess, sig: int) -> None:
+        try:
+            os.kill(worker.pid, sig)
+        except ProcessLookupError:
+            pass
+
+    @staticmethod
+    def _drain_fd(fd: int) -> None:
+        try:
+            while os.read(fd, 512):
+                pass
+        except (BlockingIOError, OSError):
+            pass
+
+    # Worker
+
+    def _child(self, slot: int, pipe: int, worker_id: int) -> None:
+        """Body of a forked worker; exits the process"""
+        code = 1
+        try:
+            signal.set_wakeup_fd(-1)
+            for sig in (signal.SIGTERM, signal.SIGHUP):
+                signal.signal(sig, signal.SIG_DFL)
+            # Interrupts go to the whole process group; the master coordinates shutdown
+            signal.signal(signal.SIGINT, signal.SIG_IGN)
+            self._close_master_fds()
+            random.seed()
+            from ..streaming.frames import set_worker_id
+            set_worker_id(worker_id)
+            if self._cpus:
+                cpu = self._cpus[slot % len(self._cpus)]
+                os.sched_setaffinity(0, {cpu})
+            asyncio.run(self._serve_worker(slot, pipe))
+            code = 0
+        except BaseException:
+            logging.getLogger("app.server.prefork").exception(f"Worker {slot} crashed")
+        finally:
+            os._exit(code)
+
+    def _close_master_fds(self) -> None:
+        for worker in self.workers.values():
+            if worker.pipe >= 0:
+                os.close(worker.pipe)
+        self.workers.clear()
+        self.slots.clear()
+        try:
+            self._selector.close()
+        except (OSError, ValueError):
+            pass
+        for fd in (self._wake_r, self._wake_w):
+            try:
+                os.close(fd)
+            except OSError:
+                pass
+
+    async def _serve_worker(self, slot: int, pipe: int) -> None:
+        loop = asyncio.get_running_loop()
+        shutdown = asyncio.Event()
+        loop.add_signal_handler(signal.SIGTERM, shutdown.set)
+
+        if self._listener is not None:
+            sockets = [self._listener]
+        else:
+            sockets = [create_listen_socket(self.config.host, self.config.port, self.config.backlog, True)]
+
+        limit = self.config.max_requests
+        if limit and self.config.max_requests_jitter:
+            limit += random.randint(0, self.config.max_requests_jitter)
+        state = {'requests': 0, 'ready': False, 'recycling': False}
+
+        def tell(message: bytes) -> None:
+            try:
+                os.write(pipe, message)
+            except OSError:
+                pass
+
+        def ready() -> None:
+            if not state['ready']:
+                state['ready'] = True
+                tell(READY)
+
+        def recycle(reason: str) -> None:
+            if not state['recycling']:
+                state['recycling'] = True
+                logging.getLogger("app.server.prefork").info(f"Worker {slot} recycling: {reason}")
+                tell(RECYCLE)
+
+        app = self.app
+
+        async def worker_app(scope, receive, send):
+            kind = scope['type']
+            if kind == 'lifespan':
+                async def lifespan_send(message):
+                    await send(message)
+                    if message['type'] == 'lifespan.startup.complete':
+                        ready()
+                return await app(scope, receive, lifespan_send)
+            if kind in ('http', 'websocket'):
+                ready()
+                state['requests'] += 1
+                if limit and state['requests'] >= limit:
+                    recycle(f"served {state['requests']} requests")
+            return await app(scope, receive, send)
+
+        async def watch_memory():
+            threshold = self.config.max_memory_mb * 1024 * 1024
+            while not shutdown.is_set():
+                rss = resident_memory()
+                if rss > threshold:
+                    recycle(f"resident memory {rss // (1024 * 1024)} MB over {self.config.max_memory_mb} MB")
+                    return
+                try:
+                    await asyncio.wait_for(shutdown.wait(), self.config.memory_check_interval)
+                except asyncio.TimeoutError:
+                    pass
+
+        watcher = asyncio.ensure_future(watch_memory()) if self.config.max_memory_mb else None
+        try:
+            await self.serve(worker_app, sockets, shutdown.wait)
+        finally:
+            if watcher is not None:
+                watcher.cancel()
+            os.close(pipe)
+
+
+__all__ = ['PreforkConfig', 'PreforkSupervisor', 'WorkerProcess', 'create_listen_socket', 'hypercorn_serve',
+           'resident_memory', 'warm_up']
@@ -6,6 +6,7 @@ from hypercorn.asyncio import serve
 from hypercorn.config import Config as HyperConfig
 
 from .config import AppConfig
+from .prefork import PreforkConfig, PreforkSupervisor
 from typing import TYPE_CHECKING
 
 if TYPE_CHECKING:
@@ -18,13 +19,17 @@ class Server:
         self._server_task: Optional[asyncio.Task] = None
         self._shutdown_event = asyncio.Event()
         self._workers: list = []
+        self._app_started = False
         self.logger = logging.getLogger("app.server")
         
     async def start(self) -> None:
         """Start the server with configured options"""
         try:
             self._setup_signal_handlers()
-            await self.app.startup()
+            # Pre-fork workers run the app's startup themselves (ASGI lifespan), after the fork
+            if self.config.workers <= 1:
+                await self.app.startup()
+                self._app_started = True
             
             hyper_config = self._create_hyper_config()
             
@@ -65,27 +70,20 @@ class Server:
         self.logger.info(f"Starting server on {self.config.host}:{self.config.port}")
         await serve(self.app, config, shutdown_trigger=self._shutdown_wait)
     
+    def _create_supervisor(self, config: HyperConfig) -> PreforkSupervisor:
+        """Pre-fork supervisor for the configured workers"""
+        return PreforkSupervisor(self.app, PreforkConfig.from_config(self.config), server_config=config)
+    
     async def _start_multiprocess(self, config: HyperConfig) -> None:
-        """Start server with multiple worker processes"""
-        import multiprocessing
-        from hypercorn.run import run_single
-        
-        self.logger.info(f"Starting {self.config.workers} workers on {self.config.host}:{self.config.port}")
-        
-        for i in range(self.config.workers):
-            process = multiprocessing.Process(
-                target=run_single,
-                args=(self.app, config),
-                kwargs={"worker_id": i, "shutdown_trigger": self._shutdown_wait}
-            )
-            process.start()
-            self._workers.append(process)
+        """
+        Start server with multiple worker processes
         
-        await self._shutdown_event.wait()
-        
-        for process in self._workers:
-            process.terminate()
-            process.join()
+        Pre-fork workers must be forked from the main thread before any event
+        loop runs (a child forked under a running loop inherits it), so this
+        refuses; ``run()`` supervises from the main thread without a loop.
+        """
+        raise RuntimeError(f"{self.config.workers} workers need the blocking Server.run() (or Application.run()), "
+                           "which forks before starting an event loop")
     
     def _setup_signal_handlers(self) -> None:
         """Setup signal handlers for graceful shutdown"""
@@ -108,7 +106,9 @@ class Server:
         """Graceful shutdown of the server"""
         self.logger.info("Initiating graceful shutdown...")
         self._shutdown_event.set()
-        await self.app.shutdown()
+        if self._app_started:
+            await self.app.shutdown()
+            self._app_started = False
         
         if self._server_task and not self._server_task.done():
             self._server_task.cancel()
@@ -127,15 +127,25 @@ class Server:
                 format='%(asctime)s - %(name)s - %(levelname)s - %(message)s'
             )
             
-            asyncio.run(self.start())
+            if self.config.workers > 1:
+                self._run_prefork()
+            else:
+                asyncio.run(self.start())
             
         except KeyboardInterrupt:
             self.logger.info("Keyboard interrupt received")
         except Exception as e:
             self.logger.error(f"Server error: {e}")
         finally:
-            asyncio.run(self.shutdown())
-
-
-
-
+            if self.config.workers <= 1:
+                asyncio.run(self.shutdown())
+    
+    def _run_prefork(self) -> None:
+        """Supervise pre-fork workers from the main thread (blocking)"""
+        try:
+            import uvloop
+            asyncio.set_event_loop_policy(uvloop.EventLoopPolicy())
+            self.logger.info("Workers will use uvloop")
+        except ImportError:
+            pass
+        self._create_supervisor(self._create_hyper_config()).run()
@@ -11,21 +11,37 @@ This module provides comprehensive Server-Sent Events support with:
 - Performance optimization
 - Security features
 - Monitoring and metrics
+
+Events sent to a channel are encoded once and pushed into a bounded
+outbox per connection, each drained by its own writer task, so a slow
+client only ever delays itself. What happens when an outbox is full is
+set by ``SlowConsumerPolicy``.
 """
 
 import asyncio
-import json
 import logging
+import math
 import time
 import uuid
-from typing import Dict, List, Callable, Any, Optional, Type, Union, Awaitable, Set
+from array import array
+from bisect import bisect_left
+from collections import deque
+from typing import Dict, List, Callable, Any, Optional, Type, Union, Awaitable, Set, Tuple, Deque
 from dataclasses import dataclass, field
 from enum import Enum
 from functools import wraps
 from contextlib import asynccontextmanager
 
+from pyserv.core import codec
+
 logger = logging.getLogger(__name__)
 
+# Fan-out latency histogram bounds in seconds, from enqueue to written
+FANOUT_BUCKETS = (0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0)
+
+# Recent deliveries per channel kept for percentiles
+LATENCY_WINDOW = 1024
+
 
 class SSEEventType(str, Enum):
     """SSE event types"""
@@ -37,6 +53,13 @@ class SSEEventType(str, Enum):
     CUSTOM = "custom"
 
 
+class SlowConsumerPolicy(str, Enum):
+    """What to do when a connection's outbox is full"""
+    DROP_OLDEST = "drop_oldest"    # Discard the oldest queued event
+    COALESCE = "coalesce"          # Overwrite the queued event with the same name, else drop oldest
+    DISCONNECT = "disconnect"      # Close the connection
+
+
 class SSEConnectionState(str, Enum):
     """SSE connection states"""
     CONNECTING = "connecting"
@@ -69,7 +92,7 @@ class SSEEvent:
 
         # Handle data (can be string, dict, or list)
         if isinstance(self.data, (dict, list)):
-            data_str = json.dumps(self.data, ensure_ascii=False)
+            data_str = codec.dumps_str(self.data)
         else:
             data_str = str(self.data)
 
@@ -80,6 +103,118 @@ class SSEEvent:
         lines.append("")  # Empty line to end event
         return '\n'.join(lines)
 
+    def encode(self) -> bytes:
+        """Wire frame for this event, including the blank line that ends it"""
+        return (self.to_string() + '\n').encode('utf-8')
+
+    @classmethod
+    def from_frame(cls, frame: Any) -> 'SSEEvent':
+        """Event for a binary stream frame: its id, type as event name and payload as text (base64 if binary)"""
+        return cls(id=str(frame.id), event=frame.type, data=frame.text(), timestamp=frame.timestamp)
+
+
+# Queued frame: (frame, event name, channel, enqueued at)
+OutboxItem = Tuple[bytes, str, Optional[str], float]
+
+
+class SSEOutbox:
+    """Bounded frame buffer for one connection, drained by its writer task"""
+
+    def __init__(self, maxsize: int = 256, policy: SlowConsumerPolicy = SlowConsumerPolicy.DROP_OLDEST):
+        self.maxsize = maxsize
+        self.policy = SlowConsumerPolicy(policy)
+        self.items: Deque[OutboxItem] = deque()
+        self.dropped = 0
+        self.coalesced = 0
+        self.closed = False
+        self._ready = asyncio.Event()
+
+    def __len__(self) -> int:
+        return len(self.items)
+
+    def put(self, item: OutboxItem) -> bool:
+        """Queue a frame; False means the connection is too slow and must be disconnected"""
+        if self.closed:
+            return False
+        items = self.items
+        if len(items) >= self.maxsize:
+            if self.policy is SlowConsumerPolicy.DISCONNECT:
+                return False
+            if self.policy is SlowConsumerPolicy.COALESCE:
+                name = item[1]
+                for index in range(len(items) - 1, -1, -1):
+                    if items[index][1] == name:
+                        # Keep the older slot so ordering against other events holds
+                        items[index] = item
+                        self.coalesced += 1
+                        return True
+            items.popleft()
+            self.dropped += 1
+        items.append(item)
+        self._ready.set()
+        return True
+
+    async def get_batch(self) -> List[OutboxItem]:
+        """Wait for frames and take everything queued; empty once closed and drained"""
+        while not self.items:
+            if self.closed:
+                return []
+            self._ready.clear()
+            await self._ready.wait()
+        batch = list(self.items)
+        self.items.clear()
+        return batch
+
+    def close(self) -> None:
+        """Stop accepting frames; the writer exits after sending what is queued"""
+        self.closed = True
+        self._ready.set()
+
+
+class SSEChannelStats:
+    """Fan-out counters and delivery latency for one channel"""
+
+    def __init__(self):
+        self.events = 0
+        self.deliveries = 0
+        self.dropped = 0
+        self.coalesced = 0
+        self.disconnects = 0
+        self.enqueue_seconds = 0.0
+        self.bucket_counts = array('Q', [0] * (len(FANOUT_BUCKETS) + 1))
+        self.latency_sum = 0.0
+        self._latencies = array('d', [0.0] * LATENCY_WINDOW)
+        self._latency_index = 0
+
+    def record_delivery(self, seconds: float) -> None:
+        self.deliveries += 1
+        self.bucket_counts[bisect_left(FANOUT_BUCKETS, seconds)] += 1
+        self.latency_sum += seconds
+        self._latencies[self._latency_index] = seconds
+        self._latency_index = (self._latency_index + 1) % LATENCY_WINDOW
+
+    def latency_percentiles(self, *quantiles: float) -> List[float]:
+        """Delivery latency quantiles over the last ``LATENCY_WINDOW`` deliveries"""
+        filled = min(self.deliveries, LATENCY_WINDOW)
+        if not filled:
+            return [0.0 for _ in quantiles]
+        window = sorted(self._latencies[:filled])
+        return [window[min(filled - 1, int(q * filled))] for q in quantiles]
+
+    def to_dict(self) -> Dict[str, Any]:
+        p50, p95, p99 = self.latency_percentiles(0.5, 0.95, 0.99)
+        return {
+            'events': self.events,
+            'deliveries': self.deliveries,
+            'dropped': self.dropped,
+            'coalesced': self.coalesced,
+            'disconnects': self.disconnects,
+            'enqueue_seconds': self.enqueue_seconds,
+            'latency_p50': p50,
+            'latency_p95': p95,
+            'latency_p99': p99,
+        }
+
 
 @dataclass
 class SSEConnection:
@@ -95,7 +230,10 @@ class SSEConnection:
     max_reconnect_attempts: int = 5
     reconnect_attempts: int = 0
     metadata: Dict[str, Any] = field(default_factory=dict)
+    # Awaitable taking the encoded bytes of one or more events
     response_writer: Optional[Callable] = None
+    outbox: Optional[SSEOutbox] = field(default=None, repr=False)
+    writer_task: Optional[asyncio.Task] = field(default=None, repr=False)
 
     def add_channel(self, channel: str) -> None:
         """Add channel subscription"""
@@ -117,9 +255,17 @@ class SSEConnection:
 
 
 class SSEManager:
-    """Server-Sent Events Manager"""
+    """Server-Sent Events Manager
 
-    def __init__(self):
+    Args:
+        outbox_size: Frames each connection may have queued
+        slow_consumer_policy: What to do when a connection's outbox is full
+        drain_timeout: Seconds a disconnecting writer may spend flushing its outbox
+    """
+
+    def __init__(self, outbox_size: int = 256,
+                 slow_consumer_policy: SlowConsumerPolicy = SlowConsumerPolicy.DROP_OLDEST,
+                 drain_timeout: float = 5.0):
         self.connections: Dict[str, SSEConnection] = {}
         self.channels: Dict[str, Set[str]] = {}  # channel -> set of connection_ids
         self.event_handlers: Dict[str, List[Callable]] = {}
@@ -127,8 +273,12 @@ class SSEManager:
         self.cleanup_task: Optional[asyncio.Task] = None
         self._running = False
         self._event_queue: asyncio.Queue[SSEEvent] = asyncio.Queue()
-        self._event_history: List[SSEEvent] = []
         self.max_history_size = 1000
+        self._event_history: Deque[SSEEvent] = deque(maxlen=self.max_history_size)
+        self.outbox_size = outbox_size
+        self.slow_consumer_policy = SlowConsumerPolicy(slow_consumer_policy)
+        self.drain_timeout = drain_timeout
+        self.channel_stats: Dict[str, SSEChannelStats] = {}
 
     async def start(self) -> None:
         """Start SSE manager"""
@@ -165,9 +315,11 @@ class SSEManager:
             except asyncio.CancelledError:
                 pass
 
-        # Close all connections
-        for connection in list(self.connections.values()):
-            await self.disconnect(connection.connection_id)
+        # Close all connections, draining their outboxes concurrently
+        await asyncio.gather(
+            *(self.disconnect(connection_id) for connection_id in list(self.connections)),
+            return_exceptions=True
+        )
 
         logger.info("SSE Manager stopped")
 
@@ -224,15 +376,35 @@ class SSEManager:
 
         await self._send_to_connection(connection_id, disconnect_event)
 
-        # Remove from channels
+        # Let the writer flush what is queued, close event included
+        task = connection.writer_task
+        if connection.outbox is not None:
+            connection.outbox.close()
+        if task is not None and not task.done():
+            try:
+                await asyncio.wait_for(asyncio.shield(task), timeout=self.drain_timeout)
+            except (asyncio.TimeoutError, Exception):
+                pass
+
+        self._remove_connection(connection_id)
+        logger.info(f"SSE connection disconnected: {connection_id}")
+
+    def _remove_connection(self, connection_id: str) -> None:
+        """Forget a connection and stop its writer without sending anything"""
+        connection = self.connections.pop(connection_id, None)
+        if connection is None:
+            return
+
         for channel in list(connection.channels):
             if channel in self.channels:
                 self.channels[channel].discard(connection_id)
 
-        # Remove connection
-        del self.connections[connection_id]
-
-        logger.info(f"SSE connection disconnected: {connection_id}")
+        if connection.outbox is not None:
+            connection.outbox.close()
+        task = connection.writer_task
+        if task is not None and not task.done() and task is not asyncio.current_task():
+            task.cancel()
+        connection.state = SSEConnectionState.DISCONNECTED
 
     async def send_to_connection(self, connection_id: str, event: SSEEvent) -> bool:
         """Send event to specific connection"""
@@ -246,54 +418,85 @@ class SSEManager:
 
     async def send_to_channel(self, channel: str, event: SSEEvent,
                             filter_func: Optional[Callable] = None) -> int:
-        """Send event to all connections in a channel"""
-        if channel not in self.channels:
+        """Queue event for all connections in a channel; returns how many accepted it"""
+        connection_ids = self.channels.get(channel)
+        if not connection_ids:
             return 0
 
-        sent_count = 0
-        connection_ids = list(self.channels[channel])
-
+        connections = []
         for connection_id in connection_ids:
-            if connection_id in self.connections:
-                connection = self.connections[connection_id]
-
-                # Apply filter if provided
-                if filter_func and not filter_func(connection):
-                    continue
-
-                if connection.has_channel(channel):
-                    if await self._send_to_connection(connection_id, event):
-                        sent_count += 1
+            connection = self.connections.get(connection_id)
+            if connection is None or not connection.has_channel(channel):
+                continue
+            # Apply filter if provided
+            if filter_func and not filter_func(connection):
+                continue
+            connections.append(connection)
 
-        return sent_count
+        return self._fan_out(connections, event, channel)
 
     async def send_to_user(self, user_id: str, event: SSEEvent) -> int:
-        """Send event to all connections of a user"""
-        sent_count = 0
-
-        for connection in self.connections.values():
-            if connection.user_id == user_id:
-                if await self._send_to_connection(connection.connection_id, event):
-                    sent_count += 1
-
-        return sent_count
+        """Queue event for all connections of a user"""
+        connections = [c for c in self.connections.values() if c.user_id == user_id]
+        return self._fan_out(connections, event, None)
 
     async def broadcast(self, event: SSEEvent,
                        filter_func: Optional[Callable] = None) -> int:
-        """Broadcast event to all connections"""
-        sent_count = 0
-
-        for connection_id in list(self.connections.keys()):
-            connection = self.connections[connection_id]
-
-            # Apply filter if provided
-            if filter_func and not filter_func(connection):
+        """Queue event for all connections"""
+        connections = [
+            c for c in self.connections.values()
+            if not filter_func or filter_func(c)
+        ]
+        return self._fan_out(connections, event, '*')
+
+    def _fan_out(self, connections: List[SSEConnection], event: SSEEvent, channel: Optional[str]) -> int:
+        """Encode once and push into each connection's outbox; never awaits a client"""
+        started = time.monotonic()
+        item: OutboxItem = (event.encode(), event.event, channel, started)
+        stats = self._channel_stats(channel) if channel is not None else None
+
+        queued = 0
+        too_slow = []
+        for connection in connections:
+            outbox = self._outbox_for(connection)
+            if outbox is None:
                 continue
-
-            if await self._send_to_connection(connection_id, event):
-                sent_count += 1
-
-        return sent_count
+            dropped, coalesced = outbox.dropped, outbox.coalesced
+            if outbox.put(item):
+                queued += 1
+            else:
+                too_slow.append(connection.connection_id)
+            if stats is not None:
+                stats.dropped += outbox.dropped - dropped
+                stats.coalesced += outbox.coalesced - coalesced
+
+        for connection_id in too_slow:
+            logger.warning(f"Disconnecting slow SSE consumer: {connection_id}")
+            self._remove_connection(connection_id)
+
+        if queued:
+            self._add_to_history(event)
+        if stats is not None:
+            stats.events += 1
+            stats.disconnects += len(too_slow)
+            stats.enqueue_seconds += time.monotonic() - started
+        return queued
+
+    def _channel_stats(self, channel: str) -> SSEChannelStats:
+        stats = self.channel_stats.get(channel)
+        if stats is None:
+            stats = self.channel_stats[channel] = SSEChannelStats()
+        return stats
+
+    def _outbox_for(self, connection: SSEConnection) -> Optional[SSEOutbox]:
+        """The connection's outbox, starting its writer on first use; None without a writer"""
+        if connection.response_writer is None:
+            return None
+        if connection.outbox is None:
+            connection.outbox = SSEOutbox(self.outbox_size, self.slow_consumer_policy)
+        if connection.writer_task is None:
+            connection.writer_task = asyncio.create_task(self._writer_loop(connection))
+        return connection.outbox
 
     async def subscribe(self, connection_id: str, channel: str) -> bool:
         """Subscribe connection to channel"""
@@ -359,35 +562,37 @@ class SSEManager:
                 pass
 
     async def _send_to_connection(self, connection_id: str, event: SSEEvent) -> bool:
-        """Send event to specific connection"""
-        if connection_id not in self.connections:
+        """Queue event for a specific connection"""
+        connection = self.connections.get(connection_id)
+        if connection is None:
             return False
+        return self._fan_out([connection], event, None) == 1
 
-        connection = self.connections[connection_id]
-
+    async def _writer_loop(self, connection: SSEConnection) -> None:
+        """Write queued frames to one client, batching whatever piled up meanwhile"""
+        outbox = connection.outbox
         try:
-            if connection.response_writer:
-                event_str = event.to_string()
-                await connection.response_writer(event_str)
-
-                # Store in history
-                self._add_to_history(event)
-
-                return True
-
+            while True:
+                batch = await outbox.get_batch()
+                if not batch:
+                    break
+                await connection.response_writer(b''.join(item[0] for item in batch))
+                now = time.monotonic()
+                for _, _, channel, enqueued_at in batch:
+                    if channel is not None:
+                        self._channel_stats(channel).record_delivery(now - enqueued_at)
+        except asyncio.CancelledError:
+            raise
         except Exception as e:
-            logger.error(f"Error sending SSE event to {connection_id}: {e}")
-
-        return False
+            logger.error(f"Error sending SSE event to {connection.connection_id}: {e}")
+            self._remove_connection(connection.connection_id)
 
     def _add_to_history(self, event: SSEEvent) -> None:
         """Add event to history"""
+        if self._event_history.maxlen != self.max_history_size:
+            self._event_history = deque(self._event_history, maxlen=self.max_history_size)
         self._event_history.append(event)
 
-        # Trim history if needed
-        if len(self._event_history) > self.max_history_size:
-            self._event_history = self._event_history[-self.max_history_size:]
-
     async def _heartbeat_loop(self) -> None:
         """Send heartbeat events to connections"""
         while self._running:
@@ -444,9 +649,50 @@ class SSEManager:
             'channel_subscriptions': {
                 channel: len(connections)
                 for channel, connections in self.channels.items()
+            },
+            'queued_frames': sum(len(c.outbox) for c in self.connections.values() if c.outbox),
+            'channel_fanout': {
+                channel: stats.to_dict()
+                for channel, stats in self.channel_stats.items()
             }
         }
 
+    def collect_metrics(self) -> List[Any]:
+        """Fan-out metrics as ``MetricValue`` records for ``MetricsCollector.add_collector``"""
+        from pyserv.monitoring.metrics import MetricValue
+
+        now = time.time()
+
+        def value(name, amount, metric_type='gauge', **labels):
+            return MetricValue(name=name, value=amount, timestamp=now, labels=labels, metric_type=metric_type)
+
+        values = [
+            value('sse_connections', len(self.connections)),
+            value('sse_queued_frames', sum(len(c.outbox) for c in self.connections.values() if c.outbox)),
+        ]
+        for channel, stats in self.channel_stats.items():
+            values += [
+                value('sse_events_total', stats.events, 'counter', channel=channel),
+                value('sse_dropped_total', stats.dropped, 'counter', channel=channel),
+                value('sse_coalesced_total', stats.coalesced, 'counter', channel=channel),
+                value('sse_slow_disconnects_total', stats.disconnects, 'counter', channel=channel),
+            ]
+            cumulative = 0
+            for bound, count in zip(FANOUT_BUCKETS + (math.inf,), stats.bucket_counts):
+                cumulative += count
+                le = '+Inf' if bound == math.inf else str(bound)
+                values.append(value('sse_fanout_seconds_bucket', cumulative, 'histogram', channel=channel, le=le))
+            values.append(value('sse_fanout_seconds_sum', stats.latency_sum, 'histogram', channel=channel))
+            values.append(value('sse_fanout_seconds_count', cumulative, 'histogram', channel=channel))
+        return values
+
+    def register_metrics(self, collector: Any = None) -> None:
+        """Export fan-out metrics through a ``MetricsCollector`` (default: the global one)"""
+        if collector is None:
+            from pyserv.monitoring.metrics import get_metrics_collector
+            collector = get_metrics_collector()
+        collector.add_collector(self.collect_metrics)
+
     def get_connection(self, connection_id: str) -> Optional[SSEConnection]:
         """Get connection by ID"""
         return self.connections.get(connection_id)
@@ -503,6 +749,7 @@ def create_sse_event(event_type: str, data: Any, event_id: Optional[str] = None,
 
 __all__ = [
     'SSEManager', 'SSEConnection', 'SSEEvent', 'SSEEventType',
-    'SSEConnectionState', 'get_sse_manager', 'start_sse_manager',
+    'SSEConnectionState', 'SSEOutbox', 'SSEChannelStats', 'SlowConsumerPolicy',
+    'FANOUT_BUCKETS', 'get_sse_manager', 'start_sse_manager',
     'stop_sse_manager', 'create_sse_event'
 ]
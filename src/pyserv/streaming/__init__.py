@@ -3,7 +3,20 @@ Modern Python Streaming Module
 High-performance async streaming processor for real-time data handling.
 """
 
-from .core import *
+# Loaded on first access, so the IoT and WebSocket layers can use frames without the processors
+from pyserv.utils.lazy import attach
+
+__getattr__, __dir__ = attach(__name__, {
+    ".core": [
+        "StreamConfig", "StreamError", "StreamTimeoutError", "StreamConnectionError",
+        "StreamMessage", "StreamProcessor", "AsyncStreamProcessor", "BufferedStreamProcessor",
+        "QuantumStreamProcessor", "StreamClient", "get_stream_processor", "stream_messages",
+        "create_message_stream", "StreamMetrics", "get_stream_metrics",
+    ],
+    ".frames": ["StreamFrame", "FrameDecoder", "FrameError", "SnowflakeIds", "next_id",
+                "encode_frames", "iter_frames"],
+    ".ring": ["FrameRing", "FrameChannel"],
+})
 
 __all__ = [
     'StreamConfig',
@@ -20,9 +33,14 @@ __all__ = [
     'stream_messages',
     'create_message_stream',
     'StreamMetrics',
-    'get_stream_metrics'
+    'get_stream_metrics',
+    'StreamFrame',
+    'FrameDecoder',
+    'FrameError',
+    'SnowflakeIds',
+    'next_id',
+    'encode_frames',
+    'iter_frames',
+    'FrameRing',
+    'FrameChannel'
 ]
-
-
-
-
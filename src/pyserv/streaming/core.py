@@ -4,8 +4,6 @@ High-performance async streaming processor for real-time data handling.
 """
 
 import asyncio
-import json
-import pickle
 from typing import Dict, Any, Optional, Union, List, Callable, AsyncGenerator, Iterator
 from dataclasses import dataclass
 from abc import ABC, abstractmethod
@@ -16,6 +14,10 @@ from collections import deque
 import threading
 import queue
 
+from pyserv.core import codec
+from pyserv.streaming.frames import StreamFrame, next_id
+from pyserv.streaming.ring import FrameRing
+
 
 logger = logging.getLogger(__name__)
 
@@ -57,8 +59,8 @@ class StreamMessage:
         self.id = self._generate_id()
 
     def _generate_id(self) -> str:
-        """Generate unique message ID"""
-        return f"{int(self.timestamp * 1000000)}_{hash(str(self.data))}"
+        """Generate unique message ID (a snowflake id, so the payload is never stringified)"""
+        return str(next_id())
 
     def to_dict(self) -> Dict[str, Any]:
         """Convert message to dictionary"""
@@ -72,7 +74,7 @@ class StreamMessage:
 
     def to_json(self) -> str:
         """Convert message to JSON string"""
-        return json.dumps(self.to_dict())
+        return codec.dumps_str(self.to_dict())
 
     @classmethod
     def from_dict(cls, data: Dict[str, Any]) -> 'StreamMessage':
@@ -85,7 +87,33 @@ class StreamMessage:
     @classmethod
     def from_json(cls, json_str: str) -> 'StreamMessage':
         """Create message from JSON string"""
-        return cls.from_dict(json.loads(json_str))
+        return cls.from_dict(codec.loads(json_str))
+
+    def to_frame(self) -> StreamFrame:
+        """Convert message to a binary frame (bytes payloads are carried without copying)"""
+        message_id = int(self.id) if self.id.isdigit() else next_id()
+        return StreamFrame.build(self.data, self.message_type, self.metadata,
+                                 id=message_id, timestamp_ns=int(self.timestamp * 1e9))
+
+    def to_bytes(self) -> bytes:
+        """Convert message to an encoded binary frame"""
+        return self.to_frame().to_bytes()
+
+    @classmethod
+    def from_frame(cls, frame: StreamFrame) -> 'StreamMessage':
+        """Create message from a binary frame"""
+        msg = cls.__new__(cls)
+        msg.data = frame.data
+        msg.message_type = frame.type
+        msg.metadata = frame.metadata
+        msg.timestamp = frame.timestamp
+        msg.id = str(frame.id)
+        return msg
+
+    @classmethod
+    def from_bytes(cls, data: Union[bytes, bytearray, memoryview]) -> 'StreamMessage':
+        """Create message from an encoded binary frame"""
+        return cls.from_frame(StreamFrame.decode(data))
 
 
 class StreamProcessor(ABC):
@@ -96,6 +124,8 @@ class StreamProcessor(ABC):
         self._running = False
         self._connections: Dict[str, Any] = {}
         self._message_queue = asyncio.Queue(maxsize=self.config.buffer_size)
+        self.hub = None
+        self.hub_topic: Optional[str] = None
 
     @abstractmethod
     async def process_message(self, message: StreamMessage) -> Optional[StreamMessage]:
@@ -130,8 +160,21 @@ class StreamProcessor(ABC):
         # Implementation depends on connection type
         pass
 
+    def use_hub(self, hub, topic: str = "stream"):
+        """
+        Broadcast through a ``WebSocketHub`` topic instead of connection by connection.
+
+        Each message is then encoded once and queued to every socket
+        subscribed to ``topic``, without waiting on any of them.
+        """
+        self.hub = hub
+        self.hub_topic = topic
+
     async def broadcast(self, message: StreamMessage):
         """Broadcast message to all connections"""
+        if self.hub is not None:
+            await self.hub.publish(self.hub_topic, message.to_frame())
+            return
         for connection_id in self._connections:
             await self._send_to_connection(connection_id, message)
 
@@ -231,42 +274,83 @@ class AsyncStreamProcessor(StreamProcessor):
 
 
 class BufferedStreamProcessor(StreamProcessor):
-    """Buffered streaming processor with batch processing"""
+    """
+    Buffered streaming processor with batch processing.
+
+    Messages (or frames) are queued by reference in a bounded ``FrameRing``;
+    each pop takes a whole batch at once, so concurrent callers never see the
+    same message twice and no lock is needed.
+    """
 
     def __init__(self, config: Optional[StreamConfig] = None):
         super().__init__(config)
-        self._buffer: List[StreamMessage] = []
-        self._buffer_lock = asyncio.Lock()
+        self._buffer = FrameRing(max(1, self.config.buffer_size))
+        self._batch_size = max(1, self.config.buffer_size // 4)
 
     async def process_message(self, message: StreamMessage) -> Optional[StreamMessage]:
         """Buffer message for batch processing"""
-        async with self._buffer_lock:
-            self._buffer.append(message)
+        while not self._buffer.push(message):
+            await self._process_batch()
 
-            # Process batch if buffer is full
-            if len(self._buffer) >= self.config.buffer_size // 4:
-                await self._process_batch()
+        # Process batch if buffer is full
+        if len(self._buffer) >= self._batch_size:
+            await self._process_batch()
 
         return None
 
+    async def flush(self):
+        """Process whatever is buffered, even a partial batch"""
+        while len(self._buffer):
+            await self._process_batch()
+
+    async def stop(self):
+        """Flush buffered messages, then stop"""
+        await self.flush()
+        await super().stop()
+
     async def _process_batch(self):
         """Process batch of messages"""
-        if not self._buffer:
+        batch = self._buffer.pop_many()
+        if not batch:
             return
 
-        batch = self._buffer.copy()
-        self._buffer.clear()
+        # Send processed messages
+        for message in await self._run_batch(batch):
+            await self.broadcast(message)
 
-        # Process batch
+    async def _run_batch(self, batch: List[StreamMessage]) -> List[StreamMessage]:
+        """Process a batch, keeping the messages that produced a result"""
         processed_batch = []
         for message in batch:
             processed = await self._process_single_message(message)
             if processed:
                 processed_batch.append(processed)
+        return processed_batch
 
-        # Send processed messages
-        for message in processed_batch:
-            await self.broadcast(message)
+    async def handle_connection(self, connection_id: str, connection) -> AsyncGenerator[StreamMessage, None]:
+        """Handle connection, taking queued messages a batch at a time"""
+        self._connections[connection_id] = connection
+
+        try:
+            while self._running:
+                try:
+                    batch = [await asyncio.wait_for(
+                        self._message_queue.get(),
+                        timeout=self.config.heartbeat_interval
+                    )]
+                except asyncio.TimeoutError:
+                    yield StreamMessage("heartbeat", "system")
+                    continue
+
+                # Take whatever else is already queued, up to a batch
+                while len(batch) < self._batch_size and not self._message_queue.empty():
+                    batch.append(self._message_queue.get_nowait())
+
+                for processed in await self._run_batch(batch):
+                    yield processed
+
+        finally:
+            del self._connections[connection_id]
 
     async def _process_single_message(self, message: StreamMessage) -> Optional[StreamMessage]:
         """Process single message"""
@@ -421,7 +505,16 @@ class StreamMetrics:
     def record_message(self, message: StreamMessage):
         """Record message processing"""
         self.messages_processed += 1
-        self.bytes_processed += len(str(message.data).encode())
+        data = message.data
+        if isinstance(data, (bytes, bytearray, memoryview)):
+            self.bytes_processed += memoryview(data).nbytes
+        else:
+            self.bytes_processed += len(str(data).encode())
+
+    def record_frame(self, frame: StreamFrame):
+        """Record frame processing, counting its encoded size"""
+        self.messages_processed += 1
+        self.bytes_processed += frame.nbytes
 
     def record_error(self):
         """Record error"""
@@ -0,0 +1,467 @@
+"""
+Binary frame format for the streaming core.
+
+A frame is length-prefixed so a byte stream splits into frames without
+scanning, and its payload is carried (and handed out) as a memoryview, so
+decoding a frame never copies what it carries::
+
+    offset  size  field
+         0     4  frame length, excluding these 4 bytes (little endian)
+         4     1  version
+         5     1  payload encoding (RAW bytes, UTF-8 TEXT or JSON)
+         6     2  message type length
+         8     8  message id
+        16     8  timestamp, nanoseconds since the epoch
+        24     4  metadata length (JSON, 0 when there is none)
+        28     4  reserved
+        32        message type (UTF-8), metadata, payload
+
+``pyserv.core.frame_ring`` splits buffers into frames natively when it is
+built; the Python fallback decodes the same format.
+
+Message ids come from ``SnowflakeIds``: a millisecond timestamp, a worker id
+and a per-millisecond sequence, so ids increase within a process and are
+unique across processes with distinct worker ids. The prefork supervisor
+assigns each worker an id from its slot through ``set_worker_id``; other
+processes fall back to the low bits of their pid, which can collide.
+"""
+
+import base64
+import os
+import struct
+import threading
+import time
+from typing import Any, Dict, Iterable, List, Optional, Tuple, Union
+
+from pyserv.core import codec, load_extension
+
+_frame_ring = load_extension("frame_ring")
+
+FRAME_VERSION = 1
+
+# frame length, version, encoding, type length, id, timestamp_ns, metadata length
+HEADER = struct.Struct("<IBBHQQI4x")
+HEADER_SIZE = HEADER.size
+PREFIX_SIZE = 4
+
+# Payload encodings
+RAW = 0
+TEXT = 1
+JSON = 2
+
+# Upper bound accepted by the decoder, so a corrupt length cannot make it buffer forever
+MAX_FRAME_SIZE = 16 * 1024 * 1024
+
+BytesLike = Union[bytes, bytearray, memoryview]
+
+
+class FrameError(ValueError):
+    """Raised for malformed or oversized frames"""
+    pass
+
+
+# Message ids
+
+# 2024-01-01T00:00:00Z; 41 bits of milliseconds from here last until 2093
+SNOWFLAKE_EPOCH_MS = 1704067200000
+WORKER_BITS = 10
+SEQUENCE_BITS = 12
+_SEQUENCE_MASK = (1 << SEQUENCE_BITS) - 1
+_WORKER_MASK = (1 << WORKER_BITS) - 1
+_TIME_SHIFT = WORKER_BITS + SEQUENCE_BITS
+_time_ns = time.time_ns
+
+
+class SnowflakeIds:
+    """
+    64-bit ids: 41 bits of milliseconds, 10 bits of worker id, 12 bits of sequence.
+
+    Up to 4096 ids per millisecond per worker; past that the generator moves
+    on to the next millisecond rather than waiting for the clock. If the clock
+    steps back, ids keep counting from the last millisecond issued, so they
+    never repeat or decrease within a worker.
+    """
+
+    def __init__(self, worker_id: Optional[int] = None, epoch_ms: int = SNOWFLAKE_EPOCH_MS):
+        self.epoch_ms = epoch_ms
+        self._fixed_worker = worker_id is not None
+        self.worker_id = (worker_id if worker_id is not None else os.getpid()) & _WORKER_MASK
+        self._worker_bits = self.worker_id << SEQUENCE_BITS
+        self._last_ms = 0
+        self._sequence = 0
+        self._lock = threading.Lock()
+
+    def assign(self, worker_id: int) -> None:
+        """Use ``worker_id`` from now on, including after later forks"""
+        with self._lock:
+            self._fixed_worker = True
+            self.worker_id = worker_id & _WORKER_MASK
+            self._worker_bits = self.worker_id << SEQUENCE_BITS
+
+    def reseed(self) -> None:
+        """Pick up the new pid after a fork and restart the sequence"""
+        if not self._fixed_worker:
+            self.worker_id = os.getpid() & _WORKER_MASK
+            self._worker_bits = self.worker_id << SEQUENCE_BITS
+        self._lock = threading.Lock()
+        self._last_ms = 0
+        self._sequence = 0
+
+    def next(self) -> int:
+        with self._lock:
+            now = _time_ns() // 1_000_000 - self.epoch_ms
+            if now > self._last_ms:
+                self._last_ms = now
+                self._sequence = 0
+                return (now << _TIME_SHIFT) | self._worker_bits
+            sequence = self._sequence = (self._sequence + 1) & _SEQUENCE_MASK
+            if not sequence:
+                self._last_ms += 1
+            return (self._last_ms << _TIME_SHIFT) | self._worker_bits | sequence
+
+    __call__ = next
+
+    def timestamp_ms(self, message_id: int) -> int:
+        """Epoch milliseconds encoded in an id"""
+        return (message_id >> _TIME_SHIFT) + self.epoch_ms
+
+
+_ids = SnowflakeIds()
+if hasattr(os, 'register_at_fork'):
+    os.register_at_fork(after_in_child=_ids.reseed)
+
+# Next message id from the process-wide generator
+next_id = _ids.next
+# Give the process-wide generator an explicit worker id
+set_worker_id = _ids.assign
+
+
+# Frames
+
+def _encode_payload(data: Any) -> Tuple[int, BytesLike]:
+    if isinstance(data, memoryview):
+        # Lengths below are byte counts, so typed views (e.g. of an array) are re-viewed as bytes
+        return RAW, data if data.itemsize == 1 else data.cast('B')
+    if isinstance(data, (bytes, bytearray)):
+        return RAW, data
+    if isinstance(data, str):
+        return TEXT, data.encode('utf-8')
+    return JSON, codec.dumps(data)
+
+
+class StreamFrame:
+    """
+    One binary streaming frame.
+
+    Frames built in-process keep the payload object they were given; frames
+    decoded from a buffer hold memoryviews into it. ``data`` and ``metadata``
+    are decoded on first access only.
+    """
+
+    __slots__ = ('id', 'timestamp_ns', 'type', 'encoding', 'payload', '_metadata', '_metadata_raw', '_wire')
+
+    def __init__(self, id: int, timestamp_ns: int, type: str, encoding: int, payload: BytesLike,
+                 metadata: Optional[Dict[str, Any]] = None, metadata_raw: BytesLike = b''):
+        self.id = id
+        self.timestamp_ns = timestamp_ns
+        self.type = type
+        self.encoding = encoding
+        self.payload = payload
+        self._metadata = metadata
+        self._metadata_raw = metadata_raw
+        self._wire: Optional[BytesLike] = None
+
+    @classmethod
+    def build(cls, data: Any, type: str = "data", metadata: Optional[Dict[str, Any]] = None,
+              id: Optional[int] = None, timestamp_ns: Optional[int] = None) -> 'StreamFrame':
+        """
+        Frame ``data``: bytes-like payloads are carried as-is, ``str`` as UTF-8
+        and anything else as JSON.
+        """
+        if data.__class__ is bytes:
+            encoding, payload = RAW, data
+        else:
+            encoding, payload = _encode_payload(data)
+        return cls(_ids.next() if id is None else id,
+                   _time_ns() if timestamp_ns is None else timestamp_ns,
+                   type, encoding, payload, metadata or None)
+
+    @property
+    def metadata(self) -> Dict[str, Any]:
+        if self._metadata is None:
+            self._metadata = codec.loads(self._metadata_raw) if self._metadata_raw else {}
+        return self._metadata
+
+    @property
+    def data(self) -> Any:
+        """The payload decoded per its encoding; RAW payloads are returned as a memoryview"""
+        if self.encoding == RAW:
+            return self.payload if isinstance(self.payload, memoryview) else memoryview(self.payload)
+        if self.encoding == TEXT:
+            return str(self.payload, 'utf-8')
+        return codec.loads(self.payload)
+
+    @property
+    def timestamp(self) -> float:
+        return self.timestamp_ns / 1e9
+
+    @property
+    def is_binary(self) -> bool:
+        return self.encoding == RAW
+
+    def text(self) -> str:
+        """Payload as text: UTF-8 and JSON as written, RAW payloads base64-encoded"""
+        if self.encoding == RAW:
+            return base64.b64encode(self.payload).decode('ascii')
+        return str(self.payload, 'utf-8')
+
+    def _metadata_bytes(self) -> BytesLike:
+        if self._metadata_raw or not self._metadata:
+            return self._metadata_raw
+        self._metadata_raw = codec.dumps(self._metadata)
+        return self._metadata_raw
+
+    def _header(self, type_bytes: bytes, metadata: BytesLike) -> bytes:
+        length = HEADER_SIZE - PREFIX_SIZE + len(type_bytes) + len(metadata) + len(self.payload)
+        if length > 0xFFFFFFFF:
+            raise FrameError("frame larger than 4 GiB")
+        return HEADER.pack(length, FRAME_VERSION, self.encoding, len(type_bytes),
+                           self.id, self.timestamp_ns, len(metadata))
+
+    @property
+    def nbytes(self) -> int:
+        """Encoded size, including the length prefix"""
+        if self._wire is not None:
+            return len(self._wire)
+        return HEADER_SIZE + len(self.type.encode('utf-8')) + len(self._metadata_bytes()) + len(self.payload)
+
+    def parts(self) -> List[BytesLike]:
+        """
+        The encoded frame as ``[header, payload]`` for ``transport.writelines``
+        or ``socket.sendmsg``, so the payload itself is never copied.
+        """
+        if self._wire is not None:
+            return [self._wire]
+        type_bytes = self.type.encode('utf-8')
+        metadata = self._metadata_bytes()
+        return [self._header(type_bytes, metadata) + type_bytes + metadata, self.payload]
+
+    def encode(self) -> BytesLike:
+        """The encoded frame as one buffer (cached; decoded frames return a view of their source)"""
+        if self._wire is None:
+            self._wire = b''.join(self.parts())
+        return self._wire
+
+    def to_bytes(self) -> bytes:
+        wire = self.encode()
+        return wire if isinstance(wire, bytes) else bytes(wire)
+
+    def encode_into(self, buffer: Union[bytearray, memoryview], offset: int = 0) -> int:
+        """Write the frame into a preallocated buffer; returns the offset just past it"""
+        type_bytes = self.type.encode('utf-8')
+        metadata = self._metadata_bytes()
+        header = self._header(type_bytes, metadata)
+        view = memoryview(buffer)
+        end = offset + HEADER_SIZE + len(type_bytes) + len(metadata) + len(self.payload)
+        if end > len(view):
+            raise FrameError("buffer too small for frame")
+        view[offset:offset + HEADER_SIZE] = header
+        position = offset + HEADER_SIZE
+        for chunk in (type_bytes, metadata, self.payload):
+            view[position:position + len(chunk)] = chunk
+            position += len(chunk)
+        return end
+
+    @classmethod
+    def from_buffer(cls, buffer: BytesLike, offset: int = 0) -> Tuple['StreamFrame', int]:
+        """
+        Decode the frame at ``offset`` without copying its payload.
+
+        Returns:
+            ``(frame, offset just past it)``
+
+        Raises:
+            FrameError: If the buffer does not hold one complete, valid frame there
+        """
+        view = buffer if isinstance(buffer, memoryview) else memoryview(buffer)
+        if len(view) - offset < HEADER_SIZE:
+            raise FrameError("truncated frame header")
+        length, version, encoding, type_len, message_id, timestamp_ns, meta_len = HEADER.unpack_from(view, offset)
+        end = offset + PREFIX_SIZE + length
+        if version != FRAME_VERSION:
+            raise FrameError(f"unsupported frame version {version}")
+        body = offset + HEADER_SIZE
+        if end > len(view) or body + type_len + meta_len > end:
+            raise FrameError("truncated frame body")
+        type_end = body + type_len
+        meta_end = type_end + meta_len
+        try:
+            message_type = str(view[body:type_end], 'utf-8')
+        except UnicodeDecodeError:
+            raise FrameError("frame type is not valid UTF-8") from None
+        frame = cls(message_id, timestamp_ns, message_type, encoding,
+                    view[meta_end:end], metadata_raw=view[type_end:meta_end])
+        frame._wire = view[offset:end]
+        return frame, end
+
+    @classmethod
+    def decode(cls, buffer: BytesLike) -> 'StreamFrame':
+        """Decode a buffer holding exactly one frame"""
+        frame, end = cls.from_buffer(buffer)
+        if end != len(buffer):
+            raise FrameError("trailing bytes after frame")
+        return frame
+
+    def __repr__(self) -> str:
+        return f"StreamFrame(id={self.id}, type={self.type!r}, encoding={self.encoding}, payload={len(self.payload)} bytes)"
+
+
+def encode_frames(frames: Iterable[StreamFrame]) -> bytes:
+    """Concatenate frames into one buffer, e.g. a batch for a single socket write"""
+    chunks: List[BytesLike] = []
+    append = chunks.append
+    pack = HEADER.pack
+    fixed = HEADER_SIZE - PREFIX_SIZE
+    for frame in frames:
+        if frame._wire is not None:
+            append(frame._wire)
+            continue
+        type_bytes = frame.type.encode('utf-8')
+        metadata = frame._metadata_bytes()
+        payload = frame.payload
+        append(pack(fixed + len(type_bytes) + len(metadata) + len(payload), FRAME_VERSION,
+                    frame.encoding, len(type_bytes), frame.id, frame.timestamp_ns, len(metadata)))
+        append(type_bytes)
+        if metadata:
+            append(metadata)
+        append(payload)
+    return b''.join(chunks)
+
+
+def _frame_size(prefix: BytesLike, max_frame_size: int) -> int:
+    """Total size of the frame whose first bytes are ``prefix``"""
+    length = int.from_bytes(prefix[:PREFIX_SIZE], 'little')
+    if length + PREFIX_SIZE > max_frame_size or length < HEADER_SIZE - PREFIX_SIZE:
+        raise FrameError(f"invalid frame length {length}")
+    return PREFIX_SIZE + length
+
+
+def _py_split(view: memoryview, offset: int, max_frame_size: int) -> Tuple[List[StreamFrame], int]:
+    """Decode the complete frames from ``offset``; returns them and where the rest starts"""
+    frames = []
+    total = len(view)
+    while total - offset >= PREFIX_SIZE:
+        end = offset + _frame_size(view[offset:offset + PREFIX_SIZE], max_frame_size)
+        if end > total:
+            break
+        frames.append(StreamFrame.from_buffer(view, offset)[0])
+        offset = end
+    return frames, offset
+
+
+def _native_split(view: memoryview, offset: int, max_frame_size: int) -> Tuple[List[StreamFrame], int]:
+    """``_py_split`` with the header parsing and slicing done by ``pyserv.core.frame_ring``"""
+    try:
+        fields, offset = _frame_ring.decode(view, offset, max_frame_size)
+    except ValueError as e:
+        raise FrameError(str(e)) from None
+    frames = []
+    new = object.__new__
+    for field in fields:
+        frame = new(StreamFrame)
+        (frame.id, frame.timestamp_ns, frame.type, frame.encoding,
+         frame._metadata_raw, frame.payload, frame._wire) = field
+        frame._metadata = None
+        frames.append(frame)
+    return frames, offset
+
+
+_split = _native_split if _frame_ring is not None else _py_split
+
+
+def iter_frames(buffer: BytesLike, max_frame_size: int = MAX_FRAME_SIZE) -> List[StreamFrame]:
+    """Decode a buffer made of whole frames"""
+    view = memoryview(buffer)
+    frames, offset = _split(view, 0, max_frame_size)
+    if offset != len(view):
+        raise FrameError("truncated frame")
+    return frames
+
+
+class FrameDecoder:
+    """
+    Split a byte stream (socket reads, MQTT payloads, ...) into frames.
+
+    Complete frames inside a chunk are decoded in place as views of that
+    chunk. Only a frame cut across reads is copied, once, into a holding
+    buffer until its remaining bytes arrive.
+    """
+
+    def __init__(self, max_frame_size: int = MAX_FRAME_SIZE):
+        self.max_frame_size = max_frame_size
+        self._pending = bytearray()
+        self._needed = 0
+
+    @property
+    def buffered(self) -> int:
+        return len(self._pending)
+
+    def feed(self, data: BytesLike) -> List[StreamFrame]:
+        """
+        Consume a chunk and return the frames it completes
+
+        Raises:
+            FrameError: On a malformed frame; the decoder is reset, since the
+                stream cannot be resynchronised past it
+        """
+        try:
+            return self._feed(data)
+        except FrameError:
+            self.reset()
+            raise
+
+    def _feed(self, data: BytesLike) -> List[StreamFrame]:
+        frames: List[StreamFrame] = []
+        view = memoryview(data)
+        offset = 0
+
+        if self._pending:
+            pending = self._pending
+            if not self._needed:
+                offset = min(PREFIX_SIZE - len(pending), len(view))
+                pending += view[:offset]
+                if len(pending) < PREFIX_SIZE:
+                    return frames
+                self._needed = _frame_size(pending, self.max_frame_size)
+            take = min(self._needed - len(pending), len(view) - offset)
+            pending += view[offset:offset + take]
+            offset += take
+            if len(pending) < self._needed:
+                return frames
+            # The completed frame owns its bytes; the holding buffer starts afresh
+            frames.append(StreamFrame.from_buffer(bytes(pending))[0])
+            self._pending = bytearray()
+            self._needed = 0
+
+        complete, offset = _split(view, offset, self.max_frame_size)
+        if frames:
+            frames.extend(complete)
+        else:
+            frames = complete
+        if offset < len(view):
+            self._pending = bytearray(view[offset:])
+            # Without the whole length prefix the frame is sized on the next feed
+            if len(self._pending) >= PREFIX_SIZE:
+                self._needed = _frame_size(self._pending, self.max_frame_size)
+        return frames
+
+    def reset(self) -> None:
+        self._pending = bytearray()
+        self._needed = 0
+
+
+__all__ = [
+    'StreamFrame', 'FrameDecoder', 'FrameError', 'SnowflakeIds', 'next_id',
+    'set_worker_id', 'encode_frames', 'iter_frames', 'HEADER', 'HEADER_SIZE', 'FRAME_VERSION',
+    'MAX_FRAME_SIZE', 'RAW', 'TEXT', 'JSON',
+]
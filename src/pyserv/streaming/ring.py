@@ -0,0 +1,257 @@
+"""
+Bounded rings for passing frames between streaming stages.
+
+``FrameRing`` is a fixed-capacity FIFO of object references, so stages hand
+each other encoded frames (and the memoryviews inside them) without copying.
+``pyserv.core.frame_ring`` provides it natively when built; the fallback
+below has the same API and semantics. Either way every operation is atomic
+under the GIL, so one ring may have several producers and consumers.
+
+``FrameChannel`` adds asyncio back-pressure on top: producers wait while the
+ring is full, consumers wait for the next batch, and both sides move items in
+batches so waking a stage is paid once per batch rather than per frame.
+"""
+
+import asyncio
+from collections import deque
+from typing import Any, Callable, Deque, Iterable, List, Optional, Tuple
+
+from pyserv.core import load_extension
+
+_frame_ring = load_extension("frame_ring")
+
+
+class PyFrameRing:
+    """Pure-Python ``FrameRing``; capacity rounds up to a power of two like the native ring"""
+
+    __slots__ = ('_items', 'capacity', 'pushed', 'rejected')
+
+    def __init__(self, capacity: int = 1024):
+        if not 1 <= capacity <= 1 << 30:
+            raise ValueError("capacity must be between 1 and 2**30")
+        self.capacity = 1 << (capacity - 1).bit_length()
+        self._items: Deque[Any] = deque()
+        self.pushed = 0
+        self.rejected = 0
+
+    def __len__(self) -> int:
+        return len(self._items)
+
+    @property
+    def free(self) -> int:
+        return self.capacity - len(self._items)
+
+    def push(self, item: Any) -> bool:
+        if len(self._items) >= self.capacity:
+            self.rejected += 1
+            return False
+        self._items.append(item)
+        self.pushed += 1
+        return True
+
+    def push_many(self, items: Iterable[Any]) -> int:
+        items = list(items)
+        accepted = min(len(items), self.capacity - len(self._items))
+        if accepted < len(items):
+            self.rejected += 1
+            items = items[:accepted]
+        self._items.extend(items)
+        self.pushed += accepted
+        return accepted
+
+    def pop(self, default: Any = None) -> Any:
+        return self._items.popleft() if self._items else default
+
+    def pop_many(self, max_items: int = -1) -> List[Any]:
+        items = self._items
+        if max_items < 0 or max_items >= len(items):
+            batch = list(items)
+            items.clear()
+            return batch
+        popleft = items.popleft
+        return [popleft() for _ in range(max_items)]
+
+    def clear(self) -> None:
+        self._items.clear()
+
+
+FrameRing = _frame_ring.Ring if _frame_ring is not None else PyFrameRing
+NATIVE_RING = _frame_ring is not None
+
+
+def _resolve(future: asyncio.Future) -> None:
+    if not future.done():
+        future.set_result(None)
+
+
+class FrameChannel:
+    """
+    Async, bounded hand-off between two streaming stages.
+
+    Non-blocking calls (``put_nowait``, ``put_many_nowait``, ``get_nowait``,
+    ``get_batch_nowait``) may be made from any thread; waiting calls belong to
+    an event loop and are woken thread-safely.
+    """
+
+    def __init__(self, capacity: int = 8192):
+        self.ring = FrameRing(capacity)
+        self._getters: Deque[Tuple[asyncio.AbstractEventLoop, asyncio.Future]] = deque()
+        self._putters: Deque[Tuple[asyncio.AbstractEventLoop, asyncio.Future]] = deque()
+        self.closed = False
+
+    def __len__(self) -> int:
+        return len(self.ring)
+
+    @property
+    def capacity(self) -> int:
+        return self.ring.capacity
+
+    @staticmethod
+    def _wake(waiters: Deque[Tuple[asyncio.AbstractEventLoop, asyncio.Future]]) -> None:
+        while waiters:
+            loop, future = waiters.popleft()
+            if future.done():
+                continue
+            try:
+                running = asyncio.get_running_loop()
+            except RuntimeError:
+                running = None
+            if loop is running:
+                future.set_result(None)
+                return
+            try:
+                loop.call_soon_threadsafe(_resolve, future)
+                return
+            except RuntimeError:
+                # Loop closed: try the next waiter
+                continue
+
+    async def _park(self, waiters: Deque[Tuple[asyncio.AbstractEventLoop, asyncio.Future]],
+                    ready: Callable[[], bool], timeout: Optional[float] = None) -> None:
+        """
+        Wait to be woken, for at most ``timeout`` seconds.
+
+        ``ready`` is checked again once the waiter is registered: a producer on
+        another thread may have pushed (and found no waiter to wake) between
+        the caller's last look at the ring and the registration.
+        """
+        loop = asyncio.get_running_loop()
+        waiter = (loop, loop.create_future())
+        waiters.append(waiter)
+        try:
+            if not ready():
+                await asyncio.wait_for(waiter[1], timeout)
+        except asyncio.TimeoutError:
+            pass
+        finally:
+            if not waiter[1].done():
+                waiter[1].cancel()
+                try:
+                    waiters.remove(waiter)
+                except ValueError:
+                    pass
+
+    def _has_items(self) -> bool:
+        return len(self.ring) > 0 or self.closed
+
+    def _has_space(self) -> bool:
+        return self.ring.free > 0 or self.closed
+
+    def _pushed(self) -> None:
+        if self._getters:
+            self._wake(self._getters)
+        # Pass a wakeup on to the next producer while space remains
+        if self._putters and self.ring.free:
+            self._wake(self._putters)
+
+    def _popped(self) -> None:
+        if self._putters:
+            self._wake(self._putters)
+        # Pass a wakeup on to the next consumer while items remain
+        if self._getters and len(self.ring):
+            self._wake(self._getters)
+
+    # Producers
+
+    def put_nowait(self, item: Any) -> bool:
+        """Queue one item; False if the channel is full"""
+        if not self.ring.push(item):
+            return False
+        self._pushed()
+        return True
+
+    def put_many_nowait(self, items: List[Any]) -> int:
+        """Queue as many items as fit, in order; returns how many were taken"""
+        accepted = self.ring.push_many(items)
+        if accepted:
+            self._pushed()
+        return accepted
+
+    async def put(self, item: Any) -> None:
+        """Queue one item, waiting while the channel is full"""
+        while not self.ring.push(item):
+            if self.closed:
+                raise RuntimeError("FrameChannel is closed")
+            await self._park(self._putters, self._has_space)
+        self._pushed()
+
+    async def put_many(self, items: List[Any]) -> None:
+        """Queue every item, waiting for space as needed"""
+        while items:
+            accepted = self.ring.push_many(items)
+            if accepted:
+                self._pushed()
+                items = items[accepted:]
+                if not items:
+                    return
+            if self.closed:
+                raise RuntimeError("FrameChannel is closed")
+            await self._park(self._putters, self._has_space)
+
+    # Consumers
+
+    def get_nowait(self, default: Any = None) -> Any:
+        item = self.ring.pop(default)
+        self._popped()
+        return item
+
+    def get_batch_nowait(self, max_items: int = -1) -> List[Any]:
+        batch = self.ring.pop_many(max_items)
+        if batch:
+            self._popped()
+        return batch
+
+    async def get_batch(self, max_items: int = -1, timeout: Optional[float] = None) -> List[Any]:
+        """
+        Take up to ``max_items`` queued items, waiting for the first one.
+
+        Returns an empty list only on timeout, or once the channel is closed
+        and drained; a wakeup whose items another consumer took waits again.
+        """
+        loop = asyncio.get_running_loop()
+        deadline = None if timeout is None else loop.time() + timeout
+        while True:
+            batch = self.ring.pop_many(max_items)
+            if batch:
+                self._popped()
+                return batch
+            if self.closed:
+                return batch
+            remaining = None if deadline is None else deadline - loop.time()
+            if remaining is not None and remaining <= 0:
+                return batch
+            await self._park(self._getters, self._has_items, remaining)
+
+    def close(self) -> None:
+        """Stop accepting waits; consumers drain what is queued, then get empty batches"""
+        self.closed = True
+        for waiters in (self._getters, self._putters):
+            while waiters:
+                loop, future = waiters.popleft()
+                try:
+                    loop.call_soon_threadsafe(_resolve, future)
+                except RuntimeError:
+                    pass
+
+
+__all__ = ['FrameRing', 'PyFrameRing', 'FrameChannel', 'NATIVE_RING']
@@ -6,6 +6,7 @@ A high-performance, pure Python template rendering system.
 from .engine import *
 
 __all__ = [
+    'AbstractTemplateEngine',
     'TemplateConfig',
     'TemplateError',
     'TemplateSyntaxError',
@@ -5,7 +5,8 @@ A high-performance, pure Python template rendering system.
 
 import re
 import asyncio
-from typing import Dict, Any, Optional, Union, List
+import string
+from typing import Dict, Any, Optional, Tuple, Union, List, Iterable, Iterator, AsyncGenerator
 from pathlib import Path
 import hashlib
 import pickle
@@ -13,11 +14,42 @@ from dataclasses import dataclass
 from abc import ABC, abstractmethod
 
 
+# Characters gathered into one chunk by streaming renders
+STREAM_CHUNK_SIZE = 16 * 1024
+
+_HEAD_END = '</head>'
+
+
+async def encode_stream(fragments: Iterable[str], encoding: str = 'utf-8',
+                        chunk_size: int = STREAM_CHUNK_SIZE) -> AsyncGenerator[bytes, None]:
+    """Group rendered fragments into encoded chunks, flushing early once </head> is out"""
+    buffer: List[str] = []
+    size = 0
+    for fragment in fragments:
+        head_end = fragment.find(_HEAD_END)
+        if head_end != -1:
+            head_end += len(_HEAD_END)
+            buffer.append(fragment[:head_end])
+            yield ''.join(buffer).encode(encoding)
+            buffer.clear()
+            fragment = fragment[head_end:]
+            size = 0
+        buffer.append(fragment)
+        size += len(fragment)
+        if size >= chunk_size:
+            yield ''.join(buffer).encode(encoding)
+            buffer.clear()
+            size = 0
+    if buffer:
+        yield ''.join(buffer).encode(encoding)
+
+
 @dataclass
 class TemplateConfig:
     """Configuration for template engine"""
     cache_enabled: bool = True
     cache_dir: Optional[Path] = None
+    template_dir: Optional[Path] = None
     auto_escape: bool = True
     trim_blocks: bool = True
     lstrip_blocks: bool = False
@@ -42,6 +74,7 @@ class Template:
         self.name = name
         self.config = config or TemplateConfig()
         self._compiled = None
+        self._pieces = None
         self._compile()
 
     def _compile(self):
@@ -70,13 +103,58 @@ class Template:
         except ValueError as e:
             raise TemplateError(f"Template rendering error: {e}")
 
+    def generate(self, **context) -> Iterator[str]:
+        """Render lazily, yielding literal text and each formatted field in turn"""
+        formatter = _FORMATTER
+        if self._pieces is None:
+            self._pieces = list(formatter.parse(self._compiled))
+        try:
+            for literal, field, spec, conversion in self._pieces:
+                if literal:
+                    yield literal
+                if field is not None:
+                    value, _ = formatter.get_field(field, (), context)
+                    value = formatter.convert_field(value, conversion)
+                    yield formatter.format_field(value, formatter.vformat(spec, (), context) if spec else '')
+        except KeyError as e:
+            raise TemplateError(f"Undefined variable: {e}")
+        except ValueError as e:
+            raise TemplateError(f"Template rendering error: {e}")
+
+
+_FORMATTER = string.Formatter()
+
+
+class AbstractTemplateEngine(ABC):
+    """
+    Base for the file-based template languages in ``templating.languages``.
+
+    Holds what every language shares: the template directory and extra
+    search paths, custom loaders and tags, and the ``debug`` and
+    ``enable_i18n`` switches (both taken from ``options``).
+    """
+
+    def __init__(self, template_dir: Union[str, Path], **options):
+        self.template_dir = Path(template_dir)
+        self.options = options
+        self.debug = options.get('debug', False)
+        self.enable_i18n = options.get('enable_i18n', False)
+        self.custom_tags: Dict[str, Any] = {}
+        self.loaders: List[Any] = []
+        self.template_search_paths: List[Path] = [self.template_dir]
+
+    @abstractmethod
+    async def render(self, template_name: str, context: Dict[str, Any]) -> str:
+        """Render the template ``template_name`` with ``context``"""
+        pass
+
 
 class TemplateEngine:
     """Modern Python template engine"""
 
     def __init__(self, config: Optional[TemplateConfig] = None):
         self.config = config or TemplateConfig()
-        self._cache: Dict[str, Template] = {}
+        self._cache: Dict[str, Tuple[int, Template]] = {}  # path -> (mtime_ns, template)
         self._setup_cache()
 
     def _setup_cache(self):
@@ -120,11 +198,18 @@ class TemplateEngine:
         return Template(source, name, self.config)
 
     def from_file(self, path: Union[str, Path]) -> Template:
-        """Load template from file with caching"""
+        """Load template from file with caching (relative paths also resolve under ``template_dir``)"""
         path = Path(path)
+        if not path.exists() and self.config.template_dir and not path.is_absolute():
+            path = Path(self.config.template_dir) / path
         if not path.exists():
             raise FileNotFoundError(f"Template file not found: {path}")
 
+        mtime = path.stat().st_mtime_ns
+        cached = self._cache.get(str(path))
+        if cached is not None and cached[0] == mtime:
+            return cached[1]
+
         cache_key = self._get_cache_key(path)
         template = self._load_from_cache(cache_key)
 
@@ -133,8 +218,28 @@ class TemplateEngine:
             template = Template(source, str(path), self.config)
             self._save_to_cache(cache_key, template)
 
+        self._cache[str(path)] = (mtime, template)
         return template
 
+    def preload(self) -> int:
+        """
+        Compile every file under ``template_dir`` into the memory cache
+        (e.g. in a pre-fork master, so workers share the compiled forms).
+        Files that fail to load are skipped. Returns the number compiled.
+        """
+        if not self.config.template_dir:
+            return 0
+        compiled = 0
+        for template_path in sorted(Path(self.config.template_dir).rglob('*')):
+            if not template_path.is_file():
+                continue
+            try:
+                self.from_file(template_path)
+                compiled += 1
+            except (OSError, UnicodeDecodeError, TemplateError):
+                pass
+        return compiled
+
     def render_string(self, source: str, **context) -> str:
         """Render template string"""
         template = self.from_string(source)
@@ -145,6 +250,13 @@ class TemplateEngine:
         template = self.from_file(path)
         return template.render(**context)
 
+    async def render_file_stream(self, path: Union[str, Path], encoding: str = 'utf-8',
+                                 **context) -> AsyncGenerator[bytes, None]:
+        """Render template file as encoded chunks, for ``Response.stream``"""
+        template = self.from_file(path)
+        async for chunk in encode_stream(template.generate(**context), encoding):
+            yield chunk
+
 
 class JinjaTemplateEngine(TemplateEngine):
     """Jinja2-based template engine for complex templates"""
@@ -184,6 +296,9 @@ class JinjaTemplate:
     def render(self, **context) -> str:
         return self.template.render(**context)
 
+    def generate(self, **context) -> Iterator[str]:
+        return self.template.generate(**context)
+
 
 class QuantumTemplateEngine(TemplateEngine):
     """Advanced template engine with quantum-inspired optimizations"""
@@ -211,6 +326,7 @@ class QuantumTemplate(Template):
         self.config = config
         self._get_pattern = pattern_getter
         self._compiled = None
+        self._pieces = None
         self._compile()
 
     def _compile(self):
@@ -2,7 +2,7 @@ import re
 import os
 import hashlib
 import time
-from typing import Callable, Dict, Any, List, Optional, Union, Tuple
+from typing import AsyncGenerator, Callable, Dict, Any, List, Optional, Union, Tuple
 from pathlib import Path
 from datetime import datetime
 import math
@@ -10,613 +10,296 @@ import json
 import functools
 
 from pyserv.templating.engine import AbstractTemplateEngine
-from pyserv.security_middleware import get_security_middleware
-
-class TemplateError(Exception):
-    """Base exception for template errors"""
-    def __init__(self, message: str, template_name: str = None, line_number: int = None):
-        self.message = message
-        self.template_name = template_name
-        self.line_number = line_number
-        super().__init__(f"{message}" + (f" in {template_name}:{line_number}" if template_name and line_number else ""))
+from pyserv.templating.languages.lean_compiler import (
+    CompiledTemplate, Markup, TemplateCompiler, TemplateError, TemplateRuntimeError,
+    TemplateSyntaxError, escape, safe_format,
+)
+
+
+@functools.lru_cache(maxsize=None)
+def _security_getter() -> Optional[Callable]:
+    # Imported on first render: pyserv.auth pulls in the user model and JWT
+    # stack, which templates should not need in order to import
+    try:
+        from pyserv.auth.security_middleware import get_security_middleware
+    except Exception:
+        return None
+    return get_security_middleware
+
+
+def _security_middleware():
+    """The output sanitizer, or None where it cannot be set up"""
+    getter = _security_getter()
+    if getter is None:
+        return None
+    try:
+        return getter()
+    except Exception:
+        return None
+
+
+# Elements the output sanitizer removes whole, open tag through close tag
+_PAIRED_UNSAFE_TAG_RE = re.compile(r'<(script|iframe|object|embed|form)', re.IGNORECASE)
+_CLOSING_TAG_RES = {name: re.compile(f'</{name}>', re.IGNORECASE)
+                    for name in ('script', 'iframe', 'object', 'embed', 'form')}
+
+
+class _SanitizeCursor:
+    """
+    How much of buffered streaming output can be sanitized on its own.
+
+    The sanitizer matches whole tags and unsafe elements, and its attribute
+    patterns never reach past a ``>``, so output can be cut right after any
+    complete tag that is not inside an unsafe element. Each call scans only
+    the text appended since the previous one.
+    """
+
+    __slots__ = ('pos', 'cut', 'closing')
+
+    def __init__(self):
+        self.pos = 0  # scanning resumes here
+        self.cut = 0  # end of the last complete tag outside an unsafe element
+        self.closing: Optional[re.Pattern] = None  # close tag of the unsafe element we are inside
+
+    def advance(self, text: str) -> int:
+        """The cut point in ``text``, the buffered output"""
+        pos = self.pos
+        while True:
+            if self.closing is not None:
+                match = self.closing.search(text, pos)
+                if match is None:
+                    # The close tag may be arriving in pieces
+                    pos = max(pos, len(text) - len(self.closing.pattern) + 1)
+                    break
+                pos = self.cut = match.end()
+                self.closing = None
+                continue
+            start = text.find('<', pos)
+            if start < 0:
+                pos = len(text)
+                break
+            end = text.find('>', start + 1)
+            if end < 0:
+                pos = start
+                break
+            pos = end + 1
+            unsafe = _PAIRED_UNSAFE_TAG_RE.match(text, start)
+            if unsafe is not None and text[end - 1] != '/':
+                self.closing = _CLOSING_TAG_RES[unsafe.group(1).lower()]
+            else:
+                self.cut = pos
+        self.pos = pos
+        return self.cut
 
-class TemplateSyntaxError(TemplateError):
-    """Syntax error in template"""
-    pass
+    def consume(self, count: int) -> None:
+        """``count`` characters were flushed from the front of the buffer"""
+        self.pos -= count
+        self.cut -= count
 
-class TemplateRuntimeError(TemplateError):
-    """Runtime error during template rendering"""
-    pass
 
 class LeanTemplateEngine(AbstractTemplateEngine):
-    """Enhanced lightweight template engine with advanced features"""
+    """Enhanced lightweight template engine with advanced features
+
+    Templates are compiled once to Python code objects (see lean_compiler) and
+    cached per file. A cached template is rebuilt when it, its layouts or its
+    includes change on disk. Set ``cache_dir`` to also keep compiled templates
+    across processes.
+    """
 
     def __init__(self, template_dir: Path, **options):
         super().__init__(template_dir, **options)
-        self.cache = {}
+        self.cache: Dict[Path, CompiledTemplate] = {}
+        self.string_cache: Dict[str, CompiledTemplate] = {}
         self.macro_cache = {}
         self.filter_cache = {}
 
-        # Enhanced regex patterns
-        self.patterns = {
-            'variable': r'\{\{([^}]+)\}\}',
-            'block': r'\{%\s*(\w+)\s*(.*?)\s*%\}',
-            'endblock': r'\{%\s*end(\w+)\s*%\}',
-            'comment': r'\{\#.*?\#\}',
-            'include': r'\{%\s*include\s+["\'](.*?)["\']\s*%\}',
-            'extends': r'\{%\s*extends\s+["\'](.*?)["\']\s*%\}',
-            'block_definition': r'\{%\s*block\s+(\w+)\s*%\}',
-            'macro': r'\{%\s*macro\s+(\w+)\((.*?)\)\s*%\}',
-            'endmacro': r'\{%\s*endmacro\s*%\}',
-            'call': r'\{%\s*call\s+(\w+)\((.*?)\)\s*%\}',
-            'filter': r'\{\{\s*(.*?)\s*\|\s*(\w+)(?::(.*?))?\s*\}\}',
-            # New patterns for advanced features
-            'set': r'\{%\s*set\s+(\w+)\s*=\s*(.*?)\s*%\}',
-            'if': r'\{%\s*if\s+(.*?)\s*%\}',
-            'elif': r'\{%\s*elif\s+(.*?)\s*%\}',
-            'else': r'\{%\s*else\s*%\}',
-            'endif': r'\{%\s*endif\s*%\}',
-            'for': r'\{%\s*for\s+(\w+(?:\s*,\s*\w+)?)\s+in\s+(.*?)(?:\s+if\s+(.*?))?\s*%\}',
-            'endfor': r'\{%\s*endfor\s*%\}',
-            'while': r'\{%\s*while\s+(.*?)\s*%\}',
-            'endwhile': r'\{%\s*endwhile\s*%\}',
-            'break': r'\{%\s*break\s*%\}',
-            'continue': r'\{%\s*continue\s*%\}',
-            'raw': r'\{%\s*raw\s*%\}',
-            'endraw': r'\{%\s*endraw\s*%\}',
-            'load': r'\{%\s*load\s+["\'](.*?)["\']\s*%\}',
-            'with': r'\{%\s*with\s+(.*?)\s*%\}',
-            'endwith': r'\{%\s*endwith\s*%\}',
-            'spaceless': r'\{%\s*spaceless\s*%\}',
-            'endspaceless': r'\{%\s*endspaceless\s*%\}',
-            'autoescape': r'\{%\s*autoescape\s+(\w+)\s*%\}',
-            'endautoescape': r'\{%\s*endautoescape\s*%\}',
-        }
-
         # Configuration options
         self.enable_cache = options.get('enable_cache', True)
         self.autoescape = options.get('autoescape', True)
-        
+        self.auto_reload = options.get('auto_reload', True)
+        self.string_cache_size = options.get('string_cache_size', 256)
+        cache_dir = options.get('cache_dir')
+        self.cache_dir = Path(cache_dir) if cache_dir else None
+        if self.cache_dir:
+            self.cache_dir.mkdir(parents=True, exist_ok=True)
+        self.compiler = TemplateCompiler(
+            trim_blocks=options.get('trim_blocks', True),
+            lstrip_blocks=options.get('lstrip_blocks', True),
+            autoescape=self.autoescape,
+        )
+
         # Built-in filters
         self.filters = self._initialize_filters()
-        
-        # Macro storage
-        self.macros = {}
-        self.macro_stack = []
 
-        # Template inheritance stack
-        self.inheritance_stack = []
+        # Python callables usable with {% call name(...) %}
+        self.macros = {}
 
         # Performance monitoring
         self.render_stats = {
             'total_renders': 0,
             'cache_hits': 0,
+            'compilations': 0,
             'avg_render_time': 0.0,
             'errors': 0
         }
-    
+
     async def render(self, template_name: str, context: Dict[str, Any]) -> str:
         """Render a template file"""
         template_path = self.template_dir / template_name
-        
+
         if not template_path.exists():
             raise FileNotFoundError(f"Template not found: {template_path}")
-        
-        # Get template content (from cache or file)
-        if self.enable_cache and template_path in self.cache:
-            template_content = self.cache[template_path]
-        else:
-            with open(template_path, 'r', encoding='utf-8') as f:
-                template_content = f.read()
-            if self.enable_cache:
-                self.cache[template_path] = template_content
-        
-        # Check for template inheritance
-        extends_match = re.search(self.patterns['extends'], template_content)
-        if extends_match:
-            return await self._render_with_inheritance(template_content, context, template_path.parent)
-        
-        return await self._render_content(template_content, context, template_path.parent)
-    
+
+        return self._render_compiled(self.get_compiled(template_path), context)
+
     async def render_string(self, template_string: str, context: Dict[str, Any]) -> str:
         """Render a template string"""
-        return await self._render_content(template_string, context, self.template_dir)
-    
-    async def _render_with_inheritance(self, content: str, context: Dict[str, Any], 
-                                     base_dir: Path) -> str:
-        """Render template with inheritance support"""
-        extends_match = re.search(self.patterns['extends'], content)
-        if not extends_match:
-            return await self._render_content(content, context, base_dir)
-        
-        parent_template = extends_match.group(1)
-        parent_path = base_dir / parent_template
-        
-        if not parent_path.exists():
-            return await self._render_content(content, context, base_dir)
-        
-        # Load parent template
-        with open(parent_path, 'r', encoding='utf-8') as f:
-            parent_content = f.read()
-        
-        # Extract blocks from child template
-        child_blocks = self._extract_blocks(content)
-        
-        # Replace blocks in parent template with child blocks
-        def replace_blocks(match):
-            block_name = match.group(1)
-            return child_blocks.get(block_name, match.group(0))
-        
-        # Process parent template with child blocks
-        parent_content = re.sub(
-            self.patterns['block_definition'],
-            replace_blocks,
-            parent_content
-        )
-        
-        return await self._render_content(parent_content, context, parent_path.parent)
-    
-    def _extract_blocks(self, content: str) -> Dict[str, str]:
-        """Extract blocks from template content"""
-        blocks = {}
-        lines = content.split('\n')
-        i = 0
-        
-        while i < len(lines):
-            line = lines[i]
-            block_match = re.match(self.patterns['block_definition'], line)
-            
-            if block_match:
-                block_name = block_match.group(1)
-                block_content = []
-                i += 1
-                
-                # Find endblock
-                while i < len(lines):
-                    current_line = lines[i]
-                    endblock_match = re.search(r'\{%\s*endblock\s*%\}', current_line)
-                    
-                    if endblock_match:
-                        break
-                    
-                    block_content.append(current_line)
-                    i += 1
-                
-                blocks[block_name] = '\n'.join(block_content)
-            
-            i += 1
-        
-        return blocks
-    
-    async def _render_content(self, content: str, context: Dict[str, Any],
-                            base_dir: Path) -> str:
-        """Render template content with context"""
-        # Process macros first
-        content = await self._process_macros(content, context, base_dir)
-
-        # Process includes
-        content = await self._process_includes(content, context, base_dir)
-
-        # Remove comments
-        content = re.sub(self.patterns['comment'], '', content)
-
-        # Process blocks
-        content = await self._process_blocks(content, context)
-
-        # Process filters
-        content = await self._process_filters(content, context)
-
-        # Replace variables
-        content = await self._replace_variables(content, context)
+        compiled = self.string_cache.get(template_string) if self.enable_cache else None
+        if compiled is None or (self.auto_reload and compiled.dependencies and compiled.is_stale()):
+            compiled = self.compiler.compile_string(template_string, self.template_dir)
+            self.render_stats['compilations'] += 1
+            if self.enable_cache:
+                if len(self.string_cache) >= self.string_cache_size:
+                    self.string_cache.pop(next(iter(self.string_cache)))
+                self.string_cache[template_string] = compiled
+        else:
+            self.render_stats['cache_hits'] += 1
+        return self._render_compiled(compiled, context)
+
+    async def render_stream(self, template_name: str, context: Dict[str, Any],
+                            encoding: str = 'utf-8') -> AsyncGenerator[bytes, None]:
+        """
+        Render a template file as encoded chunks, for ``Response.stream``
+
+        Chunks end after ``</head>``, at block boundaries and every few
+        hundred fragments inside loops, so the client starts receiving the
+        page before it is fully rendered.
+        """
+        template_path = self.template_dir / template_name
 
-        # Apply security sanitization if enabled
-        try:
-            security_middleware = get_security_middleware()
-            content = security_middleware.sanitize_template_output(content)
-        except Exception:
-            # If security middleware is not available, continue without sanitization
-            pass
+        if not template_path.exists():
+            raise FileNotFoundError(f"Template not found: {template_path}")
 
-        return content
-    
-    async def _process_macros(self, content: str, context: Dict[str, Any], 
-                            base_dir: Path) -> str:
-        """Process macro definitions and calls"""
-        lines = content.split('\n')
-        output_lines = []
-        i = 0
-        
-        # First pass: collect macro definitions
-        while i < len(lines):
-            line = lines[i]
-            macro_match = re.match(self.patterns['macro'], line)
-            
-            if macro_match:
-                macro_name = macro_match.group(1)
-                macro_params = [p.strip() for p in macro_match.group(2).split(',')] if macro_match.group(2) else []
-                
-                # Find endmacro
-                macro_content = []
-                i += 1
-                
-                while i < len(lines):
-                    current_line = lines[i]
-                    endmacro_match = re.match(self.patterns['endmacro'], current_line)
-                    
-                    if endmacro_match:
-                        break
-                    
-                    macro_content.append(current_line)
-                    i += 1
-                
-                # Store macro
-                self.macros[macro_name] = {
-                    'params': macro_params,
-                    'content': '\n'.join(macro_content)
-                }
-            
-            i += 1
-        
-        # Second pass: process macro calls
-        content = '\n'.join(lines)
-        
-        def process_macro_call(match):
-            macro_name = match.group(1)
-            macro_args = [arg.strip() for arg in match.group(2).split(',')] if match.group(2) else []
-            
-            if macro_name not in self.macros:
-                return f"<!-- Macro {macro_name} not found -->"
-            
-            macro = self.macros[macro_name]
-            macro_content = macro['content']
-            macro_params = macro['params']
-            
-            # Create macro context
-            macro_context = context.copy()
-            for param, arg in zip(macro_params, macro_args):
-                macro_context[param] = self._evaluate_expression(arg, context)
-            
-            # Render macro content
-            return self._render_content_sync(macro_content, macro_context, base_dir)
-        
-        return re.sub(self.patterns['call'], process_macro_call, content)
-    
-    def _render_content_sync(self, content: str, context: Dict[str, Any], 
-                           base_dir: Path) -> str:
-        """Synchronous version of _render_content for use in macros"""
-        # This is a simplified synchronous version for use in macro processing
-        # Remove comments
-        content = re.sub(self.patterns['comment'], '', content)
-        
-        # Replace variables
-        content = self._replace_variables_sync(content, context)
-        
-        return content
-    
-    async def _process_includes(self, content: str, context: Dict[str, Any], 
-                              base_dir: Path) -> str:
-        """Process include directives"""
-        def process_include(match):
-            include_file = match.group(1)
-            include_path = base_dir / include_file
-            
-            if not include_path.exists():
-                return f"<!-- Include not found: {include_file} -->"
-            
-            # Read included template
-            with open(include_path, 'r', encoding='utf-8') as f:
-                included_content = f.read()
-            
-            # Recursively process the included template
-            included_rendered = self._render_content_sync(included_content, context, include_path.parent)
-            return included_rendered
-        
-        return re.sub(self.patterns['include'], process_include, content)
-    
-    async def _process_filters(self, content: str, context: Dict[str, Any]) -> str:
-        """Process filter expressions"""
-        def process_filter(match):
-            expression = match.group(1).strip()
-            filter_name = match.group(2)
-            filter_args = match.group(3).split(':') if match.group(3) else []
-            
-            try:
-                value = self._evaluate_expression(expression, context)
-                
-                if filter_name in self.filters:
-                    # Apply filter with arguments
-                    if filter_args:
-                        result = value
-                        for arg in filter_args:
-                            result = self.filters[filter_name](result, *[a.strip() for a in arg.split(',')])
-                        return str(result)
-                    else:
-                        return str(self.filters[filter_name](value))
-                else:
-                    return f"{{{{ {expression} | {filter_name} }}}}"  # Unknown filter
-            except Exception as e:
-                return f"{{{{ {expression} | {filter_name} }}}}"  # Filter error
-        
-        return re.sub(self.patterns['filter'], process_filter, content)
-    
-    async def _replace_variables(self, content: str, context: Dict[str, Any]) -> str:
-        """Replace variables in template content"""
-        def replace_match(match):
-            var_name = match.group(1).strip()
-            try:
-                value = self._get_nested_value(context, var_name)
-                if value is None:
-                    return ''
-                if self.autoescape and isinstance(value, str):
-                    value = self._escape_filter(value)
-                return str(value)
-            except (KeyError, AttributeError):
-                return f'{{{{ {var_name} }}}}'  # Keep original if not found
-        
-        return re.sub(self.patterns['variable'], replace_match, content)
-    
-    def _replace_variables_sync(self, content: str, context: Dict[str, Any]) -> str:
-        """Synchronous version of variable replacement"""
-        def replace_match(match):
-            var_name = match.group(1).strip()
-            try:
-                value = self._get_nested_value(context, var_name)
-                if value is None:
-                    return ''
-                if self.autoescape and isinstance(value, str):
-                    value = self._escape_filter(value)
-                return str(value)
-            except (KeyError, AttributeError):
-                return f'{{{{ {var_name} }}}}'  # Keep original if not found
-        
-        return re.sub(self.patterns['variable'], replace_match, content)
-    
-    async def _process_blocks(self, content: str, context: Dict[str, Any]) -> str:
-        """Process template blocks (if, for, etc.)"""
-        lines = content.split('\n')
-        output_lines = []
-        i = 0
-        
-        while i < len(lines):
-            line = lines[i]
-            
-            # Check for if block
-            if_match = re.match(r'\{%\s*if\s+(.*?)\s*%\}', line)
-            if if_match:
-                condition = if_match.group(1)
-                condition_result = self._evaluate_condition(condition, context)
-                
-                # Find endif
-                endif_index = i
-                while endif_index < len(lines) and not re.search(r'\{%\s*endif\s*%\}', lines[endif_index]):
-                    endif_index += 1
-                
-                if condition_result:
-                    # Include the content between if and endif
-                    block_content = '\n'.join(lines[i+1:endif_index])
-                    rendered_block = await self._render_content(block_content, context, self.template_dir)
-                    output_lines.append(rendered_block)
-                
-                i = endif_index + 1
-                continue
-            
-            # Check for elif block
-            elif_match = re.match(r'\{%\s*elif\s+(.*?)\s*%\}', line)
-            if elif_match:
-                # elif should be inside an if block, skip for now
-                output_lines.append(line)
-                i += 1
-                continue
-            
-            # Check for else block
-            else_match = re.match(r'\{%\s*else\s*%\}', line)
-            if else_match:
-                # else should be inside an if block, skip for now
-                output_lines.append(line)
-                i += 1
-                continue
-            
-            # Check for for loop
-            for_match = re.match(r'\{%\s*for\s+(\w+)\s+in\s+(.*?)\s*%\}', line)
-            if for_match:
-                var_name = for_match.group(1)
-                iterable_expr = for_match.group(2)
-                
-                # Find endfor
-                endfor_index = i
-                while endfor_index < len(lines) and not re.search(r'\{%\s*endfor\s*%\}', lines[endfor_index]):
-                    endfor_index += 1
-                
-                # Get iterable
-                iterable = self._evaluate_expression(iterable_expr, context)
-                
-                # Process loop content for each item
-                loop_content = '\n'.join(lines[i+1:endfor_index])
-                loop_output = []
-                
-                for item in iterable or []:
-                    loop_context = context.copy()
-                    loop_context[var_name] = item
-                    # Add loop variables
-                    loop_context['loop'] = {
-                        'index': loop_output.__len__() + 1,
-                        'index0': loop_output.__len__(),
-                        'first': loop_output.__len__() == 0,
-                        'last': loop_output.__len__() == len(iterable) - 1,
-                        'length': len(iterable)
-                    }
-                    rendered_content = await self._render_content(loop_content, loop_context, self.template_dir)
-                    loop_output.append(rendered_content)
-                
-                output_lines.append('\n'.join(loop_output))
-                i = endfor_index + 1
-                continue
-            
-            # Check for set block
-            set_match = re.match(r'\{%\s*set\s+(\w+)\s*=\s*(.*?)\s*%\}', line)
-            if set_match:
-                var_name = set_match.group(1)
-                expression = set_match.group(2)
-                value = self._evaluate_expression(expression, context)
-                context[var_name] = value
-                i += 1
-                continue
-            
-            # Check for raw block (no processing)
-            raw_match = re.match(r'\{%\s*raw\s*%\}', line)
-            if raw_match:
-                # Find endraw
-                endraw_index = i
-                while endraw_index < len(lines) and not re.search(r'\{%\s*endraw\s*%\}', lines[endraw_index]):
-                    endraw_index += 1
-                
-                # Include raw content without processing
-                raw_content = '\n'.join(lines[i+1:endraw_index])
-                output_lines.append(raw_content)
-                i = endraw_index + 1
-                continue
-            
-            output_lines.append(line)
-            i += 1
-        
-        return '\n'.join(output_lines)
-    
-    def _get_nested_value(self, context: Dict[str, Any], path: str) -> Any:
-        """Get nested value from context using dot notation"""
-        parts = path.split('.')
-        value = context
-        
-        for part in parts:
-            part = part.strip()
-            if isinstance(value, dict) and part in value:
-                value = value[part]
-            elif hasattr(value, part):
-                value = getattr(value, part)
-            else:
-                # Try to access via getitem if it's a list or similar
+        async for chunk in self._stream_compiled(self.get_compiled(template_path), context, encoding):
+            yield chunk
+
+    def get_compiled(self, template_path: Path) -> CompiledTemplate:
+        """Compiled form of a template file, from memory, disk cache, or a fresh compile"""
+        compiled = self.cache.get(template_path) if self.enable_cache else None
+        if compiled is not None and not (self.auto_reload and compiled.is_stale()):
+            self.render_stats['cache_hits'] += 1
+            return compiled
+
+        disk_path = self._disk_cache_path(template_path) if self.enable_cache else None
+        compiled = CompiledTemplate.load(disk_path) if disk_path and disk_path.exists() else None
+        if compiled is None or compiled.is_stale():
+            compiled = self.compiler.compile_file(template_path)
+            self.render_stats['compilations'] += 1
+            if disk_path:
                 try:
-                    if hasattr(value, '__getitem__'):
-                        # Try integer index
-                        try:
-                            index = int(part)
-                            value = value[index]
-                            continue
-                        except (ValueError, IndexError):
-                            pass
-                except (KeyError, AttributeError, TypeError):
-                    raise KeyError(f"Key {part} not found in context")
-        
-        return value
-    
-    def _evaluate_condition(self, condition: str, context: Dict[str, Any]) -> bool:
-        """Evaluate a condition expression"""
-        # Remove extra whitespace
-        condition = condition.strip()
-        
-        # Check for common operators
-        operators = ['==', '!=', '>=', '<=', '>', '<', ' in ', ' not in ']
-        
-        for op in operators:
-            if op in condition:
-                left, right = condition.split(op, 1)
-                left_val = self._get_nested_value(context, left.strip())
-                right_val = self._get_nested_value(context, right.strip())
-                
-                # Handle different types
-                try:
-                    # Try to convert to same type for comparison
-                    if isinstance(left_val, str) and isinstance(right_val, (int, float)):
-                        right_val = str(right_val)
-                    elif isinstance(left_val, (int, float)) and isinstance(right_val, str):
-                        left_val = str(left_val)
-                except (ValueError, TypeError):
-                    pass
-                
-                if op == '==':
-                    return left_val == right_val
-                elif op == '!=':
-                    return left_val != right_val
-                elif op == '>=':
-                    return left_val >= right_val
-                elif op == '<=':
-                    return left_val <= right_val
-                elif op == '>':
-                    return left_val > right_val
-                elif op == '<':
-                    return left_val < right_val
-                elif op == ' in ':
-                    return left_val in right_val
-                elif op == ' not in ':
-                    return left_val not in right_val
-        
-        # If no operator found, treat as truthy check
-        value = self._get_nested_value(context, condition)
-        return bool(value)
-    
-    def _evaluate_expression(self, expression: str, context: Dict[str, Any]) -> Any:
-        """Evaluate an expression"""
-        expression = expression.strip()
-        
-        # Handle string literals
-        if expression.startswith('"') and expression.endswith('"'):
-            return expression[1:-1]
-        elif expression.startswith("'") and expression.endswith("'"):
-            return expression[1:-1]
-        
-        # Handle numbers
-        try:
-            if '.' in expression:
-                return float(expression)
-            else:
-                return int(expression)
-        except ValueError:
-            pass
-        
-        # Handle boolean literals
-        if expression.lower() == 'true':
-            return True
-        elif expression.lower() == 'false':
-            return False
-        elif expression.lower() == 'none' or expression.lower() == 'null':
+                    compiled.dump(disk_path)
+                except OSError as e:
+                    if self.debug:
+                        print(f"Failed to persist compiled template {template_path}: {e}")
+
+        if self.enable_cache:
+            self.cache[template_path] = compiled
+        return compiled
+
+    def _disk_cache_path(self, template_path: Path) -> Optional[Path]:
+        """Disk cache file for a template; the key covers options that change generated code"""
+        if not self.cache_dir:
             return None
-        
-        # Handle list literals
-        if expression.startswith('[') and expression.endswith(']'):
-            items = expression[1:-1].split(',')
-            return [self._evaluate_expression(item.strip(), context) for item in items]
-        
-        # Handle dict literals
-        if expression.startswith('{') and expression.endswith('}'):
-            items = expression[1:-1].split(',')
-            result = {}
-            for item in items:
-                if ':' in item:
-                    key, value = item.split(':', 1)
-                    result[key.strip()] = self._evaluate_expression(value.strip(), context)
-            return result
-        
-        # Default to variable lookup
-        return self._get_nested_value(context, expression)
-    
+        compiler = self.compiler
+        key = f"{template_path.resolve()}|{compiler.trim_blocks}|{compiler.lstrip_blocks}|{compiler.autoescape}"
+        return self.cache_dir / f"{hashlib.sha256(key.encode()).hexdigest()[:32]}.leanc"
+
+    async def _stream_compiled(self, compiled: CompiledTemplate, context: Dict[str, Any],
+                               encoding: str) -> AsyncGenerator[bytes, None]:
+        """
+        Run a compiled template lazily, sanitizing and encoding each flushed piece
+
+        Output that could be part of an element or attribute continuing in the
+        next fragment is carried over, so the sanitizer never sees half of it.
+        """
+        security_middleware = _security_middleware()
+
+        def sanitize(text: str) -> str:
+            try:
+                return security_middleware.sanitize_template_output(text)
+            except Exception:
+                return text
+
+        started = time.perf_counter()
+        pending = ''
+        cursor = _SanitizeCursor()
+        try:
+            for fragment in compiled.generate(context, self):
+                if security_middleware is None:
+                    yield fragment.encode(encoding)
+                    continue
+                pending += fragment
+                cut = cursor.advance(pending)
+                if cut:
+                    yield sanitize(pending[:cut]).encode(encoding)
+                    pending = pending[cut:]
+                    cursor.consume(cut)
+            if pending:
+                yield sanitize(pending).encode(encoding)
+        except TemplateError:
+            self.render_stats['errors'] += 1
+            raise
+
+        stats = self.render_stats
+        stats['total_renders'] += 1
+        stats['avg_render_time'] += (time.perf_counter() - started - stats['avg_render_time']) / stats['total_renders']
+
+    def _render_compiled(self, compiled: CompiledTemplate, context: Dict[str, Any]) -> str:
+        """Run a compiled template and apply output sanitization"""
+        started = time.perf_counter()
+        try:
+            content = compiled.render(context, self)
+        except TemplateError:
+            self.render_stats['errors'] += 1
+            raise
+
+        # Apply security sanitization if enabled
+        security_middleware = _security_middleware()
+        if security_middleware is not None:
+            try:
+                content = security_middleware.sanitize_template_output(content)
+            except Exception:
+                pass
+
+        stats = self.render_stats
+        stats['total_renders'] += 1
+        stats['avg_render_time'] += (time.perf_counter() - started - stats['avg_render_time']) / stats['total_renders']
+        return content
+
     def _escape_filter(self, value: str) -> str:
         """Escape HTML special characters"""
-        if not isinstance(value, str):
+        if not isinstance(value, str) or isinstance(value, Markup):
             return value
-        
-        escape_map = {
-            '&': '&amp;',
-            '<': '&lt;',
-            '>': '&gt;',
-            '"': '&quot;',
-            "'": '&#x27;',
-            '/': '&#x2F;'
-        }
-        
-        for char, escape in escape_map.items():
-            value = value.replace(char, escape)
-        
-        return value
-    
+        return Markup(escape(value))
+
+    def preload(self) -> int:
+        """
+        Compile every template under ``template_dir`` into the memory cache
+        (e.g. in a pre-fork master, so workers share the compiled forms).
+        Files that fail to compile are skipped. Returns the number compiled.
+        """
+        compiled = 0
+        for template_path in sorted(self.template_dir.rglob('*')):
+            if not template_path.is_file():
+                continue
+            try:
+                self.get_compiled(template_path)
+                compiled += 1
+            except Exception as e:
+                if self.debug:
+                    print(f"Skipping template {template_path}: {e}")
+        return compiled
+
     def add_filter(self, name: str, filter_func: Callable):
         """Add a custom filter"""
         self.filters[name] = filter_func
@@ -675,7 +358,7 @@ class LeanTemplateEngine(AbstractTemplateEngine):
             # HTML escaping
             'escape': self._escape_filter,
             'e': self._escape_filter,  # Alias for escape
-            'safe': lambda x: x,  # Mark as safe, no escaping
+            'safe': lambda x: x if isinstance(x, Markup) else Markup('' if x is None else x),  # Mark as safe, no escaping
 
             # Number filters
             'abs': lambda x: abs(x) if isinstance(x, (int, float)) else x,
@@ -689,10 +372,10 @@ class LeanTemplateEngine(AbstractTemplateEngine):
             'datetime': lambda x, fmt='%Y-%m-%d %H:%M:%S': x.strftime(fmt) if hasattr(x, 'strftime') else str(x),
 
             # JSON
-            'tojson': lambda x: json.dumps(x, default=str),
+            'tojson': lambda x: Markup(json.dumps(x, default=str)),
 
             # Formatting
-            'format': lambda x, fmt: fmt.format(x) if fmt else str(x),
+            'format': lambda x, fmt: safe_format(fmt, x) if fmt else str(x),
             'pluralize': lambda x, singular='', plural='s': singular if x == 1 else plural,
 
             # Utility
@@ -726,254 +409,6 @@ class LeanTemplateEngine(AbstractTemplateEngine):
         except ImportError:
             return {}
 
-    def _process_advanced_blocks(self, content: str, context: Dict[str, Any]) -> str:
-        """Process advanced template blocks"""
-        lines = content.split('\n')
-        output_lines = []
-        i = 0
-
-        while i < len(lines):
-            line = lines[i]
-
-            # Process custom tags first
-            custom_processed = False
-            for tag_name, tag_func in self.custom_tags.items():
-                tag_pattern = rf'\{{%\s*{tag_name}\s*(.*?)\s*%\}}'
-                if re.match(tag_pattern, line):
-                    result = tag_func(context, *re.match(tag_pattern, line).groups())
-                    output_lines.append(str(result))
-                    custom_processed = True
-                    break
-
-            if custom_processed:
-                i += 1
-                continue
-
-            # Process while loops
-            while_match = re.match(self.patterns['while'], line)
-            if while_match:
-                condition = while_match.group(1)
-                endwhile_index = self._find_block_end(lines, i, 'while', 'endwhile')
-
-                loop_content = '\n'.join(lines[i+1:endwhile_index])
-                loop_output = []
-
-                max_iterations = 1000  # Prevent infinite loops
-                iterations = 0
-
-                while self._evaluate_condition(condition, context) and iterations < max_iterations:
-                    rendered_content = self._render_content_sync(loop_content, context.copy(), self.template_dir)
-                    loop_output.append(rendered_content)
-                    iterations += 1
-
-                    # Check for break/continue
-                    if '{% break %}' in rendered_content or '{% continue %}' in rendered_content:
-                        break
-
-                output_lines.append('\n'.join(loop_output))
-                i = endwhile_index + 1
-                continue
-
-            # Process with blocks
-            with_match = re.match(self.patterns['with'], line)
-            if with_match:
-                assignments = with_match.group(1)
-                endwith_index = self._find_block_end(lines, i, 'with', 'endwith')
-
-                # Parse assignments like "var1=value1, var2=value2"
-                with_context = context.copy()
-                for assignment in assignments.split(','):
-                    if '=' in assignment:
-                        var_name, expr = assignment.split('=', 1)
-                        with_context[var_name.strip()] = self._evaluate_expression(expr.strip(), context)
-
-                block_content = '\n'.join(lines[i+1:endwith_index])
-                rendered_block = self._render_content_sync(block_content, with_context, self.template_dir)
-                output_lines.append(rendered_block)
-                i = endwith_index + 1
-                continue
-
-            # Process spaceless blocks
-            spaceless_match = re.match(self.patterns['spaceless'], line)
-            if spaceless_match:
-                endspaceless_index = self._find_block_end(lines, i, 'spaceless', 'endspaceless')
-
-                block_content = '\n'.join(lines[i+1:endspaceless_index])
-                rendered_block = self._render_content_sync(block_content, context, self.template_dir)
-
-                # Remove whitespace between HTML tags
-                rendered_block = re.sub(r'>\s+<', '><', rendered_block)
-                output_lines.append(rendered_block)
-                i = endspaceless_index + 1
-                continue
-
-            # Process autoescape blocks
-            autoescape_match = re.match(self.patterns['autoescape'], line)
-            if autoescape_match:
-                escape_value = autoescape_match.group(1).lower() in ('true', 'on', 'yes')
-                endautoescape_index = self._find_block_end(lines, i, 'autoescape', 'endautoescape')
-
-                old_autoescape = self.autoescape
-                self.autoescape = escape_value
-
-                block_content = '\n'.join(lines[i+1:endautoescape_index])
-                rendered_block = self._render_content_sync(block_content, context, self.template_dir)
-
-                self.autoescape = old_autoescape
-                output_lines.append(rendered_block)
-                i = endautoescape_index + 1
-                continue
-
-            # Process load directives
-            load_match = re.match(self.patterns['load'], line)
-            if load_match:
-                # Load external template libraries/tags
-                # This would implement dynamic loading
-                i += 1
-                continue
-
-            output_lines.append(line)
-            i += 1
-
-        return '\n'.join(output_lines)
-
-    def _find_block_end(self, lines: List[str], start_index: int, block_type: str, end_type: str) -> int:
-        """Find the end of a block"""
-        depth = 1
-        i = start_index + 1
-
-        while i < len(lines) and depth > 0:
-            line = lines[i]
-
-            if re.search(rf'\{{%\s*{block_type}\s*%}}', line):
-                depth += 1
-            elif re.search(rf'\{{%\s*{end_type}\s*%}}', line):
-                depth -= 1
-                if depth == 0:
-                    return i
-
-            i += 1
-
-        return len(lines) - 1  # Fallback
-
-    def _process_enhanced_for_loops(self, content: str, context: Dict[str, Any]) -> str:
-        """Process enhanced for loops with filtering and unpacking"""
-        def process_for_loop(match):
-            full_match = match.group(0)
-            loop_vars = match.group(1)
-            iterable_expr = match.group(2)
-            filter_expr = match.group(3)
-
-            # Parse loop variables (support unpacking)
-            if ',' in loop_vars:
-                var_names = [v.strip() for v in loop_vars.split(',')]
-            else:
-                var_names = [loop_vars.strip()]
-
-            # Get iterable
-            iterable = self._evaluate_expression(iterable_expr, context)
-
-            # Apply filter if present
-            if filter_expr:
-                iterable = [item for item in iterable if self._evaluate_condition(filter_expr, {'item': item, **context})]
-
-            # Process loop
-            loop_output = []
-            for index, item in enumerate(iterable):
-                loop_context = context.copy()
-
-                # Handle unpacking
-                if len(var_names) > 1 and hasattr(item, '__iter__'):
-                    for i, var_name in enumerate(var_names):
-                        if i < len(item):
-                            loop_context[var_name] = item[i]
-                        else:
-                            loop_context[var_name] = None
-                else:
-                    loop_context[var_names[0]] = item
-
-                # Add loop variables
-                loop_context['loop'] = {
-                    'index': index + 1,
-                    'index0': index,
-                    'first': index == 0,
-                    'last': index == len(iterable) - 1,
-                    'length': len(iterable),
-                    'previtem': iterable[index - 1] if index > 0 else None,
-                    'nextitem': iterable[index + 1] if index < len(iterable) - 1 else None,
-                }
-
-                # Find loop content (this is a simplified version)
-                # In practice, this would need more sophisticated parsing
-                loop_output.append(f"<!-- Loop item {index} -->")
-
-            return '\n'.join(loop_output)
-
-        return re.sub(self.patterns['for'], process_for_loop, content)
-
-    def _process_enhanced_conditionals(self, content: str, context: Dict[str, Any]) -> str:
-        """Process enhanced if/elif/else conditionals"""
-        # This is a simplified implementation
-        # A full implementation would need proper AST parsing
-
-        lines = content.split('\n')
-        output_lines = []
-        i = 0
-
-        while i < len(lines):
-            line = lines[i]
-
-            if_match = re.match(self.patterns['if'], line)
-            if if_match:
-                condition = if_match.group(1)
-                endif_index = self._find_block_end(lines, i, 'if', 'endif')
-
-                # Collect all branches
-                branches = []
-                current_index = i
-
-                # IF branch
-                if self._evaluate_condition(condition, context):
-                    block_content = '\n'.join(lines[i+1:endif_index])
-                    rendered_block = self._render_content_sync(block_content, context, self.template_dir)
-                    output_lines.append(rendered_block)
-                    i = endif_index + 1
-                    continue
-
-                # Check for ELIF branches
-                current_index = i + 1
-                while current_index < endif_index:
-                    elif_match = re.match(self.patterns['elif'], lines[current_index])
-                    if elif_match:
-                        elif_condition = elif_match.group(1)
-                        elif_end_index = self._find_block_end(lines, current_index, 'elif', 'endif')
-
-                        if self._evaluate_condition(elif_condition, context):
-                            block_content = '\n'.join(lines[current_index+1:elif_end_index])
-                            rendered_block = self._render_content_sync(block_content, context, self.template_dir)
-                            output_lines.append(rendered_block)
-                            i = endif_index + 1
-                            break
-
-                        current_index = elif_end_index
-                    else:
-                        break
-
-                # Check for ELSE branch
-                else_match = re.match(self.patterns['else'], lines[current_index])
-                if else_match and not output_lines:
-                    block_content = '\n'.join(lines[current_index+1:endif_index])
-                    rendered_block = self._render_content_sync(block_content, context, self.template_dir)
-                    output_lines.append(rendered_block)
-
-                i = endif_index + 1
-                continue
-
-            output_lines.append(line)
-            i += 1
-
-        return '\n'.join(output_lines)
-
     def get_performance_stats(self) -> Dict[str, Any]:
         """Get performance statistics"""
         return self.render_stats.copy()
@@ -985,17 +420,17 @@ class LeanTemplateEngine(AbstractTemplateEngine):
     def clear_cache(self):
         """Clear all caches"""
         self.cache.clear()
+        self.string_cache.clear()
         self.macro_cache.clear()
         self.filter_cache.clear()
 
     def preload_templates(self, template_names: List[str]):
-        """Preload templates into cache"""
+        """Compile templates into the cache ahead of the first render"""
         for template_name in template_names:
             try:
                 template_path = self.template_dir / template_name
                 if template_path.exists():
-                    with open(template_path, 'r', encoding='utf-8') as f:
-                        self.cache[template_path] = f.read()
+                    self.get_compiled(template_path)
             except Exception as e:
                 if self.debug:
                     print(f"Failed to preload template {template_name}: {e}")
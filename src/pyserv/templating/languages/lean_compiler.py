@@ -0,0 +1,1321 @@
+"""
+Compiler for Lean templates.
+
+A template is parsed once into a node tree. ``extends`` and ``include``
+are resolved at that point, so the tree for a page already contains its
+layout and partials. The tree is then turned into the source of one Python
+function, compiled to a code object, and cached. Rendering a cached
+template is a single call to that function: no regular expressions run and
+no expression is re-parsed. Each template also gets a generator version of
+that function. It yields the page in pieces: after ``</head>``, around
+blocks, and inside long loops, so a response can start before the page is
+finished.
+
+Expressions use Python syntax, checked node by node with ``ast`` against a
+whitelist: no lambdas, no comprehensions, and no attribute names starting
+with ``_``. On top of that:
+
+- ``a.b`` reads a key, then an attribute; ``items.0`` indexes.
+- ``x | name`` and ``x | name:arg1,arg2`` apply filters. Colon arguments
+  are literals; bare words are passed as strings, as before. Use
+  ``x | name(expr)`` for computed arguments.
+- ``true``, ``false``, ``none`` and ``null`` are literals.
+
+A ``CompiledTemplate`` records the files it was built from with their
+mtimes, so edits to a page, its layouts or its includes invalidate it. It
+can be written to disk with ``marshal`` and loaded by later processes.
+"""
+
+import ast
+import importlib.util
+import io
+import marshal
+import os
+import re
+import string
+import sys
+import tokenize
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterator, List, Optional, Tuple
+
+# Bump when the generated code changes shape, to invalidate disk caches
+COMPILER_VERSION = 3
+
+# A streamed render also flushes once a loop has buffered this many fragments
+STREAM_FLUSH_FRAGMENTS = 256
+
+# {% while %} stops after this many iterations, as the interpreted engine did
+WHILE_MAX_ITERATIONS = 1000
+
+# String methods that resolve attribute paths inside format fields
+_UNSAFE_STR_METHODS = frozenset({'format', 'format_map'})
+
+_HEAD_END_RE = re.compile(r'</head\s*>', re.IGNORECASE)
+
+
+class TemplateError(Exception):
+    """Base exception for template errors"""
+    def __init__(self, message: str, template_name: str = None, line_number: int = None):
+        self.message = message
+        self.template_name = template_name
+        self.line_number = line_number
+        super().__init__(f"{message}" + (f" in {template_name}:{line_number}" if template_name and line_number else ""))
+
+
+class TemplateSyntaxError(TemplateError):
+    """Syntax error in template"""
+    pass
+
+
+class TemplateRuntimeError(TemplateError):
+    """Runtime error during template rendering"""
+    pass
+
+
+# Runtime support used by generated code
+
+class Undefined(KeyError):
+    """A name, key or attribute used by a template does not exist"""
+
+
+class Markup(str):
+    """String that is already safe for HTML output"""
+    __slots__ = ()
+
+
+_ESCAPE_TABLE = str.maketrans({
+    '&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;', "'": '&#x27;',
+})
+
+
+def escape(value: Any) -> str:
+    """Escape HTML special characters"""
+    return str(value).translate(_ESCAPE_TABLE)
+
+
+def _undefined(name: str):
+    raise Undefined(name)
+
+
+def _attr(obj: Any, name: str) -> Any:
+    if isinstance(obj, dict):
+        try:
+            return obj[name]
+        except KeyError:
+            pass
+    if name in _UNSAFE_STR_METHODS and isinstance(obj, str):
+        # Format fields walk attributes ("{0.__class__}") past the private-name check
+        raise TemplateRuntimeError(f"str.{name} is not allowed in templates")
+    try:
+        return getattr(obj, name)
+    except AttributeError:
+        raise Undefined(name) from None
+
+
+class _SafeFormatter(string.Formatter):
+    """str.format without attribute or item lookups inside replacement fields"""
+
+    def get_field(self, field_name, args, kwargs):
+        if '.' in field_name or '[' in field_name:
+            raise TemplateRuntimeError(f"Format field {field_name!r} is not allowed in templates")
+        return super().get_field(field_name, args, kwargs)
+
+
+safe_format = _SafeFormatter().format
+
+
+def _item(obj: Any, key: Any) -> Any:
+    try:
+        return obj[key]
+    except (KeyError, IndexError, TypeError):
+        if isinstance(key, str) and not key.startswith('_'):
+            return _attr(obj, key)
+        raise Undefined(key) from None
+
+
+def _filter(env: Any, name: str, value: Any, *args, **kwargs) -> Any:
+    func = env.filters.get(name)
+    if func is None:
+        raise Undefined(name)
+    return func(value, *args, **kwargs)
+
+
+def _out_escaped(value: Any) -> str:
+    if value is None:
+        return ''
+    if isinstance(value, Markup):
+        return value
+    cls = type(value)
+    if cls is int or cls is float:
+        return str(value)
+    return str(value).translate(_ESCAPE_TABLE)
+
+
+def _out_raw(value: Any) -> str:
+    return '' if value is None else str(value)
+
+
+def _unpack(value: Any, count: int) -> tuple:
+    values = tuple(value) if hasattr(value, '__iter__') and not isinstance(value, str) else (value,)
+    if len(values) < count:
+        values += (None,) * (count - len(values))
+    return values[:count]
+
+
+def _spaceless(text: str) -> str:
+    return re.sub(r'>\s+<', '><', text)
+
+
+def _callable(ctx: Dict[str, Any], env: Any, macros: Dict[str, Callable], name: str) -> Callable:
+    macro = macros.get(name)
+    if macro is not None:
+        return lambda *args, **kwargs: macro(ctx, env, args, kwargs)
+    if name in ctx and callable(ctx[name]):
+        return ctx[name]
+    func = getattr(env, 'macros', {}).get(name)
+    if callable(func):
+        return func
+    raise Undefined(name)
+
+
+def _call_macro(ctx: Dict[str, Any], env: Any, macros: Dict[str, Callable], name: str,
+                args: tuple, kwargs: dict) -> str:
+    try:
+        func = _callable(ctx, env, macros, name)
+    except Undefined:
+        return f"<!-- Macro {name} not found -->"
+    result = func(*args, **kwargs)
+    return result if isinstance(result, Markup) else Markup('' if result is None else str(result))
+
+
+def _bind_macro(ctx: Dict[str, Any], name: str, params: Tuple[str, ...], defaults: Dict[str, Any],
+                args: tuple, kwargs: dict) -> None:
+    if len(args) > len(params):
+        raise TypeError(f"macro {name}() takes {len(params)} arguments but {len(args)} were given")
+    for param, arg in zip(params, args):
+        ctx[param] = arg
+    for param in params[len(args):]:
+        if param in kwargs:
+            ctx[param] = kwargs[param]
+        else:
+            ctx[param] = defaults.get(param)
+
+
+def _custom_tag(ctx: Dict[str, Any], env: Any, name: str, args: str, source: str) -> str:
+    tag = getattr(env, 'custom_tags', {}).get(name)
+    if tag is None:
+        return source
+    result = tag(ctx, args)
+    return '' if result is None else str(result)
+
+
+class LoopContext:
+    """The ``loop`` variable inside ``for`` blocks"""
+
+    __slots__ = ('items', 'index0', 'length')
+
+    def __init__(self, iterable: Any):
+        items = iterable if isinstance(iterable, (list, tuple)) else list(iterable or ())
+        self.items = items
+        self.index0 = -1
+        self.length = len(items)
+
+    @property
+    def index(self) -> int:
+        return self.index0 + 1
+
+    @property
+    def revindex(self) -> int:
+        return self.length - self.index0
+
+    @property
+    def revindex0(self) -> int:
+        return self.length - self.index0 - 1
+
+    @property
+    def first(self) -> bool:
+        return self.index0 == 0
+
+    @property
+    def last(self) -> bool:
+        return self.index0 == self.length - 1
+
+    @property
+    def previtem(self) -> Any:
+        return self.items[self.index0 - 1] if self.index0 > 0 else None
+
+    @property
+    def nextitem(self) -> Any:
+        return self.items[self.index0 + 1] if self.index0 + 1 < self.length else None
+
+
+RUNTIME = {
+    # Template names never reach builtins; generated code only needs these
+    '__builtins__': {'dict': dict, 'enumerate': enumerate, 'len': len, 'range': range, 'Exception': Exception},
+    '_Undefined': Undefined,
+    '_Markup': Markup,
+    '_undefined': _undefined,
+    '_attr': _attr,
+    '_item': _item,
+    '_filter': _filter,
+    '_out_escaped': _out_escaped,
+    '_out_raw': _out_raw,
+    '_unpack': _unpack,
+    '_spaceless': _spaceless,
+    '_callable': _callable,
+    '_call_macro': _call_macro,
+    '_bind_macro': _bind_macro,
+    '_custom_tag': _custom_tag,
+    '_Loop': LoopContext,
+}
+
+
+# Lexer
+
+_TOKEN_RE = re.compile(r'(\{\{.*?\}\}|\{%.*?%\}|\{#.*?#\})', re.DOTALL)
+_ENDRAW_RE = re.compile(r'\{%-?\s*endraw\s*-?%\}')
+
+
+class Token:
+    __slots__ = ('kind', 'value', 'source', 'lineno')
+
+    def __init__(self, kind: str, value: str, source: str, lineno: int):
+        self.kind = kind  # 'text', 'var' or 'tag'
+        self.value = value
+        self.source = source
+        self.lineno = lineno
+
+
+def tokenize_template(source: str, name: str, trim_blocks: bool = True, lstrip_blocks: bool = True) -> List[Token]:
+    """Split template source into text, ``{{ }}`` and ``{% %}`` tokens; comments are dropped."""
+    tokens: List[Token] = []
+    pos = 0
+    lineno = 1
+    trim_next = False
+    length = len(source)
+
+    def add_text(text: str, line: int) -> None:
+        if text:
+            tokens.append(Token('text', text, text, line))
+
+    while pos < length:
+        match = _TOKEN_RE.search(source, pos)
+        end = match.start() if match else length
+        text = source[pos:end]
+        if trim_next:
+            if text.startswith('\r\n'):
+                text = text[2:]
+            elif text.startswith('\n'):
+                text = text[1:]
+            trim_next = False
+        if match is None:
+            add_text(text, lineno)
+            break
+
+        raw = match.group(0)
+        inner = raw[2:-2]
+        strip_before = inner.startswith('-')
+        strip_after = inner.endswith('-')
+        inner = inner[1 if strip_before else 0:len(inner) - (1 if strip_after else 0)].strip()
+        kind = {'{{': 'var', '{%': 'tag', '{#': 'comment'}[raw[:2]]
+
+        if strip_before:
+            text = text.rstrip()
+        elif kind != 'var' and lstrip_blocks:
+            line_start = text.rfind('\n') + 1
+            if not text[line_start:].strip(' \t') and (line_start or not tokens):
+                text = text[:line_start]
+        add_text(text, lineno)
+        lineno += source.count('\n', pos, match.start())
+        tag_line = lineno
+        pos = match.end()
+        lineno += raw.count('\n')
+
+        if kind == 'comment':
+            trim_next = strip_after
+            if strip_after:
+                while pos < length and source[pos].isspace():
+                    pos += 1
+            continue
+
+        if kind == 'tag' and inner and inner.split(None, 1)[0] == 'raw':
+            end_match = _ENDRAW_RE.search(source, pos)
+            if end_match is None:
+                raise TemplateSyntaxError("Unclosed raw block", name, tag_line)
+            body = source[pos:end_match.start()]
+            if trim_blocks and body.startswith('\n'):
+                body = body[1:]
+            if lstrip_blocks:
+                line_start = body.rfind('\n') + 1
+                if not body[line_start:].strip(' \t'):
+                    body = body[:line_start]
+            add_text(body, lineno)
+            lineno += source.count('\n', pos, end_match.end())
+            pos = end_match.end()
+            trim_next = trim_blocks
+            continue
+
+        tokens.append(Token(kind, inner, raw, tag_line))
+        if strip_after:
+            while pos < length and source[pos].isspace():
+                if source[pos] == '\n':
+                    lineno += 1
+                pos += 1
+        elif kind == 'tag':
+            trim_next = trim_blocks
+    return tokens
+
+
+# Nodes
+
+class Node:
+    fields: Tuple[str, ...] = ()
+    bodies: Tuple[str, ...] = ()
+
+    def __init__(self, lineno: int = 0, **values):
+        self.lineno = lineno
+        for name in self.fields + self.bodies:
+            setattr(self, name, values.get(name))
+
+    def children(self):
+        for name in self.bodies:
+            body = getattr(self, name)
+            if body:
+                yield name, body
+
+
+class Text(Node):
+    fields = ('text',)
+
+
+class Output(Node):
+    fields = ('expr', 'source')
+
+
+class If(Node):
+    fields = ('tests',)       # list of condition expressions
+    bodies = ('branches',)    # list of bodies, one per test, plus else
+
+    def children(self):
+        for index, body in enumerate(self.branches):
+            yield index, body
+
+
+class For(Node):
+    fields = ('targets', 'iter', 'cond')
+    bodies = ('body', 'else_body')
+
+
+class While(Node):
+    fields = ('test',)
+    bodies = ('body',)
+
+
+class Set(Node):
+    fields = ('name', 'expr')
+
+
+class Block(Node):
+    fields = ('name',)
+    bodies = ('body',)
+
+
+class Extends(Node):
+    fields = ('template',)
+
+
+class Include(Node):
+    fields = ('template', 'base_dir')
+
+
+class Macro(Node):
+    fields = ('name', 'params', 'defaults')
+    bodies = ('body',)
+
+
+class CallMacro(Node):
+    fields = ('name', 'args', 'source')
+
+
+class With(Node):
+    fields = ('assignments',)
+    bodies = ('body',)
+
+
+class Spaceless(Node):
+    bodies = ('body',)
+
+
+class Autoescape(Node):
+    fields = ('enabled',)
+    bodies = ('body',)
+
+
+class LoopControl(Node):
+    fields = ('keyword',)
+
+
+class CustomTag(Node):
+    fields = ('name', 'args', 'source')
+
+
+def _walk_bodies(nodes: List[Node], visit: Callable[[List[Node]], List[Node]]) -> List[Node]:
+    """Rebuild every body in the tree through ``visit``."""
+    for node in nodes:
+        if isinstance(node, If):
+            node.branches = [visit(body) for body in node.branches]
+        else:
+            for name, body in list(node.children()):
+                setattr(node, name, visit(body))
+    return nodes
+
+
+# Parser
+
+_FOR_RE = re.compile(r'^(\w+(?:\s*,\s*\w+)*)\s+in\s+(.+?)(?:\s+if\s+(.+))?$', re.DOTALL)
+_SET_RE = re.compile(r'^(\w+)\s*=\s*(.+)$', re.DOTALL)
+_CALL_RE = re.compile(r'^(\w+)\s*\((.*)\)$', re.DOTALL)
+_STRING_RE = re.compile(r'''^(?:"([^"]*)"|'([^']*)')''')
+
+_END_TAGS = {'if': ('elif', 'else', 'endif'), 'for': ('else', 'endfor'), 'while': ('endwhile',),
+             'block': ('endblock',),
+             'macro': ('endmacro',), 'with': ('endwith',), 'spaceless': ('endspaceless',),
+             'autoescape': ('endautoescape',)}
+
+
+class Parser:
+    """Build a node tree from template tokens"""
+
+    def __init__(self, tokens: List[Token], name: str, base_dir: Path):
+        self.tokens = tokens
+        self.name = name
+        self.base_dir = base_dir
+        self.pos = 0
+
+    def error(self, message: str, lineno: int) -> TemplateSyntaxError:
+        return TemplateSyntaxError(message, self.name, lineno)
+
+    def parse(self) -> List[Node]:
+        nodes, end = self.parse_body(())
+        return nodes
+
+    def parse_body(self, end_tags: Tuple[str, ...], start: Optional[Token] = None):
+        nodes: List[Node] = []
+        while self.pos < len(self.tokens):
+            token = self.tokens[self.pos]
+            self.pos += 1
+            if token.kind == 'text':
+                nodes.append(Text(token.lineno, text=token.value))
+            elif token.kind == 'var':
+                nodes.append(Output(token.lineno, expr=token.value, source=token.source))
+            else:
+                keyword, _, rest = token.value.partition(' ')
+                keyword = keyword.strip()
+                rest = rest.strip()
+                if keyword in end_tags:
+                    return nodes, (keyword, rest, token)
+                if keyword.startswith('end') or keyword in ('elif', 'else'):
+                    raise self.error(f"Unexpected {keyword}", token.lineno)
+                node = self.parse_tag(keyword, rest, token)
+                if node is not None:
+                    nodes.append(node)
+        if end_tags:
+            raise self.error(f"Unclosed {start.value.split()[0]} block", start.lineno)
+        return nodes, None
+
+    def parse_tag(self, keyword: str, rest: str, token: Token) -> Optional[Node]:
+        lineno = token.lineno
+        if keyword == 'if':
+            tests, branches = [rest], []
+            while True:
+                body, (end, args, end_token) = self.parse_body(_END_TAGS['if'], token)
+                branches.append(body)
+                if end == 'elif':
+                    tests.append(args)
+                elif end == 'else':
+                    body, (end, args, end_token) = self.parse_body(('endif',), token)
+                    branches.append(body)
+                    break
+                else:
+                    break
+            return If(lineno, tests=tests, branches=branches)
+        if keyword == 'for':
+            match = _FOR_RE.match(rest)
+            if not match:
+                raise self.error(f"Invalid for loop: {rest}", lineno)
+            body, (end, _, _) = self.parse_body(_END_TAGS['for'], token)
+            else_body = None
+            if end == 'else':
+                else_body, _ = self.parse_body(('endfor',), token)
+            targets = tuple(t.strip() for t in match.group(1).split(','))
+            return For(lineno, targets=targets, iter=match.group(2), cond=match.group(3),
+                       body=body, else_body=else_body)
+        if keyword == 'while':
+            if not rest:
+                raise self.error("while requires a condition", lineno)
+            body, _ = self.parse_body(_END_TAGS['while'], token)
+            return While(lineno, test=rest, body=body)
+        if keyword == 'set':
+            match = _SET_RE.match(rest)
+            if not match:
+                raise self.error(f"Invalid set: {rest}", lineno)
+            return Set(lineno, name=match.group(1), expr=match.group(2))
+        if keyword == 'block':
+            name = rest.split()[0] if rest else ''
+            if not name.isidentifier():
+                raise self.error("Block requires a name", lineno)
+            body, _ = self.parse_body(_END_TAGS['block'], token)
+            return Block(lineno, name=name, body=body)
+        if keyword in ('extends', 'include'):
+            match = _STRING_RE.match(rest)
+            if not match:
+                raise self.error(f"{keyword} requires a quoted template name", lineno)
+            template = match.group(1) if match.group(1) is not None else match.group(2)
+            if keyword == 'extends':
+                return Extends(lineno, template=template)
+            return Include(lineno, template=template, base_dir=self.base_dir)
+        if keyword == 'macro':
+            match = _CALL_RE.match(rest)
+            if not match:
+                raise self.error(f"Invalid macro: {rest}", lineno)
+            params, defaults = self.parse_params(match.group(2), lineno)
+            body, _ = self.parse_body(_END_TAGS['macro'], token)
+            return Macro(lineno, name=match.group(1), params=params, defaults=defaults, body=body)
+        if keyword == 'call':
+            match = _CALL_RE.match(rest)
+            if not match:
+                raise self.error(f"Invalid call: {rest}", lineno)
+            return CallMacro(lineno, name=match.group(1), args=match.group(2), source=token.source)
+        if keyword == 'with':
+            body, _ = self.parse_body(_END_TAGS['with'], token)
+            return With(lineno, assignments=rest, body=body)
+        if keyword == 'spaceless':
+            body, _ = self.parse_body(_END_TAGS['spaceless'], token)
+            return Spaceless(lineno, body=body)
+        if keyword == 'autoescape':
+            body, _ = self.parse_body(_END_TAGS['autoescape'], token)
+            return Autoescape(lineno, enabled=rest.lower() in ('true', 'on', 'yes'), body=body)
+        if keyword in ('break', 'continue'):
+            return LoopControl(lineno, keyword=keyword)
+        if keyword == 'load':
+            return None
+        return CustomTag(lineno, name=keyword, args=rest, source=token.source)
+
+    def parse_params(self, text: str, lineno: int) -> Tuple[Tuple[str, ...], Dict[str, Any]]:
+        try:
+            func = ast.parse(f"def _({text}): pass").body[0]
+        except SyntaxError:
+            raise self.error(f"Invalid macro parameters: {text}", lineno) from None
+        arguments = func.args
+        params = tuple(arg.arg for arg in arguments.args)
+        defaults = {}
+        for arg, default in zip(arguments.args[len(arguments.args) - len(arguments.defaults):], arguments.defaults):
+            try:
+                defaults[arg.arg] = ast.literal_eval(default)
+            except ValueError:
+                raise self.error(f"Macro defaults must be literals: {text}", lineno) from None
+        return params, defaults
+
+
+# Expressions
+
+_LITERAL_NAMES = {'true': True, 'false': False, 'none': None, 'null': None,
+                  'True': True, 'False': False, 'None': None}
+_STOP_WORDS = {'and', 'or', 'not', 'if', 'else', 'in', 'is'}
+_STOP_OPS = {'|', '==', '!=', '<', '>', '<=', '>=', ')', ']', '}'}
+
+_ALLOWED_NODES = (
+    ast.Expression, ast.Name, ast.Load, ast.Constant, ast.Attribute, ast.Subscript, ast.Slice,
+    ast.List, ast.Tuple, ast.Dict, ast.BoolOp, ast.And, ast.Or, ast.UnaryOp, ast.Not, ast.USub, ast.UAdd,
+    ast.BinOp, ast.Add, ast.Sub, ast.Mult, ast.Div, ast.FloorDiv, ast.Mod, ast.Pow, ast.BitOr,
+    ast.Compare, ast.Eq, ast.NotEq, ast.Lt, ast.LtE, ast.Gt, ast.GtE, ast.In, ast.NotIn, ast.Is, ast.IsNot,
+    ast.IfExp, ast.Call, ast.keyword,
+)
+
+
+def _colon_argument(text: str) -> str:
+    """Python source for one ``filter:arg`` argument: a literal, else the text as a string."""
+    text = text.strip()
+    try:
+        return repr(ast.literal_eval(text))
+    except (ValueError, SyntaxError):
+        if text in _LITERAL_NAMES or text.lower() in _LITERAL_NAMES:
+            return repr(_LITERAL_NAMES.get(text, _LITERAL_NAMES.get(text.lower())))
+        return repr(text)
+
+
+def _split_top_level(text: str, separator: str = ',') -> List[str]:
+    parts, depth, quote, current = [], 0, None, []
+    for char in text:
+        if quote:
+            if char == quote:
+                quote = None
+        elif char in '"\'':
+            quote = char
+        elif char in '([{':
+            depth += 1
+        elif char in ')]}':
+            depth -= 1
+        elif char == separator and depth == 0:
+            parts.append(''.join(current))
+            current = []
+            continue
+        current.append(char)
+    parts.append(''.join(current))
+    return parts
+
+
+def _rewrite_source(text: str) -> str:
+    """
+    Turn template expression syntax into Python syntax.
+
+    ``items.0`` becomes ``items[0]`` and ``| name:a,b`` becomes ``| name(a, b)``.
+    """
+    try:
+        tokens = list(tokenize.generate_tokens(io.StringIO(text).readline))
+    except (tokenize.TokenError, IndentationError, SyntaxError):
+        return text
+
+    lines = text.split('\n')
+    offsets = [0]
+    for line in lines:
+        offsets.append(offsets[-1] + len(line) + 1)
+
+    def offset(position: Tuple[int, int]) -> int:
+        return offsets[position[0] - 1] + position[1]
+
+    out: List[str] = []
+    last = 0
+    index = 0
+    previous = None
+    while index < len(tokens):
+        token = tokens[index]
+        start, end = offset(token.start), offset(token.end)
+        if (token.type == tokenize.NUMBER and token.string.startswith('.') and token.string[1:].isdigit()
+                and previous is not None and (previous.type == tokenize.NAME or previous.string in (')', ']'))
+                and previous.end == token.start):
+            out.append(text[last:start])
+            out.append(f"[{token.string[1:]}]")
+            last = end
+        elif (token.string == ':' and index >= 2 and tokens[index - 1].type == tokenize.NAME
+                and tokens[index - 2].string == '|'):
+            # Colon arguments run to the next pipe, comparison, keyword or closing bracket
+            depth = 0
+            stop = index + 1
+            while stop < len(tokens):
+                candidate = tokens[stop]
+                if candidate.type in (tokenize.NEWLINE, tokenize.ENDMARKER, tokenize.NL):
+                    break
+                if candidate.string in '([{' and candidate.type == tokenize.OP:
+                    depth += 1
+                elif candidate.string in ')]}' and candidate.type == tokenize.OP:
+                    if depth == 0:
+                        break
+                    depth -= 1
+                elif depth == 0 and (candidate.string in _STOP_OPS or
+                                     (candidate.type == tokenize.NAME and candidate.string in _STOP_WORDS)):
+                    break
+                stop += 1
+            arg_end = offset(tokens[stop].start) if stop < len(tokens) else len(text)
+            arguments = text[end:arg_end]
+            out.append(text[last:start])
+            out.append('(' + ', '.join(_colon_argument(arg) for arg in _split_top_level(arguments)) + ') ')
+            last = arg_end
+            index = stop
+            previous = None
+            continue
+        previous = token
+        index += 1
+    out.append(text[last:])
+    return ''.join(out)
+
+
+class _ExpressionCompiler(ast.NodeTransformer):
+    """Rewrite a checked expression tree into runtime lookups."""
+
+    def __init__(self, template_name: str, lineno: int):
+        self.template_name = template_name
+        self.lineno = lineno
+        self.uses_filters = False
+
+    def error(self, message: str) -> TemplateSyntaxError:
+        return TemplateSyntaxError(message, self.template_name, self.lineno)
+
+    def generic_visit(self, node):
+        if not isinstance(node, _ALLOWED_NODES):
+            raise self.error(f"Unsupported expression syntax: {type(node).__name__}")
+        return super().generic_visit(node)
+
+    def visit_Name(self, node):
+        if node.id in _LITERAL_NAMES:
+            return ast.copy_location(ast.Constant(_LITERAL_NAMES[node.id]), node)
+        if node.id.startswith('_'):
+            raise self.error(f"Access to private name {node.id!r} is not allowed")
+        name = ast.Constant(node.id)
+        ctx_name = ast.Name('ctx', ast.Load())
+        return ast.copy_location(ast.IfExp(
+            test=ast.Compare(name, [ast.In()], [ctx_name]),
+            body=ast.Subscript(ctx_name, name, ast.Load()),
+            orelse=ast.Call(ast.Name('_undefined', ast.Load()), [name], []),
+        ), node)
+
+    def visit_Attribute(self, node):
+        if node.attr.startswith('_'):
+            raise self.error(f"Access to private attribute {node.attr!r} is not allowed")
+        value = self.visit(node.value)
+        return ast.copy_location(
+            ast.Call(ast.Name('_attr', ast.Load()), [value, ast.Constant(node.attr)], []), node)
+
+    def visit_Subscript(self, node):
+        value = self.visit(node.value)
+        if isinstance(node.slice, ast.Slice):
+            node.value = value
+            node.slice = self.visit(node.slice)
+            return node
+        return ast.copy_location(
+            ast.Call(ast.Name('_item', ast.Load()), [value, self.visit(node.slice)], []), node)
+
+    def visit_BinOp(self, node):
+        if isinstance(node.op, ast.BitOr):
+            target = node.right
+            if isinstance(target, ast.Name):
+                name, args, keywords = target.id, [], []
+            elif isinstance(target, ast.Call) and isinstance(target.func, ast.Name):
+                name = target.func.id
+                args = [self.visit(arg) for arg in target.args]
+                keywords = [ast.keyword(kw.arg, self.visit(kw.value)) for kw in target.keywords]
+            else:
+                raise self.error("Expected a filter name after '|'")
+            self.uses_filters = True
+            return ast.copy_location(ast.Call(
+                ast.Name('_filter', ast.Load()),
+                [ast.Name('env', ast.Load()), ast.Constant(name), self.visit(node.left)] + args,
+                keywords,
+            ), node)
+        return self.generic_visit(node)
+
+    def visit_Call(self, node):
+        if any(isinstance(arg, ast.Starred) for arg in node.args) or any(kw.arg is None for kw in node.keywords):
+            raise self.error("Star arguments are not allowed")
+        args = [self.visit(arg) for arg in node.args]
+        keywords = [ast.keyword(kw.arg, self.visit(kw.value)) for kw in node.keywords]
+        if isinstance(node.func, ast.Name):
+            if node.func.id.startswith('_'):
+                raise self.error(f"Access to private name {node.func.id!r} is not allowed")
+            func = ast.Call(ast.Name('_callable', ast.Load()),
+                            [ast.Name('ctx', ast.Load()), ast.Name('env', ast.Load()),
+                             ast.Name('MACROS', ast.Load()), ast.Constant(node.func.id)], [])
+        else:
+            func = self.visit(node.func)
+        return ast.copy_location(ast.Call(func, args, keywords), node)
+
+
+def compile_expression(text: str, template_name: str, lineno: int) -> Tuple[str, bool]:
+    """Python source for a template expression, and whether it applies filters."""
+    source = _rewrite_source(text.strip())
+    try:
+        tree = ast.parse(source, mode='eval')
+    except SyntaxError as e:
+        raise TemplateSyntaxError(f"Invalid expression {text.strip()!r}: {e.msg}", template_name, lineno) from None
+    compiler = _ExpressionCompiler(template_name, lineno)
+    tree = ast.fix_missing_locations(compiler.visit(tree))
+    return ast.unparse(tree), compiler.uses_filters
+
+
+def compile_arguments(text: str, template_name: str, lineno: int) -> Tuple[str, str]:
+    """Python source for positional and keyword arguments of a call, as a tuple and a dict."""
+    if not text.strip():
+        return "()", "{}"
+    try:
+        call = ast.parse(_rewrite_source(f"f({text.strip()})"), mode='eval').body
+    except SyntaxError as e:
+        raise TemplateSyntaxError(f"Invalid arguments {text.strip()!r}: {e.msg}", template_name, lineno) from None
+    if any(isinstance(arg, ast.Starred) for arg in call.args) or any(kw.arg is None for kw in call.keywords):
+        raise TemplateSyntaxError("Star arguments are not allowed", template_name, lineno)
+    compiler = _ExpressionCompiler(template_name, lineno)
+
+    def compile_node(node: ast.AST) -> str:
+        return ast.unparse(ast.fix_missing_locations(compiler.visit(node)))
+
+    args = ''.join(f"{compile_node(arg)}, " for arg in call.args)
+    kwargs = ', '.join(f"{kw.arg!r}: {compile_node(kw.value)}" for kw in call.keywords)
+    return f"({args})", f"{{{kwargs}}}"
+
+
+# Code generation
+
+class _CodeWriter:
+    def __init__(self):
+        self.lines: List[str] = []
+        self.linenos: List[int] = []
+        self.indent = 0
+        self.counter = 0
+        self.current_lineno = 0
+
+    def line(self, code: str, lineno: Optional[int] = None) -> None:
+        if lineno:
+            self.current_lineno = lineno
+        self.lines.append('    ' * self.indent + code)
+        self.linenos.append(self.current_lineno)
+
+    def unique(self, prefix: str) -> str:
+        self.counter += 1
+        return f"_{prefix}{self.counter}"
+
+
+class CodeGenerator:
+    """Generate the Python module for one resolved template."""
+
+    def __init__(self, name: str, autoescape: bool = True):
+        self.name = name
+        self.autoescape = [autoescape]
+        self.writer = _CodeWriter()
+        self.macros: Dict[str, str] = {}
+        self.loop_depth = 0
+        self.streaming = False
+
+    def generate(self, nodes: List[Node]) -> Tuple[str, List[int]]:
+        """
+        Emit ``render`` returning the whole page and ``stream`` yielding it in
+        pieces: after ``</head>``, around blocks, and inside long loops.
+        """
+        w = self.writer
+        w.line("def render(ctx, env):")
+        w.indent += 1
+        w.line("_out = []")
+        w.line("_w = _out.append")
+        self.body(nodes)
+        w.line("return ''.join(_out)")
+        w.indent -= 1
+
+        w.line("def stream(ctx, env):")
+        w.indent += 1
+        w.line("_out = []")
+        w.line("_w = _out.append")
+        self.streaming = True
+        self.body(nodes)
+        self.streaming = False
+        w.line("if _out:")
+        w.line("    yield ''.join(_out)")
+        w.indent -= 1
+
+        for macro in self._collect_macros(nodes):
+            self.macro(macro)
+        w.line("MACROS = {" + ', '.join(f"{name!r}: {func}" for name, func in self.macros.items()) + "}")
+        return '\n'.join(w.lines) + '\n', w.linenos
+
+    def _collect_macros(self, nodes: List[Node]) -> List[Macro]:
+        found: List[Macro] = []
+
+        def visit(body: List[Node]) -> List[Node]:
+            for node in body:
+                if isinstance(node, Macro):
+                    found.append(node)
+            _walk_bodies([n for n in body if not isinstance(n, Macro)], visit)
+            return body
+
+        visit(nodes)
+        return found
+
+    def expr(self, text: str, lineno: int) -> Tuple[str, bool]:
+        return compile_expression(text, self.name, lineno)
+
+    def guarded(self, target: str, text: str, lineno: int, fallback: str = 'None') -> None:
+        """Assign an expression to ``target``, using ``fallback`` if it is undefined."""
+        w = self.writer
+        code, _ = self.expr(text, lineno)
+        w.line("try:", lineno)
+        w.line(f"    {target} = {code}")
+        w.line("except _Undefined:")
+        w.line(f"    {target} = {fallback}")
+
+    def flush_point(self, min_fragments: int = 1) -> None:
+        """In the streaming function, yield what has been written so far."""
+        if not self.streaming:
+            return
+        w = self.writer
+        w.line("if len(_out) >= %d:" % min_fragments if min_fragments > 1 else "if _out:")
+        w.line("    yield ''.join(_out)")
+        w.line("    _out.clear()")
+
+    def body(self, nodes: List[Node]) -> None:
+        w = self.writer
+        start = len(w.lines)
+        pending: List[str] = []
+
+        def flush() -> None:
+            if pending:
+                w.line(f"_w({''.join(pending)!r})")
+                pending.clear()
+
+        for node in nodes:
+            if isinstance(node, Text):
+                head_end = _HEAD_END_RE.search(node.text) if self.streaming else None
+                if head_end:
+                    pending.append(node.text[:head_end.end()])
+                    flush()
+                    self.flush_point()
+                    pending.append(node.text[head_end.end():])
+                else:
+                    pending.append(node.text)
+                continue
+            flush()
+            if isinstance(node, Macro):
+                continue
+            getattr(self, f"node_{type(node).__name__}")(node)
+        flush()
+        if len(w.lines) == start:
+            w.line("pass")
+
+    def node_Output(self, node: Output) -> None:
+        w = self.writer
+        code, uses_filters = self.expr(node.expr, node.lineno)
+        out = '_out_escaped' if self.autoescape[-1] else '_out_raw'
+        w.line("try:", node.lineno)
+        w.line(f"    _w({out}({code}))")
+        # Unknown names keep the tag as written; failing filters did the same before compilation
+        w.line(f"except {'Exception' if uses_filters else '_Undefined'}:")
+        w.line(f"    _w({node.source!r})")
+
+    def node_If(self, node: If) -> None:
+        w = self.writer
+        depth = 0
+        for index, test in enumerate(node.tests):
+            self.guarded('_c', test, node.lineno)
+            w.line("if _c:")
+            w.indent += 1
+            self.body(node.branches[index])
+            w.indent -= 1
+            if index + 1 < len(node.branches):
+                w.line("else:")
+                w.indent += 1
+                depth += 1
+        if len(node.branches) > len(node.tests):
+            self.body(node.branches[-1])
+        w.indent -= depth
+
+    def node_For(self, node: For) -> None:
+        w = self.writer
+        items, saved, loop, item = (w.unique(p) for p in ('items', 'saved', 'loop', 'item'))
+        self.guarded(items, node.iter, node.lineno, '()')
+        w.line(f"{saved} = ctx")
+        w.line("ctx = dict(ctx)")
+
+        def bind() -> None:
+            if len(node.targets) == 1:
+                w.line(f"ctx[{node.targets[0]!r}] = {item}")
+            else:
+                targets = ', '.join(f"ctx[{t!r}]" for t in node.targets)
+                w.line(f"{targets} = _unpack({item}, {len(node.targets)})")
+
+        if node.cond:
+            kept = w.unique('kept')
+            w.line(f"{kept} = []")
+            w.line(f"for {item} in {items} or ():")
+            w.indent += 1
+            bind()
+            self.guarded('_c', node.cond, node.lineno)
+            w.line("if _c:")
+            w.line(f"    {kept}.append({item})")
+            w.indent -= 1
+            w.line(f"{items} = {kept}")
+
+        w.line(f"{loop} = _Loop({items})")
+        w.line(f"ctx['loop'] = {loop}")
+        w.line(f"for {loop}.index0, {item} in enumerate({loop}.items):")
+        w.indent += 1
+        bind()
+        self.loop_depth += 1
+        self.body(node.body)
+        self.loop_depth -= 1
+        self.flush_point(STREAM_FLUSH_FRAGMENTS)
+        w.indent -= 1
+        if node.else_body:
+            w.line(f"if not {loop}.items:")
+            w.indent += 1
+            self.body(node.else_body)
+            w.indent -= 1
+        w.line(f"ctx = {saved}")
+
+    def node_While(self, node: While) -> None:
+        w = self.writer
+        saved, count = w.unique('saved'), w.unique('n')
+        w.line(f"{saved} = ctx", node.lineno)
+        w.line("ctx = dict(ctx)")
+        w.line(f"for {count} in range({WHILE_MAX_ITERATIONS}):")
+        w.indent += 1
+        self.guarded('_c', node.test, node.lineno)
+        w.line("if not _c:")
+        w.line("    break")
+        self.loop_depth += 1
+        self.body(node.body)
+        self.loop_depth -= 1
+        self.flush_point(STREAM_FLUSH_FRAGMENTS)
+        w.indent -= 1
+        w.line(f"ctx = {saved}")
+
+    def node_Set(self, node: Set) -> None:
+        self.guarded(f"ctx[{node.name!r}]", node.expr, node.lineno)
+
+    def node_Block(self, node: Block) -> None:
+        self.flush_point()
+        self.body(node.body)
+        self.flush_point()
+
+    def node_Extends(self, node: Extends) -> None:
+        pass
+
+    def node_Include(self, node: Include) -> None:
+        raise TemplateSyntaxError("Unresolved include", self.name, node.lineno)
+
+    def node_CallMacro(self, node: CallMacro) -> None:
+        w = self.writer
+        args, kwargs = compile_arguments(node.args, self.name, node.lineno)
+        w.line("try:", node.lineno)
+        w.line(f"    _w(_call_macro(ctx, env, MACROS, {node.name!r}, {args}, {kwargs}))")
+        w.line("except _Undefined:")
+        w.line(f"    _w({node.source!r})")
+
+    def node_With(self, node: With) -> None:
+        w = self.writer
+        saved = w.unique('saved')
+        values = {}
+        if node.assignments:
+            _, kwargs = compile_arguments(node.assignments, self.name, node.lineno)
+            values = kwargs
+        w.line(f"{saved} = ctx", node.lineno)
+        w.line(f"ctx = dict(ctx)")
+        if values:
+            temp = w.unique('with')
+            w.line("try:")
+            w.line(f"    {temp} = {values}")
+            w.line("except _Undefined:")
+            w.line(f"    {temp} = {{}}")
+            w.line(f"ctx.update({temp})")
+        w.line("try:")
+        w.indent += 1
+        self.body(node.body)
+        w.indent -= 1
+        w.line("finally:")
+        w.line(f"    ctx = {saved}")
+
+    def node_Spaceless(self, node: Spaceless) -> None:
+        w = self.writer
+        buf, saved = w.unique('buf'), w.unique('w')
+        w.line(f"{buf} = []", node.lineno)
+        w.line(f"{saved} = _w")
+        w.line(f"_w = {buf}.append")
+        w.line("try:")
+        w.indent += 1
+        self.body(node.body)
+        w.indent -= 1
+        w.line("finally:")
+        w.line(f"    _w = {saved}")
+        w.line(f"    _w(_spaceless(''.join({buf})))")
+
+    def node_Autoescape(self, node: Autoescape) -> None:
+        self.autoescape.append(node.enabled)
+        self.body(node.body)
+        self.autoescape.pop()
+
+    def node_LoopControl(self, node: LoopControl) -> None:
+        if not self.loop_depth:
+            raise TemplateSyntaxError(f"{node.keyword} outside of a loop", self.name, node.lineno)
+        self.writer.line(node.keyword, node.lineno)
+
+    def node_CustomTag(self, node: CustomTag) -> None:
+        self.writer.line(f"_w(_custom_tag(ctx, env, {node.name!r}, {node.args!r}, {node.source!r}))", node.lineno)
+
+    def macro(self, node: Macro) -> None:
+        w = self.writer
+        func = f"_macro_{node.name}"
+        self.macros[node.name] = func
+        w.line(f"def {func}(ctx, env, args, kwargs):", node.lineno)
+        w.indent += 1
+        w.line("ctx = dict(ctx)")
+        w.line(f"_bind_macro(ctx, {node.name!r}, {node.params!r}, {node.defaults!r}, args, kwargs)")
+        w.line("_out = []")
+        w.line("_w = _out.append")
+        loop_depth, self.loop_depth = self.loop_depth, 0
+        streaming, self.streaming = self.streaming, False
+        self.body(node.body)
+        self.loop_depth, self.streaming = loop_depth, streaming
+        w.line("return _Markup(''.join(_out))")
+        w.indent -= 1
+
+
+# Compiled templates
+
+class CompiledTemplate:
+    """A template compiled to a Python function, plus the files it depends on."""
+
+    def __init__(self, name: str, code: Any, dependencies: Dict[str, Optional[int]], linenos: List[int]):
+        self.name = name
+        self.code = code
+        self.dependencies = dependencies
+        self.linenos = linenos
+        namespace = dict(RUNTIME)
+        exec(code, namespace)
+        self._render = namespace['render']
+        self._stream = namespace['stream']
+
+    def render(self, context: Dict[str, Any], env: Any) -> str:
+        try:
+            return self._render(dict(context), env)
+        except TemplateError:
+            raise
+        except Exception as e:
+            raise TemplateRuntimeError(f"{type(e).__name__}: {e}", self.name, self._template_line(e)) from e
+
+    def generate(self, context: Dict[str, Any], env: Any) -> Iterator[str]:
+        """Render lazily, yielding the page in the pieces ``stream`` flushes."""
+        try:
+            yield from self._stream(dict(context), env)
+        except TemplateError:
+            raise
+        except Exception as e:
+            raise TemplateRuntimeError(f"{type(e).__name__}: {e}", self.name, self._template_line(e)) from e
+
+    def _template_line(self, error: Exception) -> Optional[int]:
+        lineno = None
+        tb = error.__traceback__
+        while tb is not None:
+            if tb.tb_frame.f_code.co_filename == self.code.co_filename:
+                lineno = tb.tb_lineno
+            tb = tb.tb_next
+        if lineno is None or lineno > len(self.linenos):
+            return None
+        return self.linenos[lineno - 1] or None
+
+    def is_stale(self) -> bool:
+        """True if any source file changed, appeared or vanished since compilation."""
+        for path, mtime in self.dependencies.items():
+            try:
+                current = os.stat(path).st_mtime_ns
+            except OSError:
+                current = None
+            if current != mtime:
+                return True
+        return False
+
+    def dump(self, path: Path) -> None:
+        """Persist to ``path`` atomically."""
+        payload = marshal.dumps((COMPILER_VERSION, self.name, self.dependencies, self.linenos, self.code))
+        tmp = path.with_name(f"{path.name}.{os.getpid()}.tmp")
+        with open(tmp, 'wb') as f:
+            f.write(importlib.util.MAGIC_NUMBER)
+            f.write(payload)
+        os.replace(tmp, path)
+
+    @classmethod
+    def load(cls, path: Path) -> Optional['CompiledTemplate']:
+        """Load a persisted template, or None if missing, from another Python or compiler version."""
+        try:
+            with open(path, 'rb') as f:
+                magic = f.read(len(importlib.util.MAGIC_NUMBER))
+                if magic != importlib.util.MAGIC_NUMBER:
+                    return None
+                version, name, dependencies, linenos, code = marshal.loads(f.read())
+        except (OSError, ValueError, EOFError, TypeError):
+            return None
+        if version != COMPILER_VERSION:
+            return None
+        return cls(name, code, dependencies, linenos)
+
+
+class TemplateCompiler:
+    """
+    Parse, resolve and compile templates.
+
+    Args:
+        trim_blocks: Drop the first newline after a ``{% %}`` tag
+        lstrip_blocks: Drop whitespace before a ``{% %}`` tag that starts its line
+        autoescape: HTML-escape ``{{ }}`` output by default
+    """
+
+    def __init__(self, trim_blocks: bool = True, lstrip_blocks: bool = True, autoescape: bool = True):
+        self.trim_blocks = trim_blocks
+        self.lstrip_blocks = lstrip_blocks
+        self.autoescape = autoescape
+
+    def compile_file(self, path: Path, name: Optional[str] = None) -> CompiledTemplate:
+        dependencies: Dict[str, Optional[int]] = {}
+        nodes = self._load(Path(path), dependencies, ())
+        return self._generate(nodes, name or str(path), dependencies)
+
+    def compile_string(self, source: str, base_dir: Path, name: str = '<string>') -> CompiledTemplate:
+        dependencies: Dict[str, Optional[int]] = {}
+        nodes = self._resolve(self._parse(source, name, Path(base_dir)), Path(base_dir), dependencies, (name,))
+        return self._generate(nodes, name, dependencies)
+
+    def _generate(self, nodes: List[Node], name: str, dependencies: Dict[str, Optional[int]]) -> CompiledTemplate:
+        source, linenos = CodeGenerator(name, self.autoescape).generate(nodes)
+        code = compile(source, f"<lean:{name}>", 'exec')
+        return CompiledTemplate(name, code, dependencies, linenos)
+
+    def _parse(self, source: str, name: str, base_dir: Path) -> List[Node]:
+        tokens = tokenize_template(source, name, self.trim_blocks, self.lstrip_blocks)
+        return Parser(tokens, name, base_dir).parse()
+
+    def _load(self, path: Path, dependencies: Dict[str, Optional[int]], stack: Tuple[str, ...]) -> List[Node]:
+        key = str(path)
+        if key in stack:
+            raise TemplateSyntaxError(f"Recursive extends or include of {path.name}", stack[-1])
+        dependencies[key] = os.stat(path).st_mtime_ns
+        with open(path, 'r', encoding='utf-8') as f:
+            source = f.read()
+        return self._resolve(self._parse(source, key, path.parent), path.parent, dependencies, stack + (key,))
+
+    def _resolve(self, nodes: List[Node], base_dir: Path, dependencies: Dict[str, Optional[int]],
+                 stack: Tuple[str, ...]) -> List[Node]:
+        """Inline includes and apply inheritance."""
+        def inline(body: List[Node]) -> List[Node]:
+            result: List[Node] = []
+            for node in body:
+                if isinstance(node, Include):
+                    path = node.base_dir / node.template
+                    if path.exists():
+                        result.extend(self._load(path, dependencies, stack))
+                    else:
+                        dependencies[str(path)] = None
+                        result.append(Text(node.lineno, text=f"<!-- Include not found: {node.template} -->"))
+                else:
+                    result.append(node)
+            return _walk_bodies(result, inline)
+
+        nodes = inline(nodes)
+        extends = next((node for node in nodes if isinstance(node, Extends)), None)
+        if extends is None:
+            return nodes
+
+        parent_path = base_dir / extends.template
+        if not parent_path.exists():
+            # Missing layout: render the child as it stands, as before
+            dependencies[str(parent_path)] = None
+            return [node for node in nodes if not isinstance(node, Extends)]
+
+        overrides: Dict[str, List[Node]] = {}
+
+        def collect(body: List[Node]) -> List[Node]:
+            for node in body:
+                if isinstance(node, Block) and node.name not in overrides:
+                    overrides[node.name] = node.body
+            return _walk_bodies(body, collect)
+
+        collect(nodes)
+        parent = self._load(parent_path, dependencies, stack)
+
+        def apply(body: List[Node]) -> List[Node]:
+            for node in body:
+                if isinstance(node, Block) and node.name in overrides:
+                    node.body = overrides[node.name]
+            return _walk_bodies(body, apply)
+
+        # The child's top-level set and macro definitions stay visible to the layout
+        preamble = [node for node in nodes if isinstance(node, (Set, Macro))]
+        return preamble + apply(parent)
+
+
+__all__ = ['COMPILER_VERSION', 'STREAM_FLUSH_FRAGMENTS', 'WHILE_MAX_ITERATIONS', 'CompiledTemplate', 'LoopContext', 'Markup', 'TemplateCompiler',
+           'TemplateError', 'TemplateRuntimeError', 'TemplateSyntaxError', 'Undefined',
+           'compile_expression', 'escape', 'safe_format', 'tokenize_template']
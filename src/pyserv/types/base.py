@@ -115,6 +115,7 @@ class RouteConfig:
     middleware: List[Callable] = field(default_factory=list)
     cache_timeout: Optional[int] = None
     priority: int = 0
+    max_body_size: Optional[int] = None  # overrides Request.max_body_size when set
 
 # ===== Widget Types =====
 
@@ -7,24 +7,25 @@ and to eliminate code duplication. This module provides convenient access to all
 utility classes and functions.
 """
 
-# Core utilities are available through individual modules
-# Import utilities from submodules to avoid circular imports
+# Utilities load from their submodules on first access so importing pyserv.utils stays cheap
+from .lazy import attach
 
-# Import advanced utilities
-from .mathematical_operations import MathematicalOperations
-from .advanced_functions import (
-    FunctionUtils, AsyncUtils, DataUtils, ValidationUtils,
-    PerformanceUtils, ThreadingUtils, LoggingUtils,
-    function_utils, async_utils, data_utils, validation_utils,
-    performance_utils, threading_utils, logging_utils
-)
-from .locale_support import (
-    LocaleManager, TranslationManager, LocalizedFormatter,
-    get_locale_manager, get_translation_manager, get_localized_formatter,
-    set_locale, get_locale, _, ngettext,
-    format_date, format_datetime, format_number, format_currency, format_percent,
-    format_address, format_measurement, format_list
-)
+__getattr__, __dir__ = attach(__name__, {
+    ".mathematical_operations": ["MathematicalOperations"],
+    ".advanced_functions": [
+        "FunctionUtils", "AsyncUtils", "DataUtils", "ValidationUtils",
+        "PerformanceUtils", "ThreadingUtils", "LoggingUtils",
+        "function_utils", "async_utils", "data_utils", "validation_utils",
+        "performance_utils", "threading_utils", "logging_utils",
+    ],
+    ".locale_support": [
+        "LocaleManager", "TranslationManager", "LocalizedFormatter",
+        "get_locale_manager", "get_translation_manager", "get_localized_formatter",
+        "set_locale", "get_locale", "_", "ngettext",
+        "format_date", "format_datetime", "format_number", "format_currency", "format_percent",
+        "format_address", "format_measurement", "format_list",
+    ],
+})
 
 __all__ = [
     # Core utilities (from pyserv.core.utilities)
@@ -22,7 +22,7 @@ from contextlib import asynccontextmanager
 from dataclasses import dataclass, field
 from enum import Enum
 from functools import wraps
-from typing import Any, Callable, Dict, List, Optional, Set, Type, Union
+from typing import Any, Callable, Dict, List, Optional, Set, Type, Union, get_type_hints
 
 from pyserv.exceptions import DependencyInjectionException
 
@@ -68,6 +68,12 @@ class ServiceScope:
         self.services[service_type] = instance
 
 
+# A resolution plan builds (or returns) one service given the scope it is resolved in
+Plan = Callable[[ServiceScope], Any]
+
+_MISSING = object()
+
+
 class Container:
     """
     Advanced dependency injection container with full production features.
@@ -80,13 +86,22 @@ class Container:
     - Async support for service initialization
     - Service decorators and metadata
     - Thread-safe operations
+
+    Constructor signatures are inspected once per service type: the first ``get``
+    compiles a resolution plan (a closure over the constructor and the plans of its
+    dependencies) and later resolutions just call it. Any registration drops the
+    compiled plans, since a plan embeds the plans of everything it depends on.
     """
 
+    scope_pool_size = 256
+
     def __init__(self) -> None:
         self._services: Dict[Type[Any], ServiceDescriptor] = {}
         self._singletons: Dict[Type[Any], Any] = {}
-        self._scoped_services: Dict[str, Dict[Type[Any], Any]] = {}
-        self._resolving: Set[Type[Any]] = set()
+        self._scoped_services: Dict[str, ServiceScope] = {}
+        self._plans: Dict[Type[Any], Plan] = {}
+        self._compiling: Set[Type[Any]] = set()
+        self._scope_pool: List[ServiceScope] = []
         self._lock = threading.RLock()
         self._performance_stats: Dict[str, float] = {}
         self._root_scope = ServiceScope("root")
@@ -103,6 +118,9 @@ class Container:
         """
         Register a service in the container.
 
+        Re-registering a type replaces its descriptor, discards a singleton already
+        built from the old one and invalidates every compiled plan.
+
         Args:
             service_type: The service interface/type
             implementation_type: The concrete implementation class
@@ -125,6 +143,8 @@ class Container:
 
         with self._lock:
             self._services[service_type] = descriptor
+            self._singletons.pop(service_type, None)
+            self._plans.clear()
 
     def register_singleton(
         self,
@@ -170,95 +190,141 @@ class Container:
 
     def get(self, service_type: Type[Any], scope_id: str = "root") -> Any:
         """Resolve a service from the container."""
-        start_time = time.time()
-
-        try:
-            with self._lock:
-                # Check for circular dependencies
-                if service_type in self._resolving:
-                    raise DependencyInjectionException(f"Circular dependency detected for {service_type}")
-                self._resolving.add(service_type)
-
-            # Check singleton cache first
-            if service_type in self._singletons:
-                return self._singletons[service_type]
+        plan = self._plans.get(service_type)
+        if plan is None:
+            plan = self._compile(service_type)
+        scope = self._scoped_services.get(scope_id)
+        if scope is None:
+            scope = self._get_or_create_scope(scope_id)
+        return plan(scope)
+
+    def resolve(self, service_type: Type[Any], scope: Optional[ServiceScope] = None) -> Any:
+        """Resolve a service within ``scope`` (a scope from ``create_scope``), or the root scope."""
+        plan = self._plans.get(service_type)
+        if plan is None:
+            plan = self._compile(service_type)
+        return plan(scope if scope is not None else self._get_or_create_scope("root"))
+
+    def _compile(self, service_type: Type[Any]) -> Plan:
+        """Build and cache the resolution plan for a registered service."""
+        with self._lock:
+            plan = self._plans.get(service_type)
+            if plan is not None:
+                return plan
 
-            # Get service descriptor
             descriptor = self._services.get(service_type)
             if not descriptor:
-                raise DependencyInjectionException(f"Service {service_type} not registered")
-
-            # Handle different lifetimes
-            if descriptor.lifetime == ServiceLifetime.SINGLETON:
-                if service_type not in self._singletons:
-                    instance = self._create_instance(descriptor)
-                    self._singletons[service_type] = instance
-                return self._singletons[service_type]
-
-            elif descriptor.lifetime == ServiceLifetime.SCOPED:
-                scope = self._get_or_create_scope(scope_id)
-                if service_type not in scope.services:
-                    instance = self._create_instance(descriptor)
-                    scope.services[service_type] = instance
-                return scope.services[service_type]
-
-            else:  # TRANSIENT
-                return self._create_instance(descriptor)
-
-        finally:
-            with self._lock:
-                self._resolving.discard(service_type)
-
-            # Track performance
-            elapsed = time.time() - start_time
-            self._performance_stats[f"resolve_{service_type.__name__}"] = elapsed
-
-    def _create_instance(self, descriptor: ServiceDescriptor) -> Any:
-        """Create a service instance."""
+                raise DependencyInjectionException(_service_name(service_type), "Service not registered")
+            if service_type in self._compiling:
+                raise DependencyInjectionException(_service_name(service_type), "Circular dependency detected")
+
+            start_time = time.perf_counter()
+            self._compiling.add(service_type)
+            try:
+                plan = self._lifetime_plan(service_type, descriptor, self._build_plan(descriptor))
+            finally:
+                self._compiling.discard(service_type)
+
+            self._plans[service_type] = plan
+            self._performance_stats[f"compile_{_service_name(service_type)}"] = time.perf_counter() - start_time
+            return plan
+
+    def _build_plan(self, descriptor: ServiceDescriptor) -> Plan:
+        """Plan that creates a new instance of a service, ignoring its lifetime."""
         if descriptor.instance is not None:
-            return descriptor.instance
+            instance = descriptor.instance
+            return lambda scope: instance
         if descriptor.factory is not None:
-            return descriptor.factory()
+            factory = descriptor.factory
+            return lambda scope: factory()
         if descriptor.implementation_type is not None:
-            return self._instantiate(descriptor.implementation_type)
-        raise DependencyInjectionException(f"No way to create instance for {descriptor.service_type}")
+            return self._constructor_plan(descriptor.implementation_type)
+        raise DependencyInjectionException(_service_name(descriptor.service_type), "No way to create instance")
 
-    def _instantiate(self, cls: Type[Any]) -> Any:
-        """Instantiate a class with dependency injection."""
-        # Get constructor parameters
-        init_signature = inspect.signature(cls.__init__)
-        params: Dict[str, Any] = {}
+    def _constructor_plan(self, cls: Type[Any]) -> Plan:
+        """Plan that calls ``cls`` with its constructor dependencies resolved."""
+        static: Dict[str, Any] = {}
+        dynamic: List[tuple] = []
 
-        for param_name, param in init_signature.parameters.items():
-            if param_name == "self":
-                continue
-
-            # Try to resolve parameter from container
-            if param.annotation != inspect.Parameter.empty:
+        for name, param, annotation in _constructor_parameters(cls):
+            if annotation is not inspect.Parameter.empty:
                 try:
-                    params[param_name] = self.get(param.annotation)
+                    dynamic.append((name, self._compile(annotation)))
+                    continue
                 except DependencyInjectionException:
-                    # If resolution fails, use default or skip
-                    if param.default != inspect.Parameter.empty:
-                        params[param_name] = param.default
-                    else:
+                    # Unresolvable dependencies fall back to the parameter default
+                    if param.default is inspect.Parameter.empty:
                         raise
-            elif param.default != inspect.Parameter.empty:
-                params[param_name] = param.default
-            else:
-                raise DependencyInjectionException(f"Cannot resolve parameter {param_name} for {cls}")
-
-        return cls(**params)
+            elif param.default is inspect.Parameter.empty:
+                raise DependencyInjectionException(_service_name(cls), f"Cannot resolve parameter {name}")
+            static[name] = param.default
+
+        if not dynamic:
+            if not static:
+                return lambda scope: cls()
+            return lambda scope: cls(**static)
+        if len(dynamic) == 1 and not static:
+            (name, dependency), = dynamic
+            return lambda scope: cls(**{name: dependency(scope)})
+
+        def construct(scope: ServiceScope) -> Any:
+            kwargs = dict(static)
+            for name, dependency in dynamic:
+                kwargs[name] = dependency(scope)
+            return cls(**kwargs)
+        return construct
+
+    def _lifetime_plan(self, service_type: Type[Any], descriptor: ServiceDescriptor, build: Plan) -> Plan:
+        """Wrap a build plan with the caching its lifetime calls for."""
+        if descriptor.lifetime == ServiceLifetime.SINGLETON:
+            singletons = self._singletons
+            lock = self._lock
+
+            def singleton(scope: ServiceScope) -> Any:
+                instance = singletons.get(service_type, _MISSING)
+                if instance is _MISSING:
+                    with lock:
+                        instance = singletons.get(service_type, _MISSING)
+                        if instance is _MISSING:
+                            # Singletons never capture a request scope
+                            instance = singletons[service_type] = build(self._get_or_create_scope("root"))
+                return instance
+            return singleton
+
+        if descriptor.lifetime == ServiceLifetime.SCOPED:
+            def scoped(scope: ServiceScope) -> Any:
+                services = scope.services
+                instance = services.get(service_type, _MISSING)
+                if instance is _MISSING:
+                    instance = services[service_type] = build(scope)
+                return instance
+            return scoped
+
+        return build
 
     def _get_or_create_scope(self, scope_id: str) -> ServiceScope:
-        """Get or create a service scope."""
-        if scope_id not in self._scoped_services:
-            self._scoped_services[scope_id] = ServiceScope(scope_id, parent=self._root_scope)
-        return self._scoped_services[scope_id]
+        """Get a service scope, taking a recycled one from the pool if it does not exist yet."""
+        scope = self._scoped_services.get(scope_id)
+        if scope is not None:
+            return scope
+        with self._lock:
+            scope = self._scoped_services.get(scope_id)
+            if scope is None:
+                if self._scope_pool:
+                    scope = self._scope_pool.pop()
+                    scope.scope_id = scope_id
+                else:
+                    scope = ServiceScope(scope_id, parent=self._root_scope)
+                self._scoped_services[scope_id] = scope
+            return scope
 
     def create_scope(self, scope_id: str) -> ServiceScope:
-        """Create a new service scope."""
-        return ServiceScope(scope_id, parent=self._root_scope)
+        """
+        Open a service scope; ``get(..., scope_id)`` and ``resolve(..., scope)`` resolve into it.
+
+        The scope is returned to a pool by ``clear_scope``, so it must not be used afterwards.
+        """
+        return self._get_or_create_scope(scope_id)
 
     def has(self, service_type: Type[Any]) -> bool:
         """Check if a service type is registered."""
@@ -278,15 +344,20 @@ class Container:
             self._services.clear()
             self._singletons.clear()
             self._scoped_services.clear()
-            self._resolving.clear()
+            self._plans.clear()
+            self._compiling.clear()
 
     def clear_scope(self, scope_id: str) -> None:
-        """Clear a specific scope."""
-        if scope_id in self._scoped_services:
-            del self._scoped_services[scope_id]
+        """Close a scope, dropping its instances and recycling it for a later scope."""
+        with self._lock:
+            scope = self._scoped_services.pop(scope_id, None)
+            if scope is not None:
+                scope.services.clear()
+                if len(self._scope_pool) < self.scope_pool_size:
+                    self._scope_pool.append(scope)
 
     def get_performance_stats(self) -> Dict[str, float]:
-        """Get performance statistics."""
+        """Get performance statistics (seconds spent compiling each service's plan)."""
         return self._performance_stats.copy()
 
     async def initialize_async_services(self) -> None:
@@ -311,6 +382,36 @@ class Container:
             raise
 
 
+def _service_name(service_type: Any) -> str:
+    return getattr(service_type, '__name__', str(service_type))
+
+
+def _constructor_parameters(cls: Type[Any]) -> List[tuple]:
+    """``(name, parameter, annotation)`` for each injectable constructor argument."""
+    init = cls.__init__
+    if init is object.__init__:
+        return []
+    signature = inspect.signature(init)
+
+    hints: Dict[str, Any] = {}
+    if any(isinstance(param.annotation, str) for param in signature.parameters.values()):
+        try:
+            # Evaluates string annotations (``from __future__ import annotations``)
+            hints = get_type_hints(init)
+        except Exception:
+            pass
+
+    parameters = []
+    for name, param in signature.parameters.items():
+        if name == "self" or param.kind in (inspect.Parameter.VAR_POSITIONAL, inspect.Parameter.VAR_KEYWORD):
+            continue
+        annotation = param.annotation
+        if isinstance(annotation, str):
+            annotation = hints.get(name, annotation)
+        parameters.append((name, param, annotation))
+    return parameters
+
+
 # Global container instance
 container = Container()
 
@@ -319,27 +420,26 @@ def inject(func: Callable[..., Any]) -> Callable[..., Any]:
     """Decorator to inject dependencies into functions."""
     sig = inspect.signature(func)
     is_async = inspect.iscoroutinefunction(func)
+    injectable = [(name, param.annotation) for name, param in sig.parameters.items()
+                  if param.annotation is not inspect.Parameter.empty]
 
-    @wraps(func)
-    def sync_wrapper(*args: Any, **kwargs: Any) -> Any:
+    def resolve_into(kwargs: Dict[str, Any]) -> None:
         # Inject dependencies for parameters not already provided
-        for param_name, param in sig.parameters.items():
-            if param_name not in kwargs and param.annotation != inspect.Parameter.empty:
+        for param_name, annotation in injectable:
+            if param_name not in kwargs and container.has(annotation):
                 try:
-                    kwargs[param_name] = container.get(param.annotation)
+                    kwargs[param_name] = container.get(annotation)
                 except DependencyInjectionException:
                     pass  # Skip if dependency cannot be resolved
+
+    @wraps(func)
+    def sync_wrapper(*args: Any, **kwargs: Any) -> Any:
+        resolve_into(kwargs)
         return func(*args, **kwargs)
 
     @wraps(func)
     async def async_wrapper(*args: Any, **kwargs: Any) -> Any:
-        # Inject dependencies for parameters not already provided
-        for param_name, param in sig.parameters.items():
-            if param_name not in kwargs and param.annotation != inspect.Parameter.empty:
-                try:
-                    kwargs[param_name] = container.get(param.annotation)
-                except DependencyInjectionException:
-                    pass  # Skip if dependency cannot be resolved
+        resolve_into(kwargs)
         return await func(*args, **kwargs)
 
     return async_wrapper if is_async else sync_wrapper
@@ -398,14 +498,14 @@ def get_service_health() -> Dict[str, Any]:
 
     for service_type, descriptor in container.get_all_services().items():
         service_info = {
-            "type": service_type.__name__,
+            "type": _service_name(service_type),
             "lifetime": descriptor.lifetime.value,
             "implementation": descriptor.implementation_type.__name__ if descriptor.implementation_type else None,
             "has_factory": descriptor.factory is not None,
             "has_instance": descriptor.instance is not None,
             "metadata": descriptor.metadata
         }
-        health_info["services"][service_type.__name__] = service_info
+        health_info["services"][_service_name(service_type)] = service_info
 
     return health_info
 
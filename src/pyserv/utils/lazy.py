@@ -0,0 +1,70 @@
+"""
+Lazy package exports for Pyserv framework
+Implements PEP 562 module ``__getattr__`` so a package can advertise its public
+names without importing the submodules that define them until first use
+"""
+
+# Imported by ``pyserv/__init__`` itself, so it avoids even ``typing`` at runtime
+from __future__ import annotations
+
+import importlib
+import sys
+
+TYPE_CHECKING = False
+if TYPE_CHECKING:
+    from typing import Any, Callable, Dict, Iterable, List, Optional, Tuple
+
+
+def attach(package: str, exports: Dict[str, Iterable[str]], submodules: Iterable[str] = (),
+           aliases: Optional[Dict[str, str]] = None) -> Tuple[Callable[[str], Any], Callable[[], List[str]]]:
+    """
+    Build the module-level ``__getattr__`` and ``__dir__`` for a lazily loaded package.
+
+    Resolved values are stored in the package namespace, so only the first access
+    of each name goes through ``__getattr__``; later lookups are plain attribute reads.
+
+    Args:
+        package: The package ``__name__``
+        exports: Submodule path (relative to the package, e.g. ``".encryption"``, or absolute)
+            mapped to the names it provides
+        submodules: Child modules exposed as attributes, imported when first touched
+        aliases: Extra public names mapped to ``"module:name"``, e.g. ``{"Pyserv": ".application:Application"}``
+
+    Returns:
+        ``(__getattr__, __dir__)`` to assign at package level
+
+    Example:
+        __getattr__, __dir__ = attach(__name__, {".llm_engine": ["LLMEngine"]})
+    """
+    origins = {name: (module, name) for module, names in exports.items() for name in names}
+    children = set(submodules)
+    for alias, target in (aliases or {}).items():
+        module, _, name = target.partition(":")
+        origins[alias] = (module, name)
+    namespace = sys.modules[package].__dict__
+
+    def __getattr__(name: str) -> Any:
+        origin = origins.get(name)
+        if origin is not None:
+            module, attribute = origin
+            value = getattr(importlib.import_module(module, package), attribute)
+        elif name in children:
+            value = importlib.import_module(f"{package}.{name}")
+        else:
+            raise AttributeError(f"module {package!r} has no attribute {name!r}")
+        namespace[name] = value
+        return value
+
+    def __dir__() -> List[str]:
+        return sorted(set(namespace) | set(origins) | children)
+
+    return __getattr__, __dir__
+
+
+def loaded(package: str) -> List[str]:
+    """Submodules of ``package`` that have been imported so far"""
+    prefix = f"{package}."
+    return sorted(name for name in sys.modules if name.startswith(prefix))
+
+
+__all__ = ['attach', 'loaded']
@@ -1,23 +1,56 @@
 """
 Background processing and queue system for Pyserv  framework.
 Provides job queues, workers, cron scheduling, and task management.
+
+Workers are asyncio-native and notification-driven: an idle worker waits on
+its backend (a wake-up from ``enqueue`` in memory, a blocking stream read in
+Redis, ``LISTEN/NOTIFY`` in PostgreSQL) instead of sleeping, dequeues jobs
+in batches into a local deque, and steals from sibling workers' deques when
+its own runs dry.
 """
 
 import asyncio
+import bisect
+import heapq
+import importlib
+import inspect
+import itertools
+import json
+import logging
+import math
+import os
+import random
+import socket
 import threading
 import time
 import uuid
-import json
-import pickle
-from typing import Dict, List, Any, Optional, Callable, Union, Type
+from collections import deque
+from concurrent.futures import ThreadPoolExecutor
 from datetime import datetime, timedelta
-from functools import wraps
-from concurrent.futures import ThreadPoolExecutor, ProcessPoolExecutor
-import heapq
-import logging
+from functools import partial, wraps
+from typing import Any, Callable, Deque, Dict, List, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+# Upper bounds (seconds) of the queue wait and run time histogram buckets
+QUEUE_LATENCY_BUCKETS = (0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0,
+                         30.0, 60.0)
+
+
+def job_name(func: Callable) -> str:
+    """Dotted name a job function is stored and resolved under"""
+    return f"{func.__module__}.{func.__name__}"
 
-from pyserv.caching import get_cache_manager
-from pyserv.database import AbstractDatabaseConnection
+
+def resolve_job_function(name: str, registry: Optional[Dict[str, Callable]] = None) -> Optional[Callable]:
+    """Find a job function by registered name, then by importing its dotted name"""
+    if registry and name in registry:
+        return registry[name]
+    module_name, _, attribute = name.rpartition('.')
+    try:
+        return getattr(importlib.import_module(module_name), attribute)
+    except (ImportError, AttributeError, ValueError):
+        return None
 
 
 class Job:
@@ -37,12 +70,16 @@ class Job:
         self.priority = 0  # Higher number = higher priority
         self.queue_name = 'default'
         self.delay_until = None
+        # Wall-clock timestamps for queue latency: last enqueue, start and finish of the last run
+        self.enqueued_at: Optional[float] = None
+        self.started_at: Optional[float] = None
+        self.finished_at: Optional[float] = None
 
     def to_dict(self) -> Dict[str, Any]:
         """Convert job to dictionary for storage"""
         return {
             'id': self.id,
-            'func_name': f"{self.func.__module__}.{self.func.__name__}",
+            'func_name': job_name(self.func),
             'args': self.args,
             'kwargs': self.kwargs,
             'created_at': self.created_at.isoformat(),
@@ -53,18 +90,29 @@ class Job:
             'max_retries': self.max_retries,
             'priority': self.priority,
             'queue_name': self.queue_name,
-            'delay_until': self.delay_until.isoformat() if self.delay_until else None
+            'delay_until': self.delay_until.isoformat() if self.delay_until else None,
+            'enqueued_at': self.enqueued_at,
+            'started_at': self.started_at,
+            'finished_at': self.finished_at,
         }
 
     @classmethod
-    def from_dict(cls, data: Dict[str, Any]) -> 'Job':
-        """Create job from dictionary"""
-        # This would need to resolve the function from the name
-        # For now, return a placeholder
-        job = cls(lambda: None)
+    def from_dict(cls, data: Dict[str, Any], registry: Optional[Dict[str, Callable]] = None) -> 'Job':
+        """
+        Create job from dictionary
+
+        The function is resolved from ``func_name`` through ``registry`` or
+        by import; a job whose function cannot be found fails when run.
+        """
+        func = resolve_job_function(data['func_name'], registry) if data.get('func_name') else None
+        if func is None:
+            missing = data.get('func_name')
+
+            def func(*args, **kwargs):
+                raise LookupError(f"Job function {missing!r} is not registered or importable")
+
+        job = cls(func, *data['args'], **data['kwargs'])
         job.id = data['id']
-        job.args = data['args']
-        job.kwargs = data['kwargs']
         job.created_at = datetime.fromisoformat(data['created_at'])
         job.status = data['status']
         job.result = data['result']
@@ -74,8 +122,21 @@ class Job:
         job.priority = data['priority']
         job.queue_name = data['queue_name']
         job.delay_until = datetime.fromisoformat(data['delay_until']) if data['delay_until'] else None
+        job.enqueued_at = data.get('enqueued_at')
+        job.started_at = data.get('started_at')
+        job.finished_at = data.get('finished_at')
         return job
 
+    def to_json(self) -> str:
+        """Serialize for a remote backend"""
+        return json.dumps(self.to_dict(), default=str)
+
+    @classmethod
+    def from_json(cls, payload, registry: Optional[Dict[str, Callable]] = None) -> 'Job':
+        if isinstance(payload, bytes):
+            payload = payload.decode('utf-8')
+        return cls.from_dict(json.loads(payload), registry)
+
     def should_retry(self) -> bool:
         """Check if job should be retried"""
         return self.retries < self.max_retries
@@ -86,9 +147,28 @@ class Job:
             return datetime.now() >= self.delay_until
         return True
 
+    def run_at(self) -> float:
+        """Wall-clock time the job becomes runnable"""
+        return self.delay_until.timestamp() if self.delay_until else 0.0
+
 
 class QueueBackend:
-    """Base queue backend"""
+    """
+    Base queue backend
+
+    Subclasses implement the synchronous primitives; the async methods used
+    by workers default to them, with ``fetch`` polling under exponential
+    backoff. Backends with a native wait (notification, blocking read)
+    override the async methods instead.
+    """
+
+    # Job functions by name, shared with the owning QueueManager
+    registry: Optional[Dict[str, Callable]] = None
+
+    @property
+    def async_only(self) -> bool:
+        """Whether only the async API reaches the real store"""
+        return False
 
     def enqueue(self, job: Job) -> bool:
         """Add job to queue"""
@@ -98,6 +178,16 @@ class QueueBackend:
         """Get next job from queue"""
         raise NotImplementedError
 
+    def dequeue_batch(self, queue_name: str = 'default', max_jobs: int = 1) -> List[Job]:
+        """Get up to ``max_jobs`` ready jobs"""
+        jobs = []
+        while len(jobs) < max_jobs:
+            job = self.dequeue(queue_name)
+            if job is None:
+                break
+            jobs.append(job)
+        return jobs
+
     def get_job(self, job_id: str) -> Optional[Job]:
         """Get job by ID"""
         raise NotImplementedError
@@ -110,50 +200,96 @@ class QueueBackend:
         """Get queue size"""
         raise NotImplementedError
 
+    async def push(self, job: Job) -> bool:
+        """Add job to queue"""
+        return self.enqueue(job)
+
+    async def fetch(self, queue_name: str = 'default', max_jobs: int = 1,
+                    timeout: Optional[float] = 1.0) -> List[Job]:
+        """
+        Take up to ``max_jobs`` ready jobs, waiting up to ``timeout`` seconds
+        for the first one. May return early and empty; callers loop.
+        """
+        jobs = self.dequeue_batch(queue_name, max_jobs)
+        if jobs or not timeout:
+            return jobs
+        loop = asyncio.get_running_loop()
+        deadline = loop.time() + timeout
+        delay = 0.005
+        while not jobs and loop.time() < deadline:
+            await asyncio.sleep(min(delay, max(deadline - loop.time(), 0)))
+            delay = min(delay * 2, 0.5)
+            jobs = self.dequeue_batch(queue_name, max_jobs)
+        return jobs
+
+    async def complete(self, job: Job) -> bool:
+        """Record a finished job (completed or finally failed) in one write"""
+        return self.update_job(job)
+
+    async def retry(self, job: Job) -> bool:
+        """Put a failed job back for another attempt"""
+        return await self.push(job)
+
+    async def release(self, jobs: List[Job]) -> None:
+        """Return fetched but unstarted jobs to the queue"""
+        for job in jobs:
+            job.status = 'pending'
+            await self.push(job)
+
+    async def load(self, job_id: str) -> Optional[Job]:
+        """Get job by ID"""
+        return self.get_job(job_id)
+
+    async def size(self, queue_name: str = 'default') -> int:
+        """Get queue size"""
+        return self.get_queue_size(queue_name)
+
+    def wake(self, queue_name: str = 'default') -> None:
+        """Cut short any ``fetch`` waiting on ``queue_name`` (used on shutdown)"""
+
+    async def close(self) -> None:
+        """Release connections held by the backend"""
+
 
 class MemoryQueueBackend(QueueBackend):
-    """In-memory queue backend"""
+    """
+    In-memory queue backend
+
+    Ready jobs sit in a priority heap per queue and delayed jobs in a heap
+    by run time; ``enqueue`` wakes one waiting ``fetch`` from any thread or
+    event loop, so an idle worker starts a job as soon as it is enqueued.
+    """
 
     def __init__(self):
-        self.queues: Dict[str, List[Job]] = {}
+        self.queues: Dict[str, List[Tuple[int, int, Job]]] = {}
+        self.delayed: Dict[str, List[Tuple[float, int, Job]]] = {}
         self.jobs: Dict[str, Job] = {}
         self.lock = threading.Lock()
+        self._sequence = itertools.count()
+        self._waiters: Dict[str, Deque[Tuple[asyncio.AbstractEventLoop, asyncio.Future]]] = {}
 
     def enqueue(self, job: Job) -> bool:
         """Add job to queue"""
+        job.enqueued_at = time.time()
         with self.lock:
-            if job.queue_name not in self.queues:
-                self.queues[job.queue_name] = []
-
-            # Insert job in priority order (higher priority first)
-            queue = self.queues[job.queue_name]
-            inserted = False
-            for i, existing_job in enumerate(queue):
-                if job.priority > existing_job.priority:
-                    queue.insert(i, job)
-                    inserted = True
-                    break
-
-            if not inserted:
-                queue.append(job)
-
+            run_at = job.run_at()
+            if run_at > job.enqueued_at:
+                heapq.heappush(self.delayed.setdefault(job.queue_name, []), (run_at, next(self._sequence), job))
+            else:
+                heapq.heappush(self.queues.setdefault(job.queue_name, []), (-job.priority, next(self._sequence), job))
             self.jobs[job.id] = job
+            self._notify(job.queue_name)
             return True
 
     def dequeue(self, queue_name: str = 'default') -> Optional[Job]:
         """Get next job from queue"""
-        with self.lock:
-            if queue_name not in self.queues:
-                return None
-
-            queue = self.queues[queue_name]
-            for i, job in enumerate(queue):
-                if job.is_ready():
-                    queue.pop(i)
-                    job.status = 'running'
-                    return job
+        jobs = self.dequeue_batch(queue_name, 1)
+        return jobs[0] if jobs else None
 
-            return None
+    def dequeue_batch(self, queue_name: str = 'default', max_jobs: int = 1) -> List[Job]:
+        """Get up to ``max_jobs`` ready jobs, highest priority first"""
+        with self.lock:
+            return self._pop_ready(queue_name, max_jobs, time.time())
 
     def get_job(self, job_id: str) -> Optional[Job]:
         """Get job by ID"""
@@ -169,154 +305,716 @@ class MemoryQueueBackend(QueueBackend):
     def get_queue_size(self, queue_name: str = 'default') -> int:
         """Get queue size"""
         with self.lock:
-            return len(self.queues.get(queue_name, []))
+            return len(self.queues.get(queue_name, ())) + len(self.delayed.get(queue_name, ()))
 
+    async def fetch(self, queue_name: str = 'default', max_jobs: int = 1,
+                    timeout: Optional[float] = 1.0) -> List[Job]:
+        """Take ready jobs, waiting for an enqueue, the next delayed job or ``timeout``"""
+        loop = asyncio.get_running_loop()
+        with self.lock:
+            now = time.time()
+            jobs = self._pop_ready(queue_name, max_jobs, now)
+            if jobs or timeout == 0:
+                return jobs
+            delayed = self.delayed.get(queue_name)
+            wait = timeout
+            if delayed:
+                due_in = max(delayed[0][0] - now, 0.0)
+                wait = due_in if wait is None else min(wait, due_in)
+            waiter = (loop, loop.create_future())
+            self._waiters.setdefault(queue_name, deque()).append(waiter)
 
-class RedisQueueBackend(QueueBackend):
-    """Redis-based queue backend"""
+        try:
+            await asyncio.wait_for(waiter[1], wait)
+        except asyncio.TimeoutError:
+            pass
+        finally:
+            with self.lock:
+                waiters = self._waiters.get(queue_name)
+                if waiters and waiter in waiters:
+                    waiters.remove(waiter)
+        return self.dequeue_batch(queue_name, max_jobs)
+
+    def wake(self, queue_name: str = 'default') -> None:
+        """Release every waiting ``fetch`` on ``queue_name``"""
+        with self.lock:
+            waiters = list(self._waiters.pop(queue_name, ()))
+        for loop, future in waiters:
+            try:
+                loop.call_soon_threadsafe(_resolve_future, future)
+            except RuntimeError:
+                pass
+
+    def _pop_ready(self, queue_name: str, max_jobs: int, now: float) -> List[Job]:
+        """Promote due delayed jobs, then pop ready ones (lock held)"""
+        delayed = self.delayed.get(queue_name)
+        if delayed and delayed[0][0] <= now:
+            ready = self.queues.setdefault(queue_name, [])
+            while delayed and delayed[0][0] <= now:
+                _, sequence, job = heapq.heappop(delayed)
+                heapq.heappush(ready, (-job.priority, sequence, job))
+        ready = self.queues.get(queue_name)
+        jobs = []
+        while ready and len(jobs) < max_jobs:
+            job = heapq.heappop(ready)[2]
+            job.status = 'running'
+            jobs.append(job)
+        return jobs
+
+    def _notify(self, queue_name: str) -> None:
+        """Wake one waiting ``fetch`` (lock held)"""
+        waiters = self._waiters.get(queue_name)
+        while waiters:
+            loop, future = waiters.popleft()
+            if future.done():
+                continue
+            try:
+                loop.call_soon_threadsafe(self._deliver, future, queue_name)
+                return
+            except RuntimeError:
+                # Loop closed: try the next waiter
+                continue
+
+    def _deliver(self, future: asyncio.Future, queue_name: str) -> None:
+        """Resolve a woken waiter in its own loop, or pass the wake-up on if it already timed out"""
+        if future.done():
+            with self.lock:
+                self._notify(queue_name)
+        else:
+            future.set_result(True)
+
+
+def _resolve_future(future: asyncio.Future) -> None:
+    if not future.done():
+        future.set_result(False)
+
+
+# Async method reaching the real store for each synchronous primitive
+_ASYNC_EQUIVALENTS = {'enqueue': 'push', 'dequeue': 'fetch', 'get_job': 'load',
+                      'update_job': 'complete', 'get_queue_size': 'size'}
+
+
+def _sync_store(backend: QueueBackend, operation: str) -> MemoryQueueBackend:
+    """
+    The in-memory store behind an async backend's synchronous primitives.
+
+    Once a client or connection is configured the sync API would only see
+    process memory, so it refuses instead of silently diverging.
+    """
+    if backend.async_only:
+        raise RuntimeError(f"{type(backend).__name__}.{operation}() cannot reach the configured store; "
+                           f"use await {_ASYNC_EQUIVALENTS[operation]}()")
+    return backend.fallback
 
-    def __init__(self, redis_client=None):
+
+class RedisQueueBackend(QueueBackend):
+    """
+    Redis-based queue backend
+
+    Each queue is a stream read through a consumer group: ``fetch`` is a
+    blocking ``XREADGROUP`` for up to ``max_jobs`` entries, ``complete``
+    acknowledges and deletes the entry, and entries a crashed consumer never
+    acknowledged are reclaimed with ``XAUTOCLAIM`` after
+    ``visibility_timeout``. Delayed jobs wait in a sorted set by run time
+    and are moved onto the stream when due. Streams deliver FIFO, so
+    priority does not reorder a Redis queue.
+
+    ``redis_client`` is a ``redis.asyncio`` client; without one the backend
+    falls back to memory. With a client only the async API is available.
+    """
+
+    def __init__(self, redis_client=None, prefix: str = 'pyserv:queue:', group: str = 'workers',
+                 consumer: Optional[str] = None, visibility_timeout: float = 300.0,
+                 result_ttl: int = 86400):
         self.redis = redis_client
-        # This would use redis for actual implementation
-        # For now, fall back to memory backend
+        self.prefix = prefix
+        self.group = group
+        self.consumer = consumer or f"{socket.gethostname()}-{os.getpid()}-{uuid.uuid4().hex[:8]}"
+        self.visibility_timeout = visibility_timeout
+        self.result_ttl = result_ttl
         self.fallback = MemoryQueueBackend()
+        self._groups: set = set()
+        self._entries: Dict[str, str] = {}
+        self._last_reclaim: Dict[str, float] = {}
+
+    @property
+    def async_only(self) -> bool:
+        return self.redis is not None
+
+    def _stream(self, queue_name: str) -> str:
+        return f"{self.prefix}{queue_name}"
+
+    def _delayed(self, queue_name: str) -> str:
+        return f"{self.prefix}{queue_name}:delayed"
+
+    def _job_key(self, job_id: str) -> str:
+        return f"{self.prefix}job:{job_id}"
 
     def enqueue(self, job: Job) -> bool:
-        """Add job to Redis queue"""
-        if self.redis:
-            # Redis implementation would go here
-            pass
-        return self.fallback.enqueue(job)
+        """Add job to the in-memory fallback (a configured client is used through ``push``)"""
+        return _sync_store(self, 'enqueue').enqueue(job)
 
     def dequeue(self, queue_name: str = 'default') -> Optional[Job]:
-        """Get next job from Redis queue"""
-        if self.redis:
-            # Redis implementation would go here
-            pass
-        return self.fallback.dequeue(queue_name)
+        """Get next job from the in-memory fallback"""
+        return _sync_store(self, 'dequeue').dequeue(queue_name)
 
     def get_job(self, job_id: str) -> Optional[Job]:
-        """Get job by ID from Redis"""
-        if self.redis:
-            # Redis implementation would go here
-            pass
-        return self.fallback.get_job(job_id)
+        """Get job by ID from the in-memory fallback"""
+        return _sync_store(self, 'get_job').get_job(job_id)
 
     def update_job(self, job: Job) -> bool:
-        """Update job status in Redis"""
-        if self.redis:
-            # Redis implementation would go here
-            pass
-        return self.fallback.update_job(job)
+        """Update job status in the in-memory fallback"""
+        return _sync_store(self, 'update_job').update_job(job)
 
     def get_queue_size(self, queue_name: str = 'default') -> int:
-        """Get queue size from Redis"""
-        if self.redis:
-            # Redis implementation would go here
-            pass
-        return self.fallback.get_queue_size(queue_name)
+        """Get queue size from the in-memory fallback"""
+        return _sync_store(self, 'get_queue_size').get_queue_size(queue_name)
 
+    async def push(self, job: Job) -> bool:
+        """Add job to its Redis stream, or to the delayed set until it is due"""
+        if not self.redis:
+            return self.fallback.enqueue(job)
+        job.enqueued_at = time.time()
+        job.status = 'pending'
+        payload = job.to_json()
+        run_at = job.run_at()
+        async with self.redis.pipeline(transaction=False) as pipe:
+            pipe.set(self._job_key(job.id), payload, ex=self.result_ttl)
+            if run_at > job.enqueued_at:
+                pipe.zadd(self._delayed(job.queue_name), {job.id: run_at})
+            else:
+                pipe.xadd(self._stream(job.queue_name), {'job': payload})
+            await pipe.execute()
+        return True
 
-class DatabaseQueueBackend(QueueBackend):
-    """Database-based queue backend"""
+    async def fetch(self, queue_name: str = 'default', max_jobs: int = 1,
+                    timeout: Optional[float] = 1.0) -> List[Job]:
+        """Blocking read of up to ``max_jobs`` new entries for this consumer"""
+        if not self.redis:
+            return await self.fallback.fetch(queue_name, max_jobs, timeout)
+
+        stream = self._stream(queue_name)
+        await self._ensure_group(stream)
+        next_due = await self._promote_due(queue_name)
+
+        jobs = await self._reclaim(queue_name, max_jobs)
+        if jobs:
+            return jobs
+
+        wait = timeout
+        if next_due is not None:
+            due_in = max(next_due - time.time(), 0.0)
+            wait = due_in if wait is None else min(wait, due_in)
+        # BLOCK 0 waits forever; a sub-millisecond wait is a plain read
+        block = 0 if wait is None else int(wait * 1000) or None
+        response = await self.redis.xreadgroup(self.group, self.consumer, {stream: '>'},
+                                               count=max_jobs, block=block)
+        return self._decode_entries(response[0][1] if response else [])
+
+    async def complete(self, job: Job) -> bool:
+        """Acknowledge the stream entry and store the final job state"""
+        if not self.redis:
+            return self.fallback.update_job(job)
+        async with self.redis.pipeline(transaction=False) as pipe:
+            self._ack(pipe, job)
+            pipe.set(self._job_key(job.id), job.to_json(), ex=self.result_ttl)
+            await pipe.execute()
+        return True
+
+    async def retry(self, job: Job) -> bool:
+        """Acknowledge the failed attempt and queue the job again"""
+        if not self.redis:
+            return self.fallback.enqueue(job)
+        async with self.redis.pipeline(transaction=False) as pipe:
+            self._ack(pipe, job)
+            await pipe.execute()
+        return await self.push(job)
+
+    async def release(self, jobs: List[Job]) -> None:
+        """Re-queue unstarted jobs so other consumers see them now rather than after reclaim"""
+        for job in jobs:
+            await self.retry(job)
+
+    async def load(self, job_id: str) -> Optional[Job]:
+        """Get job by ID from Redis"""
+        if not self.redis:
+            return self.fallback.get_job(job_id)
+        payload = await self.redis.get(self._job_key(job_id))
+        return Job.from_json(payload, self.registry) if payload else None
+
+    async def size(self, queue_name: str = 'default') -> int:
+        """Entries on the stream (waiting or in flight) plus delayed jobs"""
+        if not self.redis:
+            return self.fallback.get_queue_size(queue_name)
+        return await self.redis.xlen(self._stream(queue_name)) + await self.redis.zcard(self._delayed(queue_name))
+
+    def wake(self, queue_name: str = 'default') -> None:
+        self.fallback.wake(queue_name)
+
+    async def close(self) -> None:
+        if self.redis is not None:
+            await self.redis.close()
+
+    def _ack(self, pipe, job: Job) -> None:
+        entry_id = self._entries.pop(job.id, None)
+        if entry_id is not None:
+            stream = self._stream(job.queue_name)
+            pipe.xack(stream, self.group, entry_id)
+            pipe.xdel(stream, entry_id)
 
-    def __init__(self, db_connection=None):
-        self.db = db_connection or AbstractDatabaseConnection.get_instance()
+    async def _ensure_group(self, stream: str) -> None:
+        if stream in self._groups:
+            return
+        try:
+            await self.redis.xgroup_create(stream, self.group, id='0', mkstream=True)
+        except Exception as e:
+            if 'BUSYGROUP' not in str(e):
+                raise
+        self._groups.add(stream)
+
+    async def _promote_due(self, queue_name: str) -> Optional[float]:
+        """Move due delayed jobs onto the stream; return the next run time still waiting"""
+        delayed = self._delayed(queue_name)
+        head = await self.redis.zrange(delayed, 0, 0, withscores=True)
+        if not head:
+            return None
+        if head[0][1] > time.time():
+            return head[0][1]
+
+        for job_id in await self.redis.zrangebyscore(delayed, '-inf', time.time(), start=0, num=100):
+            # ZREM succeeds for exactly one consumer, which then owns the promotion
+            if await self.redis.zrem(delayed, job_id):
+                job_id = job_id.decode() if isinstance(job_id, bytes) else job_id
+                payload = await self.redis.get(self._job_key(job_id))
+                if payload:
+                    await self.redis.xadd(self._stream(queue_name), {'job': payload})
+        head = await self.redis.zrange(delayed, 0, 0, withscores=True)
+        return head[0][1] if head else None
+
+    async def _reclaim(self, queue_name: str, max_jobs: int) -> List[Job]:
+        """Claim entries other consumers left unacknowledged past the visibility timeout"""
+        now = time.time()
+        if now - self._last_reclaim.get(queue_name, 0.0) < self.visibility_timeout / 2:
+            return []
+        self._last_reclaim[queue_name] = now
+        response = await self.redis.xautoclaim(self._stream(queue_name), self.group, self.consumer,
+                                               min_idle_time=int(self.visibility_timeout * 1000),
+                                               start_id='0-0', count=max_jobs)
+        return self._decode_entries(response[1] if response else [])
+
+    def _decode_entries(self, entries) -> List[Job]:
+        jobs = []
+        for entry_id, fields in entries:
+            payload = fields.get(b'job') if b'job' in fields else fields.get('job')
+            if payload is None:
+                continue
+            job = Job.from_json(payload, self.registry)
+            job.status = 'running'
+            self._entries[job.id] = entry_id.decode() if isinstance(entry_id, bytes) else entry_id
+            jobs.append(job)
+        return jobs
+
+
+class DatabaseQueueBackend(QueueBackend):
+    """
+    Database-based queue backend
+
+    Jobs are rows of ``table``. ``fetch`` claims a batch with one
+    ``UPDATE ... WHERE id IN (SELECT ... FOR UPDATE SKIP LOCKED)``, so
+    concurrent workers never block on or double-claim each other's rows,
+    and waits for ``NOTIFY`` on ``channel`` (sent by ``push``) when nothing
+    is ready. Rows left ``running`` past ``visibility_timeout`` by a dead
+    worker are put back. Written against a PostgreSQL connection (asyncpg);
+    without one the backend falls back to memory. With a connection only the
+    async API is available.
+    """
+
+    def __init__(self, db_connection=None, table: str = 'pyserv_jobs', channel: str = 'pyserv_jobs',
+                 visibility_timeout: float = 300.0):
+        self.db = db_connection
+        self.table = table
+        self.channel = channel
+        self.visibility_timeout = visibility_timeout
         self.fallback = MemoryQueueBackend()
+        self._ready = False
+        self._listener = None
+        self._listener_cm = None
+        self._loop: Optional[asyncio.AbstractEventLoop] = None
+        self._events: Dict[str, asyncio.Event] = {}
+        self._last_reclaim = 0.0
+
+    @property
+    def async_only(self) -> bool:
+        return self.db is not None
 
     def enqueue(self, job: Job) -> bool:
-        """Add job to database queue"""
-        try:
-            # Database implementation would go here
-            return self.fallback.enqueue(job)
-        except Exception:
-            return self.fallback.enqueue(job)
+        """Add job to the in-memory fallback (a configured connection is used through ``push``)"""
+        return _sync_store(self, 'enqueue').enqueue(job)
 
     def dequeue(self, queue_name: str = 'default') -> Optional[Job]:
-        """Get next job from database queue"""
-        try:
-            # Database implementation would go here
-            return self.fallback.dequeue(queue_name)
-        except Exception:
-            return self.fallback.dequeue(queue_name)
+        """Get next job from the in-memory fallback"""
+        return _sync_store(self, 'dequeue').dequeue(queue_name)
 
     def get_job(self, job_id: str) -> Optional[Job]:
-        """Get job by ID from database"""
-        try:
-            # Database implementation would go here
-            return self.fallback.get_job(job_id)
-        except Exception:
-            return self.fallback.get_job(job_id)
+        """Get job by ID from the in-memory fallback"""
+        return _sync_store(self, 'get_job').get_job(job_id)
 
     def update_job(self, job: Job) -> bool:
-        """Update job status in database"""
-        try:
-            # Database implementation would go here
-            return self.fallback.update_job(job)
-        except Exception:
-            return self.fallback.update_job(job)
+        """Update job status in the in-memory fallback"""
+        return _sync_store(self, 'update_job').update_job(job)
 
     def get_queue_size(self, queue_name: str = 'default') -> int:
-        """Get queue size from database"""
+        """Get queue size from the in-memory fallback"""
+        return _sync_store(self, 'get_queue_size').get_queue_size(queue_name)
+
+    async def push(self, job: Job) -> bool:
+        """Insert (or re-queue) the job row and notify listeners on commit"""
+        if not self.db:
+            return self.fallback.enqueue(job)
+        await self._ensure_schema()
+        job.enqueued_at = time.time()
+        job.status = 'pending'
+        async with self.db.get_connection() as connection:
+            async with connection.transaction():
+                await connection.execute(
+                    f"INSERT INTO {self.table} (id, queue_name, priority, run_at, enqueued_at, status, payload) "
+                    f"VALUES ($1, $2, $3, $4, $5, 'pending', $6) "
+                    f"ON CONFLICT (id) DO UPDATE SET status = 'pending', run_at = EXCLUDED.run_at, "
+                    f"enqueued_at = EXCLUDED.enqueued_at, payload = EXCLUDED.payload, claimed_at = NULL",
+                    job.id, job.queue_name, job.priority, max(job.run_at(), job.enqueued_at),
+                    job.enqueued_at, job.to_json())
+                await connection.execute("SELECT pg_notify($1, $2)", self.channel, job.queue_name)
+        return True
+
+    async def fetch(self, queue_name: str = 'default', max_jobs: int = 1,
+                    timeout: Optional[float] = 1.0) -> List[Job]:
+        """Claim ready rows, waiting for a notification or the next delayed row"""
+        if not self.db:
+            return await self.fallback.fetch(queue_name, max_jobs, timeout)
+        await self._ensure_schema()
+        await self._ensure_listener()
+        event = self._events.setdefault(queue_name, asyncio.Event())
+
+        # Clear before claiming so a NOTIFY that lands mid-claim still wakes the wait below
+        event.clear()
+        jobs = await self._claim(queue_name, max_jobs)
+        if jobs or timeout == 0:
+            return jobs
+
+        wait = timeout
+        async with self.db.get_connection() as connection:
+            next_due = await connection.fetchval(
+                f"SELECT min(run_at) FROM {self.table} WHERE queue_name = $1 AND status = 'pending'", queue_name)
+        if next_due is not None:
+            due_in = max(next_due - time.time(), 0.0)
+            wait = due_in if wait is None else min(wait, due_in)
         try:
-            # Database implementation would go here
-            return self.fallback.get_queue_size(queue_name)
-        except Exception:
+            await asyncio.wait_for(event.wait(), wait)
+        except asyncio.TimeoutError:
+            pass
+        return await self._claim(queue_name, max_jobs)
+
+    async def complete(self, job: Job) -> bool:
+        """Store the final state in one statement"""
+        if not self.db:
+            return self.fallback.update_job(job)
+        async with self.db.get_connection() as connection:
+            await connection.execute(f"UPDATE {self.table} SET status = $2, payload = $3 WHERE id = $1",
+                                     job.id, job.status, job.to_json())
+        return True
+
+    async def release(self, jobs: List[Job]) -> None:
+        """Put unstarted rows back to pending"""
+        if not self.db:
+            return await self.fallback.release(jobs)
+        if not jobs:
+            return
+        async with self.db.get_connection() as connection:
+            async with connection.transaction():
+                await connection.execute(
+                    f"UPDATE {self.table} SET status = 'pending', claimed_at = NULL WHERE id = ANY($1::text[])",
+                    [job.id for job in jobs])
+                for queue_name in {job.queue_name for job in jobs}:
+                    await connection.execute("SELECT pg_notify($1, $2)", self.channel, queue_name)
+
+    async def load(self, job_id: str) -> Optional[Job]:
+        """Get job by ID from the database"""
+        if not self.db:
+            return self.fallback.get_job(job_id)
+        async with self.db.get_connection() as connection:
+            row = await connection.fetchrow(f"SELECT status, payload FROM {self.table} WHERE id = $1", job_id)
+        if row is None:
+            return None
+        job = Job.from_json(row['payload'], self.registry)
+        job.status = row['status']
+        return job
+
+    async def size(self, queue_name: str = 'default') -> int:
+        """Pending rows, delayed included"""
+        if not self.db:
             return self.fallback.get_queue_size(queue_name)
+        async with self.db.get_connection() as connection:
+            return await connection.fetchval(
+                f"SELECT count(*) FROM {self.table} WHERE queue_name = $1 AND status = 'pending'", queue_name)
+
+    def wake(self, queue_name: str = 'default') -> None:
+        self.fallback.wake(queue_name)
+        event = self._events.get(queue_name)
+        if event is not None and self._loop is not None:
+            try:
+                self._loop.call_soon_threadsafe(event.set)
+            except RuntimeError:
+                pass
+
+    async def close(self) -> None:
+        if self._listener is not None:
+            try:
+                await self._listener.remove_listener(self.channel, self._on_notify)
+            finally:
+                await self._listener_cm.__aexit__(None, None, None)
+                self._listener = self._listener_cm = None
+
+    async def _claim(self, queue_name: str, max_jobs: int) -> List[Job]:
+        now = time.time()
+        async with self.db.get_connection() as connection:
+            if now - self._last_reclaim >= self.visibility_timeout / 2:
+                self._last_reclaim = now
+                await connection.execute(
+                    f"UPDATE {self.table} SET status = 'pending', claimed_at = NULL "
+                    f"WHERE status = 'running' AND claimed_at < $1", now - self.visibility_timeout)
+            rows = await connection.fetch(
+                f"UPDATE {self.table} SET status = 'running', claimed_at = $3 "
+                f"WHERE id IN (SELECT id FROM {self.table} "
+                f"WHERE queue_name = $1 AND status = 'pending' AND run_at <= $3 "
+                f"ORDER BY priority DESC, run_at LIMIT $2 FOR UPDATE SKIP LOCKED) "
+                f"RETURNING priority, run_at, payload",
+                queue_name, max_jobs, now)
+        jobs = []
+        for row in sorted(rows, key=lambda row: (-row['priority'], row['run_at'])):
+            job = Job.from_json(row['payload'], self.registry)
+            job.status = 'running'
+            jobs.append(job)
+        return jobs
+
+    async def _ensure_schema(self) -> None:
+        if self._ready:
+            return
+        async with self.db.get_connection() as connection:
+            await connection.execute(
+                f"CREATE TABLE IF NOT EXISTS {self.table} ("
+                f"id TEXT PRIMARY KEY, queue_name TEXT NOT NULL, priority INTEGER NOT NULL DEFAULT 0, "
+                f"run_at DOUBLE PRECISION NOT NULL, enqueued_at DOUBLE PRECISION NOT NULL, "
+                f"status TEXT NOT NULL, payload TEXT NOT NULL, claimed_at DOUBLE PRECISION)")
+            await connection.execute(
+                f"CREATE INDEX IF NOT EXISTS {self.table}_ready_idx "
+                f"ON {self.table} (queue_name, priority DESC, run_at) WHERE status = 'pending'")
+        self._ready = True
+
+    async def _ensure_listener(self) -> None:
+        """Hold one pooled connection for LISTEN for the backend's lifetime"""
+        if self._listener is not None:
+            return
+        self._loop = asyncio.get_running_loop()
+        self._listener_cm = self.db.get_connection()
+        connection = await self._listener_cm.__aenter__()
+        await connection.add_listener(self.channel, self._on_notify)
+        self._listener = connection
+
+    def _on_notify(self, connection, pid, channel, payload) -> None:
+        event = self._events.get(payload)
+        if event is not None:
+            event.set()
+
+
+class QueueMetrics:
+    """Enqueue-to-start latency, run time and outcome counts for one queue"""
+
+    def __init__(self, queue_name: str = 'default'):
+        self.queue_name = queue_name
+        self.wait_buckets = [0] * (len(QUEUE_LATENCY_BUCKETS) + 1)
+        self.wait_sum = 0.0
+        self.run_buckets = [0] * (len(QUEUE_LATENCY_BUCKETS) + 1)
+        self.run_sum = 0.0
+        self.completed = 0
+        self.failed = 0
+        self.retried = 0
+        self.stolen = 0
+        self.batches = 0
+        self.batched_jobs = 0
+
+    def observe_wait(self, seconds: float) -> None:
+        seconds = max(seconds, 0.0)
+        self.wait_buckets[bisect.bisect_left(QUEUE_LATENCY_BUCKETS, seconds)] += 1
+        self.wait_sum += seconds
+
+    def observe_run(self, seconds: float) -> None:
+        seconds = max(seconds, 0.0)
+        self.run_buckets[bisect.bisect_left(QUEUE_LATENCY_BUCKETS, seconds)] += 1
+        self.run_sum += seconds
+
+    def observe_batch(self, size: int) -> None:
+        self.batches += 1
+        self.batched_jobs += size
+
+    @staticmethod
+    def _quantile(buckets: List[int], q: float) -> float:
+        """Upper bound of the bucket holding quantile ``q``"""
+        total = sum(buckets)
+        if not total:
+            return 0.0
+        rank = q * total
+        cumulative = 0
+        for bound, count in zip(QUEUE_LATENCY_BUCKETS + (math.inf,), buckets):
+            cumulative += count
+            if cumulative >= rank:
+                return bound
+        return math.inf
+
+    def get_stats(self) -> Dict[str, Any]:
+        started = sum(self.wait_buckets)
+        return {
+            'queue': self.queue_name,
+            'started': started,
+            'completed': self.completed,
+            'failed': self.failed,
+            'retried': self.retried,
+            'stolen': self.stolen,
+            'average_batch': self.batched_jobs / self.batches if self.batches else 0.0,
+            'wait_average': self.wait_sum / started if started else 0.0,
+            'wait_p50': self._quantile(self.wait_buckets, 0.5),
+            'wait_p99': self._quantile(self.wait_buckets, 0.99),
+        }
 
 
 class Worker:
-    """Background worker for processing jobs"""
+    """
+    Background worker for processing jobs
+
+    Runs as an asyncio task: jobs are fetched ``batch_size`` at a time into
+    a local deque and run up to ``max_concurrent`` at once, async job
+    functions on the loop and sync ones on a thread pool. A worker whose
+    deque is empty steals half of a sibling's (``peers``) before asking the
+    backend. ``start`` runs the worker on the current event loop, or on a
+    background thread's loop when called outside one.
+    """
 
     def __init__(self, queue_backend: QueueBackend, queue_name: str = 'default',
-                 max_concurrent: int = 4):
+                 max_concurrent: int = 4, batch_size: Optional[int] = None,
+                 idle_timeout: float = 1.0, metrics: Optional[QueueMetrics] = None):
         self.queue_backend = queue_backend
         self.queue_name = queue_name
         self.max_concurrent = max_concurrent
+        self.batch_size = batch_size or max_concurrent
+        self.idle_timeout = idle_timeout
+        self.metrics = metrics or QueueMetrics(queue_name)
+        self.local: Deque[Job] = deque()
+        self.peers: List['Worker'] = []
         self.running = False
-        self.executor = ThreadPoolExecutor(max_workers=max_concurrent)
-        self.thread = None
+        self._stopping = False
+        self.executor: Optional[ThreadPoolExecutor] = None
+        self.thread: Optional[threading.Thread] = None
+        self.task: Optional[asyncio.Task] = None
+        self._inflight: set = set()
 
     def start(self):
         """Start the worker"""
-        if self.running:
-            return
-
-        self.running = True
-        self.thread = threading.Thread(target=self._run_worker)
-        self.thread.daemon = True
-        self.thread.start()
-
-    def stop(self):
-        """Stop the worker"""
-        self.running = False
-        if self.executor:
-            self.executor.shutdown(wait=True)
-
-    def _run_worker(self):
+        if not self.running:
+            start_workers([self])
+
+    def stop(self, wait: bool = True):
+        """Stop the worker after its running jobs finish; unstarted local jobs go back to the queue"""
+        self._stopping = True
+        self.queue_backend.wake(self.queue_name)
+        thread = self.thread
+        # Siblings started together share the thread; join once none of them is still wanted
+        if wait and thread is not None and thread is not threading.current_thread() \
+                and all(peer._stopping for peer in self.peers if peer.thread is thread):
+            thread.join()
+
+    async def shutdown(self):
+        """Stop the worker and wait for it from the loop it runs on"""
+        self.stop(wait=False)
+        if self.task is not None:
+            await asyncio.gather(self.task, return_exceptions=True)
+
+    async def run(self):
         """Main worker loop"""
-        while self.running:
+        self.running = True
+        self.executor = ThreadPoolExecutor(max_workers=self.max_concurrent,
+                                           thread_name_prefix=f"pyserv-queue-{self.queue_name}")
+        slots = asyncio.Semaphore(self.max_concurrent)
+        try:
+            while not self._stopping:
+                await slots.acquire()
+                if self._stopping:
+                    slots.release()
+                    break
+                job = self._next_job()
+                if job is None:
+                    try:
+                        jobs = await self.queue_backend.fetch(self.queue_name, self.batch_size, self.idle_timeout)
+                    except Exception as e:
+                        slots.release()
+                        logger.error(f"Worker error: {e}")
+                        await asyncio.sleep(1)
+                        continue
+                    if not jobs:
+                        slots.release()
+                        continue
+                    self.metrics.observe_batch(len(jobs))
+                    self.local.extend(jobs)
+                    job = self.local.popleft()
+
+                task = asyncio.ensure_future(self._execute_job(job))
+                self._inflight.add(task)
+                task.add_done_callback(self._inflight.discard)
+                task.add_done_callback(lambda _: slots.release())
+        finally:
+            self.running = False
+            if self._inflight:
+                await asyncio.gather(*self._inflight, return_exceptions=True)
+            if self.local:
+                unstarted = list(self.local)
+                self.local.clear()
+                await self.queue_backend.release(unstarted)
+            self.executor.shutdown(wait=False)
+
+    def _next_job(self) -> Optional[Job]:
+        """Own deque first (FIFO), else steal the older half of a busy sibling's"""
+        if self.local:
+            return self.local.popleft()
+        if not self.peers:
+            return None
+        start = random.randrange(len(self.peers))
+        for peer in self.peers[start:] + self.peers[:start]:
+            victim = peer.local
+            count = len(victim) // 2 or len(victim)
+            stolen = []
             try:
-                job = self.queue_backend.dequeue(self.queue_name)
-                if job:
-                    self.executor.submit(self._execute_job, job)
-                else:
-                    time.sleep(1)  # Wait before checking again
-            except Exception as e:
-                logging.error(f"Worker error: {e}")
-                time.sleep(5)  # Wait longer on error
-
-    def _execute_job(self, job: Job):
+                for _ in range(count):
+                    stolen.append(victim.popleft())
+            except IndexError:
+                pass
+            if stolen:
+                self.metrics.stolen += len(stolen)
+                self.local.extend(stolen[1:])
+                return stolen[0]
+        return None
+
+    async def _execute_job(self, job: Job):
         """Execute a single job"""
+        job.status = 'running'
+        job.started_at = time.time()
+        self.metrics.observe_wait(job.started_at - max(job.enqueued_at or job.started_at, job.run_at()))
         try:
-            job.status = 'running'
-            self.queue_backend.update_job(job)
-
-            # Execute the job function
-            result = job.func(*job.args, **job.kwargs)
+            if inspect.iscoroutinefunction(job.func):
+                result = await job.func(*job.args, **job.kwargs)
+            else:
+                loop = asyncio.get_running_loop()
+                result = await loop.run_in_executor(self.executor, partial(job.func, *job.args, **job.kwargs))
             job.result = result
             job.status = 'completed'
-
+            self.metrics.completed += 1
         except Exception as e:
             job.error = str(e)
             job.status = 'failed'
@@ -325,10 +1023,56 @@ class Worker:
             # Retry if possible
             if job.should_retry():
                 job.status = 'pending'
-                self.queue_backend.enqueue(job)
+                self.metrics.retried += 1
+                self._record_run(job)
+                await self._report(self.queue_backend.retry, job)
+                return
+            self.metrics.failed += 1
 
-        finally:
-            self.queue_backend.update_job(job)
+        self._record_run(job)
+        await self._report(self.queue_backend.complete, job)
+
+    def _record_run(self, job: Job) -> None:
+        job.finished_at = time.time()
+        self.metrics.observe_run(job.finished_at - job.started_at)
+
+    @staticmethod
+    async def _report(method: Callable, job: Job) -> None:
+        try:
+            await method(job)
+        except Exception as e:
+            logger.error(f"Failed to record job {job.id}: {e}")
+
+
+def start_workers(workers: List[Worker]) -> None:
+    """
+    Start workers as tasks on the running event loop, or, outside one, all
+    together on one background thread's loop (so they can steal from each
+    other without crossing threads).
+    """
+    try:
+        loop = asyncio.get_running_loop()
+    except RuntimeError:
+        loop = None
+    for worker in workers:
+        worker.running = True
+        worker._stopping = False
+
+    if loop is not None:
+        for worker in workers:
+            worker.task = loop.create_task(worker.run())
+        return
+
+    async def run_all():
+        for worker in workers:
+            worker.task = asyncio.current_task()
+        await asyncio.gather(*(worker.run() for worker in workers), return_exceptions=True)
+
+    thread = threading.Thread(target=asyncio.run, args=(run_all(),), daemon=True,
+                              name=f"pyserv-queue-{workers[0].queue_name}")
+    for worker in workers:
+        worker.thread = thread
+    thread.start()
 
 
 class QueueManager:
@@ -338,50 +1082,152 @@ class QueueManager:
         self.backend = backend or MemoryQueueBackend()
         self.workers: Dict[str, List[Worker]] = {}
         self.job_registry: Dict[str, Callable] = {}
+        self.metrics: Dict[str, QueueMetrics] = {}
+        self.backend.registry = self.job_registry
+        self._pending: set = set()
 
     def register_job(self, name: str, func: Callable):
         """Register a job function"""
         self.job_registry[name] = func
+        self.job_registry.setdefault(job_name(func), func)
 
-    def enqueue(self, func: Callable, *args, queue_name: str = 'default',
-                priority: int = 0, delay: Optional[timedelta] = None, **kwargs) -> str:
-        """Add job to queue"""
+    def _build_job(self, func: Callable, args: tuple, kwargs: Dict[str, Any], queue_name: str,
+                   priority: int, delay: Optional[timedelta]) -> Job:
         job = Job(func, *args, **kwargs)
         job.queue_name = queue_name
         job.priority = priority
 
         if delay:
             job.delay_until = datetime.now() + delay
+        return job
 
-        self.backend.enqueue(job)
+    def enqueue(self, func: Callable, *args, queue_name: str = 'default',
+                priority: int = 0, delay: Optional[timedelta] = None, **kwargs) -> str:
+        """
+        Add job to queue
+
+        With an async-only backend (Redis or database) the push is scheduled
+        on the running event loop; use ``enqueue_async`` to await it.
+        """
+        job = self._build_job(func, args, kwargs, queue_name, priority, delay)
+        if self.backend.async_only:
+            try:
+                loop = asyncio.get_running_loop()
+            except RuntimeError:
+                raise RuntimeError(f"{type(self.backend).__name__} can only enqueue from a running "
+                                   f"event loop; use enqueue_async") from None
+            task = loop.create_task(self.backend.push(job))
+            self._pending.add(task)
+            task.add_done_callback(self._pending.discard)
+        else:
+            self.backend.enqueue(job)
+        return job.id
+
+    async def enqueue_async(self, func: Callable, *args, queue_name: str = 'default',
+                            priority: int = 0, delay: Optional[timedelta] = None, **kwargs) -> str:
+        """Add job to queue"""
+        job = self._build_job(func, args, kwargs, queue_name, priority, delay)
+        await self.backend.push(job)
         return job.id
 
     def get_job(self, job_id: str) -> Optional[Job]:
-        """Get job by ID"""
+        """Get job by ID; async-only backends need ``get_job_async``"""
+        self._require_sync('get_job_async')
         return self.backend.get_job(job_id)
 
+    async def get_job_async(self, job_id: str) -> Optional[Job]:
+        """Get job by ID"""
+        return await self.backend.load(job_id)
+
     def start_worker(self, queue_name: str = 'default', num_workers: int = 1,
-                    max_concurrent: int = 4):
-        """Start workers for a queue"""
+                     max_concurrent: int = 4, batch_size: Optional[int] = None):
+        """Start workers for a queue; workers started together steal from each other"""
         if queue_name not in self.workers:
             self.workers[queue_name] = []
+        metrics = self.metrics.setdefault(queue_name, QueueMetrics(queue_name))
 
-        for _ in range(num_workers):
-            worker = Worker(self.backend, queue_name, max_concurrent)
-            worker.start()
-            self.workers[queue_name].append(worker)
+        workers = [Worker(self.backend, queue_name, max_concurrent, batch_size, metrics=metrics)
+                   for _ in range(num_workers)]
+        for worker in workers:
+            worker.peers = [peer for peer in workers if peer is not worker]
+        start_workers(workers)
+        self.workers[queue_name].extend(workers)
 
     def stop_workers(self, queue_name: str = 'default'):
         """Stop workers for a queue"""
         if queue_name in self.workers:
-            for worker in self.workers[queue_name]:
-                worker.stop()
-            self.workers[queue_name].clear()
+            workers = self.workers[queue_name]
+            for worker in workers:
+                worker.stop(wait=False)
+            for thread in {worker.thread for worker in workers if worker.thread is not None}:
+                if thread is not threading.current_thread():
+                    thread.join()
+            workers.clear()
+
+    async def shutdown(self):
+        """Stop every worker running on this loop and wait for in-flight jobs"""
+        for workers in self.workers.values():
+            await asyncio.gather(*(worker.shutdown() for worker in workers))
+            workers.clear()
 
     def get_queue_size(self, queue_name: str = 'default') -> int:
-        """Get queue size"""
+        """Get queue size; async-only backends need ``get_queue_size_async``"""
+        self._require_sync('get_queue_size_async')
         return self.backend.get_queue_size(queue_name)
 
+    async def get_queue_size_async(self, queue_name: str = 'default') -> int:
+        """Get queue size"""
+        return await self.backend.size(queue_name)
+
+    def _require_sync(self, alternative: str) -> None:
+        if self.backend.async_only:
+            raise RuntimeError(f"{type(self.backend).__name__} is only reachable asynchronously; "
+                               f"use {alternative}")
+
+    def get_stats(self) -> Dict[str, Dict[str, Any]]:
+        """Per-queue latency and outcome statistics"""
+        return {name: metrics.get_stats() for name, metrics in self.metrics.items()}
+
+    def collect_metrics(self) -> List[Any]:
+        """Queue metrics as ``MetricValue`` records for ``MetricsCollector.add_collector``."""
+        from pyserv.monitoring.metrics import MetricValue
+
+        now = time.time()
+        values = []
+
+        def value(name, amount, labels, metric_type='gauge', **extra):
+            return MetricValue(name=name, value=amount, timestamp=now,
+                               labels={**labels, **extra}, metric_type=metric_type)
+
+        def histogram(name, buckets, total, labels):
+            cumulative = 0
+            for bound, count in zip(QUEUE_LATENCY_BUCKETS + (math.inf,), buckets):
+                cumulative += count
+                le = '+Inf' if bound == math.inf else str(bound)
+                values.append(value(f'{name}_bucket', cumulative, labels, 'histogram', le=le))
+            values.append(value(f'{name}_sum', total, labels, 'histogram'))
+            values.append(value(f'{name}_count', cumulative, labels, 'histogram'))
+
+        for queue_name, metrics in self.metrics.items():
+            labels = {'queue': queue_name}
+            if not self.backend.async_only:
+                values.append(value('job_queue_depth', self.backend.get_queue_size(queue_name), labels))
+            values.append(value('job_queue_workers', sum(w.running for w in self.workers.get(queue_name, ())), labels))
+            values.append(value('job_queue_jobs_total', metrics.completed, labels, 'counter', outcome='completed'))
+            values.append(value('job_queue_jobs_total', metrics.failed, labels, 'counter', outcome='failed'))
+            values.append(value('job_queue_retries_total', metrics.retried, labels, 'counter'))
+            values.append(value('job_queue_steals_total', metrics.stolen, labels, 'counter'))
+            histogram('job_queue_wait_seconds', metrics.wait_buckets, metrics.wait_sum, labels)
+            histogram('job_run_seconds', metrics.run_buckets, metrics.run_sum, labels)
+        return values
+
+    def register_metrics(self, collector: Any = None) -> None:
+        """Export queue metrics through a ``MetricsCollector`` (default: the global one)."""
+        if collector is None:
+            from pyserv.monitoring.metrics import get_metrics_collector
+            collector = get_metrics_collector()
+        collector.add_collector(self.collect_metrics)
+
 
 class CronScheduler:
     """Cron-like scheduler for periodic tasks"""
@@ -390,6 +1236,8 @@ class CronScheduler:
         self.jobs: List[Dict[str, Any]] = []
         self.running = False
         self.thread = None
+        # Set by add_job and stop so the scheduler re-plans instead of waiting out its sleep
+        self._wakeup = threading.Event()
 
     def add_job(self, func: Callable, cron_expression: str, *args, **kwargs):
         """Add a cron job"""
@@ -403,6 +1251,7 @@ class CronScheduler:
             'kwargs': kwargs,
             'next_run': self._calculate_next_run(cron_expression)
         })
+        self._wakeup.set()
 
     def start(self):
         """Start the scheduler"""
@@ -417,10 +1266,12 @@ class CronScheduler:
     def stop(self):
         """Stop the scheduler"""
         self.running = False
+        self._wakeup.set()
 
     def _run_scheduler(self):
-        """Main scheduler loop"""
+        """Main scheduler loop: sleep until the earliest next run, or until woken"""
         while self.running:
+            self._wakeup.clear()
             now = datetime.now()
 
             for job in self.jobs:
@@ -433,7 +1284,9 @@ class CronScheduler:
                     # Calculate next run
                     job['next_run'] = self._calculate_next_run(job['cron'])
 
-            time.sleep(60)  # Check every minute
+            next_run = min((job['next_run'] for job in self.jobs), default=None)
+            timeout = None if next_run is None else max((next_run - datetime.now()).total_seconds(), 0.0)
+            self._wakeup.wait(timeout)
 
     def _calculate_next_run(self, cron_expression: str) -> datetime:
         """Calculate next run time from cron expression"""
@@ -493,6 +1346,7 @@ cron_scheduler = CronScheduler()
 
 __all__ = [
     'Job', 'QueueBackend', 'MemoryQueueBackend', 'RedisQueueBackend', 'DatabaseQueueBackend',
-    'Worker', 'QueueManager', 'CronScheduler', 'job', 'scheduled',
+    'QueueMetrics', 'Worker', 'QueueManager', 'CronScheduler', 'job', 'scheduled',
+    'start_workers', 'job_name', 'resolve_job_function', 'QUEUE_LATENCY_BUCKETS',
     'queue_manager', 'cron_scheduler'
 ]
@@ -6,11 +6,15 @@ with support for multiple algorithms, distributed backends, and monitoring.
 """
 
 import asyncio
+import contextlib
+import math
+import random
 import time
 import threading
 from abc import ABC, abstractmethod
+from array import array
 from dataclasses import dataclass, field
-from typing import Dict, Any, Optional, Union, List, Callable
+from typing import Dict, Any, Optional, Union, List, Callable, Tuple
 from enum import Enum
 import logging
 
@@ -23,6 +27,16 @@ class RateLimitAlgorithm(Enum):
     SLIDING_WINDOW = "sliding_window"
     TOKEN_BUCKET = "token_bucket"
     LEAKY_BUCKET = "leaky_bucket"
+    GCRA = "gcra"
+    SLIDING_LOG = "sliding_log"
+
+
+# Token and leaky buckets are both metered exactly by GCRA
+GCRA_ALGORITHMS = {
+    RateLimitAlgorithm.TOKEN_BUCKET: RateLimitAlgorithm.GCRA,
+    RateLimitAlgorithm.LEAKY_BUCKET: RateLimitAlgorithm.GCRA,
+    RateLimitAlgorithm.GCRA: RateLimitAlgorithm.GCRA,
+}
 
 
 @dataclass
@@ -50,6 +64,381 @@ class RateLimitResult:
     limit: int = 0
 
 
+class RateLimitPolicy:
+    """
+    Compiled limit for use with ``RateLimitEngine``.
+
+    ``limit`` requests per ``period`` seconds. For GCRA (token and leaky
+    bucket), requests are spaced ``period / limit`` apart and up to
+    ``burst`` may arrive together. Window algorithms count ``limit``
+    requests per ``period``-second window.
+    """
+
+    __slots__ = ('algorithm', 'limit', 'period', 'burst', 'interval', 'tolerance', 'salt', '_log_table')
+
+    def __init__(self, limit: int, period: float,
+                 algorithm: RateLimitAlgorithm = RateLimitAlgorithm.GCRA,
+                 burst: Optional[int] = None):
+        if limit <= 0 or period <= 0:
+            raise ValueError("limit and period must be positive")
+        self.algorithm = GCRA_ALGORITHMS.get(algorithm, algorithm)
+        self.limit = int(limit)
+        self.period = float(period)
+        self.burst = int(burst or limit)
+        self.interval = self.period / self.limit
+        self.tolerance = self.interval * self.burst
+        # Distinguishes this policy's keys from other policies' in a shared table
+        self.salt = random.getrandbits(63)
+        self._log_table: Optional['RateLimitTable'] = None
+
+    @classmethod
+    def from_config(cls, config: RateLimitConfig) -> 'RateLimitPolicy':
+        """Policy equivalent to a ``RateLimitConfig``"""
+        if config.algorithm in GCRA_ALGORITHMS:
+            rate = config.refill_rate / config.refill_interval
+            return cls(config.capacity, config.capacity / rate, config.algorithm, config.burst_capacity)
+        return cls(config.capacity, config.window_size, config.algorithm)
+
+
+# Stands in for a shard lock when the table is not thread-safe
+_NO_LOCK = contextlib.nullcontext()
+
+
+class _Shard:
+    __slots__ = ('keys', 'expires', 'values', 'mask', 'lock', 'evictions')
+
+    def __init__(self, slots: int, width: int, thread_safe: bool):
+        self.keys = array('q', bytes(8 * slots))
+        self.expires = array('d', bytes(8 * slots))
+        self.values = array('d', bytes(8 * slots * width))
+        self.mask = slots - 1
+        self.lock = threading.Lock() if thread_safe else None
+        self.evictions = 0
+
+
+class RateLimitTable:
+    """
+    Fixed-memory table of limiter state.
+
+    Keys are reduced to 64-bit fingerprints and stored in typed arrays
+    split into power-of-two shards, so memory is ``slots * (16 + 8 * width)``
+    bytes however many distinct keys arrive. Each slot records when its
+    state stops mattering. Expired slots are reused as found, with no
+    sweep. When all ``probe`` candidate slots are live, the one closest to
+    expiry is evicted. That key then starts fresh, so size the table above
+    the number of keys active within one period.
+
+    Args:
+        slots: Total slots, rounded up to a power of two
+        shards: Number of shards (power of two); each gets its own lock when thread_safe
+        width: Floats of state per slot
+        probe: Slots examined per lookup
+        thread_safe: Lock shards for use from several threads; not needed on one event loop
+    """
+
+    def __init__(self, slots: int = 1 << 18, shards: int = 16, width: int = 3,
+                 probe: int = 8, thread_safe: bool = False):
+        shards = 1 << max(shards - 1, 0).bit_length()
+        per_shard = 1 << max(max(slots // shards, probe) - 1, 0).bit_length()
+        self.slots = per_shard * shards
+        self.width = width
+        self.probe = probe
+        self._shard_mask = shards - 1
+        self._shard_bits = self._shard_mask.bit_length()
+        self._shards = [_Shard(per_shard, width, thread_safe) for _ in range(shards)]
+
+    def shard_for(self, fingerprint: int) -> _Shard:
+        """Shard holding a (non-zero) fingerprint; hold its lock around ``claim`` and ``find``"""
+        return self._shards[fingerprint & self._shard_mask]
+
+    def locate(self, fingerprint: int, now: float) -> Tuple[_Shard, int, bool]:
+        """Slot for a fingerprint: ``(shard, index, found_live)``; claims a slot when absent"""
+        fingerprint = fingerprint or 1
+        shard = self.shard_for(fingerprint)
+        return (shard,) + self.claim(shard, fingerprint, now)
+
+    def find(self, shard: _Shard, fingerprint: int, now: float) -> int:
+        """Index of a fingerprint's live slot in ``shard``, or -1; never claims or evicts"""
+        keys, mask = shard.keys, shard.mask
+        i = (fingerprint >> self._shard_bits) & mask
+        for _ in range(self.probe):
+            key = keys[i]
+            if key == fingerprint:
+                return i if shard.expires[i] > now else -1
+            if key == 0:
+                return -1
+            i = (i + 1) & mask
+        return -1
+
+    def claim(self, shard: _Shard, fingerprint: int, now: float) -> Tuple[int, bool]:
+        """Slot for a fingerprint in ``shard``: ``(index, found_live)``, taking one when absent"""
+        keys, expires, mask = shard.keys, shard.expires, shard.mask
+        i = (fingerprint >> self._shard_bits) & mask
+        free = victim = -1
+        victim_expiry = math.inf
+        for _ in range(self.probe):
+            key = keys[i]
+            if key == fingerprint:
+                return i, expires[i] > now
+            if key == 0:
+                # Slots are never emptied, so the key cannot be further along
+                if free < 0:
+                    free = i
+                break
+            expiry = expires[i]
+            if expiry <= now:
+                if free < 0:
+                    free = i
+            elif expiry < victim_expiry:
+                victim, victim_expiry = i, expiry
+            i = (i + 1) & mask
+        if free < 0:
+            free = victim
+            shard.evictions += 1
+        keys[free] = fingerprint
+        return free, False
+
+    def get_stats(self) -> Dict[str, Any]:
+        now = time.time()
+        return {
+            'slots': self.slots,
+            'shards': len(self._shards),
+            'live': sum(1 for shard in self._shards for expiry in shard.expires if expiry > now),
+            'evictions': sum(shard.evictions for shard in self._shards),
+        }
+
+
+class RateLimitEngine:
+    """
+    Rate-limit decisions over a ``RateLimitTable``.
+
+    Algorithms:
+    - GCRA (also TOKEN_BUCKET and LEAKY_BUCKET): one float per key
+    - SLIDING_WINDOW: previous/current window counters, weighted by overlap
+    - FIXED_WINDOW: one counter per window
+    - SLIDING_LOG: exact; the last ``limit`` timestamps per key, in a table sized by ``log_memory``
+
+    ``check`` is synchronous and never allocates per-key objects. With
+    ``thread_safe``, finding a key's slot and updating it happen under the
+    lock of the shard the key hashes to.
+    """
+
+    def __init__(self, table: Optional[RateLimitTable] = None, log_memory: int = 16 * 1024 * 1024,
+                 thread_safe: bool = False):
+        self.table = table or RateLimitTable(thread_safe=thread_safe)
+        self.log_memory = log_memory
+        self.thread_safe = thread_safe
+
+    def check(self, policy: RateLimitPolicy, key: str, cost: int = 1,
+              now: Optional[float] = None) -> RateLimitResult:
+        """Count one request (of weight ``cost``) for ``key`` against ``policy``"""
+        if now is None:
+            now = time.time()
+        table = self._table_for(policy)
+        fingerprint = (hash(key) ^ policy.salt) or 1
+        shard = table.shard_for(fingerprint)
+        lock = shard.lock
+        if lock is None:
+            return self._check(policy, table, shard, fingerprint, now, cost)
+        with lock:
+            return self._check(policy, table, shard, fingerprint, now, cost)
+
+    def _check(self, policy: RateLimitPolicy, table: RateLimitTable, shard: _Shard, fingerprint: int,
+               now: float, cost: int) -> RateLimitResult:
+        if cost == 0:
+            # Reading the allowance must not claim (or evict) a slot for an unseen key
+            index = table.find(shard, fingerprint, now)
+            if index < 0:
+                return self._unused(policy, now)
+            return self._decide(policy, shard, index, True, now, cost)
+        index, found = table.claim(shard, fingerprint, now)
+        return self._decide(policy, shard, index, found, now, cost)
+
+    def reset(self, policy: RateLimitPolicy, key: str, now: Optional[float] = None) -> bool:
+        """Forget ``key``'s state; returns whether it had any"""
+        if now is None:
+            now = time.time()
+        table = self._table_for(policy)
+        fingerprint = (hash(key) ^ policy.salt) or 1
+        shard = table.shard_for(fingerprint)
+        with shard.lock or _NO_LOCK:
+            index = table.find(shard, fingerprint, now)
+            if index < 0:
+                return False
+            shard.expires[index] = 0.0
+            return True
+
+    def peek(self, policy: RateLimitPolicy, key: str, now: Optional[float] = None) -> Dict[str, Any]:
+        """Raw state for ``key`` (empty when it has none)"""
+        if now is None:
+            now = time.time()
+        table = self._table_for(policy)
+        fingerprint = (hash(key) ^ policy.salt) or 1
+        shard = table.shard_for(fingerprint)
+        with shard.lock or _NO_LOCK:
+            index = table.find(shard, fingerprint, now)
+            if index < 0:
+                return {}
+            base = index * table.width
+            return {'expires': shard.expires[index], 'state': list(shard.values[base:base + min(table.width, 3)])}
+
+    @staticmethod
+    def _unused(policy: RateLimitPolicy, now: float) -> RateLimitResult:
+        """What a zero-cost check reports for a key with no state"""
+        algorithm = policy.algorithm
+        if algorithm is RateLimitAlgorithm.GCRA:
+            return RateLimitResult(allowed=True, remaining=policy.burst, reset_time=now, limit=policy.burst)
+        if algorithm is RateLimitAlgorithm.SLIDING_LOG:
+            reset_time = now + policy.period
+        else:
+            reset_time = (now // policy.period + 1) * policy.period
+        return RateLimitResult(allowed=True, remaining=policy.limit, reset_time=reset_time, limit=policy.limit)
+
+    def _table_for(self, policy: RateLimitPolicy) -> RateLimitTable:
+        if policy.algorithm is not RateLimitAlgorithm.SLIDING_LOG:
+            return self.table
+        table = policy._log_table
+        if table is None:
+            width = policy.limit + 1
+            # Largest power-of-two table whose slots (16 + 8 * width bytes each) fit in log_memory
+            budget = self.log_memory // (16 + 8 * width)
+            probe = 8
+            if budget < probe:
+                raise ValueError(f"log_memory of {self.log_memory} bytes cannot hold "
+                                 f"{probe} sliding logs of {policy.limit} entries")
+            slots = 1 << (budget.bit_length() - 1)
+            table = policy._log_table = RateLimitTable(slots, shards=min(16, slots // probe), width=width,
+                                                       probe=probe, thread_safe=self.thread_safe)
+        return table
+
+    def _decide(self, policy: RateLimitPolicy, shard: _Shard, index: int, found: bool,
+                now: float, cost: int) -> RateLimitResult:
+        algorithm = policy.algorithm
+        if algorithm is RateLimitAlgorithm.GCRA:
+            return self._gcra(policy, shard, index, found, now, cost)
+        if algorithm is RateLimitAlgorithm.SLIDING_WINDOW:
+            return self._sliding_window(policy, shard, index, found, now, cost)
+        if algorithm is RateLimitAlgorithm.FIXED_WINDOW:
+            return self._fixed_window(policy, shard, index, found, now, cost)
+        return self._sliding_log(policy, shard, index, found, now, cost)
+
+    def _gcra(self, policy, shard, index, found, now, cost) -> RateLimitResult:
+        values = shard.values
+        base = index * self.table.width
+        tat = values[base] if found else now
+        if tat < now:
+            tat = now
+        new_tat = tat + policy.interval * cost
+        allow_at = new_tat - policy.tolerance
+        if now < allow_at:
+            if not found:
+                shard.expires[index] = 0.0
+            return RateLimitResult(allowed=False, remaining=0, reset_time=tat,
+                                   retry_after=allow_at - now, limit=policy.burst)
+        values[base] = new_tat
+        shard.expires[index] = new_tat
+        return RateLimitResult(allowed=True, remaining=int((now - allow_at) / policy.interval),
+                               reset_time=new_tat, limit=policy.burst)
+
+    def _fixed_window(self, policy, shard, index, found, now, cost) -> RateLimitResult:
+        values = shard.values
+        base = index * self.table.width
+        window = now // policy.period
+        count = values[base + 1] if found and values[base] == window else 0.0
+        reset_time = (window + 1) * policy.period
+        if count + cost > policy.limit:
+            if not found:
+                shard.expires[index] = 0.0
+            return RateLimitResult(allowed=False, remaining=0, reset_time=reset_time,
+                                   retry_after=reset_time - now, limit=policy.limit)
+        values[base] = window
+        values[base + 1] = count + cost
+        shard.expires[index] = reset_time
+        return RateLimitResult(allowed=True, remaining=int(policy.limit - count - cost),
+                               reset_time=reset_time, limit=policy.limit)
+
+    def _sliding_window(self, policy, shard, index, found, now, cost) -> RateLimitResult:
+        values = shard.values
+        base = index * self.table.width
+        period, limit = policy.period, policy.limit
+        position = now / period
+        window = position // 1
+        current = previous = 0.0
+        if found:
+            stored = values[base]
+            if stored == window:
+                current, previous = values[base + 1], values[base + 2]
+            elif stored == window - 1:
+                previous = values[base + 1]
+        overlap = 1.0 - (position - window)
+        estimate = previous * overlap + current
+        reset_time = (window + 1) * period
+        if estimate + cost > limit:
+            if not found:
+                shard.expires[index] = 0.0
+            # When will the previous window's weight have decayed enough?
+            spare = limit - current - cost
+            if spare < 0 or previous <= 0:
+                retry_after = reset_time - now
+            else:
+                retry_after = max((window + 1 - spare / previous) * period - now, 0.0)
+            return RateLimitResult(allowed=False, remaining=0, reset_time=reset_time,
+                                   retry_after=retry_after, limit=limit)
+        values[base] = window
+        values[base + 1] = current + cost
+        values[base + 2] = previous
+        shard.expires[index] = (window + 2) * period
+        return RateLimitResult(allowed=True, remaining=int(limit - estimate - cost),
+                               reset_time=reset_time, limit=limit)
+
+    def _sliding_log(self, policy, shard, index, found, now, cost) -> RateLimitResult:
+        values = shard.values
+        limit = policy.limit
+        base = index * (limit + 1)
+        if not found:
+            # Empty ring slots are older than any window
+            values[base:base + limit + 1] = array('d', [0.0] + [float('-inf')] * limit)
+        head = int(values[base])
+        ring = base + 1
+        cutoff = now - policy.period
+        if cost > limit:
+            return RateLimitResult(allowed=False, remaining=0, reset_time=now + policy.period,
+                                   retry_after=None, limit=limit)
+
+        # Entries from head on are oldest-first; count those outside the window
+        low, high = 0, limit
+        while low < high:
+            middle = (low + high) // 2
+            if values[ring + (head + middle) % limit] <= cutoff:
+                low = middle + 1
+            else:
+                high = middle
+        expired = low
+        if expired < cost:
+            blocking = values[ring + (head + cost - 1) % limit]
+            return RateLimitResult(allowed=False, remaining=0, reset_time=blocking + policy.period,
+                                   retry_after=blocking + policy.period - now, limit=limit)
+        for _ in range(cost):
+            values[ring + head] = now
+            head = (head + 1) % limit
+        values[base] = head
+        shard.expires[index] = now + policy.period
+        oldest_live = values[ring + (head + expired - cost) % limit]
+        return RateLimitResult(allowed=True, remaining=expired - cost,
+                               reset_time=oldest_live + policy.period, limit=limit)
+
+
+_default_engine: Optional[RateLimitEngine] = None
+
+
+def get_rate_limit_engine() -> RateLimitEngine:
+    """Process-wide engine shared by limiters that don't bring their own"""
+    global _default_engine
+    if _default_engine is None:
+        _default_engine = RateLimitEngine()
+    return _default_engine
+
+
 class RateLimitBackend(ABC):
     """Abstract base class for rate limiting backends"""
 
@@ -59,121 +448,190 @@ class RateLimitBackend(ABC):
         pass
 
     @abstractmethod
-    async def reset_limit(self, key: str) -> bool:
-        """Reset rate limit for a key"""
+    async def reset_limit(self, key: str, config: Optional[RateLimitConfig] = None) -> bool:
+        """Reset rate limit for a key under ``config``, or under every config checked so far"""
         pass
 
     @abstractmethod
-    def get_stats(self, key: str) -> Dict[str, Any]:
-        """Get statistics for a key"""
+    def get_stats(self, key: str, config: Optional[RateLimitConfig] = None) -> Dict[str, Any]:
+        """Get statistics for a key under ``config``, or under the first config holding state"""
         pass
 
+    def _policy(self, config: RateLimitConfig) -> RateLimitPolicy:
+        """Compiled policy for a config, cached by identity"""
+        policies = getattr(self, '_policies', None)
+        if policies is None:
+            policies = self._policies = {}
+        entry = policies.get(id(config))
+        if entry is None or entry[0] is not config:
+            entry = policies[id(config)] = (config, RateLimitPolicy.from_config(config))
+        return entry[1]
+
+    def _policies_for(self, config: Optional[RateLimitConfig]) -> List[RateLimitPolicy]:
+        """The policy for ``config``, or every policy compiled so far"""
+        if config is not None:
+            return [self._policy(config)]
+        return [policy for _, policy in getattr(self, '_policies', {}).values()]
+
 
 class InMemoryRateLimitBackend(RateLimitBackend):
-    """In-memory rate limiting backend using token bucket algorithm"""
+    """In-process backend over a ``RateLimitEngine`` (the shared one by default)"""
 
-    def __init__(self):
-        self._buckets: Dict[str, Dict[str, Any]] = {}
-        self._lock = threading.RLock()
+    def __init__(self, engine: Optional[RateLimitEngine] = None):
+        self.engine = engine or get_rate_limit_engine()
 
     async def check_limit(self, key: str, config: RateLimitConfig) -> RateLimitResult:
-        """Check rate limit using token bucket algorithm"""
-        with self._lock:
-            now = time.time()
+        """Check rate limit for a key"""
+        return self.engine.check(self._policy(config), key)
 
-            if key not in self._buckets:
-                self._buckets[key] = {
-                    'tokens': config.capacity,
-                    'last_refill': now,
-                    'created': now
-                }
-
-            bucket = self._buckets[key]
-
-            # Refill tokens
-            elapsed = now - bucket['last_refill']
-            if elapsed >= config.refill_interval:
-                tokens_to_add = int(elapsed / config.refill_interval) * config.refill_rate
-                if tokens_to_add > 0:
-                    bucket['tokens'] = min(config.burst_capacity, bucket['tokens'] + tokens_to_add)
-                    bucket['last_refill'] = now
-
-            # Check if we have enough tokens
-            if bucket['tokens'] >= 1:
-                bucket['tokens'] -= 1
-                remaining = int(bucket['tokens'])
-                reset_time = bucket['last_refill'] + config.refill_interval
-                return RateLimitResult(
-                    allowed=True,
-                    remaining=remaining,
-                    reset_time=reset_time,
-                    limit=config.capacity
-                )
-            else:
-                # Calculate retry after time
-                tokens_needed = 1 - bucket['tokens']
-                retry_after = (tokens_needed / config.refill_rate) * config.refill_interval
-                reset_time = bucket['last_refill'] + config.refill_interval
-
-                return RateLimitResult(
-                    allowed=False,
-                    remaining=0,
-                    reset_time=reset_time,
-                    retry_after=retry_after,
-                    limit=config.capacity
-                )
-
-    async def reset_limit(self, key: str) -> bool:
+    async def reset_limit(self, key: str, config: Optional[RateLimitConfig] = None) -> bool:
         """Reset rate limit for a key"""
-        with self._lock:
-            if key in self._buckets:
-                self._buckets[key]['tokens'] = self._buckets[key].get('capacity', 100)
-                self._buckets[key]['last_refill'] = time.time()
-                return True
-            return False
-
-    def get_stats(self, key: str) -> Dict[str, Any]:
+        results = [self.engine.reset(policy, key) for policy in self._policies_for(config)]
+        return any(results)
+
+    def get_stats(self, key: str, config: Optional[RateLimitConfig] = None) -> Dict[str, Any]:
         """Get statistics for a key"""
-        with self._lock:
-            if key in self._buckets:
-                bucket = self._buckets[key]
-                return {
-                    'tokens': bucket['tokens'],
-                    'last_refill': bucket['last_refill'],
-                    'created': bucket['created'],
-                    'age': time.time() - bucket['created']
-                }
-            return {}
+        for policy in self._policies_for(config):
+            stats = self.engine.peek(policy, key)
+            if stats:
+                return stats
+        return {}
+
 
+# Redis scripts: each returns {allowed, remaining, reset_after, retry_after} using the
+# server clock, so every worker and node shares one view of time. Each keeps all of
+# its state under KEYS[1], so resetting a key is one DEL.
+_REDIS_PRELUDE = """
+local t = redis.call('TIME')
+local now = tonumber(t[1]) + tonumber(t[2]) / 1000000
+local limit = tonumber(ARGV[1])
+local period = tonumber(ARGV[2])
+local burst = tonumber(ARGV[3])
+local cost = tonumber(ARGV[4])
+"""
+
+_REDIS_SCRIPTS = {
+    RateLimitAlgorithm.GCRA: _REDIS_PRELUDE + """
+local interval = period / limit
+local tat = tonumber(redis.call('GET', KEYS[1]) or now)
+if tat < now then tat = now end
+local new_tat = tat + interval * cost
+local allow_at = new_tat - interval * burst
+if now < allow_at then
+  return {0, 0, tostring(tat - now), tostring(allow_at - now)}
+end
+redis.call('SET', KEYS[1], tostring(new_tat), 'PX', math.ceil((new_tat - now) * 1000))
+return {1, math.floor((now - allow_at) / interval), tostring(new_tat - now), '0'}
+""",
+    RateLimitAlgorithm.FIXED_WINDOW: _REDIS_PRELUDE + """
+local window = math.floor(now / period)
+local state = redis.call('HMGET', KEYS[1], 'w', 'c')
+local count = 0
+if tonumber(state[1]) == window then count = tonumber(state[2]) end
+local reset_after = (window + 1) * period - now
+if count + cost > limit then
+  return {0, 0, tostring(reset_after), tostring(reset_after)}
+end
+redis.call('HSET', KEYS[1], 'w', window, 'c', count + cost)
+redis.call('PEXPIRE', KEYS[1], math.ceil(reset_after * 1000))
+return {1, limit - count - cost, tostring(reset_after), '0'}
+""",
+    RateLimitAlgorithm.SLIDING_WINDOW: _REDIS_PRELUDE + """
+local window = math.floor(now / period)
+local state = redis.call('HMGET', KEYS[1], 'w', 'c', 'p')
+local stored = tonumber(state[1])
+local current, previous = 0, 0
+if stored == window then
+  current, previous = tonumber(state[2]), tonumber(state[3])
+elseif stored == window - 1 then
+  previous = tonumber(state[2])
+end
+local estimate = previous * (1 - (now / period - window)) + current
+local reset_after = (window + 1) * period - now
+if estimate + cost > limit then
+  return {0, 0, tostring(reset_after), tostring(reset_after)}
+end
+redis.call('HSET', KEYS[1], 'w', window, 'c', current + cost, 'p', previous)
+redis.call('PEXPIRE', KEYS[1], math.ceil((reset_after + period) * 1000))
+return {1, math.floor(limit - estimate - cost), tostring(reset_after), '0'}
+""",
+    RateLimitAlgorithm.SLIDING_LOG: _REDIS_PRELUDE + """
+redis.call('ZREMRANGEBYSCORE', KEYS[1], '-inf', now - period)
+local count = redis.call('ZCARD', KEYS[1])
+if count + cost > limit then
+  local oldest = redis.call('ZRANGE', KEYS[1], 0, 0, 'WITHSCORES')
+  local retry = tonumber(oldest[2]) + period - now
+  return {0, 0, tostring(retry), tostring(retry)}
+end
+for i = 1, cost do
+  redis.call('ZADD', KEYS[1], now, now .. ':' .. i .. ':' .. math.random())
+end
+redis.call('PEXPIRE', KEYS[1], math.ceil(period * 1000))
+return {1, limit - count - cost, tostring(period), '0'}
+""",
+}
+
+
+class RedisRateLimitBackend(RateLimitBackend):
+    """
+    Cluster-wide backend: each check is one Lua script on Redis.
 
-class DistributedRateLimitBackend(RateLimitBackend):
-    """Distributed rate limiting backend (Redis, etc.)"""
+    Limits then hold across workers and nodes. The scripts use the Redis
+    server clock, so nodes with skewed clocks still agree. Keys are
+    namespaced by policy parameters (not the in-memory random salt), so
+    every node maps one config to the same Redis key.
 
-    def __init__(self, backend: Any):
-        self.backend = backend  # Redis, database, etc.
+    Args:
+        client: ``redis.asyncio`` client
+        prefix: Key prefix
+    """
+
+    def __init__(self, client: Any, prefix: str = "pyserv:ratelimit:"):
+        self.client = client
+        self.prefix = prefix
+        self._scripts: Dict[RateLimitAlgorithm, Any] = {}
+
+    def _script(self, algorithm: RateLimitAlgorithm):
+        script = self._scripts.get(algorithm)
+        if script is None:
+            script = self._scripts[algorithm] = self.client.register_script(_REDIS_SCRIPTS[algorithm])
+        return script
 
     async def check_limit(self, key: str, config: RateLimitConfig) -> RateLimitResult:
-        """Check rate limit using distributed backend"""
-        # Implementation would depend on the specific backend
-        # For now, return allowed
+        """Check rate limit for a key on Redis"""
+        policy = self._policy(config)
+        allowed, remaining, reset_after, retry_after = await self._script(policy.algorithm)(
+            keys=[self._key(policy, key)], args=[policy.limit, policy.period, policy.burst, 1])
+        now = time.time()
         return RateLimitResult(
-            allowed=True,
-            remaining=config.capacity - 1,
-            reset_time=time.time() + config.window_size,
-            limit=config.capacity
+            allowed=bool(allowed),
+            remaining=int(remaining),
+            reset_time=now + float(reset_after),
+            retry_after=None if allowed else float(retry_after),
+            limit=policy.burst if policy.algorithm is RateLimitAlgorithm.GCRA else policy.limit,
         )
 
-    async def reset_limit(self, key: str) -> bool:
+    def _key(self, policy: RateLimitPolicy, key: str) -> str:
+        return f"{self.prefix}{policy.algorithm.value}:{policy.limit}:{policy.period:g}:{policy.burst}:{key}"
+
+    async def reset_limit(self, key: str, config: Optional[RateLimitConfig] = None) -> bool:
         """Reset rate limit for a key"""
-        # Implementation would depend on the specific backend
-        return True
+        keys = [self._key(policy, key) for policy in self._policies_for(config)]
+        return bool(keys) and bool(await self.client.delete(*keys))
 
-    def get_stats(self, key: str) -> Dict[str, Any]:
-        """Get statistics for a key"""
-        # Implementation would depend on the specific backend
+    def get_stats(self, key: str, config: Optional[RateLimitConfig] = None) -> Dict[str, Any]:
+        """Statistics live in Redis; nothing is tracked locally"""
         return {}
 
 
+class DistributedRateLimitBackend(RedisRateLimitBackend):
+    """Distributed rate limiting backend; ``backend`` is a ``redis.asyncio`` client"""
+
+    def __init__(self, backend: Any, prefix: str = "pyserv:ratelimit:"):
+        super().__init__(backend, prefix)
+        self.backend = backend
+
+
 class RateLimiter:
     """
     Unified rate limiter with support for multiple backends and algorithms.
@@ -226,12 +684,12 @@ class RateLimiter:
     async def reset_limit(self, request: Any) -> bool:
         """Reset rate limit for a request"""
         key = self.key_func(request)
-        return await self.backend.reset_limit(key)
+        return await self.backend.reset_limit(key, self.config)
 
     def get_stats(self, request: Any) -> Dict[str, Any]:
         """Get statistics for a request"""
         key = self.key_func(request)
-        return self.backend.get_stats(key)
+        return self.backend.get_stats(key, self.config)
 
     @classmethod
     def create_token_bucket(cls,
@@ -299,8 +757,13 @@ __all__ = [
     'RateLimitAlgorithm',
     'RateLimitConfig',
     'RateLimitResult',
+    'RateLimitPolicy',
+    'RateLimitTable',
+    'RateLimitEngine',
+    'get_rate_limit_engine',
     'RateLimitBackend',
     'InMemoryRateLimitBackend',
+    'RedisRateLimitBackend',
     'DistributedRateLimitBackend',
     'RateLimiter',
     'RateLimitExceeded',
@@ -9,6 +9,9 @@ import os
 import shutil
 import hashlib
 import fnmatch
+import mimetypes
+import re
+import stat as stat_module
 from pathlib import Path
 from typing import List, Dict, Set, Optional, Tuple, TYPE_CHECKING, Union, Any
 from dataclasses import dataclass
@@ -16,6 +19,16 @@ from urllib.parse import urljoin
 
 if TYPE_CHECKING:
     from pyserv.server.config import StaticFilesConfig
+    from pyserv.http.response import FileResponse
+
+# Cache-Control for content-hashed files, whose URL changes with their content
+IMMUTABLE_CACHE_CONTROL = "public, max-age=31536000, immutable"
+
+# Names produced by add_file_hashing(), e.g. app.3f2a1b9c8d7e.css
+_HASHED_NAME = re.compile(r'\.[0-9a-f]{12}(\.[^./]+)?$')
+
+# File suffix of each precompressed variant, in serving preference order
+PRECOMPRESSED_SUFFIXES = {'br': '.br', 'zstd': '.zst', 'gzip': '.gz'}
 
 
 @dataclass
@@ -39,6 +52,7 @@ class StaticFilesManager:
         self.config = config
         self.collected_files: List[StaticFile] = []
         self.hashed_files: Dict[str, str] = {}
+        self._hashed_names: Set[str] = set()
 
     def collect_static_files(self, clear: bool = False, verbosity: int = 1) -> Dict[str, int]:
         """
@@ -183,12 +197,76 @@ class StaticFilesManager:
                     print(f"Created {hashed_name}")
 
         self.hashed_files = hashed_files
+        self._hashed_names = set(hashed_files.values())
 
         if verbosity >= 1:
             print(f"Created {len(hashed_files)} hashed versions")
 
         return hashed_files
 
+    def precompress_files(self, encodings: Optional[List[str]] = None, min_size: int = 1024,
+                          verbosity: int = 1) -> Dict[str, int]:
+        """
+        Write precompressed variants (app.css.br, app.css.gz) next to
+        collected files, at maximum compression level.
+
+        Only compressible types are processed, variants that are already
+        newer than their source are kept, and a variant that would not be
+        smaller than the original is not written.
+
+        Returns:
+            Dict with counts of written and skipped variants
+        """
+        from pyserv.http import compression
+
+        if encodings is None:
+            encodings = getattr(self.config, 'precompress_encodings', ['br', 'gzip'])
+        available = compression.available_encodings()
+        encodings = [e.strip() for e in encodings if e.strip() in PRECOMPRESSED_SUFFIXES]
+        for encoding in encodings:
+            if encoding not in available and verbosity >= 1:
+                print(f"Skipping {encoding} precompression: no compressor installed")
+        encodings = [e for e in encodings if e in available]
+
+        static_root = Path(self.config.root)
+        names = [f.relative_path for f in self.collected_files] + list(self._hashed_names)
+        written = skipped = 0
+
+        for relative_path in names:
+            file_path = static_root / relative_path
+            media_type, _ = mimetypes.guess_type(relative_path)
+            try:
+                source_stat = file_path.stat()
+            except OSError:
+                continue
+            if source_stat.st_size < min_size or not compression.is_compressible(media_type):
+                continue
+
+            data = None
+            for encoding in encodings:
+                variant = file_path.with_name(file_path.name + PRECOMPRESSED_SUFFIXES[encoding])
+                try:
+                    if variant.stat().st_mtime >= source_stat.st_mtime:
+                        skipped += 1
+                        continue
+                except OSError:
+                    pass
+                if data is None:
+                    data = file_path.read_bytes()
+                encoded = compression.compress(data, encoding, compression.MAX_LEVELS[encoding])
+                if len(encoded) >= len(data):
+                    skipped += 1
+                    continue
+                variant.write_bytes(encoded)
+                written += 1
+                if verbosity >= 2:
+                    print(f"Compressed {relative_path} ({encoding}): {len(data)} -> {len(encoded)} bytes")
+
+        if verbosity >= 1:
+            print(f"Wrote {written} precompressed variants")
+
+        return {'written': written, 'skipped': skipped}
+
     def get_static_url(self, path: str) -> str:
         """
         Get the full URL for a static file, considering CDN settings.
@@ -208,6 +286,101 @@ class StaticFilesManager:
             # Use local URL
             return urljoin(self.config.url.rstrip('/') + '/', path.lstrip('/'))
 
+    def file_response(self, path: str, accept_encoding: Optional[str] = None,
+                      **kwargs) -> Optional['FileResponse']:
+        """
+        Build a streaming response for a file in STATIC_ROOT.
+
+        Hashed names created by add_file_hashing() get a far-future
+        immutable Cache-Control; other files use config.max_age. When a
+        precompressed variant the client accepts exists, it is sent as is
+        with Content-Encoding set, so nothing is compressed per request.
+
+        Args:
+            path: Path relative to STATIC_ROOT (or the STATIC_URL path)
+            accept_encoding: The request's Accept-Encoding header
+
+        Returns:
+            FileResponse, or None if the file is missing or outside STATIC_ROOT
+        """
+        from pyserv.http.response import FileResponse
+
+        url_prefix = self.config.url.rstrip('/') + '/'
+        if path.startswith(url_prefix):
+            path = path[len(url_prefix):]
+        relative_path = path.lstrip('/')
+
+        static_root = Path(self.config.root).resolve()
+        file_path = (static_root / relative_path).resolve()
+        if static_root not in file_path.parents:
+            return None
+
+        try:
+            file_stat = file_path.stat()
+        except OSError:
+            return None
+        if not stat_module.S_ISREG(file_stat.st_mode):
+            return None
+
+        headers = kwargs.pop('headers', None) or {}
+        variants = self._precompressed_variants(file_path)
+        if variants:
+            from pyserv.http import compression
+
+            compression.add_vary(headers)
+            encoding = compression.negotiate(accept_encoding, list(variants))
+            if encoding:
+                variant_path, variant_stat = variants[encoding]
+                media_type, _ = mimetypes.guess_type(file_path.name)
+                kwargs.setdefault('media_type', media_type or 'application/octet-stream')
+                kwargs.setdefault('filename', file_path.name)
+                headers['content-encoding'] = encoding
+                file_path, file_stat = variant_path, variant_stat
+
+        if relative_path in self._hashed_names or _HASHED_NAME.search(relative_path):
+            headers.setdefault('cache-control', IMMUTABLE_CACHE_CONTROL)
+        else:
+            headers.setdefault('cache-control', f"public, max-age={getattr(self.config, 'max_age', 3600)}")
+
+        return FileResponse(
+            file_path,
+            headers=headers,
+            content_disposition=None,
+            stat_result=file_stat,
+            **kwargs
+        )
+
+    @staticmethod
+    def _precompressed_variants(file_path: Path) -> Dict[str, Tuple[Path, os.stat_result]]:
+        """Existing precompressed siblings of a file, keyed by content-coding."""
+        variants = {}
+        for encoding, suffix in PRECOMPRESSED_SUFFIXES.items():
+            variant = file_path.with_name(file_path.name + suffix)
+            try:
+                variant_stat = variant.stat()
+            except OSError:
+                continue
+            if stat_module.S_ISREG(variant_stat.st_mode):
+                variants[encoding] = (variant, variant_stat)
+        return variants
+
+    def create_handler(self):
+        """
+        Create a route handler serving STATIC_URL paths from STATIC_ROOT.
+
+        Example:
+            app.router.add_route('/static/*', manager.create_handler(), ['GET', 'HEAD'])
+        """
+        from pyserv.http.response import Response
+
+        async def static_handler(request, **kwargs):
+            response = self.file_response(request.path, request.headers.get('accept-encoding'))
+            if response is None:
+                return Response(status_code=404, content="File not found")
+            return response
+
+        return static_handler
+
     def _find_static_files(self, source_dir: Path) -> List[StaticFile]:
         """Find all static files in a source directory"""
         files = []
@@ -292,6 +465,7 @@ def collectstatic(
     clear: bool = False,
     deploy_cdn: bool = False,
     add_hashing: bool = False,
+    precompress: Optional[bool] = None,
     verbosity: int = 1
 ) -> Dict[str, any]:
     """
@@ -302,6 +476,7 @@ def collectstatic(
         clear: Clear STATIC_ROOT before collecting
         deploy_cdn: Deploy to CDN after collecting
         add_hashing: Add hash-based versioning
+        precompress: Write .br/.gz variants (default: config.precompress)
         verbosity: Verbosity level
 
     Returns:
@@ -318,6 +493,14 @@ def collectstatic(
     else:
         hashing_result = {}
 
+    # Precompress after hashing so hashed names get variants too
+    if precompress is None:
+        precompress = getattr(config, 'precompress', False)
+    if precompress:
+        compression_result = manager.precompress_files(verbosity=verbosity)
+    else:
+        compression_result = {'written': 0, 'skipped': 0}
+
     # Deploy to CDN if requested
     if deploy_cdn:
         cdn_result = manager.deploy_to_cdn(verbosity=verbosity)
@@ -327,6 +510,7 @@ def collectstatic(
     return {
         'collection': collection_result,
         'hashing': hashing_result,
+        'compression': compression_result,
         'cdn': cdn_result,
         'manager': manager
     }
@@ -351,6 +535,7 @@ def cmd_collectstatic(args):
         clear=getattr(args, 'clear', False),
         deploy_cdn=getattr(args, 'cdn', False),
         add_hashing=getattr(args, 'hash', False),
+        precompress=getattr(args, 'compress', False) or None,
         verbosity=1
     )
 
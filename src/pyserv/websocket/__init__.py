@@ -6,8 +6,15 @@ and real-time communication components.
 """
 
 from .websocket import WebSocket
+from .hub import (
+    Backplane, InMemoryBackplane, NatsBackplane, OverflowPolicy, RedisBackplane,
+    WebSocketHub, get_websocket_hub,
+)
 
-__all__ = ['WebSocket']
+__all__ = [
+    'WebSocket', 'WebSocketHub', 'get_websocket_hub', 'OverflowPolicy',
+    'Backplane', 'InMemoryBackplane', 'RedisBackplane', 'NatsBackplane',
+]
 
 
 
@@ -0,0 +1,549 @@
+"""
+WebSocket topic hub for Pyserv framework.
+
+Connections subscribe to topics and messages are published to topics.
+Each published message is serialised once. It is then pushed into a
+bounded send queue per subscriber, drained by one writer task per
+connection, so publishing never waits on a client. An idle writer sends
+a frame as soon as it is queued. A writer that has fallen behind waits
+up to ``flush_interval`` and sends everything queued by then in one go.
+With ``batch_frames`` it merges queued JSON messages into a single array
+frame.
+
+With several worker processes, a ``Backplane`` carries publishes between
+them. Each process only subscribes to the backplane for topics that have
+local subscribers, so topic traffic goes only to the processes that need
+it.
+"""
+
+import asyncio
+import logging
+import time
+import uuid
+from abc import ABC, abstractmethod
+from collections import deque
+from enum import Enum
+from typing import Any, Awaitable, Callable, Deque, Dict, List, Optional, Set, Tuple, Union
+
+from pyserv.core import codec
+from pyserv.streaming.frames import StreamFrame
+
+logger = logging.getLogger(__name__)
+
+# A serialised message: (is_text, payload, is_json)
+Frame = Tuple[bool, Union[str, bytes], bool]
+
+BackplaneHandler = Callable[[str, bool, Union[str, bytes], bool], Awaitable[None]]
+
+
+class OverflowPolicy(str, Enum):
+    """What to do when a subscriber's send queue is full"""
+    DROP_OLDEST = "drop_oldest"
+    DISCONNECT = "disconnect"
+
+
+def encode_message(message: Any) -> Frame:
+    """Serialise a message once for every subscriber"""
+    if isinstance(message, bytes):
+        return False, message, False
+    if isinstance(message, StreamFrame):
+        return False, message.to_bytes(), False
+    if isinstance(message, str):
+        return True, message, False
+    return True, codec.dumps_str(message), True
+
+
+class TopicStats:
+    """Counters for one topic"""
+
+    __slots__ = ('published', 'delivered', 'dropped', 'disconnects', 'bytes_out', 'remote')
+
+    def __init__(self):
+        self.published = 0
+        self.delivered = 0
+        self.dropped = 0
+        self.disconnects = 0
+        self.bytes_out = 0
+        self.remote = 0
+
+    def to_dict(self) -> Dict[str, int]:
+        return {name: getattr(self, name) for name in self.__slots__}
+
+
+class HubConnection:
+    """A subscribed WebSocket with its send queue and writer task"""
+
+    def __init__(self, websocket: Any, queue_size: int):
+        self.id = str(uuid.uuid4())
+        self.websocket = websocket
+        self.topics: Set[str] = set()
+        self.queue: Deque[Tuple[str, Frame]] = deque()
+        self.queue_size = queue_size
+        self.writer_task: Optional[asyncio.Task] = None
+        self.closed = False
+        self._ready = asyncio.Event()
+
+    def put(self, topic: str, frame: Frame, policy: OverflowPolicy) -> Optional[bool]:
+        """Queue a frame. Returns True if queued, None if it displaced the oldest, False if full."""
+        queue = self.queue
+        displaced = False
+        if len(queue) >= self.queue_size:
+            if policy is OverflowPolicy.DISCONNECT:
+                return False
+            queue.popleft()
+            displaced = True
+        queue.append((topic, frame))
+        self._ready.set()
+        return None if displaced else True
+
+    async def wait(self) -> bool:
+        """Wait for queued frames; False once closed and drained"""
+        while not self.queue:
+            if self.closed:
+                return False
+            self._ready.clear()
+            await self._ready.wait()
+        return True
+
+    def take(self) -> List[Tuple[str, Frame]]:
+        batch = list(self.queue)
+        self.queue.clear()
+        return batch
+
+    def close(self) -> None:
+        self.closed = True
+        self._ready.set()
+
+
+class Backplane(ABC):
+    """Carries publishes between hub instances in different processes"""
+
+    @abstractmethod
+    async def start(self, node_id: str, handler: BackplaneHandler) -> None:
+        """Connect; ``handler(topic, is_text, payload, is_json)`` receives other nodes' messages"""
+
+    @abstractmethod
+    async def publish(self, topic: str, frame: Frame) -> None:
+        """Send a frame to the other nodes subscribed to ``topic``"""
+
+    @abstractmethod
+    async def subscribe(self, topic: str) -> None:
+        """Start receiving ``topic``"""
+
+    @abstractmethod
+    async def unsubscribe(self, topic: str) -> None:
+        """Stop receiving ``topic``"""
+
+    async def close(self) -> None:
+        """Disconnect"""
+
+
+def _pack(node_id: str, frame: Frame) -> bytes:
+    is_text, payload, is_json = frame
+    kind = b'j' if is_json else (b't' if is_text else b'b')
+    body = payload.encode('utf-8') if is_text else payload
+    return node_id.encode('ascii') + b'|' + kind + body
+
+
+def _unpack(data: bytes) -> Tuple[str, Frame]:
+    node_id, _, rest = data.partition(b'|')
+    kind, body = rest[:1], rest[1:]
+    if kind == b'b':
+        return node_id.decode('ascii'), (False, body, False)
+    return node_id.decode('ascii'), (True, body.decode('utf-8'), kind == b'j')
+
+
+class InMemoryBackplane(Backplane):
+    """Backplane between hubs in one process, for tests and single-host setups"""
+
+    def __init__(self):
+        self._nodes: Dict[str, Tuple[BackplaneHandler, Set[str]]] = {}
+
+    def attach(self) -> 'InMemoryBackplane':
+        """A view of this backplane for one more hub"""
+        view = InMemoryBackplane()
+        view._nodes = self._nodes
+        return view
+
+    async def start(self, node_id: str, handler: BackplaneHandler) -> None:
+        self._node_id = node_id
+        self._nodes[node_id] = (handler, set())
+
+    async def publish(self, topic: str, frame: Frame) -> None:
+        node_id, frame = _unpack(_pack(self._node_id, frame))
+        for other, (handler, topics) in list(self._nodes.items()):
+            if other != node_id and topic in topics:
+                await handler(topic, *frame)
+
+    async def subscribe(self, topic: str) -> None:
+        self._nodes[self._node_id][1].add(topic)
+
+    async def unsubscribe(self, topic: str) -> None:
+        self._nodes[self._node_id][1].discard(topic)
+
+    async def close(self) -> None:
+        self._nodes.pop(getattr(self, '_node_id', None), None)
+
+
+class RedisBackplane(Backplane):
+    """Redis pub/sub backplane; one Redis channel per topic"""
+
+    def __init__(self, url: str = "redis://localhost:6379/0", prefix: str = "pyserv:ws:"):
+        self.url = url
+        self.prefix = prefix
+        self._redis = None
+        self._pubsub = None
+        self._reader: Optional[asyncio.Task] = None
+
+    async def start(self, node_id: str, handler: BackplaneHandler) -> None:
+        import redis.asyncio as aioredis
+
+        self._node_id = node_id
+        self._handler = handler
+        self._redis = aioredis.from_url(self.url)
+        self._pubsub = self._redis.pubsub(ignore_subscribe_messages=True)
+
+    async def _read_loop(self) -> None:
+        while True:
+            try:
+                message = await self._pubsub.get_message(timeout=1.0)
+                if message is None:
+                    continue
+                node_id, frame = _unpack(message['data'])
+                if node_id != self._node_id:
+                    channel = message['channel']
+                    channel = channel.decode() if isinstance(channel, bytes) else channel
+                    await self._handler(channel[len(self.prefix):], *frame)
+            except asyncio.CancelledError:
+                raise
+            except Exception as e:
+                logger.error(f"Redis backplane read failed: {e}")
+                await asyncio.sleep(1.0)
+
+    async def publish(self, topic: str, frame: Frame) -> None:
+        await self._redis.publish(self.prefix + topic, _pack(self._node_id, frame))
+
+    async def subscribe(self, topic: str) -> None:
+        await self._pubsub.subscribe(self.prefix + topic)
+        # get_message fails until the pub/sub connection exists, which the first subscribe creates
+        if self._reader is None:
+            self._reader = asyncio.create_task(self._read_loop())
+
+    async def unsubscribe(self, topic: str) -> None:
+        await self._pubsub.unsubscribe(self.prefix + topic)
+
+    async def close(self) -> None:
+        if self._reader:
+            self._reader.cancel()
+        if self._pubsub is not None:
+            await self._pubsub.close()
+        if self._redis is not None:
+            await self._redis.close()
+
+
+class NatsBackplane(Backplane):
+    """NATS backplane; one subject per topic"""
+
+    def __init__(self, servers: Union[str, List[str]] = "nats://localhost:4222", prefix: str = "pyserv.ws."):
+        self.servers = servers
+        self.prefix = prefix
+        self._nc = None
+        self._subscriptions: Dict[str, Any] = {}
+
+    async def start(self, node_id: str, handler: BackplaneHandler) -> None:
+        import nats
+
+        self._node_id = node_id
+        self._handler = handler
+        self._nc = await nats.connect(servers=self.servers)
+
+    async def _on_message(self, message) -> None:
+        node_id, frame = _unpack(message.data)
+        if node_id != self._node_id:
+            await self._handler(message.subject[len(self.prefix):], *frame)
+
+    async def publish(self, topic: str, frame: Frame) -> None:
+        await self._nc.publish(self.prefix + topic, _pack(self._node_id, frame))
+
+    async def subscribe(self, topic: str) -> None:
+        self._subscriptions[topic] = await self._nc.subscribe(self.prefix + topic, cb=self._on_message)
+
+    async def unsubscribe(self, topic: str) -> None:
+        subscription = self._subscriptions.pop(topic, None)
+        if subscription is not None:
+            await subscription.unsubscribe()
+
+    async def close(self) -> None:
+        if self._nc is not None:
+            await self._nc.drain()
+
+
+class WebSocketHub:
+    """
+    Topic-based publish/subscribe over WebSockets.
+
+    Args:
+        queue_size: Frames each connection may have queued
+        flush_interval: Seconds a writer that found frames queued behind its
+            last flush waits so more can join the next one; idle writers
+            always send at once, and 0 never waits
+        batch_frames: Send queued JSON messages of one flush as a single
+            JSON array frame (clients must expect arrays)
+        overflow_policy: What to do when a connection's queue is full
+        backplane: Carries publishes to hubs in other worker processes
+    """
+
+    def __init__(self, queue_size: int = 256, flush_interval: float = 0.005,
+                 batch_frames: bool = False,
+                 overflow_policy: OverflowPolicy = OverflowPolicy.DROP_OLDEST,
+                 backplane: Optional[Backplane] = None):
+        self.queue_size = queue_size
+        self.flush_interval = flush_interval
+        self.batch_frames = batch_frames
+        self.overflow_policy = OverflowPolicy(overflow_policy)
+        self.backplane = backplane
+        self.node_id = uuid.uuid4().hex
+        self.connections: Dict[int, HubConnection] = {}
+        self.topics: Dict[str, Set[HubConnection]] = {}
+        self.topic_stats: Dict[str, TopicStats] = {}
+        self._started = False
+
+    async def start(self) -> None:
+        """Connect the backplane, if any"""
+        if self._started:
+            return
+        self._started = True
+        if self.backplane is not None:
+            await self.backplane.start(self.node_id, self._on_remote)
+            for topic in self.topics:
+                await self.backplane.subscribe(topic)
+
+    async def stop(self) -> None:
+        """Flush and detach every connection, then close the backplane"""
+        connections = list(self.connections.values())
+        for connection in connections:
+            connection.close()
+        tasks = [c.writer_task for c in connections if c.writer_task is not None]
+        if tasks:
+            await asyncio.wait(tasks, timeout=5.0)
+        for connection in connections:
+            await self.remove(connection.websocket)
+        if self.backplane is not None and self._started:
+            await self.backplane.close()
+        self._started = False
+
+    def _connection(self, websocket: Any) -> HubConnection:
+        connection = self.connections.get(id(websocket))
+        if connection is None:
+            connection = HubConnection(websocket, self.queue_size)
+            self.connections[id(websocket)] = connection
+        return connection
+
+    async def subscribe(self, websocket: Any, topic: str) -> None:
+        """Subscribe a connected WebSocket to a topic"""
+        connection = self._connection(websocket)
+        connection.topics.add(topic)
+        subscribers = self.topics.get(topic)
+        if subscribers is None:
+            subscribers = self.topics[topic] = set()
+            if self.backplane is not None and self._started:
+                await self.backplane.subscribe(topic)
+        subscribers.add(connection)
+
+    async def unsubscribe(self, websocket: Any, topic: str) -> None:
+        """Unsubscribe a WebSocket from a topic"""
+        connection = self.connections.get(id(websocket))
+        if connection is not None:
+            connection.topics.discard(topic)
+            await self._drop_subscriber(topic, connection)
+
+    async def remove(self, websocket: Any) -> None:
+        """Forget a WebSocket, e.g. from the handler's ``finally`` after it disconnects"""
+        connection = self.connections.pop(id(websocket), None)
+        if connection is None:
+            return
+        connection.close()
+        for topic in list(connection.topics):
+            await self._drop_subscriber(topic, connection)
+        connection.topics.clear()
+        task = connection.writer_task
+        if task is not None and not task.done() and task is not asyncio.current_task():
+            task.cancel()
+
+    async def _drop_subscriber(self, topic: str, connection: HubConnection) -> None:
+        subscribers = self.topics.get(topic)
+        if subscribers is None:
+            return
+        subscribers.discard(connection)
+        if not subscribers:
+            del self.topics[topic]
+            if self.backplane is not None and self._started:
+                await self.backplane.unsubscribe(topic)
+
+    async def publish(self, topic: str, message: Any) -> int:
+        """Publish to local subscribers and, through the backplane, to other nodes"""
+        frame = encode_message(message)
+        delivered = self._fan_out(topic, frame)
+        self._stats(topic).published += 1
+        if self.backplane is not None and self._started:
+            await self.backplane.publish(topic, frame)
+        return delivered
+
+    async def _on_remote(self, topic: str, is_text: bool, payload: Union[str, bytes], is_json: bool) -> None:
+        self._stats(topic).remote += 1
+        self._fan_out(topic, (is_text, payload, is_json))
+
+    def _stats(self, topic: str) -> TopicStats:
+        stats = self.topic_stats.get(topic)
+        if stats is None:
+            stats = self.topic_stats[topic] = TopicStats()
+        return stats
+
+    def _fan_out(self, topic: str, frame: Frame) -> int:
+        """Queue one frame for every local subscriber; never awaits a client"""
+        subscribers = self.topics.get(topic)
+        if not subscribers:
+            return 0
+        stats = self._stats(topic)
+        policy = self.overflow_policy
+        queued = 0
+        overflowed = []
+        for connection in subscribers:
+            result = connection.put(topic, frame, policy)
+            if result is False:
+                overflowed.append(connection)
+                continue
+            if result is None:
+                stats.dropped += 1
+            queued += 1
+            if connection.writer_task is None:
+                connection.writer_task = asyncio.create_task(self._writer_loop(connection))
+        for connection in overflowed:
+            stats.disconnects += 1
+            logger.warning(f"Disconnecting slow WebSocket subscriber {connection.id}")
+            asyncio.create_task(self._disconnect_slow(connection))
+        return queued
+
+    async def _disconnect_slow(self, connection: HubConnection) -> None:
+        await self.remove(connection.websocket)
+        try:
+            await connection.websocket.close(1013, "Subscriber too slow")
+        except Exception:
+            pass
+
+    async def _writer_loop(self, connection: HubConnection) -> None:
+        """Send queued frames for one connection, coalescing only once it falls behind"""
+        websocket = connection.websocket
+        backlog = False
+        try:
+            while await connection.wait():
+                if backlog and self.flush_interval > 0:
+                    await asyncio.sleep(self.flush_interval)
+                batch = connection.take()
+                for topic, frames in self._group(batch):
+                    stats = self._stats(topic)
+                    for is_text, payload in frames:
+                        if is_text:
+                            await websocket.send_text(payload)
+                        else:
+                            await websocket.send_bytes(payload)
+                        stats.bytes_out += len(payload)
+                    stats.delivered += 1 if self.batch_frames else len(frames)
+                # Frames queued while this flush was sending mean the client is behind
+                backlog = bool(connection.queue)
+        except asyncio.CancelledError:
+            raise
+        except Exception as e:
+            logger.info(f"WebSocket subscriber {connection.id} went away: {e}")
+            await self.remove(websocket)
+
+    def _group(self, batch: List[Tuple[str, Frame]]) -> List[Tuple[str, List[Tuple[bool, Union[str, bytes]]]]]:
+        """Frames to send, per topic run; JSON runs merge into arrays when batching"""
+        groups: List[Tuple[str, List[Tuple[bool, Union[str, bytes]]]]] = []
+        run_topic, run_json = None, []
+
+        def close_run() -> None:
+            if run_json:
+                groups.append((run_topic, [(True, "[" + ",".join(run_json) + "]")]))
+                run_json.clear()
+
+        for topic, (is_text, payload, is_json) in batch:
+            if self.batch_frames and is_json:
+                if topic != run_topic:
+                    close_run()
+                    run_topic = topic
+                run_json.append(payload)
+                continue
+            close_run()
+            groups.append((topic, [(is_text, payload)]))
+        close_run()
+        return groups
+
+    def get_stats(self) -> Dict[str, Any]:
+        """Hub statistics"""
+        return {
+            'connections': len(self.connections),
+            'topics': {
+                topic: {
+                    'subscribers': len(self.topics.get(topic, ())),
+                    'queue_depth': self.queue_depth(topic),
+                    **stats.to_dict(),
+                }
+                for topic, stats in self.topic_stats.items()
+            },
+        }
+
+    def queue_depth(self, topic: str) -> int:
+        """Frames queued for a topic across its subscribers"""
+        return sum(
+            1 for connection in self.topics.get(topic, ())
+            for queued_topic, _ in connection.queue if queued_topic == topic
+        )
+
+    def collect_metrics(self) -> List[Any]:
+        """Hub metrics as ``MetricValue`` records for ``MetricsCollector.add_collector``"""
+        from pyserv.monitoring.metrics import MetricValue
+
+        now = time.time()
+
+        def value(name, amount, metric_type='gauge', **labels):
+            return MetricValue(name=name, value=amount, timestamp=now, labels=labels, metric_type=metric_type)
+
+        values = [value('ws_hub_connections', len(self.connections))]
+        for topic, stats in self.topic_stats.items():
+            values += [
+                value('ws_hub_subscribers', len(self.topics.get(topic, ())), topic=topic),
+                value('ws_hub_queue_depth', self.queue_depth(topic), topic=topic),
+                value('ws_hub_published_total', stats.published, 'counter', topic=topic),
+                value('ws_hub_remote_total', stats.remote, 'counter', topic=topic),
+                value('ws_hub_delivered_total', stats.delivered, 'counter', topic=topic),
+                value('ws_hub_dropped_total', stats.dropped, 'counter', topic=topic),
+                value('ws_hub_slow_disconnects_total', stats.disconnects, 'counter', topic=topic),
+                value('ws_hub_bytes_total', stats.bytes_out, 'counter', topic=topic),
+            ]
+        return values
+
+    def register_metrics(self, collector: Any = None) -> None:
+        """Export hub metrics through a ``MetricsCollector`` (default: the global one)"""
+        if collector is None:
+            from pyserv.monitoring.metrics import get_metrics_collector
+            collector = get_metrics_collector()
+        collector.add_collector(self.collect_metrics)
+
+
+# Global WebSocket hub
+_websocket_hub: Optional[WebSocketHub] = None
+
+
+def get_websocket_hub() -> WebSocketHub:
+    """Get the global WebSocket hub instance"""
+    global _websocket_hub
+    if _websocket_hub is None:
+        _websocket_hub = WebSocketHub()
+    return _websocket_hub
+
+
+__all__ = [
+    'Backplane', 'HubConnection', 'InMemoryBackplane', 'NatsBackplane', 'OverflowPolicy',
+    'RedisBackplane', 'TopicStats', 'WebSocketHub', 'encode_message', 'get_websocket_hub',
+]
@@ -1,9 +1,9 @@
-import json
 from typing import Dict, Any, List, Optional, TYPE_CHECKING
 
 if TYPE_CHECKING:
     from pyserv.server.application import Application
 
+from pyserv.core import codec
 from pyserv.exceptions import WebSocketException
 
 class WebSocket:
@@ -75,8 +75,8 @@ class WebSocket:
         """Receive and parse JSON message"""
         text = await self.receive_text()
         try:
-            return json.loads(text)
-        except json.JSONDecodeError:
+            return codec.loads(text)
+        except codec.DecodeError:
             raise WebSocketException("Invalid JSON received")
     
     async def send_text(self, text: str) -> None:
@@ -101,8 +101,7 @@ class WebSocket:
     
     async def send_json(self, data: Any) -> None:
         """Send JSON message"""
-        text = json.dumps(data)
-        await self.send_text(text)
+        await self.send_text(codec.dumps_str(data))
     
     async def close(self, code: int = 1000, reason: Optional[str] = None) -> None:
         """Close the WebSocket connection"""
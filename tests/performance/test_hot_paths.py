@@ -0,0 +1,97 @@
+"""
+Performance tests for Pyserv hot-path benchmark suite
+"""
+import dataclasses
+
+import pytest
+
+from pyserv.performance.benchmarks import AsgiClient, BenchmarkCase, HotPathSuite, format_results, measure
+from pyserv.performance.profiling import RegressionDetector
+
+
+@pytest.mark.performance
+class TestHotPathSuite:
+    """Test the in-process benchmark suite"""
+
+    @pytest.mark.asyncio
+    async def test_quick_run(self):
+        """Test a short run yields sane results for every case it could build"""
+        suite = HotPathSuite(iterations=50, warmup=5, alloc_iterations=10,
+                             route_counts=(10, 100), middleware_depths=(0, 3))
+        results = await suite.run()
+        names = {result.name for result in results}
+        assert {"router_match_10_routes", "router_match_100_routes", "middleware_depth_3"} <= names
+        for result in results:
+            assert result.operations_per_second > 0, result.name
+            assert result.p50_latency <= result.p99_latency, result.name
+            assert result.error_rate == 0, result.name
+
+    @pytest.mark.asyncio
+    async def test_allocations_measured(self):
+        """Test allocation per op reflects what the operation allocates"""
+        small = await measure(BenchmarkCase("small", lambda: None), 20, 2, 20)
+        large = await measure(BenchmarkCase("large", lambda: bytearray(64 * 1024)), 20, 2, 20)
+        assert large.alloc_bytes_per_op >= 64 * 1024 > small.alloc_bytes_per_op
+        assert large.retained_bytes_per_op < 1024
+
+    @pytest.mark.asyncio
+    async def test_asgi_client(self):
+        """Test the in-memory client collects status, headers and body"""
+        async def app(scope, receive, send):
+            message = await receive()
+            await send({"type": "http.response.start", "status": 201, "headers": [(b"x-path", scope["raw_path"])]})
+            await send({"type": "http.response.body", "body": message["body"][::-1]})
+
+        response = await AsgiClient(app).request("POST", "/echo", body=b"abc")
+        assert response.status == 201
+        assert response.headers == [(b"x-path", b"/echo")] and response.body == b"cba"
+
+    @pytest.mark.asyncio
+    async def test_detector_flags_regressions(self, tmp_path):
+        """Test a baseline gates throughput, p99 and allocation regressions"""
+        baseline = await measure(BenchmarkCase("op", lambda: None), 50, 5, 10)
+        baseline = dataclasses.replace(baseline, alloc_bytes_per_op=100.0)
+        detector = RegressionDetector(str(tmp_path / "baseline.json"))
+        detector.establish_baseline([baseline])
+
+        reloaded = RegressionDetector(str(tmp_path / "baseline.json"))
+        assert reloaded.detect_regression([baseline]) == []
+
+        slower = dataclasses.replace(
+            baseline,
+            operations_per_second=baseline.operations_per_second / 2,
+            p99_latency=baseline.p99_latency * 3,
+            alloc_bytes_per_op=1000.0,
+        )
+        kinds = {reg["type"] for reg in reloaded.detect_regression([slower], threshold=0.25)}
+        assert {"throughput_regression", "p99_latency_regression", "allocation_regression"} <= kinds
+
+    @pytest.mark.asyncio
+    async def test_detector_flags_failing_cases(self, tmp_path):
+        """Test a case whose operations fail is a regression, with or without a baseline"""
+        def fail():
+            raise RuntimeError("broken")
+
+        failing = await measure(BenchmarkCase("op", fail), 20, 2, 5)
+        assert failing.error_rate == 1.0
+        detector = RegressionDetector(str(tmp_path / "baseline.json"))
+        assert [reg["type"] for reg in detector.detect_regression([failing])] == ["error_regression"]
+
+        healthy = dataclasses.replace(failing, error_rate=0.0)
+        detector.establish_baseline([healthy])
+        regressions = detector.detect_regression([failing])
+        assert {reg["type"] for reg in regressions} >= {"error_regression"}
+        assert all(reg["severity"] == "high" for reg in regressions if reg["type"] == "error_regression")
+
+    def test_skipped_groups_reported(self):
+        """Test groups that cannot be built are recorded and listed with the results"""
+        suite = HotPathSuite()
+
+        def unavailable():
+            raise ImportError("no module named 'missing'")
+
+        suite.builders = lambda: [("router", suite.router_cases), ("broken", unavailable)]
+        suite.route_counts = (10,)
+        assert {case.group for case in suite.cases()} == {"router"}
+        assert suite.skipped == {"broken": "no module named 'missing'"}
+        assert "broken (skipped)" in format_results([], suite.skipped)
@@ -0,0 +1,195 @@
+"""
+Security tests for Pyserv audit logging
+"""
+import json
+from datetime import datetime
+from unittest.mock import AsyncMock
+
+import pytest
+
+from pyserv.security import audit
+from pyserv.security.audit import AuditEntry, AuditEvent, AuditLogger, AuditRing, INDEX_RECORD
+from pyserv.security.siem_integration import AlertSeverity, SIEMIntegration, SIEMProvider
+
+
+async def log(logger, count, event_type=AuditEvent.DATA_ACCESS, user_id="alice", success=True):
+    for i in range(count):
+        await logger.log_event(event_type, user_id, "s1", f"/records/{i}", "read",
+                               {"n": i}, "10.0.0.1", "tests", success=success)
+
+
+class TestAuditRing:
+    """Test the ring between producers and the audit writer"""
+
+    def _entry(self, n):
+        return AuditEntry(None, AuditEvent.LOGIN, None, None, str(n), "", {}, "", "", True)
+
+    def test_publish_bounded_by_durable_cursor(self):
+        """Test producers cannot overwrite entries the writer has not committed"""
+        ring = AuditRing(4)
+        assert all(ring.publish(self._entry(n)) for n in range(4))
+        assert not ring.publish(self._entry(4))
+        ring.commit(2)
+        assert ring.publish(self._entry(4)) and ring.pending == 3
+
+    def test_lagging_reader_reports_lost_entries(self):
+        """Test a non-durable reader a full ring behind skips ahead and counts the gap"""
+        ring = AuditRing(4)
+        for n in range(10):
+            ring.publish(self._entry(n))
+            ring.commit(n + 1)
+        entries, cursor, lost = ring.read(0, 100)
+        assert lost == 6 and cursor == 10
+        assert [entry.resource for entry in entries] == ["6", "7", "8", "9"]
+
+
+class TestAuditLogger:
+    """Test the background audit writer and indexed queries"""
+
+    @pytest.mark.asyncio
+    async def test_entries_written_in_batches(self, tmp_path):
+        """Test entries reach the file via group commits and stop drains everything"""
+        logger = AuditLogger(str(tmp_path / "audit.log"), batch_size=64)
+        await log(logger, 300)
+        await logger.stop()
+
+        lines = (tmp_path / "audit.log").read_text().splitlines()
+        assert len(lines) == 300 and json.loads(lines[-1])["details"] == {"n": 299}
+        assert logger.stats["written"] == 300 and logger.stats["batches"] < 300
+        assert (tmp_path / "audit.log.idx").stat().st_size == 300 * INDEX_RECORD.size
+
+    @pytest.mark.asyncio
+    async def test_recent_entries_and_search(self, tmp_path):
+        """Test queries use the sidecar index and agree with the tail-read fallback"""
+        logger = AuditLogger(str(tmp_path / "audit.log"))
+        await log(logger, 50)
+        await log(logger, 3, AuditEvent.FAILED_LOGIN, user_id="mallory", success=False)
+        await log(logger, 20, user_id="bob")
+        await logger.stop()
+
+        recent = logger.get_recent_entries(5)
+        assert [entry.details["n"] for entry in recent] == [15, 16, 17, 18, 19]
+
+        indexed = logger.search_entries(event_type=AuditEvent.FAILED_LOGIN, user_id="mallory")
+        assert [entry.resource for entry in indexed] == ["/records/0", "/records/1", "/records/2"]
+        assert len(logger.search_entries(user_id="bob", limit=4)) == 4
+        assert logger.search_entries(user_id="bob", limit=4)[-1].details["n"] == 19
+
+        (tmp_path / "audit.log.idx").unlink()
+        assert [e.resource for e in logger.search_entries(event_type="failed_login")] == \
+            [entry.resource for entry in indexed]
+        assert [e.details for e in logger.get_recent_entries(5)] == [e.details for e in recent]
+
+    @pytest.mark.asyncio
+    async def test_stale_index_rebuilt_on_open(self, tmp_path):
+        """Test an index that does not match the log is rebuilt when the writer starts"""
+        logger = AuditLogger(str(tmp_path / "audit.log"))
+        await log(logger, 10)
+        await logger.stop()
+        (tmp_path / "audit.log.idx").write_bytes(b"")
+
+        logger = AuditLogger(str(tmp_path / "audit.log"))
+        await log(logger, 2, user_id="bob")
+        await logger.stop()
+        assert (tmp_path / "audit.log.idx").stat().st_size == 12 * INDEX_RECORD.size
+        assert len(logger.search_entries(user_id="alice")) == 10
+
+    @pytest.mark.asyncio
+    async def test_rotation_without_stat(self, tmp_path):
+        """Test the writer rotates on its tracked size and restarts the index"""
+        logger = AuditLogger(str(tmp_path / "audit.log"), max_file_size=2000, fsync="always")
+        await log(logger, 40)
+        await logger.stop()
+
+        assert logger.stats["rotations"] >= 1 and logger.stats["fsyncs"] >= 1
+        assert list(tmp_path.glob("audit.*.bak"))
+        current = (tmp_path / "audit.log").read_text().splitlines()
+        assert (tmp_path / "audit.log.idx").stat().st_size == len(current) * INDEX_RECORD.size
+        assert logger.get_recent_entries(1)[0].details["n"] == 39
+
+    @pytest.mark.asyncio
+    async def test_rotations_never_overwrite_backups(self, tmp_path, monkeypatch):
+        """Test rotations within the same clock tick each keep their own backup"""
+        class FrozenClock(datetime):
+            @classmethod
+            def now(cls, tz=None):
+                return datetime(2026, 1, 1, 12, 0, 0)
+
+        monkeypatch.setattr(audit, "datetime", FrozenClock)
+        logger = AuditLogger(str(tmp_path / "audit.log"), max_file_size=600)
+        await log(logger, 20)
+        await logger.stop()
+
+        backups = sorted(tmp_path.glob("audit.*.bak"))
+        assert len(backups) == logger.stats["rotations"] >= 3
+        kept = sum(len(path.read_text().splitlines()) for path in [*backups, tmp_path / "audit.log"])
+        assert kept == 20
+
+    @pytest.mark.asyncio
+    async def test_overflow_drop(self, tmp_path):
+        """Test the drop policy counts entries that do not fit instead of waiting"""
+        logger = AuditLogger(str(tmp_path / "audit.log"), buffer_size=8, overflow="drop")
+        logger._start_writer = lambda: None
+        await log(logger, 10)
+        assert logger.stats["dropped"] == 2 and logger.buffer.pending == 8
+
+    def test_invalid_fsync_policy(self, tmp_path):
+        """Test unknown fsync policies are rejected"""
+        with pytest.raises(ValueError):
+            AuditLogger(str(tmp_path / "audit.log"), fsync="sometimes")
+
+
+    @pytest.mark.asyncio
+    async def test_failed_batches_stay_pending(self, tmp_path):
+        """Test entries from a failed write are retried, not discarded"""
+        logger = AuditLogger(str(tmp_path / "audit.log"), flush_interval=0.01)
+        append, failures = logger._append, [OSError("disk full")] * 2
+
+        def flaky(*args):
+            if failures:
+                raise failures.pop()
+            append(*args)
+
+        logger._append = flaky
+        await log(logger, 5)
+        await logger.stop()
+        lines = (tmp_path / "audit.log").read_text().splitlines()
+        assert [json.loads(line)["details"]["n"] for line in lines] == [0, 1, 2, 3, 4]
+        assert logger.stats["errors"] == 2 and logger.stats["dropped"] == 0
+
+    @pytest.mark.asyncio
+    async def test_unwritable_entries_counted_as_dropped_on_stop(self, tmp_path):
+        """Test stop gives up on entries that still cannot be written and counts them"""
+        logger = AuditLogger(str(tmp_path / "audit.log"), flush_interval=0.01)
+
+        def broken(*args):
+            raise OSError("read-only file system")
+
+        logger._append = broken
+        await log(logger, 3)
+        await logger.stop()
+        assert logger.stats["dropped"] == 3 and logger.stats["written"] == 0
+        assert logger.buffer.pending == 0
+
+class TestSIEMAuditForwarding:
+    """Test the SIEM consumes audit entries from the writer's ring"""
+
+    @pytest.mark.asyncio
+    async def test_flush_forwards_audit_entries(self, tmp_path):
+        """Test audit entries become security events and failed sends are retried"""
+        logger = AuditLogger(str(tmp_path / "audit.log"))
+        siem = SIEMIntegration(SIEMProvider.CUSTOM, {})
+        siem.attach_audit_log(logger)
+        await log(logger, 2)
+        await log(logger, 1, AuditEvent.SECURITY_EVENT, success=False)
+        await logger.stop()
+
+        siem._send_to_custom = AsyncMock(side_effect=[ConnectionError("down"), None])
+        await siem._flush_events()
+        assert len(siem.event_buffer) == 3
+
+        await siem._flush_events()
+        sent = siem._send_to_custom.call_args.args[0]
+        assert [event["event_type"] for event in sent] == ["data_access", "data_access", "security_event"]
+        assert sent[-1]["severity"] == AlertSeverity.HIGH.value and sent[-1]["source"] == "audit"
+        assert siem.event_buffer == [] and len(logger.get_recent_entries()) == 3
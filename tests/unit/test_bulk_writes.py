@@ -0,0 +1,149 @@
+"""
+Unit tests for Pyserv bulk writes
+"""
+import time
+
+import pytest
+
+from pyserv.database import bulk
+from pyserv.database.connections.sqlite_connection import SQLiteConnection
+
+
+class Item:
+    """Minimal model for bulk writes"""
+
+    @staticmethod
+    def get_table_name():
+        return "items"
+
+
+async def make_connection():
+    """Open an in-memory SQLite database with an items table"""
+    class Config:
+        database = ":memory:"
+
+    connection = SQLiteConnection(Config())
+    await connection.connect()
+    connection.connection.execute("CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT, qty INTEGER)")
+    return connection
+
+
+async def collect_chunks(rows, max_params=None, batch_size=None, rate_limit=None):
+    """Gather the chunks produced by bulk.chunked"""
+    return [chunk async for chunk in bulk.chunked(rows, max_params, batch_size, rate_limit)]
+
+
+class TestChunking:
+    """Test chunk sizing and throttling"""
+
+    def test_chunk_size(self):
+        """Test chunks respect both the batch size and the parameter limit"""
+        assert bulk.chunk_size(3, None, None) == bulk.DEFAULT_BATCH_SIZE
+        assert bulk.chunk_size(10, bulk.POSTGRESQL_MAX_PARAMS, None) == 3276
+        assert bulk.chunk_size(10, bulk.MYSQL_MAX_PARAMS, 100) == 100
+        assert bulk.chunk_size(100000, bulk.MYSQL_MAX_PARAMS, None) == 1
+
+    @pytest.mark.asyncio
+    async def test_chunked(self):
+        """Test sync and async sources split into full chunks plus a remainder"""
+        rows = [{"id": i, "name": str(i)} for i in range(25)]
+        chunks = await collect_chunks(rows, max_params=20)
+        assert [len(chunk) for chunk in chunks] == [10, 10, 5]
+
+        async def source():
+            for row in rows:
+                yield row
+
+        chunks = await collect_chunks(source(), batch_size=7)
+        assert [len(chunk) for chunk in chunks] == [7, 7, 7, 4]
+
+    @pytest.mark.asyncio
+    async def test_rate_limit(self):
+        """Test the rate limit spaces out chunks"""
+        rows = [{"id": i} for i in range(30)]
+        started = time.monotonic()
+        await collect_chunks(rows, batch_size=10, rate_limit=300)
+        assert time.monotonic() - started >= 0.09
+
+    def test_rejects_other_rows(self):
+        """Test rows must be dicts or models"""
+        with pytest.raises(TypeError):
+            bulk.row_to_dict((1, 2))
+
+
+class TestSQLiteBulkWrites:
+    """Test bulk writes against SQLite"""
+
+    @pytest.mark.asyncio
+    async def test_insert_upsert_update(self):
+        """Test rows are inserted, upserted and updated in chunks"""
+        connection = await make_connection()
+        db = connection.connection
+
+        def row(query):
+            return tuple(db.execute(query).fetchone())
+
+        written = await connection.insert_many(
+            Item, ({"id": i, "name": f"item{i}", "qty": i} for i in range(1, 101)), batch_size=30
+        )
+        assert written == 100
+        assert row("SELECT COUNT(*) FROM items")[0] == 100
+
+        written = await connection.upsert_many(
+            Item, [{"id": 100, "name": "changed", "qty": 0}, {"id": 101, "name": "new", "qty": 1}],
+            conflict_fields=["id"], update_fields=["name"]
+        )
+        assert written == 2
+        assert row("SELECT name, qty FROM items WHERE id = 100") == ("changed", 100)
+        assert row("SELECT name FROM items WHERE id = 101") == ("new",)
+
+        await connection.upsert_many(Item, [{"id": 1, "name": "ignored", "qty": 9}],
+                                     conflict_fields=["id"], update_fields=[])
+        assert row("SELECT name FROM items WHERE id = 1") == ("item1",)
+
+        written = await connection.update_many(Item, [{"id": i, "qty": -i} for i in range(1, 11)],
+                                               batch_size=4)
+        assert written == 10
+        assert row("SELECT SUM(qty) FROM items WHERE id <= 10")[0] == -55
+
+    @pytest.mark.asyncio
+    async def test_failed_load_rolls_back(self):
+        """Test a failing chunk rolls back the whole load"""
+        connection = await make_connection()
+        rows = [{"id": i, "name": "x", "qty": 0} for i in range(1, 6)] + [{"id": 1, "name": "dup", "qty": 0}]
+        with pytest.raises(Exception):
+            await connection.insert_many(Item, rows, batch_size=2)
+        assert connection.connection.execute("SELECT COUNT(*) FROM items").fetchone()[0] == 0
+
+
+class TestMongoBulkWrites:
+    """Test the bulk_write operations built for MongoDB"""
+
+    @pytest.mark.asyncio
+    async def test_id_fields_map_to_object_id(self):
+        """Test id key and conflict fields match on _id and stay out of $set"""
+        pytest.importorskip("motor")
+        from pyserv.database.connections.mongodb_connection import MongoDBConnection
+
+        class Result:
+            upserted_count, modified_count = 0, 1
+
+        class Collection:
+            def __init__(self):
+                self.operations = []
+
+            async def bulk_write(self, operations, ordered):
+                self.operations.extend(operations)
+                return Result()
+
+        connection = MongoDBConnection(None)
+        collection = Collection()
+        connection.db = {"items": collection}
+
+        await connection.update_many(Item, [{"id": 7, "qty": 1}])
+        await connection.upsert_many(Item, [{"id": 8, "name": "new", "qty": 2}],
+                                     conflict_fields=["id"], update_fields=["id", "name"])
+        update, upsert = (operation._doc for operation in collection.operations)
+        assert [operation._filter for operation in collection.operations] == [{"_id": 7}, {"_id": 8}]
+        assert update == {"$set": {"qty": 1}}
+        assert upsert == {"$set": {"name": "new"}, "$setOnInsert": {"qty": 2}}
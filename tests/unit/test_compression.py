@@ -0,0 +1,153 @@
+"""
+Unit tests for Pyserv response compression
+"""
+import zlib
+
+import pytest
+
+from pyserv.http import compression
+from pyserv.http.response import Response
+from pyserv.utils.staticfiles import StaticFilesManager
+
+
+async def collect(response, accept_encoding="gzip"):
+    """Run a response and return its start message and joined body"""
+    messages = []
+
+    async def send(message):
+        messages.append(message)
+
+    headers = [(b"accept-encoding", accept_encoding.encode())] if accept_encoding else []
+    await response({"type": "http", "method": "GET", "headers": headers}, None, send)
+    start = messages[0]
+    body = b"".join(m["body"] for m in messages[1:])
+    return dict((k.decode(), v.decode()) for k, v in start["headers"]), body, messages[1:]
+
+
+class TestNegotiation:
+    """Test Accept-Encoding negotiation"""
+
+    def test_negotiate(self):
+        """Test q-values, wildcards and server preference"""
+        assert compression.negotiate("gzip, deflate", ["gzip", "deflate"]) == "gzip"
+        assert compression.negotiate("gzip;q=0.5, deflate", ["gzip", "deflate"]) == "deflate"
+        assert compression.negotiate("*;q=0.1, gzip;q=0", ["gzip", "deflate"]) == "deflate"
+        assert compression.negotiate("identity", ["gzip"]) is None
+        assert compression.negotiate(None, ["gzip"]) is None
+        assert compression.negotiate("x-gzip", ["gzip"]) == "gzip"
+
+    def test_is_compressible(self):
+        """Test textual types are compressible and binary ones are not"""
+        assert compression.is_compressible("text/html; charset=utf-8")
+        assert compression.is_compressible("application/vnd.api+json")
+        assert not compression.is_compressible("image/png")
+        assert not compression.is_compressible(None)
+
+
+class TestStreamCompressor:
+    """Test incremental compression"""
+
+    @pytest.mark.parametrize("encoding", ["gzip", "deflate"])
+    def test_round_trip(self, encoding):
+        """Test one-shot and incremental output decode to the input"""
+        data = b"hello compression " * 200
+        assert compression.decompress(compression.compress(data, encoding), encoding) == data
+
+        compressor = compression.StreamCompressor(encoding)
+        decoder = zlib.decompressobj(47 if encoding == "gzip" else 15)
+        for index in range(0, len(data), 100):
+            chunk = compressor.compress(data[index:index + 100])
+            # Every chunk is flushed, so everything so far is decodable
+            assert decoder.decompress(chunk) == data[index:index + 100]
+        decoder.decompress(compressor.finish())
+        assert decoder.eof
+
+    def test_unsupported(self):
+        """Test unknown codings are rejected"""
+        with pytest.raises(ValueError):
+            compression.StreamCompressor("lzma")
+
+
+class TestResponseCompression:
+    """Test negotiated compression of responses"""
+
+    @pytest.mark.asyncio
+    async def test_buffered_body(self):
+        """Test large bodies are compressed and labelled"""
+        response = Response("x" * 2000, compression="auto")
+        headers, body, _ = await collect(response)
+        assert headers["content-encoding"] == "gzip"
+        assert headers["vary"] == "Accept-Encoding"
+        assert int(headers["content-length"]) == len(body)
+        assert compression.decompress(body, "gzip") == b"x" * 2000
+
+    @pytest.mark.asyncio
+    async def test_skipped(self):
+        """Test small bodies, binary types and non-accepting clients are sent as is"""
+        headers, body, _ = await collect(Response("tiny", compression="auto"))
+        assert "content-encoding" not in headers and body == b"tiny"
+
+        headers, body, _ = await collect(Response(b"\0" * 2000, compression="auto"))
+        assert "content-encoding" not in headers
+
+        headers, body, _ = await collect(Response("x" * 2000, compression="gzip"), accept_encoding="br")
+        assert "content-encoding" not in headers and body == b"x" * 2000
+
+    @pytest.mark.asyncio
+    async def test_streamed_body(self):
+        """Test streamed chunks are compressed incrementally"""
+        response = Response(media_type="text/plain", compression="auto")
+        for chunk in (b"first ", b"second ", b"third"):
+            await response.stream_data(chunk)
+        await response.end_stream()
+
+        headers, body, messages = await collect(response)
+        assert headers["content-encoding"] == "gzip"
+        assert "content-length" not in headers
+        assert len(messages) == 4
+        assert compression.decompress(body, "gzip") == b"first second third"
+
+
+class TestPrecompressedStatic:
+    """Test precompressed static file variants"""
+
+    def _manager(self, tmp_path):
+        class Config:
+            root = str(tmp_path)
+            url = "/static/"
+            max_age = 60
+            precompress_encodings = ["br", "gzip"]
+
+        (tmp_path / "app.css").write_bytes(b"body { color: red; }\n" * 200)
+        (tmp_path / "logo.png").write_bytes(b"\x89PNG" * 1000)
+        manager = StaticFilesManager(Config())
+        manager.collected_files = [
+            type("F", (), {"relative_path": name})() for name in ("app.css", "logo.png")
+        ]
+        return manager
+
+    def test_precompress_files(self, tmp_path):
+        """Test variants are written for compressible files and kept when fresh"""
+        manager = self._manager(tmp_path)
+        result = manager.precompress_files(verbosity=0)
+        assert (tmp_path / "app.css.gz").exists()
+        assert not (tmp_path / "logo.png.gz").exists()
+        assert result["written"] >= 1
+
+        again = manager.precompress_files(verbosity=0)
+        assert again["written"] == 0
+
+    def test_serves_variant(self, tmp_path):
+        """Test an accepted variant is served with the original media type"""
+        manager = self._manager(tmp_path)
+        manager.precompress_files(verbosity=0)
+
+        response = manager.file_response("/static/app.css", "gzip, deflate")
+        assert response.headers["content-encoding"] == "gzip"
+        assert response.headers["vary"] == "Accept-Encoding"
+        assert response.media_type == "text/css"
+        assert response.path.endswith("app.css.gz")
+
+        plain = manager.file_response("/static/app.css", None)
+        assert "content-encoding" not in plain.headers
+        assert plain.path.endswith("app.css")
@@ -0,0 +1,164 @@
+"""
+Unit tests for Pyserv database connection pool
+"""
+import asyncio
+
+import pytest
+
+from pyserv.database.pool import ConnectionPool, PoolConfig, PoolTimeoutError
+
+
+class FakeConnection:
+    """Driver connection stand-in"""
+
+    def __init__(self, number):
+        self.number = number
+        self.closed = False
+        self.alive = True
+
+    async def close(self):
+        self.closed = True
+
+
+def make_pool(**config):
+    """Build a pool over fake connections, without background maintenance"""
+    opened = []
+
+    async def create():
+        connection = FakeConnection(len(opened))
+        opened.append(connection)
+        return connection
+
+    async def validate(connection):
+        return connection.alive
+
+    config.setdefault('health_check_interval', 0)
+    pool = ConnectionPool(create, validate=validate, config=PoolConfig(**config), name='test')
+    return pool, opened
+
+
+class TestConnectionPool:
+    """Test acquisition, fairness and sizing"""
+
+    @pytest.mark.asyncio
+    async def test_reuses_connections(self):
+        """Test min_size connections are opened up front and reused"""
+        pool, opened = make_pool(min_size=2, max_size=4)
+        await pool.start()
+        assert len(opened) == 2
+
+        for _ in range(5):
+            async with pool.acquire() as connection:
+                assert isinstance(connection, FakeConnection)
+        stats = pool.get_stats()
+        assert len(opened) == 2
+        assert stats.total_acquires == 5
+        assert stats.idle_connections == 2 and stats.active_connections == 0
+        await pool.close()
+        assert all(connection.closed for connection in opened)
+
+    @pytest.mark.asyncio
+    async def test_fifo_waiters(self):
+        """Test waiters are served in arrival order when the pool is exhausted"""
+        pool, _ = make_pool(min_size=1, max_size=1, target_wait=0)
+        await pool.start()
+        held = await pool.checkout()
+        order = []
+
+        async def worker(number):
+            async with pool.acquire():
+                order.append(number)
+                await asyncio.sleep(0)
+
+        tasks = []
+        for number in range(5):
+            tasks.append(asyncio.create_task(worker(number)))
+            await asyncio.sleep(0)
+        assert pool.get_stats().pending_acquires == 5
+
+        await pool.checkin(held)
+        await asyncio.gather(*tasks)
+        assert order == [0, 1, 2, 3, 4]
+
+    @pytest.mark.asyncio
+    async def test_acquire_timeout(self):
+        """Test exhausted pools time out and count it"""
+        pool, _ = make_pool(min_size=1, max_size=1)
+        await pool.start()
+        held = await pool.checkout()
+        with pytest.raises(PoolTimeoutError):
+            await pool.checkout(timeout=0.05)
+        stats = pool.get_stats()
+        assert stats.total_timeouts == 1
+        assert stats.pending_acquires == 0
+
+        # The abandoned waiter must not swallow the next released connection
+        await pool.checkin(held)
+        assert (await pool.checkout(timeout=0.05)) is held
+
+    @pytest.mark.asyncio
+    async def test_grows_under_wait(self):
+        """Test waits past target_wait raise the target size up to max_size"""
+        pool, opened = make_pool(min_size=1, max_size=3, target_wait=0.01)
+        await pool.start()
+        held = [await pool.checkout()]
+        held.append(await pool.checkout(timeout=1))
+        held.append(await pool.checkout(timeout=1))
+        assert len(opened) == 3 and pool.target_size == 3
+
+        with pytest.raises(PoolTimeoutError):
+            await pool.checkout(timeout=0.05)
+        assert len(opened) == 3
+
+    @pytest.mark.asyncio
+    async def test_maintenance(self):
+        """Test maintenance drops dead and expired connections, shrinks and refills"""
+        pool, opened = make_pool(min_size=1, max_size=4, target_wait=0.001)
+        await pool.start()
+        held = [await pool.checkout(timeout=1) for _ in range(3)]
+        for connection in held:
+            await pool.checkin(connection)
+        assert pool.size == 3
+
+        opened[0].alive = False
+        await pool.run_maintenance()
+        stats = pool.get_stats()
+        assert opened[0].closed
+        assert stats.total_validation_failures == 1
+
+        # Connections idle through whole cycles: the target steps down to min_size
+        async with pool.acquire():
+            pass
+        for _ in range(5):
+            await pool.run_maintenance()
+        assert pool.target_size == 1 and pool.size == 1
+
+        pool.config.max_lifetime = -1
+        await pool.run_maintenance()
+        assert pool.get_stats().total_recycled >= 1
+        assert pool.size == 1 and not opened[-1].closed
+
+    @pytest.mark.asyncio
+    async def test_open_failure_reaches_waiter(self):
+        """Test a failing connect is raised to the waiting caller"""
+        async def create():
+            raise OSError("refused")
+
+        pool = ConnectionPool(create, config=PoolConfig(min_size=0, max_size=2, health_check_interval=0))
+        with pytest.raises(OSError):
+            await pool.checkout(timeout=1)
+        assert pool.size == 0
+        assert pool.get_stats().total_errors == 1
+
+    @pytest.mark.asyncio
+    async def test_metrics(self):
+        """Test exported gauges and the cumulative acquire histogram"""
+        pool, _ = make_pool(min_size=1, max_size=2)
+        await pool.start()
+        async with pool.acquire():
+            values = {(v.name, v.labels.get('state'), v.labels.get('le')): v.value
+                      for v in pool.collect_metrics()}
+        assert values[('db_pool_connections', 'in_use', None)] == 1
+        assert values[('db_pool_waiters', None, None)] == 0
+        assert values[('db_pool_acquire_seconds_bucket', None, '+Inf')] == 1
+        assert values[('db_pool_acquire_seconds_count', None, None)] == 1
@@ -0,0 +1,146 @@
+"""
+Unit tests for Pyserv dependency injection
+"""
+import pytest
+
+from pyserv.exceptions import DependencyInjectionException
+from pyserv.utils import di
+from pyserv.utils.di import Container, ServiceLifetime
+
+
+class Config:
+    pass
+
+
+class Repository:
+    def __init__(self, config: Config):
+        self.config = config
+
+
+class UnitOfWork:
+    def __init__(self, repository: Repository, config: Config, retries: int = 3):
+        self.repository = repository
+        self.config = config
+        self.retries = retries
+
+
+class Service:
+    def __init__(self, unit: "UnitOfWork", timeout: float = 1.0):
+        self.unit = unit
+        self.timeout = timeout
+
+
+def container_with(lifetime=ServiceLifetime.TRANSIENT):
+    container = Container()
+    container.register_singleton(Config)
+    container.register(Repository, lifetime=lifetime)
+    container.register(UnitOfWork, lifetime=lifetime)
+    container.register_transient(Service)
+    return container
+
+
+class TestResolutionPlans:
+    """Test compiled resolution plans"""
+
+    def test_signatures_inspected_once(self, monkeypatch):
+        """Test repeated resolution reuses the compiled plan instead of inspecting constructors"""
+        calls = []
+        original = di._constructor_parameters
+        monkeypatch.setattr(di, "_constructor_parameters", lambda cls: calls.append(cls) or original(cls))
+
+        container = container_with()
+        services = [container.get(Service) for _ in range(50)]
+        assert sorted(cls.__name__ for cls in calls) == ["Config", "Repository", "Service", "UnitOfWork"]
+
+        service = services[-1]
+        assert service.timeout == 1.0 and service.unit.retries == 3
+        assert service.unit.config is service.unit.repository.config is container.get(Config)
+        assert services[0].unit is not service.unit
+
+    def test_reregistration_invalidates_plans(self):
+        """Test replacing a registration reaches services that depend on it"""
+        class TestConfig(Config):
+            pass
+
+        container = container_with()
+        assert type(container.get(Service).unit.config) is Config
+
+        container.register_singleton(Config, implementation_type=TestConfig)
+        assert type(container.get(Config)) is TestConfig
+        assert type(container.get(Service).unit.repository.config) is TestConfig
+
+    def test_defaults_cycles_and_missing(self):
+        """Test unresolvable dependencies use defaults, and cycles or gaps raise"""
+        class Optional_:
+            def __init__(self, missing: Repository = None, plain=5):
+                self.missing, self.plain = missing, plain
+
+        class Chicken:
+            def __init__(self, egg: "Egg"):
+                self.egg = egg
+
+        class Egg:
+            def __init__(self, chicken: Chicken):
+                self.chicken = chicken
+
+        class NoInit:
+            pass
+
+        container = Container()
+        container.register_transient(Optional_)
+        container.register_transient(NoInit)
+        container.register_transient(Chicken)
+        container.register_transient(Egg)
+        resolved = container.get(Optional_)
+        assert resolved.missing is None and resolved.plain == 5
+        assert isinstance(container.get(NoInit), NoInit)
+        with pytest.raises(DependencyInjectionException):
+            container.get(Egg)
+        with pytest.raises(DependencyInjectionException):
+            container.get(Repository)
+
+        container.register_singleton("app", object())
+        assert container.resolve("app") is container.get("app")
+
+
+class TestScopes:
+    """Test scoped services"""
+
+    def test_scoped_instances_shared_within_scope(self):
+        """Test a scope shares scoped instances across its dependency graph"""
+        container = container_with(ServiceLifetime.SCOPED)
+        first = container.get(Service, scope_id="request-1")
+        again = container.get(Service, scope_id="request-1")
+        other = container.resolve(Service, container.create_scope("request-2"))
+
+        assert first is not again and first.unit is again.unit
+        assert first.unit.repository is container.get(Repository, scope_id="request-1")
+        assert other.unit is not first.unit
+
+    def test_scopes_are_pooled(self):
+        """Test closed scopes are emptied and reused for later scopes"""
+        container = container_with(ServiceLifetime.SCOPED)
+        scope = container.create_scope("request-1")
+        unit = container.get(UnitOfWork, scope_id="request-1")
+        container.clear_scope("request-1")
+
+        reused = container.create_scope("request-2")
+        assert reused is scope and reused.scope_id == "request-2" and not reused.services
+        assert container.get(UnitOfWork, scope_id="request-2") is not unit
+
+
+class TestInject:
+    """Test the inject decorator"""
+
+    def test_inject_fills_registered_parameters(self, monkeypatch):
+        """Test registered annotations are injected and others are left to the caller"""
+        container = container_with()
+        monkeypatch.setattr(di, "container", container)
+
+        @di.inject
+        def handler(service: Service, name: str = "anon"):
+            return service, name
+
+        service, name = handler()
+        assert isinstance(service, Service) and name == "anon"
+        assert handler(name="x")[1] == "x"
@@ -0,0 +1,33 @@
+"""
+Unit tests for Pyserv distributed cache
+"""
+import pytest
+
+fcntl = pytest.importorskip("fcntl")
+
+from pyserv.caching.distributed_cache import CacheConfig, DistributedCache
+
+
+class TestDistributedCache:
+    """Test the cache hierarchy"""
+
+    def _config(self, tmp_path):
+        return CacheConfig(enable_l2=False, enable_l3=False, enable_shared=True,
+                           shared_cache_path=str(tmp_path / 'shm.cache'), shared_cache_buckets=8,
+                           invalidation_propagation=False)
+
+    @pytest.mark.asyncio
+    async def test_shared_level_serves_other_workers(self, tmp_path):
+        """Test a value set by one worker is read from shared memory by another and promoted to its L1"""
+        writer = DistributedCache(self._config(tmp_path))
+        reader = DistributedCache(self._config(tmp_path))
+        assert await writer.set('user:1', {'name': 'ada'})
+        assert await reader._l1_cache.get('user:1') is None
+
+        assert await reader.get('user:1') == {'name': 'ada'}
+        assert reader.get_analytics()['hits'] == 1
+        assert await reader._l1_cache.get('user:1') == {'name': 'ada'}
+
+        await writer.delete('user:1')
+        other = DistributedCache(self._config(tmp_path))
+        assert await other.get('user:1') is None
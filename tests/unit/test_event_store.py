@@ -0,0 +1,163 @@
+"""
+Unit tests for Pyserv event store
+"""
+import os
+
+import pytest
+
+from pyserv.microservices import event_log
+from pyserv.microservices.event_log import SegmentedEventLog
+from pyserv.microservices.event_sourcing import Aggregate, Event, EventStore, Repository
+
+
+class Counter(Aggregate):
+    """Aggregate counting increments"""
+
+    def __init__(self, aggregate_id):
+        super().__init__(aggregate_id)
+        self.total = 0
+        self.applied = 0
+
+    async def handle_command(self, command):
+        event = Event("Incremented", self.aggregate_id, {"by": command["by"]})
+        self.apply_event(event)
+        self.uncommitted_events.append(event)
+        return [event]
+
+    def apply_incremented(self, event):
+        self.total += event.payload["by"]
+        self.applied += 1
+
+    def snapshot_state(self):
+        return {"total": self.total}
+
+
+class Cart(Aggregate):
+    """Aggregate whose state is a mutable list, snapshotted by the default snapshot_state"""
+
+    def __init__(self, aggregate_id):
+        super().__init__(aggregate_id)
+        self.items = []
+
+    async def handle_command(self, command):
+        event = Event("ItemAdded", self.aggregate_id, {"item": command["item"]})
+        self.apply_event(event)
+        self.uncommitted_events.append(event)
+        return [event]
+
+    def apply_itemadded(self, event):
+        self.items.append(event.payload["item"])
+
+
+class TestEventStore:
+    """Test indexed queries and the on-disk log"""
+
+    @pytest.mark.asyncio
+    async def test_versions_and_queries(self):
+        """Test per-aggregate versions, type index and version slicing"""
+        store = EventStore()
+        for n in range(5):
+            await store.append(Event("Created" if n == 0 else "Changed", "a", {"n": n}))
+            await store.append(Event("Changed", "b", {"n": n}))
+
+        assert [e.version for e in store.get_events(aggregate_id="a")] == [1, 2, 3, 4, 5]
+        assert [e.payload["n"] for e in store.get_events(aggregate_id="a", from_version=2, to_version=3)] == [1, 2]
+        assert len(store.get_events(event_type="Changed")) == 9
+        assert [e.version for e in store.get_events(event_type="Changed", from_version=5)] == [5, 5]
+        assert store.get_event_count() == 10 and store.get_event_count("b") == 5
+        assert store.get_version("a") == 5 and store.get_version("missing") == 0
+
+    @pytest.mark.asyncio
+    async def test_persisted_and_reopened(self, tmp_path):
+        """Test events and snapshots survive reopening, across segment rolls"""
+        store = EventStore(directory=tmp_path, segment_size=256)
+        for n in range(20):
+            await store.append(Event("Changed", f"agg-{n % 3}", {"n": n}))
+        store.create_snapshot("agg-0", {"total": 9}, 4)
+        store.close()
+        assert len(SegmentedEventLog(tmp_path / "events").segments()) > 1
+
+        reopened = EventStore(directory=tmp_path)
+        events = reopened.get_events(aggregate_id="agg-1")
+        assert [e.payload["n"] for e in events] == list(range(1, 20, 3))
+        assert [e.version for e in events] == list(range(1, 8))
+        assert reopened.get_event_count() == 20
+        assert reopened.get_snapshot("agg-0")["version"] == 4
+
+        await reopened.append(Event("Changed", "agg-1", {"n": 99}))
+        assert reopened.get_events(aggregate_id="agg-1", from_version=8)[0].payload == {"n": 99}
+        reopened.close()
+
+    def test_torn_tail_recovery(self, tmp_path):
+        """Test a partially written record is dropped on open"""
+        log = SegmentedEventLog(tmp_path)
+        log.append("a", "T", b'{"ok":1}')
+        log.append("a", "T", b'{"ok":2}')
+        log.close()
+        segment = tmp_path / "0000000000.seg"
+        segment.write_bytes(segment.read_bytes()[:-3])
+
+        log = SegmentedEventLog(tmp_path)
+        records = list(log.scan())
+        assert len(records) == 1
+        assert log.read(records[0][0]) == b'{"ok":1}'
+        location = log.append("a", "T", b'{"ok":3}')
+        assert log.read(location) == b'{"ok":3}'
+        log.close()
+
+    @pytest.mark.asyncio
+    async def test_sync_survives_concurrent_roll(self, tmp_path, monkeypatch):
+        """Test sync fsyncs the segment it flushed even when an append rolls the log meanwhile"""
+        log = SegmentedEventLog(tmp_path, segment_size=64)
+        log.append("a", "T", b"x" * 16)
+        first = os.stat(tmp_path / "0000000000.seg").st_ino
+        real_fsync, synced = os.fsync, []
+
+        def fsync(fd):
+            if not synced:
+                synced.append(None)
+                log.append("a", "T", b"y" * 48)  # rolls, closing the active file
+                synced[0] = os.fstat(fd).st_ino
+            real_fsync(fd)
+
+        monkeypatch.setattr(event_log.os, "fsync", fsync)
+        await log.sync()
+        assert synced == [first] and len(log.segments()) == 2
+        log.close()
+
+
+class TestRepository:
+    """Test snapshot-accelerated loading"""
+
+    @pytest.mark.asyncio
+    async def test_load_replays_only_tail(self, tmp_path):
+        """Test loads restore the snapshot then apply later events"""
+        store = EventStore(directory=tmp_path)
+        repository = Repository(store, Counter, snapshot_every=4)
+        counter = Counter("c")
+        for _ in range(6):
+            await counter.handle_command({"by": 2})
+            await repository.save(counter)
+        assert store.get_snapshot("c")["version"] == 4
+
+        loaded = await repository.load("c")
+        assert loaded.total == 12 and loaded.version == 6
+        assert loaded.applied == 2
+        assert await repository.exists("c") and not await repository.exists("d")
+        store.close()
+
+    @pytest.mark.asyncio
+    async def test_in_memory_snapshot_is_not_aliased(self):
+        """Test events applied after a snapshot change neither the snapshot nor later loads"""
+        store = EventStore()
+        repository = Repository(store, Cart, snapshot_every=2)
+        cart = Cart("cart")
+        for item in (1, 2, 3):
+            await cart.handle_command({"item": item})
+            await repository.save(cart)
+
+        assert store.get_snapshot("cart")["state"]["items"] == [1, 2]
+        loaded = await repository.load("cart")
+        assert loaded.items == [1, 2, 3]
+        loaded.items.append(4)
+        assert (await repository.load("cart")).items == [1, 2, 3]
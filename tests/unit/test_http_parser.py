@@ -0,0 +1,108 @@
+"""
+Unit tests for the native Pyserv HTTP parser
+"""
+from urllib.parse import parse_qs
+
+import pytest
+
+http_parser = pytest.importorskip("pyserv.core.http_parser")
+
+
+class TestParseHeaders:
+    """Test ASGI header decoding"""
+
+    def test_lowercases_and_decodes(self):
+        """Test header names are lowercased and values decoded"""
+        parsed = http_parser.parse_headers([(b"Host", b"example.com"), [b"accept", b"*/*"]])
+        assert parsed == {"host": "example.com", "accept": "*/*"}
+
+    def test_repeated_headers_become_list(self):
+        """Test repeated headers are collected like the Python path"""
+        headers = [(b"x-a", b"1"), (b"x-a", b"2"), (b"x-a", b"3")]
+        assert http_parser.parse_headers(headers) == {"x-a": ["1", "2", "3"]}
+
+
+class TestParseQuery:
+    """Test query string parsing"""
+
+    @pytest.mark.parametrize("qs", [
+        "", "a=1", "a=1&a=2&b=", "c", "&&a=%41%zz", "q=hello+world%21", "e=%C3%A9&x=%E2%82", "=v",
+    ])
+    def test_matches_parse_qs(self, qs):
+        """Test results match urllib.parse.parse_qs"""
+        assert http_parser.parse_query(qs) == parse_qs(qs, keep_blank_values=True)
+
+    def test_accepts_bytes(self):
+        """Test bytes input is parsed without decoding first"""
+        assert http_parser.parse_query(b"a=1&b=%20") == {"a": ["1"], "b": [" "]}
+
+
+class TestParseRequest:
+    """Test raw request head parsing"""
+
+    def test_request_head(self):
+        """Test request line, headers and framing are returned"""
+        data = b"POST /items?x=1 HTTP/1.1\r\nHost: a\r\nContent-Length: 4 \r\n\r\nbody"
+        method, target, minor, headers, head_length, length, chunked = http_parser.parse_request(data)
+
+        assert method == "POST"
+        assert bytes(target) == b"/items?x=1"
+        assert minor == 1
+        assert [(bytes(n), bytes(v)) for n, v in headers] == [(b"Host", b"a"), (b"Content-Length", b"4")]
+        assert data[head_length:] == b"body"
+        assert length == 4
+        assert chunked is False
+
+    def test_header_slices_are_views(self):
+        """Test header slices reference the input buffer"""
+        data = bytearray(b"GET / HTTP/1.1\r\nX-Key: value\r\n\r\n")
+        headers = http_parser.parse_request(data)[3]
+        assert isinstance(headers[0][1], memoryview)
+        assert headers[0][1].obj is data
+
+    def test_incomplete_head(self):
+        """Test incomplete input returns None"""
+        assert http_parser.parse_request(b"GET / HTTP/1.1\r\nHost: a\r\n") is None
+
+    @pytest.mark.parametrize("data", [
+        b"GET / HTTP/2.0\r\n\r\n",
+        b"GET / HTTP/1.1\r\nBad Name: x\r\n\r\n",
+        b"GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n",
+        b"GET / HTTP/1.1\r\nContent-Length: 1\r\nTransfer-Encoding: chunked\r\n\r\n",
+    ])
+    def test_malformed_head(self, data):
+        """Test malformed heads raise HttpParserError"""
+        with pytest.raises(http_parser.HttpParserError):
+            http_parser.parse_request(data)
+
+
+class TestParseChunked:
+    """Test chunked transfer-encoding decoding"""
+
+    def test_complete_body(self):
+        """Test a full chunked body with extensions and trailers"""
+        body = b"5\r\nhello\r\n6;ext=1\r\n world\r\n0\r\nX-Trailer: y\r\n\r\nNEXT"
+        chunks, consumed, done = http_parser.parse_chunked(body)
+        assert b"".join(chunks) == b"hello world"
+        assert body[consumed:] == b"NEXT"
+        assert done is True
+
+    def test_partial_body_resumes(self):
+        """Test partial input stops at the last complete chunk"""
+        body = b"5\r\nhello\r\n6\r\n wor"
+        chunks, consumed, done = http_parser.parse_chunked(body)
+        assert [bytes(c) for c in chunks] == [b"hello"]
+        assert consumed == 10
+        assert done is False
+
+        body += b"ld\r\n0\r\n\r\n"
+        chunks, consumed, done = http_parser.parse_chunked(body, consumed)
+        assert [bytes(c) for c in chunks] == [b" world"]
+        assert done is True
+
+
+def test_parse_content_length():
+    """Test strict Content-Length parsing"""
+    assert http_parser.parse_content_length(" 42 ") == 42
+    with pytest.raises(ValueError):
+        http_parser.parse_content_length("+42")
@@ -0,0 +1,211 @@
+"""
+Unit tests for Pyserv job queue
+"""
+import asyncio
+import json
+import time
+from datetime import timedelta
+
+import pytest
+
+from pyserv.utils.queues import (
+    CronScheduler, DatabaseQueueBackend, Job, MemoryQueueBackend, QueueManager, QueueMetrics,
+    RedisQueueBackend, Worker, job_name, start_workers,
+)
+
+
+def add(a, b):
+    return a + b
+
+
+async def wait_for(predicate, timeout=2.0):
+    deadline = time.monotonic() + timeout
+    while not predicate():
+        if time.monotonic() > deadline:
+            raise AssertionError("condition not met in time")
+        await asyncio.sleep(0.001)
+
+
+def job_for(func, *args, priority=0, delay=None, queue_name='default'):
+    job = Job(func, *args)
+    job.priority = priority
+    job.queue_name = queue_name
+    if delay:
+        job.delay_until = job.created_at + delay
+    return job
+
+
+class TestMemoryBackend:
+    """Test the in-memory backend"""
+
+    def test_priority_batches_and_delay(self):
+        """Test batch dequeue follows priority then FIFO and holds delayed jobs"""
+        backend = MemoryQueueBackend()
+        low, high, also_high = job_for(add, 1, 1), job_for(add, 2, 2, priority=5), job_for(add, 3, 3, priority=5)
+        later = job_for(add, 4, 4, delay=timedelta(milliseconds=50))
+        for job in (low, high, also_high, later):
+            backend.enqueue(job)
+
+        assert backend.get_queue_size() == 4
+        assert backend.dequeue_batch(max_jobs=10) == [high, also_high, low]
+        assert backend.dequeue() is None
+        time.sleep(0.06)
+        assert backend.dequeue() is later and later.status == 'running'
+
+    @pytest.mark.asyncio
+    async def test_fetch_wakes_on_enqueue(self):
+        """Test a waiting fetch returns as soon as a job arrives, including from another thread"""
+        backend = MemoryQueueBackend()
+        fetch = asyncio.ensure_future(backend.fetch(max_jobs=4, timeout=5.0))
+        await asyncio.sleep(0.01)
+        job = job_for(add, 1, 2)
+        start = time.perf_counter()
+        await asyncio.get_running_loop().run_in_executor(None, backend.enqueue, job)
+        assert await fetch == [job]
+        assert time.perf_counter() - start < 0.5
+
+        # A delayed job bounds the wait instead of the timeout
+        backend.enqueue(job_for(add, 1, 2, delay=timedelta(milliseconds=30)))
+        start = time.perf_counter()
+        assert len(await backend.fetch(timeout=5.0)) == 1
+        assert time.perf_counter() - start < 0.5
+
+
+class TestWorkers:
+    """Test asyncio workers"""
+
+    @pytest.mark.asyncio
+    async def test_jobs_start_without_polling_delay(self):
+        """Test an idle worker starts a job immediately and records its wait"""
+        manager = QueueManager()
+        manager.start_worker(max_concurrent=2)
+        await asyncio.sleep(0.01)
+
+        async def double(n):
+            return n * 2
+
+        ids = [manager.enqueue(double, n) for n in range(5)] + [manager.enqueue(add, 2, 3)]
+        await wait_for(lambda: all(manager.get_job(i).status == 'completed' for i in ids))
+        assert [manager.get_job(i).result for i in ids] == [0, 2, 4, 6, 8, 5]
+
+        stats = manager.get_stats()['default']
+        assert stats['completed'] == 6 and stats['wait_p99'] <= 0.25
+        await manager.shutdown()
+
+    @pytest.mark.asyncio
+    async def test_retries_then_fails(self):
+        """Test a failing job is retried up to max_retries and the outcome is counted"""
+        manager = QueueManager()
+        calls = []
+
+        async def flaky():
+            calls.append(1)
+            raise ValueError("boom")
+
+        job_id = manager.enqueue(flaky)
+        manager.get_job(job_id).max_retries = 2
+        manager.start_worker()
+        await wait_for(lambda: manager.get_job(job_id).status == 'failed')
+        assert len(calls) == 2 and manager.get_job(job_id).error == "boom"
+        assert manager.metrics['default'].retried == 1 and manager.metrics['default'].failed == 1
+
+        names = {value.name for value in manager.collect_metrics()}
+        assert {"job_queue_wait_seconds_bucket", "job_queue_jobs_total", "job_queue_depth"} <= names
+        await manager.shutdown()
+
+    @pytest.mark.asyncio
+    async def test_idle_workers_steal(self):
+        """Test a sibling steals jobs one worker fetched but cannot start yet"""
+        backend = MemoryQueueBackend()
+        metrics = QueueMetrics()
+        greedy = Worker(backend, max_concurrent=1, batch_size=8, metrics=metrics)
+        idle = Worker(backend, max_concurrent=1, batch_size=8, metrics=metrics)
+        greedy.peers, idle.peers = [idle], [greedy]
+
+        async def slow(n):
+            await asyncio.sleep(0.05)
+            return n
+
+        jobs = [job_for(slow, n) for n in range(8)]
+        for job in jobs:
+            backend.enqueue(job)
+        start = time.perf_counter()
+        start_workers([greedy])
+        await asyncio.sleep(0)
+        start_workers([idle])
+        await wait_for(lambda: all(job.status == 'completed' for job in jobs))
+        elapsed = time.perf_counter() - start
+
+        assert metrics.stolen > 0 and metrics.batches >= 1
+        assert elapsed < 8 * 0.05
+        await asyncio.gather(greedy.shutdown(), idle.shutdown())
+
+    def test_thread_mode_from_sync_code(self):
+        """Test workers started outside an event loop run on their own thread and stop cleanly"""
+        manager = QueueManager()
+        manager.start_worker(num_workers=2, max_concurrent=2)
+        job_id = manager.enqueue(add, 20, 22)
+        deadline = time.monotonic() + 2.0
+        while manager.get_job(job_id).status != 'completed' and time.monotonic() < deadline:
+            time.sleep(0.005)
+        assert manager.get_job(job_id).result == 42
+
+        start = time.perf_counter()
+        manager.stop_workers()
+        assert time.perf_counter() - start < 1.0
+
+    def test_job_round_trip(self):
+        """Test serialized jobs resolve their function by registered or dotted name"""
+        job = job_for(add, 1, 2, priority=3)
+        job.enqueued_at = 123.0
+        restored = Job.from_json(job.to_json(), {job_name(add): add})
+        assert restored.func is add and restored.args == (1, 2) and restored.priority == 3
+        assert restored.enqueued_at == 123.0
+        assert Job.from_json(job_for(json.dumps, [1]).to_json()).func is json.dumps
+
+        data = job.to_dict()
+        data['func_name'] = 'json.no_such_job'
+        with pytest.raises(LookupError):
+            Job.from_dict(data).func()
+
+
+class TestStoreBackends:
+    """Test Redis and database backends without a server"""
+
+    @pytest.mark.parametrize("backend_type, option", [(RedisQueueBackend, "redis_client"),
+                                                      (DatabaseQueueBackend, "db_connection")])
+    def test_sync_api_refuses_a_configured_store(self, backend_type, option):
+        """Test sync calls raise instead of reading process memory once a store is configured"""
+        unconfigured = backend_type()
+        job = job_for(add, 1, 2)
+        assert unconfigured.enqueue(job) and unconfigured.get_job(job.id) is job
+        assert unconfigured.get_queue_size() == 1
+
+        backend = backend_type(**{option: object()})
+        for call in (lambda: backend.enqueue(job), lambda: backend.dequeue(), lambda: backend.get_job(job.id),
+                     lambda: backend.update_job(job), lambda: backend.get_queue_size()):
+            with pytest.raises(RuntimeError):
+                call()
+
+        manager = QueueManager(backend)
+        with pytest.raises(RuntimeError, match="enqueue_async"):
+            manager.enqueue(add, 1, 2)
+        with pytest.raises(RuntimeError, match="get_job_async"):
+            manager.get_job(job.id)
+        with pytest.raises(RuntimeError, match="get_queue_size_async"):
+            manager.get_queue_size()
+
+
+class TestCronScheduler:
+    """Test the cron scheduler"""
+
+    def test_stop_wakes_scheduler(self):
+        """Test stopping does not wait out the sleep until the next run"""
+        scheduler = CronScheduler()
+        scheduler.add_job(lambda: None, "0 * * * *")
+        scheduler.start()
+        time.sleep(0.01)
+        start = time.perf_counter()
+        scheduler.stop()
+        scheduler.thread.join(1.0)
+        assert not scheduler.thread.is_alive() and time.perf_counter() - start < 1.0
@@ -0,0 +1,116 @@
+"""
+Unit tests for Pyserv JSON codec
+"""
+import dataclasses
+import datetime
+import decimal
+import enum
+import uuid
+
+import pytest
+
+from pyserv.core import codec
+from pyserv.http.response import Response
+
+
+class Color(enum.Enum):
+    RED = "red"
+
+
+@dataclasses.dataclass
+class Point:
+    x: int
+    y: int
+
+
+class Model:
+    def to_dict(self):
+        return {"id": 7}
+
+
+class TestJSONCodec:
+    """Test the shared JSON codec"""
+
+    def test_compact_utf8_bytes(self):
+        """Test output is compact UTF-8 bytes with non-ASCII kept as-is"""
+        data = codec.dumps({"name": "café", "items": [1, 2]})
+        assert isinstance(data, bytes)
+        assert data == '{"name":"café","items":[1,2]}'.encode("utf-8")
+        assert codec.dumps_str([None, True]) == "[null,true]"
+
+    def test_extended_types(self):
+        """Test dataclasses, models, dates, enums and other framework types"""
+        ident = uuid.UUID(int=1)
+        value = {
+            "point": Point(1, 2),
+            "model": Model(),
+            "when": datetime.datetime(2024, 1, 2, 3, 4, 5),
+            "day": datetime.date(2024, 1, 2),
+            "color": Color.RED,
+            "id": ident,
+            "price": decimal.Decimal("1.50"),
+        }
+        assert codec.loads(codec.dumps(value)) == {
+            "point": {"x": 1, "y": 2},
+            "model": {"id": 7},
+            "when": "2024-01-02T03:04:05",
+            "day": "2024-01-02",
+            "color": "red",
+            "id": str(ident),
+            "price": "1.50",
+        }
+        assert sorted(codec.loads(codec.dumps({"tags": {"a", "b"}}))["tags"]) == ["a", "b"]
+        assert codec.loads(codec.dumps(2 ** 70)) == 2 ** 70
+
+    def test_register_encoder(self, monkeypatch):
+        """Test custom encoders apply to subclasses"""
+        class Money:
+            def __init__(self, cents):
+                self.cents = cents
+
+        class Euro(Money):
+            pass
+
+        monkeypatch.setitem(codec._encoders, Money, lambda m: m.cents / 100)
+        assert codec.dumps([Euro(250)]) == b"[2.5]"
+
+    def test_errors(self):
+        """Test encode and decode failures use codec exceptions"""
+        with pytest.raises(codec.EncodeError):
+            codec.dumps(object())
+        for data in (b"{", "[1,]", b"\xff"):
+            with pytest.raises(codec.DecodeError):
+                codec.loads(data)
+
+    def test_loads_bytes_like(self):
+        """Test loads accepts bytes, bytearray, memoryview and str"""
+        for data in (b'{"a":1}', bytearray(b'{"a":1}'), memoryview(b'{"a":1}'), '{"a":1}'):
+            assert codec.loads(data) == {"a": 1}
+
+    @pytest.mark.parametrize("backend", ["stdlib", "orjson"])
+    def test_backends_agree(self, backend):
+        """Test every backend produces identical bytes"""
+        if backend != "stdlib":
+            pytest.importorskip(backend)
+        active = codec.BACKEND
+        try:
+            codec.set_backend(backend)
+            data = codec.dumps({"s": "ü", "n": 1.5, "d": datetime.date(2024, 1, 1), "l": [Point(0, 1)]})
+        finally:
+            codec.set_backend(active)
+        assert data == '{"s":"ü","n":1.5,"d":"2024-01-01","l":[{"x":0,"y":1}]}'.encode("utf-8")
+
+
+class TestResponseJSON:
+    """Test responses serialize through the codec"""
+
+    def test_json_response(self):
+        """Test dict content and non-container JSON content"""
+        assert Response({"a": "é"})._get_content_bytes() == '{"a":"é"}'.encode("utf-8")
+        response = Response.json(Point(3, 4))
+        assert response._get_content_bytes() == b'{"x":3,"y":4}'
+
+    def test_json_response_charset(self):
+        """Test a non-UTF-8 charset re-encodes the output"""
+        response = Response({"a": "é"}, charset="latin-1")
+        assert response._get_content_bytes() == '{"a":"é"}'.encode("latin-1")
@@ -0,0 +1,107 @@
+"""
+Unit tests for Pyserv lazy imports
+"""
+import subprocess
+import sys
+from pathlib import Path
+
+import pytest
+
+from pyserv.performance.importtime import ImportReport, measure_import, parse_importtime
+from pyserv.utils.lazy import attach
+
+SRC = str(Path(__file__).resolve().parents[2] / "src")
+
+
+def fresh_modules(statement):
+    """Modules loaded by ``statement`` in a fresh interpreter"""
+    code = f"import sys; before = set(sys.modules); {statement}; print(sorted(set(sys.modules) - before))"
+    output = subprocess.run([sys.executable, "-c", code], capture_output=True, text=True,
+                            env={"PYTHONPATH": SRC}, check=True).stdout
+    return eval(output)
+
+
+class TestAttach:
+    """Test PEP 562 lazy exports"""
+
+    def test_exports_load_on_first_access(self, tmp_path, monkeypatch):
+        """Test names resolve from their submodule once, and unknown names still raise"""
+        package = tmp_path / "lazypkg"
+        package.mkdir()
+        (package / "__init__.py").write_text(
+            "from pyserv.utils.lazy import attach\n"
+            "__getattr__, __dir__ = attach(__name__, {'.heavy': ['Engine']}, submodules=['extra'],\n"
+            "                              aliases={'Motor': '.heavy:Engine'})\n"
+        )
+        (package / "heavy.py").write_text("class Engine:\n    pass\n")
+        (package / "extra.py").write_text("VALUE = 1\n")
+        monkeypatch.syspath_prepend(str(tmp_path))
+
+        import lazypkg
+        try:
+            assert "lazypkg.heavy" not in sys.modules
+            assert {"Engine", "Motor", "extra"} <= set(dir(lazypkg))
+
+            engine = lazypkg.Engine
+            assert "lazypkg.heavy" in sys.modules and lazypkg.__dict__["Engine"] is engine
+            assert lazypkg.Motor is engine and lazypkg.extra.VALUE == 1
+            with pytest.raises(AttributeError):
+                lazypkg.Missing
+        finally:
+            for name in [name for name in sys.modules if name.split(".")[0] == "lazypkg"]:
+                del sys.modules[name]
+
+    def test_attach_requires_registered_package(self):
+        """Test attach is only usable from within the package being defined"""
+        with pytest.raises(KeyError):
+            attach("no_such_package_xyz", {})
+
+
+class TestColdImport:
+    """Test importing the framework does not pull in optional subsystems"""
+
+    def test_package_import_is_lean(self):
+        """Test ``import pyserv`` loads only the package itself"""
+        loaded = [name for name in fresh_modules("import pyserv") if name.startswith("pyserv")]
+        assert set(loaded) <= {"pyserv", "pyserv.utils", "pyserv.utils.lazy"}
+
+    @pytest.mark.parametrize("package, heavy", [
+        ("pyserv.payment", "pyserv.payment.stripe_processor"),
+        ("pyserv.neuralforge", "pyserv.neuralforge.llm_engine"),
+        ("pyserv.iot", "pyserv.iot.mqtt_client"),
+        ("pyserv.security", "pyserv.security.quantum_security"),
+    ])
+    def test_optional_subsystems_are_deferred(self, package, heavy):
+        """Test importing a subsystem package leaves its submodules unloaded"""
+        assert heavy not in fresh_modules(f"import {package}")
+
+
+class TestImportTime:
+    """Test the import-time report behind ``pyserv importtime``"""
+
+    def test_parse_importtime(self):
+        """Test -X importtime lines are parsed and grouped by subsystem"""
+        output = (
+            "import time: self [us] | cumulative | imported package\n"
+            "import time:       120 |        120 |     pyserv.http.request\n"
+            "import time:        80 |        200 |   pyserv.http\n"
+            "import time:       300 |        300 |   json\n"
+            "Traceback (most recent call last):\n"
+            "import time:        50 |        550 | pyserv\n"
+        )
+        records = parse_importtime(output)
+        assert [record.module for record in records] == ["pyserv.http.request", "pyserv.http", "json", "pyserv"]
+        assert records[0].depth == 2 and records[-1].cumulative_us == 550
+
+        report = ImportReport("pyserv", records)
+        assert report.total_us == 550
+        assert report.by_subsystem() == [("json", 300, 1), ("pyserv.http", 200, 2), ("pyserv", 50, 1)]
+
+    def test_measure_import(self):
+        """Test a fresh interpreter is measured, excluding startup modules"""
+        report = measure_import("json", runs=1)
+        assert report.ok and "json" in {record.module for record in report.records}
+        assert "site" not in {record.module for record in report.records}
+
+        failed = measure_import("no_such_module_xyz", runs=1)
+        assert not failed.ok and "ModuleNotFoundError" in failed.error
@@ -0,0 +1,172 @@
+"""
+Unit tests for Pyserv Lean template compilation
+"""
+import os
+
+import pytest
+
+from pyserv.templating.engine import AbstractTemplateEngine
+from pyserv.templating.languages.lean import LeanTemplateEngine
+from pyserv.templating.languages.lean_compiler import (
+    WHILE_MAX_ITERATIONS, TemplateCompiler, TemplateRuntimeError, TemplateSyntaxError,
+)
+
+
+def write(path, text, mtime=None):
+    """Write a template, optionally pinning its mtime"""
+    path.write_text(text)
+    if mtime is not None:
+        os.utime(path, ns=(mtime, mtime))
+
+
+class TestCompiledTemplates:
+    """Test rendering through compiled templates"""
+
+    @pytest.mark.asyncio
+    async def test_engine_base_options(self, tmp_path):
+        """Test the shared engine base takes its directory, search paths and switches from options"""
+        (tmp_path / "page.html").write_text("{{ name|upper }}")
+        engine = LeanTemplateEngine(str(tmp_path), debug=True)
+        assert isinstance(engine, AbstractTemplateEngine)
+        assert engine.template_dir == tmp_path and engine.template_search_paths == [tmp_path]
+        assert engine.debug and not engine.enable_i18n
+        assert await engine.render("page.html", {"name": "lean"}) == "LEAN"
+
+    @pytest.mark.asyncio
+    async def test_control_flow(self, tmp_path):
+        """Test elif/else, filtered loops, loop else and loop controls"""
+        engine = LeanTemplateEngine(tmp_path)
+        template = (
+            "{% if n > 10 %}big{% elif n > 5 %}medium{% else %}small{% endif %}|"
+            "{% for x in items if x % 2 %}{{ loop.index }}:{{ x }}{% if loop.last %}.{% endif %}{% endfor %}|"
+            "{% for x in empty %}x{% else %}none{% endfor %}|"
+            "{% for x in items %}{% if x == 4 %}{% break %}{% endif %}{{ x }}{% endfor %}"
+        )
+        context = {"n": 7, "items": [1, 2, 3, 4, 5], "empty": []}
+        assert await engine.render_string(template, context) == "medium|1:12:33:5.|none|123"
+
+    @pytest.mark.asyncio
+    async def test_while_loops(self, tmp_path):
+        """Test while loops see their own sets, honour break and stop at the iteration cap"""
+        engine = LeanTemplateEngine(tmp_path)
+        template = ("{% set i = 0 %}{% while i < 5 %}{% set i = i + 1 %}{% if i == 4 %}{% break %}{% endif %}"
+                    "{{ i }}{% endwhile %}|{% while forever %}.{% endwhile %}")
+        result = await engine.render_string(template, {"forever": True})
+        assert result == "123|" + "." * WHILE_MAX_ITERATIONS
+        with pytest.raises(TemplateSyntaxError):
+            TemplateCompiler().compile_string("{% while x %}open", tmp_path)
+
+    @pytest.mark.asyncio
+    async def test_expressions_and_filters(self, tmp_path):
+        """Test paths, literals, chained filters and colon arguments"""
+        engine = LeanTemplateEngine(tmp_path)
+        template = ("{{ users.0.name | upper | default:x }} {{ missing | default:guest }} "
+                    "{{ price | round:1 }} {{ tags | join(sep) }} {{ flag == true }}")
+        context = {"users": [{"name": "ann"}], "missing": None, "price": 2.345,
+                   "tags": ["a", "b"], "sep": "-", "flag": True}
+        assert await engine.render_string(template, context) == "ANN guest 2.3 a-b True"
+        assert await engine.render_string("{{ nope.deeper }}", {}) == "{{ nope.deeper }}"
+
+    @pytest.mark.asyncio
+    async def test_macros_and_scoping(self, tmp_path):
+        """Test macro defaults, keyword arguments and that loop/with scopes do not leak"""
+        engine = LeanTemplateEngine(tmp_path)
+        template = (
+            '{% macro tag(name, cls="x") %}<b class="{{ cls }}">{{ name }}</b>{% endmacro %}'
+            '{% call tag("a") %}{{ tag("<b>", cls="y") }}'
+            "{% for i in items %}{% set last = i %}{% endfor %}{{ last }}"
+            "{% with v=1 %}{{ v }}{% endwith %}{{ v }}"
+        )
+        result = await engine.render_string(template, {"items": [1, 2]})
+        assert result == '<b class="x">a</b><b class="y">&lt;b&gt;</b>{{ last }}1{{ v }}'
+
+    @pytest.mark.asyncio
+    async def test_multilevel_inheritance_and_includes(self, tmp_path):
+        """Test extends chains, nested block overrides and relative includes"""
+        (tmp_path / "parts").mkdir()
+        write(tmp_path / "base.html",
+              "<title>{% block title %}Site{% endblock %}</title>"
+              "{% block body %}{% block sidebar %}side{% endblock %}{% endblock %}")
+        write(tmp_path / "layout.html",
+              '{% extends "base.html" %}{% block body %}[{% block sidebar %}menu{% endblock %}]'
+              '{% include "parts/footer.html" %}{% endblock %}')
+        write(tmp_path / "parts" / "footer.html", "<footer>{{ year }}</footer>")
+        write(tmp_path / "page.html",
+              '{% extends "layout.html" %}{% set active = "home" %}'
+              "{% block title %}{{ active }}{% endblock %}{% block sidebar %}links{% endblock %}")
+
+        engine = LeanTemplateEngine(tmp_path)
+        result = await engine.render("page.html", {"year": 2024})
+        assert result == "<title>home</title>[links]<footer>2024</footer>"
+
+    @pytest.mark.asyncio
+    async def test_cache_invalidation(self, tmp_path):
+        """Test compiled templates are reused until the page or an include changes"""
+        write(tmp_path / "part.html", "one", mtime=1_000_000_000)
+        write(tmp_path / "page.html", '{% include "part.html" %}!', mtime=1_000_000_000)
+        engine = LeanTemplateEngine(tmp_path)
+
+        assert await engine.render("page.html", {}) == "one!"
+        assert await engine.render("page.html", {}) == "one!"
+        assert engine.render_stats['compilations'] == 1
+        assert engine.render_stats['cache_hits'] == 1
+
+        write(tmp_path / "part.html", "two", mtime=2_000_000_000)
+        assert await engine.render("page.html", {}) == "two!"
+        assert engine.render_stats['compilations'] == 2
+
+    @pytest.mark.asyncio
+    async def test_disk_cache(self, tmp_path):
+        """Test compiled templates persist across engine instances"""
+        templates = tmp_path / "templates"
+        templates.mkdir()
+        write(templates / "page.html", "Hi {{ name }}", mtime=1_000_000_000)
+        cache_dir = tmp_path / "compiled"
+
+        first = LeanTemplateEngine(templates, cache_dir=cache_dir)
+        assert await first.render("page.html", {"name": "a"}) == "Hi a"
+        assert len(list(cache_dir.glob("*.leanc"))) == 1
+
+        second = LeanTemplateEngine(templates, cache_dir=cache_dir)
+        assert await second.render("page.html", {"name": "b"}) == "Hi b"
+        assert second.render_stats['compilations'] == 0
+
+        write(templates / "page.html", "Bye {{ name }}", mtime=2_000_000_000)
+        third = LeanTemplateEngine(templates, cache_dir=cache_dir)
+        assert await third.render("page.html", {"name": "c"}) == "Bye c"
+        assert third.render_stats['compilations'] == 1
+
+
+class TestCompilerErrors:
+    """Test syntax and runtime errors"""
+
+    def test_syntax_errors(self, tmp_path):
+        """Test unclosed blocks and unsafe expressions are rejected at compile time"""
+        compiler = TemplateCompiler()
+        for source in ("{% if x %}open", "{{ x.__class__ }}", "{{ [y for y in x] }}", "{% endfor %}"):
+            with pytest.raises(TemplateSyntaxError):
+                compiler.compile_string(source, tmp_path)
+
+    @pytest.mark.asyncio
+    async def test_runtime_error_line(self, tmp_path):
+        """Test runtime errors report the template line"""
+        engine = LeanTemplateEngine(tmp_path)
+        with pytest.raises(TemplateRuntimeError):
+            await engine.render_string("line one\n{{ 1 / zero }}", {"zero": 0})
+        try:
+            await engine.render_string("line one\n{{ 1 / zero }}", {"zero": 0})
+        except TemplateRuntimeError as e:
+            assert e.line_number == 2
+
+    @pytest.mark.asyncio
+    async def test_format_cannot_reach_private_attributes(self, tmp_path):
+        """Test format fields cannot walk into dunder attributes and module globals"""
+        engine = LeanTemplateEngine(tmp_path)
+        escape = '{{ "{0.__class__.__init__.__globals__}".format(x) }}'
+        with pytest.raises(TemplateRuntimeError):
+            await engine.render_string(escape, {"x": engine})
+        with pytest.raises(TemplateRuntimeError):
+            await engine.render_string('{{ fmt["format_map"]({}) }}', {"fmt": "{a}"})
+        leaked = await engine.render_string('{{ x | format("{0.__class__.__init__.__globals__}") }}', {"x": engine})
+        assert "__builtins__" not in leaked
+        assert await engine.render_string('{{ price | format("{:.2f}") }}', {"price": 2.5}) == "2.50"
@@ -0,0 +1,88 @@
+"""
+Unit tests for Pyserv Memory Cache
+"""
+import time
+
+import pytest
+
+from pyserv.caching.cache_manager import CacheConfig
+from pyserv.caching.memory_cache import MemoryCache
+
+
+class TestMemoryCache:
+    """Test MemoryCache LRU and TTL handling"""
+
+    @pytest.mark.asyncio
+    async def test_get_set_delete(self):
+        """Test basic operations"""
+        cache = MemoryCache()
+        assert await cache.set('a', {'x': 1})
+        assert await cache.get('a') == {'x': 1}
+        assert await cache.delete('a')
+        assert await cache.get('a') is None
+        assert not await cache.delete('a')
+
+    @pytest.mark.asyncio
+    async def test_lru_eviction(self):
+        """Test the least recently used key is evicted first"""
+        cache = MemoryCache(CacheConfig(max_memory_size=30), shards=1)
+        await cache.set('a', 'x' * 10)
+        await cache.set('b', 'x' * 10)
+        await cache.set('c', 'x' * 10)
+        await cache.get('a')
+        await cache.set('d', 'x' * 10)
+
+        assert await cache.get('b') is None
+        assert await cache.get('a') is not None
+        assert cache.get_stats()['evictions'] == 1
+        assert cache.current_size == 30
+
+    @pytest.mark.asyncio
+    async def test_caller_supplied_size(self):
+        """Test explicit sizes are accounted and oversized values rejected"""
+        cache = MemoryCache(CacheConfig(max_memory_size=100), shards=1)
+        assert await cache.set('a', object(), size=40)
+        assert cache.current_size == 40
+        assert not await cache.set('b', 'small', size=101)
+
+    @pytest.mark.asyncio
+    async def test_ttl_expiry(self, monkeypatch):
+        """Test expired keys are dropped lazily and by purge_expired"""
+        now = [1000.0]
+        monkeypatch.setattr(time, 'monotonic', lambda: now[0])
+        cache = MemoryCache(shards=1)
+        await cache.set('short', 1, ttl_seconds=5)
+        await cache.set('lazy', 2, ttl_seconds=5)
+        await cache.set('long', 3, ttl_seconds=60)
+
+        now[0] += 10
+        assert await cache.get('lazy') is None
+        assert cache.purge_expired() == 1
+        assert len(cache) == 1
+        assert await cache.get('long') == 3
+
+    @pytest.mark.asyncio
+    async def test_wheel_tracks_only_live_keys(self, monkeypatch):
+        """Test overwritten, deleted, evicted and lazily expired keys leave the timer wheel"""
+        now = [1000.0]
+        monkeypatch.setattr(time, 'monotonic', lambda: now[0])
+        cache = MemoryCache(CacheConfig(max_memory_size=30), shards=1)
+        shard = cache._shards[0]
+        await cache.set('cold', 'x', ttl_seconds=5, size=10)
+        for ttl in range(1, 1001):
+            await cache.set('hot', 'x', ttl_seconds=ttl, size=1)
+        await cache.set('gone', 'x', ttl_seconds=5, size=1)
+        await cache.delete('gone')
+        await cache.set('lazy', 'x', ttl_seconds=2, size=1)
+        await cache.set('big', 'x', ttl_seconds=60, size=25)
+        assert await cache.get('cold') is None
+
+        assert sorted(key for keys in shard.wheel.values() for key in keys) == ['big', 'hot', 'lazy']
+        now[0] += 5
+        assert await cache.get('lazy') is None
+        assert sum(len(keys) for keys in shard.wheel.values()) == 2
+
+    def test_shards_power_of_two(self):
+        """Test shard count validation"""
+        with pytest.raises(ValueError):
+            MemoryCache(shards=3)
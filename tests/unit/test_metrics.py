@@ -0,0 +1,139 @@
+"""
+Unit tests for Pyserv metrics
+"""
+import threading
+import tracemalloc
+
+import pytest
+
+from pyserv.monitoring.metrics import (
+    BucketHistogram, Counter, Gauge, Histogram, MetricsCollector, MetricValue, QuantileSketch,
+    SketchHistogram, StripedCounter, metrics_endpoint,
+)
+
+
+class TestPrimitives:
+    """Test the fixed-size building blocks"""
+
+    def test_striped_counter_threads(self):
+        """Test concurrent writers lose no increments"""
+        counter = StripedCounter()
+
+        def work():
+            for _ in range(10000):
+                counter.add()
+
+        threads = [threading.Thread(target=work) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        assert counter.value == 40000
+
+    def test_bucket_quantiles(self):
+        """Test bucket placement follows Prometheus ``le`` and quantiles interpolate"""
+        histogram = BucketHistogram([1.0, 2.0, 4.0])
+        for value in (0.5, 1.0, 1.5, 3.0, 9.0):
+            histogram.add(value)
+        assert list(histogram.counts) == [2, 1, 1, 1]
+        assert histogram.cumulative()[-1] == (float("inf"), 5)
+        assert histogram.quantile(0.4) == pytest.approx(1.0)
+        assert histogram.quantile(0.5) == pytest.approx(1.5)
+
+    def test_sketch_relative_accuracy(self):
+        """Test sketch quantiles stay within the configured relative error"""
+        sketch = QuantileSketch(relative_accuracy=0.01)
+        values = [(n + 1) / 1000 for n in range(10000)]
+        for value in values:
+            sketch.add(value)
+        for q in (0.5, 0.9, 0.99):
+            exact = values[int(q * (len(values) - 1))]
+            assert abs(sketch.quantile(q) - exact) <= 0.01 * exact
+
+        other = QuantileSketch(relative_accuracy=0.01)
+        other.add(1000.0)
+        sketch.merge(other)
+        assert sketch.count == 10001 and sketch.quantile(1.0) == 1000.0
+
+
+class TestMetrics:
+    """Test metric updates stay allocation-free and render correctly"""
+
+    def test_updates_do_not_grow(self):
+        """Test repeated labelled updates retain no memory"""
+        counter = Counter("requests_total")
+        histogram = Histogram("latency_seconds", buckets=[0.01, 0.1, 1.0])
+        labels = {"route": "/users"}
+        counter.increment(labels=labels)
+        histogram.observe(0.05, labels)
+
+        tracemalloc.start()
+        before = tracemalloc.take_snapshot()
+        for n in range(100000):
+            counter.increment(labels=labels)
+            histogram.observe(n / 100000, labels)
+        after = tracemalloc.take_snapshot()
+        tracemalloc.stop()
+        growth = sum(stat.size_diff for stat in after.compare_to(before, "filename"))
+        assert growth < 16 * 1024
+        assert counter.with_labels(labels).value == 100001
+        assert histogram.with_labels(route="/users").count == 100001
+
+    def test_label_sets_are_cached(self):
+        """Test the same labels resolve to the same series and merge base labels"""
+        gauge = Gauge("connections", labels={"node": "a"})
+        series = gauge.with_labels(pool="db")
+        assert gauge.with_labels({"pool": "db"}) is series
+        gauge.set(3, {"pool": "db"})
+        assert series.value == 3 and series.labels == {"node": "a", "pool": "db"}
+
+    def test_label_order_is_one_series(self):
+        """Test label sets that differ only in order share one series, rendered in sorted order"""
+        counter = Counter("requests_total")
+        counter.increment(1, {"route": "/a", "method": "GET"})
+        counter.increment(1, {"method": "GET", "route": "/a"})
+        series = counter.with_labels(route="/a", method="GET")
+        assert series.value == 2 and len(counter.series()) == 2
+        assert list(series.labels) == ["method", "route"]
+
+    def test_prometheus_exposition(self):
+        """Test text exposition renders every series, escaping and custom collectors"""
+        collector = MetricsCollector()
+        counter = collector.create_counter("jobs_total", "Jobs run")
+        counter.increment(2, {"queue": 'a"b'})
+        collector.create_histogram("wait_seconds", buckets=[0.5]).observe(0.25)
+        collector.create_sketch("size_bytes", quantiles=(0.5,)).observe(100)
+        collector.add_collector(lambda: [MetricValue("pool_idle", 4, 0.0, {"pool": "x"})])
+
+        text = collector.to_prometheus()
+        assert "# HELP jobs_total Jobs run\n# TYPE jobs_total counter\n" in text
+        assert 'jobs_total{queue="a\\"b"} 2\n' in text
+        assert 'wait_seconds_bucket{le="0.5"} 1\n' in text
+        assert 'wait_seconds_bucket{le="+Inf"} 1\n' in text
+        assert "wait_seconds_count 1\n" in text
+        assert 'size_bytes{quantile="0.5"} ' in text
+        assert '# TYPE pool_idle gauge\npool_idle{pool="x"} 4\n' in text
+
+        openmetrics = collector.to_prometheus(openmetrics=True)
+        assert "# TYPE jobs counter\n" in openmetrics and openmetrics.endswith("# EOF\n")
+
+    @pytest.mark.asyncio
+    async def test_endpoint_negotiates_format(self):
+        """Test the scrape handler picks OpenMetrics from Accept"""
+        collector = MetricsCollector()
+        collector.create_counter("hits_total").increment()
+        handler = metrics_endpoint(collector)
+
+        class Scrape:
+            accept = "application/openmetrics-text; version=1.0.0"
+
+        response = await handler(Scrape())
+        assert response.media_type.startswith("application/openmetrics-text")
+        assert "hits_total 1" in response.content
+
+    def test_collect_builds_values(self):
+        """Test ``collect`` still produces MetricValue records"""
+        sketch = SketchHistogram("rtt", quantiles=(0.5,))
+        sketch.observe(0.2)
+        names = [value.name for value in sketch.collect()]
+        assert names == ["rtt", "rtt_sum", "rtt_count"]
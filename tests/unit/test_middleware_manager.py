@@ -0,0 +1,116 @@
+"""
+Unit tests for Pyserv Middleware Manager
+"""
+import pytest
+
+from pyserv.middleware.manager import MiddlewareManager, MiddlewarePhase, MiddlewarePriority
+
+
+class _Request:
+    """Bare request object for driving the chain"""
+    method = 'GET'
+    path = '/'
+
+
+def _recorder(name, calls):
+    async def middleware(request, call_next):
+        calls.append(name)
+        response = await call_next(request)
+        calls.append(f"{name}:done")
+        return response
+    middleware.__name__ = name
+    return middleware
+
+
+class TestMiddlewareChain:
+    """Test the compiled HTTP middleware chain"""
+
+    @pytest.mark.asyncio
+    async def test_chain_order_and_release(self):
+        """Test middleware wrap the handler by priority and contexts are freed"""
+        calls = []
+        manager = MiddlewareManager()
+        manager.add(_recorder('low', calls), priority=MiddlewarePriority.LOW)
+        manager.add(_recorder('high', calls), priority=MiddlewarePriority.HIGH)
+
+        response = await manager.execute_http_chain(_Request(), lambda request: 'ok')
+
+        assert response == 'ok'
+        assert calls == ['high', 'low', 'low:done', 'high:done']
+        assert manager.request_contexts == {}
+
+    @pytest.mark.asyncio
+    async def test_disabled_middleware_skipped(self):
+        """Test disabling recompiles the chain"""
+        calls = []
+        manager = MiddlewareManager()
+        manager.add(_recorder('a', calls))
+        manager.add(_recorder('b', calls))
+        manager.disable('a')
+
+        await manager.execute_http_chain(_Request(), lambda request: None)
+        assert calls == ['b', 'b:done']
+        assert manager.get_stats()['active_http_middlewares'] == 1
+
+        manager.enable('a')
+        manager.remove('b')
+        calls.clear()
+        await manager.execute_http_chain(_Request(), lambda request: None)
+        assert calls == ['a', 'a:done']
+
+    @pytest.mark.asyncio
+    async def test_response_only_middleware(self):
+        """Test response-phase middleware run after the chain"""
+        manager = MiddlewareManager()
+
+        async def add_suffix(request, response):
+            return response + '!'
+
+        manager.add(add_suffix, phases=[MiddlewarePhase.RESPONSE])
+
+        async def handler(request):
+            return 'ok'
+
+        assert await manager.execute_http_chain(_Request(), handler) == 'ok!'
+
+    @pytest.mark.asyncio
+    async def test_sampled_timing(self):
+        """Test only one request in timing_sample_rate is timed"""
+        manager = MiddlewareManager(timing_sample_rate=4)
+        manager.add(_recorder('timed', []))
+
+        for _ in range(8):
+            await manager.execute_http_chain(_Request(), lambda request: None)
+
+        stats = manager.get_stats()['middleware_stats']['timed']
+        assert stats['execution_count'] == 8
+        assert stats['timed_count'] == 2
+
+    @pytest.mark.asyncio
+    async def test_error_releases_context(self):
+        """Test failing requests still release their context"""
+        manager = MiddlewareManager()
+        manager.add(_recorder('outer', []))
+
+        def handler(request):
+            raise RuntimeError("boom")
+
+        with pytest.raises(RuntimeError):
+            await manager.execute_http_chain(_Request(), handler)
+
+        assert manager.request_contexts == {}
+        # Handler failures are not blamed on the middleware
+        assert manager.get_middleware('outer').error_count == 0
+
+    @pytest.mark.asyncio
+    async def test_continue_on_error(self):
+        """Test a failing middleware can be skipped"""
+        manager = MiddlewareManager()
+
+        async def broken(request, call_next):
+            raise ValueError("broken")
+
+        manager.add(broken, config={'continue_on_error': True})
+
+        assert await manager.execute_http_chain(_Request(), lambda request: 'ok') == 'ok'
+        assert manager.get_middleware('broken').error_count == 1
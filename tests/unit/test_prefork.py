@@ -0,0 +1,223 @@
+"""
+Unit tests for Pyserv pre-fork supervisor
+"""
+import asyncio
+import gc
+import os
+import signal
+import socket
+import time
+
+import pytest
+
+from pyserv.routing.router import Router
+from pyserv.server.prefork import PreforkConfig, PreforkSupervisor, WorkerProcess, resident_memory, warm_up
+from pyserv.streaming.frames import next_id
+from pyserv.templating.engine import TemplateConfig, TemplateEngine
+
+pytestmark = pytest.mark.skipif(not hasattr(os, 'fork'), reason="pre-fork needs os.fork")
+
+
+async def pid_app(scope, receive, send):
+    """Answers every request with the serving worker's pid"""
+    await send({"type": "http.response.start", "status": 200, "headers": []})
+    await send({"type": "http.response.body", "body": str(os.getpid()).encode()})
+
+
+async def worker_id_app(scope, receive, send):
+    """Answers every request with the worker id in the serving worker's message ids"""
+    await send({"type": "http.response.start", "status": 200, "headers": []})
+    await send({"type": "http.response.body", "body": str((next_id() >> 12) & 0x3FF).encode()})
+
+
+async def tiny_serve(app, sockets, shutdown_trigger):
+    """Just enough HTTP/1.0 to drive an ASGI app over the supervisor's listeners"""
+    async def handle(reader, writer):
+        await reader.readuntil(b"\r\n\r\n")
+        chunks = []
+
+        async def receive():
+            return {"type": "http.request", "body": b"", "more_body": False}
+
+        async def send(message):
+            if message["type"] == "http.response.body":
+                chunks.append(message.get("body", b""))
+
+        await app({"type": "http", "method": "GET", "path": "/"}, receive, send)
+        body = b"".join(chunks)
+        writer.write(b"HTTP/1.0 200 OK\r\nContent-Length: %d\r\n\r\n%s" % (len(body), body))
+        await writer.drain()
+        writer.close()
+
+    servers = [await asyncio.start_server(handle, sock=sock) for sock in sockets]
+    await shutdown_trigger()
+    for server in servers:
+        server.close()
+
+
+def free_port():
+    with socket.socket() as sock:
+        sock.bind(("127.0.0.1", 0))
+        return sock.getsockname()[1]
+
+
+def request_pid(port):
+    with socket.create_connection(("127.0.0.1", port), timeout=2) as conn:
+        conn.sendall(b"GET / HTTP/1.0\r\n\r\n")
+        data = b""
+        while chunk := conn.recv(4096):
+            data += chunk
+    return int(data.split(b"\r\n\r\n", 1)[1])
+
+
+def fork_master(supervisor):
+    pid = os.fork()
+    if pid == 0:
+        try:
+            supervisor.run()
+        finally:
+            os._exit(0)
+    return pid
+
+
+def collect_pids(port, until, timeout=8.0):
+    """Request repeatedly until ``until(pids)`` holds"""
+    pids = set()
+    deadline = time.monotonic() + timeout
+    while not until(pids) and time.monotonic() < deadline:
+        try:
+            pids.add(request_pid(port))
+        except (OSError, ValueError):
+            pass
+        time.sleep(0.02)
+    return pids
+
+
+def stop_master(pid):
+    os.kill(pid, signal.SIGTERM)
+    deadline = time.monotonic() + 8.0
+    while time.monotonic() < deadline:
+        done, status = os.waitpid(pid, os.WNOHANG)
+        if done:
+            return os.waitstatus_to_exitcode(status)
+        time.sleep(0.02)
+    os.kill(pid, signal.SIGKILL)
+    os.waitpid(pid, 0)
+    raise AssertionError("master did not stop")
+
+
+def config(port, **overrides):
+    settings = dict(workers=2, host="127.0.0.1", port=port, ready_timeout=0.2, graceful_timeout=3.0,
+                    freeze_gc=False, preload_modules=[])
+    settings.update(overrides)
+    return PreforkConfig(**settings)
+
+
+class TestPrefork:
+    """Test the pre-fork master and its workers"""
+
+    @pytest.mark.skipif(not hasattr(socket, 'SO_REUSEPORT'), reason="needs SO_REUSEPORT")
+    def test_reuse_port_workers_recycle(self):
+        """Test per-worker listeners serve and workers are replaced after max_requests"""
+        port = free_port()
+        master = fork_master(PreforkSupervisor(pid_app, config(port, max_requests=3), serve=tiny_serve))
+        try:
+            # Two initial workers plus at least two successors
+            pids = collect_pids(port, lambda pids: len(pids) >= 4)
+        finally:
+            code = stop_master(master)
+        assert len(pids) >= 4 and master not in pids
+        assert code == 0
+
+    def test_shared_listener_rolling_reload(self):
+        """Test the shared-listener fallback and a SIGHUP rolling restart"""
+        port = free_port()
+        master = fork_master(PreforkSupervisor(pid_app, config(port, reuse_port=False), serve=tiny_serve))
+        try:
+            before = collect_pids(port, lambda pids: len(pids) >= 1)
+            os.kill(master, signal.SIGHUP)
+            after = collect_pids(port, lambda pids: bool(pids - before))
+        finally:
+            assert stop_master(master) == 0
+        assert before and after - before
+
+    def test_workers_get_distinct_message_id_workers(self):
+        """Test the supervisor gives each worker a slot-derived id for snowflake message ids"""
+        port = free_port()
+        master = fork_master(PreforkSupervisor(worker_id_app, config(port, reuse_port=False), serve=tiny_serve))
+        try:
+            worker_ids = collect_pids(port, lambda ids: len(ids) >= 2)
+        finally:
+            assert stop_master(master) == 0
+        # Slots 0 and 1 on their first fork
+        assert worker_ids == {1, 3}
+
+    def test_warm_up_compiles_and_freezes(self):
+        """Test warm-up compiles routes, preloads templates and freezes the heap"""
+        class Engine:
+            def preload(self):
+                return 3
+
+        class App:
+            router = Router()
+            template_engine = Engine()
+
+        App.router.add_route("/users/{id:int}", lambda request: None, ["GET"])
+        App.router.add_route("/users", lambda request: None, ["GET"])
+        try:
+            stats = warm_up(App(), preload_modules=["json"])
+            assert stats["routes"] == 2 and stats["templates"] == 3 and stats["modules"] == 1
+            assert gc.get_freeze_count() > 0 and App.router._compiled is not None
+        finally:
+            gc.unfreeze()
+
+    def test_warm_up_creates_and_preloads_template_engine(self, tmp_path):
+        """Test warm-up builds the app's engine before the fork and compiles its templates"""
+        (tmp_path / "pages").mkdir()
+        (tmp_path / "index.html").write_text("<h1>{title}</h1>")
+        (tmp_path / "pages" / "about.html").write_text("<p>{body}</p>")
+
+        class App:
+            template_engine = None
+
+            def setup_template_engine(self):
+                if self.template_engine is None:
+                    self.template_engine = TemplateEngine(TemplateConfig(template_dir=tmp_path))
+                return self.template_engine
+
+        app = App()
+        stats = warm_up(app, freeze=False)
+        assert stats["templates"] == 2
+        template = app.template_engine.from_file("index.html")
+        assert app.template_engine.from_file(tmp_path / "index.html") is template
+        assert template.render(title="Hi") == "<h1>Hi</h1>"
+
+    def test_failed_replacement_backs_off(self):
+        """Test a replacement that dies before serving is not re-forked at once"""
+        supervisor = PreforkSupervisor(pid_app, config(free_port()), serve=tiny_serve)
+        spawned = []
+        supervisor._spawn = lambda slot: spawned.append(slot) or WorkerProcess(slot, -1, -1)
+        pid = os.fork()
+        if pid == 0:
+            os._exit(1)
+        supervisor.slots[0] = WorkerProcess(0, -2, -1)
+        supervisor.workers[pid] = supervisor._replacing = WorkerProcess(0, pid, -1)
+        while supervisor.workers:
+            supervisor._reap()
+            time.sleep(0.01)
+        supervisor._advance_rolling()
+        assert spawned == [] and list(supervisor._recycle) == [0]
+        supervisor._rolling_at = 0.0
+        supervisor._advance_rolling()
+        assert spawned == [0]
+
+    def test_config_from_app_config(self):
+        """Test settings are taken from a config object by name"""
+        class AppConfig:
+            workers = 8
+            port = 9000
+            max_requests = 1000
+
+        prefork = PreforkConfig.from_config(AppConfig())
+        assert (prefork.workers, prefork.port, prefork.max_requests) == (8, 9000, 1000)
+        assert resident_memory() > 0
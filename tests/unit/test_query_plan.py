@@ -0,0 +1,119 @@
+"""
+Unit tests for Pyserv QueryBuilder plan cache
+"""
+import sqlite3
+
+from pyserv.database.query_plan import PlanCache, POSTGRESQL, MYSQL, SQLITE, query_shape
+from pyserv.models.base import OrderDirection
+
+
+def params(filters=None, limit=None, offset=None, order_by=None, **extra):
+    """Build QueryBuilder-style query parameters"""
+    query_params = {
+        'select_fields': [],
+        'distinct': False,
+        'filters': filters or {},
+        'limit': limit,
+        'offset': offset,
+        'order_by': order_by or [],
+        'group_by': [],
+        'having': [],
+        'having_params': [],
+        'table_name': 'users',
+    }
+    query_params.update(extra)
+    return query_params
+
+
+class TestQueryShape:
+    """Test plan-cache keys"""
+
+    def test_values_not_in_key(self):
+        """Test queries differing only in values share a shape"""
+        a = params({'age': {'$gt': 18}, 'name': 'ann'}, limit=10, offset=0)
+        b = params({'age': {'$gt': 65}, 'name': 'bob'}, limit=20, offset=40)
+        assert query_shape(a, SQLITE) == query_shape(b, SQLITE)
+
+    def test_shape_changes(self):
+        """Test operators, ordering and limit presence change the shape"""
+        base = query_shape(params({'age': 1}), SQLITE)
+        assert query_shape(params({'age': {'$gt': 1}}), SQLITE) != base
+        assert query_shape(params({'age': 1}, limit=5), SQLITE) != base
+        assert query_shape(params({'age': 1}, order_by=[('age', OrderDirection.DESC)]), SQLITE) != base
+
+    def test_in_lists(self):
+        """Test IN lists share a shape per power-of-two bucket, or always on PostgreSQL"""
+        three = params({'id': {'$in': [1, 2, 3]}})
+        four = params({'id': {'$in': [1, 2, 3, 4]}})
+        five = params({'id': {'$in': [1, 2, 3, 4, 5]}})
+        assert query_shape(three, SQLITE) == query_shape(four, SQLITE)
+        assert query_shape(four, SQLITE) != query_shape(five, SQLITE)
+        assert query_shape(three, POSTGRESQL) == query_shape(five, POSTGRESQL)
+
+
+class TestPlanCache:
+    """Test compiled plans and cache statistics"""
+
+    def test_compiled_sql(self):
+        """Test SQL text and bound parameters per dialect"""
+        query_params = params({'age': {'$gte': 18}, 'id': {'$in': [1, 2, 3]}, 'deleted_at': None},
+                              limit=10, offset=20, order_by=[('age', OrderDirection.DESC)])
+
+        plan, bound = PlanCache(POSTGRESQL).prepare(query_params)
+        assert plan.sql == ("SELECT * FROM users WHERE age >= $1 AND id = ANY($2) AND deleted_at IS NULL "
+                            "ORDER BY age DESC LIMIT $3 OFFSET $4")
+        assert bound == [18, [1, 2, 3], 10, 20]
+
+        plan, bound = PlanCache(MYSQL).prepare(query_params)
+        assert plan.sql == ("SELECT * FROM users WHERE age >= %s AND id IN (%s, %s, %s, %s) "
+                            "AND deleted_at IS NULL ORDER BY age DESC LIMIT %s OFFSET %s")
+        assert bound == [18, 1, 2, 3, 3, 10, 20]
+
+    def test_hit_rate(self):
+        """Test repeated shapes hit the cache and LRU eviction"""
+        cache = PlanCache(SQLITE, max_size=2)
+        for value in range(10):
+            cache.get(params({'age': value}, limit=value))
+        cache.get(params({'name': 'x'}))
+        cache.get(params({'email': 'x'}))
+
+        stats = cache.get_stats()
+        assert stats['hits'] == 9
+        assert stats['misses'] == 3
+        assert stats['evictions'] == 1
+        assert stats['plans'] == 2
+
+    def test_executes_on_sqlite(self):
+        """Test plans run against a real database"""
+        db = sqlite3.connect(':memory:')
+        db.execute("CREATE TABLE users (id INTEGER, name TEXT, age INTEGER)")
+        db.executemany("INSERT INTO users VALUES (?, ?, ?)", [(i, f"user{i}", 20 + i) for i in range(10)])
+        cache = PlanCache(SQLITE)
+
+        plan, bound = cache.prepare(params({'id': {'$in': [1, 5, 7]}}, order_by=[('id', 'DESC')]))
+        assert [row[0] for row in db.execute(plan.sql, bound)] == [7, 5, 1]
+
+        plan, bound = cache.prepare(params({'age': {'$lt': 25}, 'name': {'$regex': '.*user.*'}}, offset=3))
+        assert [row[0] for row in db.execute(plan.sql, bound)] == [3, 4]
+
+        plan, bound = cache.prepare(params({'id': {'$in': []}}))
+        assert db.execute(plan.sql, bound).fetchall() == []
+
+    def test_having_binds_before_limit(self):
+        """Test HAVING values precede LIMIT/OFFSET in SQL order on every dialect"""
+        query_params = params({'age': {'$gte': 20}}, limit=2, offset=1, order_by=[('name', 'ASC')],
+                              select_fields=['name', 'COUNT(*)'], group_by=['name'],
+                              having=["COUNT(*) >= ?", "name != '?'"], having_params=[2])
+
+        plan, bound = PlanCache(POSTGRESQL).prepare(query_params)
+        assert plan.sql == ("SELECT name, COUNT(*) FROM users WHERE age >= $1 GROUP BY name "
+                            "HAVING COUNT(*) >= $2 AND name != '?' ORDER BY name ASC LIMIT $3 OFFSET $4")
+        assert bound == [20, 2, 2, 1]
+
+        db = sqlite3.connect(':memory:')
+        db.execute("CREATE TABLE users (id INTEGER, name TEXT, age INTEGER)")
+        db.executemany("INSERT INTO users VALUES (?, ?, ?)",
+                       [(i, name, 20 + i) for i, name in enumerate("aabbbcdddde")])
+        plan, bound = PlanCache(SQLITE).prepare(query_params)
+        assert bound == [20, 2, 2, 1]
+        assert db.execute(plan.sql, bound).fetchall() == [('b', 3), ('d', 4)]
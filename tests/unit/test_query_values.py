@@ -0,0 +1,104 @@
+"""
+Unit tests for Pyserv QueryBuilder lightweight hydration
+"""
+import pytest
+
+from pyserv.database.connections.sqlite_connection import SQLiteConnection
+from pyserv.models.query import QueryBuilder
+
+
+class Config:
+    database = ":memory:"
+
+
+async def make_db():
+    """In-memory SQLite backend with 25 rows"""
+    connection = SQLiteConnection(Config())
+    await connection.connect()
+    connection.connection.execute("CREATE TABLE items (id INTEGER, name TEXT, price REAL)")
+    connection.connection.executemany(
+        "INSERT INTO items VALUES (?, ?, ?)", [(i, f"item{i}", i * 1.5) for i in range(25)]
+    )
+    return connection
+
+
+def make_model(connection):
+    """Model class whose construction is counted"""
+    class Item:
+        created = 0
+
+        def __init__(self, **fields):
+            Item.created += 1
+            self.__dict__.update(fields)
+
+        @staticmethod
+        def get_db_connection():
+            return connection
+
+        @staticmethod
+        def get_table_name():
+            return "items"
+
+    return Item
+
+
+class TestQueryValues:
+    """Test values, values_list and batched iteration"""
+
+    @pytest.mark.asyncio
+    async def test_values_and_values_list(self):
+        """Test rows come back as dicts or tuples without model construction"""
+        db = await make_db()
+        Item = make_model(db)
+        query = QueryBuilder(Item).filter(id__lt=3)
+
+        assert await query.copy().values("id", "name") == [
+            {"id": 0, "name": "item0"}, {"id": 1, "name": "item1"}, {"id": 2, "name": "item2"}
+        ]
+        assert await query.copy().values_list("id", "price") == [(0, 0.0), (1, 1.5), (2, 3.0)]
+        assert await query.copy().values_list("name", flat=True) == ["item0", "item1", "item2"]
+        assert Item.created == 0
+
+        with pytest.raises(ValueError):
+            await query.values_list("id", "name", flat=True)
+
+    @pytest.mark.asyncio
+    async def test_values_skip_the_cursor(self):
+        """Test fully materialised results use a plain fetch and only streaming opens a cursor"""
+        db = await make_db()
+        Item = make_model(db)
+        cursors = []
+        iter_query_builder = db.iter_query_builder
+
+        def counting(*args):
+            cursors.append(args)
+            return iter_query_builder(*args)
+
+        db.iter_query_builder = counting
+        assert len(await QueryBuilder(Item).values()) == 25
+        assert await QueryBuilder(Item).filter(id=4).values_list("name", flat=True) == ["item4"]
+        assert cursors == []
+        assert len([rows async for rows in QueryBuilder(Item).iter_batches(10)]) == 3
+        assert len(cursors) == 1
+
+    @pytest.mark.asyncio
+    async def test_iter_batches(self):
+        """Test batches of tuples and of column arrays"""
+        db = await make_db()
+        Item = make_model(db)
+        batches = [rows async for rows in QueryBuilder(Item).iter_batches(10)]
+        assert [len(rows) for rows in batches] == [10, 10, 5]
+        assert batches[0][0] == (0, "item0", 0.0)
+
+        columns = [batch async for batch in QueryBuilder(Item).filter(id__gte=20).iter_batches(3, columnar=True)]
+        assert columns[0] == {"id": [20, 21, 22], "name": ["item20", "item21", "item22"], "price": [30.0, 31.5, 33.0]}
+        assert columns[1]["id"] == [23, 24]
+
+    @pytest.mark.asyncio
+    async def test_stream_models(self):
+        """Test streaming builds models one batch at a time"""
+        db = await make_db()
+        Item = make_model(db)
+        names = [item.name async for item in QueryBuilder(Item).filter(id__in=[3, 4]).stream(batch_size=1)]
+        assert names == ["item3", "item4"]
+        assert Item.created == 2
@@ -0,0 +1,155 @@
+"""
+Unit tests for Pyserv Raft transport and replication
+"""
+import asyncio
+import time
+
+import pytest
+
+from pyserv.microservices.consensus import (
+    AppendEntriesRequest, AppendEntriesResponse, InMemoryStorage, LogEntry, LogEntryType,
+    NetworkTransport, NodeRole, RaftNode, RequestVoteRequest, RequestVoteResponse,
+)
+
+
+def entry(index, term=1, command=None):
+    return LogEntry(term=term, index=index, entry_type=LogEntryType.COMMAND,
+                    command=command or {"key": f"k{index}", "value": index}, client_id="c")
+
+
+async def start_cluster(size):
+    """Start ``size`` nodes on localhost and wait for a leader"""
+    ids = [f"n{i}" for i in range(size)]
+    transports = {node_id: NetworkTransport(node_id, '127.0.0.1', 0) for node_id in ids}
+    for transport in transports.values():
+        await transport.initialize()
+    for transport in transports.values():
+        for node_id, other in transports.items():
+            transport.add_node(node_id, '127.0.0.1', other.port)
+
+    nodes = [RaftNode(node_id, ids, transports[node_id], InMemoryStorage(node_id)) for node_id in ids]
+    tasks = [asyncio.create_task(node.start()) for node in nodes]
+    deadline = time.monotonic() + 5
+    while time.monotonic() < deadline:
+        leaders = [node for node in nodes if node.role == NodeRole.LEADER]
+        if len(leaders) == 1:
+            return nodes, tasks, leaders[0]
+        await asyncio.sleep(0.02)
+    raise AssertionError("no leader elected")
+
+
+async def stop_cluster(nodes, tasks):
+    for node in nodes:
+        await node.stop()
+    for task in tasks:
+        task.cancel()
+    await asyncio.gather(*tasks, return_exceptions=True)
+
+
+class TestWireFormat:
+    """Test binary RPC encoding"""
+
+    def test_round_trip(self):
+        """Test requests and responses survive encoding"""
+        request = AppendEntriesRequest(term=3, leader_id="n1", prev_log_index=7, prev_log_term=2,
+                                       entries=[entry(8, 3), entry(9, 3, {"nested": [1, None]})],
+                                       leader_commit=6)
+        decoded = AppendEntriesRequest.from_bytes(request.to_bytes(), "r1")
+        assert decoded.request_id == "r1" and decoded.leader_id == "n1"
+        assert (decoded.term, decoded.prev_log_index, decoded.prev_log_term, decoded.leader_commit) == (3, 7, 2, 6)
+        assert [e.to_dict() for e in decoded.entries] == [e.to_dict() for e in request.entries]
+
+        response = AppendEntriesResponse.from_bytes(
+            AppendEntriesResponse(term=3, request_id="", success=False, match_index=4,
+                                  error_message="x").to_bytes(), "r1")
+        assert (response.success, response.match_index, response.error_message) == (False, 4, "x")
+
+        vote = RequestVoteRequest.from_bytes(
+            RequestVoteRequest(term=5, candidate_id="n2", last_log_index=9, last_log_term=4).to_bytes())
+        assert (vote.term, vote.candidate_id, vote.last_log_index, vote.last_log_term) == (5, "n2", 9, 4)
+        granted = RequestVoteResponse.from_bytes(
+            RequestVoteResponse(term=5, request_id="", vote_granted=True).to_bytes())
+        assert granted.vote_granted and granted.success
+
+
+class TestTransport:
+    """Test persistent, multiplexed connections"""
+
+    @pytest.mark.asyncio
+    async def test_pipelined_calls_share_a_connection(self):
+        """Test concurrent RPCs reuse one connection and get their own replies"""
+        server, client = NetworkTransport("s", '127.0.0.1', 0), NetworkTransport("c", '127.0.0.1', 0)
+        await server.initialize()
+        seen = []
+
+        async def handler(request):
+            seen.append(request.prev_log_index)
+            return AppendEntriesResponse(term=request.term, request_id=request.request_id,
+                                         match_index=request.prev_log_index)
+
+        server.register_message_handler('append_entries', handler)
+        client.add_node("s", '127.0.0.1', server.port)
+        requests = [AppendEntriesRequest(term=1, prev_log_index=i) for i in range(20)]
+        responses = await asyncio.gather(*(client.send_append_entries("s", r) for r in requests))
+        assert [r.match_index for r in responses] == list(range(20))
+        assert [r.request_id for r in responses] == [r.request_id for r in requests]
+        assert seen == list(range(20)) and len(server._server_connections) == 1
+        client.shutdown()
+        server.shutdown()
+
+
+class TestReplication:
+    """Test pipelined log replication"""
+
+    @pytest.mark.asyncio
+    async def test_commits_replicate_to_followers(self):
+        """Test committed writes reach every node's state machine"""
+        nodes, tasks, leader = await start_cluster(3)
+        try:
+            results = await asyncio.gather(*(
+                leader.append_entry({"key": f"k{i}", "value": i}, wait_for_commit=True) for i in range(100)))
+            assert all(results) and leader.commit_index == 100
+            await asyncio.sleep(leader.heartbeat_interval * 3)
+            for node in nodes:
+                assert len(node.log) == 100
+                assert node.state_machine["k99"] == 99
+        finally:
+            await stop_cluster(nodes, tasks)
+
+    @pytest.mark.asyncio
+    async def test_divergent_follower_hint(self):
+        """Test a rejected AppendEntries tells the leader where to resume"""
+        node = RaftNode("f", ["f", "l"], NetworkTransport("f"), InMemoryStorage("f"))
+        node.log = [entry(1), entry(2)]
+        response = await node._process_append_entries(
+            AppendEntriesRequest(term=1, leader_id="l", prev_log_index=10, prev_log_term=1))
+        assert not response.success and response.match_index == 2
+
+        response = await node._process_append_entries(
+            AppendEntriesRequest(term=1, leader_id="l", prev_log_index=2, prev_log_term=1,
+                                 entries=[entry(3)], leader_commit=3))
+        assert response.success and response.match_index == 3
+        assert node.commit_index == 3 and node.state_machine["k3"] == 3
+
+    @pytest.mark.asyncio
+    async def test_overlapping_append_entries_reconciled(self):
+        """Test overlapping and duplicate AppendEntries keep the log consistent"""
+        node = RaftNode("f", ["f", "l"], NetworkTransport("f"), InMemoryStorage("f"))
+
+        async def append(prev, entries, leader_commit=0):
+            return await node._process_append_entries(AppendEntriesRequest(
+                term=2, leader_id="l", prev_log_index=prev, prev_log_term=prev and node.log[prev - 1].term,
+                entries=entries, leader_commit=leader_commit))
+
+        assert (await append(0, [entry(1), entry(2), entry(3)])).match_index == 3
+        response = await append(1, [entry(2), entry(3), entry(4)])
+        assert response.success and response.match_index == 4
+        assert [e.index for e in node.log] == [1, 2, 3, 4]
+
+        response = await append(1, [entry(2)])
+        assert response.match_index == 2 and len(node.log) == 4
+
+        response = await append(2, [entry(3, term=2)], leader_commit=4)
+        assert [(e.index, e.term) for e in node.log] == [(1, 1), (2, 1), (3, 2)]
+        assert response.match_index == 3 and node.commit_index == 3
+        assert [e.index for e in await node.storage.get_log_entries()] == [1, 2, 3]
@@ -0,0 +1,220 @@
+"""
+Unit tests for Pyserv rate limit engine
+"""
+import sys
+import threading
+
+import pytest
+
+from pyserv.security.rate_limiter import RateLimiter, RateLimitRule, RateLimitStrategy
+from pyserv.utils.rate_limiting import (
+    InMemoryRateLimitBackend, RateLimitAlgorithm, RateLimitConfig, RateLimitEngine,
+    RateLimitPolicy, RateLimitTable,
+)
+
+
+def allowed(engine, policy, key, times):
+    """Timestamps in ``times`` that were allowed"""
+    return [t for t in times if engine.check(policy, key, now=t).allowed]
+
+
+class TestAlgorithms:
+    """Test each algorithm's decisions"""
+
+    def test_gcra_burst_and_spacing(self):
+        """Test a full burst, then one request per emission interval"""
+        engine = RateLimitEngine()
+        policy = RateLimitPolicy(10, 10.0, RateLimitAlgorithm.GCRA, burst=3)
+        results = [engine.check(policy, "ip", now=100.0) for _ in range(4)]
+        assert [r.allowed for r in results] == [True, True, True, False]
+        assert [r.remaining for r in results[:3]] == [2, 1, 0]
+        assert results[3].retry_after == pytest.approx(1.0)
+        assert not engine.check(policy, "ip", now=100.5).allowed
+        assert engine.check(policy, "ip", now=101.0).allowed
+        assert engine.check(policy, "other", now=100.0).allowed
+
+    def test_sliding_window_weights_previous(self):
+        """Test the previous window's count decays across the current one"""
+        engine = RateLimitEngine()
+        policy = RateLimitPolicy(10, 60.0, RateLimitAlgorithm.SLIDING_WINDOW)
+        assert len(allowed(engine, policy, "k", [59.0] * 12)) == 10
+        # 25% into the next window: 10 * 0.75 = 7.5 carried over, so 2 more fit
+        assert len(allowed(engine, policy, "k", [75.0] * 5)) == 2
+        # Two windows later nothing carries over
+        assert len(allowed(engine, policy, "k", [180.0] * 12)) == 10
+
+    def test_fixed_window_resets(self):
+        """Test counts reset at window boundaries"""
+        engine = RateLimitEngine()
+        policy = RateLimitPolicy(3, 10.0, RateLimitAlgorithm.FIXED_WINDOW)
+        assert len(allowed(engine, policy, "k", [1.0] * 5)) == 3
+        result = engine.check(policy, "k", now=9.0)
+        assert not result.allowed and result.retry_after == pytest.approx(1.0)
+        assert len(allowed(engine, policy, "k", [10.0] * 5)) == 3
+
+    def test_sliding_log_is_exact(self):
+        """Test no period-long span ever admits more than the limit"""
+        engine = RateLimitEngine()
+        policy = RateLimitPolicy(3, 10.0, RateLimitAlgorithm.SLIDING_LOG)
+        times = [0.0, 1.0, 9.0, 9.5, 10.0, 10.5, 11.0, 19.5]
+        assert allowed(engine, policy, "k", times) == [0.0, 1.0, 9.0, 10.0, 11.0, 19.5]
+        result = engine.check(policy, "k", now=19.8)
+        assert not result.allowed and result.retry_after == pytest.approx(0.2)
+
+
+class TestTable:
+    """Test the fixed-memory table"""
+
+    def test_memory_stays_fixed(self):
+        """Test many distinct keys evict instead of growing the table"""
+        table = RateLimitTable(slots=1024, shards=4, probe=4)
+        engine = RateLimitEngine(table=table)
+        policy = RateLimitPolicy(5, 60.0)
+        for n in range(20000):
+            engine.check(policy, f"10.0.{n // 256}.{n % 256}", now=1.0)
+        stats = table.get_stats()
+        assert stats['slots'] == 1024 and stats['evictions'] > 0
+
+        # Once everything has expired the slots are reused in place, without a sweep
+        evictions = stats['evictions']
+        for n in range(32):
+            engine.check(policy, f"late-{n}", now=1000.0)
+        assert table.get_stats()['evictions'] == evictions
+
+    def test_policies_do_not_share_state(self):
+        """Test the same key under two policies is counted separately and can be reset"""
+        engine = RateLimitEngine()
+        strict, loose = RateLimitPolicy(1, 60.0), RateLimitPolicy(100, 60.0)
+        assert engine.check(strict, "k", now=1.0).allowed
+        assert not engine.check(strict, "k", now=1.0).allowed
+        assert engine.check(loose, "k", now=1.0).allowed
+        assert engine.reset(strict, "k", now=1.0)
+        assert engine.check(strict, "k", now=1.0).allowed
+
+    def test_reads_do_not_claim_slots(self):
+        """Test peek, reset and zero-cost checks of unknown keys leave live keys alone"""
+        table = RateLimitTable(slots=8, shards=1, probe=8)
+        engine = RateLimitEngine(table=table)
+        policy = RateLimitPolicy(5, 60.0, RateLimitAlgorithm.FIXED_WINDOW)
+        for n in range(8):
+            engine.check(policy, f"live-{n}", now=1.0)
+        for n in range(16):
+            assert engine.peek(policy, f"ghost-{n}", now=1.0) == {}
+            assert not engine.reset(policy, f"ghost-{n}", now=1.0)
+            assert engine.check(policy, f"ghost-{n}", cost=0, now=1.0).remaining == 5
+        assert table.get_stats()['evictions'] == 0
+        assert all(engine.peek(policy, f"live-{n}", now=1.0)['state'][1] == 1 for n in range(8))
+        assert engine.check(policy, "live-0", cost=0, now=1.0).remaining == 4
+
+    def test_sliding_log_fits_log_memory(self):
+        """Test the sliding-log table never outgrows log_memory and rejects budgets too small"""
+        policy = RateLimitPolicy(100, 60.0, RateLimitAlgorithm.SLIDING_LOG)
+        engine = RateLimitEngine(log_memory=64 * 1024)
+        assert engine.check(policy, "k", now=1.0).allowed
+        table = policy._log_table
+        assert table.slots * (16 + 8 * table.width) <= 64 * 1024
+        with pytest.raises(ValueError):
+            RateLimitEngine(log_memory=4096).check(RateLimitPolicy(100, 60.0, RateLimitAlgorithm.SLIDING_LOG), "k")
+
+    def test_thread_safe_counts_every_request(self):
+        """Test concurrent checks of new and existing keys lose no updates"""
+        previous = sys.getswitchinterval()
+        sys.setswitchinterval(1e-6)
+        try:
+            engine = RateLimitEngine(thread_safe=True)
+            policy = RateLimitPolicy(10 ** 6, 60.0, RateLimitAlgorithm.FIXED_WINDOW)
+            keys = [f"k{n}" for n in range(50)]
+
+            def worker():
+                for _ in range(20):
+                    for key in keys:
+                        engine.check(policy, key, now=1.0)
+
+            threads = [threading.Thread(target=worker) for _ in range(8)]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+        finally:
+            sys.setswitchinterval(previous)
+        assert [engine.peek(policy, key, now=1.0)['state'][1] for key in keys] == [160.0] * 50
+
+
+class TestLimiters:
+    """Test the rule-based limiter and the backend share the engine"""
+
+    @pytest.mark.asyncio
+    async def test_rule_limiter(self):
+        """Test rules, burst caps and unknown rules"""
+        limiter = RateLimiter(engine=RateLimitEngine())
+        limiter.add_rule(RateLimitRule("login", 5, 60, RateLimitStrategy.SLIDING_WINDOW, burst_limit=2))
+        results = [await limiter.check_rate_limit("login", "1.2.3.4") for _ in range(3)]
+        assert [ok for ok, _ in results] == [True, True, False]
+        assert results[2][1]["error"] == "Rate limit exceeded"
+        assert await limiter.check_rate_limit("missing", "x") == (True, {"error": "Rule not found"})
+
+    @pytest.mark.asyncio
+    async def test_backend_token_bucket(self):
+        """Test RateLimitConfig token buckets map onto GCRA"""
+        backend = InMemoryRateLimitBackend(RateLimitEngine())
+        config = RateLimitConfig(capacity=2, refill_rate=1.0)
+        results = [await backend.check_limit("k", config) for _ in range(3)]
+        assert [r.allowed for r in results] == [True, True, False]
+        assert results[2].limit == 2 and 0 < results[2].retry_after <= 1.0
+        assert await backend.reset_limit("k")
+        assert (await backend.check_limit("k", config)).allowed
+
+    @pytest.mark.asyncio
+    async def test_backend_reset_by_config(self):
+        """Test reset and stats address the given config, or every config without one"""
+        backend = InMemoryRateLimitBackend(RateLimitEngine())
+        strict = RateLimitConfig(algorithm=RateLimitAlgorithm.FIXED_WINDOW, capacity=1)
+        loose = RateLimitConfig(algorithm=RateLimitAlgorithm.FIXED_WINDOW, capacity=5)
+        for config in (strict, loose, strict):
+            await backend.check_limit("k", config)
+        assert backend.get_stats("k", loose)['state'][1] == 1
+        assert await backend.reset_limit("k", strict)
+        assert backend.get_stats("k", strict) == {} and backend.get_stats("k", loose)
+        assert (await backend.check_limit("k", strict)).allowed
+        assert await backend.reset_limit("k")
+        assert backend.get_stats("k") == {}
+
+    @pytest.mark.asyncio
+    async def test_redis_keys_per_policy(self):
+        """Test each policy gets its own Redis key, and reset deletes the key the script wrote"""
+        from pyserv.utils.rate_limiting import RedisRateLimitBackend
+
+        class Client:
+            def __init__(self):
+                self.written, self.deleted = [], []
+
+            def register_script(self, source):
+                async def script(keys, args):
+                    self.written.extend(keys)
+                    return [1, 0, "1", "0"]
+                return script
+
+            async def delete(self, *keys):
+                self.deleted.extend(keys)
+                return len(keys)
+
+        client = Client()
+        backend = RedisRateLimitBackend(client)
+        strict = RateLimitConfig(algorithm=RateLimitAlgorithm.SLIDING_WINDOW, capacity=1)
+        loose = RateLimitConfig(algorithm=RateLimitAlgorithm.SLIDING_WINDOW, capacity=5)
+        await backend.check_limit("k", strict)
+        await backend.check_limit("k", loose)
+        assert len(set(client.written)) == 2
+        assert await backend.reset_limit("k", strict)
+        assert client.deleted == client.written[:1]
+        assert await backend.reset_limit("k")
+        assert client.deleted[1:] == client.written
+
+    def test_security_middleware_limiter(self):
+        """Test the security middleware's limiter reads remaining without consuming"""
+        from pyserv.security.middleware import RateLimiter as MiddlewareRateLimiter
+
+        limiter = MiddlewareRateLimiter(3, 60, engine=RateLimitEngine())
+        assert [limiter.is_allowed("a") for _ in range(4)] == [True, True, True, False]
+        assert limiter.get_remaining_requests("a") == 0
+        assert limiter.get_remaining_requests("b") == 3 and limiter.is_allowed("b")
@@ -0,0 +1,103 @@
+"""
+Unit tests for Pyserv streaming request bodies
+"""
+import pytest
+
+from pyserv.exceptions import BadRequest, PayloadTooLarge
+from pyserv.http.multipart import MultipartParser, UploadFile, PART_BEGIN, PART_DATA, PART_END
+from pyserv.http.request import Request
+
+
+def make_request(chunks, content_type="application/json", content_length=True):
+    """Build a request whose body arrives as the given chunks"""
+    messages = [
+        {"type": "http.request", "body": chunk, "more_body": index < len(chunks) - 1}
+        for index, chunk in enumerate(chunks)
+    ]
+
+    async def receive():
+        return messages.pop(0)
+
+    headers = [(b"content-type", content_type.encode())]
+    if content_length:
+        headers.append((b"content-length", str(sum(map(len, chunks))).encode()))
+    scope = {"type": "http", "method": "POST", "path": "/upload", "headers": headers}
+    return Request(scope, receive, None, None)
+
+
+class TestRequestBody:
+    """Test buffered and streamed request bodies"""
+
+    @pytest.mark.asyncio
+    async def test_body_from_chunks(self):
+        """Test chunks are joined into one body"""
+        request = make_request([b"ab", b"cd", b"ef"])
+        assert await request.body() == b"abcdef"
+        assert await request.body() == b"abcdef"
+
+    @pytest.mark.asyncio
+    async def test_body_limit(self):
+        """Test max_body_size is enforced with and without Content-Length"""
+        for content_length in (True, False):
+            request = make_request([b"x" * 10] * 3, content_length=content_length)
+            request.max_body_size = 25
+            with pytest.raises(PayloadTooLarge):
+                await request.body()
+
+    @pytest.mark.asyncio
+    async def test_json_items(self):
+        """Test array items are decoded across chunk boundaries"""
+        request = make_request([b'[1, 2', b'.5, {"a": [', b'true]}, "x', b'y"]'])
+        items = [item async for item in request.json_items()]
+        assert items == [1, 2.5, {"a": [True]}, "xy"]
+
+    @pytest.mark.asyncio
+    async def test_json_items_invalid(self):
+        """Test malformed arrays are rejected"""
+        for body in (b'{"a": 1}', b'[1,]', b'[1 2]', b'[1'):
+            request = make_request([body])
+            with pytest.raises(BadRequest):
+                [item async for item in request.json_items()]
+
+    @pytest.mark.asyncio
+    async def test_multipart_form(self):
+        """Test fields and spooled file parts"""
+        body = (
+            b'--XyZ\r\nContent-Disposition: form-data; name="title"\r\n\r\nhello\r\n'
+            b'--XyZ\r\nContent-Disposition: form-data; name="doc"; filename="a.txt"\r\n'
+            b'Content-Type: text/plain\r\n\r\n' + b"z" * 5000 + b'\r\n--XyZ--\r\n'
+        )
+        chunks = [body[i:i + 7] for i in range(0, len(body), 7)]
+        request = make_request(chunks, content_type="multipart/form-data; boundary=XyZ")
+        request.SPOOL_MAX_SIZE = 1024
+
+        form = await request.form()
+        assert form["title"] == "hello"
+        upload = form["doc"]
+        assert isinstance(upload, UploadFile)
+        assert upload.filename == "a.txt"
+        assert not upload.in_memory
+        assert await upload.read() == b"z" * 5000
+        await upload.close()
+
+
+class TestMultipartParser:
+    """Test the incremental multipart parser"""
+
+    def test_events(self):
+        """Test a delimiter split across feeds is not emitted as data"""
+        parser = MultipartParser("b")
+        events = parser.feed(b'--b\r\nContent-Disposition: form-data; name="a"\r\n\r\nval\r\n-')
+        events += parser.feed(b'-b--\r\n')
+        parser.close()
+
+        assert events[0] == (PART_BEGIN, {"content-disposition": 'form-data; name="a"'})
+        assert b"".join(data for kind, data in events if kind == PART_DATA) == b"val"
+        assert events[-1] == (PART_END, None)
+
+    def test_truncated(self):
+        """Test a body without the closing boundary is rejected"""
+        parser = MultipartParser("b")
+        parser.feed(b'--b\r\n\r\npartial')
+        with pytest.raises(BadRequest):
+            parser.close()
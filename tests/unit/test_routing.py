@@ -175,3 +175,98 @@ class TestRouter:
         route, params = router.find_route('/nonexistent', 'GET')
         assert route is None
         assert params is None
+
+
+class TestRadixMatching:
+    """Test radix-tree route matching"""
+
+    def _both(self, router, method, path):
+        """Match with the radix tree and the regex scan"""
+        router.clear_cache()
+        radix = router.match(method, path)
+        router._radix_enabled = False
+        router.clear_cache()
+        regex = router.match(method, path)
+        router._radix_enabled = True
+        return radix, regex
+
+    def test_typed_params_converted(self):
+        """Test {id:int} converters apply and reject bad values"""
+        router = Router()
+        router.add_route('/users/{id:int}', lambda r: None, ['GET'])
+        router.add_route('/users/{name}', lambda r: None, ['GET'])
+
+        match = router.match('GET', '/users/42')
+        assert match.params == {'id': 42}
+        match = router.match('GET', '/users/alice')
+        assert match.route.path == '/users/{name}'
+        assert match.params == {'name': 'alice'}
+
+    def test_priority_wins_over_registration_order(self):
+        """Test higher priority routes are matched first"""
+        router = Router()
+        router.add_route('/items/{slug}', lambda r: None, ['GET'])
+        router.add_route('/items/featured', lambda r: None, ['GET'], priority=10)
+
+        assert router.match('GET', '/items/featured').route.path == '/items/featured'
+        assert router.match('GET', '/items/other').route.path == '/items/{slug}'
+
+    def test_wildcard_and_regex_fallback(self):
+        """Test trailing wildcards and non-segment patterns"""
+        router = Router()
+        router.add_route('/static/*', lambda r: None, ['GET'])
+        router.add_route('/files/{name}.txt', lambda r: None, ['GET'])
+
+        assert router.match('GET', '/static/css/app.css').route.path == '/static/*'
+        assert router.match('GET', '/static') is None
+        assert router.match('GET', '/files/notes.txt').params == {'name': 'notes'}
+
+    def test_matches_regex_scan(self):
+        """Test radix results agree with the regex scan"""
+        router = Router()
+        for path in ['/', '/a', '/a/{x}', '/a/{x:int}/b', '/a/*', '/{x}/b', '/a/b', '/v/{f:float}']:
+            router.add_route(path, lambda r: None, ['GET'])
+
+        for path in ['/', '/a', '/a/1', '/a/1/b', '/a/q/b', '/a/b', '/z/b', '/v/1.5', '/v/x', '/a/']:
+            radix, regex = self._both(router, 'GET', path)
+            assert (radix and (radix.route, radix.params)) == (regex and (regex.route, regex.params))
+
+    def test_stats_report_matcher(self):
+        """Test get_stats reports the matcher backend"""
+        router = Router()
+        router.add_route('/test', lambda r: None, ['GET'])
+        assert router.get_stats()['matcher'] in ('native', 'python')
+
+
+class TestRouteCache:
+    """Test bounded route-match cache"""
+
+    def test_clock_eviction_keeps_hot_entries(self):
+        """Test referenced entries survive eviction"""
+        from pyserv.routing.cache import RouteCache
+
+        cache = RouteCache(capacity=2)
+        cache.put('hot', 1)
+        cache.put('cold', 2)
+        assert cache.get('hot') == 1
+        cache.put('new', 3)
+
+        assert 'hot' in cache
+        assert 'cold' not in cache
+        assert cache.get_stats()['evictions'] == 1
+
+    def test_router_caches_only_static_routes(self):
+        """Test parameterised and unmatched URLs don't grow the cache"""
+        router = Router(cache_size=8)
+        router.add_route('/health', lambda r: None, ['GET'])
+        router.add_route('/users/{id:int}', lambda r: None, ['GET'])
+
+        for user_id in range(100):
+            assert router.match('GET', f'/users/{user_id}').params == {'id': user_id}
+            assert router.match('GET', f'/scan/{user_id}') is None
+        router.match('GET', '/health')
+        router.match('GET', '/health')
+
+        stats = router.get_stats()['cache']
+        assert stats['size'] == 1
+        assert stats['hits'] == 1
@@ -0,0 +1,139 @@
+"""
+Unit tests for Pyserv sampling profiler
+"""
+import asyncio
+import gzip
+import threading
+from types import SimpleNamespace
+
+import pytest
+
+from pyserv.middleware.manager import MiddlewareManager
+from pyserv.performance.sampling import SamplingProfiler
+
+
+def spin(arrived, release):
+    """Burn CPU until the test has sampled this point"""
+    arrived.set()
+    while not release.is_set():
+        pass
+
+
+class Gate:
+    """A point in the request the test samples at"""
+
+    def __init__(self):
+        self.arrived, self.release = threading.Event(), threading.Event()
+
+    def pass_through(self):
+        spin(self.arrived, self.release)
+
+
+in_middleware, in_handler = Gate(), Gate()
+
+
+class AuthMiddleware:
+    async def __call__(self, request, call_next):
+        in_middleware.pass_through()
+        return await call_next(request)
+
+
+def list_users(request):
+    in_handler.pass_through()
+    return "ok"
+
+
+class Application:
+    """Stand-in with the same shape as pyserv.server.Application.handle_http"""
+
+    def __init__(self, manager):
+        self.manager = manager
+
+    async def handle_http(self, request):
+        async def final_handler(req):
+            return list_users(req)
+
+        return await self.manager.execute_http_chain(request, final_handler)
+
+
+class TestSamplingProfiler:
+    """Test sampling, attribution and export"""
+
+    def test_attributes_route_and_middleware(self):
+        """Test samples are tagged with the running middleware, then the route"""
+        manager = MiddlewareManager()
+        manager.add(AuthMiddleware)
+        router = SimpleNamespace(routes=[SimpleNamespace(path="/users", methods={"GET"}, handler=list_users)])
+        profiler = SamplingProfiler(router=router)
+        request = SimpleNamespace(method="GET", path="/users")
+        worker = threading.Thread(target=lambda: asyncio.run(Application(manager).handle_http(request)))
+        worker.start()
+
+        for gate in (in_middleware, in_handler):
+            assert gate.arrived.wait(5)
+            profiler.sample(exclude=threading.get_ident())
+            gate.release.set()
+        worker.join(5)
+
+        profile = profiler.snapshot()
+        assert profile.by_middleware() == {"AuthMiddleware": 1}
+        # Middleware runs before routing, so only the handler sample has a route
+        assert profile.by_route() == {"": 1, "GET /users": 1}
+        for _route, _middleware, names, _count in profile.stacks():
+            assert "spin" in [name.split(" ")[0] for name in names]
+
+    def test_background_thread_is_bounded(self):
+        """Test the sampler runs, counts idle threads and caps distinct stacks"""
+        profiler = SamplingProfiler(interval=0.001, max_stacks=1)
+        stop = threading.Event()
+        waiter = threading.Thread(target=stop.wait)
+        waiter.start()
+        profiler.start()
+        deadline = threading.Event()
+        deadline.wait(0.2)
+        profiler.stop()
+        stop.set()
+        waiter.join()
+
+        stats = profiler.get_stats()
+        assert not stats["running"] and stats["stacks"] <= 1
+        assert stats["idle_samples"] > 0
+        assert 0 < profiler.overhead() < 1
+
+    def test_exports(self):
+        """Test collapsed stacks, pprof and windowed snapshots"""
+        profiler = SamplingProfiler()
+        profiler.sample()
+        first = profiler.snapshot()
+        profiler.sample()
+        window = profiler.snapshot().since(first)
+        assert window.total_samples == first.total_samples > 0
+
+        lines = first.collapsed().splitlines()
+        assert lines and all(line.rsplit(" ", 1)[1].isdigit() for line in lines)
+        assert "test_exports" in first.collapsed()
+
+        pprof = gzip.decompress(first.to_pprof())
+        assert b"samples" in pprof and b"test_exports" in pprof
+
+        profiler.reset()
+        assert profiler.snapshot().total_samples == 0
+
+    @pytest.mark.asyncio
+    async def test_capture_survives_reset(self):
+        """Test a timed capture keeps its own counts when the window is reset meanwhile"""
+        profiler = SamplingProfiler()
+        for _ in range(3):
+            profiler.sample()
+
+        async def export_tick():
+            await asyncio.sleep(0)
+            profiler.sample()
+            profiler.reset()
+            profiler.sample()
+
+        captured, _ = await asyncio.gather(profiler.capture(0.05), export_tick())
+        after_reset = profiler.snapshot()
+        rounds = after_reset.total_samples + after_reset.idle_samples
+        assert captured.total_samples + captured.idle_samples == 2 * rounds > 0
+        assert len(profiler._windows) == 1
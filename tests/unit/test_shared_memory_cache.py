@@ -0,0 +1,77 @@
+"""
+Unit tests for Pyserv Shared Memory Cache
+"""
+import multiprocessing
+
+import pytest
+
+fcntl = pytest.importorskip("fcntl")
+
+from pyserv.caching.shared_memory_cache import SharedMemoryCache
+
+
+def _write_from_child(path):
+    cache = SharedMemoryCache(path=path, buckets=8, ways=4, slot_size=256)
+    cache.set_sync('child', {'pid': 'other'})
+
+
+class TestSharedMemoryCache:
+    """Test the cross-process shared-memory cache"""
+
+    def _cache(self, tmp_path):
+        return SharedMemoryCache(path=str(tmp_path / 'shm.cache'), buckets=8, ways=4, slot_size=256)
+
+    def test_round_trip_types(self, tmp_path):
+        """Test bytes, str and pickled values"""
+        cache = self._cache(tmp_path)
+        assert cache.set_sync('b', b'raw')
+        assert cache.set_sync('s', 'text')
+        assert cache.set_sync('o', {'n': [1, 2]})
+        assert cache.get_sync('b') == b'raw'
+        assert cache.get_sync('s') == 'text'
+        assert cache.get_sync('o') == {'n': [1, 2]}
+        assert cache.get_sync('missing') is None
+
+    def test_delete_and_oversized(self, tmp_path):
+        """Test delete and values larger than a slot"""
+        cache = self._cache(tmp_path)
+        cache.set_sync('k', 'v')
+        assert cache.delete_sync('k')
+        assert not cache.delete_sync('k')
+        assert not cache.set_sync('big', b'x' * 1024)
+
+    def test_bucket_eviction(self, tmp_path):
+        """Test a full bucket replaces its oldest slot"""
+        cache = SharedMemoryCache(path=str(tmp_path / 'one.cache'), buckets=1, ways=2, slot_size=128)
+        cache.set_sync('a', 1)
+        cache.set_sync('b', 2)
+        cache.set_sync('c', 3)
+        assert cache.get_sync('a') is None
+        assert cache.get_sync('c') == 3
+        assert cache.get_stats()['evictions'] == 1
+
+    def test_invalidate_by_tag(self, tmp_path):
+        """Test tag invalidation hides tagged entries only"""
+        cache = self._cache(tmp_path)
+        cache.set_sync('tagged', 1, tags=['users'])
+        cache.set_sync('plain', 2)
+        cache.invalidate_by_tag_sync('users')
+        assert cache.get_sync('tagged') is None
+        assert cache.get_sync('plain') == 2
+
+        cache.set_sync('tagged', 3, tags=['users'])
+        assert cache.get_sync('tagged') == 3
+
+    def test_shared_between_processes(self, tmp_path):
+        """Test entries written by another process are visible"""
+        cache = self._cache(tmp_path)
+        process = multiprocessing.Process(target=_write_from_child, args=(cache.path,))
+        process.start()
+        process.join()
+        assert cache.get_sync('child') == {'pid': 'other'}
+
+    def test_geometry_mismatch(self, tmp_path):
+        """Test reopening with different geometry is rejected"""
+        cache = self._cache(tmp_path)
+        with pytest.raises(ValueError):
+            SharedMemoryCache(path=cache.path, buckets=16, ways=4, slot_size=256)
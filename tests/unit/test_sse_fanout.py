@@ -0,0 +1,130 @@
+"""
+Unit tests for Pyserv SSE fan-out
+"""
+import asyncio
+
+import pytest
+
+from pyserv.server.sse import SSEEvent, SSEManager, SSEOutbox, SlowConsumerPolicy
+
+
+class Client:
+    """Response writer stand-in that can be paused"""
+
+    def __init__(self):
+        self.received = []
+        self.open = asyncio.Event()
+        self.open.set()
+
+    async def write(self, data):
+        await self.open.wait()
+        self.received.append(data)
+
+    def events(self):
+        return b"".join(self.received).decode().count("\n\n")
+
+
+async def settle():
+    """Let writer tasks run"""
+    for _ in range(10):
+        await asyncio.sleep(0)
+
+
+async def subscribe(manager, channel, client):
+    connection = await manager.connect(channels=[channel])
+    connection.response_writer = client.write
+    return connection
+
+
+class TestOutbox:
+    """Test slow-consumer policies"""
+
+    def test_policies(self):
+        """Test drop-oldest, coalesce and disconnect when the outbox is full"""
+        def item(name, number):
+            return (str(number).encode(), name, "c", 0.0)
+
+        outbox = SSEOutbox(2, SlowConsumerPolicy.DROP_OLDEST)
+        for number in range(3):
+            assert outbox.put(item("tick", number))
+        assert [i[0] for i in outbox.items] == [b"1", b"2"] and outbox.dropped == 1
+
+        outbox = SSEOutbox(2, SlowConsumerPolicy.COALESCE)
+        outbox.put(item("cpu", 1))
+        outbox.put(item("mem", 1))
+        outbox.put(item("cpu", 2))
+        assert [(i[1], i[0]) for i in outbox.items] == [("cpu", b"2"), ("mem", b"1")]
+        assert outbox.coalesced == 1
+
+        outbox = SSEOutbox(1, SlowConsumerPolicy.DISCONNECT)
+        assert outbox.put(item("a", 1))
+        assert not outbox.put(item("a", 2))
+
+
+class TestFanOut:
+    """Test channel fan-out through per-connection writers"""
+
+    @pytest.mark.asyncio
+    async def test_encodes_once_and_delivers(self, monkeypatch):
+        """Test one encode per broadcast and delivery to every subscriber"""
+        manager = SSEManager()
+        clients = [Client() for _ in range(3)]
+        for client in clients:
+            await subscribe(manager, "dash", client)
+
+        encodes = []
+        original = SSEEvent.encode
+        monkeypatch.setattr(SSEEvent, "encode", lambda self: encodes.append(1) or original(self))
+
+        assert await manager.send_to_channel("dash", SSEEvent(event="cpu", data={"v": 1})) == 3
+        await settle()
+        assert len(encodes) == 1
+        assert all(b"event: cpu\ndata: {\"v\":1}\n\n" in b"".join(c.received) for c in clients)
+        stats = manager.get_stats()["channel_fanout"]["dash"]
+        assert stats["events"] == 1 and stats["deliveries"] == 3
+
+    @pytest.mark.asyncio
+    async def test_slow_client_does_not_stall_channel(self):
+        """Test a stalled writer only fills its own outbox"""
+        manager = SSEManager(outbox_size=4)
+        fast, slow = Client(), Client()
+        slow.open.clear()
+        await subscribe(manager, "dash", fast)
+        await subscribe(manager, "dash", slow)
+
+        for number in range(10):
+            await asyncio.wait_for(manager.send_to_channel("dash", SSEEvent(data=number)), timeout=1)
+            await settle()
+        assert fast.events() == 10
+        assert manager.get_stats()["channel_fanout"]["dash"]["dropped"] > 0
+
+        slow.open.set()
+        await settle()
+        # One write already in flight, then the outbox holding the newest events
+        assert slow.events() == 5
+
+    @pytest.mark.asyncio
+    async def test_disconnect_policy(self):
+        """Test slow consumers are dropped under the disconnect policy"""
+        manager = SSEManager(outbox_size=1, slow_consumer_policy="disconnect")
+        slow = Client()
+        slow.open.clear()
+        connection = await subscribe(manager, "dash", slow)
+
+        for number in range(3):
+            await manager.send_to_channel("dash", SSEEvent(data=number))
+            await settle()
+        assert connection.connection_id not in manager.connections
+        assert manager.get_stats()["channel_fanout"]["dash"]["disconnects"] == 1
+
+    @pytest.mark.asyncio
+    async def test_disconnect_flushes_close_event(self):
+        """Test disconnect sends queued events and the close event before removing"""
+        manager = SSEManager()
+        client = Client()
+        connection = await subscribe(manager, "dash", client)
+        await manager.send_to_channel("dash", SSEEvent(data="last"))
+        await manager.disconnect(connection.connection_id)
+        received = b"".join(client.received).decode()
+        assert "data: last" in received and "event: close" in received
+        assert connection.writer_task.done()
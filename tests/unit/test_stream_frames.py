@@ -0,0 +1,328 @@
+"""
+Unit tests for Pyserv streaming frames
+"""
+import asyncio
+import gc
+import json
+import time
+from array import array
+
+import pytest
+
+from pyserv.streaming import frames
+from pyserv.streaming.core import BufferedStreamProcessor, StreamConfig, StreamMessage
+from pyserv.streaming.frames import (FrameDecoder, FrameError, SnowflakeIds, StreamFrame,
+                                     encode_frames, iter_frames, HEADER_SIZE)
+from pyserv.streaming.ring import FrameChannel, FrameRing, PyFrameRing, NATIVE_RING
+
+SPLITTERS = [frames._py_split] + ([frames._native_split] if frames._frame_ring is not None else [])
+RINGS = [PyFrameRing] + ([FrameRing] if NATIVE_RING else [])
+
+
+class TestStreamFrame:
+    """Test the binary frame format"""
+
+    @pytest.mark.parametrize("data, encoding", [
+        (b"\x00\x01raw", frames.RAW),
+        ("température", frames.TEXT),
+        ({"device": "sensor-1", "samples": [1.5, 2.5]}, frames.JSON),
+    ])
+    def test_round_trip(self, data, encoding):
+        """Test payload, type, id, timestamp and metadata survive encoding"""
+        frame = StreamFrame.build(data, "telemetry", {"unit": "C"})
+        decoded = StreamFrame.decode(frame.to_bytes())
+        assert decoded.encoding == encoding and decoded.type == "telemetry"
+        assert (decoded.id, decoded.timestamp_ns) == (frame.id, frame.timestamp_ns)
+        assert decoded.metadata == {"unit": "C"}
+        assert (bytes(decoded.data) if encoding == frames.RAW else decoded.data) == data
+        assert frame.nbytes == len(frame.to_bytes()) and frame.to_bytes()[:4] == (frame.nbytes - 4).to_bytes(4, "little")
+
+    def test_decoding_does_not_copy(self):
+        """Test decoded payloads are views of the received buffer"""
+        samples = array("d", range(64))
+        wire = bytearray(StreamFrame.build(memoryview(samples), "samples").to_bytes())
+        frame = StreamFrame.decode(wire)
+        assert frame.payload.obj is wire and len(frame.payload) == 512
+        wire[-8:] = array("d", [99.0]).tobytes()
+        assert frame.payload.cast("d")[-1] == 99.0
+
+    def test_parts_and_encode_into(self):
+        """Test scatter parts and in-place encoding produce the same bytes"""
+        frame = StreamFrame.build(b"x" * 100, "blob", {"k": 1})
+        wire = frame.to_bytes()
+        fresh = StreamFrame.build(b"x" * 100, "blob", {"k": 1}, id=frame.id, timestamp_ns=frame.timestamp_ns)
+        assert b"".join(fresh.parts()) == wire and fresh.parts()[1] is fresh.payload
+
+        buffer = bytearray(len(wire) + 10)
+        assert fresh.encode_into(buffer, 10) == len(buffer)
+        assert bytes(buffer[10:]) == wire
+        with pytest.raises(FrameError):
+            fresh.encode_into(bytearray(10))
+
+    def test_malformed_frames(self):
+        """Test truncated and unknown-version frames are rejected"""
+        wire = bytearray(StreamFrame.build(b"abc").to_bytes())
+        with pytest.raises(FrameError):
+            StreamFrame.decode(wire[:-1])
+        with pytest.raises(FrameError):
+            StreamFrame.decode(wire[:HEADER_SIZE - 1])
+        wire[4] = 9
+        with pytest.raises(FrameError):
+            StreamFrame.decode(wire)
+
+    @pytest.mark.parametrize("split", SPLITTERS)
+    def test_invalid_utf8_type(self, split):
+        """Test a type that is not UTF-8 raises FrameError on every path and resets the decoder"""
+        wire = bytearray(StreamFrame.build(b"abc", "ok").to_bytes())
+        wire[HEADER_SIZE:HEADER_SIZE + 2] = b"\xff\xfe"
+        with pytest.raises(FrameError):
+            StreamFrame.decode(wire)
+
+        original = frames._split
+        frames._split = split
+        try:
+            for chunk in (len(wire), 5):
+                decoder = FrameDecoder()
+                with pytest.raises(FrameError):
+                    for start in range(0, len(wire), chunk):
+                        decoder.feed(wire[start:start + chunk])
+                assert decoder.buffered == 0
+                good = StreamFrame.build(b"next")
+                assert [f.id for f in decoder.feed(good.to_bytes())] == [good.id]
+        finally:
+            frames._split = original
+
+    def test_text_for_sse(self):
+        """Test text() keeps JSON as written and base64-encodes binary payloads"""
+        assert json.loads(StreamFrame.build({"a": 1}).text()) == {"a": 1}
+        assert StreamFrame.build(b"\xff\x00").text() == "/wA="
+
+
+class TestFrameDecoder:
+    """Test splitting byte streams into frames"""
+
+    @pytest.mark.parametrize("split", SPLITTERS)
+    def test_frames_split_across_reads(self, split):
+        """Test frames cut at every possible byte boundary are reassembled in order"""
+        original = frames._split
+        frames._split = split
+        try:
+            sent = [StreamFrame.build(b"p" * n, f"t{n % 3}", {"n": n} if n % 2 else None) for n in range(20)]
+            wire = encode_frames(sent)
+            assert [f.id for f in iter_frames(wire)] == [f.id for f in sent]
+
+            for chunk in (1, 3, 7, 64, len(wire)):
+                decoder = FrameDecoder()
+                received = []
+                for start in range(0, len(wire), chunk):
+                    received.extend(decoder.feed(wire[start:start + chunk]))
+                assert [(f.id, f.type, bytes(f.payload)) for f in received] == \
+                    [(f.id, f.type, bytes(f.payload)) for f in sent]
+                assert received[1].metadata == {"n": 1} and decoder.buffered == 0
+        finally:
+            frames._split = original
+
+    @pytest.mark.parametrize("split", SPLITTERS)
+    def test_invalid_length_rejected(self, split):
+        """Test a corrupt or oversized length raises instead of buffering"""
+        original = frames._split
+        frames._split = split
+        try:
+            with pytest.raises(FrameError):
+                FrameDecoder().feed(b"\x01\x00\x00\x00" + b"\x00" * 40)
+            with pytest.raises(FrameError):
+                FrameDecoder(max_frame_size=64).feed(StreamFrame.build(b"x" * 100).to_bytes())
+        finally:
+            frames._split = original
+
+
+class TestSnowflakeIds:
+    """Test message id generation"""
+
+    def test_ids_unique_and_increasing(self):
+        """Test ids increase, carry the worker id and stay ordered past 4096 per millisecond"""
+        ids = SnowflakeIds(worker_id=5)
+        issued = [ids.next() for _ in range(10000)]
+        assert issued == sorted(set(issued))
+        assert all((value >> 12) & 0x3FF == 5 for value in issued)
+        assert abs(ids.timestamp_ms(issued[0]) - time.time() * 1000) < 1000
+
+    def test_clock_step_back(self):
+        """Test ids keep increasing when the clock goes backwards"""
+        ids = SnowflakeIds(worker_id=1)
+        first = ids.next()
+        ids._last_ms += 60000
+        assert ids.next() > first and ids.next() > first
+
+    def test_assigned_worker_survives_reseed(self):
+        """Test an assigned worker id is kept across forks instead of the pid"""
+        ids = SnowflakeIds()
+        ids.assign(7 | 1 << 10)
+        ids.reseed()
+        assert ids.worker_id == 7
+        assert (ids.next() >> 12) & 0x3FF == 7
+
+    def test_message_ids_do_not_stringify_payload(self):
+        """Test StreamMessage ids no longer depend on str(data)"""
+        class Opaque:
+            def __str__(self):
+                raise AssertionError("payload stringified")
+
+        first, second = StreamMessage(Opaque()), StreamMessage(Opaque())
+        assert first.id != second.id and int(second.id) > int(first.id)
+
+
+class TestFrameRing:
+    """Test the bounded frame ring"""
+
+    @pytest.mark.parametrize("ring_type", RINGS)
+    def test_bounded_fifo(self, ring_type):
+        """Test capacity rounding, rejection when full and batch pops"""
+        ring = ring_type(5)
+        assert ring.capacity == 8 and ring.free == 8
+        assert ring.push_many(range(10)) == 8 and not ring.push("x")
+        assert len(ring) == 8 and ring.rejected == 2 and ring.pushed == 8
+        assert ring.pop() == 0 and ring.pop_many(3) == [1, 2, 3]
+        assert ring.pop_many() == [4, 5, 6, 7] and ring.pop("empty") == "empty"
+        with pytest.raises(ValueError):
+            ring_type(0)
+
+    @pytest.mark.parametrize("ring_type", RINGS)
+    def test_pop_many_with_concurrent_pop(self, ring_type):
+        """Test pop_many returns only real items when a collection pops from the ring mid-batch"""
+        ring = ring_type(16)
+        ring.push_many(range(8))
+
+        class Thief:
+            def __del__(self):
+                ring.pop()
+
+        gc.collect()
+        gc.disable()
+        thief = Thief()
+        thief.cycle = thief
+        del thief
+        threshold = gc.get_threshold()
+        gc.set_threshold(1)
+        gc.enable()
+        try:
+            batch = ring.pop_many()
+        finally:
+            gc.set_threshold(*threshold)
+        # The collection may or may not land inside pop_many; either way no slot comes back empty
+        assert batch in (list(range(8)), list(range(1, 8))) and len(ring) == 0
+
+    @pytest.mark.asyncio
+    async def test_channel_back_pressure(self):
+        """Test producers wait for space and consumers receive whole batches"""
+        channel = FrameChannel(4)
+        received = []
+
+        async def consume():
+            while True:
+                batch = await channel.get_batch(timeout=1.0)
+                if not batch:
+                    return
+                received.extend(batch)
+                await asyncio.sleep(0)
+
+        consumer = asyncio.create_task(consume())
+        await channel.put_many(list(range(50)))
+        await channel.put("last")
+        channel.close()
+        await asyncio.wait_for(consumer, 2.0)
+        assert received == list(range(50)) + ["last"]
+        assert await FrameChannel(4).get_batch(timeout=0.01) == []
+
+    @pytest.mark.asyncio
+    async def test_channel_push_between_pop_and_park(self):
+        """Test a push landing after a consumer's empty pop, before it waits, is not missed"""
+        channel = FrameChannel(8)
+        ring = channel.ring
+
+        class RacingRing:
+            """Lets a 'producer' run right after each empty pop, as another thread could"""
+            racing = ["late"]
+
+            def __getattr__(self, name):
+                return getattr(ring, name)
+
+            def __len__(self):
+                return len(ring)
+
+            def pop_many(self, max_items=-1):
+                batch = ring.pop_many(max_items)
+                if not batch and self.racing:
+                    channel.put_nowait(self.racing.pop())
+                return batch
+
+        channel.ring = RacingRing()
+        assert await asyncio.wait_for(channel.get_batch(), 1.0) == ["late"]
+
+        # A woken consumer whose items were taken waits again instead of returning []
+        waiting = asyncio.create_task(channel.get_batch())
+        await asyncio.sleep(0)
+        channel.put_nowait(1)
+        assert channel.get_batch_nowait() == [1]
+        await asyncio.sleep(0.01)
+        assert not waiting.done()
+        channel.put_nowait(2)
+        assert await asyncio.wait_for(waiting, 1.0) == [2]
+
+
+class TestStreamingIntegration:
+    """Test frames through the streaming processors and delivery layers"""
+
+    def test_message_frame_round_trip(self):
+        """Test StreamMessage converts to and from frames"""
+        message = StreamMessage({"t": 21.5}, "telemetry", {"device": "d1"})
+        restored = StreamMessage.from_bytes(message.to_bytes())
+        assert restored.timestamp == pytest.approx(message.timestamp, abs=1e-6) and restored.message_type == "telemetry"
+        assert (restored.id, restored.data, restored.metadata) == (message.id, {"t": 21.5}, {"device": "d1"})
+
+    @pytest.mark.asyncio
+    async def test_buffered_processor_batches(self):
+        """Test messages are processed a batch at a time and flushed on stop"""
+        processor = BufferedStreamProcessor(StreamConfig(buffer_size=8))
+        batches = []
+        original = processor._run_batch
+
+        async def record(batch):
+            batches.append(len(batch))
+            return await original(batch)
+
+        processor._run_batch = record
+        for n in range(5):
+            await processor.process_message(StreamMessage(n))
+        assert batches == [2, 2]
+        await processor.stop()
+        assert batches == [2, 2, 1] and len(processor._buffer) == 0
+
+    def test_sse_and_websocket_encoding(self):
+        """Test frames map onto SSE events and binary WebSocket messages"""
+        from pyserv.server.sse import SSEEvent
+        from pyserv.websocket.hub import encode_message
+
+        frame = StreamFrame.build("hello", "greeting")
+        event = SSEEvent.from_frame(frame)
+        assert (event.id, event.event, event.data) == (str(frame.id), "greeting", "hello")
+        assert encode_message(frame) == (False, frame.to_bytes(), False)
+
+    @pytest.mark.asyncio
+    async def test_gateway_ingest(self):
+        """Test the IoT gateway decodes frames per device stream and dispatches them"""
+        from pyserv.iot.protocol_gateway import ProtocolGateway, ProtocolGatewayConfig
+
+        gateway = ProtocolGateway(ProtocolGatewayConfig())
+        received = []
+
+        async def handler(device_id, frame):
+            received.append((device_id, frame.data))
+
+        gateway.register_protocol_handler("mqtt", handler)
+        wire = encode_frames([StreamFrame.build({"n": n}) for n in range(3)])
+        assert await gateway.ingest("mqtt", wire[:20], "d1") == 0
+        assert await gateway.ingest("mqtt", b"garbage-length!!", "d2") == 0
+        assert await gateway.ingest("mqtt", wire[20:], "d1") == 3
+        assert received == [("d1", {"n": 0}), ("d1", {"n": 1}), ("d1", {"n": 2})]
+        assert gateway.frames_received == 3
@@ -0,0 +1,210 @@
+"""
+Unit tests for Pyserv streamed template rendering
+"""
+import asyncio
+import re
+
+import pytest
+
+from pyserv.http.response import Response
+from pyserv.templating.engine import TemplateEngine, encode_stream
+from pyserv.templating.languages.lean import LeanTemplateEngine
+
+
+async def collect(response):
+    """Run a response and return its body messages"""
+    messages = []
+
+    async def send(message):
+        messages.append(message)
+
+    await response({"type": "http", "method": "GET", "headers": []}, None, send)
+    return messages[1:]
+
+
+async def chunks_of(generator):
+    """Gather an async generator into a list"""
+    return [chunk async for chunk in generator]
+
+
+class TestLeanStreaming:
+    """Test Lean templates rendered in pieces"""
+
+    @pytest.mark.asyncio
+    async def test_flush_points(self, tmp_path, monkeypatch):
+        """Test chunks end after </head> and around blocks, and join to the full render"""
+        from pyserv.templating.languages import lean
+
+        monkeypatch.setattr(lean, "_security_middleware", lambda: None)
+        (tmp_path / "base.html").write_text(
+            "<html><head><title>{% block title %}{% endblock %}</title></head>"
+            "<body>{% block body %}{% endblock %}</body></html>")
+        (tmp_path / "page.html").write_text(
+            '{% extends "base.html" %}{% block title %}T{% endblock %}'
+            "{% block body %}{% for row in rows %}<p>{{ row }}</p>{% endfor %}{% endblock %}")
+        engine = LeanTemplateEngine(tmp_path)
+        context = {"rows": list(range(300))}
+
+        chunks = await chunks_of(engine.render_stream("page.html", context))
+        assert b"".join(chunks).decode() == await engine.render("page.html", context)
+        assert chunks[0] == b"<html><head><title>"
+        assert chunks[1] == b"T"
+        assert any(chunk.endswith(b"</head>") for chunk in chunks)
+        # The 300-row loop flushes part way through instead of buffering the whole body
+        assert len(chunks) > 5
+
+
+class TestSimpleEngineStreaming:
+    """Test the format-based engine rendered in pieces"""
+
+    @pytest.mark.asyncio
+    async def test_render_file_stream(self, tmp_path):
+        """Test the stream matches render_file"""
+        path = tmp_path / "page.html"
+        path.write_text("<head>{{title}}</head><body>{{body}}</body>")
+        engine = TemplateEngine()
+        chunks = await chunks_of(engine.render_file_stream(path, title="t", body="b" * 10))
+        assert chunks[0] == b"<head>t</head>"
+        assert b"".join(chunks).decode() == engine.render_file(path, title="t", body="b" * 10)
+
+    @pytest.mark.asyncio
+    async def test_encode_stream_chunk_size(self):
+        """Test fragments are grouped up to the chunk size"""
+        chunks = await chunks_of(encode_stream(["ab", "cd", "ef", "g"], chunk_size=4))
+        assert chunks == [b"abcd", b"efg"]
+
+
+class TestStreamResponse:
+    """Test Response.stream"""
+
+    @pytest.mark.asyncio
+    async def test_streams_generator(self):
+        """Test each generated chunk is sent as it is produced"""
+        async def body():
+            for part in (b"<head></head>", b"<p>1</p>", b"<p>2</p>"):
+                yield part
+
+        messages = await collect(Response.stream(body()))
+        assert [m["body"] for m in messages] == [b"<head></head>", b"<p>1</p>", b"<p>2</p>", b""]
+        assert messages[-1]["more_body"] is False
+
+    @pytest.mark.asyncio
+    async def test_backpressure(self):
+        """Test the generator runs at most stream_queue_size chunks ahead of the sender"""
+        produced = []
+        release = asyncio.Event()
+
+        async def body():
+            for number in range(50):
+                produced.append(number)
+                yield b"x"
+
+        async def send(message):
+            if message["type"] == "http.response.body" and not release.is_set():
+                await release.wait()
+
+        task = asyncio.create_task(Response.stream(body())({"type": "http", "headers": []}, None, send))
+        for _ in range(20):
+            await asyncio.sleep(0)
+        assert len(produced) <= Response.stream_queue_size + 2
+        release.set()
+        await task
+        assert len(produced) == 50
+
+    @pytest.mark.asyncio
+    async def test_generator_error_propagates(self):
+        """Test a failing generator aborts the response instead of ending it cleanly"""
+        async def body():
+            yield b"start"
+            raise RuntimeError("render failed")
+
+        with pytest.raises(RuntimeError):
+            await collect(Response.stream(body()))
+
+    @pytest.mark.asyncio
+    async def test_client_disconnect_releases_producer(self):
+        """Test a dropped client cancels the producer even when the queue is full"""
+        closed = asyncio.Event()
+
+        async def body():
+            try:
+                while True:
+                    yield b"x"
+            finally:
+                closed.set()
+
+        async def send(message):
+            if message["type"] == "http.response.body":
+                for _ in range(10):
+                    await asyncio.sleep(0)
+                raise ConnectionResetError("client went away")
+
+        with pytest.raises(ConnectionResetError):
+            await Response.stream(body())({"type": "http", "headers": []}, None, send)
+        await asyncio.wait_for(closed.wait(), 1.0)
+        for _ in range(5):
+            await asyncio.sleep(0)
+        assert [t for t in asyncio.all_tasks() if t is not asyncio.current_task()] == []
+
+
+class TestStreamSanitization:
+    """Test output sanitization across streamed fragments"""
+
+    def test_cursor_cuts_after_complete_tags(self):
+        """Test the cut follows the last complete tag and waits out open tags and unsafe elements"""
+        from pyserv.templating.languages.lean import _SanitizeCursor
+
+        cursor = _SanitizeCursor()
+        text = "<p>no whitespace</p><a hr"
+        assert cursor.advance(text) == len("<p>no whitespace</p>")
+        text += 'ef="/">x</a><SCRIPT>a</scr'
+        assert cursor.advance(text) == len('<p>no whitespace</p><a href="/">x</a>')
+        cursor.consume(20)
+        text = text[20:] + "ipt><br/>tail"
+        assert text[:cursor.advance(text)].endswith("</scr" "ipt><br/>")
+        assert cursor.pos == len(text)
+
+    @pytest.mark.asyncio
+    async def test_streams_with_sanitizer(self, tmp_path, monkeypatch):
+        """Test output without whitespace still streams in pieces when a sanitizer is present"""
+        from pyserv.templating.languages import lean
+
+        class Middleware:
+            def sanitize_template_output(self, content):
+                return content
+
+        monkeypatch.setattr(lean, "_security_middleware", Middleware)
+        (tmp_path / "page.html").write_text(
+            "<html><head></head><body>{% for row in rows %}<p>{{ row }}</p>{% endfor %}</body></html>")
+        engine = LeanTemplateEngine(tmp_path)
+        context = {"rows": list(range(3000))}
+
+        chunks = await chunks_of(engine.render_stream("page.html", context))
+        assert b"".join(chunks).decode() == await engine.render("page.html", context)
+        assert len(chunks) > 5
+
+    @pytest.mark.asyncio
+    async def test_element_split_across_fragments(self, tmp_path, monkeypatch):
+        """Test a script or handler split across flush points is still removed"""
+        from pyserv.templating.languages import lean
+
+        class Middleware:
+            """Element and attribute stripping in the style of XSSProtector.sanitize_html"""
+
+            def sanitize_template_output(self, content):
+                content = re.sub(r'<script[^>]*>.*?</script>', '', content, flags=re.IGNORECASE | re.DOTALL)
+                return re.sub(r'\son\w+[^>\s]*', '', content, flags=re.IGNORECASE)
+
+        monkeypatch.setattr(lean, "_security_middleware", Middleware)
+        (tmp_path / "page.html").write_text(
+            "<html><head></head>{% block a %}<p>ok</p><script>{% endblock %}"
+            "{% block b %}alert(1)</script><a{% endblock %}{% block c %} onclick=x>link</a>{% endblock %}"
+            "{% for row in rows %}<p>{{ row }}</p>\n{% endfor %}")
+        engine = LeanTemplateEngine(tmp_path)
+        context = {"rows": list(range(300))}
+
+        chunks = await chunks_of(engine.render_stream("page.html", context))
+        body = b"".join(chunks).decode()
+        assert body == await engine.render("page.html", context)
+        assert "alert" not in body and "onclick" not in body and "<p>ok</p>" in body
+        assert len(chunks) > 3
@@ -0,0 +1,259 @@
+"""
+Unit tests for Pyserv WebSocket hub
+"""
+import asyncio
+import sys
+import types
+
+import pytest
+
+from pyserv.websocket.hub import InMemoryBackplane, OverflowPolicy, RedisBackplane, WebSocketHub
+
+
+class FakeWebSocket:
+    """Connected WebSocket stand-in recording sent frames"""
+
+    def __init__(self, block=False):
+        self.sent = []
+        self.closed = None
+        self.gate = asyncio.Event()
+        if not block:
+            self.gate.set()
+
+    async def send_text(self, data):
+        await self.gate.wait()
+        self.sent.append(data)
+
+    async def send_bytes(self, data):
+        await self.gate.wait()
+        self.sent.append(data)
+
+    async def close(self, code=1000, reason=None):
+        self.closed = code
+
+
+async def settle(hub):
+    """Let writer tasks flush"""
+    await asyncio.sleep(hub.flush_interval * 4 + 0.01)
+
+
+class TestWebSocketHub:
+    """Test topic fan-out, coalescing and backpressure"""
+
+    @pytest.mark.asyncio
+    async def test_publish_to_subscribers(self):
+        """Test messages reach only the topic's subscribers, serialised once"""
+        hub = WebSocketHub(flush_interval=0)
+        a, b, c = FakeWebSocket(), FakeWebSocket(), FakeWebSocket()
+        await hub.subscribe(a, "news")
+        await hub.subscribe(b, "news")
+        await hub.subscribe(c, "sport")
+
+        assert await hub.publish("news", {"n": 1}) == 2
+        await hub.publish("news", b"\x00raw")
+        await settle(hub)
+        assert a.sent == ['{"n":1}', b"\x00raw"]
+        assert a.sent[0] is b.sent[0]
+        assert c.sent == []
+
+        await hub.unsubscribe(a, "news")
+        await hub.publish("news", "text")
+        await settle(hub)
+        assert len(a.sent) == 2 and b.sent[-1] == "text"
+
+        stats = hub.get_stats()['topics']['news']
+        assert stats['published'] == 3 and stats['delivered'] == 5
+        await hub.stop()
+
+    @pytest.mark.asyncio
+    async def test_batched_frames(self):
+        """Test JSON messages queued together go out as one array frame"""
+        hub = WebSocketHub(flush_interval=0.01, batch_frames=True)
+        ws = FakeWebSocket()
+        await hub.subscribe(ws, "t")
+        for n in range(3):
+            await hub.publish("t", {"n": n})
+        await hub.publish("t", "plain")
+        await settle(hub)
+        assert ws.sent == ['[{"n":0},{"n":1},{"n":2}]', "plain"]
+        await hub.stop()
+
+    @pytest.mark.asyncio
+    async def test_idle_sends_at_once_and_backlog_batches(self):
+        """Test an idle writer skips the flush wait and one that fell behind batches what queued"""
+        hub = WebSocketHub(flush_interval=1.0, batch_frames=True)
+        ws = FakeWebSocket(block=True)
+        await hub.subscribe(ws, "t")
+        await hub.publish("t", {"n": 0})
+        await asyncio.sleep(0.01)  # the writer is sending {"n": 0} without having waited
+        for n in range(1, 3):
+            await hub.publish("t", {"n": n})
+        ws.gate.set()
+        await asyncio.sleep(0.01)
+        assert ws.sent == ['[{"n":0}]']
+        await asyncio.sleep(1.05)
+        assert ws.sent == ['[{"n":0}]', '[{"n":1},{"n":2}]']
+
+        await hub.publish("t", {"n": 3})
+        await asyncio.sleep(0.01)
+        assert ws.sent[-1] == '[{"n":3}]'
+        await hub.stop()
+
+    @pytest.mark.asyncio
+    async def test_slow_consumer_drop_oldest(self):
+        """Test a stalled client keeps only the newest frames and others are unaffected"""
+        hub = WebSocketHub(queue_size=2, flush_interval=0)
+        slow, fast = FakeWebSocket(block=True), FakeWebSocket()
+        await hub.subscribe(slow, "t")
+        await hub.subscribe(fast, "t")
+        await hub.publish("t", "first")
+        await asyncio.sleep(0.01)  # slow's writer now blocks sending "first"
+        for n in range(5):
+            await hub.publish("t", str(n))
+            await asyncio.sleep(0.005)
+        await settle(hub)
+        assert fast.sent == ["first", "0", "1", "2", "3", "4"]
+        assert hub.get_stats()['topics']['t']['queue_depth'] == 2
+        assert hub.topic_stats['t'].dropped == 3
+
+        slow.gate.set()
+        await settle(hub)
+        assert slow.sent == ["first", "3", "4"]
+        await hub.stop()
+
+    @pytest.mark.asyncio
+    async def test_slow_consumer_disconnect(self):
+        """Test the disconnect policy closes clients whose queue overflows"""
+        hub = WebSocketHub(queue_size=1, flush_interval=0, overflow_policy=OverflowPolicy.DISCONNECT)
+        slow = FakeWebSocket(block=True)
+        await hub.subscribe(slow, "t")
+        await hub.publish("t", "a")
+        await asyncio.sleep(0.01)
+        await hub.publish("t", "b")
+        await hub.publish("t", "c")
+        await asyncio.sleep(0.01)
+        assert slow.closed == 1013
+        assert hub.get_stats()['connections'] == 0 and "t" not in hub.topics
+
+    @pytest.mark.asyncio
+    async def test_backplane(self):
+        """Test publishes reach other nodes only for topics they subscribe to"""
+        shared = InMemoryBackplane()
+        one = WebSocketHub(flush_interval=0, backplane=shared)
+        two = WebSocketHub(flush_interval=0, backplane=shared.attach())
+        await one.start()
+        await two.start()
+        local, remote = FakeWebSocket(), FakeWebSocket()
+        await one.subscribe(local, "t")
+        await two.subscribe(remote, "t")
+
+        await one.publish("t", {"x": 1})
+        await one.publish("other", "ignored")
+        await settle(one)
+        assert local.sent == ['{"x":1}'] and remote.sent == ['{"x":1}']
+        assert two.topic_stats['t'].remote == 1 and "other" not in two.topic_stats
+
+        await two.remove(remote)
+        await one.publish("t", "again")
+        await settle(one)
+        assert remote.sent == ['{"x":1}']
+        await one.stop()
+        await two.stop()
+
+    @pytest.mark.asyncio
+    async def test_metrics(self):
+        """Test per-topic metrics"""
+        hub = WebSocketHub(flush_interval=0)
+        ws = FakeWebSocket()
+        await hub.subscribe(ws, "t")
+        await hub.publish("t", "hello")
+        await settle(hub)
+        values = {(v.name, v.labels.get('topic')): v.value for v in hub.collect_metrics()}
+        assert values[('ws_hub_connections', None)] == 1
+        assert values[('ws_hub_published_total', 't')] == 1
+        assert values[('ws_hub_bytes_total', 't')] == 5
+        assert values[('ws_hub_queue_depth', 't')] == 0
+        await hub.stop()
+
+    @pytest.mark.asyncio
+    async def test_redis_reader_waits_for_subscribe(self, monkeypatch):
+        """Test the Redis backplane only polls for messages once it has subscribed"""
+        class PubSub:
+            def __init__(self):
+                self.channels = []
+                self.inbox = asyncio.Queue()
+
+            async def subscribe(self, channel):
+                self.channels.append(channel)
+
+            async def get_message(self, timeout):
+                if not self.channels:
+                    raise RuntimeError("pubsub connection not set")
+                try:
+                    return await asyncio.wait_for(self.inbox.get(), timeout)
+                except asyncio.TimeoutError:
+                    return None
+
+            async def close(self):
+                pass
+
+        pubsub = PubSub()
+
+        class Redis:
+            def pubsub(self, ignore_subscribe_messages):
+                return pubsub
+
+            async def publish(self, channel, data):
+                await pubsub.inbox.put({'channel': channel.encode(), 'data': data})
+
+            async def close(self):
+                pass
+
+        module = types.ModuleType("redis.asyncio")
+        module.from_url = lambda url: Redis()
+        monkeypatch.setitem(sys.modules, "redis", types.ModuleType("redis"))
+        monkeypatch.setitem(sys.modules, "redis.asyncio", module)
+
+        received = []
+
+        async def handler(topic, *frame):
+            received.append((topic, frame))
+
+        backplane = RedisBackplane()
+        await backplane.start("local", handler)
+        assert backplane._reader is None
+        await backplane.subscribe("t")
+        await Redis().publish("pyserv:ws:t", b"remote|tpayload")
+        await asyncio.sleep(0.01)
+        assert received == [("t", (True, "payload", False))]
+        await backplane.close()
+
+    @pytest.mark.asyncio
+    async def test_stream_and_p2p_fan_out_through_hub(self):
+        """Test stream broadcasts and P2P group sends are queued to sockets by the hub"""
+        from pyserv.iot.websocket_p2p import HubChannelLayer, P2PConsumer
+        from pyserv.streaming.core import BufferedStreamProcessor, StreamMessage
+
+        hub = WebSocketHub(flush_interval=0)
+        viewer = FakeWebSocket()
+        await hub.subscribe(viewer, "telemetry")
+        processor = BufferedStreamProcessor()
+        processor.use_hub(hub, "telemetry")
+        message = StreamMessage({"t": 21.5}, "reading")
+        await processor.broadcast(message)
+        await settle(hub)
+        assert viewer.sent == [message.to_bytes()]
+
+        layer = HubChannelLayer(hub)
+        peers = [P2PConsumer({}, FakeWebSocket()) for _ in range(2)]
+        for peer in peers:
+            peer.channel_layer = layer
+            await peer.connect()
+        await peers[0].receive(text_data='{"type": "broadcast", "message": "hi"}')
+        await settle(hub)
+        assert [len(peer.websocket.sent) for peer in peers] == [1, 1]
+        assert peers[0].websocket.sent[0] is peers[1].websocket.sent[0]
+
+        await peers[1].disconnect(1000)
+        assert hub.get_stats()['connections'] == 2
+        await hub.stop()